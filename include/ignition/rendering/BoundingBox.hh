@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_BOUNDINGBOX_HH_
+#define IGNITION_RENDERING_BOUNDINGBOX_HH_
+
+#include <cstdint>
+
+#include <ignition/math/Quaternion.hh>
+#include <ignition/math/Vector3.hh>
+
+#include "ignition/rendering/config.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    /// \enum BoundingBoxType
+    /// \brief Types of bounding boxes reported by a bounding box camera
+    enum BoundingBoxType
+    {
+      /// \brief 2D box of the pixels where a visual is visible
+      BBT_VISIBLEBOX2D = 0,
+
+      /// \brief 2D box of the full extent of a visual in the image,
+      /// including its occluded parts
+      BBT_FULLBOX2D = 1,
+
+      /// \brief 3D oriented box of a visual in the camera frame
+      BBT_BOX3D = 2
+    };
+
+    /// \brief Bounding box of a labelled visual seen by a camera
+    class BoundingBox
+    {
+      /// \brief Type of the box
+      public: BoundingBoxType type = BBT_VISIBLEBOX2D;
+
+      /// \brief Center of the box. 2D boxes are in pixels, from the top
+      /// left corner of the image, with a z of 0. 3D boxes are in meters,
+      /// in the camera frame, where x points forward and z up.
+      public: math::Vector3d center;
+
+      /// \brief Size of the box, in pixels for 2D boxes, with a z of 0,
+      /// and in meters along the axes of the box for 3D boxes
+      public: math::Vector3d size;
+
+      /// \brief Orientation of 3D boxes in the camera frame. Identity for
+      /// 2D boxes.
+      public: math::Quaterniond orientation;
+
+      /// \brief Label of the visual
+      public: uint32_t label = 0u;
+    };
+    }
+  }
+}
+#endif
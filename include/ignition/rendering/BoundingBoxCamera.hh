@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_BOUNDINGBOXCAMERA_HH_
+#define IGNITION_RENDERING_BOUNDINGBOXCAMERA_HH_
+
+#include <functional>
+#include <vector>
+
+#include <ignition/common/Event.hh>
+
+#include "ignition/rendering/BoundingBox.hh"
+#include "ignition/rendering/Camera.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    /* \class BoundingBoxCamera BoundingBoxCamera.hh \
+      * ignition/rendering/BoundingBoxCamera.hh
+     */
+    /// \brief Camera that reports the bounding boxes of the labelled visuals
+    /// it sees, e.g. to annotate images for perception datasets. A visual
+    /// is labelled by setting its user data with the key "label" to a
+    /// positive integer, and all the descendants of a labelled visual belong
+    /// to it, unless they have a label of their own. Boxes are reported for
+    /// the labelled visuals that have at least one visible pixel, so
+    /// visuals that are fully occluded or outside of the view are left out.
+    class IGNITION_RENDERING_VISIBLE BoundingBoxCamera :
+      public virtual Camera
+    {
+      /// \brief Destructor
+      public: virtual ~BoundingBoxCamera() { }
+
+      /// \brief Set the type of the boxes reported by the camera
+      /// \param[in] _type Type of the boxes
+      /// \sa Type
+      public: virtual void SetBoundingBoxType(BoundingBoxType _type) = 0;
+
+      /// \brief Get the type of the boxes reported by the camera
+      /// \return Type of the boxes
+      /// \sa SetBoundingBoxType
+      public: virtual BoundingBoxType Type() const = 0;
+
+      /// \brief Get the boxes of the last rendered frame
+      /// \return Boxes of the labelled visuals seen by the camera
+      public: virtual const std::vector<BoundingBox> &BoundingBoxData()
+                  const = 0;
+
+      /// \brief Connect to the new bounding boxes event, emitted once per
+      /// rendered frame
+      /// \param[in] _subscriber Subscriber callback function
+      /// \return Pointer to the new Connection. This must be kept in scope
+      public: virtual ignition::common::ConnectionPtr ConnectNewBoundingBoxes(
+                  std::function<void(const std::vector<BoundingBox> &)>
+                  _subscriber) = 0;
+    };
+    }
+  }
+}
+#endif
@@ -18,6 +18,7 @@
 #define IGNITION_RENDERING_CAMERA_HH_
 
 #include <string>
+#include <vector>
 
 #include <ignition/common/Event.hh>
 #include <ignition/math/Matrix4.hh>
@@ -27,6 +28,7 @@
 #include "ignition/rendering/PixelFormat.hh"
 #include "ignition/rendering/Sensor.hh"
 #include "ignition/rendering/Scene.hh"
+#include "ignition/rendering/VisibilityIndex.hh"
 
 
 namespace ignition
@@ -107,6 +109,16 @@ namespace ignition
       /// \param[in] _aa Level of anti-aliasing used during rendering
       public: virtual void SetAntiAliasing(const unsigned int _aa) = 0;
 
+      /// \brief Get the background color of the camera image
+      /// \return Background color
+      public: virtual math::Color BackgroundColor() const = 0;
+
+      /// \brief Set the background color of the camera image. Cameras are
+      /// given the background color of the scene when created, and setting
+      /// the background color of the scene may override it.
+      /// \param[in] _color Background color
+      public: virtual void SetBackgroundColor(const math::Color &_color) = 0;
+
       /// \brief Get the camera's far clipping plane distance
       /// \return Far clipping plane distance
       public: virtual double FarClipPlane() const = 0;
@@ -193,6 +205,31 @@ namespace ignition
       /// \return Camera view matrix
       public: virtual math::Matrix4d ViewMatrix() const = 0;
 
+      /// \brief Find the visuals inside the view frustum of this camera
+      /// without rendering, using the world bounding boxes of the visuals.
+      /// The camera visibility mask is applied in addition to the mask in
+      /// _options. The query uses Scene::UpdateVisibilityIndex, which only
+      /// re-reads the visuals that changed. To query many cameras in
+      /// parallel, use VisibilityIndex::Query on that index instead.
+      /// \param[in] _options Query options
+      /// \return Visible visuals sorted by distance from the camera
+      public: virtual std::vector<VisibleVisual> VisibleVisuals(
+                  const VisibleVisualsOptions &_options =
+                  VisibleVisualsOptions()) = 0;
+
+      /// \brief Enable or disable occlusion culling. When enabled, objects
+      /// hidden behind visuals that have the IGN_VISIBILITY_OCCLUDER
+      /// visibility flag are not submitted for rendering. Occluders are
+      /// rasterized as their bounding boxes, so only solid box-like visuals
+      /// such as walls and floors should be flagged. Not all render engines
+      /// support occlusion culling.
+      /// \param[in] _enabled True to enable occlusion culling
+      public: virtual void SetOcclusionCulling(bool _enabled) = 0;
+
+      /// \brief Get whether occlusion culling is enabled
+      /// \return True if occlusion culling is enabled
+      public: virtual bool OcclusionCulling() const = 0;
+
       /// \brief Set a node for camera to track. The camera will automatically
       /// change its orientation to face the target being tracked. If null is
       /// specified, tracking is disabled. In contrast to SetFollowTarget
@@ -298,6 +335,50 @@ namespace ignition
       /// \return Render pass at the specified index
       public: virtual RenderPassPtr RenderPassByIndex(unsigned int _index)
           const = 0;
+
+      /// \brief Enable or disable dynamic resolution of the camera render
+      /// target. When enabled, the scene is rendered at a fraction of the
+      /// image resolution that keeps frames close to the target frame time,
+      /// and upscaled to the image resolution.
+      /// \param[in] _enabled True to enable dynamic resolution
+      /// \sa RenderTarget::SetDynamicResolution
+      public: virtual void SetDynamicResolution(bool _enabled) = 0;
+
+      /// \brief Get whether dynamic resolution is enabled
+      /// \return True if dynamic resolution is enabled
+      public: virtual bool DynamicResolution() const = 0;
+
+      /// \brief Set the frame time dynamic resolution tries to hold
+      /// \param[in] _seconds Target frame time in seconds
+      public: virtual void SetTargetFrameTime(double _seconds) = 0;
+
+      /// \brief Get the frame time dynamic resolution tries to hold
+      /// \return Target frame time in seconds
+      public: virtual double TargetFrameTime() const = 0;
+
+      /// \brief Set the range of the dynamic resolution scale
+      /// \param[in] _min Minimum fraction of the image resolution
+      /// \param[in] _max Maximum fraction of the image resolution
+      public: virtual void SetResolutionScaleRange(double _min,
+                  double _max) = 0;
+
+      /// \brief Get the minimum dynamic resolution scale
+      /// \return Minimum fraction of the image resolution
+      public: virtual double MinResolutionScale() const = 0;
+
+      /// \brief Get the maximum dynamic resolution scale
+      /// \return Maximum fraction of the image resolution
+      public: virtual double MaxResolutionScale() const = 0;
+
+      /// \brief Set the resolution scale used when dynamic resolution is
+      /// disabled
+      /// \param[in] _scale Fraction of the image resolution, in [0.1, 1]
+      public: virtual void SetResolutionScale(double _scale) = 0;
+
+      /// \brief Get the resolution scale the scene is currently rendered
+      /// at
+      /// \return Fraction of the image resolution
+      public: virtual double ResolutionScale() const = 0;
     };
     }
   }
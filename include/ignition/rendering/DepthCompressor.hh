@@ -0,0 +1,171 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_DEPTHCOMPRESSOR_HH_
+#define IGNITION_RENDERING_DEPTHCOMPRESSOR_HH_
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include <ignition/common/Event.hh>
+#include <ignition/common/SuppressWarning.hh>
+
+#include "ignition/rendering/config.hh"
+#include "ignition/rendering/Export.hh"
+#include "ignition/rendering/RenderTypes.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    // forward declarations
+    class DepthCompressorPrivate;
+
+    /* \class DepthCompressor DepthCompressor.hh \
+     * ignition/rendering/DepthCompressor.hh
+     */
+    /// \brief Compresses depth and range frames on worker threads.
+    ///
+    /// Ranges are quantized to a fixed step (1 mm by default) and encoded
+    /// with RVL, a run length and variable length delta codec designed for
+    /// depth images. Apart from the quantization the encoding is lossless;
+    /// NaN and infinite values are preserved. The sensor thread only copies
+    /// the frame; quantization and encoding run on the worker threads and
+    /// compressed frames are delivered in order through the compressed
+    /// frame event, on a worker thread.
+    class IGNITION_RENDERING_VISIBLE DepthCompressor
+    {
+      /// \brief Callback for compressed frames. The arguments are the
+      /// compressed data, the frame width and height and the frame number.
+      public: typedef std::function<void(const std::vector<unsigned char> &,
+          unsigned int, unsigned int, uint64_t)> CompressedFrameListener;
+
+      /// \brief Constructor
+      public: DepthCompressor();
+
+      /// \brief Destructor. Waits for queued frames to be compressed.
+      public: virtual ~DepthCompressor();
+
+      /// \brief Set the quantization step. Only affects frames queued
+      /// after the call.
+      /// \param[in] _step Quantization step in meters, must be positive
+      public: void SetQuantization(double _step);
+
+      /// \brief Get the quantization step
+      /// \return Quantization step in meters
+      public: double Quantization() const;
+
+      /// \brief Set the number of worker threads. Waits for queued frames
+      /// to be delivered first.
+      /// \param[in] _count Number of threads, at least 1
+      public: void SetWorkerCount(unsigned int _count);
+
+      /// \brief Get the number of worker threads
+      /// \return Number of threads
+      public: unsigned int WorkerCount() const;
+
+      /// \brief Set the maximum number of frames waiting to be compressed.
+      /// When the queue is full the sensor thread waits, so that no frame
+      /// is lost.
+      /// \param[in] _size Queue size, at least 1
+      public: void SetQueueSize(unsigned int _size);
+
+      /// \brief Get the maximum number of frames waiting to be compressed
+      /// \return Queue size
+      public: unsigned int QueueSize() const;
+
+      /// \brief Compress every frame produced by a depth camera
+      /// \param[in] _camera Depth camera
+      /// \return Connection to the new depth frame event. This must be kept
+      /// in scope.
+      public: common::ConnectionPtr ConnectDepthCamera(
+          const DepthCameraPtr &_camera);
+
+      /// \brief Compress the range channel of every frame produced by a
+      /// gpu rays sensor. The retro channel is not kept.
+      /// \param[in] _rays Gpu rays sensor
+      /// \return Connection to the new gpu rays frame event. This must be
+      /// kept in scope.
+      public: common::ConnectionPtr ConnectGpuRays(const GpuRaysPtr &_rays);
+
+      /// \brief Queue a frame for compression
+      /// \param[in] _data Frame data
+      /// \param[in] _width Frame width
+      /// \param[in] _height Frame height
+      /// \param[in] _channels Number of floats per pixel. Only the first
+      /// one is compressed.
+      public: void Compress(const float *_data, unsigned int _width,
+          unsigned int _height, unsigned int _channels = 1u);
+
+      /// \brief Wait until all queued frames have been delivered
+      public: void Flush();
+
+      /// \brief Connect to the compressed frame event
+      /// \param[in] _listener Callback, called on a worker thread
+      /// \return Connection. This must be kept in scope.
+      public: common::ConnectionPtr ConnectNewCompressedFrame(
+          CompressedFrameListener _listener);
+
+      /// \brief Get the number of frames compressed
+      /// \return Number of frames
+      public: uint64_t FramesCompressed() const;
+
+      /// \brief Get the ratio between the size of the float frames and the
+      /// size of the compressed frames
+      /// \return Compression ratio, 0 if no frame was compressed
+      public: double CompressionRatio() const;
+
+      /// \brief Get the amount of float data compressed per second of
+      /// worker thread time
+      /// \return Throughput of a single worker in MB/s
+      public: double Throughput() const;
+
+      /// \brief Compress a frame in the current thread
+      /// \param[in] _data Frame data
+      /// \param[in] _width Frame width
+      /// \param[in] _height Frame height
+      /// \param[in] _channels Number of floats per pixel. Only the first
+      /// one is compressed.
+      /// \param[in] _step Quantization step in meters
+      /// \param[out] _out Compressed frame
+      public: static void Encode(const float *_data, unsigned int _width,
+          unsigned int _height, unsigned int _channels, double _step,
+          std::vector<unsigned char> &_out);
+
+      /// \brief Decompress a frame
+      /// \param[in] _data Compressed frame
+      /// \param[in] _size Size of the compressed frame in bytes
+      /// \param[out] _out Depth values, resized to width * height
+      /// \param[out] _width Frame width
+      /// \param[out] _height Frame height
+      /// \return True if the data is a valid compressed frame
+      public: static bool Decode(const unsigned char *_data, size_t _size,
+          std::vector<float> &_out, unsigned int &_width,
+          unsigned int &_height);
+
+      IGN_COMMON_WARN_IGNORE__DLL_INTERFACE_MISSING
+      /// \brief Private data pointer
+      private: std::unique_ptr<DepthCompressorPrivate> dataPtr;
+      IGN_COMMON_WARN_RESUME__DLL_INTERFACE_MISSING
+    };
+    }
+  }
+}
+#endif
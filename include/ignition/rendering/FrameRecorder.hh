@@ -0,0 +1,182 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_FRAMERECORDER_HH_
+#define IGNITION_RENDERING_FRAMERECORDER_HH_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include <ignition/common/SuppressWarning.hh>
+
+#include "ignition/rendering/config.hh"
+#include "ignition/rendering/Export.hh"
+#include "ignition/rendering/Image.hh"
+#include "ignition/rendering/PixelFormat.hh"
+#include "ignition/rendering/RenderTypes.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    // forward declarations
+    class FrameRecorderPrivate;
+
+    /// \brief What FrameRecorder does with a new frame when its queue is
+    /// full
+    enum FrameDropPolicy
+    {
+      /// \brief Block the caller until a frame has been encoded. No frame
+      /// is lost but rendering slows down to the encoding rate.
+      FDP_BLOCK = 0,
+
+      /// \brief Discard the new frame
+      FDP_DROP_NEWEST = 1,
+
+      /// \brief Discard the oldest queued frame to make room for the new
+      /// frame
+      FDP_DROP_OLDEST = 2
+    };
+
+    /* \class FrameRecorder FrameRecorder.hh \
+     * ignition/rendering/FrameRecorder.hh
+     */
+    /// \brief Saves camera frames to image files on a pool of worker
+    /// threads, so that encoding does not block rendering.
+    ///
+    /// Frames are copied once into a reusable buffer and queued. The queue
+    /// is bounded; the drop policy decides what happens when it is full.
+    /// Files are named <prefix>_<frame number>.<extension> in the output
+    /// directory. Supported extensions are "png", "ppm" and "pgm"
+    /// (8 or 16 bit binary netpbm, much faster to write than png) and
+    /// "pfm" (portable float map, for depth and other float images).
+    class IGNITION_RENDERING_VISIBLE FrameRecorder
+    {
+      /// \brief Constructor
+      public: FrameRecorder();
+
+      /// \brief Destructor. Stops recording and waits for queued frames to
+      /// be saved.
+      public: virtual ~FrameRecorder();
+
+      /// \brief Set the number of threads encoding frames. Only takes
+      /// effect on the next call to Start().
+      /// \param[in] _count Number of threads, at least 1
+      public: void SetWorkerCount(unsigned int _count);
+
+      /// \brief Get the number of threads encoding frames
+      /// \return Number of threads
+      public: unsigned int WorkerCount() const;
+
+      /// \brief Set the maximum number of frames waiting to be encoded
+      /// \param[in] _size Queue size, at least 1
+      public: void SetQueueSize(unsigned int _size);
+
+      /// \brief Get the maximum number of frames waiting to be encoded
+      /// \return Queue size
+      public: unsigned int QueueSize() const;
+
+      /// \brief Set what happens to new frames when the queue is full
+      /// \param[in] _policy Drop policy
+      public: void SetDropPolicy(FrameDropPolicy _policy);
+
+      /// \brief Get what happens to new frames when the queue is full
+      /// \return Drop policy
+      public: FrameDropPolicy DropPolicy() const;
+
+      /// \brief Start recording. Creates the output directory if needed
+      /// and resets the statistics.
+      /// \param[in] _directory Output directory
+      /// \param[in] _prefix File name prefix
+      /// \param[in] _extension File extension, which selects the format
+      /// \return True if recording started
+      public: bool Start(const std::string &_directory,
+          const std::string &_prefix = "frame",
+          const std::string &_extension = "png");
+
+      /// \brief Stop recording and wait for queued frames to be saved
+      public: void Stop();
+
+      /// \brief Check if recording
+      /// \return True if Start() was called and Stop() was not
+      public: bool Recording() const;
+
+      /// \brief Queue the last frame rendered by a camera
+      /// \param[in] _camera Camera to read the frame from
+      /// \return True if the frame was queued, false if it was dropped or
+      /// the recorder is not recording
+      public: bool AddFrame(const CameraPtr &_camera);
+
+      /// \brief Queue a frame
+      /// \param[in] _image Frame to save
+      /// \return True if the frame was queued, false if it was dropped or
+      /// the recorder is not recording
+      public: bool AddFrame(const Image &_image);
+
+      /// \brief Queue a frame. The signature matches
+      /// Camera::NewFrameListener so the recorder can be connected to the
+      /// new frame event of a camera.
+      /// \param[in] _data Pixel data
+      /// \param[in] _width Width in pixels
+      /// \param[in] _height Height in pixels
+      /// \param[in] _format Pixel format
+      /// \return True if the frame was queued, false if it was dropped or
+      /// the recorder is not recording
+      public: bool AddFrame(const void *_data, unsigned int _width,
+          unsigned int _height, PixelFormat _format);
+
+      /// \brief Wait until all queued frames have been saved. Returns
+      /// immediately if the recorder was not started.
+      public: void Flush();
+
+      /// \brief Get the number of frames waiting to be encoded
+      /// \return Queue depth
+      public: unsigned int QueueDepth() const;
+
+      /// \brief Get the number of frames saved since Start()
+      /// \return Number of frames
+      public: uint64_t FramesSaved() const;
+
+      /// \brief Get the number of frames dropped since Start(), either
+      /// because the queue was full or because they could not be saved
+      /// \return Number of frames
+      public: uint64_t FramesDropped() const;
+
+      /// \brief Get the average number of frames saved per second since
+      /// Start()
+      /// \return Encoding throughput
+      public: double EncodeRate() const;
+
+      /// \brief Save an image to a file, in the current thread
+      /// \param[in] _image Image to save
+      /// \param[in] _filename File name. The extension selects the format,
+      /// see the class description.
+      /// \return True if the file was written
+      public: static bool SaveImage(const Image &_image,
+          const std::string &_filename);
+
+      IGN_COMMON_WARN_IGNORE__DLL_INTERFACE_MISSING
+      /// \brief Private data pointer
+      private: std::unique_ptr<FrameRecorderPrivate> dataPtr;
+      IGN_COMMON_WARN_RESUME__DLL_INTERFACE_MISSING
+    };
+    }
+  }
+}
+#endif
@@ -0,0 +1,144 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_HEIGHTMAP_HH_
+#define IGNITION_RENDERING_HEIGHTMAP_HH_
+
+#include <cstdint>
+#include <memory>
+
+#include <ignition/common/SuppressWarning.hh>
+#include <ignition/math/Vector3.hh>
+
+#include "ignition/rendering/config.hh"
+#include "ignition/rendering/Camera.hh"
+#include "ignition/rendering/HeightmapDescriptor.hh"
+#include "ignition/rendering/Visual.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    // forward declarations
+    class HeightmapPrivate;
+
+    /* \class Heightmap Heightmap.hh \
+     * ignition/rendering/Heightmap.hh
+     */
+    /// \brief Terrain built from a grid of height samples, drawn as a
+    /// quadtree of chunks with distance based level of detail.
+    ///
+    /// Every chunk has the same number of vertices: the root chunk covers
+    /// the whole terrain with the largest sample stride, and each level
+    /// halves the stride of its parent. On Update(), chunks close to the
+    /// camera are replaced by their four children until the finest level is
+    /// reached. Chunk meshes are built the first time they are needed.
+    /// Each chunk has a skirt hanging below its edges so that no gaps are
+    /// visible between neighbouring chunks of different levels.
+    ///
+    /// The terrain is centered on Visual(), with the first row of samples
+    /// at +y. Add Visual() to the scene graph to display it.
+    class IGNITION_RENDERING_VISIBLE Heightmap
+    {
+      /// \brief Constructor
+      /// \param[in] _scene Scene to create the chunks in
+      /// \param[in] _desc Heightmap description
+      public: Heightmap(const ScenePtr &_scene,
+          const HeightmapDescriptor &_desc);
+
+      /// \brief Destructor. Destroys the chunk visuals. Must be called
+      /// before the scene is destroyed.
+      public: virtual ~Heightmap();
+
+      /// \brief Get the heightmap description
+      /// \return Descriptor
+      public: virtual const HeightmapDescriptor &Descriptor() const;
+
+      /// \brief Get the visual the chunks are attached to
+      /// \return Root visual of the terrain
+      public: virtual VisualPtr Visual() const;
+
+      /// \brief Set the camera used to select the chunk levels
+      /// \param[in] _camera Camera
+      public: virtual void SetCamera(const CameraPtr &_camera);
+
+      /// \brief Get the camera used to select the chunk levels
+      /// \return Camera
+      public: virtual CameraPtr Camera() const;
+
+      /// \brief Set the level of detail factor, see
+      /// HeightmapDescriptor::lodFactor
+      /// \param[in] _factor Factor, must be positive
+      public: virtual void SetLodFactor(double _factor);
+
+      /// \brief Get the level of detail factor
+      /// \return Factor
+      public: virtual double LodFactor() const;
+
+      /// \brief Select the chunks to draw for the camera position. Call once
+      /// per frame before rendering. Without camera, the root chunk is
+      /// drawn.
+      public: virtual void Update();
+
+      /// \brief Select the chunks to draw for a view position. Useful for
+      /// sensors such as GpuRays that are not a Camera.
+      /// \param[in] _position View position in world frame
+      public: virtual void Update(const math::Vector3d &_position);
+
+      /// \brief Get the number of levels of the quadtree
+      /// \return Level count
+      public: virtual unsigned int LevelCount() const;
+
+      /// \brief Get the number of chunks drawn after the last update
+      /// \return Visible chunk count
+      public: virtual unsigned int VisibleChunkCount() const;
+
+      /// \brief Get the number of chunks whose mesh has been built
+      /// \return Loaded chunk count
+      public: virtual unsigned int LoadedChunkCount() const;
+
+      /// \brief Get the number of vertices drawn after the last update,
+      /// including skirts
+      /// \return Vertex count
+      public: virtual uint64_t VisibleVertexCount() const;
+
+      /// \brief Get the height of the terrain below a point, interpolated
+      /// from the samples rather than from the drawn chunks. Assumes the
+      /// terrain is only rotated around the vertical axis.
+      /// \param[in] _x X position in world frame
+      /// \param[in] _y Y position in world frame
+      /// \return Height in world frame, or NaN outside of the terrain
+      public: virtual double HeightAt(double _x, double _y) const;
+
+      /// \brief Intersect a ray with the terrain surface, on the CPU
+      /// \param[in] _origin Ray origin in world frame
+      /// \param[in] _direction Ray direction in world frame
+      /// \param[out] _distance Distance from the origin to the intersection
+      /// \return True if the ray hits the terrain
+      public: virtual bool Intersect(const math::Vector3d &_origin,
+          const math::Vector3d &_direction, double &_distance) const;
+
+      IGN_COMMON_WARN_IGNORE__DLL_INTERFACE_MISSING
+      /// \brief Private data pointer
+      private: std::unique_ptr<HeightmapPrivate> dataPtr;
+      IGN_COMMON_WARN_RESUME__DLL_INTERFACE_MISSING
+    };
+    }
+  }
+}
+#endif
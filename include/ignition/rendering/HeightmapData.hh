@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_HEIGHTMAPDATA_HH_
+#define IGNITION_RENDERING_HEIGHTMAPDATA_HH_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <ignition/common/SuppressWarning.hh>
+
+#include "ignition/rendering/config.hh"
+#include "ignition/rendering/Export.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    // forward declarations
+    class HeightmapDataPrivate;
+
+    /* \class HeightmapData HeightmapData.hh \
+     * ignition/rendering/HeightmapData.hh
+     */
+    /// \brief Grid of height samples used by a Heightmap.
+    ///
+    /// Files are memory mapped rather than read, so that only the parts of
+    /// a large elevation model that are actually sampled are loaded from
+    /// disk. Supported files are binary pgm images (8 or 16 bit) and raw
+    /// 16 bit little endian files. On platforms without memory mapping the
+    /// file is read into memory.
+    class IGNITION_RENDERING_VISIBLE HeightmapData
+    {
+      /// \brief Constructor
+      public: HeightmapData();
+
+      /// \brief Destructor. Unmaps the file.
+      public: virtual ~HeightmapData();
+
+      /// \brief Load a binary pgm image
+      /// \param[in] _filename Path to the image
+      /// \return True if the image was loaded
+      public: bool Load(const std::string &_filename);
+
+      /// \brief Load a raw file of 16 bit little endian samples, stored row
+      /// by row without header
+      /// \param[in] _filename Path to the file
+      /// \param[in] _width Number of samples per row
+      /// \param[in] _height Number of rows
+      /// \return True if the file was loaded
+      public: bool LoadRaw(const std::string &_filename, unsigned int _width,
+          unsigned int _height);
+
+      /// \brief Copy samples from memory
+      /// \param[in] _samples Samples, row by row
+      /// \param[in] _width Number of samples per row
+      /// \param[in] _height Number of rows
+      /// \return True if the sample count matches the size
+      public: bool SetData(const std::vector<uint16_t> &_samples,
+          unsigned int _width, unsigned int _height);
+
+      /// \brief Release the samples
+      public: void Close();
+
+      /// \brief Get the number of samples per row
+      /// \return Width
+      public: unsigned int Width() const;
+
+      /// \brief Get the number of rows
+      /// \return Height
+      public: unsigned int Height() const;
+
+      /// \brief Check if the samples are read from a memory mapped file
+      /// \return True if memory mapped
+      public: bool MemoryMapped() const;
+
+      /// \brief Get a sample. Coordinates are clamped to the grid.
+      /// \param[in] _x Column
+      /// \param[in] _y Row
+      /// \return Sample normalized to [0, 1]
+      public: double Value(unsigned int _x, unsigned int _y) const;
+
+      /// \brief Get a bilinearly interpolated sample. Coordinates are
+      /// clamped to the grid.
+      /// \param[in] _x Column
+      /// \param[in] _y Row
+      /// \return Sample normalized to [0, 1]
+      public: double Interpolate(double _x, double _y) const;
+
+      IGN_COMMON_WARN_IGNORE__DLL_INTERFACE_MISSING
+      /// \brief Private data pointer
+      private: std::unique_ptr<HeightmapDataPrivate> dataPtr;
+      IGN_COMMON_WARN_RESUME__DLL_INTERFACE_MISSING
+    };
+    }
+  }
+}
+#endif
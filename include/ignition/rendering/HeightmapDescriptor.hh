@@ -0,0 +1,59 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_HEIGHTMAPDESCRIPTOR_HH_
+#define IGNITION_RENDERING_HEIGHTMAPDESCRIPTOR_HH_
+
+#include <memory>
+
+#include <ignition/math/Vector3.hh>
+
+#include "ignition/rendering/config.hh"
+#include "ignition/rendering/HeightmapData.hh"
+#include "ignition/rendering/RenderTypes.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    /// \brief Describes a heightmap to create with Scene::CreateHeightmap
+    struct HeightmapDescriptor
+    {
+      /// \brief Height samples. The first row of samples is at +y.
+      std::shared_ptr<HeightmapData> data;
+
+      /// \brief Size of the terrain. X and Y are the extent of the samples,
+      /// Z is the height of a sample of value 1.
+      math::Vector3d size = math::Vector3d(100, 100, 10);
+
+      /// \brief Number of vertices along each side of a chunk. All chunks
+      /// have the same vertex count, chunks of coarser levels skip samples.
+      unsigned int chunkSize = 65u;
+
+      /// \brief A chunk is split into its four children when the distance
+      /// to the camera is less than its size times this factor. Larger
+      /// values give more detail.
+      double lodFactor = 2.0;
+
+      /// \brief Material of the terrain. A default material is used if null.
+      MaterialPtr material;
+    };
+    }
+  }
+}
+#endif
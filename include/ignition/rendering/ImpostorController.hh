@@ -0,0 +1,143 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_IMPOSTORCONTROLLER_HH_
+#define IGNITION_RENDERING_IMPOSTORCONTROLLER_HH_
+
+#include <memory>
+#include <string>
+
+#include <ignition/common/SuppressWarning.hh>
+
+#include "ignition/rendering/config.hh"
+#include "ignition/rendering/Camera.hh"
+#include "ignition/rendering/Visual.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    // forward declarations
+    class ImpostorControllerPrivate;
+
+    /* \class ImpostorController ImpostorController.hh \
+     * ignition/rendering/ImpostorController.hh
+     */
+    /// \brief Replaces distant visuals with camera facing billboards
+    /// (impostors) to reduce draw calls and vertex work.
+    ///
+    /// When a visual is added, the controller renders it from a number of
+    /// directions around the vertical axis with an offscreen camera and
+    /// stores the images as textures. Visuals added with the same key share
+    /// these textures, so repeated objects such as trees or vehicles are
+    /// only rendered once. On every Update(), visuals whose projected size
+    /// in the camera image is below the screen size threshold are hidden and
+    /// replaced by a billboard textured with the view closest to the camera
+    /// direction. The billboards of all the visuals added with the same key
+    /// are drawn together as a single billboard set, and write depth so they
+    /// are correctly sorted against other objects. Visuals hidden with
+    /// Visual::SetVisible are not replaced, and visuals switched back get
+    /// the visibility they had before.
+    class IGNITION_RENDERING_VISIBLE ImpostorController
+    {
+      /// \brief Constructor
+      public: ImpostorController();
+
+      /// \brief Destructor. Restores the visuals and destroys the impostors.
+      public: virtual ~ImpostorController();
+
+      /// \brief Set the camera used to compute the screen size of visuals
+      /// \param[in] _camera Camera
+      public: virtual void SetCamera(const CameraPtr &_camera);
+
+      /// \brief Get the camera used to compute the screen size of visuals
+      /// \return Camera
+      public: virtual CameraPtr Camera() const;
+
+      /// \brief Set the screen size below which visuals are drawn as
+      /// impostors
+      /// \param[in] _pixels Size of the visual bounds in the camera image,
+      /// in pixels
+      public: virtual void SetScreenSizeThreshold(double _pixels);
+
+      /// \brief Get the screen size below which visuals are drawn as
+      /// impostors
+      /// \return Size in pixels
+      public: virtual double ScreenSizeThreshold() const;
+
+      /// \brief Set the number of directions each visual is rendered from.
+      /// Only affects visuals added afterwards with a new key.
+      /// \param[in] _count Number of views around the vertical axis
+      public: virtual void SetViewCount(unsigned int _count);
+
+      /// \brief Get the number of directions each visual is rendered from
+      /// \return Number of views around the vertical axis
+      public: virtual unsigned int ViewCount() const;
+
+      /// \brief Set the resolution of each impostor view. Only affects
+      /// visuals added afterwards with a new key.
+      /// \param[in] _size Width and height of a view in pixels
+      public: virtual void SetTextureSize(unsigned int _size);
+
+      /// \brief Get the resolution of each impostor view
+      /// \return Width and height of a view in pixels
+      public: virtual unsigned int TextureSize() const;
+
+      /// \brief Add a visual to be replaced by an impostor when far away.
+      /// The impostor textures are generated the first time a key is used,
+      /// which renders the scene.
+      /// \param[in] _visual Visual to manage
+      /// \param[in] _key Visuals that look the same should use the same key
+      /// to share impostor textures
+      /// \return True if the visual was added
+      public: virtual bool AddVisual(const VisualPtr &_visual,
+          const std::string &_key);
+
+      /// \brief Stop managing a visual. The visual is shown again if it was
+      /// replaced by an impostor.
+      /// \param[in] _visual Visual to remove
+      /// \return True if the visual was removed
+      public: virtual bool RemoveVisual(const VisualPtr &_visual);
+
+      /// \brief Get the number of managed visuals
+      /// \return Number of visuals
+      public: virtual unsigned int VisualCount() const;
+
+      /// \brief Get the number of visuals currently drawn as impostors
+      /// \return Number of impostors
+      public: virtual unsigned int ImpostorCount() const;
+
+      /// \brief Check if a visual is currently drawn as an impostor
+      /// \param[in] _visual Visual to check
+      /// \return True if the visual is replaced by its impostor
+      public: virtual bool IsImpostor(const VisualPtr &_visual) const;
+
+      /// \brief Switch visuals between meshes and impostors based on their
+      /// screen size, and turn impostors towards the camera. Call once per
+      /// frame before rendering.
+      public: virtual void Update();
+
+      IGN_COMMON_WARN_IGNORE__DLL_INTERFACE_MISSING
+      /// \brief Private data pointer
+      private: std::unique_ptr<ImpostorControllerPrivate> dataPtr;
+      IGN_COMMON_WARN_RESUME__DLL_INTERFACE_MISSING
+    };
+    }
+  }
+}
+#endif
@@ -17,8 +17,12 @@
 #ifndef IGNITION_RENDERING_MARKER_HH_
 #define IGNITION_RENDERING_MARKER_HH_
 
+#include <vector>
+
 #include <ignition/common/Time.hh>
 #include <ignition/math/Color.hh>
+#include <ignition/math/Pose3.hh>
+#include <ignition/math/Vector2.hh>
 #include <ignition/math/Vector3.hh>
 #include "ignition/rendering/config.hh"
 #include "ignition/rendering/Geometry.hh"
@@ -65,7 +69,13 @@ namespace ignition
       MT_TRIANGLE_LIST  = 9,
 
       /// \brief Triangle strip primitive
-      MT_TRIANGLE_STRIP = 10
+      MT_TRIANGLE_STRIP = 10,
+      /// \brief List of box geometries drawn together
+      MT_BOX_LIST       = 11,
+      /// \brief List of cylinder geometries drawn together
+      MT_CYLINDER_LIST  = 12,
+      /// \brief List of sphere geometries drawn together
+      MT_SPHERE_LIST    = 13
     };
 
     /// \class Marker Marker.hh ignition/rendering/Marker
@@ -128,6 +138,41 @@ namespace ignition
       /// \param[in] _value The new positional vector of the point
       public: virtual void SetPoint(unsigned int _index,
                   const ignition::math::Vector3d &_value) = 0;
+
+      /// \brief Set the texture coordinates of an existing point. They are
+      /// used by triangle markers with a textured material, e.g. to draw
+      /// many textured quads in a single call. Points are added with (0, 0)
+      /// texture coordinates.
+      /// \param[in] _index The index of the point
+      /// \param[in] _texCoord The new texture coordinates of the point
+      public: virtual void SetPointTexCoord(unsigned int _index,
+                  const ignition::math::Vector2d &_texCoord) = 0;
+
+      /// \brief Set the shapes of a list marker (MT_BOX_LIST,
+      /// MT_CYLINDER_LIST or MT_SPHERE_LIST). All shapes are instances of
+      /// one shared unit primitive. The shapes are updated before the next
+      /// render, not on every call.
+      /// Scales and colors can be empty to use unit size and white, have a
+      /// single value used for all shapes, or have one value per shape.
+      /// If colors are empty, the ogre2 engine uses the marker material.
+      /// \param[in] _poses Pose of each shape relative to the marker
+      /// \param[in] _scales Size of the shapes
+      /// \param[in] _colors Color of the shapes
+      public: virtual void SetListElements(
+                  const std::vector<ignition::math::Pose3d> &_poses,
+                  const std::vector<ignition::math::Vector3d> &_scales,
+                  const std::vector<ignition::math::Color> &_colors) = 0;
+
+      /// \brief Get the number of shapes of a list marker
+      /// \return Number of shapes set by SetListElements
+      public: virtual unsigned int ListElementCount() const = 0;
+
+      /// \brief Get the color of a shape of a list marker
+      /// \param[in] _index Index of the shape
+      /// \return Color of the shape, white if no colors were set or the
+      /// index is out of range
+      public: virtual ignition::math::Color ListElementColor(
+                  unsigned int _index) const = 0;
     };
     }
   }
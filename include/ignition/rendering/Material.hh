@@ -17,8 +17,10 @@
 #ifndef IGNITION_RENDERING_MATERIAL_HH_
 #define IGNITION_RENDERING_MATERIAL_HH_
 
+#include <memory>
 #include <string>
 #include <ignition/math/Color.hh>
+#include <ignition/common/Image.hh>
 #include <ignition/common/Material.hh>
 #include "ignition/rendering/config.hh"
 #include "ignition/rendering/RenderTypes.hh"
@@ -223,6 +225,16 @@ namespace ignition
       /// \param[in] _name URI of the new texture file
       public: virtual void SetTexture(const std::string &_name) = 0;
 
+      /// \brief Set the material texture from an image in memory, e.g. one
+      /// rendered at run time, without writing it to a file first
+      /// \param[in] _name Unique name of the new texture. Texture() returns
+      /// it, and materials setting a texture with the same name share it.
+      /// The texture is removed when the material that created it is
+      /// destroyed or given another texture from memory.
+      /// \param[in] _img Image of the texture
+      public: virtual void SetTexture(const std::string &_name,
+                  const std::shared_ptr<const common::Image> &_img) = 0;
+
       /// \brief Removes any texture mapped to this material
       public: virtual void ClearTexture() = 0;
 
@@ -77,6 +77,13 @@ namespace ignition
 
       /// \brief Denotes if the loaded sub-mesh vertices should be centered
       public: bool centerSubMesh = false;
+
+      /// \brief Denotes if the loaded triangle list sub-meshes should be
+      /// optimized for GPU processing: duplicate vertices are welded,
+      /// triangles are reordered for vertex cache locality and overdraw and
+      /// vertices are reordered for fetch locality.
+      /// \sa MeshOptimizer
+      public: bool optimizeMesh = false;
     };
     }
   }
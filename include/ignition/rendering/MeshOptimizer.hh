@@ -0,0 +1,144 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_MESHOPTIMIZER_HH_
+#define IGNITION_RENDERING_MESHOPTIMIZER_HH_
+
+#include <vector>
+
+#include <ignition/common/SubMesh.hh>
+
+#include "ignition/rendering/config.hh"
+#include "ignition/rendering/Export.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    /// \class MeshOptimizer MeshOptimizer.hh
+    /// ignition/rendering/MeshOptimizer.hh
+    /// \brief CPU-only utilities that reorder triangle list geometry for
+    /// efficient GPU processing. All functions are deterministic: the same
+    /// input always produces the same output.
+    ///
+    /// Vertex data is passed as an interleaved array of floats where each
+    /// vertex occupies _stride floats and the first three floats of each
+    /// vertex are its position. Index data is a triangle list.
+    class IGNITION_RENDERING_VISIBLE MeshOptimizer
+    {
+      /// \brief Value stored in a remap table for vertices that are no
+      /// longer referenced after an operation.
+      public: static const unsigned int kUnused;
+
+      /// \brief Merge vertices whose attributes are bitwise identical and
+      /// update the indices to reference the merged vertices. Merged vertices
+      /// keep the order of their first occurrence.
+      /// \param[in,out] _vertices Interleaved vertex data
+      /// \param[in] _stride Number of floats per vertex
+      /// \param[in,out] _indices Triangle list indices
+      /// \param[out] _remap Table mapping each original vertex index to its
+      /// new index
+      /// \return Number of vertices after welding
+      public: static unsigned int WeldVertices(std::vector<float> &_vertices,
+          unsigned int _stride, std::vector<unsigned int> &_indices,
+          std::vector<unsigned int> &_remap);
+
+      /// \brief Reorder triangles to improve post-transform vertex cache
+      /// locality using Tom Forsyth's linear-speed vertex cache
+      /// optimization algorithm.
+      /// \param[in,out] _indices Triangle list indices
+      /// \param[in] _vertexCount Number of vertices referenced by _indices
+      public: static void OptimizeVertexCache(
+          std::vector<unsigned int> &_indices, unsigned int _vertexCount);
+
+      /// \brief Reorder clusters of triangles to reduce overdraw. The
+      /// triangle list is split into clusters wherever the vertex cache would
+      /// be cold anyway, so this should be called after OptimizeVertexCache
+      /// and has little effect on the cache miss ratio. Clusters that face
+      /// outwards from the mesh center are drawn first.
+      /// \param[in,out] _indices Triangle list indices
+      /// \param[in] _vertices Interleaved vertex data
+      /// \param[in] _stride Number of floats per vertex
+      /// \param[in] _cacheSize Size of the simulated FIFO vertex cache used
+      /// to find cluster boundaries
+      public: static void OptimizeOverdraw(std::vector<unsigned int> &_indices,
+          const std::vector<float> &_vertices, unsigned int _stride,
+          unsigned int _cacheSize = 16u);
+
+      /// \brief Reorder vertices in the order they are first referenced by
+      /// the indices to improve vertex fetch locality. Vertices that are not
+      /// referenced are removed.
+      /// \param[in,out] _vertices Interleaved vertex data
+      /// \param[in] _stride Number of floats per vertex
+      /// \param[in,out] _indices Triangle list indices
+      /// \param[out] _remap Table mapping each original vertex index to its
+      /// new index, or kUnused if the vertex was removed
+      /// \return Number of vertices after reordering
+      public: static unsigned int OptimizeVertexFetch(
+          std::vector<float> &_vertices, unsigned int _stride,
+          std::vector<unsigned int> &_indices,
+          std::vector<unsigned int> &_remap);
+
+      /// \brief Run all optimization stages in order: vertex welding,
+      /// vertex cache, overdraw and vertex fetch optimization.
+      /// \param[in,out] _vertices Interleaved vertex data
+      /// \param[in] _stride Number of floats per vertex
+      /// \param[in,out] _indices Triangle list indices
+      /// \param[out] _remap Table mapping each original vertex index to its
+      /// new index, or kUnused if the vertex was removed
+      /// \return Number of vertices after optimization
+      public: static unsigned int Optimize(std::vector<float> &_vertices,
+          unsigned int _stride, std::vector<unsigned int> &_indices,
+          std::vector<unsigned int> &_remap);
+
+      /// \brief Get an optimized copy of a sub-mesh. Only triangle list
+      /// sub-meshes are optimized. Unindexed sub-meshes are indexed first.
+      /// Positions, normals, the first set of texture coordinates and node
+      /// assignments are preserved. Other sub-meshes are returned unchanged.
+      /// \param[in] _subMesh Sub-mesh to optimize
+      /// \return Optimized copy of the sub-mesh
+      public: static common::SubMesh Optimize(
+          const common::SubMesh &_subMesh);
+
+      /// \brief Get the average cache miss ratio (ACMR) of a triangle list,
+      /// i.e. the number of vertex shader invocations per triangle for a
+      /// simulated FIFO post-transform vertex cache. Values range from 3
+      /// (no reuse) down to about 0.5 for a perfectly ordered regular grid.
+      /// \param[in] _indices Triangle list indices
+      /// \param[in] _cacheSize Size of the simulated FIFO vertex cache
+      /// \return Average cache miss ratio, or 0 if there are no triangles
+      public: static double AverageCacheMissRatio(
+          const std::vector<unsigned int> &_indices,
+          unsigned int _cacheSize = 16u);
+
+      /// \brief Get the ratio of vertex shader invocations to vertex count
+      /// (ATVR) for a simulated FIFO post-transform vertex cache. The
+      /// optimal value is 1.
+      /// \param[in] _indices Triangle list indices
+      /// \param[in] _vertexCount Number of vertices referenced by _indices
+      /// \param[in] _cacheSize Size of the simulated FIFO vertex cache
+      /// \return Average transform to vertex ratio, or 0 if there are no
+      /// vertices
+      public: static double AverageTransformToVertexRatio(
+          const std::vector<unsigned int> &_indices, unsigned int _vertexCount,
+          unsigned int _cacheSize = 16u);
+    };
+    }
+  }
+}
+#endif
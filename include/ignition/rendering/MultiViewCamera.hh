@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_MULTIVIEWCAMERA_HH_
+#define IGNITION_RENDERING_MULTIVIEWCAMERA_HH_
+
+#include <ignition/math/Pose3.hh>
+
+#include "ignition/rendering/Camera.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    /* \class MultiViewCamera MultiViewCamera.hh \
+      * ignition/rendering/MultiViewCamera.hh
+     */
+    /// \brief Camera that renders several closely spaced views of the scene,
+    /// e.g. a stereo pair or a ring of cameras, in a single pass over the
+    /// scene. The views are packed side by side, from left to right in the
+    /// order they were added, into one image whose width is the image width
+    /// of the camera. The image width should therefore be a multiple of the
+    /// number of views. The field of view, clip planes and visibility mask
+    /// of the camera apply to every view, and the aspect ratio of each view
+    /// is the one of its slice of the image. Render engines share the work
+    /// that does not depend on the viewpoint, such as updating the scene,
+    /// between the views. Shadow maps are fitted to the frustum of a view,
+    /// so they are only shared with the first view by views that look in
+    /// about the same direction from about the same place, e.g. a stereo
+    /// pair; other views, e.g. a ring of cameras, render their own.
+    /// Occlusion culling is not supported. Without views the camera
+    /// renders a single view from its own pose.
+    class IGNITION_RENDERING_VISIBLE MultiViewCamera :
+      public virtual Camera
+    {
+      /// \brief Destructor
+      public: virtual ~MultiViewCamera() { }
+
+      /// \brief Add a view to the camera
+      /// \param[in] _pose Pose of the view relative to the camera
+      /// \return Index of the new view
+      public: virtual unsigned int AddView(const math::Pose3d &_pose) = 0;
+
+      /// \brief Get the number of views of the camera
+      /// \return Number of views
+      public: virtual unsigned int ViewCount() const = 0;
+
+      /// \brief Get the pose of a view relative to the camera
+      /// \param[in] _index Index of the view
+      /// \return Pose of the view, or identity if the index is out of range
+      /// \sa SetViewPose
+      public: virtual math::Pose3d ViewPose(unsigned int _index) const = 0;
+
+      /// \brief Set the pose of a view relative to the camera
+      /// \param[in] _index Index of the view
+      /// \param[in] _pose Pose of the view relative to the camera
+      /// \sa ViewPose
+      public: virtual void SetViewPose(unsigned int _index,
+                  const math::Pose3d &_pose) = 0;
+
+      /// \brief Remove all views of the camera
+      public: virtual void ClearViews() = 0;
+    };
+    }
+  }
+}
+#endif
@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_OCCLUSIONBUFFER_HH_
+#define IGNITION_RENDERING_OCCLUSIONBUFFER_HH_
+
+#include <memory>
+
+#include <ignition/common/SuppressWarning.hh>
+#include <ignition/math/AxisAlignedBox.hh>
+#include <ignition/math/Matrix4.hh>
+
+#include "ignition/rendering/config.hh"
+#include "ignition/rendering/Export.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    // forward declarations
+    class OcclusionBufferPrivate;
+
+    /// \class OcclusionBuffer OcclusionBuffer.hh
+    /// ignition/rendering/OcclusionBuffer.hh
+    /// \brief Low resolution software depth buffer with a hierarchical-Z
+    /// (Hi-Z) pyramid, used to reject objects hidden behind large occluders
+    /// before they are submitted for rendering.
+    ///
+    /// Typical use for each frame: call Clear() with the camera matrices,
+    /// rasterize the occluders with AddOccluder(), call BuildPyramid() and
+    /// then test objects with IsOccluded(). Occluders are rasterized as
+    /// boxes so they should be solid objects that fill their bounds, such
+    /// as walls and floors.
+    class IGNITION_RENDERING_VISIBLE OcclusionBuffer
+    {
+      /// \brief Constructor
+      public: OcclusionBuffer();
+
+      /// \brief Destructor
+      public: ~OcclusionBuffer();
+
+      /// \brief Set the resolution of the depth buffer
+      /// \param[in] _width Width in pixels
+      /// \param[in] _height Height in pixels
+      public: void Resize(unsigned int _width, unsigned int _height);
+
+      /// \brief Get the width of the depth buffer
+      /// \return Width in pixels
+      public: unsigned int Width() const;
+
+      /// \brief Get the height of the depth buffer
+      /// \return Height in pixels
+      public: unsigned int Height() const;
+
+      /// \brief Clear the depth buffer and set the camera used for
+      /// subsequent calls
+      /// \param[in] _viewProjection Projection matrix multiplied by the
+      /// view matrix of the camera
+      public: void Clear(const math::Matrix4d &_viewProjection);
+
+      /// \brief Rasterize a solid box into the depth buffer
+      /// \param[in] _box Box in the local frame of the occluder
+      /// \param[in] _transform Local to world transform of the occluder,
+      /// including scale
+      public: void AddOccluder(const math::AxisAlignedBox &_box,
+          const math::Matrix4d &_transform);
+
+      /// \brief Build the Hi-Z pyramid from the depth buffer. Must be called
+      /// after adding occluders and before testing objects.
+      public: void BuildPyramid();
+
+      /// \brief Check if a box is completely hidden by the occluders
+      /// \param[in] _box World axis aligned box
+      /// \return True if the box is occluded. Boxes that cross the near
+      /// plane or lie outside the view are never reported as occluded.
+      public: bool IsOccluded(const math::AxisAlignedBox &_box) const;
+
+      /// \internal
+      /// \brief Private data pointer
+      IGN_COMMON_WARN_IGNORE__DLL_INTERFACE_MISSING
+      private: std::unique_ptr<OcclusionBufferPrivate> dataPtr;
+      IGN_COMMON_WARN_RESUME__DLL_INTERFACE_MISSING
+    };
+    }
+  }
+}
+#endif
@@ -93,6 +93,52 @@ namespace ignition
       /// \return Render pass at the specified index
       public: virtual RenderPassPtr RenderPassByIndex(unsigned int _index)
           const = 0;
+
+      /// \brief Enable or disable dynamic resolution. When enabled, the
+      /// render target measures the time taken by each frame and renders
+      /// the scene at a fraction of its resolution, within the range set by
+      /// SetResolutionScaleRange, so that frames take about the target frame
+      /// time. The image is upscaled to the full resolution in the final
+      /// compositor pass. Render engines that cannot render at a lower
+      /// resolution always report a ResolutionScale of 1.
+      /// \param[in] _enabled True to enable dynamic resolution
+      public: virtual void SetDynamicResolution(bool _enabled) = 0;
+
+      /// \brief Get whether dynamic resolution is enabled
+      /// \return True if dynamic resolution is enabled
+      public: virtual bool DynamicResolution() const = 0;
+
+      /// \brief Set the frame time dynamic resolution tries to hold
+      /// \param[in] _seconds Target frame time in seconds
+      public: virtual void SetTargetFrameTime(double _seconds) = 0;
+
+      /// \brief Get the frame time dynamic resolution tries to hold
+      /// \return Target frame time in seconds
+      public: virtual double TargetFrameTime() const = 0;
+
+      /// \brief Set the range of the dynamic resolution scale
+      /// \param[in] _min Minimum fraction of the resolution
+      /// \param[in] _max Maximum fraction of the resolution
+      public: virtual void SetResolutionScaleRange(double _min,
+                  double _max) = 0;
+
+      /// \brief Get the minimum dynamic resolution scale
+      /// \return Minimum fraction of the resolution
+      public: virtual double MinResolutionScale() const = 0;
+
+      /// \brief Get the maximum dynamic resolution scale
+      /// \return Maximum fraction of the resolution
+      public: virtual double MaxResolutionScale() const = 0;
+
+      /// \brief Set the resolution scale used when dynamic resolution is
+      /// disabled. Forcing a scale gives deterministic output for testing.
+      /// \param[in] _scale Fraction of the resolution, in [0.1, 1]
+      public: virtual void SetResolutionScale(double _scale) = 0;
+
+      /// \brief Get the resolution scale the scene is currently rendered
+      /// at
+      /// \return Fraction of the resolution
+      public: virtual double ResolutionScale() const = 0;
     };
 
     /* \class RenderTexture RenderTexture.hh \
@@ -37,6 +37,17 @@
 /// \brief Render visuals that are selectable mask.
 #define IGN_VISIBILITY_SELECTABLE      0x00000002
 
+/// \def IGN_VISIBILITY_LAYERS
+/// \brief Visibility flags given to the named visibility layers of a
+/// scene, see Scene::VisibilityLayer.
+#define IGN_VISIBILITY_LAYERS          0x000FFF00
+
+/// \def IGN_VISIBILITY_OCCLUDER
+/// \brief Visuals that hide other objects from cameras with occlusion
+/// culling enabled. Not part of IGN_VISIBILITY_ALL so it does not affect
+/// visibility masks.
+#define IGN_VISIBILITY_OCCLUDER        0x20000000
+
 namespace ignition
 {
   namespace rendering
@@ -48,6 +59,7 @@ namespace ignition
 
     class ArrowVisual;
     class AxisVisual;
+    class BoundingBoxCamera;
     class Camera;
     class DepthCamera;
     class DirectionalLight;
@@ -56,6 +68,7 @@ namespace ignition
     class GizmoVisual;
     class GpuRays;
     class Grid;
+    class Heightmap;
     class JointVisual;
     class Image;
     class Light;
@@ -63,6 +76,7 @@ namespace ignition
     class Material;
     class Marker;
     class Mesh;
+    class MultiViewCamera;
     class Node;
     class Object;
     class ObjectFactory;
@@ -105,6 +119,14 @@ namespace ignition
     /// \brief Shared pointer to ThermalCamera
     typedef shared_ptr<ThermalCamera> ThermalCameraPtr;
 
+    /// \def BoundingBoxCameraPtr
+    /// \brief Shared pointer to BoundingBoxCamera
+    typedef shared_ptr<BoundingBoxCamera> BoundingBoxCameraPtr;
+
+    /// \def MultiViewCameraPtr
+    /// \brief Shared pointer to MultiViewCamera
+    typedef shared_ptr<MultiViewCamera> MultiViewCameraPtr;
+
     /// \def GpuRaysPtr
     /// \brief Shared pointer to GpuRays
     typedef shared_ptr<GpuRays> GpuRaysPtr;
@@ -129,6 +151,10 @@ namespace ignition
     /// \brief Shared pointer to Grid
     typedef shared_ptr<Grid> GridPtr;
 
+    /// \def HeightmapPtr
+    /// \brief Shared pointer to Heightmap
+    typedef shared_ptr<Heightmap> HeightmapPtr;
+
     /// \def JointVisualPtr
     /// \brief Shared pointer to JointVisual
     typedef shared_ptr<JointVisual> JointVisualPtr;
@@ -251,6 +277,14 @@ namespace ignition
     /// \brief Shared pointer to const ThermalCamera
     typedef shared_ptr<const ThermalCamera> ConstThermalCameraPtr;
 
+    /// \def const BoundingBoxCameraPtr
+    /// \brief Shared pointer to const BoundingBoxCamera
+    typedef shared_ptr<const BoundingBoxCamera> ConstBoundingBoxCameraPtr;
+
+    /// \def const MultiViewCameraPtr
+    /// \brief Shared pointer to const MultiViewCamera
+    typedef shared_ptr<const MultiViewCamera> ConstMultiViewCameraPtr;
+
     /// \def const GpuRaysPtr
     /// \brief Shared pointer to const GpuRays
     typedef shared_ptr<const GpuRays> ConstGpuRaysPtr;
@@ -271,6 +305,10 @@ namespace ignition
     /// \brief Shared pointer to const GizmoVisual
     typedef shared_ptr<const GizmoVisual> ConstGizmoVisualPtr;
 
+    /// \def const HeightmapPtr
+    /// \brief Shared pointer to const Heightmap
+    typedef shared_ptr<const Heightmap> ConstHeightmapPtr;
+
     /// \def const JointVisualPtr
     /// \brief Shared pointer to const JointVisual
     typedef shared_ptr<const JointVisual> ConstJointVisualPtr;
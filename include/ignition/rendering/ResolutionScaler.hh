@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_RESOLUTIONSCALER_HH_
+#define IGNITION_RENDERING_RESOLUTIONSCALER_HH_
+
+#include <memory>
+
+#include <ignition/common/SuppressWarning.hh>
+
+#include "ignition/rendering/config.hh"
+#include "ignition/rendering/Export.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    // forward declarations
+    class ResolutionScalerPrivate;
+
+    /// \class ResolutionScaler ResolutionScaler.hh
+    /// ignition/rendering/ResolutionScaler.hh
+    /// \brief Chooses the fraction of the output resolution a render target
+    /// renders at so that frames take about a target time.
+    ///
+    /// Render targets feed the measured time of each frame to Update().
+    /// When dynamic, the scale goes down while frames are slower than the
+    /// target and back up once they are comfortably faster, within the
+    /// configured range. Changes are made in steps of 0.05 and followed by
+    /// a few frames without change, so the scale does not oscillate. When
+    /// not dynamic, the fixed scale is used and frame times are ignored,
+    /// which gives deterministic output for testing.
+    class IGNITION_RENDERING_VISIBLE ResolutionScaler
+    {
+      /// \brief Constructor
+      public: ResolutionScaler();
+
+      /// \brief Destructor
+      public: ~ResolutionScaler();
+
+      /// \brief Set whether the scale adapts to the frame time
+      /// \param[in] _dynamic True to adapt the scale, false to use the
+      /// fixed scale
+      public: void SetDynamic(bool _dynamic);
+
+      /// \brief Get whether the scale adapts to the frame time
+      /// \return True if the scale adapts to the frame time
+      public: bool Dynamic() const;
+
+      /// \brief Set the frame time to hold. The default is 1/30 s.
+      /// \param[in] _seconds Target frame time in seconds
+      public: void SetTargetFrameTime(double _seconds);
+
+      /// \brief Get the frame time to hold
+      /// \return Target frame time in seconds
+      public: double TargetFrameTime() const;
+
+      /// \brief Set the range of the dynamic scale. The default is
+      /// [0.5, 1]. Values are clamped to [0.1, 1].
+      /// \param[in] _min Minimum scale
+      /// \param[in] _max Maximum scale
+      public: void SetScaleRange(double _min, double _max);
+
+      /// \brief Get the minimum dynamic scale
+      /// \return Minimum scale
+      public: double MinScale() const;
+
+      /// \brief Get the maximum dynamic scale
+      /// \return Maximum scale
+      public: double MaxScale() const;
+
+      /// \brief Set the scale used when not dynamic. The default is 1.
+      /// The value is clamped to [0.1, 1].
+      /// \param[in] _scale Fixed scale
+      public: void SetFixedScale(double _scale);
+
+      /// \brief Get the scale used when not dynamic
+      /// \return Fixed scale
+      public: double FixedScale() const;
+
+      /// \brief Get the current scale
+      /// \return Fraction of the output resolution to render at
+      public: double Scale() const;
+
+      /// \brief Record the time taken by a frame and update the scale
+      /// \param[in] _frameTime Frame time in seconds
+      /// \return True if the scale changed
+      public: bool Update(double _frameTime);
+
+      /// \brief Forget the recorded frame times, e.g. after the render
+      /// target is resized
+      public: void Reset();
+
+      IGN_COMMON_WARN_IGNORE__DLL_INTERFACE_MISSING
+      /// \brief Private data pointer
+      private: std::unique_ptr<ResolutionScalerPrivate> dataPtr;
+      IGN_COMMON_WARN_RESUME__DLL_INTERFACE_MISSING
+    };
+    }
+  }
+}
+#endif
@@ -20,6 +20,7 @@
 #include <array>
 #include <string>
 #include <limits>
+#include <vector>
 
 #include <ignition/common/Material.hh>
 #include <ignition/common/Mesh.hh>
@@ -28,9 +29,11 @@
 #include <ignition/math/Color.hh>
 
 #include "ignition/rendering/config.hh"
+#include "ignition/rendering/HeightmapDescriptor.hh"
 #include "ignition/rendering/MeshDescriptor.hh"
 #include "ignition/rendering/RenderTypes.hh"
 #include "ignition/rendering/Storage.hh"
+#include "ignition/rendering/VisualMaterialUpdate.hh"
 #include "ignition/rendering/Export.hh"
 
 namespace ignition
@@ -40,6 +43,9 @@ namespace ignition
     inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
     //
     class RenderEngine;
+    class VisibilityIndex;
+    template <class T> class BaseNode;
+    template <class T> class BaseVisual;
 
     /// \class Scene Scene.hh ignition/rendering/Scene.hh
     /// \brief Manages a single scene-graph. This class updates scene-wide
@@ -494,6 +500,52 @@ namespace ignition
       /// \brief Unregister and destroys all registered materials
       public: virtual void DestroyMaterials() = 0;
 
+      /// \brief Set the diffuse color, emissive color and transparency of
+      /// many visuals in one call. Instead of giving each visual its own
+      /// material, visuals whose original materials are equal, e.g. unique
+      /// clones of one material, and with the same new properties share one
+      /// material. It is created the first time the combination is used and
+      /// destroyed when no visual uses it anymore. Visuals stop using it
+      /// when they are destroyed or given another material with
+      /// Visual::SetMaterial.
+      /// Colors are quantized to 8 bits per channel for sharing. The new
+      /// material is set on all geometries and child visuals, so visuals
+      /// with a different material per submesh get a single material.
+      /// \param[in] _updates Visuals and their new material properties
+      public: virtual void UpdateVisualMaterials(
+                  const std::vector<VisualMaterialUpdate> &_updates) = 0;
+
+      /// \brief Restore the material a visual had before it was first
+      /// updated with UpdateVisualMaterials
+      /// \param[in] _visual Visual to restore
+      public: virtual void ResetVisualMaterial(VisualPtr _visual) = 0;
+
+      /// \brief Get the number of materials shared by visuals updated with
+      /// UpdateVisualMaterials
+      /// \return Number of shared materials
+      public: virtual unsigned int BatchMaterialCount() const = 0;
+
+      /// \brief Get the visibility flag of a named visibility layer. The
+      /// layer is created the first time its name is used and is given one
+      /// of the flags in IGN_VISIBILITY_LAYERS. Visuals are assigned to a
+      /// layer with Visual::SetVisibilityLayer, and sensors show or hide
+      /// the layer with Sensor::SetVisibilityLayerEnabled. Toggling a layer
+      /// only changes the visibility mask of the sensor, so its cost does
+      /// not depend on the number of visuals in the layer.
+      /// \param[in] _name Name of the layer
+      /// \return Visibility flag of the layer, or 0 if all layer flags are
+      /// already in use
+      public: virtual uint32_t VisibilityLayer(const std::string &_name) = 0;
+
+      /// \brief Get the visibility flag of an existing named visibility
+      /// layer. Unlike VisibilityLayer, the layer is not created if it does
+      /// not exist yet.
+      /// \param[in] _name Name of the layer
+      /// \return Visibility flag of the layer, or 0 if there is no layer
+      /// with the given name
+      public: virtual uint32_t VisibilityLayerFlag(
+                  const std::string &_name) const = 0;
+
       /// \brief Create new directional light. A unique ID and name will
       /// automatically be assigned to the light.
       /// \return The created light
@@ -668,6 +720,65 @@ namespace ignition
       public: virtual ThermalCameraPtr CreateThermalCamera(
                   unsigned int _id, const std::string &_name) = 0;
 
+      /// \brief Create new multi-view camera. A unique ID and name will
+      /// automatically be assigned to the camera.
+      /// \return The created camera
+      public: virtual MultiViewCameraPtr CreateMultiViewCamera() = 0;
+
+      /// \brief Create new multi-view camera with the given ID. A unique
+      /// name will automatically be assigned to the camera. If the given ID
+      /// is already in use, NULL will be returned.
+      /// \param[in] _id ID of the new camera
+      /// \return The created camera
+      public: virtual MultiViewCameraPtr CreateMultiViewCamera(
+                  unsigned int _id) = 0;
+
+      /// \brief Create new multi-view camera with the given name. A unique
+      /// ID will automatically be assigned to the camera. If the given name
+      /// is already in use, NULL will be returned.
+      /// \param[in] _name Name of the new camera
+      /// \return The created camera
+      public: virtual MultiViewCameraPtr CreateMultiViewCamera(
+                  const std::string &_name) = 0;
+
+      /// \brief Create new multi-view camera with the given name. If either
+      /// the given ID or name is already in use, NULL will be returned.
+      /// \param[in] _id ID of the new camera
+      /// \param[in] _name Name of the new camera
+      /// \return The created camera
+      public: virtual MultiViewCameraPtr CreateMultiViewCamera(
+                  unsigned int _id, const std::string &_name) = 0;
+
+      /// \brief Create new bounding box camera. A unique ID and name will
+      /// automatically be assigned to the camera.
+      /// \return The created camera
+      public: virtual BoundingBoxCameraPtr CreateBoundingBoxCamera() = 0;
+
+      /// \brief Create new bounding box camera with the given ID. A unique
+      /// name will automatically be assigned to the camera. If the given ID
+      /// is already in use, NULL will be returned.
+      /// \param[in] _id ID of the new camera
+      /// \return The created camera
+      public: virtual BoundingBoxCameraPtr CreateBoundingBoxCamera(
+                  unsigned int _id) = 0;
+
+      /// \brief Create new bounding box camera with the given name. A unique
+      /// ID will automatically be assigned to the camera. If the given name
+      /// is already in use, NULL will be returned.
+      /// \param[in] _name Name of the new camera
+      /// \return The created camera
+      public: virtual BoundingBoxCameraPtr CreateBoundingBoxCamera(
+                  const std::string &_name) = 0;
+
+      /// \brief Create new bounding box camera with the given name. If
+      /// either the given ID or name is already in use, NULL will be
+      /// returned.
+      /// \param[in] _id ID of the new camera
+      /// \param[in] _name Name of the new camera
+      /// \return The created camera
+      public: virtual BoundingBoxCameraPtr CreateBoundingBoxCamera(
+                  unsigned int _id, const std::string &_name) = 0;
+
       /// \brief Create new gpu rays caster. A unique ID and name will
       /// automatically be assigned to the gpu rays caster.
       /// \return The created gpu rays caster
@@ -854,6 +965,13 @@ namespace ignition
       /// \return The created mesh
       public: virtual MeshPtr CreateMesh(const MeshDescriptor &_desc) = 0;
 
+      /// \brief Create a new heightmap. The heightmap keeps the chunks it
+      /// draws up to date, call Heightmap::Update before rendering.
+      /// \param[in] _desc Descriptor of the heightmap
+      /// \return The created heightmap
+      public: virtual HeightmapPtr CreateHeightmap(
+          const HeightmapDescriptor &_desc) = 0;
+
       /// \brief Create new grid geometry.
       /// \return The created grid
       public: virtual GridPtr CreateGrid() = 0;
@@ -954,6 +1072,14 @@ namespace ignition
       public: virtual ParticleEmitterPtr CreateParticleEmitter(
                   unsigned int _id, const std::string &_name) = 0;
 
+      /// \brief Get the visibility index of the scene, updated with the
+      /// visuals that moved or were changed, added or removed since the
+      /// last call. Changes made directly to geometries, such as new marker
+      /// points, are only picked up when their visual changes as well.
+      /// Must be called from the thread that updates the scene.
+      /// \return Visibility index of the scene
+      public: virtual const VisibilityIndex &UpdateVisibilityIndex() = 0;
+
       /// \brief Prepare scene for rendering. The scene will flushing any scene
       /// changes by traversing scene-graph, calling PreRender on all objects
       public: virtual void PreRender() = 0;
@@ -967,6 +1093,25 @@ namespace ignition
       /// use of this scene after its destruction will result in undefined
       /// behavior.
       public: virtual void Destroy() = 0;
+
+      /// \brief Stop sharing the material a visual was given with
+      /// UpdateVisualMaterials. Called by visuals when their material is
+      /// set from outside of the batch updates and when they are destroyed.
+      /// \param[in] _visualId Id of the visual
+      protected: virtual void ReleaseVisualMaterial(
+                     unsigned int _visualId) = 0;
+
+      /// \brief Mark the bounds of a node as changed so that its root level
+      /// visual is updated in the visibility index. Called by nodes when
+      /// they move or their children or geometries change.
+      /// \param[in] _nodeId Id of the node
+      protected: virtual void MarkBoundsDirty(unsigned int _nodeId) = 0;
+
+      /// \brief Nodes mark their bounds as changed
+      private: template <class T> friend class BaseNode;
+
+      /// \brief Visuals release their batch materials
+      private: template <class T> friend class BaseVisual;
     };
     }
   }
@@ -17,6 +17,8 @@
 #ifndef IGNITION_RENDERING_SENSOR_HH_
 #define IGNITION_RENDERING_SENSOR_HH_
 
+#include <string>
+
 #include "ignition/rendering/config.hh"
 #include "ignition/rendering/Node.hh"
 
@@ -42,6 +44,21 @@ namespace ignition
       /// \brief Get visibility mask
       /// \return visibility mask
       public: virtual uint32_t VisibilityMask() const = 0;
+
+      /// \brief Show or hide the visuals of a named visibility layer, see
+      /// Scene::VisibilityLayer. Layers are enabled by default.
+      /// \param[in] _layer Name of the layer
+      /// \param[in] _enabled True to show the visuals of the layer
+      public: virtual void SetVisibilityLayerEnabled(
+                  const std::string &_layer, bool _enabled) = 0;
+
+      /// \brief Get whether the visuals of a named visibility layer are
+      /// shown
+      /// \param[in] _layer Name of the layer
+      /// \return True if the layer is enabled, false if it is disabled or
+      /// if the scene has no layer with the given name
+      public: virtual bool VisibilityLayerEnabled(
+                  const std::string &_layer) const = 0;
     };
     }
   }
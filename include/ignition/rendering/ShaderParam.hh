@@ -20,8 +20,15 @@
 
 #include <cstdint>
 #include <memory>
+#include <vector>
 
 #include <ignition/common/SuppressWarning.hh>
+#include <ignition/math/Color.hh>
+#include <ignition/math/Matrix3.hh>
+#include <ignition/math/Matrix4.hh>
+#include <ignition/math/Vector2.hh>
+#include <ignition/math/Vector3.hh>
+#include <ignition/math/Vector4.hh>
 
 #include "ignition/rendering/config.hh"
 #include "ignition/rendering/Export.hh"
@@ -34,6 +41,7 @@ namespace ignition
     //
     /// \brief forward declaration
     class ShaderParamPrivate;
+    class ShaderParams;
 
     /// \brief a variant type that holds params that can be passed to a shader
     class IGNITION_RENDERING_VISIBLE ShaderParam
@@ -48,6 +56,13 @@ namespace ignition
 
         /// \brief Integer type param
         PARAM_INT = 2,
+
+        /// \brief Array of floats, used for float arrays, vectors and
+        /// matrices
+        PARAM_FLOAT_BUFFER = 3,
+
+        /// \brief Array of integers
+        PARAM_INT_BUFFER = 4,
       };
 
       /// \brief constructor
@@ -77,6 +92,54 @@ namespace ignition
       /// \param[in] _value Value to set this param to.
       public: void operator=(const int _value);
 
+      /// \brief Set this to be a float buffer param holding a vector
+      /// \param[in] _value Value to set this param to.
+      public: void operator=(const math::Vector2d &_value);
+
+      /// \brief Set this to be a float buffer param holding a vector
+      /// \param[in] _value Value to set this param to.
+      public: void operator=(const math::Vector3d &_value);
+
+      /// \brief Set this to be a float buffer param holding a vector
+      /// \param[in] _value Value to set this param to.
+      public: void operator=(const math::Vector4d &_value);
+
+      /// \brief Set this to be a float buffer param holding the RGBA
+      /// components of a color
+      /// \param[in] _value Value to set this param to.
+      public: void operator=(const math::Color &_value);
+
+      /// \brief Set this to be a float buffer param holding a matrix in
+      /// row-major order
+      /// \param[in] _value Value to set this param to.
+      public: void operator=(const math::Matrix3d &_value);
+
+      /// \brief Set this to be a float buffer param holding a matrix in
+      /// row-major order
+      /// \param[in] _value Value to set this param to.
+      public: void operator=(const math::Matrix4d &_value);
+
+      /// \brief Set this to be a float buffer param
+      /// \param[in] _values Values to copy
+      /// \param[in] _count Number of values
+      public: void SetFloatBuffer(const float *_values, uint32_t _count);
+
+      /// \brief Set this to be an integer buffer param
+      /// \param[in] _values Values to copy
+      /// \param[in] _count Number of values
+      public: void SetIntBuffer(const int *_values, uint32_t _count);
+
+      /// \brief Get the number of values held by this parameter
+      /// \return 1 for float and int params, the buffer size for buffer
+      /// params and 0 if the param is not set
+      public: uint32_t Count() const;
+
+      /// \brief Get a pointer to the values held by this parameter. The
+      /// values are floats for PARAM_FLOAT and PARAM_FLOAT_BUFFER params and
+      /// ints for PARAM_INT and PARAM_INT_BUFFER params.
+      /// \return Pointer to Count() values, valid until the param is changed
+      public: const void *Data() const;
+
       /// \brief Get the value of this parameter if it is a float
       /// \param[out] _value variable the value will be copied to
       /// \return true if the param is the expected type
@@ -87,6 +150,38 @@ namespace ignition
       /// \return true if the param is the expected type
       public: bool Value(int *_value) const;
 
+      /// \brief Get the value of this parameter if it is a float buffer
+      /// \param[out] _value variable the values will be copied to
+      /// \return true if the param is the expected type
+      public: bool Value(std::vector<float> *_value) const;
+
+      /// \brief Get the value of this parameter if it is an int buffer
+      /// \param[out] _value variable the values will be copied to
+      /// \return true if the param is the expected type
+      public: bool Value(std::vector<int> *_value) const;
+
+      /// \brief Check if the value changed since the owning ShaderParams
+      /// was last cleared
+      /// \internal
+      /// \return True if the param has changed
+      public: bool IsDirty() const;
+
+      /// \brief Record that the value changed and notify the owning
+      /// ShaderParams
+      private: void MarkDirty();
+
+      /// \brief Set the ShaderParams this param belongs to
+      /// \param[in] _dirtyIndices List of modified params of the owner
+      /// \param[in] _index Index of this param in the owner
+      private: void SetOwner(std::vector<uint32_t> *_dirtyIndices,
+          uint32_t _index);
+
+      /// \brief Reset the dirty flag without notifying the owner
+      private: void ClearDirty();
+
+      /// \brief Only ShaderParams can set the owner of a param
+      private: friend class ShaderParams;
+
       /// \brief private implementation
       IGN_COMMON_WARN_IGNORE__DLL_INTERFACE_MISSING
       private: std::unique_ptr<ShaderParamPrivate> dataPtr;
@@ -21,6 +21,7 @@
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "ignition/rendering/Export.hh"
 #include "ignition/rendering/ShaderParam.hh"
@@ -95,7 +96,10 @@ namespace ignition
       /// \brief destructor
       public: ~ShaderParams();
 
-      /// \brief Access a param with a given name
+      /// \brief Access a param with a given name. The param is created if
+      /// it does not exist and is marked as changed. The reference stays
+      /// valid for the lifetime of these params and can be kept as a handle
+      /// to update the param without looking it up again.
       /// \param[in] _name Identifier for the parameter
       /// \returns parameter reference
       public: ShaderParam &operator[](const std::string &_name);
@@ -124,6 +128,28 @@ namespace ignition
       /// \internal
       public: void ClearDirty();
 
+      /// \brief Get the indices of the params that changed since the
+      /// dirty flag was last reset. Indices are assigned in creation order
+      /// and never change, so render engines can use them to cache the
+      /// location of each param in their shaders.
+      /// \internal
+      /// \return Indices of the changed params
+      public: const std::vector<uint32_t> &DirtyIndices() const;
+
+      /// \brief Get the number of params
+      /// \return Number of params
+      public: uint32_t ParamCount() const;
+
+      /// \brief Get the name of a param
+      /// \param[in] _index Index of the param
+      /// \return Name of the param
+      public: const std::string &NameByIndex(uint32_t _index) const;
+
+      /// \brief Get a param by index
+      /// \param[in] _index Index of the param
+      /// \return Const parameter reference
+      public: const ShaderParam &ParamByIndex(uint32_t _index) const;
+
       /// \brief private implementation
       private: std::unique_ptr<ShaderParamsPrivate> dataPtr;
     };
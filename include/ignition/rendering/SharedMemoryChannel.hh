@@ -0,0 +1,251 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_SHAREDMEMORYCHANNEL_HH_
+#define IGNITION_RENDERING_SHAREDMEMORYCHANNEL_HH_
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <ignition/common/Event.hh>
+#include <ignition/common/SuppressWarning.hh>
+
+#include "ignition/rendering/config.hh"
+#include "ignition/rendering/Export.hh"
+#include "ignition/rendering/RenderTypes.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    // forward declarations
+    class SharedMemoryWriterPrivate;
+    class SharedMemoryReaderPrivate;
+
+    /// \brief Header of a frame stored in a shared memory channel
+    struct SharedMemoryFrameInfo
+    {
+      /// \brief Frame number, starting at 0 for the first frame written to
+      /// the channel
+      uint64_t sequence = 0u;
+
+      /// \brief Time the frame was written, in nanoseconds of the monotonic
+      /// system clock, which is shared by all processes
+      int64_t timestamp = 0;
+
+      /// \brief Frame width
+      unsigned int width = 0u;
+
+      /// \brief Frame height
+      unsigned int height = 0u;
+
+      /// \brief Number of channels per pixel
+      unsigned int channels = 0u;
+
+      /// \brief Pixel format name, as given by the sensor event, e.g.
+      /// "R8G8B8", "FLOAT32" or "PF_FLOAT32_RGB"
+      std::string format;
+
+      /// \brief Size of the frame data in bytes
+      uint64_t size = 0u;
+    };
+
+    /* \class SharedMemoryWriter SharedMemoryChannel.hh \
+     * ignition/rendering/SharedMemoryChannel.hh
+     */
+    /// \brief Publishes sensor frames to other processes through a POSIX
+    /// shared memory ring buffer.
+    ///
+    /// The ring has a fixed number of slots of fixed size. Each frame is
+    /// copied once from the sensor readback buffer into the next slot,
+    /// together with its sequence number, timestamp and format. The writer
+    /// never waits for readers: slow readers miss the frames that were
+    /// overwritten. Only one writer may use a channel. Shared memory is not
+    /// supported on Windows.
+    class IGNITION_RENDERING_VISIBLE SharedMemoryWriter
+    {
+      /// \brief Constructor
+      public: SharedMemoryWriter();
+
+      /// \brief Destructor. Closes the channel.
+      public: virtual ~SharedMemoryWriter();
+
+      /// \brief Create the shared memory channel. An existing channel with
+      /// the same name is replaced.
+      /// \param[in] _name Channel name, e.g. "/camera". A leading '/' is
+      /// added if missing.
+      /// \param[in] _slotCount Number of frames in the ring
+      /// \param[in] _slotSize Maximum size of a frame in bytes
+      /// \return True if the channel was created
+      public: bool Open(const std::string &_name, unsigned int _slotCount,
+          uint64_t _slotSize);
+
+      /// \brief Close and remove the channel. Readers that already opened
+      /// the channel keep their mapping but receive no new frames.
+      public: void Close();
+
+      /// \brief Check if the channel is open
+      /// \return True if open
+      public: bool IsOpen() const;
+
+      /// \brief Get the channel name
+      /// \return Channel name, with a leading '/'
+      public: std::string Name() const;
+
+      /// \brief Get the number of frames in the ring
+      /// \return Number of slots
+      public: unsigned int SlotCount() const;
+
+      /// \brief Get the maximum size of a frame
+      /// \return Slot size in bytes
+      public: uint64_t SlotSize() const;
+
+      /// \brief Get the number of frames written since Open()
+      /// \return Number of frames
+      public: uint64_t FramesWritten() const;
+
+      /// \brief Write a frame to the next slot
+      /// \param[in] _data Frame data
+      /// \param[in] _size Size of the frame data in bytes
+      /// \param[in] _width Frame width
+      /// \param[in] _height Frame height
+      /// \param[in] _channels Number of channels per pixel
+      /// \param[in] _format Pixel format name
+      /// \return True if the frame was written, false if the channel is not
+      /// open or the frame is larger than a slot
+      public: bool Write(const void *_data, uint64_t _size,
+          unsigned int _width, unsigned int _height, unsigned int _channels,
+          const std::string &_format);
+
+      /// \brief Read back the last frame rendered by a camera and write it
+      /// \param[in] _camera Camera to read the frame from
+      /// \return True if the frame was written
+      public: bool Write(const CameraPtr &_camera);
+
+      /// \brief Write every frame produced by a depth camera
+      /// \param[in] _camera Depth camera
+      /// \return Connection to the new depth frame event. This must be kept
+      /// in scope.
+      public: common::ConnectionPtr ConnectDepthCamera(
+          const DepthCameraPtr &_camera);
+
+      /// \brief Write every frame produced by a thermal camera
+      /// \param[in] _camera Thermal camera
+      /// \return Connection to the new thermal frame event. This must be
+      /// kept in scope.
+      public: common::ConnectionPtr ConnectThermalCamera(
+          const ThermalCameraPtr &_camera);
+
+      /// \brief Write every frame produced by a gpu rays sensor
+      /// \param[in] _rays Gpu rays sensor
+      /// \return Connection to the new gpu rays frame event. This must be
+      /// kept in scope.
+      public: common::ConnectionPtr ConnectGpuRays(const GpuRaysPtr &_rays);
+
+      IGN_COMMON_WARN_IGNORE__DLL_INTERFACE_MISSING
+      /// \brief Private data pointer
+      private: std::unique_ptr<SharedMemoryWriterPrivate> dataPtr;
+      IGN_COMMON_WARN_RESUME__DLL_INTERFACE_MISSING
+    };
+
+    /* \class SharedMemoryReader SharedMemoryChannel.hh \
+     * ignition/rendering/SharedMemoryChannel.hh
+     */
+    /// \brief Reads sensor frames published by a SharedMemoryWriter in
+    /// another process. Does not require a render engine.
+    class IGNITION_RENDERING_VISIBLE SharedMemoryReader
+    {
+      /// \brief Constructor
+      public: SharedMemoryReader();
+
+      /// \brief Destructor. Closes the channel.
+      public: virtual ~SharedMemoryReader();
+
+      /// \brief Open an existing channel. Only frames written after this
+      /// call are read.
+      /// \param[in] _name Channel name
+      /// \return True if the channel exists and has a valid header
+      public: bool Open(const std::string &_name);
+
+      /// \brief Close the channel
+      public: void Close();
+
+      /// \brief Check if the channel is open
+      /// \return True if open
+      public: bool IsOpen() const;
+
+      /// \brief Get the number of frames in the ring
+      /// \return Number of slots
+      public: unsigned int SlotCount() const;
+
+      /// \brief Get the maximum size of a frame
+      /// \return Slot size in bytes
+      public: uint64_t SlotSize() const;
+
+      /// \brief Read the oldest frame that has not been read yet, without
+      /// waiting
+      /// \param[out] _data Frame data, resized to the frame size
+      /// \param[out] _info Frame header
+      /// \return True if a frame was read
+      public: bool Read(std::vector<unsigned char> &_data,
+          SharedMemoryFrameInfo &_info);
+
+      /// \brief Read the newest frame, skipping older unread frames.
+      /// Skipped frames are not counted as missed.
+      /// \param[out] _data Frame data, resized to the frame size
+      /// \param[out] _info Frame header
+      /// \return True if a frame was read
+      public: bool ReadLatest(std::vector<unsigned char> &_data,
+          SharedMemoryFrameInfo &_info);
+
+      /// \brief Wait for the next frame and read it
+      /// \param[out] _data Frame data, resized to the frame size
+      /// \param[out] _info Frame header
+      /// \param[in] _timeout Maximum time to wait
+      /// \return True if a frame was read before the timeout
+      public: bool Wait(std::vector<unsigned char> &_data,
+          SharedMemoryFrameInfo &_info,
+          std::chrono::nanoseconds _timeout);
+
+      /// \brief Get the number of frames read since Open()
+      /// \return Number of frames
+      public: uint64_t FramesRead() const;
+
+      /// \brief Get the number of frames that were overwritten by the
+      /// writer before they could be read
+      /// \return Number of frames
+      public: uint64_t FramesMissed() const;
+
+      /// \brief Get the time elapsed since a frame was written
+      /// \param[in] _info Frame header
+      /// \return Time elapsed
+      public: static std::chrono::nanoseconds Latency(
+          const SharedMemoryFrameInfo &_info);
+
+      IGN_COMMON_WARN_IGNORE__DLL_INTERFACE_MISSING
+      /// \brief Private data pointer
+      private: std::unique_ptr<SharedMemoryReaderPrivate> dataPtr;
+      IGN_COMMON_WARN_RESUME__DLL_INTERFACE_MISSING
+    };
+    }
+  }
+}
+#endif
@@ -17,6 +17,7 @@
 #ifndef IGNITION_RENDERING_UTILS_HH_
 #define IGNITION_RENDERING_UTILS_HH_
 
+#include <cstdint>
 #include <vector>
 
 #include <ignition/math/Helpers.hh>
@@ -49,6 +50,27 @@ namespace ignition
     ignition::math::AxisAlignedBox transformAxisAlignedBox(
         const ignition::math::AxisAlignedBox &_box,
         const ignition::math::Pose3d &_pose);
+
+    /// \brief Get the visibility flags render engines give to the objects
+    /// of a visual. Engines render an object if any of its flags is in the
+    /// mask of a sensor, so a visual restricted to some visibility layers
+    /// only keeps its layer flags, IGN_VISIBILITY_SELECTABLE and the flags
+    /// outside IGN_VISIBILITY_ALL. Its layers alone then decide which
+    /// sensors render it.
+    /// \param[in] _flags Visibility flags of the visual
+    /// \return Flags of the render engine objects
+    IGNITION_RENDERING_VISIBLE
+    uint32_t renderVisibilityFlags(uint32_t _flags);
+
+    /// \brief Get the visibility mask render engines use to render the
+    /// image of a sensor. Masks that disable some of the visibility layers
+    /// leave out IGN_VISIBILITY_SELECTABLE, which layered visuals keep for
+    /// selection buffers. Other masks, including the default one, are
+    /// returned unchanged.
+    /// \param[in] _mask Visibility mask of the sensor
+    /// \return Mask of the render engine passes
+    IGNITION_RENDERING_VISIBLE
+    uint32_t renderVisibilityMask(uint32_t _mask);
     }
   }
 }
@@ -0,0 +1,155 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_VISIBILITYINDEX_HH_
+#define IGNITION_RENDERING_VISIBILITYINDEX_HH_
+
+#include <memory>
+#include <set>
+#include <vector>
+
+#include <ignition/common/SuppressWarning.hh>
+#include <ignition/math/AxisAlignedBox.hh>
+#include <ignition/math/Matrix4.hh>
+#include <ignition/math/Vector2.hh>
+
+#include "ignition/rendering/config.hh"
+#include "ignition/rendering/Export.hh"
+#include "ignition/rendering/RenderTypes.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    // forward declarations
+    class VisibilityIndexPrivate;
+
+    /// \brief Options for a CPU visibility query
+    class IGNITION_RENDERING_VISIBLE VisibleVisualsOptions
+    {
+      /// \brief Only visuals with visibility flags that match this mask are
+      /// considered. The mask is combined with the camera visibility mask.
+      public: uint32_t visibilityMask = IGN_VISIBILITY_ALL;
+
+      /// \brief True to report every visual in the scene tree. By default
+      /// only the visuals attached to the root visual (models) are reported.
+      public: bool recursive = false;
+
+      /// \brief Visuals that cover fewer pixels than this are not reported
+      public: double minScreenArea = 0.0;
+
+      /// \brief Number of occlusion rays cast along each axis of the
+      /// screen rectangle of a visual. Zero disables occlusion testing.
+      /// Occluders are approximated by the bounding boxes of other root
+      /// level visuals, so concave or thin shapes over-occlude.
+      public: unsigned int occlusionSamples = 0u;
+    };
+
+    /// \brief Result of a CPU visibility query for a single visual
+    class IGNITION_RENDERING_VISIBLE VisibleVisual
+    {
+      /// \brief Id of the visual
+      public: unsigned int id = 0u;
+
+      /// \brief Top left corner of the projected bounding box in pixels,
+      /// clamped to the image
+      IGN_COMMON_WARN_IGNORE__DLL_INTERFACE_MISSING
+      public: math::Vector2d screenMin;
+
+      /// \brief Bottom right corner of the projected bounding box in pixels,
+      /// clamped to the image
+      public: math::Vector2d screenMax;
+      IGN_COMMON_WARN_RESUME__DLL_INTERFACE_MISSING
+
+      /// \brief Area of the screen rectangle in pixels
+      public: double screenArea = 0.0;
+
+      /// \brief Distance from the camera to the closest point of the
+      /// bounding box
+      public: double distance = 0.0;
+
+      /// \brief Fraction of occlusion rays that reached the visual. This is
+      /// 1 if occlusion testing is disabled.
+      public: double visibleFraction = 1.0;
+    };
+
+    /// \class VisibilityIndex VisibilityIndex.hh
+    /// ignition/rendering/VisibilityIndex.hh
+    /// \brief Bounding volume hierarchy over the world bounding boxes of
+    /// the visuals in a scene, used to answer camera visibility queries
+    /// without rendering.
+    ///
+    /// Update() reads the scene and must be called from the thread that
+    /// updates the scene. Queries only read the index and may run
+    /// concurrently from multiple threads. Scene::UpdateVisibilityIndex
+    /// keeps an index per scene up to date with the visuals that changed.
+    class IGNITION_RENDERING_VISIBLE VisibilityIndex
+    {
+      /// \brief Constructor
+      public: VisibilityIndex();
+
+      /// \brief Destructor
+      public: ~VisibilityIndex();
+
+      /// \brief Rebuild the index from the current state of a scene
+      /// \param[in] _scene Scene to index
+      public: void Update(const ScenePtr &_scene);
+
+      /// \brief Update the entries of the given root level visuals and
+      /// refit the hierarchy to their new bounds. The index is rebuilt if
+      /// visuals were added to or removed from one of them.
+      /// \param[in] _scene Indexed scene
+      /// \param[in] _roots Ids of the root level visuals that changed
+      public: void Update(const ScenePtr &_scene,
+          const std::set<unsigned int> &_roots);
+
+      /// \brief Get the number of visuals in the index
+      /// \return Number of indexed visuals
+      public: unsigned int VisualCount() const;
+
+      /// \brief Find the visuals inside a view frustum
+      /// \param[in] _view View matrix of the camera
+      /// \param[in] _projection Projection matrix of the camera
+      /// \param[in] _width Image width in pixels
+      /// \param[in] _height Image height in pixels
+      /// \param[in] _options Query options
+      /// \return Visible visuals sorted by distance from the camera
+      public: std::vector<VisibleVisual> Query(const math::Matrix4d &_view,
+          const math::Matrix4d &_projection, unsigned int _width,
+          unsigned int _height, const VisibleVisualsOptions &_options) const;
+
+      /// \brief Find the visuals visible to each camera. The camera
+      /// parameters are read on the calling thread and the queries are
+      /// distributed over worker threads.
+      /// \param[in] _cameras Cameras to query
+      /// \param[in] _options Query options
+      /// \return Visible visuals for each camera, in the order of _cameras
+      public: std::vector<std::vector<VisibleVisual>> Query(
+          const std::vector<CameraPtr> &_cameras,
+          const VisibleVisualsOptions &_options) const;
+
+      /// \internal
+      /// \brief Private data pointer
+      IGN_COMMON_WARN_IGNORE__DLL_INTERFACE_MISSING
+      private: std::unique_ptr<VisibilityIndexPrivate> dataPtr;
+      IGN_COMMON_WARN_RESUME__DLL_INTERFACE_MISSING
+    };
+    }
+  }
+}
+#endif
@@ -114,6 +114,11 @@ namespace ignition
       /// \param[in] _visible True if this visual should be made visible
       public: virtual void SetVisible(bool _visible) = 0;
 
+      /// \brief Get whether this visual was made visible or hidden with
+      /// SetVisible
+      /// \return True if the visual is visible
+      public: virtual bool Visible() const = 0;
+
       /// \brief Set visibility flags
       /// \param[in] _flags Visibility flags
       public: virtual void SetVisibilityFlags(uint32_t _flags) = 0;
@@ -130,6 +135,14 @@ namespace ignition
       /// \param[in] _visibility flags
       public: virtual void RemoveVisibilityFlags(uint32_t _flags) = 0;
 
+      /// \brief Assign this visual and its children to a named visibility
+      /// layer, see Scene::VisibilityLayer. The flags within
+      /// IGN_VISIBILITY_LAYERS are replaced by the flag of the layer and the
+      /// other flags are kept. The visual is then only rendered by sensors
+      /// that have the layer enabled, see renderVisibilityFlags.
+      /// \param[in] _layer Name of the layer
+      public: virtual void SetVisibilityLayer(const std::string &_layer) = 0;
+
       /// \brief Store any custom data associated with this visual
       /// \param[in] _key Unique key
       /// \param[in] _value Value in any type
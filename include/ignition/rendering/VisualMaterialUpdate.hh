@@ -0,0 +1,50 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_VISUALMATERIALUPDATE_HH_
+#define IGNITION_RENDERING_VISUALMATERIALUPDATE_HH_
+
+#include <ignition/math/Color.hh>
+
+#include "ignition/rendering/config.hh"
+#include "ignition/rendering/RenderTypes.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    /// \brief Material properties to apply to a visual with
+    /// Scene::UpdateVisualMaterials
+    struct VisualMaterialUpdate
+    {
+      /// \brief Visual to update
+      VisualPtr visual;
+
+      /// \brief Diffuse color
+      math::Color diffuse = math::Color::White;
+
+      /// \brief Emissive color
+      math::Color emissive = math::Color::Black;
+
+      /// \brief Transparency, from 0 (opaque) to 1 (invisible)
+      double transparency = 0.0;
+    };
+    }
+  }
+}
+#endif
@@ -0,0 +1,232 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_WORLDSTREAMER_HH_
+#define IGNITION_RENDERING_WORLDSTREAMER_HH_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include <ignition/common/SuppressWarning.hh>
+#include <ignition/math/Pose3.hh>
+#include <ignition/math/Vector3.hh>
+
+#include "ignition/rendering/config.hh"
+#include "ignition/rendering/RenderTypes.hh"
+#include "ignition/rendering/Export.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    // forward declarations
+    class WorldStreamerPrivate;
+
+    /// \brief A model loaded and unloaded by a WorldStreamer
+    struct StreamedModel
+    {
+      /// \brief Unique name of the model
+      std::string name;
+
+      /// \brief Mesh file, or name of a mesh already in
+      /// common::MeshManager
+      std::string mesh;
+
+      /// \brief World pose
+      math::Pose3d pose;
+
+      /// \brief Scale
+      math::Vector3d scale = math::Vector3d::One;
+
+      /// \brief Material applied to the whole model. The materials of the
+      /// mesh are used if null.
+      MaterialPtr material;
+    };
+
+    /* \class WorldStreamer WorldStreamer.hh \
+     * ignition/rendering/WorldStreamer.hh
+     */
+    /// \brief Creates and destroys the visuals of a large world as sensors
+    /// move through it.
+    ///
+    /// Models are sorted into square cells on the XY plane. On Update(),
+    /// cells closer than the load distance to any sensor are scheduled for
+    /// loading, nearest first. Mesh files are parsed and the texture files
+    /// they reference are read on worker threads, and the visuals are then
+    /// created on the calling thread, at most a fixed number per update to
+    /// avoid frame time spikes. Loaded cells farther than the unload
+    /// distance from every sensor are unloaded, farthest first, while the
+    /// estimated memory of loaded models is above the budget. The gap
+    /// between the load and unload distances prevents cells from being
+    /// loaded and unloaded repeatedly when a sensor moves along a border.
+    ///
+    /// Workers parse the mesh files into meshes of their own, which are
+    /// added to common::MeshManager on the calling thread when the visuals
+    /// are created, so the streamer must be used from the render thread.
+    /// Workers also read the texture files to warm the file cache, the
+    /// textures themselves are loaded by the render engine.
+    class IGNITION_RENDERING_VISIBLE WorldStreamer
+    {
+      /// \brief Constructor
+      /// \param[in] _scene Scene to create the visuals in
+      public: explicit WorldStreamer(const ScenePtr &_scene);
+
+      /// \brief Destructor. Waits for the workers and destroys the visuals.
+      /// Must be called before the scene is destroyed.
+      public: virtual ~WorldStreamer();
+
+      /// \brief Set the size of the cells. Only affects models added
+      /// afterwards.
+      /// \param[in] _size Length of a cell side in meters
+      public: virtual void SetCellSize(double _size);
+
+      /// \brief Get the size of the cells
+      /// \return Length of a cell side in meters
+      public: virtual double CellSize() const;
+
+      /// \brief Set the distance under which cells are loaded. The unload
+      /// distance is raised if needed to stay above it.
+      /// \param[in] _distance Distance from a sensor to a cell in meters
+      public: virtual void SetLoadDistance(double _distance);
+
+      /// \brief Get the distance under which cells are loaded
+      /// \return Distance in meters
+      public: virtual double LoadDistance() const;
+
+      /// \brief Set the distance beyond which cells may be unloaded. The
+      /// load distance is lowered if needed to stay below it.
+      /// \param[in] _distance Distance from a sensor to a cell in meters
+      public: virtual void SetUnloadDistance(double _distance);
+
+      /// \brief Get the distance beyond which cells may be unloaded
+      /// \return Distance in meters
+      public: virtual double UnloadDistance() const;
+
+      /// \brief Set the memory budget of the loaded models
+      /// \param[in] _bytes Budget in bytes
+      public: virtual void SetMemoryBudget(uint64_t _bytes);
+
+      /// \brief Get the memory budget of the loaded models
+      /// \return Budget in bytes
+      public: virtual uint64_t MemoryBudget() const;
+
+      /// \brief Set the maximum number of visuals created per update
+      /// \param[in] _count Visual count, at least 1
+      public: virtual void SetMaxLoadsPerUpdate(unsigned int _count);
+
+      /// \brief Get the maximum number of visuals created per update
+      /// \return Visual count
+      public: virtual unsigned int MaxLoadsPerUpdate() const;
+
+      /// \brief Set the number of worker threads. With no workers, meshes
+      /// are parsed in Update(), which makes loading deterministic.
+      /// \param[in] _count Number of threads
+      public: virtual void SetWorkerCount(unsigned int _count);
+
+      /// \brief Get the number of worker threads
+      /// \return Number of threads
+      public: virtual unsigned int WorkerCount() const;
+
+      /// \brief Add a model to stream
+      /// \param[in] _model Model description
+      /// \return False if the name is empty or already used
+      public: virtual bool AddModel(const StreamedModel &_model);
+
+      /// \brief Remove a model, destroying its visual if loaded
+      /// \param[in] _name Name of the model
+      /// \return True if the model was removed
+      public: virtual bool RemoveModel(const std::string &_name);
+
+      /// \brief Get the number of models
+      /// \return Model count
+      public: virtual unsigned int ModelCount() const;
+
+      /// \brief Get the visual of a model
+      /// \param[in] _name Name of the model
+      /// \return Visual, or null if the model is not loaded
+      public: virtual VisualPtr ModelVisual(const std::string &_name) const;
+
+      /// \brief Add a sensor whose position drives loading
+      /// \param[in] _sensor Camera, GpuRays or any other sensor
+      public: virtual void AddSensor(const SensorPtr &_sensor);
+
+      /// \brief Remove a sensor
+      /// \param[in] _sensor Sensor to remove
+      public: virtual void RemoveSensor(const SensorPtr &_sensor);
+
+      /// \brief Get the number of sensors
+      /// \return Sensor count
+      public: virtual unsigned int SensorCount() const;
+
+      /// \brief Schedule loads and unloads for the sensor positions, and
+      /// create the visuals of loaded meshes. Call once per frame before
+      /// rendering.
+      public: virtual void Update();
+
+      /// \brief Wait for all scheduled loads and create their visuals
+      public: virtual void Flush();
+
+      /// \brief Get the number of cells with models
+      /// \return Cell count
+      public: virtual unsigned int CellCount() const;
+
+      /// \brief Get the number of cells whose models are all loaded
+      /// \return Cell count
+      public: virtual unsigned int LoadedCellCount() const;
+
+      /// \brief Get the number of cells scheduled for loading
+      /// \return Cell count
+      public: virtual unsigned int PendingCellCount() const;
+
+      /// \brief Get the number of models with a visual
+      /// \return Model count
+      public: virtual unsigned int LoadedModelCount() const;
+
+      /// \brief Get the estimated memory of the loaded models: vertex and
+      /// index data of their meshes
+      /// \return Memory in bytes
+      public: virtual uint64_t MemoryUsage() const;
+
+      /// \brief Get the number of cells loaded so far
+      /// \return Load count
+      public: virtual uint64_t LoadCount() const;
+
+      /// \brief Get the number of cells unloaded so far
+      /// \return Unload count
+      public: virtual uint64_t UnloadCount() const;
+
+      /// \brief Get the average time from scheduling a cell to creating the
+      /// last of its visuals
+      /// \return Latency in seconds
+      public: virtual double AverageLoadLatency() const;
+
+      /// \brief Get the longest time from scheduling a cell to creating the
+      /// last of its visuals
+      /// \return Latency in seconds
+      public: virtual double MaxLoadLatency() const;
+
+      IGN_COMMON_WARN_IGNORE__DLL_INTERFACE_MISSING
+      /// \brief Private data pointer
+      private: std::unique_ptr<WorldStreamerPrivate> dataPtr;
+      IGN_COMMON_WARN_RESUME__DLL_INTERFACE_MISSING
+    };
+    }
+  }
+}
+#endif
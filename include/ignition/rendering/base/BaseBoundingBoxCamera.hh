@@ -0,0 +1,288 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_BASE_BASEBOUNDINGBOXCAMERA_HH_
+#define IGNITION_RENDERING_BASE_BASEBOUNDINGBOXCAMERA_HH_
+
+#include <algorithm>
+#include <vector>
+
+#include <ignition/math/AxisAlignedBox.hh>
+#include <ignition/math/Helpers.hh>
+#include <ignition/math/Matrix4.hh>
+#include <ignition/math/Pose3.hh>
+
+#include "ignition/rendering/BoundingBoxCamera.hh"
+#include "ignition/rendering/Visual.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    /// \brief Base implementation of the BoundingBoxCamera class. Render
+    /// engines find the labelled visuals with visible pixels and their
+    /// visible boxes, and the full 2D and 3D boxes are computed from the
+    /// cached local bounds of the visuals.
+    template <class T>
+    class BaseBoundingBoxCamera :
+      public virtual BoundingBoxCamera,
+      public virtual T
+    {
+      /// \brief Constructor
+      protected: BaseBoundingBoxCamera();
+
+      /// \brief Destructor
+      public: virtual ~BaseBoundingBoxCamera();
+
+      // Documentation inherited.
+      public: virtual void SetBoundingBoxType(BoundingBoxType _type)
+                  override;
+
+      // Documentation inherited.
+      public: virtual BoundingBoxType Type() const override;
+
+      // Documentation inherited.
+      public: virtual const std::vector<BoundingBox> &BoundingBoxData()
+                  const override;
+
+      // Documentation inherited.
+      public: virtual ignition::common::ConnectionPtr ConnectNewBoundingBoxes(
+                  std::function<void(const std::vector<BoundingBox> &)>
+                  _subscriber) override;
+
+      /// \brief Set the boxes of a new frame and notify the subscribers
+      /// \param[in] _visuals Labelled visuals with visible pixels
+      /// \param[in] _visibleBoxes Visible 2D boxes of the visuals, with
+      /// their labels
+      protected: void UpdateBoundingBoxes(
+                     const std::vector<VisualPtr> &_visuals,
+                     const std::vector<BoundingBox> &_visibleBoxes);
+
+      /// \brief Compute the 3D box of a visual in the camera frame
+      /// \param[in] _visual Visual to compute the box of
+      /// \return Oriented box of the visual
+      protected: BoundingBox Box3d(const VisualPtr &_visual) const;
+
+      /// \brief Compute the 2D box of the full extent of a visual, by
+      /// projecting the parts of its 3D box in front of the near plane
+      /// \param[in] _visual Visual to compute the box of
+      /// \param[out] _box Box of the visual, clamped to the image
+      /// \return False if the box is empty or outside of the image
+      protected: bool FullBox2d(const VisualPtr &_visual,
+                     BoundingBox &_box) const;
+
+      /// \brief Type of the reported boxes
+      protected: BoundingBoxType type = BBT_VISIBLEBOX2D;
+
+      /// \brief Boxes of the last rendered frame
+      protected: std::vector<BoundingBox> boxes;
+
+      /// \brief Event emitted with the boxes of each rendered frame
+      protected: ignition::common::EventT<void(
+                     const std::vector<BoundingBox> &)> newBoundingBoxes;
+    };
+
+    //////////////////////////////////////////////////
+    template <class T>
+    BaseBoundingBoxCamera<T>::BaseBoundingBoxCamera()
+    {
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    BaseBoundingBoxCamera<T>::~BaseBoundingBoxCamera()
+    {
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseBoundingBoxCamera<T>::SetBoundingBoxType(BoundingBoxType _type)
+    {
+      this->type = _type;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    BoundingBoxType BaseBoundingBoxCamera<T>::Type() const
+    {
+      return this->type;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    const std::vector<BoundingBox> &BaseBoundingBoxCamera<T>::BoundingBoxData()
+        const
+    {
+      return this->boxes;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    ignition::common::ConnectionPtr
+        BaseBoundingBoxCamera<T>::ConnectNewBoundingBoxes(
+        std::function<void(const std::vector<BoundingBox> &)> _subscriber)
+    {
+      return this->newBoundingBoxes.Connect(_subscriber);
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseBoundingBoxCamera<T>::UpdateBoundingBoxes(
+        const std::vector<VisualPtr> &_visuals,
+        const std::vector<BoundingBox> &_visibleBoxes)
+    {
+      this->boxes.clear();
+      for (size_t i = 0u; i < _visuals.size() && i < _visibleBoxes.size();
+          ++i)
+      {
+        if (this->type == BBT_VISIBLEBOX2D)
+        {
+          this->boxes.push_back(_visibleBoxes[i]);
+        }
+        else if (this->type == BBT_FULLBOX2D)
+        {
+          BoundingBox box;
+          if (this->FullBox2d(_visuals[i], box))
+          {
+            box.label = _visibleBoxes[i].label;
+            this->boxes.push_back(box);
+          }
+        }
+        else
+        {
+          BoundingBox box = this->Box3d(_visuals[i]);
+          box.label = _visibleBoxes[i].label;
+          this->boxes.push_back(box);
+        }
+      }
+      this->newBoundingBoxes(this->boxes);
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    BoundingBox BaseBoundingBoxCamera<T>::Box3d(const VisualPtr &_visual)
+        const
+    {
+      BoundingBox box;
+      box.type = BBT_BOX3D;
+
+      const math::Pose3d cameraPose = this->WorldPose();
+      const math::Pose3d visualPose = _visual->WorldPose();
+      math::Quaterniond invRot = cameraPose.Rot().Inverse();
+      box.orientation = invRot * visualPose.Rot();
+
+      // the local bounds are cached by the visual, in its own frame
+      math::AxisAlignedBox localBox = _visual->LocalBoundingBox();
+      math::Vector3d center = visualPose.Pos();
+      if (localBox.Min().X() <= localBox.Max().X())
+      {
+        center += visualPose.Rot() * localBox.Center();
+        box.size = localBox.Size();
+      }
+      box.center = invRot * (center - cameraPose.Pos());
+      return box;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    bool BaseBoundingBoxCamera<T>::FullBox2d(const VisualPtr &_visual,
+        BoundingBox &_box) const
+    {
+      math::AxisAlignedBox localBox = _visual->LocalBoundingBox();
+      if (localBox.Min().X() > localBox.Max().X())
+        return false;
+
+      // corners of the box in the view frame, where the camera looks
+      // down -z
+      math::Matrix4d toView =
+          this->ViewMatrix() * math::Matrix4d(_visual->WorldPose());
+      const math::Vector3d &min = localBox.Min();
+      const math::Vector3d &max = localBox.Max();
+      math::Vector3d corners[8];
+      for (unsigned int i = 0u; i < 8u; ++i)
+      {
+        corners[i] = toView * math::Vector3d(
+            (i & 1u) ? max.X() : min.X(),
+            (i & 2u) ? max.Y() : min.Y(),
+            (i & 4u) ? max.Z() : min.Z());
+      }
+
+      // keep the corners in front of the near plane, and the points where
+      // the edges of the box cross it
+      double nearZ = -this->NearClipPlane();
+      std::vector<math::Vector3d> points;
+      for (unsigned int i = 0u; i < 8u; ++i)
+      {
+        if (corners[i].Z() <= nearZ)
+          points.push_back(corners[i]);
+        for (unsigned int axis = 1u; axis < 8u; axis <<= 1u)
+        {
+          if (i & axis)
+            continue;
+          const math::Vector3d &a = corners[i];
+          const math::Vector3d &b = corners[i | axis];
+          if ((a.Z() <= nearZ) != (b.Z() <= nearZ))
+          {
+            double t = (nearZ - a.Z()) / (b.Z() - a.Z());
+            points.push_back(a + (b - a) * t);
+          }
+        }
+      }
+      if (points.empty())
+        return false;
+
+      const math::Matrix4d projection = this->ProjectionMatrix();
+      double width = this->ImageWidth();
+      double height = this->ImageHeight();
+      double minX = math::MAX_D;
+      double minY = math::MAX_D;
+      double maxX = math::LOW_D;
+      double maxY = math::LOW_D;
+      for (const auto &p : points)
+      {
+        double x = projection(0, 0) * p.X() + projection(0, 1) * p.Y() +
+            projection(0, 2) * p.Z() + projection(0, 3);
+        double y = projection(1, 0) * p.X() + projection(1, 1) * p.Y() +
+            projection(1, 2) * p.Z() + projection(1, 3);
+        double w = projection(3, 0) * p.X() + projection(3, 1) * p.Y() +
+            projection(3, 2) * p.Z() + projection(3, 3);
+        double px = (x / w + 1.0) * 0.5 * width;
+        double py = (1.0 - y / w) * 0.5 * height;
+        minX = std::min(minX, px);
+        minY = std::min(minY, py);
+        maxX = std::max(maxX, px);
+        maxY = std::max(maxY, py);
+      }
+
+      minX = std::max(minX, 0.0);
+      minY = std::max(minY, 0.0);
+      maxX = std::min(maxX, width);
+      maxY = std::min(maxY, height);
+      if (maxX <= minX || maxY <= minY)
+        return false;
+
+      _box.type = BBT_FULLBOX2D;
+      _box.center.Set((minX + maxX) * 0.5, (minY + maxY) * 0.5, 0.0);
+      _box.size.Set(maxX - minX, maxY - minY, 0.0);
+      _box.orientation = math::Quaterniond::Identity;
+      return true;
+    }
+    }
+  }
+}
+#endif
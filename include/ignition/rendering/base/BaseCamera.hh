@@ -18,6 +18,7 @@
 #define IGNITION_RENDERING_BASE_BASECAMERA_HH_
 
 #include <string>
+#include <vector>
 
 #include <ignition/math/Matrix3.hh>
 #include <ignition/math/Pose3.hh>
@@ -27,9 +28,12 @@
 #include <ignition/common/SuppressWarning.hh>
 
 #include "ignition/rendering/Camera.hh"
+#include "ignition/rendering/FrameRecorder.hh"
 #include "ignition/rendering/Image.hh"
 #include "ignition/rendering/RenderEngine.hh"
 #include "ignition/rendering/Scene.hh"
+#include "ignition/rendering/Utils.hh"
+#include "ignition/rendering/VisibilityIndex.hh"
 #include "ignition/rendering/base/BaseRenderTarget.hh"
 
 namespace ignition
@@ -75,6 +79,13 @@ namespace ignition
 
       public: virtual void SetAntiAliasing(const unsigned int _aa) override;
 
+      // Documentation inherited.
+      public: virtual math::Color BackgroundColor() const override;
+
+      // Documentation inherited.
+      public: virtual void SetBackgroundColor(const math::Color &_color)
+                  override;
+
       public: virtual double FarClipPlane() const override;
 
       public: virtual void SetFarClipPlane(const double _far) override;
@@ -114,6 +125,17 @@ namespace ignition
       // Documentation inherited.
       public: virtual math::Matrix4d ViewMatrix() const override;
 
+      // Documentation inherited.
+      public: virtual std::vector<VisibleVisual> VisibleVisuals(
+                  const VisibleVisualsOptions &_options =
+                  VisibleVisualsOptions()) override;
+
+      // Documentation inherited.
+      public: virtual void SetOcclusionCulling(bool _enabled) override;
+
+      // Documentation inherited.
+      public: virtual bool OcclusionCulling() const override;
+
       // Documentation inherited.
       // \sa Camera::SetMaterial(const MaterialPtr &) override;
       public: virtual void SetMaterial(const MaterialPtr &_material)
@@ -178,6 +200,34 @@ namespace ignition
       public: virtual RenderPassPtr RenderPassByIndex(unsigned int _index)
           const override;
 
+      // Documentation inherited.
+      public: virtual void SetDynamicResolution(bool _enabled) override;
+
+      // Documentation inherited.
+      public: virtual bool DynamicResolution() const override;
+
+      // Documentation inherited.
+      public: virtual void SetTargetFrameTime(double _seconds) override;
+
+      // Documentation inherited.
+      public: virtual double TargetFrameTime() const override;
+
+      // Documentation inherited.
+      public: virtual void SetResolutionScaleRange(double _min, double _max)
+                  override;
+
+      // Documentation inherited.
+      public: virtual double MinResolutionScale() const override;
+
+      // Documentation inherited.
+      public: virtual double MaxResolutionScale() const override;
+
+      // Documentation inherited.
+      public: virtual void SetResolutionScale(double _scale) override;
+
+      // Documentation inherited.
+      public: virtual double ResolutionScale() const override;
+
       protected: virtual void *CreateImageBuffer() const;
 
       protected: virtual void Load() override;
@@ -235,6 +285,9 @@ namespace ignition
       /// \brief Offset distance between camera and target node being followed
       protected: math::Vector3d followOffset;
 
+      /// \brief True if occlusion culling is enabled
+      protected: bool occlusionCulling = false;
+
       friend class BaseDepthCamera<T>;
     };
 
@@ -407,9 +460,11 @@ namespace ignition
 
     //////////////////////////////////////////////////
     template <class T>
-    bool BaseCamera<T>::SaveFrame(const std::string &/*_name*/)
+    bool BaseCamera<T>::SaveFrame(const std::string &_name)
     {
-      return false;
+      Image image = this->CreateImage();
+      this->Copy(image);
+      return FrameRecorder::SaveImage(image, _name);
     }
 
     //////////////////////////////////////////////////
@@ -522,6 +577,36 @@ namespace ignition
       return result;
     }
 
+    //////////////////////////////////////////////////
+    template <class T>
+    std::vector<VisibleVisual> BaseCamera<T>::VisibleVisuals(
+        const VisibleVisualsOptions &_options)
+    {
+      ScenePtr scene = this->Scene();
+      if (!scene)
+        return std::vector<VisibleVisual>();
+
+      VisibleVisualsOptions options = _options;
+      options.visibilityMask &= renderVisibilityMask(this->VisibilityMask());
+      return scene->UpdateVisibilityIndex().Query(this->ViewMatrix(),
+          this->ProjectionMatrix(), this->ImageWidth(), this->ImageHeight(),
+          options);
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseCamera<T>::SetOcclusionCulling(bool _enabled)
+    {
+      this->occlusionCulling = _enabled;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    bool BaseCamera<T>::OcclusionCulling() const
+    {
+      return this->occlusionCulling;
+    }
+
     //////////////////////////////////////////////////
     template <class T>
     math::Angle BaseCamera<T>::HFOV() const
@@ -573,6 +658,21 @@ namespace ignition
       this->antiAliasing = _aa;
     }
 
+    //////////////////////////////////////////////////
+    template <class T>
+    math::Color BaseCamera<T>::BackgroundColor() const
+    {
+      return this->Scene()->BackgroundColor();
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseCamera<T>::SetBackgroundColor(const math::Color &)
+    {
+      ignwarn << "SetBackgroundColor not supported by camera ["
+              << this->Name() << "]" << std::endl;
+    }
+
     //////////////////////////////////////////////////
     template <class T>
     double BaseCamera<T>::FarClipPlane() const
@@ -735,6 +835,69 @@ namespace ignition
     {
       return this->RenderTarget()->RenderPassByIndex(_index);
     }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseCamera<T>::SetDynamicResolution(bool _enabled)
+    {
+      this->RenderTarget()->SetDynamicResolution(_enabled);
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    bool BaseCamera<T>::DynamicResolution() const
+    {
+      return this->RenderTarget()->DynamicResolution();
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseCamera<T>::SetTargetFrameTime(double _seconds)
+    {
+      this->RenderTarget()->SetTargetFrameTime(_seconds);
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    double BaseCamera<T>::TargetFrameTime() const
+    {
+      return this->RenderTarget()->TargetFrameTime();
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseCamera<T>::SetResolutionScaleRange(double _min, double _max)
+    {
+      this->RenderTarget()->SetResolutionScaleRange(_min, _max);
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    double BaseCamera<T>::MinResolutionScale() const
+    {
+      return this->RenderTarget()->MinResolutionScale();
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    double BaseCamera<T>::MaxResolutionScale() const
+    {
+      return this->RenderTarget()->MaxResolutionScale();
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseCamera<T>::SetResolutionScale(double _scale)
+    {
+      this->RenderTarget()->SetResolutionScale(_scale);
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    double BaseCamera<T>::ResolutionScale() const
+    {
+      return this->RenderTarget()->ResolutionScale();
+    }
     }
   }
 }
@@ -19,6 +19,7 @@
 #define IGNITION_RENDERING_BASE_BASEGIZMOVISUAL_HH_
 
 #include <map>
+#include <set>
 #include <string>
 #include <ignition/common/MeshManager.hh>
 #include <ignition/common/SuppressWarning.hh>
@@ -77,9 +78,27 @@ namespace ignition
       /// \brief Reset the gizmo visual state
       public: virtual void Reset();
 
-      /// \brief Create materials used by the gizmo visual
+      /// \brief Create materials used by the gizmo visual. The materials
+      /// are shared by all gizmo visuals in the scene.
       protected: void CreateMaterials();
 
+      /// \brief Create the visuals of a transform mode if they have not
+      /// been created yet
+      /// \param[in] _mode Transform mode
+      protected: void CreateModeVisual(unsigned int _mode);
+
+      /// \brief Get the default material of an axis
+      /// \param[in] _axis Transform axis
+      /// \return Material of the x, y or z axis
+      protected: MaterialPtr AxisMaterial(unsigned int _axis);
+
+      /// \brief Set the material of an axis visual, keeping the material of
+      /// its handle
+      /// \param[in] _axis Transform axis
+      /// \param[in] _material Material to set
+      protected: void SetAxisMaterial(unsigned int _axis,
+          MaterialPtr _material);
+
       /// \brief Create gizmo visual for translation
       protected: void CreateTranslationVisual();
 
@@ -87,7 +106,6 @@ namespace ignition
       protected: void CreateRotationVisual();
 
       /// \brief Create gizmo visual for scale
-      /// \return Rotation visual
       protected: void CreateScaleVisual();
 
       /// \brief Current gizmo mode
@@ -111,6 +129,9 @@ namespace ignition
 
       /// \brief A map of axis enums to materials
       protected: std::map<unsigned int, MaterialPtr> materials;
+
+      /// \brief Axes that currently use the active material
+      protected: std::set<unsigned int> activeAxes;
       IGN_COMMON_WARN_RESUME__DLL_INTERFACE_MISSING
 
       /// \brief Material used by axes
@@ -152,58 +173,18 @@ namespace ignition
     {
       T::Init();
 
+      // the visuals of each mode are created the first time the mode is
+      // used, see CreateModeVisual
       this->CreateMaterials();
-      this->CreateTranslationVisual();
-      this->CreateRotationVisual();
-      this->CreateScaleVisual();
-
-      for (auto v : this->visuals)
-        v.second->SetVisible(false);
     }
 
     //////////////////////////////////////////////////
     template <class T>
     void BaseGizmoVisual<T>::Reset()
     {
-      this->visuals[TransformAxis::TA_TRANSLATION_X]->SetMaterial(
-          this->materials[AM_X], false);
-      this->visuals[TransformAxis::TA_TRANSLATION_Y]->SetMaterial(
-          this->materials[AM_Y], false);
-      this->visuals[TransformAxis::TA_TRANSLATION_Z]->SetMaterial(
-          this->materials[AM_Z], false);
-      this->visuals[TransformAxis::TA_ROTATION_X]->SetMaterial(
-          this->materials[AM_X], false);
-      this->visuals[TransformAxis::TA_ROTATION_Y]->SetMaterial(
-          this->materials[AM_Y], false);
-      this->visuals[TransformAxis::TA_ROTATION_Z]->SetMaterial(
-          this->materials[AM_Z], false);
-      this->visuals[TransformAxis::TA_SCALE_X]->SetMaterial(
-          this->materials[AM_X], false);
-      this->visuals[TransformAxis::TA_SCALE_Y]->SetMaterial(
-          this->materials[AM_Y], false);
-      this->visuals[TransformAxis::TA_SCALE_Z]->SetMaterial(
-          this->materials[AM_Z], false);
-
-      this->handles[TransformAxis::TA_TRANSLATION_X]->SetMaterial(
-          this->materials[AM_HANDLE], false);
-      this->handles[TransformAxis::TA_TRANSLATION_Y]->SetMaterial(
-          this->materials[AM_HANDLE], false);
-      this->handles[TransformAxis::TA_TRANSLATION_Z]->SetMaterial(
-          this->materials[AM_HANDLE], false);
-
-      this->handles[TransformAxis::TA_ROTATION_X]->SetMaterial(
-          this->materials[AM_HANDLE], false);
-      this->handles[TransformAxis::TA_ROTATION_Y]->SetMaterial(
-          this->materials[AM_HANDLE], false);
-      this->handles[TransformAxis::TA_ROTATION_Z]->SetMaterial(
-          this->materials[AM_HANDLE], false);
-
-      this->handles[TransformAxis::TA_SCALE_X]->SetMaterial(
-          this->materials[AM_HANDLE], false);
-      this->handles[TransformAxis::TA_SCALE_Y]->SetMaterial(
-          this->materials[AM_HANDLE], false);
-      this->handles[TransformAxis::TA_SCALE_Z]->SetMaterial(
-          this->materials[AM_HANDLE], false);
+      for (auto a : this->activeAxes)
+        this->SetAxisMaterial(a, this->AxisMaterial(a));
+      this->activeAxes.clear();
 
       for (auto v : this->visuals)
         v.second->SetVisible(false);
@@ -218,93 +199,39 @@ namespace ignition
 
       this->Reset();
 
-      if (this->mode == TransformMode::TM_NONE)
-      {
-        this->modeDirty = false;
-        return;
-      }
-
+      // x, y and z axes of the current mode
+      unsigned int axes[3] = {0u, 0u, 0u};
       if (this->mode & TransformMode::TM_TRANSLATION)
       {
-        this->visuals[TransformAxis::TA_TRANSLATION_X]->SetVisible(true);
-        this->visuals[TransformAxis::TA_TRANSLATION_Y]->SetVisible(true);
-        this->visuals[TransformAxis::TA_TRANSLATION_Z]->SetVisible(true);
+        axes[0] = TransformAxis::TA_TRANSLATION_X;
+        axes[1] = TransformAxis::TA_TRANSLATION_Y;
+        axes[2] = TransformAxis::TA_TRANSLATION_Z;
         this->visuals[TransformAxis::TA_TRANSLATION_Z << 1]->SetVisible(true);
-        if (this->axis.X() > 0)
-        {
-          this->visuals[TransformAxis::TA_TRANSLATION_X]->SetMaterial(
-              this->materials[AM_ACTIVE], false);
-          this->handles[TransformAxis::TA_TRANSLATION_X]->SetMaterial(
-              this->materials[AM_HANDLE], false);
-        }
-        if (this->axis.Y() > 0)
-        {
-          this->visuals[TransformAxis::TA_TRANSLATION_Y]->SetMaterial(
-              this->materials[AM_ACTIVE], false);
-          this->handles[TransformAxis::TA_TRANSLATION_Y]->SetMaterial(
-              this->materials[AM_HANDLE], false);
-        }
-        if (this->axis.Z() > 0)
-        {
-          this->visuals[TransformAxis::TA_TRANSLATION_Z]->SetMaterial(
-              this->materials[AM_ACTIVE], false);
-          this->handles[TransformAxis::TA_TRANSLATION_Z]->SetMaterial(
-              this->materials[AM_HANDLE], false);
-        }
       }
       else if (this->mode & TransformMode::TM_ROTATION)
       {
-        this->visuals[TransformAxis::TA_ROTATION_X]->SetVisible(true);
-        this->visuals[TransformAxis::TA_ROTATION_Y]->SetVisible(true);
-        this->visuals[TransformAxis::TA_ROTATION_Z]->SetVisible(true);
+        axes[0] = TransformAxis::TA_ROTATION_X;
+        axes[1] = TransformAxis::TA_ROTATION_Y;
+        axes[2] = TransformAxis::TA_ROTATION_Z;
         this->visuals[TransformAxis::TA_ROTATION_Z << 1]->SetVisible(true);
-        if (this->axis.X() > 0)
-        {
-          this->visuals[TransformAxis::TA_ROTATION_X]->SetMaterial(
-              this->materials[AM_ACTIVE], false);
-          this->handles[TransformAxis::TA_ROTATION_X]->SetMaterial(
-              this->materials[AM_HANDLE], false);
-        }
-        if (this->axis.Y() > 0)
-        {
-          this->visuals[TransformAxis::TA_ROTATION_Y]->SetMaterial(
-              this->materials[AM_ACTIVE], false);
-          this->handles[TransformAxis::TA_ROTATION_Y]->SetMaterial(
-              this->materials[AM_HANDLE], false);
-        }
-        if (this->axis.Z() > 0)
-        {
-          this->visuals[TransformAxis::TA_ROTATION_Z]->SetMaterial(
-              this->materials[AM_ACTIVE], false);
-          this->handles[TransformAxis::TA_ROTATION_Z]->SetMaterial(
-              this->materials[AM_HANDLE], false);
-        }
       }
       else if (this->mode & TransformMode::TM_SCALE)
       {
-        this->visuals[TransformAxis::TA_SCALE_X]->SetVisible(true);
-        this->visuals[TransformAxis::TA_SCALE_Y]->SetVisible(true);
-        this->visuals[TransformAxis::TA_SCALE_Z]->SetVisible(true);
-        if (this->axis.X() > 0)
-        {
-          this->visuals[TransformAxis::TA_SCALE_X]->SetMaterial(
-              this->materials[AM_ACTIVE], false);
-          this->handles[TransformAxis::TA_SCALE_X]->SetMaterial(
-              this->materials[AM_HANDLE], false);
-        }
-        if (this->axis.Y() > 0)
-        {
-          this->visuals[TransformAxis::TA_SCALE_Y]->SetMaterial(
-              this->materials[AM_ACTIVE], false);
-          this->handles[TransformAxis::TA_SCALE_Y]->SetMaterial(
-              this->materials[AM_HANDLE], false);
-        }
-        if (this->axis.Z() > 0)
+        axes[0] = TransformAxis::TA_SCALE_X;
+        axes[1] = TransformAxis::TA_SCALE_Y;
+        axes[2] = TransformAxis::TA_SCALE_Z;
+      }
+
+      for (unsigned int i = 0u; i < 3u; ++i)
+      {
+        if (axes[i] == 0u)
+          continue;
+
+        this->visuals[axes[i]]->SetVisible(true);
+        if (this->axis[i] > 0)
         {
-          this->visuals[TransformAxis::TA_SCALE_Z]->SetMaterial(
-              this->materials[AM_ACTIVE], false);
-          this->handles[TransformAxis::TA_SCALE_Z]->SetMaterial(
-              this->materials[AM_HANDLE], false);
+          this->SetAxisMaterial(axes[i], this->materials[AM_ACTIVE]);
+          this->activeAxes.insert(axes[i]);
         }
       }
 
@@ -319,6 +246,9 @@ namespace ignition
         return;
 
       this->mode = _mode;
+      // create the visuals now so that they can be queried before the next
+      // PreRender call
+      this->CreateModeVisual(_mode);
       // clear active axis when mode changes
       this->axis = math::Vector3d::Zero;
       this->modeDirty = true;
@@ -368,21 +298,22 @@ namespace ignition
     template <class T>
     void BaseGizmoVisual<T>::CreateMaterials()
     {
-      MaterialPtr xMat = this->Scene()->Material("Default/TransRed")->Clone();
-      MaterialPtr yMat = this->Scene()->Material("Default/TransGreen")->Clone();
-      MaterialPtr zMat = this->Scene()->Material("Default/TransBlue")->Clone();
-      MaterialPtr activeMat =
-          this->Scene()->Material("Default/TransYellow")->Clone();
-
-      // disable depth checking and writing, make them overlays
-      xMat->SetDepthWriteEnabled(false);
-      xMat->SetDepthCheckEnabled(false);
-      yMat->SetDepthWriteEnabled(false);
-      yMat->SetDepthCheckEnabled(false);
-      zMat->SetDepthWriteEnabled(false);
-      zMat->SetDepthCheckEnabled(false);
-      activeMat->SetDepthWriteEnabled(false);
-      activeMat->SetDepthCheckEnabled(false);
+      // axis colors are shared by all gizmos in the scene, so creating
+      // more gizmos does not create more materials
+      std::map<std::string, std::string> axisMaterials = {
+          {"GizmoX", "Default/TransRed"},
+          {"GizmoY", "Default/TransGreen"},
+          {"GizmoZ", "Default/TransBlue"},
+          {"GizmoActive", "Default/TransYellow"}};
+      for (const auto &m : axisMaterials)
+      {
+        if (this->Scene()->MaterialRegistered(m.first))
+          continue;
+        MaterialPtr mat = this->Scene()->Material(m.second)->Clone(m.first);
+        // disable depth checking and writing, make them overlays
+        mat->SetDepthWriteEnabled(false);
+        mat->SetDepthCheckEnabled(false);
+      }
 
       MaterialPtr oMat = this->Scene()->Material("GizmoGray");
       if (!oMat)
@@ -414,13 +345,72 @@ namespace ignition
         handleMat->SetDepthCheckEnabled(false);
       }
 
-      this->materials[AM_X] = xMat;
-      this->materials[AM_Y] = yMat;
-      this->materials[AM_Z] = zMat;
-      this->materials[AM_ACTIVE] = activeMat;
+      this->materials[AM_X] = this->Scene()->Material("GizmoX");
+      this->materials[AM_Y] = this->Scene()->Material("GizmoY");
+      this->materials[AM_Z] = this->Scene()->Material("GizmoZ");
+      this->materials[AM_ACTIVE] = this->Scene()->Material("GizmoActive");
       this->materials[AM_O] = oMat;
       this->materials[AM_HANDLE] = handleMat;
     }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseGizmoVisual<T>::CreateModeVisual(unsigned int _mode)
+    {
+      if ((_mode & TransformMode::TM_TRANSLATION) &&
+          !this->visuals.count(TransformAxis::TA_TRANSLATION_X))
+      {
+        this->CreateTranslationVisual();
+      }
+      else if ((_mode & TransformMode::TM_ROTATION) &&
+          !this->visuals.count(TransformAxis::TA_ROTATION_X))
+      {
+        this->CreateRotationVisual();
+      }
+      else if ((_mode & (TransformAxis::TA_SCALE_X |
+          TransformAxis::TA_SCALE_Y | TransformAxis::TA_SCALE_Z)) &&
+          !this->visuals.count(TransformAxis::TA_SCALE_X))
+      {
+        this->CreateScaleVisual();
+      }
+      else
+      {
+        return;
+      }
+
+      // update visibility of the new visuals in the next PreRender call
+      this->modeDirty = true;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    MaterialPtr BaseGizmoVisual<T>::AxisMaterial(unsigned int _axis)
+    {
+      if (_axis & (TransformAxis::TA_TRANSLATION_X |
+          TransformAxis::TA_ROTATION_X | TransformAxis::TA_SCALE_X))
+        return this->materials[AM_X];
+      if (_axis & (TransformAxis::TA_TRANSLATION_Y |
+          TransformAxis::TA_ROTATION_Y | TransformAxis::TA_SCALE_Y))
+        return this->materials[AM_Y];
+      return this->materials[AM_Z];
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseGizmoVisual<T>::SetAxisMaterial(unsigned int _axis,
+        MaterialPtr _material)
+    {
+      auto it = this->visuals.find(_axis);
+      if (it == this->visuals.end())
+        return;
+      it->second->SetMaterial(_material, false);
+
+      // setting the material of the axis visual also sets it on its handle
+      auto handleIt = this->handles.find(_axis);
+      if (handleIt != this->handles.end())
+        handleIt->second->SetMaterial(this->materials[AM_HANDLE], false);
+    }
+
     //////////////////////////////////////////////////
     template <class T>
     void BaseGizmoVisual<T>::CreateTranslationVisual()
@@ -712,6 +702,16 @@ namespace ignition
     template <class T>
     VisualPtr BaseGizmoVisual<T>::ChildByAxis(unsigned int _axis) const
     {
+      // create the visuals of the mode the axis belongs to if needed. The
+      // origin visuals of the translation and rotation modes use the bit
+      // after their z axis.
+      unsigned int axisMode = _axis;
+      if (_axis == (TransformAxis::TA_TRANSLATION_Z << 1))
+        axisMode = TransformAxis::TA_TRANSLATION_Z;
+      else if (_axis == (TransformAxis::TA_ROTATION_Z << 1))
+        axisMode = TransformAxis::TA_ROTATION_Z;
+      const_cast<BaseGizmoVisual<T> *>(this)->CreateModeVisual(axisMode);
+
       auto it = this->visuals.find(_axis);
       if (it != this->visuals.end())
         return it->second;
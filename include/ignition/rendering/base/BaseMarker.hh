@@ -17,6 +17,13 @@
 #ifndef IGNITION_RENDERING_BASEMARKER_HH_
 #define IGNITION_RENDERING_BASEMARKER_HH_
 
+#include <string>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+#include <ignition/common/Mesh.hh>
+#include <ignition/common/MeshManager.hh>
+#include <ignition/common/SubMesh.hh>
 #include <ignition/common/SuppressWarning.hh>
 
 #include "ignition/rendering/Marker.hh"
@@ -82,6 +89,47 @@ namespace ignition
       public: virtual void SetPoint(unsigned int _index,
                   const ignition::math::Vector3d &_value) override;
 
+      // Documentation inherited
+      public: virtual void SetPointTexCoord(unsigned int _index,
+                  const ignition::math::Vector2d &_texCoord) override;
+
+      // Documentation inherited
+      public: virtual void SetListElements(
+                  const std::vector<ignition::math::Pose3d> &_poses,
+                  const std::vector<ignition::math::Vector3d> &_scales,
+                  const std::vector<ignition::math::Color> &_colors)
+                  override;
+
+      // Documentation inherited
+      public: virtual unsigned int ListElementCount() const override;
+
+      // Documentation inherited
+      public: virtual ignition::math::Color ListElementColor(
+                  unsigned int _index) const override;
+
+      /// \brief Get the size of a shape of a list marker
+      /// \param[in] _index Index of the shape
+      /// \return Size of the shape
+      protected: ignition::math::Vector3d ListElementScale(
+                  unsigned int _index) const;
+
+      /// \brief Copy the triangles of the list primitive into the points
+      /// of the marker, once per shape. It is used by engines that draw
+      /// list markers as one dynamic triangle list.
+      protected: void BakeListElements();
+
+      /// \brief Get whether a marker type is a list of shapes
+      /// \param[in] _markerType Marker type
+      /// \return True for MT_BOX_LIST, MT_CYLINDER_LIST and MT_SPHERE_LIST
+      protected: static bool IsListType(MarkerType _markerType);
+
+      /// \brief Get the unit primitive mesh shared by all list markers of
+      /// a type. It is created the first time it is needed.
+      /// \param[in] _markerType List marker type
+      /// \return Primitive mesh, or null if the type is not a list type
+      protected: static const common::Mesh *ListPrimitive(
+                  MarkerType _markerType);
+
       /// \brief Life time of a marker
       IGN_COMMON_WARN_IGNORE__DLL_INTERFACE_MISSING
       protected: std::chrono::steady_clock::duration lifetime =
@@ -97,6 +145,20 @@ namespace ignition
       /// \brief Marker type
       protected: MarkerType markerType =
           ignition::rendering::MarkerType::MT_NONE;
+
+      /// \brief Poses of the shapes of a list marker
+      protected: std::vector<ignition::math::Pose3d> listPoses;
+
+      /// \brief Sizes of the shapes of a list marker. Empty, one value for
+      /// all shapes or one value per shape.
+      protected: std::vector<ignition::math::Vector3d> listScales;
+
+      /// \brief Colors of the shapes of a list marker. Empty, one value
+      /// for all shapes or one value per shape.
+      protected: std::vector<ignition::math::Color> listColors;
+
+      /// \brief Flag to indicate if the list shapes need to be updated
+      protected: bool listDirty = false;
     };
 
     /////////////////////////////////////////////////
@@ -203,6 +265,143 @@ namespace ignition
     {
       // no op
     }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    void BaseMarker<T>::SetPointTexCoord(unsigned int,
+                  const ignition::math::Vector2d &)
+    {
+      // no op
+    }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    void BaseMarker<T>::SetListElements(
+        const std::vector<ignition::math::Pose3d> &_poses,
+        const std::vector<ignition::math::Vector3d> &_scales,
+        const std::vector<ignition::math::Color> &_colors)
+    {
+      if (!IsListType(this->markerType))
+      {
+        ignerr << "Marker type [" << this->markerType << "] is not a list "
+               << "type" << std::endl;
+        return;
+      }
+
+      size_t count = _poses.size();
+      if (_scales.size() > 1u && _scales.size() != count)
+      {
+        ignerr << "Number of scales [" << _scales.size() << "] does not "
+               << "match the number of poses [" << count << "]" << std::endl;
+        return;
+      }
+      if (_colors.size() > 1u && _colors.size() != count)
+      {
+        ignerr << "Number of colors [" << _colors.size() << "] does not "
+               << "match the number of poses [" << count << "]" << std::endl;
+        return;
+      }
+
+      this->listPoses = _poses;
+      this->listScales = _scales;
+      this->listColors = _colors;
+      this->listDirty = true;
+    }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    unsigned int BaseMarker<T>::ListElementCount() const
+    {
+      return static_cast<unsigned int>(this->listPoses.size());
+    }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    math::Color BaseMarker<T>::ListElementColor(unsigned int _index) const
+    {
+      if (this->listColors.empty() || _index >= this->listPoses.size())
+        return math::Color::White;
+      if (this->listColors.size() == 1u)
+        return this->listColors[0];
+      return this->listColors[_index];
+    }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    math::Vector3d BaseMarker<T>::ListElementScale(unsigned int _index) const
+    {
+      if (this->listScales.empty() || _index >= this->listPoses.size())
+        return math::Vector3d::One;
+      if (this->listScales.size() == 1u)
+        return this->listScales[0];
+      return this->listScales[_index];
+    }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    void BaseMarker<T>::BakeListElements()
+    {
+      this->listDirty = false;
+      const common::Mesh *primitive = ListPrimitive(this->markerType);
+      if (!primitive)
+        return;
+
+      // all shapes are appended to a single triangle list
+      this->ClearPoints();
+      for (unsigned int i = 0u; i < this->ListElementCount(); ++i)
+      {
+        const math::Pose3d &pose = this->listPoses[i];
+        math::Vector3d scale = this->ListElementScale(i);
+        math::Color color = this->ListElementColor(i);
+        for (unsigned int j = 0u; j < primitive->SubMeshCount(); ++j)
+        {
+          auto subMesh = primitive->SubMeshByIndex(j).lock();
+          if (!subMesh)
+            continue;
+          for (unsigned int k = 0u; k < subMesh->IndexCount(); ++k)
+          {
+            math::Vector3d v = subMesh->Vertex(subMesh->Index(k)) * scale;
+            this->AddPoint(pose.Pos() + pose.Rot() * v, color);
+          }
+        }
+      }
+    }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    bool BaseMarker<T>::IsListType(MarkerType _markerType)
+    {
+      return _markerType == MT_BOX_LIST || _markerType == MT_CYLINDER_LIST ||
+          _markerType == MT_SPHERE_LIST;
+    }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    const common::Mesh *BaseMarker<T>::ListPrimitive(MarkerType _markerType)
+    {
+      // low resolution primitives, since list markers can have many shapes
+      common::MeshManager *meshMgr = common::MeshManager::Instance();
+      std::string name;
+      switch (_markerType)
+      {
+        case MT_BOX_LIST:
+          name = "unit_box";
+          break;
+        case MT_CYLINDER_LIST:
+          name = "marker_list_cylinder";
+          if (!meshMgr->HasMesh(name))
+            meshMgr->CreateCylinder(name, 0.5f, 1.0f, 1, 16);
+          break;
+        case MT_SPHERE_LIST:
+          name = "marker_list_sphere";
+          if (!meshMgr->HasMesh(name))
+            meshMgr->CreateSphere(name, 0.5f, 8, 12);
+          break;
+        default:
+          return nullptr;
+      }
+      return meshMgr->MeshByName(name);
+    }
     }
   }
 }
@@ -17,6 +17,7 @@
 #ifndef IGNITION_RENDERING_BASE_BASEMATERIAL_HH_
 #define IGNITION_RENDERING_BASE_BASEMATERIAL_HH_
 
+#include <memory>
 #include <string>
 
 #include "ignition/common/Console.hh"
@@ -164,6 +165,10 @@ namespace ignition
       // Documentation inherited
       public: virtual void SetTexture(const std::string &_texture) override;
 
+      // Documentation inherited
+      public: virtual void SetTexture(const std::string &_name,
+                  const std::shared_ptr<const common::Image> &_img) override;
+
       // Documentation inherited
       public: virtual void ClearTexture() override;
 
@@ -674,6 +679,14 @@ namespace ignition
       // no op
     }
 
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseMaterial<T>::SetTexture(const std::string &,
+        const std::shared_ptr<const common::Image> &)
+    {
+      // no op
+    }
+
     //////////////////////////////////////////////////
     template <class T>
     void BaseMaterial<T>::ClearTexture()
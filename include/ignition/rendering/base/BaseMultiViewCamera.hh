@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_BASE_BASEMULTIVIEWCAMERA_HH_
+#define IGNITION_RENDERING_BASE_BASEMULTIVIEWCAMERA_HH_
+
+#include <vector>
+
+#include <ignition/common/Console.hh>
+
+#include "ignition/rendering/MultiViewCamera.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    /// \brief Base implementation of the MultiViewCamera class
+    template <class T>
+    class BaseMultiViewCamera :
+      public virtual MultiViewCamera,
+      public virtual T
+    {
+      /// \brief Constructor
+      protected: BaseMultiViewCamera();
+
+      /// \brief Destructor
+      public: virtual ~BaseMultiViewCamera();
+
+      // Documentation inherited.
+      public: virtual unsigned int AddView(const math::Pose3d &_pose)
+                  override;
+
+      // Documentation inherited.
+      public: virtual unsigned int ViewCount() const override;
+
+      // Documentation inherited.
+      public: virtual math::Pose3d ViewPose(unsigned int _index) const
+                  override;
+
+      // Documentation inherited.
+      public: virtual void SetViewPose(unsigned int _index,
+                  const math::Pose3d &_pose) override;
+
+      // Documentation inherited.
+      public: virtual void ClearViews() override;
+
+      /// \brief Poses of the views relative to the camera
+      protected: std::vector<math::Pose3d> viewPoses;
+    };
+
+    //////////////////////////////////////////////////
+    template <class T>
+    BaseMultiViewCamera<T>::BaseMultiViewCamera()
+    {
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    BaseMultiViewCamera<T>::~BaseMultiViewCamera()
+    {
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    unsigned int BaseMultiViewCamera<T>::AddView(const math::Pose3d &_pose)
+    {
+      this->viewPoses.push_back(_pose);
+      return static_cast<unsigned int>(this->viewPoses.size() - 1u);
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    unsigned int BaseMultiViewCamera<T>::ViewCount() const
+    {
+      return static_cast<unsigned int>(this->viewPoses.size());
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    math::Pose3d BaseMultiViewCamera<T>::ViewPose(unsigned int _index) const
+    {
+      if (_index >= this->viewPoses.size())
+      {
+        ignerr << "View index out of range: " << _index << std::endl;
+        return math::Pose3d::Zero;
+      }
+      return this->viewPoses[_index];
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseMultiViewCamera<T>::SetViewPose(unsigned int _index,
+        const math::Pose3d &_pose)
+    {
+      if (_index >= this->viewPoses.size())
+      {
+        ignerr << "View index out of range: " << _index << std::endl;
+        return;
+      }
+      this->viewPoses[_index] = _pose;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseMultiViewCamera<T>::ClearViews()
+    {
+      this->viewPoses.clear();
+    }
+    }
+  }
+}
+#endif
@@ -19,6 +19,7 @@
 
 #include <string>
 #include "ignition/rendering/Node.hh"
+#include "ignition/rendering/Scene.hh"
 #include "ignition/rendering/Storage.hh"
 #include "ignition/rendering/base/BaseStorage.hh"
 
@@ -185,6 +186,9 @@ namespace ignition
       protected: virtual void SetLocalScaleImpl(
                      const math::Vector3d &_scale) = 0;
 
+      /// \brief Tell the scene that the bounds of this node changed
+      protected: void MarkSceneBoundsDirty();
+
       protected: math::Vector3d origin;
     };
 
@@ -228,6 +232,7 @@ namespace ignition
       if (this->AttachChild(_child))
       {
         this->Children()->Add(_child);
+        this->MarkSceneBoundsDirty();
       }
     }
 
@@ -236,7 +241,11 @@ namespace ignition
     NodePtr BaseNode<T>::RemoveChild(NodePtr _child)
     {
       NodePtr child = this->Children()->Remove(_child);
-      if (child) this->DetachChild(child);
+      if (child)
+      {
+        this->DetachChild(child);
+        this->MarkSceneBoundsDirty();
+      }
       return child;
     }
 
@@ -245,7 +254,11 @@ namespace ignition
     NodePtr BaseNode<T>::RemoveChildById(unsigned int _id)
     {
       NodePtr child = this->Children()->RemoveById(_id);
-      if (child) this->DetachChild(child);
+      if (child)
+      {
+        this->DetachChild(child);
+        this->MarkSceneBoundsDirty();
+      }
       return child;
     }
 
@@ -254,7 +267,11 @@ namespace ignition
     NodePtr BaseNode<T>::RemoveChildByName(const std::string &_name)
     {
       NodePtr child = this->Children()->RemoveByName(_name);
-      if (child) this->DetachChild(child);
+      if (child)
+      {
+        this->DetachChild(child);
+        this->MarkSceneBoundsDirty();
+      }
       return child;
     }
 
@@ -263,7 +280,11 @@ namespace ignition
     NodePtr BaseNode<T>::RemoveChildByIndex(unsigned int _index)
     {
       NodePtr child = this->Children()->RemoveByIndex(_index);
-      if (child) this->DetachChild(child);
+      if (child)
+      {
+        this->DetachChild(child);
+        this->MarkSceneBoundsDirty();
+      }
       return child;
     }
 
@@ -321,6 +342,16 @@ namespace ignition
       }
 
       this->SetRawLocalPose(pose);
+      this->MarkSceneBoundsDirty();
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseNode<T>::MarkSceneBoundsDirty()
+    {
+      ScenePtr scene = this->Scene();
+      if (scene)
+        scene->MarkBoundsDirty(this->Id());
     }
 
     //////////////////////////////////////////////////
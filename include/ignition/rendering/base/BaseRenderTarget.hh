@@ -17,11 +17,13 @@
 #ifndef IGNITION_RENDERING_BASE_BASERENDERTARGET_HH_
 #define IGNITION_RENDERING_BASE_BASERENDERTARGET_HH_
 
+#include <chrono>
 #include <string>
 #include <vector>
 
 #include "ignition/rendering/RenderPass.hh"
 #include "ignition/rendering/RenderTarget.hh"
+#include "ignition/rendering/ResolutionScaler.hh"
 #include "ignition/rendering/Scene.hh"
 #include "ignition/rendering/base/BaseRenderTypes.hh"
 
@@ -75,8 +77,42 @@ namespace ignition
       public: virtual RenderPassPtr RenderPassByIndex(unsigned int _index)
           const override;
 
+      // Documentation inherited
+      public: virtual void SetDynamicResolution(bool _enabled) override;
+
+      // Documentation inherited
+      public: virtual bool DynamicResolution() const override;
+
+      // Documentation inherited
+      public: virtual void SetTargetFrameTime(double _seconds) override;
+
+      // Documentation inherited
+      public: virtual double TargetFrameTime() const override;
+
+      // Documentation inherited
+      public: virtual void SetResolutionScaleRange(double _min, double _max)
+          override;
+
+      // Documentation inherited
+      public: virtual double MinResolutionScale() const override;
+
+      // Documentation inherited
+      public: virtual double MaxResolutionScale() const override;
+
+      // Documentation inherited
+      public: virtual void SetResolutionScale(double _scale) override;
+
+      // Documentation inherited
+      public: virtual double ResolutionScale() const override;
+
       protected: virtual void Rebuild();
 
+      /// \brief Get the time taken by the frame that just finished, used by
+      /// dynamic resolution. By default this is the time since PreRender.
+      /// \return Frame time in seconds, or a negative value if the frame
+      /// was not measured
+      protected: virtual double FrameTime();
+
       protected: virtual void RebuildImpl() = 0;
 
       protected: PixelFormat format = PF_UNKNOWN;
@@ -92,6 +128,12 @@ namespace ignition
 
       /// \brief A chain of render passes applied to the render target
       protected: std::vector<RenderPassPtr> renderPasses;
+
+      /// \brief Chooses the resolution scale from the frame times
+      protected: ResolutionScaler resolutionScaler;
+
+      /// \brief Time the current frame started in PreRender
+      protected: std::chrono::steady_clock::time_point frameStart;
     };
 
     template <class T>
@@ -152,6 +194,7 @@ namespace ignition
     template <class T>
     void BaseRenderTarget<T>::PreRender()
     {
+      this->frameStart = std::chrono::steady_clock::now();
       T::PreRender();
       this->Rebuild();
       for (auto &pass : this->renderPasses)
@@ -163,6 +206,22 @@ namespace ignition
     void BaseRenderTarget<T>::PostRender()
     {
       T::PostRender();
+
+      if (this->resolutionScaler.Dynamic())
+      {
+        double frameTime = this->FrameTime();
+        if (frameTime >= 0.0)
+          this->resolutionScaler.Update(frameTime);
+      }
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    double BaseRenderTarget<T>::FrameTime()
+    {
+      std::chrono::duration<double> frameTime =
+          std::chrono::steady_clock::now() - this->frameStart;
+      return frameTime.count();
     }
 
     //////////////////////////////////////////////////
@@ -270,6 +329,70 @@ namespace ignition
       return this->renderPasses[_index];
     }
 
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseRenderTarget<T>::SetDynamicResolution(bool _enabled)
+    {
+      this->resolutionScaler.SetDynamic(_enabled);
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    bool BaseRenderTarget<T>::DynamicResolution() const
+    {
+      return this->resolutionScaler.Dynamic();
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseRenderTarget<T>::SetTargetFrameTime(double _seconds)
+    {
+      this->resolutionScaler.SetTargetFrameTime(_seconds);
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    double BaseRenderTarget<T>::TargetFrameTime() const
+    {
+      return this->resolutionScaler.TargetFrameTime();
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseRenderTarget<T>::SetResolutionScaleRange(double _min,
+        double _max)
+    {
+      this->resolutionScaler.SetScaleRange(_min, _max);
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    double BaseRenderTarget<T>::MinResolutionScale() const
+    {
+      return this->resolutionScaler.MinScale();
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    double BaseRenderTarget<T>::MaxResolutionScale() const
+    {
+      return this->resolutionScaler.MaxScale();
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseRenderTarget<T>::SetResolutionScale(double _scale)
+    {
+      this->resolutionScaler.SetFixedScale(_scale);
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    double BaseRenderTarget<T>::ResolutionScale() const
+    {
+      return this->resolutionScaler.Scale();
+    }
+
     //////////////////////////////////////////////////
     // BaseRenderTexture
     //////////////////////////////////////////////////
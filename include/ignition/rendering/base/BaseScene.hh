@@ -18,14 +18,17 @@
 #define IGNITION_RENDERING_BASE_BASESCENE_HH_
 
 #include <array>
+#include <map>
 #include <set>
 #include <string>
+#include <vector>
 
 #include <ignition/common/Console.hh>
 #include <ignition/common/SuppressWarning.hh>
 
 #include "ignition/rendering/RenderEngine.hh"
 #include "ignition/rendering/Scene.hh"
+#include "ignition/rendering/VisibilityIndex.hh"
 #include "ignition/rendering/base/BaseRenderTypes.hh"
 
 namespace ignition
@@ -237,6 +240,24 @@ namespace ignition
       // Documentation inherited
       public: virtual void DestroyMaterials() override;
 
+      // Documentation inherited.
+      public: virtual void UpdateVisualMaterials(
+                  const std::vector<VisualMaterialUpdate> &_updates) override;
+
+      // Documentation inherited.
+      public: virtual void ResetVisualMaterial(VisualPtr _visual) override;
+
+      // Documentation inherited.
+      public: virtual unsigned int BatchMaterialCount() const override;
+
+      // Documentation inherited.
+      public: virtual uint32_t VisibilityLayer(const std::string &_name)
+                  override;
+
+      // Documentation inherited.
+      public: virtual uint32_t VisibilityLayerFlag(
+                  const std::string &_name) const override;
+
       public: virtual DirectionalLightPtr CreateDirectionalLight() override;
 
       public: virtual DirectionalLightPtr CreateDirectionalLight(
@@ -303,6 +324,37 @@ namespace ignition
       public: virtual ThermalCameraPtr CreateThermalCamera(
                   const unsigned int _id, const std::string &_name) override;
 
+      // Documentation inherited.
+      public: virtual MultiViewCameraPtr CreateMultiViewCamera() override;
+
+      // Documentation inherited.
+      public: virtual MultiViewCameraPtr CreateMultiViewCamera(
+                  const unsigned int _id) override;
+
+      // Documentation inherited.
+      public: virtual MultiViewCameraPtr CreateMultiViewCamera(
+                  const std::string &_name) override;
+
+      // Documentation inherited.
+      public: virtual MultiViewCameraPtr CreateMultiViewCamera(
+                  const unsigned int _id, const std::string &_name) override;
+
+      // Documentation inherited.
+      public: virtual BoundingBoxCameraPtr CreateBoundingBoxCamera()
+                  override;
+
+      // Documentation inherited.
+      public: virtual BoundingBoxCameraPtr CreateBoundingBoxCamera(
+                  const unsigned int _id) override;
+
+      // Documentation inherited.
+      public: virtual BoundingBoxCameraPtr CreateBoundingBoxCamera(
+                  const std::string &_name) override;
+
+      // Documentation inherited.
+      public: virtual BoundingBoxCameraPtr CreateBoundingBoxCamera(
+                  const unsigned int _id, const std::string &_name) override;
+
       // Documentation inherited.
       public: virtual GpuRaysPtr CreateGpuRays() override;
 
@@ -380,6 +432,10 @@ namespace ignition
 
       public: virtual MeshPtr CreateMesh(const MeshDescriptor &_desc) override;
 
+      // Documentation inherited.
+      public: virtual HeightmapPtr CreateHeightmap(
+          const HeightmapDescriptor &_desc) override;
+
       // Documentation inherited.
       public: virtual GridPtr CreateGrid() override;
 
@@ -435,6 +491,10 @@ namespace ignition
       public: virtual ParticleEmitterPtr CreateParticleEmitter(
                   unsigned int _id, const std::string &_name) override;
 
+      // Documentation inherited.
+      public: virtual const VisibilityIndex &UpdateVisibilityIndex()
+                  override;
+
       public: virtual void PreRender() override;
 
       public: virtual void Clear() override;
@@ -478,6 +538,28 @@ namespace ignition
                    return ThermalCameraPtr();
                  }
 
+      /// \brief Implementation for creating a multi-view camera.
+      /// \param[in] _id Unique id
+      /// \param[in] _name Name of multi-view camera
+      protected: virtual MultiViewCameraPtr CreateMultiViewCameraImpl(
+                     unsigned int /*_id*/, const std::string &/*_name*/)
+                 {
+                   ignerr << "Multi-view camera not supported by: "
+                          << this->Engine()->Name() << std::endl;
+                   return MultiViewCameraPtr();
+                 }
+
+      /// \brief Implementation for creating a bounding box camera.
+      /// \param[in] _id Unique id
+      /// \param[in] _name Name of bounding box camera
+      protected: virtual BoundingBoxCameraPtr CreateBoundingBoxCameraImpl(
+                     unsigned int /*_id*/, const std::string &/*_name*/)
+                 {
+                   ignerr << "Bounding box camera not supported by: "
+                          << this->Engine()->Name() << std::endl;
+                   return BoundingBoxCameraPtr();
+                 }
+
       /// \brief Implementation for creating GpuRays sensor.
       /// \param[in] _id Unique id
       /// \param[in] _name Name of GpuRays sensor
@@ -616,6 +698,20 @@ namespace ignition
       private: void DestroyNodeRecursive(NodePtr _node,
           std::set<unsigned int> &_nodeIds);
 
+      // Documentation inherited.
+      protected: virtual void ReleaseVisualMaterial(unsigned int _visualId)
+                     override;
+
+      // Documentation inherited.
+      protected: virtual void MarkBoundsDirty(unsigned int _nodeId)
+                     override;
+
+      /// \brief Stop using a material shared by UpdateVisualMaterials, and
+      /// destroy it if no other visual uses it
+      /// \param[in] _material Material no longer used by a visual. Other
+      /// materials are ignored.
+      private: void ReleaseBatchMaterial(MaterialPtr _material);
+
       protected: unsigned int id;
 
       IGN_COMMON_WARN_IGNORE__DLL_INTERFACE_MISSING
@@ -650,6 +746,39 @@ namespace ignition
 
       IGN_COMMON_WARN_IGNORE__DLL_INTERFACE_MISSING
       private: NodeStorePtr nodes;
+
+      /// \brief Material of each visual before it was first updated by
+      /// UpdateVisualMaterials, by visual id
+      private: std::map<unsigned int, MaterialPtr> batchBaseMaterials;
+
+      /// \brief Material shared by UpdateVisualMaterials that each visual
+      /// uses, by visual id
+      private: std::map<unsigned int, MaterialPtr> batchVisualMaterials;
+
+      /// \brief Number of visuals using each material shared by
+      /// UpdateVisualMaterials, by material name
+      private: std::map<std::string, unsigned int> batchMaterialUsers;
+
+      /// \brief Name of each material shared by UpdateVisualMaterials, by
+      /// the properties of the material
+      private: std::map<std::string, std::string> batchMaterialNames;
+
+      /// \brief True while UpdateVisualMaterials sets materials on visuals
+      private: bool batchUpdating = false;
+
+      /// \brief Visibility flag of each visibility layer, by layer name
+      private: std::map<std::string, uint32_t> visibilityLayers;
+
+      /// \brief Visibility index returned by UpdateVisibilityIndex
+      private: VisibilityIndex visibilityIndex;
+
+      /// \brief False until the visibility index is built and whenever
+      /// root level visuals are added or removed
+      private: bool visibilityIndexValid = false;
+
+      /// \brief Ids of the root level visuals that changed since the
+      /// visibility index was last updated
+      private: std::set<unsigned int> dirtyBounds;
       IGN_COMMON_WARN_RESUME__DLL_INTERFACE_MISSING
     };
     }
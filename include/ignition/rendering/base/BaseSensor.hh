@@ -17,6 +17,9 @@
 #ifndef IGNITION_RENDERING_BASE_BASESENSOR_HH_
 #define IGNITION_RENDERING_BASE_BASESENSOR_HH_
 
+#include <string>
+
+#include "ignition/rendering/Scene.hh"
 #include "ignition/rendering/Sensor.hh"
 
 namespace ignition
@@ -40,6 +43,14 @@ namespace ignition
       // Documentation inherited.
       public: virtual uint32_t VisibilityMask() const override;
 
+      // Documentation inherited.
+      public: virtual void SetVisibilityLayerEnabled(
+                  const std::string &_layer, bool _enabled) override;
+
+      // Documentation inherited.
+      public: virtual bool VisibilityLayerEnabled(
+                  const std::string &_layer) const override;
+
       /// \brief Camera's visibility mask
       protected: uint32_t visibilityMask = IGN_VISIBILITY_ALL;
     };
@@ -69,6 +80,30 @@ namespace ignition
     {
       return this->visibilityMask;
     }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseSensor<T>::SetVisibilityLayerEnabled(const std::string &_layer,
+        bool _enabled)
+    {
+      uint32_t flag = this->Scene()->VisibilityLayer(_layer);
+      if (flag == 0u)
+        return;
+
+      uint32_t mask = this->VisibilityMask();
+      mask = _enabled ? (mask | flag) : (mask & ~flag);
+      if (mask != this->VisibilityMask())
+        this->SetVisibilityMask(mask);
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    bool BaseSensor<T>::VisibilityLayerEnabled(const std::string &_layer) const
+    {
+      // querying a layer does not create it
+      uint32_t flag = this->Scene()->VisibilityLayerFlag(_layer);
+      return flag != 0u && (this->VisibilityMask() & flag) != 0u;
+    }
     }
   }
 }
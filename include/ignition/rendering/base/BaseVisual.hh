@@ -25,6 +25,7 @@
 #include "ignition/rendering/Visual.hh"
 #include "ignition/rendering/Storage.hh"
 #include "ignition/rendering/RenderEngine.hh"
+#include "ignition/rendering/Scene.hh"
 #include "ignition/rendering/base/BaseStorage.hh"
 
 namespace ignition
@@ -82,6 +83,9 @@ namespace ignition
       // Documentation inherited.
       public: virtual void SetVisible(bool _visible) override;
 
+      // Documentation inherited.
+      public: virtual bool Visible() const override;
+
       // Documentation inherited.
       public: virtual void SetVisibilityFlags(uint32_t _flags) override;
 
@@ -94,6 +98,10 @@ namespace ignition
       // Documentation inherited.
       public: virtual void RemoveVisibilityFlags(uint32_t _flags) override;
 
+      // Documentation inherited.
+      public: virtual void SetVisibilityLayer(const std::string &_layer)
+                  override;
+
       // Documentation inherited.
       public: virtual void PreRender() override;
 
@@ -134,6 +142,9 @@ namespace ignition
       /// \brief Visual's visibility flags
       protected: uint32_t visibilityFlags = IGN_VISIBILITY_ALL;
 
+      /// \brief Whether the visual was made visible or hidden
+      protected: bool visible = true;
+
       /// \brief The bounding box of the visual
       protected: ignition::math::AxisAlignedBox boundingBox;
     };
@@ -176,6 +187,7 @@ namespace ignition
       }
 
       this->SetRawLocalPose(rawPose);
+      this->MarkSceneBoundsDirty();
     }
 
     //////////////////////////////////////////////////
@@ -206,6 +218,7 @@ namespace ignition
       if (this->AttachGeometry(_geometry))
       {
         this->Geometries()->Add(_geometry);
+        this->MarkSceneBoundsDirty();
       }
     }
 
@@ -216,6 +229,7 @@ namespace ignition
       if (this->DetachGeometry(_geometry))
       {
         this->Geometries()->Remove(_geometry);
+        this->MarkSceneBoundsDirty();
       }
       return _geometry;
     }
@@ -249,6 +263,11 @@ namespace ignition
     template <class T>
     void BaseVisual<T>::SetMaterial(MaterialPtr _material, bool _unique)
     {
+      // stop sharing a material set by batch material updates
+      ScenePtr scene = this->Scene();
+      if (scene)
+        scene->ReleaseVisualMaterial(this->Id());
+
       _material = (_unique) ? _material->Clone() : _material;
       this->SetChildMaterial(_material, false);
       this->SetGeometryMaterial(_material, false);
@@ -312,6 +331,10 @@ namespace ignition
     template <class T>
     void BaseVisual<T>::Destroy()
     {
+      ScenePtr scene = this->Scene();
+      if (scene)
+        scene->ReleaseVisualMaterial(this->Id());
+
       this->Geometries()->DestroyAll();
       this->Children()->RemoveAll();
       this->material.reset();
@@ -358,6 +381,13 @@ namespace ignition
              << std::endl;
     }
 
+    //////////////////////////////////////////////////
+    template <class T>
+    bool BaseVisual<T>::Visible() const
+    {
+      return this->visible;
+    }
+
     //////////////////////////////////////////////////
     template <class T>
     ignition::math::AxisAlignedBox BaseVisual<T>::LocalBoundingBox() const
@@ -426,11 +456,24 @@ namespace ignition
       this->SetVisibilityFlags(this->VisibilityFlags() & ~(_flags));
     }
 
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseVisual<T>::SetVisibilityLayer(const std::string &_layer)
+    {
+      uint32_t flag = this->Scene()->VisibilityLayer(_layer);
+      if (flag == 0u)
+        return;
+
+      this->SetVisibilityFlags((this->VisibilityFlags() &
+          ~static_cast<uint32_t>(IGN_VISIBILITY_LAYERS)) | flag);
+    }
+
     //////////////////////////////////////////////////
     template <class T>
     void BaseVisual<T>::SetVisibilityFlags(uint32_t _flags)
     {
       this->visibilityFlags = _flags;
+      this->MarkSceneBoundsDirty();
 
       // recursively set child visuals' visibility flags
       auto childNodes =
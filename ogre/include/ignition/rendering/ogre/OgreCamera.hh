@@ -59,9 +59,12 @@ namespace ignition
 
       public: virtual void SetNearClipPlane(const double _near) override;
 
-      public: virtual math::Color BackgroundColor() const;
+      // Documentation inherited.
+      public: virtual math::Color BackgroundColor() const override;
 
-      public: virtual void SetBackgroundColor(const math::Color &_color);
+      // Documentation inherited.
+      public: virtual void SetBackgroundColor(const math::Color &_color)
+                  override;
 
       public: virtual void Render() override;
 
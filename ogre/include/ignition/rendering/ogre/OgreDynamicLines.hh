@@ -76,6 +76,13 @@ namespace ignition
       public: void SetColor(unsigned int _index,
                             const ignition::math::Color &_color);
 
+      /// \brief Change the texture coordinates of an existing point in the
+      /// point list
+      /// \param[in] _index Index of the point to set
+      /// \param[in] _texCoord Texture coordinates of the point
+      public: void SetTexCoord(unsigned int _index,
+                  const ignition::math::Vector2d &_texCoord);
+
       /// \brief Return the location of an existing point in the point list
       /// \param[in] _index Number of the point to return
       /// \return ignition::math::Vector3d value of the point. A vector of
@@ -24,6 +24,8 @@
 #include <sstream>
 
 #include <ignition/common/SuppressWarning.hh>
+#include <ignition/math/Vector2.hh>
+#include <ignition/math/Vector3.hh>
 
 #include "ignition/rendering/RenderTypes.hh"
 #include "ignition/rendering/base/BaseGpuRays.hh"
@@ -55,7 +57,7 @@ namespace ignition
     **/
     /// \brief Gpu Rays used to render depth data into an image buffer
     class IGNITION_RENDERING_OGRE_VISIBLE OgreGpuRays :
-      public BaseGpuRays<OgreSensor>, public Ogre::RenderObjectListener
+      public BaseGpuRays<OgreSensor>
     {
       /// \brief Constructor
       protected: OgreGpuRays();
@@ -93,12 +95,6 @@ namespace ignition
       // Documentation inherited.
       public: virtual RenderTargetPtr RenderTarget() const override;
 
-      /// \internal
-      /// \brief Implementation of Ogre::RenderObjectListener
-      public: virtual void notifyRenderSingleObject(Ogre::Renderable *_rend,
-              const Ogre::Pass *_p, const Ogre::AutoParamDataSource *_s,
-              const Ogre::LightList *_ll, bool _supp) override;
-
       /// \brief Set the number of samples in the width and height for the
       /// first pass texture.
       /// \param[in] _w Number of samples in the horizontal sweep
@@ -119,9 +115,19 @@ namespace ignition
       /// \brief Configure cameras.
       private: void ConfigureCameras();
 
-      /// \brief Create a mesh.
+      /// \brief Create the mesh of the second pass canvas. It has a point
+      /// for each ray, with the index of the cubemap face to sample the
+      /// range from and the texture coordinates on that face.
       private: void CreateMesh();
 
+      /// \brief Helper function to convert a direction vector to the
+      /// index number of a cubemap face and texture uv coordinates on that face
+      /// \param[in] _v Direction vector
+      /// \param[out] _faceIndex Index of face to sample
+      /// \return Texture UV coordinates on the face indicated by _faceIndex
+      private: math::Vector2d SampleCubemap(const math::Vector3d &_v,
+          unsigned int &_faceIndex);
+
       /// \brief Create a canvas.
       private: void CreateCanvas();
 
@@ -65,6 +65,10 @@ namespace ignition
       public: virtual void SetPoint(unsigned int _index,
                            const ignition::math::Vector3d &_value) override;
 
+      // Documentation inherited
+      public: virtual void SetPointTexCoord(unsigned int _index,
+                  const ignition::math::Vector2d &_texCoord) override;
+
       // Documentation inherited
       public: virtual void AddPoint(const ignition::math::Vector3d &_pt,
                            const ignition::math::Color &_color) override;
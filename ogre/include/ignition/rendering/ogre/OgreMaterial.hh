@@ -17,7 +17,9 @@
 #ifndef IGNITION_RENDERING_OGRE_OGREMATERIAL_HH_
 #define IGNITION_RENDERING_OGRE_OGREMATERIAL_HH_
 
+#include <memory>
 #include <string>
+#include <vector>
 
 #include <ignition/common/SuppressWarning.hh>
 
@@ -115,6 +117,9 @@ namespace ignition
 
       public: virtual void SetTexture(const std::string &_name) override;
 
+      public: virtual void SetTexture(const std::string &_name,
+                  const std::shared_ptr<const common::Image> &_img) override;
+
       public: virtual void ClearTexture() override;
 
       public: virtual bool HasNormalMap() const override;
@@ -174,6 +179,10 @@ namespace ignition
 
       protected: virtual Ogre::TexturePtr Texture(const std::string &_name);
 
+      /// \brief Unload and remove the texture this material created from
+      /// an image in memory, if any
+      protected: void DestroyMemoryTexture();
+
       protected: virtual Ogre::TexturePtr CreateTexture(
                      const std::string &_name);
 
@@ -184,11 +193,16 @@ namespace ignition
       /// \brief bind shader parameters that have changed
       protected: void UpdateShaderParams();
 
-      /// \brief Transfer params from ign-rendering type to ogre type
+      /// \brief Transfer params that have changed from ign-rendering type
+      /// to ogre type
       /// \param[in] _params ignition rendering params
       /// \param[out] _ogreParams ogre type for holding params
+      /// \param[in,out] _handles Shader constants of the params, by param
+      /// index. Constants are looked up by name the first time a param is
+      /// transferred.
       protected: void UpdateShaderParams(ConstShaderParamsPtr _params,
-        Ogre::GpuProgramParametersSharedPtr _ogreParams);
+        Ogre::GpuProgramParametersSharedPtr _ogreParams,
+        std::vector<const Ogre::GpuConstantDefinition *> &_handles);
 
       protected: virtual void Init() override;
 
@@ -208,6 +222,10 @@ namespace ignition
 #endif
       protected: std::string textureName;
 
+      /// \brief Name of the texture this material created from an image in
+      /// memory, empty if there is none. It is removed with the material.
+      protected: std::string memoryTextureName;
+
       protected: std::string normalMapName;
 
       protected: enum ShaderType shaderType = ST_PIXEL;
@@ -223,6 +241,14 @@ namespace ignition
 
       /// \brief Parameters to be bound to the fragment shader
       protected: ShaderParamsPtr fragmentShaderParams;
+
+      /// \brief Vertex shader constants of the vertex shader params
+      protected: std::vector<const Ogre::GpuConstantDefinition *>
+          vertexShaderHandles;
+
+      /// \brief Fragment shader constants of the fragment shader params
+      protected: std::vector<const Ogre::GpuConstantDefinition *>
+          fragmentShaderHandles;
       IGN_COMMON_WARN_RESUME__DLL_INTERFACE_MISSING
 
       private: friend class OgreScene;
@@ -85,6 +85,19 @@ namespace ignition
                 RENDER_PATH_COUNT
               };
 
+      /// \enum OgreSceneManagerType
+      /// \brief The type of ogre scene manager created by new scenes.
+      public: enum OgreSceneManagerType
+              {
+                /// \brief Flat list of scene nodes. Every node is tested
+                /// against the frustum of each camera.
+                SM_GENERIC = 0,
+                /// \brief Octree of scene node bounds, so that cameras only
+                /// test the nodes of the octants they see. Nodes are moved
+                /// to other octants when their bounds change.
+                SM_OCTREE = 1
+              };
+
       /// \brief Constructor
       private: OgreRenderEngine();
 
@@ -98,6 +111,18 @@ namespace ignition
 
       public: OgreRenderPathType RenderPathType() const;
 
+      /// \brief Get the type of ogre scene manager created by new scenes
+      /// \return Scene manager type
+      /// \sa SetSceneManagerType
+      public: OgreSceneManagerType SceneManagerType() const;
+
+      /// \brief Set the type of ogre scene manager created by new scenes.
+      /// Existing scenes keep their scene manager. If the octree scene
+      /// manager plugin is not available, scenes use the generic scene
+      /// manager. The default is SM_OCTREE.
+      /// \param[in] _type Scene manager type
+      public: void SetSceneManagerType(OgreSceneManagerType _type);
+
       public: void AddResourcePath(const std::string &_uri) override;
 
       public: virtual Ogre::Root *OgreRoot() const;
@@ -120,6 +145,8 @@ namespace ignition
       /// Current accepts the following parameters and values:
       /// "useCurrentGLContext" : "1" or "0". Use current OpenGL context for
       ///                                     rendering
+      /// "sceneManager" : "octree" or "generic". Type of ogre scene manager
+      ///                  created by scenes, see SetSceneManagerType
       protected: virtual bool LoadImpl(
           const std::map<std::string, std::string> &_params) override;
 
@@ -160,6 +187,9 @@ namespace ignition
 
       private: OgreRenderPathType renderPathType;
 
+      /// \brief Type of ogre scene manager created by new scenes
+      private: OgreSceneManagerType sceneManagerType = SM_OCTREE;
+
       private: Ogre::Root *ogreRoot = nullptr;
 
       private: Ogre::LogManager *ogreLogManager = nullptr;
@@ -91,6 +91,11 @@ namespace ignition
       /// \param[in] _mask Visibility mask
       public: virtual void SetVisibilityMask(uint32_t _mask);
 
+      /// \brief Get the resolution scale. Ogre render targets always
+      /// render at full resolution.
+      /// \return Always 1
+      public: virtual double ResolutionScale() const override;
+
       protected: virtual void UpdateBackgroundColor();
 
       /// \brief Update render pass chain if changes were made
@@ -26,7 +26,7 @@
 using namespace ignition;
 using namespace rendering;
 
-enum {POSITION_BINDING, TEXCOORD_BINDING};
+enum {POSITION_BINDING, COLOR_BINDING, TEXCOORD_BINDING};
 
 
 /// \brief Private implementation
@@ -38,6 +38,9 @@ class ignition::rendering::OgreDynamicLinesPrivate
   /// \brief List of points for the line
   public: std::vector<ignition::math::Vector3d> points;
 
+  /// \brief Texture coordinates of each point
+  public: std::vector<ignition::math::Vector2d> texCoords;
+
   /// \brief Used to indicate if the lines require an update
   public: bool dirty = false;
 };
@@ -62,6 +65,7 @@ void OgreDynamicLines::AddPoint(const ignition::math::Vector3d &_pt,
 {
   this->dataPtr->points.push_back(_pt);
   this->dataPtr->colors.push_back(_color);
+  this->dataPtr->texCoords.push_back(ignition::math::Vector2d::Zero);
   this->dataPtr->dirty = true;
 }
 
@@ -96,6 +100,21 @@ void OgreDynamicLines::SetColor(unsigned int _index,
   this->dataPtr->dirty = true;
 }
 
+/////////////////////////////////////////////////
+void OgreDynamicLines::SetTexCoord(unsigned int _index,
+                            const ignition::math::Vector2d &_texCoord)
+{
+  if (_index >= this->dataPtr->texCoords.size())
+  {
+    ignerr << "Point index[" << _index << "] is out of bounds[0-"
+           << this->dataPtr->texCoords.size()-1 << "]\n";
+    return;
+  }
+
+  this->dataPtr->texCoords[_index] = _texCoord;
+  this->dataPtr->dirty = true;
+}
+
 /////////////////////////////////////////////////
 ignition::math::Vector3d OgreDynamicLines::Point(
     const unsigned int _index) const
@@ -123,14 +142,21 @@ unsigned int OgreDynamicLines::PointCount() const
 void OgreDynamicLines::Clear()
 {
   this->dataPtr->points.clear();
+  this->dataPtr->colors.clear();
+  this->dataPtr->texCoords.clear();
   this->dataPtr->dirty = true;
 }
 
 /////////////////////////////////////////////////
 void OgreDynamicLines::Update()
 {
-  if (this->dataPtr->dirty && this->dataPtr->points.size() > 1)
+  // the buffers are also updated once all the points are cleared, so that
+  // the old geometry is not drawn anymore
+  if (this->dataPtr->dirty && (this->dataPtr->points.empty() ||
+      this->dataPtr->points.size() > 1))
+  {
     this->FillHardwareBuffers();
+  }
 }
 
 /////////////////////////////////////////////////
@@ -140,7 +166,9 @@ void OgreDynamicLines::CreateVertexDeclaration()
     this->mRenderOp.vertexData->vertexDeclaration;
 
   decl->addElement(POSITION_BINDING, 0, Ogre::VET_FLOAT3, Ogre::VES_POSITION);
-  decl->addElement(1, 0, Ogre::VET_COLOUR, Ogre::VES_DIFFUSE);
+  decl->addElement(COLOR_BINDING, 0, Ogre::VET_COLOUR, Ogre::VES_DIFFUSE);
+  decl->addElement(TEXCOORD_BINDING, 0, Ogre::VET_FLOAT2,
+      Ogre::VES_TEXTURE_COORDINATES);
 }
 
 /////////////////////////////////////////////////
@@ -189,6 +217,20 @@ void OgreDynamicLines::FillHardwareBuffers()
   }
   cbuf->unlock();
 
+  // Update the texture coordinates
+  Ogre::HardwareVertexBufferSharedPtr tbuf =
+    this->mRenderOp.vertexData->vertexBufferBinding->getBuffer(
+    TEXCOORD_BINDING);
+
+  Ogre::Real *prTexCoord =
+    static_cast<Ogre::Real*>(tbuf->lock(Ogre::HardwareBuffer::HBL_DISCARD));
+  for (int i = 0; i < size; ++i)
+  {
+    *prTexCoord++ = this->dataPtr->texCoords[i].X();
+    *prTexCoord++ = this->dataPtr->texCoords[i].Y();
+  }
+  tbuf->unlock();
+
   // need to update after mBox change, otherwise the lines goes in and out
   // of scope based on old mBox
   this->getParentSceneNode()->needUpdate();
@@ -186,6 +186,20 @@ void OgreDynamicRenderable::PrepareHardwareBuffers(size_t vertexCount,
     this->mRenderOp.vertexData->vertexBufferBinding->setBinding(0, vbuf);
 
     this->mRenderOp.vertexData->vertexBufferBinding->setBinding(1, cbuf);
+
+    // bind a buffer to each other source of the vertex declaration
+    Ogre::VertexDeclaration *decl =
+        this->mRenderOp.vertexData->vertexDeclaration;
+    for (unsigned short source = 2; source <= decl->getMaxSource(); ++source)
+    {
+      Ogre::HardwareVertexBufferSharedPtr buf =
+        Ogre::HardwareBufferManager::getSingleton().createVertexBuffer(
+          decl->getVertexSize(source),
+          this->vertexBufferCapacity,
+          Ogre::HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY);
+      this->mRenderOp.vertexData->vertexBufferBinding->setBinding(
+          source, buf);
+    }
   }
 
   // Update vertex count in the render operation
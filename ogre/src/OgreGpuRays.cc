@@ -15,17 +15,88 @@
  *
 */
 
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <set>
+
 #include <ignition/common/Mesh.hh>
 #include <ignition/common/MeshManager.hh>
 #include <ignition/common/SubMesh.hh>
 
 #include <ignition/math/Color.hh>
 #include <ignition/math/Helpers.hh>
+#include <ignition/math/Quaternion.hh>
 #include <ignition/math/Vector3.hh>
 
 #include "ignition/rendering/RenderTypes.hh"
 #include "ignition/rendering/ogre/OgreCamera.hh"
 #include "ignition/rendering/ogre/OgreGpuRays.hh"
+#include "ignition/rendering/ogre/OgreVisual.hh"
+
+namespace ignition
+{
+namespace rendering
+{
+inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+//
+/// \brief Helper class for rendering objects with the first pass material
+/// of the gpu rays, with their laser retro value as a custom parameter.
+/// Objects are rendered through the regular ogre render queue, so the
+/// range limits are set once per pass and only the per object auto
+/// parameters are updated for each object.
+class OgreGpuRaysMaterialSwitcher : public Ogre::RenderTargetListener,
+      public Ogre::MaterialManager::Listener
+{
+  /// \brief constructor
+  /// \param[in] _scene the scene manager responsible for rendering
+  /// \param[in] _material First pass material
+  public: OgreGpuRaysMaterialSwitcher(OgreScenePtr _scene,
+      Ogre::Material *_material);
+
+  /// \brief destructor
+  public: ~OgreGpuRaysMaterialSwitcher() = default;
+
+  /// \brief Callback when a render target is about to be rendered
+  /// \param[in] _evt Ogre render target event containing information about
+  /// the source render target.
+  private: virtual void preRenderTargetUpdate(
+      const Ogre::RenderTargetEvent &_evt) override;
+
+  /// \brief Callback when a render target is finisned being rendered
+  /// \param[in] _evt Ogre render target event containing information about
+  /// the source render target.
+  private: virtual void postRenderTargetUpdate(
+      const Ogre::RenderTargetEvent &_evt) override;
+
+  // Documentation inherited.
+  private: Ogre::Technique *handleSchemeNotFound(
+    uint16_t _schemeIndex, const Ogre::String &_schemeName,
+    Ogre::Material *_originalMaterial, uint16_t _lodIndex,
+    const Ogre::Renderable *_rend) override;
+
+  /// \brief Get the laser retro value of the visual of a renderable
+  /// \param[in] _rend Renderable to get the laser retro value of
+  /// \return Laser retro value, 0 if not set
+  private: float LaserRetro(const Ogre::Renderable *_rend) const;
+
+  /// \brief Scene manager
+  private: OgreScenePtr scene;
+
+  /// \brief First pass material
+  private: Ogre::Material *material = nullptr;
+
+  /// \brief Material scheme name
+  public: static const char kSchemeName[];
+
+  /// \brief Custom parameter index of laser retro value in an ogre
+  /// renderable. This has to match the custom index specifed in
+  /// GpuRaysScan1stFS program in media/materials/scripts/gpu_rays.material
+  private: const unsigned int customParamIdx = 2u;
+};
+}
+}
+}
 
 /// \internal
 /// \brief Private data for the OgreGpuRays class
@@ -53,18 +124,22 @@ class ignition::rendering::OgreGpuRaysPrivate
   /// \brief Pointer to Ogre material for the second rendering pass.
   public: Ogre::Material *matSecondPass = nullptr;
 
-  /// \brief Temporary pointer to the current material.
-  public: Ogre::Material *currentMat = nullptr;
+  /// \brief Material switcher for the first rendering pass
+  public: std::unique_ptr<OgreGpuRaysMaterialSwitcher> materialSwitcher;
 
-  /// \brief An array of first pass textures.
-  public: Ogre::Texture *firstPassTextures[3];
+  /// \brief First pass textures, one for each cubemap face
+  public: Ogre::Texture *firstPassTextures[6] = {nullptr};
+
+  /// \brief Cameras used to render the cubemap faces in the first pass
+  public: Ogre::Camera *cubeCam[6] = {nullptr};
+
+  /// \brief Indices of the cubemap faces that are needed to sample the
+  /// rays. Only these faces are rendered.
+  public: std::set<unsigned int> cubeFaceIdx;
 
   /// \brief Second pass texture.
   public: Ogre::Texture *secondPassTexture = nullptr;
 
-  /// \brief Temporary pointer to the current render target.
-  public: Ogre::Texture *currentTexture = nullptr;
-
   /// \brief Ogre orthorgraphic camera used in the second pass for
   /// undistortion.
   public: Ogre::Camera *orthoCam = nullptr;
@@ -82,12 +157,6 @@ class ignition::rendering::OgreGpuRaysPrivate
   /// \brief Pointer to visual that holds the canvas.
   public: VisualPtr visual;
 
-  /// \brief Number of first pass textures.
-  public: unsigned int textureCount = 0u;
-
-  /// \brief A list of camera angles for first pass rendering.
-  public: double cameraYaws[4];
-
   /// \brief Image width of first pass.
   public: unsigned int w1st = 0u;
 
@@ -100,12 +169,9 @@ class ignition::rendering::OgreGpuRaysPrivate
   /// \brief Image height of second pass.
   public: unsigned int h2nd = 0u;
 
-  /// \brief List of texture unit indices used during the second
-  /// rendering pass.
-  public: std::vector<int> texIdx;
-
-  /// Number of second pass texture units created.
-  public: unsigned int texCount = 0;
+  /// \brief Texture unit index of each cubemap face used during the
+  /// second rendering pass.
+  public: std::map<unsigned int, unsigned int> texIdx;
 
   /// \brief Dummy render texture for the gpu rays
   public: RenderTexturePtr renderTexture;
@@ -121,14 +187,125 @@ class ignition::rendering::OgreGpuRaysPrivate
 
   /// \brief Vertical half angle.
   public: double vertHalfAngle = 0;
-
-  /// \brief Number of cameras needed to generate the rays.
-  public: unsigned int cameraCount = 1;
 };
 
 using namespace ignition;
 using namespace rendering;
 
+/// \brief Minimum width and height of the first pass cubemap face textures
+static const unsigned int kMinFaceSize = 1024u;
+
+/// \brief Maximum width and height of the first pass cubemap face textures
+static const unsigned int kMaxFaceSize = 4096u;
+
+const char OgreGpuRaysMaterialSwitcher::kSchemeName[] = "gpu_rays";
+
+//////////////////////////////////////////////////
+OgreGpuRaysMaterialSwitcher::OgreGpuRaysMaterialSwitcher(
+    OgreScenePtr _scene, Ogre::Material *_material)
+  : scene(_scene), material(_material)
+{
+}
+
+//////////////////////////////////////////////////
+void OgreGpuRaysMaterialSwitcher::preRenderTargetUpdate(
+    const Ogre::RenderTargetEvent & /*_evt*/)
+{
+  Ogre::MaterialManager::getSingleton().addListener(this);
+}
+
+//////////////////////////////////////////////////
+void OgreGpuRaysMaterialSwitcher::postRenderTargetUpdate(
+    const Ogre::RenderTargetEvent & /*_evt*/)
+{
+  Ogre::MaterialManager::getSingleton().removeListener(this);
+}
+
+//////////////////////////////////////////////////
+/// \brief Ogre callback that assigns material to new renderables
+Ogre::Technique *OgreGpuRaysMaterialSwitcher::handleSchemeNotFound(
+    uint16_t /*_schemeIndex*/, const Ogre::String &_schemeName,
+    Ogre::Material * /*_originalMaterial*/, uint16_t /*_lodIndex*/,
+    const Ogre::Renderable *_rend)
+{
+  if (_schemeName != kSchemeName || !_rend)
+    return nullptr;
+
+  // the laser retro value is looked up the first time an object is
+  // rendered, afterwards this is called for each object and frame
+  if (!_rend->hasCustomParameter(this->customParamIdx))
+  {
+    const_cast<Ogre::Renderable *>(_rend)->setCustomParameter(
+        this->customParamIdx,
+        Ogre::Vector4(this->LaserRetro(_rend), 0.0, 0.0, 0.0));
+  }
+
+  return this->material->getSupportedTechnique(0);
+}
+
+//////////////////////////////////////////////////
+float OgreGpuRaysMaterialSwitcher::LaserRetro(
+    const Ogre::Renderable *_rend) const
+{
+  if (typeid(*_rend) != typeid(Ogre::SubEntity))
+    return 0.0f;
+
+  const Ogre::SubEntity *subEntity =
+    static_cast<const Ogre::SubEntity *>(_rend);
+
+  OgreVisualPtr ogreVisual;
+  Ogre::Any userAny =
+      subEntity->getParent()->getUserObjectBindings().getUserAny();
+  if (!userAny.isEmpty() && userAny.getType() == typeid(unsigned int))
+  {
+    VisualPtr result;
+    try
+    {
+      result = this->scene->VisualById(Ogre::any_cast<unsigned int>(userAny));
+    }
+    catch(Ogre::Exception &e)
+    {
+      ignerr << "Ogre Error:" << e.getFullDescription() << "\n";
+    }
+    ogreVisual = std::dynamic_pointer_cast<OgreVisual>(result);
+  }
+
+  if (!ogreVisual)
+    return 0.0f;
+
+  Variant retroAny = ogreVisual->UserData("laser_retro");
+  if (retroAny.index() == 0)
+    return 0.0f;
+
+  float retro = 0.0f;
+  try
+  {
+    retro = std::get<float>(retroAny);
+  }
+  catch(...)
+  {
+    try
+    {
+      retro = static_cast<float>(std::get<double>(retroAny));
+    }
+    catch(...)
+    {
+      try
+      {
+        retro = static_cast<float>(std::get<int>(retroAny));
+      }
+      catch(std::bad_variant_access &e)
+      {
+        ignerr << "Error casting user data: " << e.what() << "\n";
+        retro = 0.0f;
+      }
+    }
+  }
+
+  // limit laser retro value to 2000 (as in gazebo)
+  return std::max(0.0f, std::min(retro, 2000.0f));
+}
+
 //////////////////////////////////////////////////
 OgreGpuRays::OgreGpuRays()
   : dataPtr(new OgreGpuRaysPrivate)
@@ -170,14 +347,25 @@ void OgreGpuRays::Destroy()
     this->dataPtr->gpuRaysScan = nullptr;
   }
 
-  for (unsigned int i = 0; i < this->dataPtr->textureCount; ++i)
+  for (unsigned int i = 0; i < 6u; ++i)
   {
     if (this->dataPtr->firstPassTextures[i])
     {
+      if (this->dataPtr->materialSwitcher)
+      {
+        this->dataPtr->firstPassTextures[i]->getBuffer()->getRenderTarget()
+            ->removeListener(this->dataPtr->materialSwitcher.get());
+      }
       Ogre::TextureManager::getSingleton().remove(
           this->dataPtr->firstPassTextures[i]->getName());
       this->dataPtr->firstPassTextures[i] = nullptr;
     }
+    if (this->scene && this->dataPtr->cubeCam[i])
+    {
+      this->scene->OgreSceneManager()->destroyCamera(
+          this->dataPtr->cubeCam[i]);
+      this->dataPtr->cubeCam[i] = nullptr;
+    }
   }
 
   if (this->dataPtr->secondPassTexture)
@@ -200,9 +388,10 @@ void OgreGpuRays::Destroy()
     this->dataPtr->orthoCam = nullptr;
   }
 
+  this->dataPtr->materialSwitcher.reset();
   this->dataPtr->visual.reset();
   this->dataPtr->texIdx.clear();
-  this->dataPtr->texCount = 0u;
+  this->dataPtr->cubeFaceIdx.clear();
 }
 
 /////////////////////////////////////////////////
@@ -250,39 +439,11 @@ void OgreGpuRays::ConfigureCameras()
   if (this->HFOV().Radian() > 2.0 * IGN_PI)
   {
     this->SetHFOV(2.0 * IGN_PI);
-    ignwarn << "Horizontal FOV for GPU rays is capped at 180 degrees.\n";
+    ignwarn << "Horizontal FOV for GPU rays is capped at 360 degrees.\n";
   }
 
   this->SetHorzHalfAngle((this->AngleMax() + this->AngleMin()).Radian() / 2.0);
 
-  // determine number of cameras to use
-  if (this->HFOV().Radian() > 2.8)
-  {
-    if (this->HFOV().Radian()  > 5.6)
-    {
-      this->dataPtr->cameraCount = 3;
-    }
-    else
-    {
-      this->dataPtr->cameraCount = 2;
-    }
-  }
-  else
-  {
-    this->dataPtr->cameraCount = 1;
-  }
-
-  // horizontal fov of single frame
-  this->SetHFOV(this->HFOV().Radian() / this->dataPtr->cameraCount);
-  this->SetCosHorzFOV(this->HFOV().Radian());
-
-  // Fixed minimum resolution of texture to reduce steps in ranges
-  // when hitting surfaces where the angle between ray and surface is small.
-  // Also have to keep in mind the GPU's max. texture size
-  unsigned int horzRangeCountPerCamera =
-      std::max(2048U, this->RangeCount() / this->dataPtr->cameraCount);
-  unsigned int vertRangeCountPerCamera = this->VerticalRangeCount();
-
   // vertical laser setup
   double vfovAngle;
 
@@ -302,78 +463,73 @@ void OgreGpuRays::ConfigureCameras()
     }
   }
 
-  if (vfovAngle > IGN_PI / 2.0)
-  {
-    vfovAngle = IGN_PI / 2.0;
-    ignwarn << "Vertical FOV for GPU laser is capped at 90 degrees.\n";
-  }
-
   this->SetVFOV(vfovAngle);
   this->SetVertHalfAngle((this->VerticalAngleMax()
                    + this->VerticalAngleMin()).Radian() / 2.0);
 
-  this->SetVerticalAngleMin(this->VertHalfAngle() - (vfovAngle / 2));
-  this->SetVerticalAngleMax(this->VertHalfAngle() + (vfovAngle / 2));
-
-  // Assume camera always stays horizontally even if vert. half angle of
-  // laser is not 0. Add padding to camera vfov.
-  double vfovCamera = vfovAngle + 2.0 * std::abs(this->VertHalfAngle());
-
-  // Add padding to vertical camera FOV to cover all possible rays
-  // for given laser vert. and horiz. FOV
-  vfovCamera = 2.0 * atan(tan(vfovCamera / 2.0) / cos(
-        this->HFOV().Radian() / 2.0));
-
-  if (vfovCamera > 2.8)
-  {
-    ignerr << "Vertical FOV of internal camera exceeds 2.8 radians.\n";
-  }
-
-  this->SetCosVertFOV(vfovCamera);
+  // The rays are sampled from the faces of a cubemap, which are rendered
+  // by square cameras with a 90 degrees field of view. This supports any
+  // horizontal and vertical field of view.
+  this->SetCosHorzFOV(IGN_PI / 2.0);
+  this->SetCosVertFOV(IGN_PI / 2.0);
+  this->SetRayCountRatio(1.0);
+  this->rangeCountRatio = 1.0;
 
-  // If vertical ray is not 1 adjust horizontal and vertical
-  // ray count to maintain aspect ratio
-  if (this->vSamples > 1)
+  // Fixed minimum resolution of the faces to reduce steps in ranges
+  // when hitting surfaces where the angle between ray and surface is small.
+  // Denser rays get at least one texel per ray, while keeping in mind the
+  // GPU's max. texture size
+  double rayDensity = 0.0;
+  if (this->RangeCount() > 1 && this->HFOV().Radian() > 0.0)
   {
-    double cameraAspectRatio =
-      tan(this->HFOV().Radian() / 2.0) / tan(vfovCamera / 2.0);
-
-    this->SetRayCountRatio(cameraAspectRatio);
-    this->rangeCountRatio = cameraAspectRatio;
-
-    if ((horzRangeCountPerCamera / this->rangeCountRatio) >
-         vertRangeCountPerCamera)
-    {
-      vertRangeCountPerCamera = static_cast<unsigned int>(
-          std::round(horzRangeCountPerCamera / this->rangeCountRatio));
-    }
-    else
-    {
-      horzRangeCountPerCamera = static_cast<unsigned int>(std::round(
-          vertRangeCountPerCamera * this->rangeCountRatio));
-    }
+    rayDensity = (this->RangeCount() - 1) / this->HFOV().Radian();
   }
-  else
+  if (this->VerticalRangeCount() > 1 && vfovAngle > 0.0)
   {
-    // In case of 1 vert. ray, set a very small vertical FOV for camera
-    this->SetRayCountRatio(horzRangeCountPerCamera);
-    double camVFOV = 2.0 * atan(tan(
-          this->HFOV().Radian() / 2.0) / this->RayCountRatio());
-    this->SetCosVertFOV(camVFOV);
+    rayDensity = std::max(rayDensity,
+        (this->VerticalRangeCount() - 1) / vfovAngle);
   }
+  unsigned int faceSize = static_cast<unsigned int>(
+      std::ceil(rayDensity * IGN_PI / 2.0));
+  faceSize = std::max(kMinFaceSize, std::min(faceSize, kMaxFaceSize));
 
   // Configure first pass texture size
-  this->Set1stTextureSize(horzRangeCountPerCamera, vertRangeCountPerCamera);
+  this->Set1stTextureSize(faceSize, faceSize);
   // Configure second pass texture size
   this->SetRangeCount(this->RangeCount(), this->VerticalRangeCount());
 
   // Set ogre cam properties
-  this->dataPtr->ogreCamera->setAspectRatio(this->RayCountRatio());
-  this->dataPtr->ogreCamera->setFOVy(Ogre::Radian((this->CosVertFOV())));
   this->dataPtr->ogreCamera->setNearClipDistance(this->NearClipPlane());
   this->dataPtr->ogreCamera->setFarClipDistance(this->FarClipPlane());
   this->dataPtr->ogreCamera->setRenderingDistance(this->FarClipPlane());
-  this->dataPtr->ogreCamera->yaw(Ogre::Radian(this->HorzHalfAngle()));
+}
+
+/////////////////////////////////////////////////////////
+math::Vector2d OgreGpuRays::SampleCubemap(const math::Vector3d &_v,
+    unsigned int &_faceIndex)
+{
+  math::Vector3d vAbs = _v.Abs();
+  double ma;
+  math::Vector2d uv;
+  if (vAbs.Z() >= vAbs.X() && vAbs.Z() >= vAbs.Y())
+  {
+    _faceIndex = _v.Z() < 0.0 ? 5u : 4u;
+    ma = 0.5 / vAbs.Z();
+    uv = math::Vector2d(_v.Z() < 0.0 ? -_v.X() : _v.X(), -_v.Y());
+  }
+  else if (vAbs.Y() >= vAbs.X())
+  {
+    _faceIndex = _v.Y() < 0.0 ? 3u : 2u;
+    ma = 0.5 / vAbs.Y();
+    uv = math::Vector2d(_v.X(), _v.Y() < 0.0 ? -_v.Z() : _v.Z());
+  }
+  else
+  {
+    _faceIndex = _v.X() < 0.0 ? 1u : 0u;
+    ma = 0.5 / vAbs.X();
+    uv = math::Vector2d(_v.X() < 0.0 ? _v.Z() : -_v.Z(), -_v.Y());
+  }
+  return uv * ma + 0.5;
 }
 
 /////////////////////////////////////////////////////////
@@ -381,28 +537,48 @@ void OgreGpuRays::CreateGpuRaysTextures()
 {
   this->ConfigureCameras();
 
+  // the canvas mesh determines which cubemap faces are needed
+  this->CreateMesh();
+
   this->CreateOrthoCam();
 
-  this->dataPtr->textureCount = this->dataPtr->cameraCount;
+  this->dataPtr->matFirstPass = dynamic_cast<Ogre::Material *>(
+      Ogre::MaterialManager::getSingleton().getByName("GpuRaysScan1st").get());
+  this->dataPtr->matFirstPass->load();
+  this->dataPtr->matFirstPass->setCullingMode(Ogre::CULL_NONE);
+  this->dataPtr->materialSwitcher.reset(new OgreGpuRaysMaterialSwitcher(
+      this->scene, this->dataPtr->matFirstPass));
 
-  if (this->dataPtr->textureCount == 2)
-  {
-    this->dataPtr->cameraYaws[0] = -this->HFOV().Radian() / 2.0;
-    this->dataPtr->cameraYaws[1] = +this->HFOV().Radian();
-    this->dataPtr->cameraYaws[2] = 0;
-    this->dataPtr->cameraYaws[3] = -this->HFOV().Radian() / 2.0;
-  }
-  else
+  // Create the cubemap cameras and first pass textures of the faces that
+  // are sampled by the rays
+  Ogre::SceneManager *ogreSceneManager = this->scene->OgreSceneManager();
+  for (auto i : this->dataPtr->cubeFaceIdx)
   {
-    this->dataPtr->cameraYaws[0] = -this->HFOV().Radian();
-    this->dataPtr->cameraYaws[1] = +this->HFOV().Radian();
-    this->dataPtr->cameraYaws[2] = +this->HFOV().Radian();
-    this->dataPtr->cameraYaws[3] = -this->HFOV().Radian();
-  }
+    Ogre::Camera *cam = ogreSceneManager->createCamera(
+        this->Name() + "_env" + std::to_string(i));
+    this->ogreNode->attachObject(cam);
+    cam->setFOVy(Ogre::Degree(90));
+    cam->setAspectRatio(1);
+    cam->setNearClipDistance(this->NearClipPlane());
+    cam->setFarClipDistance(this->FarClipPlane());
+    cam->setRenderingDistance(this->FarClipPlane());
+    cam->setFixedYawAxis(false);
+    cam->yaw(Ogre::Degree(-90));
+    cam->roll(Ogre::Degree(-90));
+
+    // orient camera to create cubemap
+    if (i == 0)
+      cam->yaw(Ogre::Degree(-90));
+    else if (i == 1)
+      cam->yaw(Ogre::Degree(90));
+    else if (i == 2)
+      cam->pitch(Ogre::Degree(90));
+    else if (i == 3)
+      cam->pitch(Ogre::Degree(-90));
+    else if (i == 5)
+      cam->yaw(Ogre::Degree(180));
+    this->dataPtr->cubeCam[i] = cam;
 
-  // Configure first pass textures that are not yet configured properly
-  for (unsigned int i = 0; i < this->dataPtr->textureCount; ++i)
-  {
     std::stringstream texName;
     texName << this->Name() << "_first_pass_" << i;
     this->dataPtr->firstPassTextures[i] =
@@ -420,8 +596,7 @@ void OgreGpuRays::CreateGpuRaysTextures()
     rt->setAutoUpdated(false);
 
     // Setup the viewport to use the texture
-    Ogre::Viewport *vp =
-        rt->addViewport(this->dataPtr->ogreCamera);
+    Ogre::Viewport *vp = rt->addViewport(cam);
     vp->setClearEveryFrame(true);
     vp->setOverlaysEnabled(false);
     vp->setShadowsEnabled(false);
@@ -430,12 +605,11 @@ void OgreGpuRays::CreateGpuRaysTextures()
         Ogre::ColourValue(this->dataMaxVal, 0.0, 1.0));
     vp->setVisibilityMask(IGN_VISIBILITY_ALL &
         ~(IGN_VISIBILITY_GUI | IGN_VISIBILITY_SELECTABLE));
-  }
 
-  this->dataPtr->matFirstPass = dynamic_cast<Ogre::Material *>(
-      Ogre::MaterialManager::getSingleton().getByName("GpuRaysScan1st").get());
-  this->dataPtr->matFirstPass->load();
-  this->dataPtr->matFirstPass->setCullingMode(Ogre::CULL_NONE);
+    // render all objects with the first pass material
+    vp->setMaterialScheme(OgreGpuRaysMaterialSwitcher::kSchemeName);
+    rt->addListener(this->dataPtr->materialSwitcher.get());
+  }
 
   // Configure second pass texture
   this->dataPtr->secondPassTexture =
@@ -490,18 +664,16 @@ void OgreGpuRays::CreateGpuRaysTextures()
       "OgreGpuRays material script error: pass not found");
   pass->removeAllTextureUnitStates();
   Ogre::TextureUnitState *texUnit = nullptr;
-  for (unsigned int i = 0; i < this->dataPtr->textureCount; ++i)
+  for (auto i : this->dataPtr->cubeFaceIdx)
   {
-    unsigned int texIndex = this->dataPtr->texCount++;
-    {
-      texUnit = pass->createTextureUnitState(
-            this->dataPtr->firstPassTextures[i]->getName(), texIndex);
+    unsigned int texIndex = this->dataPtr->texIdx.size();
+    texUnit = pass->createTextureUnitState(
+          this->dataPtr->firstPassTextures[i]->getName(), texIndex);
 
-      this->dataPtr->texIdx.push_back(texIndex);
+    this->dataPtr->texIdx[i] = texIndex;
 
-      texUnit->setTextureFiltering(Ogre::TFO_NONE);
-      texUnit->setTextureAddressingMode(Ogre::TextureUnitState::TAM_MIRROR);
-    }
+    texUnit->setTextureFiltering(Ogre::TFO_NONE);
+    texUnit->setTextureAddressingMode(Ogre::TextureUnitState::TAM_CLAMP);
   }
 
   this->CreateCanvas();
@@ -543,15 +715,10 @@ void OgreGpuRays::UpdateRenderTarget(Ogre::RenderTarget *_target,
 
   if (_updateTex)
   {
-    pass->getFragmentProgramParameters()->setNamedConstant("tex1",
-      this->dataPtr->texIdx[0]);
-    if (this->dataPtr->texIdx.size() > 1)
+    for (const auto &it : this->dataPtr->texIdx)
     {
-      pass->getFragmentProgramParameters()->setNamedConstant("tex2",
-        this->dataPtr->texIdx[1]);
-      if (this->dataPtr->texIdx.size() > 2)
-        pass->getFragmentProgramParameters()->setNamedConstant("tex3",
-          this->dataPtr->texIdx[2]);
+      pass->getFragmentProgramParameters()->setNamedConstant(
+          "tex" + std::to_string(it.first), static_cast<int>(it.second));
     }
   }
 
@@ -582,31 +749,28 @@ void OgreGpuRays::Render()
 {
   Ogre::SceneManager *sceneMgr = this->scene->OgreSceneManager();
 
-  sceneMgr->_suppressRenderStateChanges(true);
-  sceneMgr->addRenderObjectListener(this);
-
-  for (unsigned int i = 0; i < this->dataPtr->textureCount; ++i)
+  // the range limits are the same for all objects, set them once. Objects
+  // are rendered with the first pass material through the material scheme
+  // of the first pass viewports.
+  Ogre::Pass *pass =
+      this->dataPtr->matFirstPass->getBestTechnique()->getPass(0);
+  Ogre::GpuProgramParametersSharedPtr params =
+      pass->getFragmentProgramParameters();
+  params->setNamedConstant("max", static_cast<float>(this->dataMaxVal));
+  params->setNamedConstant("min", static_cast<float>(this->dataMinVal));
+
+  // only the cubemap faces sampled by the rays are rendered
+  for (auto i : this->dataPtr->cubeFaceIdx)
   {
-    if (this->dataPtr->textureCount > 1)
-    {
-      // Cannot call Camera::RotateYaw because it rotates in world frame,
-      // but we need rotation in camera local frame
-      this->Node()->roll(Ogre::Radian(this->dataPtr->cameraYaws[i]));
-    }
-
-    this->dataPtr->currentMat = this->dataPtr->matFirstPass;
-    this->dataPtr->currentTexture = this->dataPtr->firstPassTextures[i];
-
-    this->UpdateRenderTarget(
-        this->dataPtr->firstPassTextures[i]->getBuffer()->getRenderTarget(),
-        this->dataPtr->matFirstPass,
-        this->dataPtr->ogreCamera, false);
+    // OgreSceneManager::_render function automatically sets farClip to 0.
+    // Which normally equates to infinite distance. We don't want this. So
+    // we have to set the distance every time.
+    this->dataPtr->cubeCam[i]->setFarClipDistance(this->FarClipPlane());
+    this->dataPtr->firstPassTextures[i]->getBuffer()->getRenderTarget()
+        ->update(false);
   }
 
-  if (this->dataPtr->textureCount > 1)
-      this->Node()->roll(Ogre::Radian(this->dataPtr->cameraYaws[3]));
-
-  sceneMgr->removeRenderObjectListener(this);
+  sceneMgr->_suppressRenderStateChanges(true);
 
   this->dataPtr->visual->SetVisible(true);
 
@@ -623,14 +787,14 @@ void OgreGpuRays::Render()
 //////////////////////////////////////////////////
 void OgreGpuRays::PreRender()
 {
-  if (this->dataPtr->textureCount == 0)
+  if (!this->dataPtr->secondPassTexture)
     this->CreateGpuRaysTextures();
 }
 
 //////////////////////////////////////////////////
 void OgreGpuRays::PostRender()
 {
-  for (unsigned int i = 0; i < this->dataPtr->textureCount; ++i)
+  for (auto i : this->dataPtr->cubeFaceIdx)
   {
     auto rt =
         this->dataPtr->firstPassTextures[i]->getBuffer()->getRenderTarget();
@@ -795,86 +959,48 @@ void OgreGpuRays::CreateMesh()
 
   // startX ranges from 0 to -(w2nd/10) at dx=0.1 increments
   // startY ranges from h2nd/10 to 0 at dy=0.1 decrements
-  // see OgreGpuRays::Set2ndPassTarget() on how the ortho cam is set up
-  double startX = dx;
+  // see OgreGpuRays::CreateGpuRaysTextures() on how the ortho cam is set up
   double startY = this->dataPtr->h2nd/10.0;
 
-  // half of actual camera vertical FOV without padding
-  double phi = this->VFOV().Radian() / 2.0;
-  double phiCamera = phi + std::abs(this->VertHalfAngle());
-  double theta = this->CosHorzFOV() / 2.0;
-
-  if (this->dataPtr->h2nd == 1)
-  {
-    phi = 0;
-  }
-
-  // index of ray
-  unsigned int ptsOnLine = 0;
-
-  // total gpu rays hfov
-  double thfov = this->dataPtr->textureCount * this->CosHorzFOV();
-  double hstep = thfov / (this->dataPtr->w2nd - 1);
-  double vstep = 2.0 * phi / (this->dataPtr->h2nd - 1);
-
-  if (this->dataPtr->h2nd == 1)
-  {
-    vstep = 0;
-  }
-
+  double min = this->AngleMin().Radian();
+  double max = this->AngleMax().Radian();
+  double vmin = this->VerticalAngleMin().Radian();
+  double vmax = this->VerticalAngleMax().Radian();
+  double hStep = 0.0;
+  if (this->dataPtr->w2nd > 1)
+    hStep = (max - min) / static_cast<double>(this->dataPtr->w2nd - 1);
+  double vStep = 0.0;
+  if (this->dataPtr->h2nd > 1)
+    vStep = (vmax - vmin) / static_cast<double>(this->dataPtr->h2nd - 1);
+
+  this->dataPtr->cubeFaceIdx.clear();
   for (unsigned int j = 0; j < this->dataPtr->h2nd; ++j)
   {
-    double gamma = 0;
-    if (this->dataPtr->h2nd != 1)
-    {
-      // gamma: current vertical angle w.r.t. camera
-      gamma = vstep * j - phi + this->VertHalfAngle();
-    }
-
+    double v = vmin + j * vStep;
+    double startX = 0;
     for (unsigned int i = 0; i < this->dataPtr->w2nd; ++i)
     {
-      // current horizontal angle from start of gpu rays scan
-      double delta = hstep * i;
-
-      // index of texture that contains the depth value
-      unsigned int texture = static_cast<unsigned int>(
-          delta / this->CosHorzFOV());
-
-      // cap texture index and horizontal angle
-      if (texture > this->dataPtr->textureCount-1)
-      {
-        texture -= 1;
-        delta -= hstep;
-      }
+      double h = min + i * hStep;
+
+      // set up dir vector to sample from a standard Y up cubemap
+      math::Vector3d ray(0, 0, 1);
+      math::Quaterniond pitch(math::Vector3d(1, 0, 0), -v);
+      math::Quaterniond yaw(math::Vector3d(0, 1, 0), -h);
+      math::Vector3d dir = yaw * pitch * ray;
+      unsigned int faceIdx;
+      math::Vector2d uv = this->SampleCubemap(dir, faceIdx);
+      this->dataPtr->cubeFaceIdx.insert(faceIdx);
+
+      // the faceIdx/1000.0 value is used in the gpu_rays_2nd_pass shaders
+      // as a trick to determine which cubemap face texture to sample the
+      // range from.
+      submesh->AddVertex(faceIdx/1000.0, startX, startY);
+      submesh->AddTexCoord(uv.X(), uv.Y());
+      submesh->AddIndex(this->dataPtr->w2nd * j + i);
 
       startX -= dx;
-      if (ptsOnLine == this->dataPtr->w2nd)
-      {
-        ptsOnLine = 0;
-        startX = 0;
-        startY -= dy;
-      }
-      ptsOnLine++;
-
-      // the texture/1000.0 value is used in the gpu rays_2nd_pass.frag shader
-      // as a trick to determine which camera texture to use when stitching
-      // together the final depth image.
-      submesh->AddVertex(texture/1000.0, startX, startY);
-
-      // first compute angle from the start of current camera's horizontal
-      // min angle, then set delta to be angle from center of current camera.
-      delta = delta - (texture * this->CosHorzFOV());
-      delta = delta - theta;
-
-      // adjust uv coordinates of depth texture to match projection of current
-      // gpu ray the depth image plane.
-      double u = 0.5 - tan(delta) / (2.0 * tan(theta));
-      double v = 0.5 - (tan(gamma) * cos(theta)) /
-          (2.0 * tan(phiCamera) * cos(delta));
-
-      submesh->AddTexCoord(u, v);
-      submesh->AddIndex(this->dataPtr->w2nd * j + i);
     }
+    startY -= dy;
   }
 
   mesh->AddSubMesh(*submesh);
@@ -887,8 +1013,6 @@ void OgreGpuRays::CreateMesh()
 /////////////////////////////////////////////////
 void OgreGpuRays::CreateCanvas()
 {
-  this->CreateMesh();
-
   this->dataPtr->visual = this->scene->CreateVisual(
       this->Name() + "second_pass_canvas");
 
@@ -919,61 +1043,6 @@ void OgreGpuRays::CreateCanvas()
   this->dataPtr->visual->SetVisible(true);
 }
 
-/////////////////////////////////////////////////
-void OgreGpuRays::notifyRenderSingleObject(Ogre::Renderable *_rend,
-      const Ogre::Pass* /*pass*/, const Ogre::AutoParamDataSource* /*source*/,
-      const Ogre::LightList* /*lights*/, bool /*supp*/)
-{
-  // TODO(anyone): this function sets the retro for each obj
-  // but currently just sets it to 0
-
-  Ogre::Vector4 retro = Ogre::Vector4(0, 0, 0, 0);
-  if (!_rend->hasCustomParameter(1))
-  {
-    _rend->setCustomParameter(1, Ogre::Vector4(0, 0, 0, 0));
-  }
-
-  Ogre::Pass *pass =
-    this->dataPtr->currentMat->getBestTechnique()->getPass(0);
-  Ogre::RenderSystem *renderSys =
-    this->scene->OgreSceneManager()->getDestinationRenderSystem();
-
-  Ogre::AutoParamDataSource autoParamDataSource;
-
-  Ogre::RenderTarget *rt =
-    this->dataPtr->currentTexture->getBuffer()->getRenderTarget();
-  Ogre::Viewport *vp = rt->getViewport(0);
-
-  renderSys->_setViewport(vp);
-  autoParamDataSource.setCurrentRenderable(_rend);
-  autoParamDataSource.setCurrentPass(pass);
-  autoParamDataSource.setCurrentViewport(vp);
-  autoParamDataSource.setCurrentRenderTarget(rt);
-  autoParamDataSource.setCurrentSceneManager(this->scene->OgreSceneManager());
-  autoParamDataSource.setCurrentCamera(this->dataPtr->ogreCamera, true);
-
-  pass->_updateAutoParams(&autoParamDataSource,
-      Ogre::GPV_GLOBAL | Ogre::GPV_PER_OBJECT);
-  pass->getFragmentProgramParameters()->setNamedConstant("retro", retro[0]);
-  pass->getFragmentProgramParameters()->setNamedConstant(
-      "max", static_cast<float>(this->dataMaxVal));
-  pass->getFragmentProgramParameters()->setNamedConstant(
-      "min", static_cast<float>(this->dataMinVal));
-  renderSys->bindGpuProgram(
-      pass->getVertexProgram()->_getBindingDelegate());
-
-  renderSys->bindGpuProgramParameters(Ogre::GPT_VERTEX_PROGRAM,
-      pass->getVertexProgramParameters(),
-      Ogre::GPV_GLOBAL | Ogre::GPV_PER_OBJECT);
-
-  renderSys->bindGpuProgram(
-      pass->getFragmentProgram()->_getBindingDelegate());
-
-  renderSys->bindGpuProgramParameters(Ogre::GPT_FRAGMENT_PROGRAM,
-      pass->getFragmentProgramParameters(),
-      (Ogre::GPV_GLOBAL | Ogre::GPV_PER_OBJECT));
-}
-
 //////////////////////////////////////////////////
 ignition::common::ConnectionPtr OgreGpuRays::ConnectNewGpuRaysFrame(
     std::function<void(const float *_frame, unsigned int _width,
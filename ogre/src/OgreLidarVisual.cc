@@ -508,5 +508,5 @@ std::vector<double> OgreLidarVisual::Points() const
 void OgreLidarVisual::SetVisible(bool _visible)
 {
   this->dataPtr->visible = _visible;
-  this->ogreNode->setVisible(this->dataPtr->visible);
+  OgreVisual::SetVisible(_visible);
 }
@@ -53,6 +53,10 @@ OgreMarker::~OgreMarker()
 //////////////////////////////////////////////////
 void OgreMarker::PreRender()
 {
+  // ogre1 has no hlms instancing, list shapes are copied into the lines
+  if (this->listDirty && IsListType(this->markerType))
+    this->BakeListElements();
+
   this->dataPtr->dynamicRenderable->Update();
 }
 
@@ -90,6 +94,9 @@ Ogre::MovableObject *OgreMarker::OgreObject() const
     case MT_TRIANGLE_FAN:
     case MT_TRIANGLE_LIST:
     case MT_TRIANGLE_STRIP:
+    case MT_BOX_LIST:
+    case MT_CYLINDER_LIST:
+    case MT_SPHERE_LIST:
       return std::dynamic_pointer_cast<Ogre::MovableObject>
         (this->dataPtr->dynamicRenderable).get();
     default:
@@ -155,6 +162,9 @@ void OgreMarker::SetMaterial(MaterialPtr _material, bool _unique)
     case MT_TRIANGLE_FAN:
     case MT_TRIANGLE_LIST:
     case MT_TRIANGLE_STRIP:
+    case MT_BOX_LIST:
+    case MT_CYLINDER_LIST:
+    case MT_SPHERE_LIST:
 #if (OGRE_VERSION <= ((1 << 16) | (10 << 8) | 7))
       this->dataPtr->dynamicRenderable->setMaterial(materialName);
 #else
@@ -180,6 +190,13 @@ void OgreMarker::SetPoint(unsigned int _index,
   this->dataPtr->dynamicRenderable->SetPoint(_index, _value);
 }
 
+//////////////////////////////////////////////////
+void OgreMarker::SetPointTexCoord(unsigned int _index,
+    const ignition::math::Vector2d &_texCoord)
+{
+  this->dataPtr->dynamicRenderable->SetTexCoord(_index, _texCoord);
+}
+
 //////////////////////////////////////////////////
 void OgreMarker::AddPoint(const ignition::math::Vector3d &_pt,
     const ignition::math::Color &_color)
@@ -221,6 +238,13 @@ void OgreMarker::SetType(MarkerType _markerType)
     case MT_TRIANGLE_STRIP:
       this->dataPtr->dynamicRenderable->SetOperationType(_markerType);
       break;
+    case MT_BOX_LIST:
+    case MT_CYLINDER_LIST:
+    case MT_SPHERE_LIST:
+      // the shapes are drawn as a single triangle list, see PreRender
+      this->dataPtr->dynamicRenderable->SetOperationType(MT_TRIANGLE_LIST);
+      this->listDirty = true;
+      break;
     default:
       ignerr << "Invalid Marker type\n";
       break;
@@ -15,6 +15,9 @@
  *
  */
 
+#include <algorithm>
+#include <vector>
+
 #include <ignition/common/Console.hh>
 #include <ignition/common/Filesystem.hh>
 
@@ -45,6 +48,8 @@ void OgreMaterial::Destroy()
   if (!this->Scene()->IsInitialized())
     return;
 
+  this->DestroyMemoryTexture();
+
   Ogre::MaterialManager &matManager = Ogre::MaterialManager::getSingleton();
 #if OGRE_VERSION_LT_1_10_1
   if (!this->ogreMaterial.isNull())
@@ -256,6 +261,74 @@ void OgreMaterial::SetTexture(const std::string &_name)
   this->SetTextureImpl(this->textureName);
 }
 
+//////////////////////////////////////////////////
+void OgreMaterial::SetTexture(const std::string &_name,
+    const std::shared_ptr<const common::Image> &_img)
+{
+  if (_name.empty() || !_img || !_img->Valid())
+  {
+    this->ClearTexture();
+    return;
+  }
+
+  if (_name != this->memoryTextureName)
+    this->DestroyMemoryTexture();
+  this->textureName = _name;
+
+  // the texture is shared by all the materials using the same name. The
+  // material uploading it removes it.
+  Ogre::TextureManager &texManager = Ogre::TextureManager::getSingleton();
+  if (!texManager.resourceExists(_name))
+  {
+    unsigned int width = _img->Width();
+    unsigned int height = _img->Height();
+    std::vector<unsigned char> data(width * height * 4u);
+    for (unsigned int y = 0u; y < height; ++y)
+    {
+      for (unsigned int x = 0u; x < width; ++x)
+      {
+        math::Color color = _img->Pixel(x, y);
+        unsigned char *pixel = &data[(y * width + x) * 4u];
+        pixel[0] = static_cast<unsigned char>(color.R() * 255.0f);
+        pixel[1] = static_cast<unsigned char>(color.G() * 255.0f);
+        pixel[2] = static_cast<unsigned char>(color.B() * 255.0f);
+        pixel[3] = static_cast<unsigned char>(color.A() * 255.0f);
+      }
+    }
+
+    Ogre::Image image;
+    image.loadDynamicImage(data.data(), width, height, 1,
+        Ogre::PF_BYTE_RGBA);
+    try
+    {
+      texManager.loadImage(_name, this->ogreGroup, image);
+      this->memoryTextureName = _name;
+    }
+    catch (const Ogre::Exception &ex)
+    {
+      ignerr << "Unable to create texture [" << _name << "]: "
+             << ex.what() << std::endl;
+      this->ClearTexture();
+      return;
+    }
+  }
+
+  this->ogreTexState->setTextureName(_name);
+  this->UpdateColorOperation();
+}
+
+//////////////////////////////////////////////////
+void OgreMaterial::DestroyMemoryTexture()
+{
+  if (this->memoryTextureName.empty())
+    return;
+
+  Ogre::TextureManager &texManager = Ogre::TextureManager::getSingleton();
+  texManager.unload(this->memoryTextureName);
+  texManager.remove(this->memoryTextureName);
+  this->memoryTextureName.clear();
+}
+
 //////////////////////////////////////////////////
 void OgreMaterial::ClearTexture()
 {
@@ -321,35 +394,61 @@ void OgreMaterial::UpdateShaderParams()
   {
     Ogre::GpuProgramParametersSharedPtr ogreParams;
     ogreParams = this->ogrePass->getVertexProgramParameters();
-    this->UpdateShaderParams(this->vertexShaderParams, ogreParams);
+    this->UpdateShaderParams(this->vertexShaderParams, ogreParams,
+        this->vertexShaderHandles);
     this->vertexShaderParams->ClearDirty();
   }
   if (this->fragmentShaderParams && this->fragmentShaderParams->IsDirty())
   {
     Ogre::GpuProgramParametersSharedPtr ogreParams;
     ogreParams = this->ogrePass->getFragmentProgramParameters();
-    this->UpdateShaderParams(this->fragmentShaderParams, ogreParams);
+    this->UpdateShaderParams(this->fragmentShaderParams, ogreParams,
+        this->fragmentShaderHandles);
     this->fragmentShaderParams->ClearDirty();
   }
 }
 
 //////////////////////////////////////////////////
 void OgreMaterial::UpdateShaderParams(ConstShaderParamsPtr _params,
-    Ogre::GpuProgramParametersSharedPtr _ogreParams)
+    Ogre::GpuProgramParametersSharedPtr _ogreParams,
+    std::vector<const Ogre::GpuConstantDefinition *> &_handles)
 {
-  for (const auto name_param : *_params)
+  for (auto index : _params->DirtyIndices())
   {
-    if (ShaderParam::PARAM_FLOAT == name_param.second.Type())
+    // resolve the constants of new params
+    while (_handles.size() <= index)
+    {
+      const std::string &name = _params->NameByIndex(
+          static_cast<uint32_t>(_handles.size()));
+      const Ogre::GpuConstantDefinition *def =
+          _ogreParams->_findNamedConstantDefinition(name, false);
+      if (!def)
+      {
+        ignwarn << "Shader param [" << name << "] not found in shader of "
+                << "material [" << this->name << "]" << std::endl;
+      }
+      _handles.push_back(def);
+    }
+
+    const Ogre::GpuConstantDefinition *def = _handles[index];
+    if (!def)
+      continue;
+
+    // write the values straight to the constant buffer, without a lookup
+    const ShaderParam &param = _params->ParamByIndex(index);
+    size_t count = std::min<size_t>(param.Count(),
+        def->elementSize * def->arraySize);
+    if ((ShaderParam::PARAM_FLOAT == param.Type() ||
+        ShaderParam::PARAM_FLOAT_BUFFER == param.Type()) && def->isFloat())
     {
-      float value;
-      name_param.second.Value(&value);
-      _ogreParams->setNamedConstant(name_param.first, value);
+      _ogreParams->_writeRawConstants(def->physicalIndex,
+          static_cast<const float *>(param.Data()), count);
     }
-    else if (ShaderParam::PARAM_INT == name_param.second.Type())
+    else if ((ShaderParam::PARAM_INT == param.Type() ||
+        ShaderParam::PARAM_INT_BUFFER == param.Type()) && !def->isFloat())
     {
-      int value;
-      name_param.second.Value(&value);
-      _ogreParams->setNamedConstant(name_param.first, value);
+      _ogreParams->_writeRawConstants(def->physicalIndex,
+          static_cast<const int *>(param.Data()), count);
     }
   }
 }
@@ -369,9 +468,11 @@ void OgreMaterial::SetVertexShader(const std::string &_path)
   Ogre::ResourceGroupManager::getSingleton().addResourceLocation(_path,
   "FileSystem", "General", false);
 
+  // name the program after the material too, materials sharing a shader
+  // file each get their own program
   Ogre::HighLevelGpuProgramPtr vertexShader =
     Ogre::HighLevelGpuProgramManager::getSingletonPtr()->createProgram(
-        "__ignition_rendering_vertex__" + _path,
+        "__ignition_rendering_vertex__" + this->Name() + "__" + _path,
         this->ogreGroup,
         "glsl", Ogre::GpuProgramType::GPT_VERTEX_PROGRAM);
 
@@ -389,6 +490,7 @@ void OgreMaterial::SetVertexShader(const std::string &_path)
 
   this->vertexShaderPath = _path;
   this->vertexShaderParams.reset(new ShaderParams);
+  this->vertexShaderHandles.clear();
 }
 
 //////////////////////////////////////////////////
@@ -418,9 +520,10 @@ void OgreMaterial::SetFragmentShader(const std::string &_path)
   Ogre::ResourceGroupManager::getSingleton().addResourceLocation(_path,
   "FileSystem", "General", false);
 
+  // name the program after the material too, see SetVertexShader
   Ogre::HighLevelGpuProgramPtr fragmentShader =
     Ogre::HighLevelGpuProgramManager::getSingleton().createProgram(
-        "__ignition_rendering_fragment__" + _path,
+        "__ignition_rendering_fragment__" + this->Name() + "__" + _path,
         this->ogreGroup,
         "glsl", Ogre::GpuProgramType::GPT_FRAGMENT_PROGRAM);
 
@@ -440,6 +543,7 @@ void OgreMaterial::SetFragmentShader(const std::string &_path)
 
   this->fragmentShaderPath = _path;
   this->fragmentShaderParams.reset(new ShaderParams);
+  this->fragmentShaderHandles.clear();
 }
 
 //////////////////////////////////////////////////
@@ -492,7 +596,9 @@ void OgreMaterial::LoadOneImage(const std::string &_name, Ogre::Image &_image)
 //////////////////////////////////////////////////
 void OgreMaterial::SetTextureImpl(const std::string &_texture)
 {
-  if (!Ogre::ResourceGroupManager::getSingleton().resourceExists(
+  // textures set from memory are known to the texture manager only
+  if (!Ogre::TextureManager::getSingleton().resourceExists(_texture) &&
+      !Ogre::ResourceGroupManager::getSingleton().resourceExists(
       this->ogreGroup, _texture))
   {
     Ogre::ResourceGroupManager::getSingleton().addResourceLocation(
@@ -27,6 +27,7 @@
 
 #include <ignition/math/Matrix4.hh>
 
+#include "ignition/rendering/MeshOptimizer.hh"
 #include "ignition/rendering/ogre/OgreConversions.hh"
 #include "ignition/rendering/ogre/OgreIncludes.hh"
 #include "ignition/rendering/ogre/OgreMesh.hh"
@@ -227,7 +228,8 @@ bool OgreMeshFactory::LoadImpl(const MeshDescriptor &_desc)
 
       // Copy the original submesh. We may need to modify the vertices, and
       // we don't want to change the original.
-      common::SubMesh subMesh(*s.get());
+      common::SubMesh subMesh(_desc.optimizeMesh ?
+          MeshOptimizer::Optimize(*s.get()) : *s.get());
 
       // Recenter the vertices if requested.
       if (_desc.centerSubMesh)
@@ -460,6 +462,8 @@ std::string OgreMeshFactory::MeshName(const MeshDescriptor &_desc)
   ss << _desc.meshName << "::";
   ss << _desc.subMeshName << "::";
   ss << ((_desc.centerSubMesh) ? "CENTERED" : "ORIGINAL");
+  if (_desc.optimizeMesh)
+    ss << "::OPTIMIZED";
   return ss.str();
 }
 
@@ -157,6 +157,19 @@ OgreRenderEngine::OgreRenderPathType
   return this->renderPathType;
 }
 
+//////////////////////////////////////////////////
+OgreRenderEngine::OgreSceneManagerType
+    OgreRenderEngine::SceneManagerType() const
+{
+  return this->sceneManagerType;
+}
+
+//////////////////////////////////////////////////
+void OgreRenderEngine::SetSceneManagerType(OgreSceneManagerType _type)
+{
+  this->sceneManagerType = _type;
+}
+
 //////////////////////////////////////////////////
 void OgreRenderEngine::AddResourcePath(const std::string &_uri)
 {
@@ -275,6 +288,17 @@ bool OgreRenderEngine::LoadImpl(
   if (it != _params.end())
     std::istringstream(it->second) >> this->useCurrentGLContext;
 
+  it = _params.find("sceneManager");
+  if (it != _params.end())
+  {
+    if (it->second == "octree")
+      this->sceneManagerType = SM_OCTREE;
+    else if (it->second == "generic")
+      this->sceneManagerType = SM_GENERIC;
+    else
+      ignwarn << "Unknown scene manager [" << it->second << "]" << std::endl;
+  }
+
   try
   {
     this->LoadAttempt();
@@ -34,6 +34,7 @@
 #include <ignition/common/Console.hh>
 
 #include "ignition/rendering/Material.hh"
+#include "ignition/rendering/Utils.hh"
 
 #include "ignition/rendering/ogre/OgreRenderEngine.hh"
 #include "ignition/rendering/ogre/OgreRenderPass.hh"
@@ -159,7 +160,14 @@ void OgreRenderTarget::SetVisibilityMask(uint32_t _mask)
 {
   this->visibilityMask = _mask;
   if (this->ogreViewport)
-    this->ogreViewport->setVisibilityMask(this->visibilityMask);
+    this->ogreViewport->setVisibilityMask(
+        renderVisibilityMask(this->visibilityMask));
+}
+
+//////////////////////////////////////////////////
+double OgreRenderTarget::ResolutionScale() const
+{
+  return 1.0;
 }
 
 //////////////////////////////////////////////////
@@ -195,7 +203,8 @@ void OgreRenderTarget::RebuildViewport()
   this->ogreViewport->setClearEveryFrame(true);
   this->ogreViewport->setShadowsEnabled(true);
   this->ogreViewport->setOverlaysEnabled(false);
-  this->ogreViewport->setVisibilityMask(this->visibilityMask);
+  this->ogreViewport->setVisibilityMask(
+      renderVisibilityMask(this->visibilityMask));
 
   OgreRTShaderSystem::Instance()->AttachViewport(this->ogreViewport,
       this->scene);
@@ -610,8 +610,29 @@ bool OgreScene::InitObject(OgreObjectPtr _object, unsigned int _id,
 //////////////////////////////////////////////////
 void OgreScene::CreateContext()
 {
-  Ogre::Root *root = OgreRenderEngine::Instance()->OgreRoot();
-  this->ogreSceneManager = root->createSceneManager(Ogre::ST_GENERIC);
+  OgreRenderEngine *engine = OgreRenderEngine::Instance();
+  Ogre::Root *root = engine->OgreRoot();
+
+  // create scene managers by type name. Creating them by scene type mask
+  // picks whichever plugin registered a matching factory last.
+  if (engine->SceneManagerType() == OgreRenderEngine::SM_OCTREE)
+  {
+    try
+    {
+      this->ogreSceneManager = root->createSceneManager("OctreeSceneManager");
+    }
+    catch (Ogre::Exception &)
+    {
+      ignwarn << "Octree scene manager is not available, using the "
+              << "generic scene manager" << std::endl;
+    }
+  }
+
+  if (!this->ogreSceneManager)
+  {
+    this->ogreSceneManager = root->createSceneManager(
+        Ogre::DefaultSceneManagerFactory::FACTORY_TYPE_NAME);
+  }
 
 #if (OGRE_VERSION >= ((1 << 16) | (9 << 8) | 0))
   this->ogreSceneManager->addRenderQueueListener(
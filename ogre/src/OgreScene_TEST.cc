@@ -0,0 +1,129 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <string>
+
+#include <ignition/common/Console.hh>
+
+#include "ignition/rendering/RenderEngine.hh"
+#include "ignition/rendering/RenderingIface.hh"
+#include "ignition/rendering/Scene.hh"
+#include "ignition/rendering/ogre/OgreIncludes.hh"
+#include "ignition/rendering/ogre/OgreRenderEngine.hh"
+#include "ignition/rendering/ogre/OgreScene.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+/////////////////////////////////////////////////
+/// \brief Get the type name of the ogre scene manager of a scene
+/// \param[in] _scene Scene
+/// \return Type name, empty if the scene is not an ogre scene
+std::string sceneManagerType(const ScenePtr &_scene)
+{
+  OgreScenePtr ogreScene = std::dynamic_pointer_cast<OgreScene>(_scene);
+  if (!ogreScene || !ogreScene->OgreSceneManager())
+    return std::string();
+  return ogreScene->OgreSceneManager()->getTypeName();
+}
+
+/////////////////////////////////////////////////
+TEST(OgreSceneTest, SceneManagerType)
+{
+  RenderEngine *engine = rendering::engine("ogre");
+  if (!engine)
+  {
+    igndbg << "Engine 'ogre' is not supported" << std::endl;
+    return;
+  }
+  OgreRenderEngine *ogreEngine = OgreRenderEngine::Instance();
+  const std::string octree = "OctreeSceneManager";
+  const std::string generic =
+      Ogre::DefaultSceneManagerFactory::FACTORY_TYPE_NAME;
+
+  // the octree scene manager is used by default
+  EXPECT_EQ(OgreRenderEngine::SM_OCTREE, ogreEngine->SceneManagerType());
+  ScenePtr scene = engine->CreateScene("octree");
+  ASSERT_NE(nullptr, scene);
+  EXPECT_EQ(octree, sceneManagerType(scene));
+
+  // only new scenes use the new type
+  ogreEngine->SetSceneManagerType(OgreRenderEngine::SM_GENERIC);
+  EXPECT_EQ(OgreRenderEngine::SM_GENERIC, ogreEngine->SceneManagerType());
+  ScenePtr genericScene = engine->CreateScene("generic");
+  ASSERT_NE(nullptr, genericScene);
+  EXPECT_EQ(generic, sceneManagerType(genericScene));
+  EXPECT_EQ(octree, sceneManagerType(scene));
+  engine->DestroyScenes();
+  rendering::unloadEngine(engine->Name());
+
+  // the engine parameter selects the type
+  std::map<std::string, std::string> params;
+  params["sceneManager"] = "octree";
+  engine = rendering::engine("ogre", params);
+  ASSERT_NE(nullptr, engine);
+  EXPECT_EQ(OgreRenderEngine::SM_OCTREE, ogreEngine->SceneManagerType());
+  scene = engine->CreateScene("octree");
+  EXPECT_EQ(octree, sceneManagerType(scene));
+  engine->DestroyScenes();
+  rendering::unloadEngine(engine->Name());
+
+  params["sceneManager"] = "generic";
+  engine = rendering::engine("ogre", params);
+  ASSERT_NE(nullptr, engine);
+  EXPECT_EQ(OgreRenderEngine::SM_GENERIC, ogreEngine->SceneManagerType());
+  scene = engine->CreateScene("generic");
+  EXPECT_EQ(generic, sceneManagerType(scene));
+  engine->DestroyScenes();
+  rendering::unloadEngine(engine->Name());
+
+  // unknown values keep the current type
+  params["sceneManager"] = "bsp";
+  engine = rendering::engine("ogre", params);
+  ASSERT_NE(nullptr, engine);
+  EXPECT_EQ(OgreRenderEngine::SM_GENERIC, ogreEngine->SceneManagerType());
+
+  // scenes fall back to the generic scene manager without the octree
+  // plugin
+  ogreEngine->SetSceneManagerType(OgreRenderEngine::SM_OCTREE);
+  Ogre::Root *root = ogreEngine->OgreRoot();
+  Ogre::Plugin *octreePlugin = nullptr;
+  for (auto plugin : root->getInstalledPlugins())
+  {
+    if (plugin->getName() == "Octree Scene Manager")
+      octreePlugin = plugin;
+  }
+  ASSERT_NE(nullptr, octreePlugin);
+  root->uninstallPlugin(octreePlugin);
+  scene = engine->CreateScene("fallback");
+  ASSERT_NE(nullptr, scene);
+  EXPECT_EQ(generic, sceneManagerType(scene));
+  engine->DestroyScenes();
+  root->installPlugin(octreePlugin);
+
+  // Clean up
+  rendering::unloadEngine(engine->Name());
+}
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -39,6 +39,7 @@ OgreVisual::~OgreVisual()
 //////////////////////////////////////////////////
 void OgreVisual::SetVisible(bool _visible)
 {
+  this->visible = _visible;
   this->ogreNode->setVisible(_visible);
 }
 
@@ -51,7 +52,10 @@ void OgreVisual::SetVisibilityFlags(uint32_t _flags)
     return;
 
   for (unsigned int i = 0; i < this->ogreNode->numAttachedObjects(); ++i)
-    this->ogreNode->getAttachedObject(i)->setVisibilityFlags(_flags);
+  {
+    this->ogreNode->getAttachedObject(i)->setVisibilityFlags(
+        renderVisibilityFlags(_flags));
+  }
 }
 
 //////////////////////////////////////////////////
@@ -84,7 +88,7 @@ bool OgreVisual::AttachGeometry(GeometryPtr _geometry)
   // set user data for mouse queries
   ogreObj->getUserObjectBindings().setUserAny(
       Ogre::Any(this->Id()));
-  ogreObj->setVisibilityFlags(this->visibilityFlags);
+  ogreObj->setVisibilityFlags(renderVisibilityFlags(this->visibilityFlags));
 
   derived->SetParent(this->SharedThis());
   this->ogreNode->attachObject(ogreObj);
@@ -174,7 +178,7 @@ void OgreVisual::BoundsHelper(ignition::math::AxisAlignedBox &_box,
         box.Max() = max;
 
         // Assume world transform
-        ignition::math::Pose3d transform = _pose;
+        ignition::math::Pose3d transform = this->WorldPose();
 
         // If local frame, calculate transform matrix and set
         if (_local)
@@ -1,6 +1,17 @@
+// cubemap is constructed using z-up, x-forward, y-left
+// index: face   axis
+//     0: right  -y
+//     1: left   +y
+//     2: top    +z
+//     3: bottom -z
+//     4: front  +x
+//     5: back   -x
+uniform sampler2D tex0;
 uniform sampler2D tex1;
 uniform sampler2D tex2;
 uniform sampler2D tex3;
+uniform sampler2D tex4;
+uniform sampler2D tex5;
 
 uniform vec4 texSize;
 varying float tex;
@@ -12,16 +23,19 @@ void main()
     gl_FragColor = vec4(1,1,1,1);
   else
   {
-    int int_tex = int(tex * 1000.0);
+    // index of the cubemap face to sample the range from
+    int int_tex = int(tex * 1000.0 + 0.5);
     if (int_tex == 0)
-      //gl_FragColor=vec4(12,34,56,1);
-      gl_FragColor = texture2D( tex1, gl_TexCoord[0].st);
+      gl_FragColor = texture2D(tex0, gl_TexCoord[0].st);
+    else if (int_tex == 1)
+      gl_FragColor = texture2D(tex1, gl_TexCoord[0].st);
+    else if (int_tex == 2)
+      gl_FragColor = texture2D(tex2, gl_TexCoord[0].st);
+    else if (int_tex == 3)
+      gl_FragColor = texture2D(tex3, gl_TexCoord[0].st);
+    else if (int_tex == 4)
+      gl_FragColor = texture2D(tex4, gl_TexCoord[0].st);
     else
-      if (int_tex == 1)
-        //gl_FragColor=vec4(2,1,0,1);
-        gl_FragColor = texture2D( tex2, gl_TexCoord[0].st);
-      else
-        //gl_FragColor=vec4(3,2,1,1);
-        gl_FragColor = texture2D( tex3, gl_TexCoord[0].st);
-   }
+      gl_FragColor = texture2D(tex5, gl_TexCoord[0].st);
+  }
 }
@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_OGRE2_OGRE2BOUNDINGBOXCAMERA_HH_
+#define IGNITION_RENDERING_OGRE2_OGRE2BOUNDINGBOXCAMERA_HH_
+
+#include <memory>
+
+#include "ignition/rendering/base/BaseBoundingBoxCamera.hh"
+#include "ignition/rendering/ogre2/Ogre2Camera.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    // forward declaration
+    class Ogre2BoundingBoxCameraPrivate;
+
+    /// \brief Ogre2.x implementation of the bounding box camera class. The
+    /// labelled visuals are rendered with a color per visual into an id
+    /// texture, next to the image of the camera, and their visible boxes are
+    /// found in a single pass over the pixels read back.
+    class IGNITION_RENDERING_OGRE2_VISIBLE Ogre2BoundingBoxCamera :
+      public BaseBoundingBoxCamera<Ogre2Camera>
+    {
+      /// \brief Constructor
+      protected: Ogre2BoundingBoxCamera();
+
+      /// \brief Destructor
+      public: virtual ~Ogre2BoundingBoxCamera();
+
+      // Documentation inherited.
+      public: virtual void PreRender() override;
+
+      // Documentation inherited.
+      public: virtual void Render() override;
+
+      // Documentation inherited.
+      public: virtual void PostRender() override;
+
+      // Documentation inherited.
+      public: virtual void Destroy() override;
+
+      /// \brief Create the id texture and its compositor workspace, with
+      /// the size of the image of the camera
+      private: void CreateIdTexture();
+
+      /// \brief Destroy the id texture and its compositor workspace
+      private: void DestroyIdTexture();
+
+      /// \brief Read back the id texture and compute the boxes of the
+      /// visuals seen in it
+      private: void ReadIdTexture();
+
+      /// \brief Pointer to private data class
+      private: std::unique_ptr<Ogre2BoundingBoxCameraPrivate> dataPtr;
+
+      /// \brief Make scene our friend so it can create a bounding box camera
+      private: friend class Ogre2Scene;
+    };
+    }
+  }
+}
+#endif
@@ -69,9 +69,12 @@ namespace ignition
       // Documentation inherited.
       public: virtual void SetNearClipPlane(const double _near) override;
 
-      public: virtual math::Color BackgroundColor() const;
+      // Documentation inherited.
+      public: virtual math::Color BackgroundColor() const override;
 
-      public: virtual void SetBackgroundColor(const math::Color &_color);
+      // Documentation inherited.
+      public: virtual void SetBackgroundColor(const math::Color &_color)
+                  override;
 
       // Documentation inherited.
       public: virtual void Render() override;
@@ -121,6 +124,14 @@ namespace ignition
       /// \brief Create internal camera object
       private: void CreateCamera();
 
+      /// \brief Hide items that are occluded by visuals with the
+      /// IGN_VISIBILITY_OCCLUDER flag. The items are shown again by
+      /// RestoreOccludedItems.
+      private: void HideOccludedItems();
+
+      /// \brief Show the items hidden by HideOccludedItems
+      private: void RestoreOccludedItems();
+
       /// \brief Pointer to ogre camera object
       protected: Ogre::Camera *ogreCamera = nullptr;
 
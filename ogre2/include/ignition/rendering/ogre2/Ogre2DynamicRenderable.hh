@@ -89,6 +89,13 @@ namespace ignition
       public: void SetColor(unsigned int _index,
                             const ignition::math::Color &_color);
 
+      /// \brief Change the texture coordinates of an existing point in the
+      /// point list
+      /// \param[in] _index Index of the point to set
+      /// \param[in] _texCoord Texture coordinates of the point
+      public: void SetTexCoord(unsigned int _index,
+                               const ignition::math::Vector2d &_texCoord);
+
       /// \brief Return the position of an existing point in the point list
       /// \param[in] _index Get the point at this index
       /// \return position of point. A vector of
@@ -65,6 +65,10 @@ namespace ignition
       public: virtual void SetPoint(unsigned int _index,
                            const ignition::math::Vector3d &_value) override;
 
+      // Documentation inherited
+      public: virtual void SetPointTexCoord(unsigned int _index,
+                  const ignition::math::Vector2d &_texCoord) override;
+
       // Documentation inherited
       public: virtual void AddPoint(const ignition::math::Vector3d &_pt,
                            const ignition::math::Color &_color) override;
@@ -78,9 +82,18 @@ namespace ignition
       // Documentation inherited
       public: virtual MarkerType Type() const override;
 
+      // Documentation inherited
+      protected: virtual void SetParent(Ogre2VisualPtr _parent) override;
+
       /// \brief Create the marker geometry in ogre
       private: void Create();
 
+      /// \brief Create, move and color the items of the list shapes
+      private: void UpdateListItems();
+
+      /// \brief Destroy the items of the list shapes
+      private: void DestroyListItems();
+
       /// \brief Marker should only be created by scene.
       private: friend class Ogre2Scene;
 
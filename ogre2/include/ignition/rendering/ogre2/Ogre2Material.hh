@@ -87,6 +87,10 @@ namespace ignition
       // Documentation inherited
       public: virtual void SetTexture(const std::string &_name) override;
 
+      // Documentation inherited
+      public: virtual void SetTexture(const std::string &_name,
+                  const std::shared_ptr<const common::Image> &_img) override;
+
       // Documentation inherited
       public: virtual void ClearTexture() override;
 
@@ -184,6 +188,37 @@ namespace ignition
       // \sa BaseMaterial::PreRender()
       public: virtual void PreRender() override;
 
+      // Documentation inherited.
+      // \sa Material::SetVertexShader(const std::string &)
+      public: virtual void SetVertexShader(const std::string &_path) override;
+
+      // Documentation inherited.
+      // \sa Material::VertexShader() const
+      public: virtual std::string VertexShader() const override;
+
+      // Documentation inherited.
+      // \sa Material::VertexShaderParams()
+      public: virtual ShaderParamsPtr VertexShaderParams() override;
+
+      // Documentation inherited.
+      // \sa Material::SetFragmentShader(const std::string &)
+      public: virtual void SetFragmentShader(const std::string &_path)
+          override;
+
+      // Documentation inherited.
+      // \sa Material::FragmentShader() const
+      public: virtual std::string FragmentShader() const override;
+
+      // Documentation inherited.
+      // \sa Material::FragmentShaderParams()
+      public: virtual ShaderParamsPtr FragmentShaderParams() override;
+
+      /// \brief Check if custom shaders are set. Materials with custom
+      /// shaders are rendered with the low level ogre material returned by
+      /// Material() instead of the Hlms datablock.
+      /// \return True if a vertex or fragment shader is set
+      public: virtual bool HasCustomShaders() const;
+
       // Documentation inherited.
       public: virtual enum MaterialType Type() const override;
 
@@ -210,6 +245,10 @@ namespace ignition
       /// \return Ogre texture
       protected: virtual Ogre::TexturePtr Texture(const std::string &_name);
 
+      /// \brief Destroy the texture this material created from an image in
+      /// memory, if any
+      protected: void DestroyMemoryTexture();
+
       /// \brief Updates the material transparency in the engine,
       /// based on transparency and diffuse alpha values
       protected: virtual void UpdateTransparency();
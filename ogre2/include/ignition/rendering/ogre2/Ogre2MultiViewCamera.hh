@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_OGRE2_OGRE2MULTIVIEWCAMERA_HH_
+#define IGNITION_RENDERING_OGRE2_OGRE2MULTIVIEWCAMERA_HH_
+
+#include <memory>
+
+#include "ignition/rendering/base/BaseMultiViewCamera.hh"
+#include "ignition/rendering/ogre2/Ogre2Camera.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    // forward declaration
+    class Ogre2MultiViewCameraPrivate;
+
+    /// \brief Ogre2.x implementation of the multi-view camera class. Each
+    /// view is rendered by an ogre camera attached to the node of the
+    /// camera, with one scene pass per view in the compositor workspace of
+    /// the render texture.
+    class IGNITION_RENDERING_OGRE2_VISIBLE Ogre2MultiViewCamera :
+      public BaseMultiViewCamera<Ogre2Camera>
+    {
+      /// \brief Constructor
+      protected: Ogre2MultiViewCamera();
+
+      /// \brief Destructor
+      public: virtual ~Ogre2MultiViewCamera();
+
+      // Documentation inherited.
+      public: virtual void PreRender() override;
+
+      // Documentation inherited.
+      public: virtual void Destroy() override;
+
+      /// \brief Occlusion culling is not supported by multi-view cameras,
+      /// since occluded objects are found from the pose of the camera and
+      /// not of each view. Enabling it prints a warning.
+      /// \param[in] _enabled Ignored, occlusion culling stays disabled
+      public: virtual void SetOcclusionCulling(bool _enabled) override;
+
+      /// \brief Create or destroy the ogre cameras so that there is one
+      /// per view, and update their poses and projections
+      private: void UpdateViewCameras();
+
+      /// \brief Pointer to private data class
+      private: std::unique_ptr<Ogre2MultiViewCameraPrivate> dataPtr;
+
+      /// \brief Make scene our friend so it can create a multi-view camera
+      private: friend class Ogre2Scene;
+    };
+    }
+  }
+}
+#endif
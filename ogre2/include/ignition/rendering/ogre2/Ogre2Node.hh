@@ -55,6 +55,18 @@ namespace ignition
       // Documentation inherited.
       public: virtual void Destroy() override;
 
+      // Documentation inherited.
+      public: virtual math::Pose3d WorldPose() const override;
+
+      // Documentation inherited.
+      public: virtual math::Vector3d WorldScale() const override;
+
+      // Documentation inherited.
+      public: using BaseNode<Ogre2Object>::SetOrigin;
+
+      // Documentation inherited.
+      public: virtual void SetOrigin(const math::Vector3d &_origin) override;
+
       // Documentation inherited.
       public: virtual math::Vector3d LocalScale() const override;
 
@@ -112,6 +124,22 @@ namespace ignition
       // Documentation inherited.
       protected: virtual void Init() override;
 
+      /// \brief Mark the cached world transform and bounds of this node and
+      /// all its descendants dirty, as well as the cached bounds of its
+      /// ancestors. This must be called whenever the local transform or the
+      /// parent of the node changes.
+      protected: void MarkTransformDirty();
+
+      /// \brief Mark the cached bounds of this node and its ancestors dirty.
+      /// This must be called whenever the content of the subtree rooted at
+      /// this node changes.
+      protected: void MarkBoundsDirty();
+
+      /// \brief Recursively mark the cached world transform and bounds of
+      /// this node and its descendants dirty. Stops at nodes that are
+      /// already dirty since their descendants are dirty too.
+      private: void MarkSubtreeTransformDirty();
+
       /// \brief get a shared pointer to this
       private: Ogre2NodePtr SharedThis();
 
@@ -124,6 +152,24 @@ namespace ignition
       /// \brief A list of child nodes
       protected: Ogre2NodeStorePtr children;
 
+      /// \brief Cached world pose, valid when worldTransformDirty is false
+      protected: mutable math::Pose3d cachedWorldPose;
+
+      /// \brief Cached world scale, valid when worldTransformDirty is false
+      protected: mutable math::Vector3d cachedWorldScale;
+
+      /// \brief True if the cached world pose and scale need to be
+      /// recomputed. If a node is dirty, all its descendants are dirty too.
+      protected: mutable bool worldTransformDirty = true;
+
+      /// \brief True if the cached world bounds of the subtree rooted at
+      /// this node need to be recomputed
+      protected: mutable bool worldBoundsDirty = true;
+
+      /// \brief True if the cached local bounds of the subtree rooted at
+      /// this node need to be recomputed
+      protected: mutable bool localBoundsDirty = true;
+
       // TODO(anyone): remove the need for a visual friend class
       private: friend class Ogre2Visual;
     };
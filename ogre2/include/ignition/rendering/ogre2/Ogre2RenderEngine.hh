@@ -17,6 +17,7 @@
 #ifndef IGNITION_RENDERING_OGRE2_OGRE2RENDERENGINE_HH_
 #define IGNITION_RENDERING_OGRE2_OGRE2RENDERENGINE_HH_
 
+#include <cstdint>
 #include <map>
 #include <memory>
 #include <string>
@@ -32,6 +33,7 @@
 
 namespace Ogre
 {
+  class CompositorWorkspace;
   class LogManager;
   class Root;
   namespace v1
@@ -168,6 +170,48 @@ namespace ignition
       /// \return Pointer to the ogre overlay system.
       public: Ogre::v1::OverlaySystem *OverlaySystem() const;
 
+      /// \brief Request a compositor workspace to be updated. Requests are
+      /// batched, and all the workspaces requested since the last flush are
+      /// updated together in a single Ogre frame by FlushRenderRequests, so
+      /// that the scene graph update and the per frame work of Ogre are only
+      /// done once for all of them. Workspaces are updated in the order
+      /// they were created. Anything reading the output of a workspace must
+      /// flush the requests first.
+      /// \param[in] _workspace Workspace to update
+      /// \sa SetBatchRendering
+      public: void RequestRender(Ogre::CompositorWorkspace *_workspace);
+
+      /// \brief Update all the requested compositor workspaces in a single
+      /// Ogre frame. Does nothing if there are no requests.
+      public: void FlushRenderRequests();
+
+      /// \brief Cancel the render request of a workspace, e.g. before the
+      /// workspace is destroyed
+      /// \param[in] _workspace Workspace to cancel the request of
+      public: void CancelRenderRequest(Ogre::CompositorWorkspace *_workspace);
+
+      /// \brief Get the time a workspace took to render in the last flush
+      /// that updated it, and forget it so that each frame is only reported
+      /// once. The time of a flush is split between the workspaces it
+      /// updated by the size of their output.
+      /// \param[in] _workspace Workspace to get the render time of
+      /// \return Render time in seconds, or a negative value if the
+      /// workspace was not rendered since the last call
+      public: double PopRenderTime(Ogre::CompositorWorkspace *_workspace);
+
+      /// \brief Set whether render requests are batched. When disabled,
+      /// each request renders an Ogre frame right away. Enabled by default.
+      /// \param[in] _batch True to batch render requests
+      public: void SetBatchRendering(bool _batch);
+
+      /// \brief Get whether render requests are batched
+      /// \return True if render requests are batched
+      public: bool BatchRendering() const;
+
+      /// \brief Get the number of Ogre frames rendered for render requests
+      /// \return Frame count
+      public: uint64_t FrameCount() const;
+
       /// \brief Pointer to the ogre's overlay system
       private: Ogre::v1::OverlaySystem *ogreOverlaySystem = nullptr;
 
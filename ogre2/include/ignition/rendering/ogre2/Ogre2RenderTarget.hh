@@ -73,6 +73,22 @@ namespace ignition
       /// \param[in] _camera Pointer to ogre camera
       public: virtual void SetCamera(Ogre::Camera *_camera);
 
+      /// \brief Set the ogre cameras of the views rendered side by side
+      /// into this render target, from left to right, each into a slice
+      /// of the same width. The views share the scene update of a single
+      /// compositor workspace. The compositor is destroyed right away and
+      /// rebuilt on the next PreRender, so the cameras of the previous views
+      /// can be destroyed once this returns.
+      /// \param[in] _cameras Cameras of the views. If empty, the whole
+      /// target is rendered with the camera set by SetCamera.
+      /// \param[in] _reuseShadows For each view, true to reuse the shadow
+      /// maps rendered for the first view instead of rendering its own.
+      /// Shadow maps are fitted to the frustum of the view they are
+      /// rendered for, so only views that overlap the first one should
+      /// reuse them. Views without an entry render their own.
+      public: void SetViewCameras(const std::vector<Ogre::Camera *> &_cameras,
+                  const std::vector<bool> &_reuseShadows = {});
+
       // Documentation inherited
       public: virtual math::Color BackgroundColor() const override;
 
@@ -111,11 +127,15 @@ namespace ignition
       public: virtual void SetVisibilityMask(uint32_t _mask);
 
       /// \brief Update the render pass chain
+      /// \param[in] _baseNodeInputs Number of input textures of the base
+      /// node. They are connected to the external channels that follow the
+      /// output of the workspace.
       public: static void UpdateRenderPassChain(
           Ogre::CompositorWorkspace *_workspace,
           const std::string &_workspaceDefName,
           const std::string &_baseNode, const std::string &_finalNode,
-          const std::vector<RenderPassPtr> &_renderPasses, bool _recreateNodes);
+          const std::vector<RenderPassPtr> &_renderPasses, bool _recreateNodes,
+          unsigned int _baseNodeInputs = 0u);
 
       /// \brief Update the background color
       protected: virtual void UpdateBackgroundColor();
@@ -123,8 +143,16 @@ namespace ignition
       /// \brief Update the render pass chain
       protected: virtual void UpdateRenderPassChain();
 
-      /// \brief Create a compositor shadow node with the same number of shadow
-      /// textures as the number of shadow casting lights
+      /// \brief Recreate the compositor nodes if the resolution scale
+      /// changed, so that the scene is rendered at the new resolution
+      protected: void UpdateResolutionScale();
+
+      // Documentation inherited.
+      protected: virtual double FrameTime() override;
+
+      /// \brief Recreate the compositor nodes if the scene replaced its
+      /// shadow node definition, so that the new shadow casting lights are
+      /// rendered
       protected: void UpdateShadowNode();
 
       /// \brief Implementation of the Rebuild function
@@ -148,24 +176,6 @@ namespace ignition
       /// \sa BaseRenderTarget::Rebuild()
       protected: void RebuildMaterial();
 
-      /// \brief Create ogre compositor shadow node definition. The function
-      /// takes a vector of parameters that describe the type, number, and
-      /// resolution of textures create. Note that it is not necessary to
-      /// create separate textures for each shadow map. It is more efficient to
-      /// define a large texture atlas which is composed of multiple shadow
-      /// maps each occupying a subspace within the texture. This function is
-      /// similar to Ogre::ShadowNodeHelper::createShadowNodeWithSettings but
-      /// fixes a problem with the shadow map index when directional and spot
-      /// light shadow textures are defined on two different texture atlases.
-      /// \param[in] _compositorManager ogre compositor manager
-      /// \param[in] _shadowNodeName Name of the shadow node definition
-      /// \param[in] _shadowParams Parameters containing the shadow type,
-      /// texure resolution and position on the texture atlas.
-      private: void CreateShadowNodeWithSettings(
-          Ogre::CompositorManager2 *_compositorManager,
-          const std::string &_shadowNodeName,
-          const Ogre::ShadowNodeHelper::ShadowParamVec &_shadowParams);
-
       /// \brief Pointer to the internal ogre camera
       protected: Ogre::Camera *ogreCamera = nullptr;
 
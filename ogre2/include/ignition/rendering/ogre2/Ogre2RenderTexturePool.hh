@@ -0,0 +1,146 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_OGRE2_OGRE2RENDERTEXTUREPOOL_HH_
+#define IGNITION_RENDERING_OGRE2_OGRE2RENDERTEXTUREPOOL_HH_
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+#include <ignition/common/SuppressWarning.hh>
+
+#include "ignition/rendering/config.hh"
+#include "ignition/rendering/ogre2/Ogre2Includes.hh"
+#include "ignition/rendering/ogre2/Export.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    // forward declaration
+    class Ogre2RenderTexturePoolPrivate;
+
+    /// \brief Scene wide pool of the render textures of sensors, which
+    /// sensors only need while they are being updated.
+    ///
+    /// Sensors acquire the textures their compositor workspaces render into
+    /// when they create the workspaces, and the pool hands out the same texture
+    /// to all sensors asking for the same size and format. This covers the
+    /// output targets as well as the intermediate colour, depth and particle
+    /// textures, which the compositor nodes take as inputs instead of
+    /// creating their own. Since sensors are updated one after another, the
+    /// contents of a texture are only needed by one sensor at a time: a
+    /// sensor borrows its textures before rendering into them and returns
+    /// them once it has read back its output. If another sensor borrows a
+    /// texture that has not been returned yet, the current holder is asked
+    /// to render and read back its data first.
+    class IGNITION_RENDERING_OGRE2_VISIBLE Ogre2RenderTexturePool
+    {
+      /// \brief Constructor
+      public: Ogre2RenderTexturePool();
+
+      /// \brief Destructor. Destroys the textures still acquired.
+      public: virtual ~Ogre2RenderTexturePool();
+
+      /// \brief Set whether textures are shared between owners. Disabling
+      /// the pool gives each acquisition its own texture, which is useful
+      /// to compare memory usage. Only affects textures acquired afterwards.
+      /// \param[in] _enabled True to share textures
+      public: void SetEnabled(bool _enabled);
+
+      /// \brief Get whether textures are shared between owners
+      /// \return True if textures are shared
+      public: bool Enabled() const;
+
+      /// \brief Acquire a 2D render texture. An owner acquiring several
+      /// textures of the same size and format gets distinct textures.
+      /// \param[in] _owner Object the texture is acquired for, usually the
+      /// sensor
+      /// \param[in] _width Width in pixels
+      /// \param[in] _height Height in pixels
+      /// \param[in] _format Pixel format
+      /// \param[in] _hwGamma True to write the texture with gamma
+      /// correction
+      /// \param[in] _depthFormat Format of the depth texture the render
+      /// target should be attached to, PF_UNKNOWN for a regular depth buffer
+      /// \return Render texture
+      public: Ogre::TexturePtr Acquire(const void *_owner,
+                  unsigned int _width, unsigned int _height,
+                  Ogre::PixelFormat _format, bool _hwGamma = false,
+                  Ogre::PixelFormat _depthFormat = Ogre::PF_UNKNOWN);
+
+      /// \brief Release a texture acquired with Acquire. The texture is
+      /// destroyed once no owner uses it.
+      /// \param[in] _owner Owner the texture was acquired for
+      /// \param[in] _texture Texture to release
+      public: void Release(const void *_owner,
+                  const Ogre::TexturePtr &_texture);
+
+      /// \brief Borrow a texture before rendering into it. If another owner
+      /// still holds the texture, its reclaim function is called so that it
+      /// reads back the contents before they are overwritten.
+      /// \param[in] _owner Owner borrowing the texture
+      /// \param[in] _texture Texture acquired by the owner
+      /// \param[in] _reclaim Function reading back the contents of the
+      /// texture, called if another owner borrows it before it is returned.
+      /// Can be null when the contents are not needed after rendering.
+      public: void Borrow(const void *_owner,
+                  const Ogre::TexturePtr &_texture,
+                  const std::function<void()> &_reclaim = nullptr);
+
+      /// \brief Return a borrowed texture once its contents are read back
+      /// \param[in] _owner Owner that borrowed the texture
+      /// \param[in] _texture Texture to return
+      public: void Return(const void *_owner,
+                  const Ogre::TexturePtr &_texture);
+
+      /// \brief Create the compositor channel of a texture, used to pass
+      /// the texture to a compositor workspace as an external target
+      /// \param[in] _texture Render texture
+      /// \return Compositor channel
+      public: static Ogre::CompositorChannel Channel(
+                  const Ogre::TexturePtr &_texture);
+
+      /// \brief Get the number of textures in the pool
+      /// \return Texture count
+      public: unsigned int TextureCount() const;
+
+      /// \brief Get the memory of the textures in the pool
+      /// \return Memory in bytes
+      public: uint64_t MemoryUsage() const;
+
+      /// \brief Get the memory the acquired textures would use if each
+      /// acquisition had its own texture
+      /// \return Memory in bytes
+      public: uint64_t UnpooledMemoryUsage() const;
+
+      /// \brief Get the number of times an owner had to read back its data
+      /// because another owner borrowed its texture
+      /// \return Reclaim count
+      public: uint64_t ReclaimCount() const;
+
+      IGN_COMMON_WARN_IGNORE__DLL_INTERFACE_MISSING
+      /// \brief Private data pointer
+      private: std::unique_ptr<Ogre2RenderTexturePoolPrivate> dataPtr;
+      IGN_COMMON_WARN_RESUME__DLL_INTERFACE_MISSING
+    };
+    }
+  }
+}
+#endif
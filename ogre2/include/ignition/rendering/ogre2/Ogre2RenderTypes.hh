@@ -30,6 +30,7 @@ namespace ignition
     //
     class Ogre2ArrowVisual;
     class Ogre2AxisVisual;
+    class Ogre2BoundingBoxCamera;
     class Ogre2Camera;
     class Ogre2DepthCamera;
     class Ogre2DirectionalLight;
@@ -43,6 +44,7 @@ namespace ignition
     class Ogre2Material;
     class Ogre2Mesh;
     class Ogre2MeshFactory;
+    class Ogre2MultiViewCamera;
     class Ogre2Node;
     class Ogre2Object;
     class Ogre2ParticleEmitter;
@@ -52,6 +54,7 @@ namespace ignition
     class Ogre2RenderTarget;
     class Ogre2RenderTargetMaterial;
     class Ogre2RenderTexture;
+    class Ogre2RenderTexturePool;
     class Ogre2RenderWindow;
     class Ogre2Scene;
     class Ogre2Sensor;
@@ -73,6 +76,7 @@ namespace ignition
 
     typedef shared_ptr<Ogre2ArrowVisual>          Ogre2ArrowVisualPtr;
     typedef shared_ptr<Ogre2AxisVisual>           Ogre2AxisVisualPtr;
+    typedef shared_ptr<Ogre2BoundingBoxCamera>    Ogre2BoundingBoxCameraPtr;
     typedef shared_ptr<Ogre2Camera>               Ogre2CameraPtr;
     typedef shared_ptr<Ogre2DepthCamera>          Ogre2DepthCameraPtr;
     typedef shared_ptr<Ogre2DirectionalLight>     Ogre2DirectionalLightPtr;
@@ -86,6 +90,7 @@ namespace ignition
     typedef shared_ptr<Ogre2Material>             Ogre2MaterialPtr;
     typedef shared_ptr<Ogre2Mesh>                 Ogre2MeshPtr;
     typedef shared_ptr<Ogre2MeshFactory>          Ogre2MeshFactoryPtr;
+    typedef shared_ptr<Ogre2MultiViewCamera>      Ogre2MultiViewCameraPtr;
     typedef shared_ptr<Ogre2Node>                 Ogre2NodePtr;
     typedef shared_ptr<Ogre2Object>               Ogre2ObjectPtr;
     typedef shared_ptr<Ogre2ParticleEmitter>      Ogre2ParticleEmitterPtr;
@@ -94,6 +99,7 @@ namespace ignition
     typedef shared_ptr<Ogre2RenderEngine>         Ogre2RenderEnginePtr;
     typedef shared_ptr<Ogre2RenderTarget>         Ogre2RenderTargetPtr;
     typedef shared_ptr<Ogre2RenderTexture>        Ogre2RenderTexturePtr;
+    typedef shared_ptr<Ogre2RenderTexturePool>    Ogre2RenderTexturePoolPtr;
     typedef shared_ptr<Ogre2RenderWindow>         Ogre2RenderWindowPtr;
     typedef shared_ptr<Ogre2Scene>                Ogre2ScenePtr;
     typedef shared_ptr<Ogre2Sensor>               Ogre2SensorPtr;
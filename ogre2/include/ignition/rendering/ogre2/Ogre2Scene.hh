@@ -81,6 +81,11 @@ namespace ignition
       /// \return Pointer to the ogre scene manager
       public: virtual Ogre::SceneManager *OgreSceneManager() const;
 
+      /// \brief Get the pool of render textures shared by the sensors of
+      /// this scene
+      /// \return Render texture pool
+      public: Ogre2RenderTexturePoolPtr RenderTexturePool() const;
+
       /// \cond PRIVATE
       /// \internal
       /// \brief Mark shadows dirty to rebuild compostior shadow node
@@ -94,6 +99,36 @@ namespace ignition
       /// \return True if the number of shadow casting lights changed
       /// \sa ShadowsDirty
       public: bool ShadowsDirty() const;
+
+      /// \internal
+      /// \brief Update the compositor shadow node definition if shadows
+      /// are dirty. The shadow node has room for more shadow casting lights
+      /// than there are, and a new definition is only created when the
+      /// lights no longer fit. Lights can then be added, removed and have
+      /// shadows toggled without rebuilding the compositors of the cameras.
+      public: void UpdateShadowNode();
+
+      /// \internal
+      /// \brief Get the name of the current compositor shadow node
+      /// definition. Render targets recreate their compositor nodes with
+      /// it when it changes.
+      /// \return Name of the shadow node definition
+      public: std::string ShadowNodeDefinitionName() const;
+
+      /// \internal
+      /// \brief Mark a shadow node definition as used by a compositor
+      /// workspace, so that it is not removed while still in use
+      /// \param[in] _name Name of the shadow node definition
+      /// \sa ReleaseShadowNode
+      public: void RetainShadowNode(const std::string &_name);
+
+      /// \internal
+      /// \brief Mark a shadow node definition as no longer used by a
+      /// compositor workspace. Definitions that were replaced are removed
+      /// once they are no longer used.
+      /// \param[in] _name Name of the shadow node definition
+      /// \sa RetainShadowNode
+      public: void ReleaseShadowNode(const std::string &_name);
       /// \endcond
 
       // Documentation inherited
@@ -126,6 +161,14 @@ namespace ignition
       protected: virtual ThermalCameraPtr CreateThermalCameraImpl(
                      unsigned int _id, const std::string &_name) override;
 
+      // Documentation inherited
+      protected: virtual MultiViewCameraPtr CreateMultiViewCameraImpl(
+                     unsigned int _id, const std::string &_name) override;
+
+      // Documentation inherited
+      protected: virtual BoundingBoxCameraPtr CreateBoundingBoxCameraImpl(
+                     unsigned int _id, const std::string &_name) override;
+
       // Documentation inherited
       protected: virtual GpuRaysPtr CreateGpuRaysImpl(unsigned int _id,
                      const std::string &_name) override;
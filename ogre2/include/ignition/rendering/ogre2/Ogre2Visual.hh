@@ -57,23 +57,25 @@ namespace ignition
       public: virtual ignition::math::AxisAlignedBox LocalBoundingBox()
                   const override;
 
-      /// \brief Recursively loop through this visual's children
-      /// to obtain the bounding box.
-      /// \param[in,out] _box The bounding box.
-      /// \param[in] _local A flag indicating if the local bounding box is to
-      /// be calculated.
-      /// \param[in] _pose World pose of the visual
-      private: virtual void BoundsHelper(
-                     ignition::math::AxisAlignedBox &_box, bool _local,
-                     const ignition::math::Pose3d &_pose) const;
-
-      /// \brief Wrapper function for BoundsHelper to reduce redundant
-      /// world pose access
+      // Documentation inherited.
+      public: virtual void PreRender() override;
+
+      /// \brief Recursively loop through this visual's children to obtain
+      /// the bounding box in the frame of an ancestor.
       /// \param[in,out] _box The bounding box.
-      /// \param[in] _local A flag indicating if the local bounding box is to
-      /// be calculated.
-      private: virtual void BoundsHelper(
-                     ignition::math::AxisAlignedBox &_box, bool _local) const;
+      /// \param[in] _pose World pose of the ancestor visual
+      private: void BoundsHelper(ignition::math::AxisAlignedBox &_box,
+                   const ignition::math::Pose3d &_pose) const;
+
+      /// \brief Recompute the cached bounds of the objects attached to this
+      /// visual's node.
+      /// \return True if the bounds changed
+      private: bool UpdateContentBounds() const;
+
+      /// \brief Mark the cached bounds of the objects attached to this
+      /// visual's node dirty, along with the cached bounds of its ancestors.
+      /// \param[in] _recursive True to also mark the descendants dirty
+      private: void MarkContentDirty(bool _recursive);
 
       // Documentation inherited.
       protected: virtual GeometryStorePtr Geometries() const override;
@@ -0,0 +1,413 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+
+#include "ignition/rendering/Utils.hh"
+#include "ignition/rendering/ogre2/Ogre2BoundingBoxCamera.hh"
+#include "ignition/rendering/ogre2/Ogre2Includes.hh"
+#include "ignition/rendering/ogre2/Ogre2RenderEngine.hh"
+#include "ignition/rendering/ogre2/Ogre2Scene.hh"
+
+namespace ignition
+{
+namespace rendering
+{
+inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+//
+/// \brief Helper class that renders the items of each labelled visual with
+/// a color of its own while the id texture of a bounding box camera is
+/// being rendered
+class Ogre2BoundingBoxMaterialSwitcher : public Ogre::RenderTargetListener
+{
+  /// \brief Constructor
+  /// \param[in] _scene Scene the camera belongs to
+  public: explicit Ogre2BoundingBoxMaterialSwitcher(Ogre2ScenePtr _scene);
+
+  /// \brief Callback when a render target is about to be rendered
+  /// \param[in] _evt Ogre render target event containing information about
+  /// the source render target.
+  private: virtual void preRenderTargetUpdate(
+      const Ogre::RenderTargetEvent &_evt) override;
+
+  /// \brief Callback when a render target is finished being rendered
+  /// \param[in] _evt Ogre render target event containing information about
+  /// the source render target.
+  private: virtual void postRenderTargetUpdate(
+      const Ogre::RenderTargetEvent &_evt) override;
+
+  /// \brief Get the id of the labelled visual a visual belongs to, which
+  /// is the visual itself or its closest labelled ancestor
+  /// \param[in] _visual Visual of a rendered item
+  /// \return Id of the labelled visual, or 0 if it is not labelled
+  private: unsigned int LabelledId(const VisualPtr &_visual);
+
+  /// \brief Labelled visuals rendered in the last frame, the color of a
+  /// visual is its index in this list plus one
+  public: std::vector<VisualPtr> visuals;
+
+  /// \brief Labels of the visuals
+  public: std::vector<uint32_t> labels;
+
+  /// \brief Scene the camera belongs to
+  private: Ogre2ScenePtr scene;
+
+  /// \brief Plain color material, it renders the first custom parameter
+  /// of each sub item
+  private: Ogre::MaterialPtr plainMaterial;
+
+  /// \brief Id of each visual seen in the frame, by visual id. The ids
+  /// are looked up once per visual and frame, so the ancestors of
+  /// visuals with many items are only walked once.
+  private: std::unordered_map<unsigned int, unsigned int> ids;
+
+  /// \brief Original datablocks of the sub items
+  private: std::unordered_map<Ogre::SubItem *, Ogre::HlmsDatablock *>
+      datablockMap;
+
+  /// \brief Overlay items hidden while the id texture is rendered, they
+  /// are drawn on top of the scene and would hide labelled visuals
+  private: std::vector<Ogre::Item *> hiddenItems;
+};
+}
+}
+}
+
+/// \brief Private data for the Ogre2BoundingBoxCamera class
+class ignition::rendering::Ogre2BoundingBoxCameraPrivate
+{
+  /// \brief Texture the ids of the labelled visuals are rendered to
+  public: Ogre::TexturePtr idTexture;
+
+  /// \brief Compositor workspace that renders the id texture
+  public: Ogre::CompositorWorkspace *idWorkspace = nullptr;
+
+  /// \brief Name of the compositor workspace definition of the id texture
+  public: std::string idWorkspaceDef;
+
+  /// \brief Material switcher of the id texture
+  public: std::unique_ptr<Ogre2BoundingBoxMaterialSwitcher> materialSwitcher;
+
+  /// \brief Id texture data read back from the gpu
+  public: std::vector<uint8_t> idBuffer;
+};
+
+using namespace ignition;
+using namespace rendering;
+
+//////////////////////////////////////////////////
+Ogre2BoundingBoxMaterialSwitcher::Ogre2BoundingBoxMaterialSwitcher(
+    Ogre2ScenePtr _scene)
+  : scene(_scene)
+{
+  Ogre::ResourcePtr res =
+    Ogre::MaterialManager::getSingleton().load("ign-rendering/plain_color",
+        Ogre::ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+  this->plainMaterial = res.staticCast<Ogre::Material>();
+  this->plainMaterial->load();
+}
+
+//////////////////////////////////////////////////
+unsigned int Ogre2BoundingBoxMaterialSwitcher::LabelledId(
+    const VisualPtr &_visual)
+{
+  auto it = this->ids.find(_visual->Id());
+  if (it != this->ids.end())
+    return it->second;
+
+  unsigned int id = 0u;
+  VisualPtr parent =
+      std::dynamic_pointer_cast<Visual>(_visual->Parent());
+  Variant labelAny = _visual->UserData("label");
+  const int *label = std::get_if<int>(&labelAny);
+  if (label && *label > 0)
+  {
+    this->visuals.push_back(_visual);
+    this->labels.push_back(static_cast<uint32_t>(*label));
+    id = static_cast<unsigned int>(this->visuals.size());
+  }
+  else if (parent)
+  {
+    id = this->LabelledId(parent);
+  }
+  this->ids[_visual->Id()] = id;
+  return id;
+}
+
+//////////////////////////////////////////////////
+void Ogre2BoundingBoxMaterialSwitcher::preRenderTargetUpdate(
+    const Ogre::RenderTargetEvent &/*_evt*/)
+{
+  this->visuals.clear();
+  this->labels.clear();
+  this->ids.clear();
+  this->datablockMap.clear();
+  this->hiddenItems.clear();
+
+  auto itor = this->scene->OgreSceneManager()->getMovableObjectIterator(
+      Ogre::ItemFactory::FACTORY_TYPE_NAME);
+  while (itor.hasMoreElements())
+  {
+    Ogre::Item *item = static_cast<Ogre::Item *>(itor.getNext());
+    if (!item->isVisible())
+      continue;
+
+    // unlabelled items are rendered black, so they still occlude the
+    // labelled visuals behind them
+    unsigned int id = 0u;
+    Ogre::Any userAny = item->getUserObjectBindings().getUserAny();
+    if (!userAny.isEmpty() && userAny.getType() == typeid(unsigned int))
+    {
+      VisualPtr visual = this->scene->VisualById(
+          Ogre::any_cast<unsigned int>(userAny));
+      if (visual)
+        id = this->LabelledId(visual);
+    }
+
+    Ogre::Vector4 color(((id >> 16u) & 0xFF) / 255.0f,
+        ((id >> 8u) & 0xFF) / 255.0f, (id & 0xFF) / 255.0f, 1.0f);
+    for (unsigned int i = 0; i < item->getNumSubItems(); ++i)
+    {
+      Ogre::SubItem *subItem = item->getSubItem(i);
+      Ogre::HlmsDatablock *datablock = subItem->getDatablock();
+      if (!datablock->getMacroblock()->mDepthWrite &&
+          !datablock->getMacroblock()->mDepthCheck)
+      {
+        item->setVisible(false);
+        this->hiddenItems.push_back(item);
+        break;
+      }
+    }
+    if (!item->isVisible())
+      continue;
+
+    for (unsigned int i = 0; i < item->getNumSubItems(); ++i)
+    {
+      Ogre::SubItem *subItem = item->getSubItem(i);
+      this->datablockMap[subItem] = subItem->getDatablock();
+      subItem->setCustomParameter(1, color);
+      subItem->setMaterial(this->plainMaterial);
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+void Ogre2BoundingBoxMaterialSwitcher::postRenderTargetUpdate(
+    const Ogre::RenderTargetEvent &/*_evt*/)
+{
+  for (auto &it : this->datablockMap)
+    it.first->setDatablock(it.second);
+  this->datablockMap.clear();
+
+  for (auto item : this->hiddenItems)
+    item->setVisible(true);
+  this->hiddenItems.clear();
+}
+
+//////////////////////////////////////////////////
+Ogre2BoundingBoxCamera::Ogre2BoundingBoxCamera()
+  : dataPtr(std::make_unique<Ogre2BoundingBoxCameraPrivate>())
+{
+}
+
+//////////////////////////////////////////////////
+Ogre2BoundingBoxCamera::~Ogre2BoundingBoxCamera()
+{
+  this->Destroy();
+}
+
+//////////////////////////////////////////////////
+void Ogre2BoundingBoxCamera::Destroy()
+{
+  if (this->Scene()->IsInitialized())
+    this->DestroyIdTexture();
+  this->dataPtr->materialSwitcher.reset();
+
+  Ogre2Camera::Destroy();
+}
+
+//////////////////////////////////////////////////
+void Ogre2BoundingBoxCamera::PreRender()
+{
+  BaseCamera::PreRender();
+
+  Ogre::TexturePtr &texture = this->dataPtr->idTexture;
+  if (!texture || texture->getWidth() != this->ImageWidth() ||
+      texture->getHeight() != this->ImageHeight())
+  {
+    this->DestroyIdTexture();
+    this->CreateIdTexture();
+  }
+
+  // the id texture sees the same visuals as the camera
+  if (this->dataPtr->idWorkspace)
+  {
+    auto nodeSeq = this->dataPtr->idWorkspace->getNodeSequence();
+    auto pass = nodeSeq[0]->_getPasses()[1]->getDefinition();
+    auto scenePass = dynamic_cast<const Ogre::CompositorPassSceneDef *>(pass);
+    const_cast<Ogre::CompositorPassSceneDef *>(scenePass)->mVisibilityMask =
+        renderVisibilityMask(this->VisibilityMask());
+  }
+}
+
+//////////////////////////////////////////////////
+void Ogre2BoundingBoxCamera::Render()
+{
+  Ogre2Camera::Render();
+
+  // rendered together with the image of the camera, and read back in
+  // PostRender
+  if (this->dataPtr->idWorkspace)
+  {
+    Ogre2RenderEngine::Instance()->RequestRender(
+        this->dataPtr->idWorkspace);
+  }
+}
+
+//////////////////////////////////////////////////
+void Ogre2BoundingBoxCamera::PostRender()
+{
+  BaseCamera::PostRender();
+  this->ReadIdTexture();
+}
+
+//////////////////////////////////////////////////
+void Ogre2BoundingBoxCamera::CreateIdTexture()
+{
+  unsigned int width = this->ImageWidth();
+  unsigned int height = this->ImageHeight();
+  if (width == 0u || height == 0u)
+    return;
+
+  if (!this->dataPtr->materialSwitcher)
+  {
+    this->dataPtr->materialSwitcher =
+        std::make_unique<Ogre2BoundingBoxMaterialSwitcher>(this->scene);
+  }
+
+  // ids are exact colors, so the texture has no anti-aliasing
+  this->dataPtr->idTexture = Ogre::TextureManager::getSingleton().createManual(
+      this->name + "_Ids",
+      Ogre::ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME,
+      Ogre::TEX_TYPE_2D, width, height, 0, Ogre::PF_R8G8B8,
+      Ogre::TU_RENDERTARGET, 0, false, 0);
+  Ogre::RenderTarget *rt =
+      this->dataPtr->idTexture->getBuffer()->getRenderTarget();
+  rt->addListener(this->dataPtr->materialSwitcher.get());
+
+  auto engine = Ogre2RenderEngine::Instance();
+  Ogre::CompositorManager2 *ogreCompMgr =
+      engine->OgreRoot()->getCompositorManager2();
+  this->dataPtr->idWorkspaceDef = this->name + "_IdWorkspace";
+  if (!ogreCompMgr->hasWorkspaceDefinition(this->dataPtr->idWorkspaceDef))
+  {
+    ogreCompMgr->createBasicWorkspaceDef(this->dataPtr->idWorkspaceDef,
+        Ogre::ColourValue(0.0f, 0.0f, 0.0f, 1.0f));
+  }
+  this->dataPtr->idWorkspace = ogreCompMgr->addWorkspace(
+      this->scene->OgreSceneManager(), rt, this->ogreCamera,
+      this->dataPtr->idWorkspaceDef, false);
+
+  this->dataPtr->idBuffer.resize(
+      Ogre::PixelUtil::getMemorySize(width, height, 1, Ogre::PF_BYTE_RGB));
+}
+
+//////////////////////////////////////////////////
+void Ogre2BoundingBoxCamera::DestroyIdTexture()
+{
+  auto engine = Ogre2RenderEngine::Instance();
+  Ogre::CompositorManager2 *ogreCompMgr =
+      engine->OgreRoot()->getCompositorManager2();
+  if (this->dataPtr->idWorkspace)
+  {
+    engine->CancelRenderRequest(this->dataPtr->idWorkspace);
+    ogreCompMgr->removeWorkspace(this->dataPtr->idWorkspace);
+    this->dataPtr->idWorkspace = nullptr;
+  }
+  if (this->dataPtr->idTexture)
+  {
+    auto &manager = Ogre::TextureManager::getSingleton();
+    manager.unload(this->dataPtr->idTexture->getName());
+    manager.remove(this->dataPtr->idTexture->getName());
+    this->dataPtr->idTexture.reset();
+  }
+}
+
+//////////////////////////////////////////////////
+void Ogre2BoundingBoxCamera::ReadIdTexture()
+{
+  if (!this->dataPtr->idTexture || !this->dataPtr->materialSwitcher)
+    return;
+
+  // make sure the requested frame is rendered
+  Ogre2RenderEngine::Instance()->FlushRenderRequests();
+
+  unsigned int width = this->dataPtr->idTexture->getWidth();
+  unsigned int height = this->dataPtr->idTexture->getHeight();
+  Ogre::PixelBox dstBox(width, height, 1, Ogre::PF_BYTE_RGB,
+      this->dataPtr->idBuffer.data());
+  this->dataPtr->idTexture->getBuffer()->getRenderTarget()->
+      copyContentsToMemory(dstBox, Ogre::RenderTarget::FB_FRONT);
+
+  // min and max pixels of each id, found in a single pass over the image
+  const std::vector<VisualPtr> &visuals =
+      this->dataPtr->materialSwitcher->visuals;
+  const unsigned int count = static_cast<unsigned int>(visuals.size());
+  std::vector<unsigned int> minX(count + 1u, width);
+  std::vector<unsigned int> minY(count + 1u, height);
+  std::vector<unsigned int> maxX(count + 1u, 0u);
+  std::vector<unsigned int> maxY(count + 1u, 0u);
+  const uint8_t *data = this->dataPtr->idBuffer.data();
+  for (unsigned int y = 0u; y < height; ++y)
+  {
+    for (unsigned int x = 0u; x < width; ++x, data += 3)
+    {
+      unsigned int id = (data[0] << 16u) | (data[1] << 8u) | data[2];
+      if (id == 0u || id > count)
+        continue;
+      minX[id] = std::min(minX[id], x);
+      minY[id] = std::min(minY[id], y);
+      maxX[id] = std::max(maxX[id], x);
+      maxY[id] = std::max(maxY[id], y);
+    }
+  }
+
+  // visible boxes cover whole pixels
+  std::vector<VisualPtr> seen;
+  std::vector<BoundingBox> visibleBoxes;
+  for (unsigned int id = 1u; id <= count; ++id)
+  {
+    if (minX[id] > maxX[id])
+      continue;
+    BoundingBox box;
+    box.type = BBT_VISIBLEBOX2D;
+    box.label = this->dataPtr->materialSwitcher->labels[id - 1u];
+    box.center.Set((minX[id] + maxX[id] + 1.0) * 0.5,
+        (minY[id] + maxY[id] + 1.0) * 0.5, 0.0);
+    box.size.Set(maxX[id] - minX[id] + 1.0, maxY[id] - minY[id] + 1.0, 0.0);
+    seen.push_back(visuals[id - 1u]);
+    visibleBoxes.push_back(box);
+  }
+
+  this->UpdateBoundingBoxes(seen, visibleBoxes);
+}
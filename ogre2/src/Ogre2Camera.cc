@@ -15,9 +15,14 @@
  *
  */
 
+#include <algorithm>
+#include <vector>
+
+#include "ignition/rendering/OcclusionBuffer.hh"
 #include "ignition/rendering/ogre2/Ogre2Camera.hh"
 #include "ignition/rendering/ogre2/Ogre2Conversions.hh"
 #include "ignition/rendering/ogre2/Ogre2Includes.hh"
+#include "ignition/rendering/ogre2/Ogre2RenderEngine.hh"
 // #include "ignition/rendering/ogre2/Ogre2Material.hh"
 #include "ignition/rendering/ogre2/Ogre2RenderTarget.hh"
 #include "ignition/rendering/ogre2/Ogre2Scene.hh"
@@ -27,11 +32,19 @@
 /// \brief Private data for the Ogre2Camera class
 class ignition::rendering::Ogre2CameraPrivate
 {
+  /// \brief Software depth buffer used for occlusion culling
+  public: OcclusionBuffer occlusionBuffer;
+
+  /// \brief Items hidden by occlusion culling for the current frame
+  public: std::vector<Ogre::MovableObject *> occludedItems;
 };
 
 using namespace ignition;
 using namespace rendering;
 
+/// \brief Width of the software depth buffer used for occlusion culling
+static const unsigned int kOcclusionBufferWidth = 256u;
+
 //////////////////////////////////////////////////
 Ogre2Camera::Ogre2Camera()
   : dataPtr(std::make_unique<Ogre2CameraPrivate>())
@@ -119,7 +132,90 @@ void Ogre2Camera::SetMaterial(const MaterialPtr &_material)
 //////////////////////////////////////////////////
 void Ogre2Camera::Render()
 {
+  // occluded items are hidden for all cameras, so a camera with occlusion
+  // culling is not rendered in the same frame as other cameras
+  auto engine = Ogre2RenderEngine::Instance();
+  if (this->occlusionCulling)
+  {
+    engine->FlushRenderRequests();
+    this->HideOccludedItems();
+  }
+
   this->renderTexture->Render();
+
+  if (this->occlusionCulling)
+    engine->FlushRenderRequests();
+  this->RestoreOccludedItems();
+}
+
+//////////////////////////////////////////////////
+void Ogre2Camera::HideOccludedItems()
+{
+  Ogre::SceneManager *ogreSceneManager = this->scene->OgreSceneManager();
+  if (!ogreSceneManager)
+    return;
+
+  uint32_t mask = renderVisibilityMask(this->VisibilityMask());
+  std::vector<Ogre::MovableObject *> occluders;
+  std::vector<Ogre::MovableObject *> candidates;
+  auto itor = ogreSceneManager->getMovableObjectIterator(
+      Ogre::ItemFactory::FACTORY_TYPE_NAME);
+  while (itor.hasMoreElements())
+  {
+    Ogre::MovableObject *object = itor.getNext();
+    if (!object->isVisible() || !object->getParentNode() ||
+        !(object->getVisibilityFlags() & mask))
+    {
+      continue;
+    }
+    if (object->getVisibilityFlags() & IGN_VISIBILITY_OCCLUDER)
+      occluders.push_back(object);
+    else
+      candidates.push_back(object);
+  }
+  if (occluders.empty() || candidates.empty())
+    return;
+
+  // keep the aspect ratio of the camera in the depth buffer
+  OcclusionBuffer &buffer = this->dataPtr->occlusionBuffer;
+  unsigned int height = std::max(1u, static_cast<unsigned int>(
+      kOcclusionBufferWidth / std::max(this->AspectRatio(), 1e-3)));
+  if (buffer.Width() != kOcclusionBufferWidth || buffer.Height() != height)
+    buffer.Resize(kOcclusionBufferWidth, height);
+
+  // compute the view matrix from the node poses since the ogre camera is
+  // only updated when the scene graph is rendered
+  buffer.Clear(this->ProjectionMatrix() * BaseCamera::ViewMatrix());
+  for (auto occluder : occluders)
+  {
+    Ogre::Aabb aabb = occluder->getLocalAabb();
+    buffer.AddOccluder(math::AxisAlignedBox(
+        Ogre2Conversions::Convert(aabb.getMinimum()),
+        Ogre2Conversions::Convert(aabb.getMaximum())),
+        Ogre2Conversions::Convert(
+        occluder->getParentNode()->_getFullTransformUpdated()));
+  }
+  buffer.BuildPyramid();
+
+  for (auto candidate : candidates)
+  {
+    Ogre::Aabb aabb = candidate->getWorldAabbUpdated();
+    if (buffer.IsOccluded(math::AxisAlignedBox(
+        Ogre2Conversions::Convert(aabb.getMinimum()),
+        Ogre2Conversions::Convert(aabb.getMaximum()))))
+    {
+      candidate->setVisible(false);
+      this->dataPtr->occludedItems.push_back(candidate);
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+void Ogre2Camera::RestoreOccludedItems()
+{
+  for (auto item : this->dataPtr->occludedItems)
+    item->setVisible(true);
+  this->dataPtr->occludedItems.clear();
 }
 
 //////////////////////////////////////////////////
@@ -24,9 +24,11 @@
 #endif
 
 #include <math.h>
+#include <algorithm>
 #include <ignition/math/Helpers.hh>
 
 #include "ignition/rendering/RenderTypes.hh"
+#include "ignition/rendering/Utils.hh"
 #include "ignition/rendering/ogre2/Ogre2Conversions.hh"
 #include "ignition/rendering/ogre2/Ogre2DepthCamera.hh"
 #include "ignition/rendering/ogre2/Ogre2GaussianNoisePass.hh"
@@ -34,6 +36,7 @@
 #include "ignition/rendering/ogre2/Ogre2ParticleEmitter.hh"
 #include "ignition/rendering/ogre2/Ogre2RenderEngine.hh"
 #include "ignition/rendering/ogre2/Ogre2RenderTarget.hh"
+#include "ignition/rendering/ogre2/Ogre2RenderTexturePool.hh"
 #include "ignition/rendering/ogre2/Ogre2RenderTypes.hh"
 #include "ignition/rendering/ogre2/Ogre2Scene.hh"
 #include "ignition/rendering/ogre2/Ogre2Sensor.hh"
@@ -103,9 +106,31 @@ class ignition::rendering::Ogre2DepthCameraPrivate
   /// \brief Compositor workspace.
   public: Ogre::CompositorWorkspace *ogreCompositorWorkspace = nullptr;
 
-  /// \brief Output texture with depth and color data
+  /// \brief Copy the output texture to the depth buffer
+  public: void ReadDepthBuffer();
+
+  /// \brief Output texture with depth and color data, acquired from the
+  /// render texture pool of the scene
   public: Ogre::TexturePtr ogreDepthTexture;
 
+  /// \brief Pool the output texture is acquired from
+  public: Ogre2RenderTexturePoolPtr texturePool;
+
+  /// \brief Depth, color and particle textures rendered and sampled by the
+  /// base compositor node, acquired from the render texture pool
+  public: std::vector<Ogre::TexturePtr> nodeInputTextures;
+
+  /// \brief True while the node input textures are borrowed
+  public: bool nodeInputsBorrowed = false;
+
+  /// \brief Render the requested frame and return the node input textures
+  /// to the pool
+  /// \param[in] _owner Camera the textures were acquired for
+  public: void ReturnNodeInputs(const void *_owner);
+
+  /// \brief True if the depth buffer already holds the last rendered frame
+  public: bool depthBufferRead = false;
+
   /// \brief Dummy render texture for the depth data
   public: RenderTexturePtr depthTexture;
 
@@ -142,6 +167,47 @@ class ignition::rendering::Ogre2DepthCameraPrivate
 using namespace ignition;
 using namespace rendering;
 
+/// \brief Index of the particle texture in the node input textures
+static const unsigned int kParticleTextureInput = 2u;
+
+//////////////////////////////////////////////////
+void Ogre2DepthCameraPrivate::ReturnNodeInputs(const void *_owner)
+{
+  if (!this->nodeInputsBorrowed)
+    return;
+  this->nodeInputsBorrowed = false;
+
+  // the particle noise listener must be attached while the frame renders
+  Ogre2RenderEngine::Instance()->FlushRenderRequests();
+  this->nodeInputTextures[kParticleTextureInput]->getBuffer()->
+      getRenderTarget()->removeListener(this->particleNoiseListener.get());
+  for (auto &texture : this->nodeInputTextures)
+    this->texturePool->Return(_owner, texture);
+}
+
+//////////////////////////////////////////////////
+void Ogre2DepthCameraPrivate::ReadDepthBuffer()
+{
+  // make sure the requested frame is rendered
+  Ogre2RenderEngine::Instance()->FlushRenderRequests();
+
+  unsigned int width = this->ogreDepthTexture->getWidth();
+  unsigned int height = this->ogreDepthTexture->getHeight();
+  unsigned int channelCount = PixelUtil::ChannelCount(PF_FLOAT32_RGBA);
+
+  if (!this->depthBuffer)
+  {
+    this->depthBuffer = new float[width * height * channelCount];
+  }
+  Ogre::PixelBox dstBox(width, height,
+        1, Ogre::PF_FLOAT32_RGBA, this->depthBuffer);
+
+  // blit data from gpu to cpu
+  auto rt = this->ogreDepthTexture->getBuffer()->getRenderTarget();
+  rt->copyContentsToMemory(dstBox, Ogre::RenderTarget::FB_AUTO);
+  this->depthBufferRead = true;
+}
+
 //////////////////////////////////////////////////
 void Ogre2DepthGaussianNoisePass::PreRender()
 {
@@ -290,16 +356,28 @@ void Ogre2DepthCamera::Destroy()
   Ogre::CompositorManager2 *ogreCompMgr = ogreRoot->getCompositorManager2();
 
   // remove depth texture, material, compositor
-  if (this->dataPtr->ogreDepthTexture)
-  {
-    Ogre::TextureManager::getSingleton().remove(
-        this->dataPtr->ogreDepthTexture->getName());
-  }
   if (this->dataPtr->ogreCompositorWorkspace)
   {
+    engine->CancelRenderRequest(this->dataPtr->ogreCompositorWorkspace);
     ogreCompMgr->removeWorkspace(
         this->dataPtr->ogreCompositorWorkspace);
   }
+  if (this->dataPtr->ogreDepthTexture)
+  {
+    this->dataPtr->texturePool->Release(this,
+        this->dataPtr->ogreDepthTexture);
+    this->dataPtr->ogreDepthTexture.reset();
+  }
+  if (this->dataPtr->nodeInputsBorrowed)
+  {
+    this->dataPtr->nodeInputTextures[kParticleTextureInput]->getBuffer()->
+        getRenderTarget()->removeListener(
+        this->dataPtr->particleNoiseListener.get());
+    this->dataPtr->nodeInputsBorrowed = false;
+  }
+  for (auto &texture : this->dataPtr->nodeInputTextures)
+    this->dataPtr->texturePool->Release(this, texture);
+  this->dataPtr->nodeInputTextures.clear();
 
   if (this->dataPtr->depthMaterial)
   {
@@ -482,13 +560,14 @@ void Ogre2DepthCamera::CreateDepthTexture()
     //
     // compositor_node DepthCamera
     // {
+    //   // inputs are acquired from the render texture pool of the scene
+    //   in 0 depthTexture // PF_D32_FLOAT
+    //   in 1 colorTexture // PF_R8G8B8, depth_texture PF_D32_FLOAT
+    //   in 2 particleTexture // PF_L8, half size
     //   texture rt0 target_width target_height PF_FLOAT32_RGBA
     //   texture rt1 target_width target_height PF_FLOAT32_RGBA
-    //   texture colorTexture target_width target_height PF_R8G8B8
-    //       depth_texture depth_format PF_D32_FLOAT
-    //   texture depthTexture target_width target_height PF_D32_FLOAT
-    //   texture particleTexture target_width target_height PF_L8
-    //   // particleDepthTexture shares same depth buffer as particleTexture
+    //   // particleDepthTexture has its own depth buffer, so it is not
+    //   // shared
     //   texture particleDepthTexture target_width target_height PF_D32_FLOAT
     //   target colorTexture
     //   {
@@ -588,64 +667,13 @@ void Ogre2DepthCamera::CreateDepthTexture()
     rt1TexDef->depthBufferFormat = Ogre::PF_UNKNOWN;
     rt1TexDef->fsaaExplicitResolve = false;
 
-    Ogre::TextureDefinitionBase::TextureDefinition *depthTexDef =
-        baseNodeDef->addTextureDefinition("depthTexture");
-    depthTexDef->textureType = Ogre::TEX_TYPE_2D;
-    depthTexDef->width = 0;
-    depthTexDef->height = 0;
-    depthTexDef->depth = 1;
-    depthTexDef->numMipmaps = 0;
-    depthTexDef->widthFactor = 1;
-    depthTexDef->heightFactor = 1;
-    depthTexDef->formatList = {Ogre::PF_D32_FLOAT};
-    depthTexDef->fsaa = 0;
-    depthTexDef->uav = false;
-    depthTexDef->automipmaps = false;
-    depthTexDef->hwGammaWrite = Ogre::TextureDefinitionBase::BoolFalse;
-    depthTexDef->depthBufferId = Ogre::DepthBuffer::POOL_DEFAULT;
-    depthTexDef->depthBufferFormat = Ogre::PF_UNKNOWN;
-    depthTexDef->fsaaExplicitResolve = false;
-
-    Ogre::TextureDefinitionBase::TextureDefinition *colorTexDef =
-        baseNodeDef->addTextureDefinition("colorTexture");
-    colorTexDef->textureType = Ogre::TEX_TYPE_2D;
-    colorTexDef->width = 0;
-    colorTexDef->height = 0;
-    colorTexDef->depth = 1;
-    colorTexDef->numMipmaps = 0;
-    colorTexDef->widthFactor = 1;
-    colorTexDef->heightFactor = 1;
-    colorTexDef->formatList = {Ogre::PF_R8G8B8};
-    colorTexDef->fsaa = 0;
-    colorTexDef->uav = false;
-    colorTexDef->automipmaps = false;
-    // Enable gamma write to avoid discretization in the color values
-    // Note we are using low level materials in quad pass so also had to perform
-    // gamma correction in the fragment shaders (depth_camera_fs.glsl)
-    colorTexDef->hwGammaWrite = Ogre::TextureDefinitionBase::BoolTrue;
-    colorTexDef->depthBufferId = Ogre::DepthBuffer::POOL_DEFAULT;
-    colorTexDef->depthBufferFormat = Ogre::PF_D32_FLOAT;
-    colorTexDef->preferDepthTexture = true;
-    colorTexDef->fsaaExplicitResolve = false;
-
-    Ogre::TextureDefinitionBase::TextureDefinition *particleTexDef =
-        baseNodeDef->addTextureDefinition("particleTexture");
-    particleTexDef->textureType = Ogre::TEX_TYPE_2D;
-    particleTexDef->width = 0;
-    particleTexDef->height = 0;
-    particleTexDef->depth = 1;
-    particleTexDef->numMipmaps = 0;
-    particleTexDef->widthFactor = 0.5;
-    particleTexDef->heightFactor = 0.5;
-    particleTexDef->formatList = {Ogre::PF_L8};
-    particleTexDef->fsaa = 0;
-    particleTexDef->uav = false;
-    particleTexDef->automipmaps = false;
-    particleTexDef->hwGammaWrite = Ogre::TextureDefinitionBase::BoolFalse;
-    particleTexDef->depthBufferId = Ogre::DepthBuffer::POOL_DEFAULT;
-    particleTexDef->depthBufferFormat = Ogre::PF_UNKNOWN;
-    particleTexDef->preferDepthTexture = false;
-    particleTexDef->fsaaExplicitResolve = false;
+    // the depth, color and particle textures are shared with other sensors
+    baseNodeDef->addTextureSourceName("depthTexture", 0,
+        Ogre::TextureDefinitionBase::TEXTURE_INPUT);
+    baseNodeDef->addTextureSourceName("colorTexture", 1,
+        Ogre::TextureDefinitionBase::TEXTURE_INPUT);
+    baseNodeDef->addTextureSourceName("particleTexture",
+        kParticleTextureInput, Ogre::TextureDefinitionBase::TEXTURE_INPUT);
 
     Ogre::TextureDefinitionBase::TextureDefinition *particleDepthTexDef =
         baseNodeDef->addTextureDefinition("particleDepthTexture");
@@ -681,7 +709,8 @@ void Ogre2DepthCamera::CreateDepthTexture()
       Ogre::CompositorPassSceneDef *passScene =
           static_cast<Ogre::CompositorPassSceneDef *>(
           colorTargetDef->addPass(Ogre::PASS_SCENE));
-      passScene->mVisibilityMask = IGN_VISIBILITY_ALL;
+      passScene->mVisibilityMask = IGN_VISIBILITY_ALL &
+          renderVisibilityMask(this->VisibilityMask());
 
       // todo(anyone) Fix shadows. The shadow compositor node gets rebuilt
       // when the number of shadow-casting light changes so we end up with
@@ -708,7 +737,8 @@ void Ogre2DepthCamera::CreateDepthTexture()
           depthTargetDef->addPass(Ogre::PASS_SCENE));
       // depth texute does not contain particles
       passScene->mVisibilityMask = IGN_VISIBILITY_ALL
-          & ~Ogre2ParticleEmitter::kParticleVisibilityFlags;
+          & ~Ogre2ParticleEmitter::kParticleVisibilityFlags
+          & renderVisibilityMask(this->VisibilityMask());
     }
 
     Ogre::CompositorTargetDef *particleTargetDef =
@@ -726,7 +756,8 @@ void Ogre2DepthCamera::CreateDepthTexture()
           static_cast<Ogre::CompositorPassSceneDef *>(
           particleTargetDef->addPass(Ogre::PASS_SCENE));
       passScene->mVisibilityMask =
-          Ogre2ParticleEmitter::kParticleVisibilityFlags;
+          Ogre2ParticleEmitter::kParticleVisibilityFlags &
+          this->VisibilityMask();
     }
 
     Ogre::CompositorTargetDef *particleDepthTargetDef =
@@ -745,7 +776,8 @@ void Ogre2DepthCamera::CreateDepthTexture()
           static_cast<Ogre::CompositorPassSceneDef *>(
           particleDepthTargetDef->addPass(Ogre::PASS_SCENE));
       passScene->mVisibilityMask =
-          Ogre2ParticleEmitter::kParticleVisibilityFlags;
+          Ogre2ParticleEmitter::kParticleVisibilityFlags &
+          this->VisibilityMask();
     }
 
     // rt0 target - converts depth to xyz
@@ -837,6 +869,9 @@ void Ogre2DepthCamera::CreateDepthTexture()
     // workspace DepthCameraWorkspace
     // {
     //   connect_output DepthCameraFinal 0
+    //   connect_external 1 DepthCamera 0
+    //   connect_external 2 DepthCamera 1
+    //   connect_external 3 DepthCamera 2
     //   connect DepthCamera 0 DepthCameraFinal 1
     // }
     Ogre::CompositorWorkspaceDef *workDef =
@@ -844,6 +879,8 @@ void Ogre2DepthCamera::CreateDepthTexture()
 
     workDef->connect(baseNodeDefName, 0,  finalNodeDefName, 1);
     workDef->connectExternal(0, finalNodeDefName, 0);
+    for (unsigned int i = 0u; i <= kParticleTextureInput; ++i)
+      workDef->connectExternal(1u + i, baseNodeDefName, i);
   }
   Ogre::CompositorWorkspaceDef *wsDef =
       ogreCompMgr->getWorkspaceDefinition(wsDefName);
@@ -854,50 +891,73 @@ void Ogre2DepthCamera::CreateDepthTexture()
            << " for " << this->Name();
   }
 
-  // create render texture - these textures pack the range data
-  this->dataPtr->ogreDepthTexture =
-    Ogre::TextureManager::getSingleton().createManual(
-    this->Name() + "_depth", "General", Ogre::TEX_TYPE_2D,
-    this->ImageWidth(), this->ImageHeight(), 1, 0,
-    Ogre::PF_FLOAT32_RGBA, Ogre::TU_RENDERTARGET,
-    0, false, 0, Ogre::BLANKSTRING, false, true);
-
-  Ogre::RenderTarget *rt =
-    this->dataPtr->ogreDepthTexture->getBuffer()->getRenderTarget();
+  // create render texture - these textures pack the range data.
+  // The textures are only needed while the camera is updated so they are
+  // shared with the other sensors of the same size
+  unsigned int width = this->ImageWidth();
+  unsigned int height = this->ImageHeight();
+  Ogre2RenderTexturePoolPtr pool = this->scene->RenderTexturePool();
+  this->dataPtr->texturePool = pool;
+  this->dataPtr->ogreDepthTexture = pool->Acquire(
+      this, width, height, Ogre::PF_FLOAT32_RGBA);
+  // enable gamma write on the color texture to avoid discretization in the
+  // color values. Note we are using low level materials in quad pass so
+  // also had to perform gamma correction in the fragment shaders
+  // (depth_camera_fs.glsl)
+  this->dataPtr->nodeInputTextures = {
+      pool->Acquire(this, width, height, Ogre::PF_D32_FLOAT),
+      pool->Acquire(this, width, height, Ogre::PF_R8G8B8, true,
+          Ogre::PF_D32_FLOAT),
+      pool->Acquire(this, std::max(width / 2u, 1u),
+          std::max(height / 2u, 1u), Ogre::PF_L8)};
+
+  Ogre::CompositorChannelVec externalTargets;
+  externalTargets.push_back(
+      Ogre2RenderTexturePool::Channel(this->dataPtr->ogreDepthTexture));
+  for (auto &texture : this->dataPtr->nodeInputTextures)
+    externalTargets.push_back(Ogre2RenderTexturePool::Channel(texture));
 
   // create compositor worksspace
   this->dataPtr->ogreCompositorWorkspace =
       ogreCompMgr->addWorkspace(this->scene->OgreSceneManager(),
-      rt, this->ogreCamera, wsDefName, false);
-
-  // add the listener
-  Ogre::CompositorNode *node =
-      this->dataPtr->ogreCompositorWorkspace->getNodeSequence()[0];
-  auto channelsTex = node->getLocalTextures();
-
-  for (auto c : channelsTex)
-  {
-    if (c.textures[0]->getSrcFormat() == Ogre::PF_L8)
-    {
-      // add particle noise / scatter effects listener so we can set the
-      // amount of noise based on size of emitter
-      this->dataPtr->particleNoiseListener.reset(
-          new Ogre2ParticleNoiseListener(this->scene,
-          this->ogreCamera, this->dataPtr->depthMaterial));
-      c.target->addListener(this->dataPtr->particleNoiseListener.get());
-      break;
-    }
-  }
+      externalTargets, this->ogreCamera, wsDefName, false);
+
+  // particle noise / scatter effects listener so we can set the amount of
+  // noise based on size of emitter. It is added to the particle texture
+  // while the camera borrows it, see Render
+  this->dataPtr->particleNoiseListener.reset(
+      new Ogre2ParticleNoiseListener(this->scene,
+      this->ogreCamera, this->dataPtr->depthMaterial));
 }
 
 //////////////////////////////////////////////////
 void Ogre2DepthCamera::Render()
 {
-  // update the compositors
-  this->dataPtr->ogreCompositorWorkspace->setEnabled(true);
-  auto engine = Ogre2RenderEngine::Instance();
-  engine->OgreRoot()->renderOneFrame();
-  this->dataPtr->ogreCompositorWorkspace->setEnabled(false);
+  // borrow the node inputs. Other sensors render into them too, so the
+  // particle noise listener is only attached while the camera holds them
+  for (auto &texture : this->dataPtr->nodeInputTextures)
+  {
+    this->dataPtr->texturePool->Borrow(this, texture,
+        [this]() { this->dataPtr->ReturnNodeInputs(this); });
+  }
+  if (!this->dataPtr->nodeInputsBorrowed)
+  {
+    this->dataPtr->nodeInputTextures[kParticleTextureInput]->getBuffer()->
+        getRenderTarget()->addListener(
+        this->dataPtr->particleNoiseListener.get());
+    this->dataPtr->nodeInputsBorrowed = true;
+  }
+
+  // borrow the output texture. If another sensor borrows it before
+  // PostRender, the depth data is read back right away
+  this->dataPtr->depthBufferRead = false;
+  this->dataPtr->texturePool->Borrow(this, this->dataPtr->ogreDepthTexture,
+      [this]() { this->dataPtr->ReadDepthBuffer(); });
+
+  // update the compositors together with the other sensors, the depth
+  // data is read back in PostRender
+  Ogre2RenderEngine::Instance()->RequestRender(
+      this->dataPtr->ogreCompositorWorkspace);
 }
 
 //////////////////////////////////////////////////
@@ -913,34 +973,11 @@ void Ogre2DepthCamera::PreRender()
       this->dataPtr->ogreCompositorBaseNodeDef,
       this->dataPtr->ogreCompositorFinalNodeDef,
       this->dataPtr->renderPasses,
-      this->dataPtr->renderPassDirty);
+      this->dataPtr->renderPassDirty,
+      static_cast<unsigned int>(this->dataPtr->nodeInputTextures.size()));
   for (auto &pass : this->dataPtr->renderPasses)
     pass->PreRender();
 
-
-  // add the particle noise listener again if worksapce is recreated due to
-  // dirty render pass
-  if (this->dataPtr->renderPassDirty)
-  {
-    Ogre::CompositorNode *node =
-        this->dataPtr->ogreCompositorWorkspace->getNodeSequence()[0];
-    auto channelsTex = node->getLocalTextures();
-
-    for (auto c : channelsTex)
-    {
-      if (c.textures[0]->getSrcFormat() == Ogre::PF_L8)
-      {
-        // add particle noise / scatter effects listener so we can set the
-        // amount of noise based on size of emitter
-        this->dataPtr->particleNoiseListener.reset(
-            new Ogre2ParticleNoiseListener(this->scene,
-            this->ogreCamera, this->dataPtr->depthMaterial));
-        c.target->addListener(this->dataPtr->particleNoiseListener.get());
-        break;
-      }
-    }
-  }
-
   this->dataPtr->renderPassDirty = false;
 }
 
@@ -957,16 +994,13 @@ void Ogre2DepthCamera::PostRender()
   int len = width * height;
   unsigned int channelCount = PixelUtil::ChannelCount(format);
 
-  if (!this->dataPtr->depthBuffer)
-  {
-    this->dataPtr->depthBuffer = new float[len * channelCount];
-  }
-  Ogre::PixelBox dstBox(width, height,
-        1, imageFormat, this->dataPtr->depthBuffer);
-
-  // blit data from gpu to cpu
-  auto rt = this->dataPtr->ogreDepthTexture->getBuffer()->getRenderTarget();
-  rt->copyContentsToMemory(dstBox, Ogre::RenderTarget::FB_AUTO);
+  // blit data from gpu to cpu, unless it was already done when another
+  // sensor borrowed the output texture
+  if (!this->dataPtr->depthBufferRead)
+    this->dataPtr->ReadDepthBuffer();
+  this->dataPtr->depthBufferRead = false;
+  this->dataPtr->texturePool->Return(this, this->dataPtr->ogreDepthTexture);
+  this->dataPtr->ReturnNodeInputs(this);
 
   if (!this->dataPtr->depthImage)
   {
@@ -32,6 +32,10 @@
 #include "ignition/rendering/ogre2/Ogre2RenderEngine.hh"
 #include "ignition/rendering/ogre2/Ogre2Scene.hh"
 
+/// \brief Number of floats of each vertex in the vertex buffer: position,
+/// normal and texture coordinates
+static const unsigned int kVertexStride = 8u;
+
 /// \brief Private implementation
 class ignition::rendering::Ogre2DynamicRenderablePrivate
 {
@@ -41,11 +45,15 @@ class ignition::rendering::Ogre2DynamicRenderablePrivate
   /// \brief List of vertices for the mesh
   public: std::vector<ignition::math::Vector3d> vertices;
 
+  /// \brief Texture coordinates of each vertex
+  public: std::vector<ignition::math::Vector2d> texCoords;
+
   /// \brief Used to indicate if the lines require an update
   public: bool dirty = false;
 
   /// \brief Render operation type
-  public: Ogre::OperationType operationType;
+  public: Ogre::OperationType operationType =
+      Ogre::OperationType::OT_LINE_STRIP;
 
   /// \brief Ogre submesh
   public: Ogre::SubMesh *subMesh = nullptr;
@@ -230,7 +238,7 @@ void Ogre2DynamicRenderable::UpdateBuffer()
 
     this->DestroyBuffer();
 
-    unsigned int size = this->dataPtr->vertexBufferCapacity * 6;
+    unsigned int size = this->dataPtr->vertexBufferCapacity * kVertexStride;
     this->dataPtr->vbuffer = new float[size];
     memset(this->dataPtr->vbuffer, 0, size * sizeof(float));
 
@@ -243,6 +251,8 @@ void Ogre2DynamicRenderable::UpdateBuffer()
         Ogre::VertexElement2(Ogre::VET_FLOAT3, Ogre::VES_POSITION));
     vertexElements.push_back(
         Ogre::VertexElement2(Ogre::VET_FLOAT3, Ogre::VES_NORMAL));
+    vertexElements.push_back(Ogre::VertexElement2(Ogre::VET_FLOAT2,
+        Ogre::VES_TEXTURE_COORDINATES));
 
     // create vertex buffer
     this->dataPtr->vertexBuffer = vaoManager->createVertexBuffer(
@@ -272,12 +282,16 @@ void Ogre2DynamicRenderable::UpdateBuffer()
   // fill vertices
   for (unsigned int i = 0; i < vertexCount; ++i)
   {
-    unsigned int idx = i*6;
+    unsigned int idx = i * kVertexStride;
     Ogre::Vector3 v = Ogre2Conversions::Convert(this->dataPtr->vertices[i]);
     vertices[idx] = v.x;
     vertices[idx+1] = v.y;
     vertices[idx+2] = v.z;
 
+    const math::Vector2d &uv = this->dataPtr->texCoords[i];
+    vertices[idx+6] = uv.X();
+    vertices[idx+7] = uv.Y();
+
     bbox.merge(v);
   }
 
@@ -289,7 +303,7 @@ void Ogre2DynamicRenderable::UpdateBuffer()
     for (unsigned int i = vertexCount; i < this->dataPtr->vertexBufferCapacity;
         ++i)
     {
-      unsigned int idx = i * 6;
+      unsigned int idx = i * kVertexStride;
       vertices[idx] = lastVertex.X();
       vertices[idx+1] = lastVertex.Y();
       vertices[idx+2] = lastVertex.Z();
@@ -297,6 +311,9 @@ void Ogre2DynamicRenderable::UpdateBuffer()
       vertices[idx+3] = 0;
       vertices[idx+4] = 0;
       vertices[idx+5] = 1;
+
+      vertices[idx+6] = 0;
+      vertices[idx+7] = 0;
     }
   }
 
@@ -336,6 +353,7 @@ void Ogre2DynamicRenderable::UpdateBuffer()
 //////////////////////////////////////////////////
 void Ogre2DynamicRenderable::SetOperationType(MarkerType _opType)
 {
+  Ogre::OperationType prevOpType = this->dataPtr->operationType;
   switch (_opType)
   {
     case MT_POINTS:
@@ -366,6 +384,13 @@ void Ogre2DynamicRenderable::SetOperationType(MarkerType _opType)
       ignerr << "Unknown render operation type[" << _opType << "]\n";
       return;
   }
+
+  // the operation type is part of the vao, so it needs to be recreated
+  if (this->dataPtr->vao && prevOpType != this->dataPtr->operationType)
+  {
+    this->dataPtr->vertexBufferCapacity = 0;
+    this->dataPtr->dirty = true;
+  }
 }
 
 //////////////////////////////////////////////////
@@ -408,6 +433,7 @@ void Ogre2DynamicRenderable::AddPoint(const ignition::math::Vector3d &_pt,
                                       const ignition::math::Color &_color)
 {
   this->dataPtr->vertices.push_back(_pt);
+  this->dataPtr->texCoords.push_back(ignition::math::Vector2d::Zero);
 
   // todo(anyone)
   // setting material works but vertex coloring does not work yet.
@@ -462,6 +488,22 @@ void Ogre2DynamicRenderable::SetColor(unsigned int _index,
   // this->dataPtr->dirty = true;
 }
 
+/////////////////////////////////////////////////
+void Ogre2DynamicRenderable::SetTexCoord(unsigned int _index,
+    const ignition::math::Vector2d &_texCoord)
+{
+  if (_index >= this->dataPtr->texCoords.size())
+  {
+    ignerr << "Point index[" << _index << "] is out of bounds[0-"
+           << this->dataPtr->texCoords.size()-1 << "]\n";
+    return;
+  }
+
+  this->dataPtr->texCoords[_index] = _texCoord;
+
+  this->dataPtr->dirty = true;
+}
+
 /////////////////////////////////////////////////
 ignition::math::Vector3d Ogre2DynamicRenderable::Point(
     const unsigned int _index) const
@@ -492,6 +534,7 @@ void Ogre2DynamicRenderable::Clear()
     return;
 
   this->dataPtr->vertices.clear();
+  this->dataPtr->texCoords.clear();
   this->dataPtr->colors.clear();
   this->dataPtr->dirty = true;
 }
@@ -531,13 +574,15 @@ void Ogre2DynamicRenderable::GenerateNormals(Ogre::OperationType _opType,
   const std::vector<math::Vector3d> &_vertices, float *_vbuffer)
 {
   unsigned int vertexCount = _vertices.size();
-  // Each vertex occupies 6 elements in the vbuffer float array:
+  // Each vertex occupies kVertexStride elements in the vbuffer float array:
   // vbuffer[i]   : position x
   // vbuffer[i+1] : position y
   // vbuffer[i+2] : position z
   // vbuffer[i+3] : normal x
   // vbuffer[i+4] : normal y
   // vbuffer[i+5] : normal z
+  // vbuffer[i+6] : texture coordinate u
+  // vbuffer[i+7] : texture coordinate v
   switch (_opType)
   {
     case Ogre::OperationType::OT_POINT_LIST:
@@ -552,9 +597,9 @@ void Ogre2DynamicRenderable::GenerateNormals(Ogre::OperationType _opType,
       for (unsigned int i = 0; i < vertexCount / 3; ++i)
       {
         unsigned int idx = i*3;
-        unsigned int idx1 = idx * 6;
-        unsigned int idx2 = idx1 + 6;
-        unsigned int idx3 = idx2 + 6;
+        unsigned int idx1 = idx * kVertexStride;
+        unsigned int idx2 = idx1 + kVertexStride;
+        unsigned int idx3 = idx2 + kVertexStride;
         math::Vector3d v1 = _vertices[idx];
         math::Vector3d v2 = _vertices[idx+1];
         math::Vector3d v3 = _vertices[idx+2];
@@ -589,20 +634,20 @@ void Ogre2DynamicRenderable::GenerateNormals(Ogre::OperationType _opType,
         // For even n, vertices n+1, n, and n+2 define triangle n.
         unsigned int idx1;
         unsigned int idx2;
-        unsigned int idx3 = (i+2) * 6;
+        unsigned int idx3 = (i+2) * kVertexStride;
         if (even)
         {
           v1 = _vertices[i+1];
           v2 = _vertices[i];
-          idx1 = (i+1) * 6;
-          idx2 = i*6;
+          idx1 = (i+1) * kVertexStride;
+          idx2 = i * kVertexStride;
         }
         else
         {
           v1 = _vertices[i];
           v2 = _vertices[i+1];
-          idx1 = i*6;
-          idx2 = (i+1) * 6;
+          idx1 = i * kVertexStride;
+          idx2 = (i+1) * kVertexStride;
         }
         even = !even;
 
@@ -641,8 +686,8 @@ void Ogre2DynamicRenderable::GenerateNormals(Ogre::OperationType _opType,
 
       for (unsigned int i = 0; i < vertexCount - 2; ++i)
       {
-        unsigned int idx2 = (i+1) * 6;
-        unsigned int idx3 = idx2 + 6;
+        unsigned int idx2 = (i+1) * kVertexStride;
+        unsigned int idx3 = idx2 + kVertexStride;
         math::Vector3d v2 = _vertices[i+1];
         math::Vector3d v3 = _vertices[i+2];
         math::Vector3d n = (v1 - v2).Cross((v1 - v3));
@@ -15,6 +15,9 @@
  *
 */
 
+#include <algorithm>
+#include <vector>
+
 #include <ignition/math/Vector2.hh>
 #include <ignition/math/Vector3.hh>
 
@@ -25,10 +28,12 @@
 #include "ignition/rendering/ogre2/Ogre2GpuRays.hh"
 #include "ignition/rendering/ogre2/Ogre2RenderEngine.hh"
 #include "ignition/rendering/RenderTypes.hh"
+#include "ignition/rendering/Utils.hh"
 #include "ignition/rendering/ogre2/Ogre2Conversions.hh"
 #include "ignition/rendering/ogre2/Ogre2Includes.hh"
 #include "ignition/rendering/ogre2/Ogre2ParticleEmitter.hh"
 #include "ignition/rendering/ogre2/Ogre2RenderTarget.hh"
+#include "ignition/rendering/ogre2/Ogre2RenderTexturePool.hh"
 #include "ignition/rendering/ogre2/Ogre2RenderTypes.hh"
 #include "ignition/rendering/ogre2/Ogre2Scene.hh"
 #include "ignition/rendering/ogre2/Ogre2Sensor.hh"
@@ -138,12 +143,36 @@ class ignition::rendering::Ogre2GpuRaysPrivate
   /// \brief 2nd pass compositor workspace.
   public: Ogre::CompositorWorkspace *ogreCompositorWorkspace2nd = nullptr;
 
+  /// \brief Copy the second pass texture to the gpu rays buffer
+  /// \param[in] _channels Number of channels of the buffer
+  public: void ReadGpuRaysBuffer(unsigned int _channels);
+
   /// \brief An array of first pass textures. One for each cubemap camera.
   public: Ogre::TexturePtr firstPassTextures[6];
 
   /// \brief Second pass texture.
   public: Ogre::TexturePtr secondPassTexture;
 
+  /// \brief Pool the first and second pass textures are acquired from
+  public: Ogre2RenderTexturePoolPtr texturePool;
+
+  /// \brief Depth, color, particle depth and particle textures rendered
+  /// and sampled by the 1st pass compositor node, acquired from the render
+  /// texture pool. One set for each cubemap camera.
+  public: std::vector<Ogre::TexturePtr> nodeInputTextures[6];
+
+  /// \brief True while the 1st pass textures and node inputs are borrowed
+  public: bool firstPassBorrowed = false;
+
+  /// \brief Render the requested frame and return the 1st pass textures
+  /// and node inputs to the pool
+  /// \param[in] _owner Sensor the textures were acquired for
+  public: void ReturnFirstPass(const void *_owner);
+
+  /// \brief True if the gpu rays buffer already holds the last rendered
+  /// frame
+  public: bool gpuRaysBufferRead = false;
+
   /// \brief Pointer to the ogre camera
   public: Ogre::Camera *ogreCamera = nullptr;
 
@@ -177,6 +206,50 @@ class ignition::rendering::Ogre2GpuRaysPrivate
 using namespace ignition;
 using namespace rendering;
 
+/// \brief Index of the color texture in the node input textures
+static const unsigned int kColorTextureInput = 1u;
+
+//////////////////////////////////////////////////
+void Ogre2GpuRaysPrivate::ReturnFirstPass(const void *_owner)
+{
+  if (!this->firstPassBorrowed)
+    return;
+  this->firstPassBorrowed = false;
+
+  // the listeners must be attached while the frame renders, and the 2nd
+  // pass must have sampled the 1st pass textures
+  Ogre2RenderEngine::Instance()->FlushRenderRequests();
+  for (auto i : this->cubeFaceIdx)
+  {
+    Ogre::RenderTarget *rt = this->nodeInputTextures[i][kColorTextureInput]->
+        getBuffer()->getRenderTarget();
+    rt->removeListener(this->laserRetroMaterialSwitcher[i].get());
+    rt->removeListener(this->particleNoiseListener[i].get());
+    for (auto &texture : this->nodeInputTextures[i])
+      this->texturePool->Return(_owner, texture);
+    this->texturePool->Return(_owner, this->firstPassTextures[i]);
+  }
+}
+
+//////////////////////////////////////////////////
+void Ogre2GpuRaysPrivate::ReadGpuRaysBuffer(unsigned int _channels)
+{
+  // make sure the requested frame is rendered
+  Ogre2RenderEngine::Instance()->FlushRenderRequests();
+
+  if (!this->gpuRaysBuffer)
+  {
+    this->gpuRaysBuffer = new float[this->w2nd * this->h2nd * _channels];
+  }
+  Ogre::PixelBox dstBox(this->w2nd, this->h2nd,
+        1, Ogre::PF_FLOAT32_RGB, this->gpuRaysBuffer);
+
+  // blit data from gpu to cpu
+  auto rt = this->secondPassTexture->getBuffer()->getRenderTarget();
+  rt->copyContentsToMemory(dstBox, Ogre::RenderTarget::FB_FRONT);
+  this->gpuRaysBufferRead = true;
+}
+
 
 //////////////////////////////////////////////////
 Ogre2LaserRetroMaterialSwitcher::Ogre2LaserRetroMaterialSwitcher(
@@ -359,17 +432,34 @@ void Ogre2GpuRays::Destroy()
   {
     if (this->dataPtr->firstPassTextures[i])
     {
-      Ogre::TextureManager::getSingleton().remove(
-          this->dataPtr->firstPassTextures[i]->getName());
+      this->dataPtr->texturePool->Release(this,
+          this->dataPtr->firstPassTextures[i]);
       this->dataPtr->firstPassTextures[i].reset();
     }
     if (this->dataPtr->ogreCompositorWorkspace1st[i])
     {
+      engine->CancelRenderRequest(
+          this->dataPtr->ogreCompositorWorkspace1st[i]);
       ogreCompMgr->removeWorkspace(
           this->dataPtr->ogreCompositorWorkspace1st[i]);
       this->dataPtr->ogreCompositorWorkspace1st[i] = nullptr;
     }
+    if (!this->dataPtr->nodeInputTextures[i].empty())
+    {
+      if (this->dataPtr->firstPassBorrowed)
+      {
+        Ogre::RenderTarget *rt =
+            this->dataPtr->nodeInputTextures[i][kColorTextureInput]->
+            getBuffer()->getRenderTarget();
+        rt->removeListener(this->dataPtr->laserRetroMaterialSwitcher[i].get());
+        rt->removeListener(this->dataPtr->particleNoiseListener[i].get());
+      }
+      for (auto &texture : this->dataPtr->nodeInputTextures[i])
+        this->dataPtr->texturePool->Release(this, texture);
+      this->dataPtr->nodeInputTextures[i].clear();
+    }
   }
+  this->dataPtr->firstPassBorrowed = false;
   if (this->dataPtr->matFirstPass)
   {
     Ogre::MaterialManager::getSingleton().remove(
@@ -389,8 +479,8 @@ void Ogre2GpuRays::Destroy()
   // remove 2nd pass texture, material, compositor
   if (this->dataPtr->secondPassTexture)
   {
-    Ogre::TextureManager::getSingleton().remove(
-        this->dataPtr->secondPassTexture->getName());
+    this->dataPtr->texturePool->Release(this,
+        this->dataPtr->secondPassTexture);
     this->dataPtr->secondPassTexture.reset();
   }
 
@@ -403,6 +493,7 @@ void Ogre2GpuRays::Destroy()
 
   if (!this->dataPtr->ogreCompositorWorkspaceDef2nd.empty())
   {
+    engine->CancelRenderRequest(this->dataPtr->ogreCompositorWorkspace2nd);
     ogreCompMgr->removeWorkspace(this->dataPtr->ogreCompositorWorkspace2nd);
     ogreCompMgr->removeWorkspaceDefinition(
         this->dataPtr->ogreCompositorWorkspaceDef2nd);
@@ -632,10 +723,12 @@ void Ogre2GpuRays::Setup1stPass()
   // compositor_node GpuRays1stPass
   // {
   //   in 0 rt_input
-  //   texture depthTexture target_width target_height PF_D32_FLOAT
-  //   texture colorTexture target_width target_height PF_R8G8B8
-  //   texture particleTexture target_width target_height PF_L8
-  //   texture particleDepthTexture target_width target_height PF_D32_FLOAT
+  //   // inputs are acquired from the render texture pool of the scene
+  //   in 1 depthTexture // PF_D32_FLOAT
+  //   in 2 colorTexture // PF_R8G8B8, depth_texture PF_D32_FLOAT
+  //   in 3 particleDepthTexture // PF_D32_FLOAT, half size
+  //   in 4 particleTexture // PF_R8G8B8, half size,
+  //                        // depth_texture PF_D32_FLOAT
   //   target colorTexture
   //   {
   //     pass clear
@@ -685,78 +778,15 @@ void Ogre2GpuRays::Setup1stPass()
     // Input texture
     nodeDef->addTextureSourceName("rt_input", 0,
         Ogre::TextureDefinitionBase::TEXTURE_INPUT);
-    Ogre::TextureDefinitionBase::TextureDefinition *depthTexDef =
-        nodeDef->addTextureDefinition("depthTexture");
-    depthTexDef->textureType = Ogre::TEX_TYPE_2D;
-    depthTexDef->width = 0;
-    depthTexDef->height = 0;
-    depthTexDef->depth = 1;
-    depthTexDef->numMipmaps = 0;
-    depthTexDef->widthFactor = 1;
-    depthTexDef->heightFactor = 1;
-    depthTexDef->formatList = {Ogre::PF_D32_FLOAT};
-    depthTexDef->fsaa = 0;
-    depthTexDef->uav = false;
-    depthTexDef->automipmaps = false;
-    depthTexDef->hwGammaWrite = Ogre::TextureDefinitionBase::BoolFalse;
-    depthTexDef->depthBufferId = Ogre::DepthBuffer::POOL_DEFAULT;
-
-    depthTexDef->depthBufferFormat = Ogre::PF_UNKNOWN;
-    depthTexDef->fsaaExplicitResolve = false;
-
-    Ogre::TextureDefinitionBase::TextureDefinition *colorTexDef =
-        nodeDef->addTextureDefinition("colorTexture");
-    colorTexDef->textureType = Ogre::TEX_TYPE_2D;
-    colorTexDef->width = 0;
-    colorTexDef->height = 0;
-    colorTexDef->depth = 1;
-    colorTexDef->numMipmaps = 0;
-    colorTexDef->widthFactor = 1;
-    colorTexDef->heightFactor = 1;
-    colorTexDef->formatList = {Ogre::PF_R8G8B8};
-    colorTexDef->fsaa = 0;
-    colorTexDef->uav = false;
-    colorTexDef->automipmaps = false;
-    colorTexDef->hwGammaWrite = Ogre::TextureDefinitionBase::BoolFalse;
-    colorTexDef->depthBufferId = Ogre::DepthBuffer::POOL_DEFAULT;
-    colorTexDef->depthBufferFormat = Ogre::PF_D32_FLOAT;
-    colorTexDef->preferDepthTexture = true;
-    colorTexDef->fsaaExplicitResolve = false;
-
-    Ogre::TextureDefinitionBase::TextureDefinition *particleDepthTexDef =
-        nodeDef->addTextureDefinition("particleDepthTexture");
-    particleDepthTexDef->textureType = Ogre::TEX_TYPE_2D;
-    particleDepthTexDef->width = 0;
-    particleDepthTexDef->height = 0;
-    particleDepthTexDef->depth = 1;
-    particleDepthTexDef->numMipmaps = 0;
-    particleDepthTexDef->widthFactor = 0.5;
-    particleDepthTexDef->heightFactor = 0.5;
-    particleDepthTexDef->formatList = {Ogre::PF_D32_FLOAT};
-    particleDepthTexDef->fsaa = 0;
-    particleDepthTexDef->uav = false;
-    particleDepthTexDef->automipmaps = false;
-    particleDepthTexDef->hwGammaWrite = Ogre::TextureDefinitionBase::BoolFalse;
-    particleDepthTexDef->depthBufferId = Ogre::DepthBuffer::POOL_DEFAULT;
-
-    Ogre::TextureDefinitionBase::TextureDefinition *particleTexDef =
-        nodeDef->addTextureDefinition("particleTexture");
-    particleTexDef->textureType = Ogre::TEX_TYPE_2D;
-    particleTexDef->width = 0;
-    particleTexDef->height = 0;
-    particleTexDef->depth = 1;
-    particleTexDef->numMipmaps = 0;
-    particleTexDef->widthFactor = 0.5;
-    particleTexDef->heightFactor = 0.5;
-    particleTexDef->formatList = {Ogre::PF_R8G8B8};
-    particleTexDef->fsaa = 0;
-    particleTexDef->uav = false;
-    particleTexDef->automipmaps = false;
-    particleTexDef->hwGammaWrite = Ogre::TextureDefinitionBase::BoolFalse;
-    particleTexDef->depthBufferId = Ogre::DepthBuffer::POOL_DEFAULT;
-    particleTexDef->depthBufferFormat = Ogre::PF_D32_FLOAT;
-    particleTexDef->preferDepthTexture = true;
-    particleTexDef->fsaaExplicitResolve = false;
+    // the depth, color and particle textures are shared with other sensors
+    nodeDef->addTextureSourceName("depthTexture", 1,
+        Ogre::TextureDefinitionBase::TEXTURE_INPUT);
+    nodeDef->addTextureSourceName("colorTexture", 1 + kColorTextureInput,
+        Ogre::TextureDefinitionBase::TEXTURE_INPUT);
+    nodeDef->addTextureSourceName("particleDepthTexture", 3,
+        Ogre::TextureDefinitionBase::TEXTURE_INPUT);
+    nodeDef->addTextureSourceName("particleTexture", 4,
+        Ogre::TextureDefinitionBase::TEXTURE_INPUT);
 
     nodeDef->setNumTargetPass(3);
 
@@ -775,7 +805,8 @@ void Ogre2GpuRays::Setup1stPass()
           colorTargetDef->addPass(Ogre::PASS_SCENE));
       // set camera custom visibility mask when rendering laser retro
       passScene->mVisibilityMask = 0x01000000 &
-          ~Ogre2ParticleEmitter::kParticleVisibilityFlags;
+          ~Ogre2ParticleEmitter::kParticleVisibilityFlags &
+          renderVisibilityMask(this->VisibilityMask());
     }
 
     Ogre::CompositorTargetDef *particleTargetDef =
@@ -793,7 +824,8 @@ void Ogre2GpuRays::Setup1stPass()
           particleTargetDef->addPass(Ogre::PASS_SCENE));
       // set camera custom visibility mask when rendering laser retro
       passScene->mVisibilityMask =
-          Ogre2ParticleEmitter::kParticleVisibilityFlags;
+          Ogre2ParticleEmitter::kParticleVisibilityFlags &
+          this->VisibilityMask();
     }
 
     // rt_input target - converts depth to range
@@ -821,7 +853,8 @@ void Ogre2GpuRays::Setup1stPass()
     nodeDef->mapOutputChannel(0, "rt_input");
     Ogre::CompositorWorkspaceDef *workDef =
         ogreCompMgr->addWorkspaceDefinition(wsDefName);
-    workDef->connectExternal(0, nodeDef->getName(), 0);
+    for (unsigned int i = 0u; i < 5u; ++i)
+      workDef->connectExternal(i, nodeDef->getName(), i);
   }
   Ogre::CompositorWorkspaceDef *wsDef =
       ogreCompMgr->getWorkspaceDefinition(wsDefName);
@@ -861,48 +894,46 @@ void Ogre2GpuRays::Setup1stPass()
       this->dataPtr->cubeCam[i]->yaw(Ogre::Degree(180));
 
     // create render texture - these textures pack the range data
-    // that will be used in the 2nd pass
-    std::stringstream texName;
-    texName << this->Name() << "_first_pass_" << i;
-    this->dataPtr->firstPassTextures[i] =
-      Ogre::TextureManager::getSingleton().createManual(
-      texName.str(), "General", Ogre::TEX_TYPE_2D,
-      this->dataPtr->w1st, this->dataPtr->h1st, 1, 0,
-      Ogre::PF_FLOAT32_RGB, Ogre::TU_RENDERTARGET,
-      0, false, 0, Ogre::BLANKSTRING, false, true);
+    // that will be used in the 2nd pass. They are only needed while the
+    // sensor is updated so they are shared with the other sensors
+    // The textures rendered and sampled by the compositor node are pooled
+    // too. Each face gets its own set, since a set is only shared between
+    // different sensors.
+    unsigned int w = this->dataPtr->w1st;
+    unsigned int h = this->dataPtr->h1st;
+    unsigned int halfW = std::max(w / 2u, 1u);
+    unsigned int halfH = std::max(h / 2u, 1u);
+    Ogre2RenderTexturePoolPtr pool = this->dataPtr->texturePool;
+    this->dataPtr->firstPassTextures[i] = pool->Acquire(
+        this, w, h, Ogre::PF_FLOAT32_RGB);
+    this->dataPtr->nodeInputTextures[i] = {
+        pool->Acquire(this, w, h, Ogre::PF_D32_FLOAT),
+        pool->Acquire(this, w, h, Ogre::PF_R8G8B8, false, Ogre::PF_D32_FLOAT),
+        pool->Acquire(this, halfW, halfH, Ogre::PF_D32_FLOAT),
+        pool->Acquire(this, halfW, halfH, Ogre::PF_R8G8B8, false,
+            Ogre::PF_D32_FLOAT)};
+
+    Ogre::CompositorChannelVec externalTargets;
+    externalTargets.push_back(
+        Ogre2RenderTexturePool::Channel(this->dataPtr->firstPassTextures[i]));
+    for (auto &texture : this->dataPtr->nodeInputTextures[i])
+      externalTargets.push_back(Ogre2RenderTexturePool::Channel(texture));
 
-    Ogre::RenderTarget *rt =
-        this->dataPtr->firstPassTextures[i]->getBuffer()->getRenderTarget();
     // create compositor worksspace
     this->dataPtr->ogreCompositorWorkspace1st[i] =
         ogreCompMgr->addWorkspace(this->scene->OgreSceneManager(),
-        rt, this->dataPtr->cubeCam[i], wsDefName, false);
-
-    Ogre::CompositorNode *node =
-        this->dataPtr->ogreCompositorWorkspace1st[i]->getNodeSequence()[0];
-    auto channelsTex = node->getLocalTextures();
-
-    for (auto c : channelsTex)
-    {
-      if (c.textures[0]->getSrcFormat() == Ogre::PF_R8G8B8)
-      {
-        // add laser retro material switcher to render target listener
-        // so we can switch to use laser retro material when the camera is being
-        // updated
-        this->dataPtr->laserRetroMaterialSwitcher[i].reset(
-            new Ogre2LaserRetroMaterialSwitcher(this->scene));
-        c.target->addListener(
-            this->dataPtr->laserRetroMaterialSwitcher[i].get());
-
-        // add particle noise / scatter effects listener so we can set the
-        // amount of noise based on size of emitter
-        this->dataPtr->particleNoiseListener[i].reset(
-            new Ogre2ParticleNoiseListener(this->scene,
-            this->dataPtr->cubeCam[i], this->dataPtr->matFirstPass));
-        c.target->addListener(this->dataPtr->particleNoiseListener[i].get());
-        break;
-      }
-    }
+        externalTargets, this->dataPtr->cubeCam[i], wsDefName, false);
+
+    // laser retro material switcher so we can switch to use laser retro
+    // material when the camera is being updated, and particle noise /
+    // scatter effects listener so we can set the amount of noise based on
+    // size of emitter. They are added to the color texture while the sensor
+    // borrows it, see Render
+    this->dataPtr->laserRetroMaterialSwitcher[i].reset(
+        new Ogre2LaserRetroMaterialSwitcher(this->scene));
+    this->dataPtr->particleNoiseListener[i].reset(
+        new Ogre2ParticleNoiseListener(this->scene,
+        this->dataPtr->cubeCam[i], this->dataPtr->matFirstPass));
   }
 }
 
@@ -911,14 +942,8 @@ void Ogre2GpuRays::Setup2ndPass()
 {
   // Create second pass RTT, which stores the final range data output
   // see PostRender on how we retrieve data from this texture
-  this->dataPtr->secondPassTexture =
-      Ogre::TextureManager::getSingleton().createManual(
-      this->Name() + "_second_pass",
-      "General",
-      Ogre::TEX_TYPE_2D,
-      this->dataPtr->w2nd, this->dataPtr->h2nd, 0,
-      Ogre::PF_FLOAT32_RGB,
-      Ogre::TU_RENDERTARGET);
+  this->dataPtr->secondPassTexture = this->dataPtr->texturePool->Acquire(
+      this, this->dataPtr->w2nd, this->dataPtr->h2nd, Ogre::PF_FLOAT32_RGB);
 
   // Create second pass material
   // The GpuRaysScan2nd material is defined in script (gpu_rays.material).
@@ -1026,6 +1051,7 @@ void Ogre2GpuRays::Setup2ndPass()
 /////////////////////////////////////////////////////////
 void Ogre2GpuRays::CreateGpuRaysTextures()
 {
+  this->dataPtr->texturePool = this->scene->RenderTexturePool();
   this->ConfigureCamera();
   this->CreateSampleTexture();
   this->Setup1stPass();
@@ -1035,27 +1061,53 @@ void Ogre2GpuRays::CreateGpuRaysTextures()
 /////////////////////////////////////////////////
 void Ogre2GpuRays::UpdateRenderTarget1stPass()
 {
-  // update the compositors
-  for (auto i : this->dataPtr->cubeFaceIdx)
-    this->dataPtr->ogreCompositorWorkspace1st[i]->setEnabled(true);
+  // update the compositors together with the other sensors
   auto engine = Ogre2RenderEngine::Instance();
-  engine->OgreRoot()->renderOneFrame();
   for (auto i : this->dataPtr->cubeFaceIdx)
-    this->dataPtr->ogreCompositorWorkspace1st[i]->setEnabled(false);
+    engine->RequestRender(this->dataPtr->ogreCompositorWorkspace1st[i]);
 }
 
 /////////////////////////////////////////////////
 void Ogre2GpuRays::UpdateRenderTarget2ndPass()
 {
-  this->dataPtr->ogreCompositorWorkspace2nd->setEnabled(true);
-  auto engine = Ogre2RenderEngine::Instance();
-  engine->OgreRoot()->renderOneFrame();
-  this->dataPtr->ogreCompositorWorkspace2nd->setEnabled(false);
+  // the 2nd pass workspace is created after the 1st pass ones, so it is
+  // updated after them when they are rendered in the same frame
+  Ogre2RenderEngine::Instance()->RequestRender(
+      this->dataPtr->ogreCompositorWorkspace2nd);
 }
 
 //////////////////////////////////////////////////
 void Ogre2GpuRays::Render()
 {
+  // borrow the pooled textures. The first pass textures and node inputs are
+  // consumed by the second pass, and are returned once the frame is
+  // rendered. Other sensors render into them too, so the listeners are only
+  // attached while the sensor holds them. The second pass texture is read
+  // back in PostRender, or right away if another sensor borrows it before
+  auto reclaimFirstPass = [this]() { this->dataPtr->ReturnFirstPass(this); };
+  for (auto i : this->dataPtr->cubeFaceIdx)
+  {
+    for (auto &texture : this->dataPtr->nodeInputTextures[i])
+      this->dataPtr->texturePool->Borrow(this, texture, reclaimFirstPass);
+    this->dataPtr->texturePool->Borrow(this,
+        this->dataPtr->firstPassTextures[i], reclaimFirstPass);
+  }
+  if (!this->dataPtr->firstPassBorrowed)
+  {
+    for (auto i : this->dataPtr->cubeFaceIdx)
+    {
+      Ogre::RenderTarget *rt =
+          this->dataPtr->nodeInputTextures[i][kColorTextureInput]->
+          getBuffer()->getRenderTarget();
+      rt->addListener(this->dataPtr->laserRetroMaterialSwitcher[i].get());
+      rt->addListener(this->dataPtr->particleNoiseListener[i].get());
+    }
+    this->dataPtr->firstPassBorrowed = true;
+  }
+  this->dataPtr->gpuRaysBufferRead = false;
+  this->dataPtr->texturePool->Borrow(this, this->dataPtr->secondPassTexture,
+      [this]() { this->dataPtr->ReadGpuRaysBuffer(this->Channels()); });
+
   this->UpdateRenderTarget1stPass();
   this->UpdateRenderTarget2ndPass();
 }
@@ -1077,16 +1129,14 @@ void Ogre2GpuRays::PostRender()
     width, height, 1, Ogre::PF_FLOAT32_RGB);
   int len = width * height * this->Channels();
 
-  if (!this->dataPtr->gpuRaysBuffer)
-  {
-    this->dataPtr->gpuRaysBuffer = new float[len];
-  }
-  Ogre::PixelBox dstBox(width, height,
-        1, Ogre::PF_FLOAT32_RGB, this->dataPtr->gpuRaysBuffer);
-
-  // blit data from gpu to cpu
-  auto rt = this->dataPtr->secondPassTexture->getBuffer()->getRenderTarget();
-  rt->copyContentsToMemory(dstBox, Ogre::RenderTarget::FB_FRONT);
+  // blit data from gpu to cpu, unless it was already done when another
+  // sensor borrowed the second pass texture
+  if (!this->dataPtr->gpuRaysBufferRead)
+    this->dataPtr->ReadGpuRaysBuffer(this->Channels());
+  this->dataPtr->gpuRaysBufferRead = false;
+  this->dataPtr->texturePool->Return(this,
+      this->dataPtr->secondPassTexture);
+  this->dataPtr->ReturnFirstPass(this);
 
   if (!this->dataPtr->gpuRaysScan)
   {
@@ -455,5 +455,7 @@ std::vector<double> Ogre2LidarVisual::Points() const
 void Ogre2LidarVisual::SetVisible(bool _visible)
 {
   this->dataPtr->visible = _visible;
-  this->ogreNode->setVisible(this->dataPtr->visible);
+
+  // go through the visual so the cached bounds of the points are updated
+  Ogre2Visual::SetVisible(_visible);
 }
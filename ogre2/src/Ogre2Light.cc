@@ -132,6 +132,9 @@ bool Ogre2Light::CastShadows() const
 //////////////////////////////////////////////////
 void Ogre2Light::SetCastShadows(bool _castShadows)
 {
+  if (this->ogreLight->getCastShadows() == _castShadows)
+    return;
+
   this->ogreLight->setCastShadows(_castShadows);
   this->scene->SetShadowsDirty(true);
 }
@@ -145,6 +148,10 @@ Ogre::Light *Ogre2Light::Light() const
 //////////////////////////////////////////////////
 void Ogre2Light::Destroy()
 {
+  // the light no longer needs a shadow map
+  if (this->ogreLight && this->ogreLight->getCastShadows())
+    this->scene->SetShadowsDirty(true);
+
   BaseLight::Destroy();
   Ogre::SceneManager *ogreSceneManager = this->scene->OgreSceneManager();
   ogreSceneManager->destroySceneNode(this->ogreLight->getParentSceneNode());
@@ -170,6 +177,7 @@ void Ogre2Light::CreateLight()
   // functions that update the light pose will affect the light direction
   this->ogreNode->createChildSceneNode()->attachObject(this->ogreLight);
   this->ogreLight->setCastShadows(true);
+  this->scene->SetShadowsDirty(true);
   this->ogreLight->setPowerScale(Ogre::Math::PI);
   this->UpdateAttenuation();
 }
@@ -15,8 +15,12 @@
  *
  */
 
+#include <map>
+#include <vector>
+
 #include <ignition/common/Console.hh>
 
+#include "ignition/rendering/ogre2/Ogre2Conversions.hh"
 #include "ignition/rendering/ogre2/Ogre2DynamicRenderable.hh"
 #include "ignition/rendering/ogre2/Ogre2Marker.hh"
 #include "ignition/rendering/ogre2/Ogre2Material.hh"
@@ -38,6 +42,28 @@ class ignition::rendering::Ogre2MarkerPrivate
 
   /// \brief DynamicLines Object to display
   public: std::shared_ptr<Ogre2DynamicRenderable> dynamicRenderable;
+
+  /// \brief Mesh holding the primitive shared by the list shapes
+  public: Ogre2MeshPtr listMesh = nullptr;
+
+  /// \brief Scene node the list shapes are attached to
+  public: Ogre::SceneNode *listParent = nullptr;
+
+  /// \brief Scene node of each list shape
+  public: std::vector<Ogre::SceneNode *> listNodes;
+
+  /// \brief Item of each list shape. They all use the primitive mesh, so
+  /// shapes with the same material are instanced by the hlms.
+  public: std::vector<Ogre::Item *> listItems;
+
+  /// \brief Materials of the list shapes, by RGBA color
+  public: std::map<uint32_t, Ogre2MaterialPtr> listMaterials;
+
+  /// \brief Flag to indicate that the list materials must be recreated
+  public: bool listMaterialsDirty = false;
+
+  /// \brief True once the user was warned that point colors are ignored
+  public: bool pointColorWarned = false;
 };
 
 using namespace ignition;
@@ -59,6 +85,147 @@ Ogre2Marker::~Ogre2Marker()
 void Ogre2Marker::PreRender()
 {
   this->dataPtr->dynamicRenderable->Update();
+
+  if (IsListType(this->markerType))
+    this->UpdateListItems();
+}
+
+//////////////////////////////////////////////////
+void Ogre2Marker::UpdateListItems()
+{
+  if (!this->dataPtr->dynamicRenderable)
+    return;
+
+  auto visual = std::dynamic_pointer_cast<Ogre2Visual>(this->Parent());
+  Ogre::SceneNode *parentNode = visual ? visual->Node() : nullptr;
+  if (parentNode != this->dataPtr->listParent)
+  {
+    this->DestroyListItems();
+    this->dataPtr->listParent = parentNode;
+    this->listDirty = true;
+  }
+
+  if (!parentNode)
+    return;
+
+  // the empty dynamic renderable is the geometry attached to the visual,
+  // the shapes follow its visibility flags
+  Ogre::MovableObject *anchor = this->dataPtr->dynamicRenderable->OgreObject();
+  if (!this->listDirty)
+  {
+    for (auto item : this->dataPtr->listItems)
+      item->setVisibilityFlags(anchor->getVisibilityFlags());
+    return;
+  }
+  this->listDirty = false;
+
+  if (!this->dataPtr->listMesh)
+  {
+    this->dataPtr->listMesh = std::dynamic_pointer_cast<Ogre2Mesh>(
+        this->scene->CreateMesh(ListPrimitive(this->markerType)));
+    if (!this->dataPtr->listMesh)
+    {
+      ignerr << "Failed to create the list marker primitive" << std::endl;
+      return;
+    }
+  }
+  Ogre::MeshPtr mesh = static_cast<Ogre::Item *>(
+      this->dataPtr->listMesh->OgreObject())->getMesh();
+
+  Ogre::SceneManager *sceneManager = this->scene->OgreSceneManager();
+  unsigned int count = this->ListElementCount();
+  while (this->dataPtr->listItems.size() > count)
+  {
+    sceneManager->destroyItem(this->dataPtr->listItems.back());
+    sceneManager->destroySceneNode(this->dataPtr->listNodes.back());
+    this->dataPtr->listItems.pop_back();
+    this->dataPtr->listNodes.pop_back();
+  }
+  while (this->dataPtr->listItems.size() < count)
+  {
+    Ogre::Item *item = sceneManager->createItem(mesh, Ogre::SCENE_DYNAMIC);
+    item->setCastShadows(false);
+    item->getUserObjectBindings().setUserAny(
+        anchor->getUserObjectBindings().getUserAny());
+    Ogre::SceneNode *node =
+        parentNode->createChildSceneNode(Ogre::SCENE_DYNAMIC);
+    node->attachObject(item);
+    this->dataPtr->listItems.push_back(item);
+    this->dataPtr->listNodes.push_back(node);
+  }
+
+  // shapes without a color use the marker material, the others share one
+  // material per color
+  std::map<uint32_t, Ogre2MaterialPtr> materials;
+  for (unsigned int i = 0u; i < count; ++i)
+  {
+    Ogre::SceneNode *node = this->dataPtr->listNodes[i];
+    node->setPosition(Ogre2Conversions::Convert(this->listPoses[i].Pos()));
+    node->setOrientation(Ogre2Conversions::Convert(this->listPoses[i].Rot()));
+    node->setScale(Ogre2Conversions::Convert(this->ListElementScale(i)));
+    this->dataPtr->listItems[i]->setVisibilityFlags(
+        anchor->getVisibilityFlags());
+
+    Ogre2MaterialPtr material = this->dataPtr->material;
+    if (!this->listColors.empty() || !material)
+    {
+      math::Color color = this->ListElementColor(i);
+      uint32_t key = color.AsRGBA();
+      auto it = materials.find(key);
+      if (it != materials.end())
+      {
+        material = it->second;
+      }
+      else
+      {
+        auto cached = this->dataPtr->listMaterials.find(key);
+        if (!this->dataPtr->listMaterialsDirty &&
+            cached != this->dataPtr->listMaterials.end())
+        {
+          material = cached->second;
+          this->dataPtr->listMaterials.erase(cached);
+        }
+        else
+        {
+          MaterialPtr newMaterial = this->dataPtr->material ?
+              this->dataPtr->material->Clone() : this->scene->CreateMaterial();
+          newMaterial->SetAmbient(color);
+          newMaterial->SetDiffuse(color);
+          newMaterial->SetEmissive(color);
+          newMaterial->SetTransparency(1.0 - color.A());
+          newMaterial->SetReceiveShadows(false);
+          newMaterial->SetCastShadows(false);
+          newMaterial->SetLightingEnabled(false);
+          material = std::dynamic_pointer_cast<Ogre2Material>(newMaterial);
+        }
+        materials[key] = material;
+      }
+    }
+    this->dataPtr->listItems[i]->setDatablock(material->Datablock());
+  }
+
+  // materials of colors that are no longer used
+  for (auto &it : this->dataPtr->listMaterials)
+    this->scene->DestroyMaterial(it.second);
+  this->dataPtr->listMaterials = materials;
+  this->dataPtr->listMaterialsDirty = false;
+}
+
+//////////////////////////////////////////////////
+void Ogre2Marker::DestroyListItems()
+{
+  Ogre::SceneManager *sceneManager = this->scene->OgreSceneManager();
+  for (auto item : this->dataPtr->listItems)
+    sceneManager->destroyItem(item);
+  for (auto node : this->dataPtr->listNodes)
+    sceneManager->destroySceneNode(node);
+  this->dataPtr->listItems.clear();
+  this->dataPtr->listNodes.clear();
+  this->dataPtr->listParent = nullptr;
+
+  for (auto &it : this->dataPtr->listMaterials)
+    this->scene->DestroyMaterial(it.second);
+  this->dataPtr->listMaterials.clear();
 }
 
 //////////////////////////////////////////////////
@@ -67,6 +234,13 @@ void Ogre2Marker::Destroy()
   if (!this->Scene())
     return;
 
+  this->DestroyListItems();
+  if (this->dataPtr->listMesh)
+  {
+    this->dataPtr->listMesh->Destroy();
+    this->dataPtr->listMesh.reset();
+  }
+
   if (this->dataPtr->mesh)
   {
     this->dataPtr->mesh->Destroy();
@@ -96,6 +270,8 @@ Ogre::MovableObject *Ogre2Marker::OgreObject() const
     case MT_BOX:
     case MT_CYLINDER:
     case MT_SPHERE:
+      if (!this->dataPtr->mesh)
+        return nullptr;
       return this->dataPtr->mesh->OgreObject();
     case MT_LINE_STRIP:
     case MT_LINE_LIST:
@@ -103,6 +279,9 @@ Ogre::MovableObject *Ogre2Marker::OgreObject() const
     case MT_TRIANGLE_FAN:
     case MT_TRIANGLE_LIST:
     case MT_TRIANGLE_STRIP:
+    case MT_BOX_LIST:
+    case MT_CYLINDER_LIST:
+    case MT_SPHERE_LIST:
     {
       return this->dataPtr->dynamicRenderable->OgreObject();
     }
@@ -121,14 +300,10 @@ void Ogre2Marker::Init()
 //////////////////////////////////////////////////
 void Ogre2Marker::Create()
 {
+  // primitive meshes are only created once a shape type is set
   this->markerType = MT_NONE;
   this->dataPtr->dynamicRenderable.reset(new Ogre2DynamicRenderable(
       this->scene));
-  if (!this->dataPtr->mesh)
-  {
-    this->dataPtr->mesh =
-      std::dynamic_pointer_cast<Ogre2Mesh>(this->scene->CreateBox());
-  }
 }
 
 //////////////////////////////////////////////////
@@ -160,7 +335,8 @@ void Ogre2Marker::SetMaterial(MaterialPtr _material, bool _unique)
     case MT_BOX:
     case MT_CYLINDER:
     case MT_SPHERE:
-      this->dataPtr->mesh->SetMaterial(derived, false);
+      if (this->dataPtr->mesh)
+        this->dataPtr->mesh->SetMaterial(derived, false);
       break;
     case MT_LINE_STRIP:
     case MT_LINE_LIST:
@@ -168,6 +344,9 @@ void Ogre2Marker::SetMaterial(MaterialPtr _material, bool _unique)
     case MT_TRIANGLE_FAN:
     case MT_TRIANGLE_LIST:
     case MT_TRIANGLE_STRIP:
+    case MT_BOX_LIST:
+    case MT_CYLINDER_LIST:
+    case MT_SPHERE_LIST:
       this->dataPtr->dynamicRenderable->SetMaterial(derived, false);
       break;
     default:
@@ -175,11 +354,24 @@ void Ogre2Marker::SetMaterial(MaterialPtr _material, bool _unique)
       break;
   }
 
+  Ogre2MaterialPtr oldMaterial;
   if (this->dataPtr->material && this->dataPtr->ownsMaterial)
-    this->Scene()->DestroyMaterial(this->dataPtr->material);
+    oldMaterial = this->dataPtr->material;
 
   this->dataPtr->material = derived;
   this->dataPtr->ownsMaterial = _unique;
+
+  // list shapes use the marker material or copies of it. Move them to the
+  // new one before the old one is destroyed.
+  if (IsListType(this->markerType))
+  {
+    this->dataPtr->listMaterialsDirty = true;
+    this->listDirty = true;
+    this->UpdateListItems();
+  }
+
+  if (oldMaterial)
+    this->Scene()->DestroyMaterial(oldMaterial);
 }
 
 //////////////////////////////////////////////////
@@ -195,10 +387,24 @@ void Ogre2Marker::SetPoint(unsigned int _index,
   this->dataPtr->dynamicRenderable->SetPoint(_index, _value);
 }
 
+//////////////////////////////////////////////////
+void Ogre2Marker::SetPointTexCoord(unsigned int _index,
+    const ignition::math::Vector2d &_texCoord)
+{
+  this->dataPtr->dynamicRenderable->SetTexCoord(_index, _texCoord);
+}
+
 //////////////////////////////////////////////////
 void Ogre2Marker::AddPoint(const ignition::math::Vector3d &_pt,
     const ignition::math::Color &_color)
 {
+  // the ogre2 dynamic renderable has no vertex colors
+  if (_color != math::Color::White && !this->dataPtr->pointColorWarned)
+  {
+    ignwarn << "Point colors are not supported by ogre2 markers, marker ["
+            << this->Name() << "] uses its material color" << std::endl;
+    this->dataPtr->pointColorWarned = true;
+  }
   this->dataPtr->dynamicRenderable->AddPoint(_pt, _color);
 }
 
@@ -214,21 +420,30 @@ void Ogre2Marker::SetType(MarkerType _markerType)
   if (_markerType == this->markerType)
     return;
 
-  this->markerType = _markerType;
-
   auto visual = std::dynamic_pointer_cast<Ogre2Visual>(this->Parent());
 
+  // detach the ogre object of the current type
+  if (visual && this->OgreObject())
+  {
+    visual->RemoveGeometry(
+        std::dynamic_pointer_cast<Geometry>(shared_from_this()));
+  }
+
   // clear geom if needed
   if (this->dataPtr->mesh)
   {
-    if (visual)
-    {
-      visual->RemoveGeometry(
-          std::dynamic_pointer_cast<Geometry>(shared_from_this()));
-    }
     this->dataPtr->mesh->Destroy();
+    this->dataPtr->mesh.reset();
+  }
+  this->DestroyListItems();
+  if (this->dataPtr->listMesh)
+  {
+    this->dataPtr->listMesh->Destroy();
+    this->dataPtr->listMesh.reset();
   }
 
+  this->markerType = _markerType;
+
 
   GeometryPtr newMesh;
   switch (_markerType)
@@ -252,22 +467,40 @@ void Ogre2Marker::SetType(MarkerType _markerType)
     case MT_TRIANGLE_STRIP:
       this->dataPtr->dynamicRenderable->SetOperationType(_markerType);
       break;
+    case MT_BOX_LIST:
+    case MT_CYLINDER_LIST:
+    case MT_SPHERE_LIST:
+      // the shapes are instanced items, see UpdateListItems. The empty
+      // dynamic renderable is attached to the visual in their place.
+      this->dataPtr->dynamicRenderable->SetOperationType(MT_TRIANGLE_LIST);
+      this->dataPtr->dynamicRenderable->Clear();
+      this->listDirty = true;
+      break;
     default:
       ignerr << "Invalid Marker type\n";
       break;
   }
 
   if (newMesh)
-  {
     this->dataPtr->mesh = std::dynamic_pointer_cast<Ogre2Mesh>(newMesh);
-    if (visual)
-    {
-      visual->AddGeometry(
-          std::dynamic_pointer_cast<Geometry>(shared_from_this()));
-    }
+
+  if (visual && this->OgreObject())
+  {
+    visual->AddGeometry(
+        std::dynamic_pointer_cast<Geometry>(shared_from_this()));
   }
 }
 
+//////////////////////////////////////////////////
+void Ogre2Marker::SetParent(Ogre2VisualPtr _parent)
+{
+  Ogre2Geometry::SetParent(_parent);
+
+  // move the list shapes to the scene node of the new parent
+  if (IsListType(this->markerType))
+    this->UpdateListItems();
+}
+
 //////////////////////////////////////////////////
 MarkerType Ogre2Marker::Type() const
 {
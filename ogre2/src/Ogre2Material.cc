@@ -26,6 +26,9 @@
 #pragma warning(pop)
 #endif
 
+#include <algorithm>
+#include <vector>
+
 #include <ignition/common/Console.hh>
 #include <ignition/common/Filesystem.hh>
 
@@ -39,6 +42,42 @@
 /// \brief Private data for the Ogre2Material class
 class ignition::rendering::Ogre2MaterialPrivate
 {
+  /// \brief Transfer params that have changed from ign-rendering type
+  /// to ogre type
+  /// \param[in] _params ignition rendering params
+  /// \param[out] _ogreParams ogre type for holding params
+  /// \param[in,out] _handles Shader constants of the params, by param
+  /// index. Constants are looked up by name the first time a param is
+  /// transferred.
+  /// \param[in] _materialName Name of the material, for error messages
+  public: void UpdateShaderParams(const ShaderParamsPtr &_params,
+      Ogre::GpuProgramParametersSharedPtr _ogreParams,
+      std::vector<const Ogre::GpuConstantDefinition *> &_handles,
+      const std::string &_materialName);
+
+  /// \brief Path to vertex shader program.
+  public: std::string vertexShaderPath;
+
+  /// \brief Path to fragment shader program.
+  public: std::string fragmentShaderPath;
+
+  /// \brief Parameters to be bound to the vertex shader
+  public: ShaderParamsPtr vertexShaderParams;
+
+  /// \brief Parameters to be bound to the fragment shader
+  public: ShaderParamsPtr fragmentShaderParams;
+
+  /// \brief Vertex shader constants of the vertex shader params
+  public: std::vector<const Ogre::GpuConstantDefinition *>
+      vertexShaderHandles;
+
+  /// \brief Fragment shader constants of the fragment shader params
+  public: std::vector<const Ogre::GpuConstantDefinition *>
+      fragmentShaderHandles;
+
+  /// \brief Name of the texture this material created from an image in
+  /// memory, empty if there is none. It is destroyed with the material.
+  public: std::string memoryTextureName;
 };
 
 using namespace ignition;
@@ -67,6 +106,7 @@ void Ogre2Material::Destroy()
 
   this->ogreHlmsPbs->destroyDatablock(this->ogreDatablockId);
   this->ogreDatablock = nullptr;
+  this->DestroyMemoryTexture();
 
   if (this->ogreUnlitDatablock)
   {
@@ -209,6 +249,71 @@ void Ogre2Material::SetTexture(const std::string &_name)
   this->SetTextureMapImpl(this->textureName, Ogre::PBSM_DIFFUSE);
 }
 
+//////////////////////////////////////////////////
+void Ogre2Material::SetTexture(const std::string &_name,
+    const std::shared_ptr<const common::Image> &_img)
+{
+  if (_name.empty() || !_img || !_img->Valid())
+  {
+    this->ClearTexture();
+    return;
+  }
+
+  if (_name != this->dataPtr->memoryTextureName)
+    this->DestroyMemoryTexture();
+  this->textureName = _name;
+
+  unsigned int width = _img->Width();
+  unsigned int height = _img->Height();
+  std::vector<unsigned char> data(width * height * 4u);
+  for (unsigned int y = 0u; y < height; ++y)
+  {
+    for (unsigned int x = 0u; x < width; ++x)
+    {
+      math::Color color = _img->Pixel(x, y);
+      unsigned char *pixel = &data[(y * width + x) * 4u];
+      pixel[0] = static_cast<unsigned char>(color.R() * 255.0f);
+      pixel[1] = static_cast<unsigned char>(color.G() * 255.0f);
+      pixel[2] = static_cast<unsigned char>(color.B() * 255.0f);
+      pixel[3] = static_cast<unsigned char>(color.A() * 255.0f);
+    }
+  }
+  Ogre::Image image;
+  image.loadDynamicImage(data.data(), width, height, 1, Ogre::PF_BYTE_RGBA);
+
+  // the image is only uploaded the first time, the texture is then shared
+  // by all the materials using the same name. The material uploading it
+  // destroys it.
+  Ogre::HlmsTextureManager *hlmsTextureManager =
+      this->ogreHlmsPbs->getHlmsManager()->getTextureManager();
+  if (!hlmsTextureManager->findResourceNameFromAlias(_name))
+    this->dataPtr->memoryTextureName = _name;
+  Ogre::HlmsTextureManager::TextureLocation texLocation =
+      hlmsTextureManager->createOrRetrieveTexture(_name, _name,
+      this->ogreDatablock->suggestMapTypeBasedOnTextureType(
+      Ogre::PBSM_DIFFUSE), &image);
+
+  Ogre::HlmsSamplerblock samplerBlockRef;
+  samplerBlockRef.mU = Ogre::TAM_WRAP;
+  samplerBlockRef.mV = Ogre::TAM_WRAP;
+  samplerBlockRef.mW = Ogre::TAM_WRAP;
+
+  this->ogreDatablock->setTexture(Ogre::PBSM_DIFFUSE, texLocation.xIdx,
+      texLocation.texture, &samplerBlockRef);
+}
+
+//////////////////////////////////////////////////
+void Ogre2Material::DestroyMemoryTexture()
+{
+  if (this->dataPtr->memoryTextureName.empty())
+    return;
+
+  Ogre::HlmsTextureManager *hlmsTextureManager =
+      this->ogreHlmsPbs->getHlmsManager()->getTextureManager();
+  hlmsTextureManager->destroyTexture(this->dataPtr->memoryTextureName);
+  this->dataPtr->memoryTextureName.clear();
+}
+
 //////////////////////////////////////////////////
 void Ogre2Material::ClearTexture()
 {
@@ -403,6 +508,170 @@ float Ogre2Material::Metalness() const
 //////////////////////////////////////////////////
 void Ogre2Material::PreRender()
 {
+  if (!this->ogreMaterial)
+    return;
+
+  Ogre::Pass *pass = this->ogreMaterial->getTechnique(0u)->getPass(0u);
+  if (this->dataPtr->vertexShaderParams &&
+      this->dataPtr->vertexShaderParams->IsDirty())
+  {
+    this->dataPtr->UpdateShaderParams(this->dataPtr->vertexShaderParams,
+        pass->getVertexProgramParameters(),
+        this->dataPtr->vertexShaderHandles, this->name);
+    this->dataPtr->vertexShaderParams->ClearDirty();
+  }
+  if (this->dataPtr->fragmentShaderParams &&
+      this->dataPtr->fragmentShaderParams->IsDirty())
+  {
+    this->dataPtr->UpdateShaderParams(this->dataPtr->fragmentShaderParams,
+        pass->getFragmentProgramParameters(),
+        this->dataPtr->fragmentShaderHandles, this->name);
+    this->dataPtr->fragmentShaderParams->ClearDirty();
+  }
+}
+
+//////////////////////////////////////////////////
+void Ogre2MaterialPrivate::UpdateShaderParams(const ShaderParamsPtr &_params,
+    Ogre::GpuProgramParametersSharedPtr _ogreParams,
+    std::vector<const Ogre::GpuConstantDefinition *> &_handles,
+    const std::string &_materialName)
+{
+  for (auto index : _params->DirtyIndices())
+  {
+    // resolve the constants of new params
+    while (_handles.size() <= index)
+    {
+      const std::string &name = _params->NameByIndex(
+          static_cast<uint32_t>(_handles.size()));
+      const Ogre::GpuConstantDefinition *def =
+          _ogreParams->_findNamedConstantDefinition(name, false);
+      if (!def)
+      {
+        ignwarn << "Shader param [" << name << "] not found in shader of "
+                << "material [" << _materialName << "]" << std::endl;
+      }
+      _handles.push_back(def);
+    }
+
+    const Ogre::GpuConstantDefinition *def = _handles[index];
+    if (!def)
+      continue;
+
+    // write the values straight to the constant buffer, without a lookup
+    const ShaderParam &param = _params->ParamByIndex(index);
+    size_t count = std::min<size_t>(param.Count(),
+        def->elementSize * def->arraySize);
+    if ((ShaderParam::PARAM_FLOAT == param.Type() ||
+        ShaderParam::PARAM_FLOAT_BUFFER == param.Type()) && def->isFloat())
+    {
+      _ogreParams->_writeRawConstants(def->physicalIndex,
+          static_cast<const float *>(param.Data()), count);
+    }
+    else if ((ShaderParam::PARAM_INT == param.Type() ||
+        ShaderParam::PARAM_INT_BUFFER == param.Type()) && !def->isFloat())
+    {
+      _ogreParams->_writeRawConstants(def->physicalIndex,
+          static_cast<const int *>(param.Data()), count);
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+void Ogre2Material::SetVertexShader(const std::string &_path)
+{
+  if (_path.empty())
+    return;
+
+  if (!common::exists(_path))
+  {
+    ignerr << "Vertex shader path does not exist: " << _path << std::endl;
+    return;
+  }
+
+  // name the program after the material too, materials sharing a shader
+  // file each get their own program
+  Ogre::HighLevelGpuProgramPtr vertexShader =
+    Ogre::HighLevelGpuProgramManager::getSingleton().createProgram(
+        "__ignition_rendering_vertex__" + this->Name() + "__" + _path,
+        Ogre::ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME,
+        "glsl", Ogre::GpuProgramType::GPT_VERTEX_PROGRAM);
+
+  vertexShader->setSourceFile(_path);
+  vertexShader->load();
+
+  Ogre::MaterialPtr mat = this->Material();
+  mat->getTechnique(0u)->getPass(0u)->setVertexProgram(
+      vertexShader->getName());
+  mat->compile();
+  mat->load();
+
+  this->dataPtr->vertexShaderPath = _path;
+  this->dataPtr->vertexShaderParams.reset(new ShaderParams);
+  this->dataPtr->vertexShaderHandles.clear();
+}
+
+//////////////////////////////////////////////////
+std::string Ogre2Material::VertexShader() const
+{
+  return this->dataPtr->vertexShaderPath;
+}
+
+//////////////////////////////////////////////////
+ShaderParamsPtr Ogre2Material::VertexShaderParams()
+{
+  return this->dataPtr->vertexShaderParams;
+}
+
+//////////////////////////////////////////////////
+void Ogre2Material::SetFragmentShader(const std::string &_path)
+{
+  if (_path.empty())
+    return;
+
+  if (!common::exists(_path))
+  {
+    ignerr << "Fragment shader path does not exist: " << _path << std::endl;
+    return;
+  }
+
+  // name the program after the material too, see SetVertexShader
+  Ogre::HighLevelGpuProgramPtr fragmentShader =
+    Ogre::HighLevelGpuProgramManager::getSingleton().createProgram(
+        "__ignition_rendering_fragment__" + this->Name() + "__" + _path,
+        Ogre::ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME,
+        "glsl", Ogre::GpuProgramType::GPT_FRAGMENT_PROGRAM);
+
+  fragmentShader->setSourceFile(_path);
+  fragmentShader->load();
+
+  Ogre::MaterialPtr mat = this->Material();
+  mat->getTechnique(0u)->getPass(0u)->setFragmentProgram(
+      fragmentShader->getName());
+  mat->compile();
+  mat->load();
+
+  this->dataPtr->fragmentShaderPath = _path;
+  this->dataPtr->fragmentShaderParams.reset(new ShaderParams);
+  this->dataPtr->fragmentShaderHandles.clear();
+}
+
+//////////////////////////////////////////////////
+std::string Ogre2Material::FragmentShader() const
+{
+  return this->dataPtr->fragmentShaderPath;
+}
+
+//////////////////////////////////////////////////
+ShaderParamsPtr Ogre2Material::FragmentShaderParams()
+{
+  return this->dataPtr->fragmentShaderParams;
+}
+
+//////////////////////////////////////////////////
+bool Ogre2Material::HasCustomShaders() const
+{
+  return !this->dataPtr->vertexShaderPath.empty() ||
+      !this->dataPtr->fragmentShaderPath.empty();
 }
 
 //////////////////////////////////////////////////
@@ -299,8 +299,16 @@ void Ogre2SubMesh::SetMaterialImpl(MaterialPtr _material)
     return;
   }
 
-  this->ogreSubItem->setDatablock(
-      static_cast<Ogre::HlmsPbsDatablock *>(derived->Datablock()));
+  // materials with custom shaders use the low level material
+  if (derived->HasCustomShaders())
+  {
+    this->ogreSubItem->setMaterial(derived->Material());
+  }
+  else
+  {
+    this->ogreSubItem->setDatablock(
+        static_cast<Ogre::HlmsPbsDatablock *>(derived->Datablock()));
+  }
 
   // set cast shadows
   this->ogreSubItem->getParent()->setCastShadows(_material->CastShadows());
@@ -27,6 +27,7 @@
 
 #include <ignition/math/Matrix4.hh>
 
+#include "ignition/rendering/MeshOptimizer.hh"
 #include "ignition/rendering/ogre2/Ogre2Conversions.hh"
 #include "ignition/rendering/ogre2/Ogre2Includes.hh"
 #include "ignition/rendering/ogre2/Ogre2Mesh.hh"
@@ -268,7 +269,8 @@ bool Ogre2MeshFactory::LoadImpl(const MeshDescriptor &_desc)
 
       // Copy the original submesh. We may need to modify the vertices, and
       // we don't want to change the original.
-      common::SubMesh subMesh(*s.get());
+      common::SubMesh subMesh(_desc.optimizeMesh ?
+          MeshOptimizer::Optimize(*s.get()) : *s.get());
 
       // Recenter the vertices if requested.
       if (_desc.centerSubMesh)
@@ -479,6 +481,8 @@ std::string Ogre2MeshFactory::MeshName(const MeshDescriptor &_desc)
   ss << _desc.meshName << "::";
   ss << _desc.subMeshName << "::";
   ss << ((_desc.centerSubMesh) ? "CENTERED" : "ORIGINAL");
+  if (_desc.optimizeMesh)
+    ss << "::OPTIMIZED";
   return ss.str();
 }
 
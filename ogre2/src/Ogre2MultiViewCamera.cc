@@ -0,0 +1,174 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+
+#include "ignition/rendering/ogre2/Ogre2Conversions.hh"
+#include "ignition/rendering/ogre2/Ogre2Includes.hh"
+#include "ignition/rendering/ogre2/Ogre2MultiViewCamera.hh"
+#include "ignition/rendering/ogre2/Ogre2RenderTarget.hh"
+#include "ignition/rendering/ogre2/Ogre2Scene.hh"
+
+/// \brief Private data for the Ogre2MultiViewCamera class
+class ignition::rendering::Ogre2MultiViewCameraPrivate
+{
+  /// \brief Ogre cameras of the views, attached to the node of the camera
+  public: std::vector<Ogre::Camera *> viewCameras;
+};
+
+using namespace ignition;
+using namespace rendering;
+
+/// \brief Maximum angle between a view and the first view, as a fraction
+/// of the horizontal field of view, for the view to reuse the shadow maps
+/// of the first view
+static const double kShadowReuseFov = 0.05;
+
+/// \brief Maximum distance between a view and the first view, in meters,
+/// for the view to reuse the shadow maps of the first view
+static const double kShadowReuseDistance = 0.5;
+
+//////////////////////////////////////////////////
+Ogre2MultiViewCamera::Ogre2MultiViewCamera()
+  : dataPtr(std::make_unique<Ogre2MultiViewCameraPrivate>())
+{
+}
+
+//////////////////////////////////////////////////
+Ogre2MultiViewCamera::~Ogre2MultiViewCamera()
+{
+  this->Destroy();
+}
+
+//////////////////////////////////////////////////
+void Ogre2MultiViewCamera::Destroy()
+{
+  if (!this->dataPtr->viewCameras.empty() && this->Scene()->IsInitialized())
+  {
+    // the render texture stops rendering with the cameras before they are
+    // destroyed
+    if (this->renderTexture)
+      this->renderTexture->SetViewCameras({});
+
+    Ogre::SceneManager *ogreSceneManager = this->scene->OgreSceneManager();
+    for (auto camera : this->dataPtr->viewCameras)
+      ogreSceneManager->destroyCamera(camera);
+  }
+  this->dataPtr->viewCameras.clear();
+
+  Ogre2Camera::Destroy();
+}
+
+//////////////////////////////////////////////////
+void Ogre2MultiViewCamera::PreRender()
+{
+  // the render texture is rebuilt in BaseCamera::PreRender when the number
+  // of views changes
+  this->UpdateViewCameras();
+  BaseCamera::PreRender();
+}
+
+//////////////////////////////////////////////////
+void Ogre2MultiViewCamera::SetOcclusionCulling(bool _enabled)
+{
+  if (_enabled)
+  {
+    ignwarn << "Occlusion culling is not supported by multi-view cameras. "
+            << "Camera [" << this->Name() << "] renders all objects."
+            << std::endl;
+  }
+}
+
+//////////////////////////////////////////////////
+void Ogre2MultiViewCamera::UpdateViewCameras()
+{
+  Ogre::SceneManager *ogreSceneManager = this->scene->OgreSceneManager();
+  std::vector<Ogre::Camera *> &cameras = this->dataPtr->viewCameras;
+  std::vector<Ogre::Camera *> removed;
+  if (cameras.size() != this->viewPoses.size())
+  {
+    while (cameras.size() > this->viewPoses.size())
+    {
+      removed.push_back(cameras.back());
+      cameras.pop_back();
+    }
+    while (cameras.size() < this->viewPoses.size())
+    {
+      Ogre::Camera *camera = ogreSceneManager->createCamera(
+          this->name + "_view_" + std::to_string(cameras.size()));
+      // by default, ogre2 cameras are attached to root scene node
+      camera->detachFromParent();
+      this->ogreNode->attachObject(camera);
+      camera->setFixedYawAxis(false);
+      camera->setAutoAspectRatio(false);
+      camera->setProjectionType(Ogre::PT_PERSPECTIVE);
+      camera->setCustomProjectionMatrix(false);
+      cameras.push_back(camera);
+    }
+  }
+
+  // shadow maps are fitted to the frustum of the first view, so only views
+  // that look about the same way from about the same place reuse them
+  std::vector<bool> reuseShadows(cameras.size(), false);
+  for (size_t i = 1u; i < cameras.size(); ++i)
+  {
+    const math::Pose3d &first = this->viewPoses[0];
+    const math::Pose3d &view = this->viewPoses[i];
+    math::Quaterniond diff = first.Rot().Inverse() * view.Rot();
+    diff.Normalize();
+    double angle = 2.0 * std::acos(std::min(1.0, std::abs(diff.W())));
+    reuseShadows[i] = angle <= kShadowReuseFov * this->HFOV().Radian() &&
+        first.Pos().Distance(view.Pos()) <= kShadowReuseDistance;
+  }
+
+  // the render texture is only rebuilt if the views or the shadow reuse
+  // changed, and stops using removed cameras before they are destroyed
+  this->renderTexture->SetViewCameras(cameras, reuseShadows);
+  for (auto camera : removed)
+    ogreSceneManager->destroyCamera(camera);
+
+  if (cameras.empty())
+    return;
+
+  // every view gets a slice of the image with the field of view of the
+  // camera
+  double aspect = static_cast<double>(this->ImageWidth()) /
+      (cameras.size() * std::max(this->ImageHeight(), 1u));
+  double vfov = 2.0 * std::atan(std::tan(this->HFOV().Radian() / 2.0) /
+      std::max(aspect, 1e-6));
+
+  // the camera orientation turns ogre cameras, which look down -Z, into
+  // the camera frame, which looks down +X
+  Ogre::Quaternion orientation = this->ogreCamera->getOrientation();
+  for (size_t i = 0u; i < cameras.size(); ++i)
+  {
+    Ogre::Camera *camera = cameras[i];
+    const math::Pose3d &pose = this->viewPoses[i];
+    camera->setPosition(Ogre2Conversions::Convert(pose.Pos()));
+    camera->setOrientation(
+        Ogre2Conversions::Convert(pose.Rot()) * orientation);
+    camera->setAspectRatio(static_cast<Ogre::Real>(aspect));
+    camera->setFOVy(Ogre::Radian(static_cast<Ogre::Real>(vfov)));
+    camera->setNearClipDistance(this->NearClipPlane());
+    camera->setFarClipDistance(this->FarClipPlane());
+  }
+}
@@ -89,6 +89,7 @@ math::Vector3d Ogre2Node::RawLocalPosition() const
 void Ogre2Node::SetRawLocalPosition(const math::Vector3d &_position)
 {
   this->ogreNode->setPosition(Ogre2Conversions::Convert(_position));
+  this->MarkTransformDirty();
 }
 
 //////////////////////////////////////////////////
@@ -101,12 +102,16 @@ math::Quaterniond Ogre2Node::RawLocalRotation() const
 void Ogre2Node::SetRawLocalRotation(const math::Quaterniond &_rotation)
 {
   this->ogreNode->setOrientation(Ogre2Conversions::Convert(_rotation));
+  this->MarkTransformDirty();
 }
 
 //////////////////////////////////////////////////
 void Ogre2Node::SetParent(Ogre2NodePtr _parent)
 {
+  // the old parent's bounds no longer include this node
+  this->MarkBoundsDirty();
   this->parent = _parent;
+  this->MarkTransformDirty();
 }
 
 //////////////////////////////////////////////////
@@ -174,6 +179,8 @@ bool Ogre2Node::DetachChild(NodePtr _child)
   }
 
   this->ogreNode->removeChild(derived->Node());
+  derived->MarkTransformDirty();
+  this->MarkBoundsDirty();
   return true;
 }
 
@@ -200,12 +207,83 @@ bool Ogre2Node::InheritScale() const
 void Ogre2Node::SetInheritScale(bool _inherit)
 {
   this->ogreNode->setInheritScale(_inherit);
+  this->MarkTransformDirty();
 }
 
 //////////////////////////////////////////////////
 void Ogre2Node::SetLocalScaleImpl(const math::Vector3d &_scale)
 {
   this->ogreNode->setScale(Ogre2Conversions::Convert(_scale));
+  this->MarkTransformDirty();
+}
+
+//////////////////////////////////////////////////
+void Ogre2Node::SetOrigin(const math::Vector3d &_origin)
+{
+  BaseNode::SetOrigin(_origin);
+  this->MarkTransformDirty();
+}
+
+//////////////////////////////////////////////////
+math::Pose3d Ogre2Node::WorldPose() const
+{
+  if (this->worldTransformDirty)
+  {
+    this->cachedWorldPose = BaseNode::WorldPose();
+    this->cachedWorldScale = BaseNode::WorldScale();
+    this->worldTransformDirty = false;
+  }
+  return this->cachedWorldPose;
+}
+
+//////////////////////////////////////////////////
+math::Vector3d Ogre2Node::WorldScale() const
+{
+  if (this->worldTransformDirty)
+  {
+    this->cachedWorldPose = BaseNode::WorldPose();
+    this->cachedWorldScale = BaseNode::WorldScale();
+    this->worldTransformDirty = false;
+  }
+  return this->cachedWorldScale;
+}
+
+//////////////////////////////////////////////////
+void Ogre2Node::MarkTransformDirty()
+{
+  this->MarkBoundsDirty();
+  this->MarkSubtreeTransformDirty();
+}
+
+//////////////////////////////////////////////////
+void Ogre2Node::MarkSubtreeTransformDirty()
+{
+  if (this->worldTransformDirty)
+    return;
+
+  this->worldTransformDirty = true;
+  this->worldBoundsDirty = true;
+  this->localBoundsDirty = true;
+
+  if (!this->children)
+    return;
+
+  for (auto it = this->children->Begin(); it != this->children->End(); ++it)
+    it->second->MarkSubtreeTransformDirty();
+}
+
+//////////////////////////////////////////////////
+void Ogre2Node::MarkBoundsDirty()
+{
+  // always walk up to the root. The cached local bounds of an ancestor may
+  // have been computed without cleaning the bounds of its descendants
+  Ogre2Node *node = this;
+  while (node)
+  {
+    node->worldBoundsDirty = true;
+    node->localBoundsDirty = true;
+    node = node->parent.get();
+  }
 }
 
 
@@ -27,6 +27,10 @@
   // pulled in by anybody (e.g., Boost).
   #include <Winsock2.h>
 #endif
+#include <algorithm>
+#include <chrono>
+#include <map>
+
 #include <ignition/common/Console.hh>
 #include <ignition/common/Filesystem.hh>
 #include <ignition/common/Util.hh>
@@ -49,6 +53,19 @@ class ignition::rendering::Ogre2RenderEnginePrivate
 
   /// \brief A list of supported fsaa levels
   public: std::vector<unsigned int> fsaaLevels;
+
+  /// \brief Workspaces requested to be updated in the next frame
+  public: std::vector<Ogre::CompositorWorkspace *> renderRequests;
+
+  /// \brief True to batch render requests
+  public: bool batchRendering = true;
+
+  /// \brief Number of frames rendered for render requests
+  public: uint64_t frameCount = 0u;
+
+  /// \brief Share of the last frame time of each workspace rendered since
+  /// its time was last read
+  public: std::map<Ogre::CompositorWorkspace *, double> renderTimes;
 };
 
 using namespace ignition;
@@ -101,6 +118,8 @@ Ogre2RenderEngine::~Ogre2RenderEngine()
 //////////////////////////////////////////////////
 void Ogre2RenderEngine::Destroy()
 {
+  this->dataPtr->renderRequests.clear();
+
   BaseRenderEngine::Destroy();
 
   if (this->scenes)
@@ -788,6 +807,111 @@ Ogre::v1::OverlaySystem *Ogre2RenderEngine::OverlaySystem() const
   return this->ogreOverlaySystem;
 }
 
+/////////////////////////////////////////////////
+void Ogre2RenderEngine::RequestRender(Ogre::CompositorWorkspace *_workspace)
+{
+  if (!_workspace)
+    return;
+
+  auto &requests = this->dataPtr->renderRequests;
+  if (std::find(requests.begin(), requests.end(), _workspace) ==
+      requests.end())
+  {
+    _workspace->setEnabled(true);
+    requests.push_back(_workspace);
+  }
+
+  if (!this->dataPtr->batchRendering)
+    this->FlushRenderRequests();
+}
+
+/////////////////////////////////////////////////
+void Ogre2RenderEngine::FlushRenderRequests()
+{
+  if (this->dataPtr->renderRequests.empty())
+    return;
+
+  // Updating each workspace manually with _beginUpdate/_update/_endUpdate
+  // does not work in ogre 2.1 (https://forums.ogre3d.org/viewtopic.php?t=84687)
+  // so render one frame with only the requested workspaces enabled. The
+  // compositor manager updates the scene graph once and then the enabled
+  // workspaces in the order they were created.
+  auto start = std::chrono::steady_clock::now();
+  this->ogreRoot->renderOneFrame();
+  double seconds = std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - start).count();
+
+  // split the frame time between the workspaces by the size of their
+  // output, so that each render target only accounts for its own share
+  std::vector<double> pixels;
+  double totalPixels = 0.0;
+  for (auto workspace : this->dataPtr->renderRequests)
+  {
+    Ogre::RenderTarget *target = workspace->getFinalTarget();
+    pixels.push_back(target ?
+        static_cast<double>(target->getWidth()) * target->getHeight() : 0.0);
+    totalPixels += pixels.back();
+  }
+  for (unsigned int i = 0; i < this->dataPtr->renderRequests.size(); ++i)
+  {
+    this->dataPtr->renderTimes[this->dataPtr->renderRequests[i]] =
+        totalPixels > 0.0 ? seconds * pixels[i] / totalPixels :
+        seconds / this->dataPtr->renderRequests.size();
+  }
+
+  for (auto workspace : this->dataPtr->renderRequests)
+    workspace->setEnabled(false);
+  this->dataPtr->renderRequests.clear();
+  this->dataPtr->frameCount++;
+}
+
+/////////////////////////////////////////////////
+double Ogre2RenderEngine::PopRenderTime(
+    Ogre::CompositorWorkspace *_workspace)
+{
+  auto it = this->dataPtr->renderTimes.find(_workspace);
+  if (it == this->dataPtr->renderTimes.end())
+    return -1.0;
+
+  double seconds = it->second;
+  this->dataPtr->renderTimes.erase(it);
+  return seconds;
+}
+
+/////////////////////////////////////////////////
+void Ogre2RenderEngine::CancelRenderRequest(
+    Ogre::CompositorWorkspace *_workspace)
+{
+  this->dataPtr->renderTimes.erase(_workspace);
+  auto &requests = this->dataPtr->renderRequests;
+  auto it = std::find(requests.begin(), requests.end(), _workspace);
+  if (it != requests.end())
+  {
+    (*it)->setEnabled(false);
+    requests.erase(it);
+  }
+}
+
+/////////////////////////////////////////////////
+void Ogre2RenderEngine::SetBatchRendering(bool _batch)
+{
+  this->dataPtr->batchRendering = _batch;
+  if (!_batch)
+    this->FlushRenderRequests();
+}
+
+/////////////////////////////////////////////////
+bool Ogre2RenderEngine::BatchRendering() const
+{
+  return this->dataPtr->batchRendering;
+}
+
+/////////////////////////////////////////////////
+uint64_t Ogre2RenderEngine::FrameCount() const
+{
+  return this->dataPtr->frameCount;
+}
+
 // Register this plugin
 IGNITION_ADD_PLUGIN(ignition::rendering::Ogre2RenderEnginePlugin,
                     ignition::rendering::RenderEnginePlugin)
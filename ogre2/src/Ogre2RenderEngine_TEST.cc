@@ -0,0 +1,191 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+#include <ignition/math/Helpers.hh>
+
+#include "ignition/rendering/Camera.hh"
+#include "ignition/rendering/DepthCamera.hh"
+#include "ignition/rendering/Image.hh"
+#include "ignition/rendering/RenderEngine.hh"
+#include "ignition/rendering/RenderingIface.hh"
+#include "ignition/rendering/Scene.hh"
+#include "ignition/rendering/Visual.hh"
+#include "ignition/rendering/ogre2/Ogre2RenderEngine.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+/////////////////////////////////////////////////
+/// \brief Render all cameras, then read all of them back
+/// \param[in] _scene Scene of the cameras
+/// \param[in] _cameras Cameras to update
+/// \return Time taken in seconds
+double updateCameras(const ScenePtr &_scene,
+    const std::vector<CameraPtr> &_cameras)
+{
+  auto start = std::chrono::steady_clock::now();
+  _scene->PreRender();
+  for (auto &camera : _cameras)
+    camera->Render();
+  for (auto &camera : _cameras)
+    camera->PostRender();
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  return elapsed.count();
+}
+
+/////////////////////////////////////////////////
+TEST(Ogre2RenderEngineTest, BatchRendering)
+{
+  RenderEngine *engine = rendering::engine("ogre2");
+  if (!engine)
+  {
+    igndbg << "Engine 'ogre2' is not supported" << std::endl;
+    return;
+  }
+  Ogre2RenderEngine *ogreEngine = dynamic_cast<Ogre2RenderEngine *>(engine);
+  ASSERT_NE(nullptr, ogreEngine);
+  EXPECT_TRUE(ogreEngine->BatchRendering());
+
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+  scene->SetBackgroundColor(0.0, 0.0, 1.0);
+
+  // boxes around the origin and cameras looking at them from all sides
+  for (int i = 0; i < 4; ++i)
+  {
+    VisualPtr box = scene->CreateVisual();
+    box->AddGeometry(scene->CreateBox());
+    box->SetLocalPosition(std::cos(i * IGN_PI / 2.0),
+        std::sin(i * IGN_PI / 2.0), 0.0);
+    scene->RootVisual()->AddChild(box);
+  }
+
+  const unsigned int cameraCount = 12u;
+  std::vector<CameraPtr> cameras;
+  for (unsigned int i = 0u; i < cameraCount; ++i)
+  {
+    double yaw = 2.0 * IGN_PI * i / cameraCount;
+    CameraPtr camera = scene->CreateCamera();
+    camera->SetImageWidth(160u);
+    camera->SetImageHeight(120u);
+    camera->SetLocalPosition(5.0 * std::cos(yaw), 5.0 * std::sin(yaw), 0.0);
+    camera->SetLocalRotation(0.0, 0.0, yaw + IGN_PI);
+    scene->RootVisual()->AddChild(camera);
+    cameras.push_back(camera);
+  }
+
+  DepthCameraPtr depthCamera = scene->CreateDepthCamera();
+  depthCamera->SetImageWidth(160u);
+  depthCamera->SetImageHeight(120u);
+  depthCamera->SetFarClipPlane(10.0);
+  depthCamera->CreateDepthTexture();
+  depthCamera->SetLocalPosition(5.0, 0.0, 0.0);
+  depthCamera->SetLocalRotation(0.0, 0.0, IGN_PI);
+  scene->RootVisual()->AddChild(depthCamera);
+
+  // warm up
+  updateCameras(scene, cameras);
+
+  // images rendered one frame per camera
+  ogreEngine->SetBatchRendering(false);
+  EXPECT_FALSE(ogreEngine->BatchRendering());
+  uint64_t frames = ogreEngine->FrameCount();
+  double unbatchedTime = updateCameras(scene, cameras);
+  EXPECT_EQ(frames + cameraCount, ogreEngine->FrameCount());
+
+  std::vector<Image> expected;
+  for (auto &camera : cameras)
+  {
+    Image image = camera->CreateImage();
+    camera->Copy(image);
+    expected.push_back(image);
+  }
+
+  // the same images rendered in a single frame
+  ogreEngine->SetBatchRendering(true);
+  frames = ogreEngine->FrameCount();
+  double batchedTime = updateCameras(scene, cameras);
+  EXPECT_EQ(frames + 1u, ogreEngine->FrameCount());
+
+  unsigned int size = 160u * 120u * 3u;
+  for (unsigned int i = 0u; i < cameraCount; ++i)
+  {
+    Image image = cameras[i]->CreateImage();
+    cameras[i]->Copy(image);
+    const unsigned char *data = image.Data<unsigned char>();
+    const unsigned char *expectedData = expected[i].Data<unsigned char>();
+    unsigned int different = 0u;
+    for (unsigned int j = 0u; j < size; ++j)
+    {
+      if (data[j] != expectedData[j])
+        ++different;
+    }
+    EXPECT_EQ(0u, different) << "camera " << i;
+  }
+
+  std::cout << "Updating " << cameraCount << " cameras" << std::endl
+            << "  one frame per camera: " << unbatchedTime * 1000.0 << " ms"
+            << std::endl
+            << "  single frame:         " << batchedTime * 1000.0 << " ms"
+            << std::endl;
+
+  // sensors are batched with cameras, and reading back their data renders
+  // the requested frame
+  frames = ogreEngine->FrameCount();
+  scene->PreRender();
+  cameras[0]->Render();
+  depthCamera->Render();
+  EXPECT_EQ(frames, ogreEngine->FrameCount());
+  depthCamera->PostRender();
+  cameras[0]->PostRender();
+  EXPECT_EQ(frames + 1u, ogreEngine->FrameCount());
+  unsigned int mid = 60u * 160u + 80u;
+  EXPECT_NEAR(3.5, depthCamera->DepthData()[mid], 0.1);
+
+  // scene changes render the pending frames first
+  cameras[0]->Render();
+  scene->PreRender();
+  EXPECT_EQ(frames + 2u, ogreEngine->FrameCount());
+  cameras[0]->PostRender();
+  EXPECT_EQ(frames + 2u, ogreEngine->FrameCount());
+
+  // destroying a camera cancels its request
+  cameras[1]->Render();
+  scene->DestroySensor(cameras[1]);
+  ogreEngine->FlushRenderRequests();
+  EXPECT_EQ(frames + 2u, ogreEngine->FrameCount());
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -25,9 +25,14 @@
 #pragma warning(pop)
 #endif
 
+#include <cmath>
+#include <string>
+#include <vector>
+
 #include <ignition/common/Console.hh>
 
 #include "ignition/rendering/Material.hh"
+#include "ignition/rendering/Utils.hh"
 
 #include "ignition/rendering/ogre2/Ogre2Includes.hh"
 #include "ignition/rendering/ogre2/Ogre2RenderEngine.hh"
@@ -68,7 +73,7 @@ class Ogre2RenderTargetCompositorListener :
       IGN_ASSERT(scenePass != nullptr, "Unable to get scene pass");
       Ogre::Viewport *vp = scenePass->getViewport();
       // make sure we do not alter the reserved visibility flags
-      uint32_t f = ogreRenderTarget->VisibilityMask() |
+      uint32_t f = renderVisibilityMask(ogreRenderTarget->VisibilityMask()) |
           ~Ogre::VisibilityFlags::RESERVED_VISIBILITY_FLAGS;
       // apply the new visibility mask
       uint32_t flags = f & vp->getVisibilityMask();
@@ -83,16 +88,226 @@ class Ogre2RenderTargetCompositorListener :
 }
 }
 
+/// \brief Shadow node of the base scene node in the compositor scripts
+static const char kScriptShadowNode[] = "PbsMaterialsShadowNode";
+
+/// \brief Base scene node in the compositor scripts
+static const char kScriptSceneNode[] = "PbsMaterialsRenderingNode";
+
+/// \brief Workspace of the base scene node in the compositor scripts
+static const char kScriptWorkspace[] = "PbsMaterialsWorkspace";
+
 /// \brief Private data class for Ogre2RenderTarget
 class ignition::rendering::Ogre2RenderTargetPrivate
 {
+  /// \brief Set the size of the textures of a base scene node
+  /// definition relative to the render target, and the shadow node its
+  /// scene passes use. The definition in the compositor scripts is shared
+  /// by all render targets, so it must be set back to the defaults once
+  /// the nodes of a workspace are created.
+  /// \param[in] _nodeDefName Name of the base scene node definition
+  /// \param[in] _factor Fraction of the render target resolution
+  /// \param[in] _shadowNode Name of the shadow node definition
+  public: static void SetSceneNodeDefinition(const std::string &_nodeDefName,
+      double _factor, const std::string &_shadowNode);
+
+  /// \brief Create the base scene node and workspace definitions used to
+  /// render the views of the render target. The node is the same as the
+  /// base scene node of the compositor scripts, except that it has one
+  /// scene pass per view camera, each rendering into its own slice of the
+  /// target. The shadow maps are only rendered by the pass of the first
+  /// view and reused by the others.
+  /// \param[in] _name Name of the render target
+  /// \param[in] _color Background color
+  /// \return Name of the workspace definition
+  public: std::string CreateViewDefinitions(const std::string &_name,
+      const Ogre::ColourValue &_color);
+
+  /// \brief Remove the definitions created by CreateViewDefinitions, if
+  /// any, and go back to the definitions of the compositor scripts
+  public: void DestroyViewDefinitions();
+
+  /// \brief Recreate the compositor nodes of a workspace with the current
+  /// resolution scale and the current shadow node of the scene
+  /// \param[in] _workspace Workspace to recreate the nodes of
+  /// \param[in] _scene Scene of the render target
+  public: void RecreateNodes(Ogre::CompositorWorkspace *_workspace,
+      const Ogre2ScenePtr &_scene);
+
   /// \brief Listener for chaning compositor pass properties
   public: Ogre2RenderTargetCompositorListener *rtListener = nullptr;
+
+  /// \brief Resolution scale the compositor nodes were created with
+  public: double appliedResolutionScale = 1.0;
+
+  /// \brief Shadow node definition the compositor nodes were created with
+  public: std::string shadowNodeDefName;
+
+  /// \brief Cameras of the views rendered side by side into the target.
+  /// When empty, the whole target is rendered with the render target
+  /// camera.
+  public: std::vector<Ogre::Camera *> viewCameras;
+
+  /// \brief For each view, true if it reuses the shadow maps of the first
+  /// view
+  public: std::vector<bool> reuseShadows;
+
+  /// \brief Name of the base scene node definition of the workspace
+  public: std::string baseNodeDefName = kScriptSceneNode;
+
+  /// \brief Name of the workspace definition created for the views
+  public: std::string viewWorkspaceDefName;
 };
 
 using namespace ignition;
 using namespace rendering;
 
+//////////////////////////////////////////////////
+void Ogre2RenderTargetPrivate::SetSceneNodeDefinition(
+    const std::string &_nodeDefName, double _factor,
+    const std::string &_shadowNode)
+{
+  auto engine = Ogre2RenderEngine::Instance();
+  Ogre::CompositorManager2 *ogreCompMgr =
+      engine->OgreRoot()->getCompositorManager2();
+  Ogre::CompositorNodeDef *nodeDef =
+      ogreCompMgr->getNodeDefinitionNonConst(_nodeDefName);
+
+  // only scale the textures sized relative to the render target, i.e.
+  // the ones declared with target_width and target_height
+  Ogre::Real factor = static_cast<Ogre::Real>(_factor);
+  auto &textureDefs = nodeDef->getLocalTextureDefinitionsNonConst();
+  for (auto &textureDef : textureDefs)
+  {
+    if (textureDef.width == 0u)
+      textureDef.widthFactor = factor;
+    if (textureDef.height == 0u)
+      textureDef.heightFactor = factor;
+  }
+
+  for (size_t i = 0u; i < nodeDef->getNumTargetPasses(); ++i)
+  {
+    Ogre::CompositorTargetDef *targetDef = nodeDef->getTargetPass(i);
+    for (auto passDef : targetDef->getCompositorPassesNonConst())
+    {
+      if (passDef->getType() != Ogre::PASS_SCENE)
+        continue;
+      Ogre::CompositorPassSceneDef *passScene =
+          static_cast<Ogre::CompositorPassSceneDef *>(passDef);
+      passScene->mShadowNode = _shadowNode;
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+void Ogre2RenderTargetPrivate::RecreateNodes(
+    Ogre::CompositorWorkspace *_workspace, const Ogre2ScenePtr &_scene)
+{
+  std::string shadowNode = _scene->ShadowNodeDefinitionName();
+  SetSceneNodeDefinition(this->baseNodeDefName, this->appliedResolutionScale,
+      shadowNode);
+  _workspace->recreateAllNodes();
+  SetSceneNodeDefinition(this->baseNodeDefName, 1.0, kScriptShadowNode);
+
+  // retain first in case the shadow node did not change
+  _scene->RetainShadowNode(shadowNode);
+  _scene->ReleaseShadowNode(this->shadowNodeDefName);
+  this->shadowNodeDefName = shadowNode;
+}
+
+//////////////////////////////////////////////////
+std::string Ogre2RenderTargetPrivate::CreateViewDefinitions(
+    const std::string &_name, const Ogre::ColourValue &_color)
+{
+  auto engine = Ogre2RenderEngine::Instance();
+  Ogre::CompositorManager2 *ogreCompMgr =
+      engine->OgreRoot()->getCompositorManager2();
+
+  std::string wsDefName = _name + "/MultiViewWorkspace";
+  std::string nodeDefName = wsDefName + "/BaseNode";
+  Ogre::CompositorNodeDef *nodeDef =
+      ogreCompMgr->addNodeDefinition(nodeDefName);
+
+  // rt0 and rt1 are sized relative to the render target, like the
+  // textures declared with target_width and target_height
+  for (const char *texName : {"rt0", "rt1"})
+  {
+    Ogre::TextureDefinitionBase::TextureDefinition *texDef =
+        nodeDef->addTextureDefinition(texName);
+    texDef->textureType = Ogre::TEX_TYPE_2D;
+    texDef->width = 0;
+    texDef->height = 0;
+    texDef->widthFactor = 1;
+    texDef->heightFactor = 1;
+    texDef->formatList = {Ogre::PF_R8G8B8};
+  }
+
+  nodeDef->setNumTargetPass(1);
+  Ogre::CompositorTargetDef *targetDef = nodeDef->addTargetPass("rt0");
+  targetDef->setNumPasses(1u + this->viewCameras.size());
+  {
+    // clear pass, for the whole target
+    Ogre::CompositorPassClearDef *passClear =
+        static_cast<Ogre::CompositorPassClearDef *>(
+        targetDef->addPass(Ogre::PASS_CLEAR));
+    passClear->mColourValue = _color;
+  }
+
+  // one scene pass per view, from left to right. All views use the first
+  // one for level of detail so that they see the same meshes. Shadow maps
+  // are fitted to the frustum of a view, so views that do not overlap the
+  // first one render their own.
+  Ogre::Real viewWidth =
+      static_cast<Ogre::Real>(1.0 / this->viewCameras.size());
+  for (size_t i = 0u; i < this->viewCameras.size(); ++i)
+  {
+    Ogre::CompositorPassSceneDef *passScene =
+        static_cast<Ogre::CompositorPassSceneDef *>(
+        targetDef->addPass(Ogre::PASS_SCENE));
+    passScene->mCameraName = this->viewCameras[i]->getName();
+    passScene->mLodCameraName = this->viewCameras[0]->getName();
+    passScene->mShadowNode = kScriptShadowNode;
+    if (i > 0u && i < this->reuseShadows.size() && this->reuseShadows[i])
+      passScene->mShadowNodeRecalculation = Ogre::SHADOW_NODE_REUSE;
+    else
+      passScene->mShadowNodeRecalculation = Ogre::SHADOW_NODE_RECALCULATE;
+    passScene->mIncludeOverlays = true;
+    passScene->mVpLeft = viewWidth * i;
+    passScene->mVpTop = 0;
+    passScene->mVpWidth = viewWidth;
+    passScene->mVpHeight = 1;
+  }
+
+  nodeDef->mapOutputChannel(0, "rt0");
+  nodeDef->mapOutputChannel(1, "rt1");
+
+  // same connections as PbsMaterialsWorkspace
+  Ogre::CompositorWorkspaceDef *workspaceDef =
+      ogreCompMgr->addWorkspaceDefinition(wsDefName);
+  workspaceDef->connect(nodeDefName, 0, "FinalComposition", 1);
+  workspaceDef->connectExternal(0, "FinalComposition", 0);
+
+  this->baseNodeDefName = nodeDefName;
+  this->viewWorkspaceDefName = wsDefName;
+  return wsDefName;
+}
+
+//////////////////////////////////////////////////
+void Ogre2RenderTargetPrivate::DestroyViewDefinitions()
+{
+  if (this->viewWorkspaceDefName.empty())
+    return;
+
+  auto engine = Ogre2RenderEngine::Instance();
+  Ogre::CompositorManager2 *ogreCompMgr =
+      engine->OgreRoot()->getCompositorManager2();
+  ogreCompMgr->removeWorkspaceDefinition(this->viewWorkspaceDefName);
+  ogreCompMgr->removeNodeDefinition(this->baseNodeDefName);
+
+  this->viewWorkspaceDefName.clear();
+  this->baseNodeDefName = kScriptSceneNode;
+}
+
 //////////////////////////////////////////////////
 // Ogre2RenderTarget
 //////////////////////////////////////////////////
@@ -100,7 +315,7 @@ Ogre2RenderTarget::Ogre2RenderTarget()
   : dataPtr(new Ogre2RenderTargetPrivate)
 {
   this->ogreBackgroundColor = Ogre::ColourValue::Black;
-  this->ogreCompositorWorkspaceDefName = "PbsMaterialsWorkspace";
+  this->ogreCompositorWorkspaceDefName = kScriptWorkspace;
 }
 
 //////////////////////////////////////////////////
@@ -116,16 +331,35 @@ Ogre2RenderTarget::~Ogre2RenderTarget()
 //////////////////////////////////////////////////
 void Ogre2RenderTarget::BuildCompositor()
 {
-  this->UpdateShadowNode();
+  this->scene->UpdateShadowNode();
 
   auto engine = Ogre2RenderEngine::Instance();
   auto ogreRoot = engine->OgreRoot();
   Ogre::CompositorManager2 *ogreCompMgr = ogreRoot->getCompositorManager2();
 
+  // several views are rendered by a workspace of their own, in the same
+  // scene pass node
+  if (!this->dataPtr->viewCameras.empty())
+  {
+    this->ogreCompositorWorkspaceDefName =
+        this->dataPtr->CreateViewDefinitions(this->name,
+        this->ogreBackgroundColor);
+  }
+
+  // the scene is rendered at the resolution scale and upscaled to the
+  // render target by the final composition node
+  this->dataPtr->appliedResolutionScale = this->ResolutionScale();
+  this->dataPtr->shadowNodeDefName = this->scene->ShadowNodeDefinitionName();
+  Ogre2RenderTargetPrivate::SetSceneNodeDefinition(
+      this->dataPtr->baseNodeDefName, this->dataPtr->appliedResolutionScale,
+      this->dataPtr->shadowNodeDefName);
   this->ogreCompositorWorkspace =
       ogreCompMgr->addWorkspace(this->scene->OgreSceneManager(),
       this->RenderTarget(), this->ogreCamera,
       this->ogreCompositorWorkspaceDefName, false);
+  Ogre2RenderTargetPrivate::SetSceneNodeDefinition(
+      this->dataPtr->baseNodeDefName, 1.0, kScriptShadowNode);
+  this->scene->RetainShadowNode(this->dataPtr->shadowNodeDefName);
 
   this->dataPtr->rtListener = new Ogre2RenderTargetCompositorListener(this);
   this->ogreCompositorWorkspace->setListener(this->dataPtr->rtListener);
@@ -140,11 +374,21 @@ void Ogre2RenderTarget::DestroyCompositor()
   auto engine = Ogre2RenderEngine::Instance();
   auto ogreRoot = engine->OgreRoot();
   Ogre::CompositorManager2 *ogreCompMgr = ogreRoot->getCompositorManager2();
+  engine->CancelRenderRequest(this->ogreCompositorWorkspace);
   this->ogreCompositorWorkspace->setListener(nullptr);
   ogreCompMgr->removeWorkspace(this->ogreCompositorWorkspace);
   this->ogreCompositorWorkspace = nullptr;
   delete this->dataPtr->rtListener;
   this->dataPtr->rtListener = nullptr;
+
+  this->scene->ReleaseShadowNode(this->dataPtr->shadowNodeDefName);
+  this->dataPtr->shadowNodeDefName.clear();
+
+  if (!this->dataPtr->viewWorkspaceDefName.empty())
+  {
+    this->dataPtr->DestroyViewDefinitions();
+    this->ogreCompositorWorkspaceDefName = kScriptWorkspace;
+  }
 }
 
 //////////////////////////////////////////////////
@@ -166,6 +410,9 @@ void Ogre2RenderTarget::Copy(Image &_image) const
     return;
   }
 
+  // make sure the last requested frame is rendered
+  Ogre2RenderEngine::Instance()->FlushRenderRequests();
+
   void *data = _image.Data();
   Ogre::PixelFormat imageFormat = Ogre2Conversions::Convert(_image.Format());
   Ogre::PixelBox ogrePixelBox(this->width, this->height, 1, imageFormat, data);
@@ -185,6 +432,25 @@ void Ogre2RenderTarget::SetCamera(Ogre::Camera *_camera)
   this->targetDirty = true;
 }
 
+//////////////////////////////////////////////////
+void Ogre2RenderTarget::SetViewCameras(
+    const std::vector<Ogre::Camera *> &_cameras,
+    const std::vector<bool> &_reuseShadows)
+{
+  if (_cameras == this->dataPtr->viewCameras &&
+      _reuseShadows == this->dataPtr->reuseShadows)
+  {
+    return;
+  }
+
+  // the workspace renders with the cameras of the views, so destroy it now
+  // in case they are destroyed before the target is rebuilt
+  this->DestroyCompositor();
+  this->dataPtr->viewCameras = _cameras;
+  this->dataPtr->reuseShadows = _reuseShadows;
+  this->targetDirty = true;
+}
+
 //////////////////////////////////////////////////
 math::Color Ogre2RenderTarget::BackgroundColor() const
 {
@@ -223,44 +489,37 @@ void Ogre2RenderTarget::PreRender()
   }
 
   this->UpdateRenderPassChain();
+  this->UpdateResolutionScale();
+  this->UpdateShadowNode();
 }
 
 //////////////////////////////////////////////////
 void Ogre2RenderTarget::PostRender()
 {
-  // do nothing by default
+  // render this target, together with the other targets that were
+  // requested since the last frame
+  Ogre2RenderEngine::Instance()->FlushRenderRequests();
+
+  // measure the frame time for dynamic resolution
+  BaseRenderTarget::PostRender();
+}
+
+//////////////////////////////////////////////////
+double Ogre2RenderTarget::FrameTime()
+{
+  // the workspace may be rendered in a batch with other targets, or by a
+  // flush before PostRender, so use its share of the frame that rendered
+  // it instead of the time since PreRender
+  return Ogre2RenderEngine::Instance()->PopRenderTime(
+      this->ogreCompositorWorkspace);
 }
 
 //////////////////////////////////////////////////
 void Ogre2RenderTarget::Render()
 {
-  // TODO(anyone)
-  // There is current not an easy solution to manually updating
-  // render textures:
-  // https://forums.ogre3d.org/viewtopic.php?t=84687
-  this->ogreCompositorWorkspace->setEnabled(true);
-  auto engine = Ogre2RenderEngine::Instance();
-  engine->OgreRoot()->renderOneFrame();
-  this->ogreCompositorWorkspace->setEnabled(false);
-
-  // The code below for manual updating render textures was suggested in ogre
-  // forum but it does not seem to work
-  // this->scene->OgreSceneManager()->updateSceneGraph();
-  // this->ogreCompositorWorkspace->_validateFinalTarget();
-  // engine->OgreRoot()->getRenderSystem()->_beginFrameOnce();
-  // this->ogreCompositorWorkspace->_beginUpdate(false);
-  // this->ogreCompositorWorkspace->_update();
-  // this->ogreCompositorWorkspace->_endUpdate(false);
-
-  // this->scene->OgreSceneManager()->_frameEnded();
-  // for (size_t i=0; i < Ogre::HLMS_MAX; ++i)
-  // {
-  //   Ogre::Hlms *hlms = engine->OgreRoot()->getHlmsManager()->getHlms(
-  //       static_cast<Ogre::HlmsTypes>(i));
-  //   if(hlms)
-  //     hlms->frameEnded();
-  // }
-  // engine->OgreRoot()->getRenderSystem()->_update();
+  // the workspace is updated in PostRender, in the same Ogre frame as the
+  // other render targets and sensors rendered in between
+  Ogre2RenderEngine::Instance()->RequestRender(this->ogreCompositorWorkspace);
 }
 
 //////////////////////////////////////////////////
@@ -294,20 +553,39 @@ void Ogre2RenderTarget::UpdateBackgroundColor()
 //////////////////////////////////////////////////
 void Ogre2RenderTarget::UpdateRenderPassChain()
 {
+  // nodes may be recreated, keep the current resolution scale and
+  // shadow node
+  Ogre2RenderTargetPrivate::SetSceneNodeDefinition(
+      this->dataPtr->baseNodeDefName, this->dataPtr->appliedResolutionScale,
+      this->dataPtr->shadowNodeDefName);
   UpdateRenderPassChain(this->ogreCompositorWorkspace,
       this->ogreCompositorWorkspaceDefName,
-      "PbsMaterialsRenderingNode", "FinalComposition",
+      this->dataPtr->baseNodeDefName, "FinalComposition",
       this->renderPasses, this->renderPassDirty);
+  Ogre2RenderTargetPrivate::SetSceneNodeDefinition(
+      this->dataPtr->baseNodeDefName, 1.0, kScriptShadowNode);
 
   this->renderPassDirty = false;
 }
 
+//////////////////////////////////////////////////
+void Ogre2RenderTarget::UpdateResolutionScale()
+{
+  double scale = this->ResolutionScale();
+  if (!this->ogreCompositorWorkspace ||
+      std::abs(scale - this->dataPtr->appliedResolutionScale) < 1e-6)
+    return;
+
+  this->dataPtr->appliedResolutionScale = scale;
+  this->dataPtr->RecreateNodes(this->ogreCompositorWorkspace, this->scene);
+}
+
 //////////////////////////////////////////////////
 void Ogre2RenderTarget::UpdateRenderPassChain(
     Ogre::CompositorWorkspace *_workspace, const std::string &_workspaceDefName,
     const std::string &_baseNode, const std::string &_finalNode,
     const std::vector<RenderPassPtr> &_renderPasses,
-    bool _recreateNodes)
+    bool _recreateNodes, unsigned int _baseNodeInputs)
 {
   if (!_workspace || _workspaceDefName.empty() ||
       _baseNode.empty() || _finalNode.empty() || _renderPasses.empty())
@@ -397,8 +675,10 @@ void Ogre2RenderTarget::UpdateRenderPassChain(
   // otherwise update the connections
   if (_recreateNodes)
   {
-    // clearAll requires the output to be connected again.
+    // clearAll requires the output and inputs to be connected again.
     workspaceDef->connectExternal(0, finalNodeDefName, 0);
+    for (unsigned int i = 0u; i < _baseNodeInputs; ++i)
+      workspaceDef->connectExternal(1u + i, _baseNode, i);
     _workspace->recreateAllNodes();
   }
   else
@@ -410,398 +690,16 @@ void Ogre2RenderTarget::UpdateRenderPassChain(
 //////////////////////////////////////////////////
 void Ogre2RenderTarget::UpdateShadowNode()
 {
-  if (!this->scene->ShadowsDirty())
-    return;
-
-  unsigned int spotPointLightCount = 0;
-  unsigned int dirLightCount = 0;
-
-  for (unsigned int i = 0; i < this->scene->LightCount(); ++i)
-  {
-    LightPtr light = this->scene->LightByIndex(i);
-    if (light->CastShadows())
-    {
-      if (std::dynamic_pointer_cast<DirectionalLight>(light))
-        dirLightCount++;
-      else
-        spotPointLightCount++;
-    }
-  }
-
-  // limit number of shadow maps
-  // shaders dynamically generated by ogre produce compile error at runtime if
-  // the number of shadow maps exceeds certain number. The error seems to
-  // suggest that the number of uniform variables has exceeded the max number
-  // allowed
-  unsigned int maxShadowMaps = 25u;
-  if (dirLightCount * 3 + spotPointLightCount > maxShadowMaps)
-  {
-    dirLightCount = std::min(static_cast<unsigned int>(maxShadowMaps / 3),
-        dirLightCount);
-    spotPointLightCount = std::min(
-        std::max(maxShadowMaps - dirLightCount * 3, 0u), spotPointLightCount);
-    ignwarn << "Number of shadow-casting lights exceeds the limit supported by "
-            << "the underlying rendering engine ogre2. Limiting to "
-            << dirLightCount << " directional lights and "
-            << spotPointLightCount << " point / spot lights" << std::endl;
-  }
-
-  auto engine = Ogre2RenderEngine::Instance();
-  Ogre::CompositorManager2 *compositorManager =
-      engine->OgreRoot()->getCompositorManager2();
-
-  Ogre::ShadowNodeHelper::ShadowParamVec shadowParams;
-  Ogre::ShadowNodeHelper::ShadowParam shadowParam;
-
-  // directional lights
-  unsigned int atlasId = 0u;
-  unsigned int texSize = 2048u;
-  unsigned int halfTexSize = texSize * 0.5;
-  for (unsigned int i = 0; i < dirLightCount; ++i)
-  {
-    shadowParam.technique = Ogre::SHADOWMAP_PSSM;
-    shadowParam.atlasId = atlasId;
-    shadowParam.numPssmSplits = 3u;
-    shadowParam.resolution[0].x = texSize;
-    shadowParam.resolution[0].y = texSize;
-    shadowParam.resolution[1].x = halfTexSize;
-    shadowParam.resolution[1].y = halfTexSize;
-    shadowParam.resolution[2].x = halfTexSize;
-    shadowParam.resolution[2].y = halfTexSize;
-    shadowParam.atlasStart[0].x = 0u;
-    shadowParam.atlasStart[0].y = 0u;
-    shadowParam.atlasStart[1].x = 0u;
-    shadowParam.atlasStart[1].y = texSize;
-    shadowParam.atlasStart[2].x = halfTexSize;
-    shadowParam.atlasStart[2].y = texSize;
-    shadowParam.supportedLightTypes = 0u;
-    shadowParam.addLightType(Ogre::Light::LT_DIRECTIONAL);
-    shadowParams.push_back(shadowParam);
-    atlasId++;
-  }
-
-  // others
-  unsigned int maxTexSize = 8192u;
-  unsigned int rowIdx = 0;
-  unsigned int colIdx = 0;
-  unsigned int rowSize = maxTexSize / texSize;
-  unsigned int colSize = rowSize;
-
-  for (unsigned int i = 0; i < spotPointLightCount; ++i)
-  {
-    shadowParam.technique = Ogre::SHADOWMAP_FOCUSED;
-    shadowParam.atlasId = atlasId;
-    shadowParam.resolution[0].x = texSize;
-    shadowParam.resolution[0].y = texSize;
-    shadowParam.atlasStart[0].x = colIdx * texSize;
-    shadowParam.atlasStart[0].y = rowIdx * texSize;
-
-    shadowParam.supportedLightTypes = 0u;
-    shadowParam.addLightType(Ogre::Light::LT_DIRECTIONAL);
-    shadowParam.addLightType(Ogre::Light::LT_POINT);
-    shadowParam.addLightType(Ogre::Light::LT_SPOTLIGHT);
-    shadowParams.push_back(shadowParam);
-
-    colIdx++;
-    colIdx = colIdx % colSize;
-    if (colIdx == 0u)
-      rowIdx++;
-
-    // check if we've filled the current texture atlas
-    // if so, increment atlas id to indicate we want a new texture
-    if (rowIdx >= rowSize)
-    {
-      atlasId++;
-      colIdx = 0;
-      rowIdx = 0;
-    }
-  }
-
-  std::string shadowNodeDefName = "PbsMaterialsShadowNode";
-  if (compositorManager->hasShadowNodeDefinition(shadowNodeDefName))
-    compositorManager->removeShadowNodeDefinition(shadowNodeDefName);
-
-  this->CreateShadowNodeWithSettings(compositorManager, shadowNodeDefName,
-      shadowParams);
-
-  this->scene->SetShadowsDirty(false);
-}
-
-////////////////////////////////////////////////////
-void Ogre2RenderTarget::CreateShadowNodeWithSettings(
-    Ogre::CompositorManager2 *_compositorManager,
-    const std::string &_shadowNodeName,
-    const Ogre::ShadowNodeHelper::ShadowParamVec &_shadowParams)
-{
-  Ogre::uint32 pointLightCubemapResolution = 1024u;
-  Ogre::Real pssmLambda = 0.95f;
-  Ogre::Real splitPadding = 1.0f;
-  Ogre::Real splitBlend = 0.125f;
-  Ogre::Real splitFade = 0.313f;
-
-  const Ogre::uint32 spotMask           = 1u << Ogre::Light::LT_SPOTLIGHT;
-  const Ogre::uint32 directionalMask    = 1u << Ogre::Light::LT_DIRECTIONAL;
-  const Ogre::uint32 pointMask          = 1u << Ogre::Light::LT_POINT;
-  const Ogre::uint32 spotAndDirMask = spotMask | directionalMask;
-
-  typedef Ogre::vector<Ogre::ShadowNodeHelper::Resolution>::type ResolutionVec;
-
-  size_t numExtraShadowMapsForPssmSplits = 0;
-  size_t numTargetPasses = 0;
-  ResolutionVec atlasResolutions;
-
-  // Validation and data gathering
-  bool hasPointLights = false;
-
-  Ogre::ShadowNodeHelper::ShadowParamVec::const_iterator itor =
-      _shadowParams.begin();
-  Ogre::ShadowNodeHelper::ShadowParamVec::const_iterator end =
-      _shadowParams.end();
-
-  while (itor != end)
-  {
-    if (itor->technique == Ogre::SHADOWMAP_PSSM)
-    {
-      numExtraShadowMapsForPssmSplits = itor->numPssmSplits - 1u;
-      // 1 per PSSM split
-      numTargetPasses += numExtraShadowMapsForPssmSplits + 1u;
-    }
-
-    if (itor->atlasId >= atlasResolutions.size())
-      atlasResolutions.resize(itor->atlasId + 1u);
-
-    Ogre::ShadowNodeHelper::Resolution &resolution =
-        atlasResolutions[itor->atlasId];
+  this->scene->UpdateShadowNode();
 
-    const size_t numSplits = itor->technique == Ogre::SHADOWMAP_PSSM ?
-        itor->numPssmSplits : 1u;
-    for (size_t i = 0; i < numSplits; ++i)
-    {
-      resolution.x = std::max(resolution.x,
-          itor->atlasStart[i].x + itor->resolution[i].x);
-      resolution.y = std::max(resolution.y,
-          itor->atlasStart[i].y + itor->resolution[i].y);
-    }
-
-    if (itor->supportedLightTypes & pointMask)
-    {
-      hasPointLights = true;
-      // 6 target passes per cubemap + 1 for copy
-      numTargetPasses += 7u;
-    }
-    if (itor->supportedLightTypes & spotAndDirMask &&
-        itor->technique != Ogre::SHADOWMAP_PSSM)
-    {
-      // 1 per directional/spot light (for non-PSSM techniques)
-      numTargetPasses += 1u;
-    }
-    ++itor;
-  }
-
-  // One clear for each atlas
-  numTargetPasses += atlasResolutions.size();
-  // Create the shadow node definition
-  Ogre::CompositorShadowNodeDef *shadowNodeDef =
-      _compositorManager->addShadowNodeDefinition(_shadowNodeName);
-
-  const size_t numTextures = atlasResolutions.size();
-  {
-    // Define the atlases (textures)
-    shadowNodeDef->setNumLocalTextureDefinitions(
-        numTextures + (hasPointLights ? 1u : 0u));
-    for (size_t i = 0; i < numTextures; ++i)
-    {
-      const Ogre::ShadowNodeHelper::Resolution &atlasRes = atlasResolutions[i];
-      Ogre::TextureDefinitionBase::TextureDefinition *texDef =
-          shadowNodeDef->addTextureDefinition(
-          "atlas" + Ogre::StringConverter::toString(i));
-
-      texDef->width = std::max(atlasRes.x, 1u);
-      texDef->height = std::max(atlasRes.y, 1u);
-      texDef->formatList.push_back(Ogre::PF_D32_FLOAT);
-      texDef->depthBufferId = Ogre::DepthBuffer::POOL_NON_SHAREABLE;
-      texDef->depthBufferFormat = Ogre::PF_D32_FLOAT;
-      texDef->preferDepthTexture = false;
-      texDef->fsaa = false;
-    }
-
-    // Define the cubemap needed by point lights
-    if (hasPointLights)
-    {
-      Ogre::TextureDefinitionBase::TextureDefinition *texDef =
-          shadowNodeDef->addTextureDefinition("tmpCubemap");
-
-      texDef->width   = pointLightCubemapResolution;
-      texDef->height  = pointLightCubemapResolution;
-      texDef->depth   = 6u;
-      texDef->textureType = Ogre::TEX_TYPE_CUBE_MAP;
-      texDef->formatList.push_back(Ogre::PF_FLOAT32_R);
-      texDef->depthBufferId = 1u;
-      texDef->depthBufferFormat = Ogre::PF_D32_FLOAT;
-      texDef->preferDepthTexture = false;
-      texDef->fsaa = false;
-    }
-  }
-
-  // Create the shadow maps
-  const size_t numShadowMaps =
-      _shadowParams.size() + numExtraShadowMapsForPssmSplits;
-  shadowNodeDef->setNumShadowTextureDefinitions(numShadowMaps);
-
-  itor = _shadowParams.begin();
-
-  while (itor != end)
-  {
-    const size_t lightIdx = itor - _shadowParams.begin();
-    const Ogre::ShadowNodeHelper::ShadowParam &shadowParam = *itor;
-
-    const Ogre::ShadowNodeHelper::Resolution &texResolution =
-        atlasResolutions[shadowParam.atlasId];
-
-    const size_t numSplits =
-        shadowParam.technique == Ogre::SHADOWMAP_PSSM ?
-        shadowParam.numPssmSplits : 1u;
-
-    for (size_t j = 0; j < numSplits; ++j)
-    {
-      Ogre::Vector2 uvOffset(
-          shadowParam.atlasStart[j].x, shadowParam.atlasStart[j].y);
-      Ogre::Vector2 uvLength(
-          shadowParam.resolution[j].x, shadowParam.resolution[j].y);
-
-      uvOffset /= Ogre::Vector2(texResolution.x, texResolution.y);
-      uvLength /= Ogre::Vector2(texResolution.x, texResolution.y);
-
-      const Ogre::String texName =
-          "atlas" + Ogre::StringConverter::toString(shadowParam.atlasId);
-
-      Ogre::ShadowTextureDefinition *shadowTexDef =
-          shadowNodeDef->addShadowTextureDefinition(lightIdx, j, texName,
-          0, uvOffset, uvLength, 0);
-      shadowTexDef->shadowMapTechnique = shadowParam.technique;
-      shadowTexDef->pssmLambda = pssmLambda;
-      shadowTexDef->splitPadding = splitPadding;
-      shadowTexDef->splitBlend = splitBlend;
-      shadowTexDef->splitFade = splitFade;
-      shadowTexDef->numSplits = numSplits;
-    }
-    ++itor;
-  }
-
-  shadowNodeDef->setNumTargetPass(numTargetPasses);
-
-  // Create the passes for each atlas
-  for (size_t atlasId = 0; atlasId < numTextures; ++atlasId)
-  {
-    const Ogre::String texName =
-        "atlas" + Ogre::StringConverter::toString(atlasId);
-    {
-      // Atlas clear pass
-      Ogre::CompositorTargetDef *targetDef =
-          shadowNodeDef->addTargetPass(texName);
-      targetDef->setNumPasses(1u);
-
-      Ogre::CompositorPassDef *passDef = targetDef->addPass(Ogre::PASS_CLEAR);
-      Ogre::CompositorPassClearDef *passClear =
-          static_cast<Ogre::CompositorPassClearDef *>(passDef);
-      passClear->mColourValue = Ogre::ColourValue::White;
-      passClear->mDepthValue = 1.0f;
-    }
-
-    // Pass scene for directional and spot lights first
-    size_t shadowMapIdx = 0;
-    itor = _shadowParams.begin();
-    while (itor != end)
-    {
-      const Ogre::ShadowNodeHelper::ShadowParam &shadowParam = *itor;
-      const size_t numSplits = shadowParam.technique == Ogre::SHADOWMAP_PSSM ?
-          shadowParam.numPssmSplits : 1u;
-      if (shadowParam.atlasId == atlasId &&
-          shadowParam.supportedLightTypes & spotAndDirMask)
-      {
-        size_t currentShadowMapIdx = shadowMapIdx;
-        for (size_t i = 0; i < numSplits; ++i)
-        {
-          Ogre::CompositorTargetDef *targetDef =
-              shadowNodeDef->addTargetPass(texName);
-          targetDef->setShadowMapSupportedLightTypes(
-              shadowParam.supportedLightTypes & spotAndDirMask);
-          targetDef->setNumPasses(1u);
-
-          Ogre::CompositorPassDef *passDef =
-              targetDef->addPass(Ogre::PASS_SCENE);
-          Ogre::CompositorPassSceneDef *passScene =
-              static_cast<Ogre::CompositorPassSceneDef *>(passDef);
-
-          passScene->mShadowMapIdx = currentShadowMapIdx + i;
-          passScene->mIncludeOverlays = false;
-        }
-      }
-      shadowMapIdx += numSplits;
-      ++itor;
-    }
+  // only recreate the nodes when the scene replaced the shadow node
+  // definition, i.e. when the shadow casting lights no longer fit
+  if (!this->ogreCompositorWorkspace ||
+      this->dataPtr->shadowNodeDefName ==
+      this->scene->ShadowNodeDefinitionName())
+    return;
 
-    // Pass scene for point lights last
-    shadowMapIdx = 0;
-    itor = _shadowParams.begin();
-    while (itor != end)
-    {
-      const Ogre::ShadowNodeHelper::ShadowParam &shadowParam = *itor;
-      if (shadowParam.atlasId == atlasId &&
-          shadowParam.supportedLightTypes & pointMask)
-      {
-        // Render to cubemap, each face clear + render
-        for (Ogre::uint32 i = 0; i < 6u; ++i)
-        {
-          Ogre::CompositorTargetDef *targetDef =
-              shadowNodeDef->addTargetPass("tmpCubemap", i);
-          targetDef->setNumPasses(2u);
-          targetDef->setShadowMapSupportedLightTypes(
-              shadowParam.supportedLightTypes & pointMask);
-          {
-            // Clear pass
-            Ogre::CompositorPassDef *passDef =
-                targetDef->addPass(Ogre::PASS_CLEAR);
-            Ogre::CompositorPassClearDef *passClear =
-                static_cast<Ogre::CompositorPassClearDef *>(passDef);
-            passClear->mColourValue = Ogre::ColourValue::White;
-            passClear->mDepthValue = 1.0f;
-            passClear->mShadowMapIdx = shadowMapIdx;
-          }
-
-          {
-            // Scene pass
-            Ogre::CompositorPassDef *passDef =
-                targetDef->addPass(Ogre::PASS_SCENE);
-            Ogre::CompositorPassSceneDef *passScene =
-                static_cast<Ogre::CompositorPassSceneDef *>(passDef);
-            passScene->mCameraCubemapReorient = true;
-            passScene->mShadowMapIdx = shadowMapIdx;
-            passScene->mIncludeOverlays = false;
-          }
-        }
-
-        // Copy to the atlas using a pass quad
-        // (Cubemap -> DPSM / Dual Paraboloid).
-        Ogre::CompositorTargetDef *targetDef =
-            shadowNodeDef->addTargetPass(texName);
-        targetDef->setShadowMapSupportedLightTypes(
-            shadowParam.supportedLightTypes & pointMask);
-        targetDef->setNumPasses(1u);
-        Ogre::CompositorPassDef *passDef = targetDef->addPass(Ogre::PASS_QUAD);
-        Ogre::CompositorPassQuadDef *passQuad =
-            static_cast<Ogre::CompositorPassQuadDef *>(passDef);
-        passQuad->mMaterialIsHlms = false;
-        passQuad->mMaterialName = "Ogre/DPSM/CubeToDpsm";
-        passQuad->addQuadTextureSource(0, "tmpCubemap", 0);
-        passQuad->mShadowMapIdx = shadowMapIdx;
-      }
-      const size_t numSplits = shadowParam.technique ==
-          Ogre::SHADOWMAP_PSSM ? shadowParam.numPssmSplits : 1u;
-      shadowMapIdx += numSplits;
-      ++itor;
-    }
-  }
+  this->dataPtr->RecreateNodes(this->ogreCompositorWorkspace, this->scene);
 }
 
 //////////////////////////////////////////////////
@@ -0,0 +1,292 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <list>
+#include <set>
+#include <string>
+
+#include <ignition/common/Console.hh>
+
+#include "ignition/rendering/ogre2/Ogre2RenderTexturePool.hh"
+
+/// \brief A texture of the pool
+struct PooledTexture
+{
+  /// \brief Ogre render texture
+  Ogre::TexturePtr texture;
+
+  /// \brief Width in pixels
+  unsigned int width = 0u;
+
+  /// \brief Height in pixels
+  unsigned int height = 0u;
+
+  /// \brief Pixel format
+  Ogre::PixelFormat format = Ogre::PF_UNKNOWN;
+
+  /// \brief True if the texture is written with gamma correction
+  bool hwGamma = false;
+
+  /// \brief Format of the depth texture the render target is attached to
+  Ogre::PixelFormat depthFormat = Ogre::PF_UNKNOWN;
+
+  /// \brief Memory of the texture in bytes
+  uint64_t bytes = 0u;
+
+  /// \brief True if the texture can be given to other owners
+  bool shared = true;
+
+  /// \brief Owners that acquired the texture
+  std::set<const void *> owners;
+
+  /// \brief Owner that borrowed the texture and did not return it yet
+  const void *borrower = nullptr;
+
+  /// \brief Function reading back the contents for the borrower
+  std::function<void()> reclaim;
+};
+
+/// \brief Private data for the Ogre2RenderTexturePool class
+class ignition::rendering::Ogre2RenderTexturePoolPrivate
+{
+  /// \brief Find the pool entry of a texture
+  /// \param[in] _texture Texture to look for
+  /// \return Iterator to the entry, or end of the list
+  public: std::list<PooledTexture>::iterator Find(
+              const Ogre::TexturePtr &_texture);
+
+  /// \brief Textures of the pool
+  public: std::list<PooledTexture> textures;
+
+  /// \brief True to share textures between owners
+  public: bool enabled = true;
+
+  /// \brief Memory of all acquisitions if none were shared
+  public: uint64_t unpooledMemory = 0u;
+
+  /// \brief Number of reclaimed textures
+  public: uint64_t reclaimCount = 0u;
+
+  /// \brief Counter used to name the textures
+  public: unsigned int textureCounter = 0u;
+};
+
+using namespace ignition;
+using namespace rendering;
+
+//////////////////////////////////////////////////
+std::list<PooledTexture>::iterator Ogre2RenderTexturePoolPrivate::Find(
+    const Ogre::TexturePtr &_texture)
+{
+  auto it = this->textures.begin();
+  for (; it != this->textures.end(); ++it)
+  {
+    if (it->texture == _texture)
+      break;
+  }
+  return it;
+}
+
+//////////////////////////////////////////////////
+Ogre2RenderTexturePool::Ogre2RenderTexturePool()
+  : dataPtr(new Ogre2RenderTexturePoolPrivate)
+{
+}
+
+//////////////////////////////////////////////////
+Ogre2RenderTexturePool::~Ogre2RenderTexturePool()
+{
+  if (!Ogre::TextureManager::getSingletonPtr())
+    return;
+
+  for (auto &pooled : this->dataPtr->textures)
+  {
+    Ogre::TextureManager::getSingleton().remove(
+        pooled.texture->getName());
+  }
+}
+
+//////////////////////////////////////////////////
+void Ogre2RenderTexturePool::SetEnabled(bool _enabled)
+{
+  this->dataPtr->enabled = _enabled;
+}
+
+//////////////////////////////////////////////////
+bool Ogre2RenderTexturePool::Enabled() const
+{
+  return this->dataPtr->enabled;
+}
+
+//////////////////////////////////////////////////
+Ogre::TexturePtr Ogre2RenderTexturePool::Acquire(const void *_owner,
+    unsigned int _width, unsigned int _height, Ogre::PixelFormat _format,
+    bool _hwGamma, Ogre::PixelFormat _depthFormat)
+{
+  uint64_t bytes = Ogre::PixelUtil::getMemorySize(_width, _height, 1u,
+      _format);
+  this->dataPtr->unpooledMemory += bytes;
+
+  if (this->dataPtr->enabled)
+  {
+    for (auto &pooled : this->dataPtr->textures)
+    {
+      if (pooled.shared && pooled.width == _width &&
+          pooled.height == _height && pooled.format == _format &&
+          pooled.hwGamma == _hwGamma && pooled.depthFormat == _depthFormat &&
+          pooled.owners.find(_owner) == pooled.owners.end())
+      {
+        pooled.owners.insert(_owner);
+        return pooled.texture;
+      }
+    }
+  }
+
+  PooledTexture pooled;
+  pooled.width = _width;
+  pooled.height = _height;
+  pooled.format = _format;
+  pooled.hwGamma = _hwGamma;
+  pooled.depthFormat = _depthFormat;
+  pooled.bytes = bytes;
+  pooled.shared = this->dataPtr->enabled;
+  pooled.owners.insert(_owner);
+  pooled.texture = Ogre::TextureManager::getSingleton().createManual(
+      "Ogre2RenderTexturePool_" +
+      std::to_string(this->dataPtr->textureCounter++),
+      "General", Ogre::TEX_TYPE_2D, _width, _height, 1, 0,
+      _format, Ogre::TU_RENDERTARGET,
+      0, _hwGamma, 0, Ogre::BLANKSTRING, false, true);
+
+  // same depth setup as the textures defined by compositor nodes, so that
+  // the render target writes its depth to a depth texture of the pool
+  if (_depthFormat != Ogre::PF_UNKNOWN &&
+      !Ogre::PixelUtil::isDepth(_format))
+  {
+    Ogre::RenderTarget *rt = pooled.texture->getBuffer()->getRenderTarget();
+    rt->setDepthBufferPool(Ogre::DepthBuffer::POOL_DEFAULT);
+    rt->setPreferDepthTexture(true);
+    rt->setDesiredDepthBufferFormat(_depthFormat);
+  }
+  this->dataPtr->textures.push_back(pooled);
+  return pooled.texture;
+}
+
+//////////////////////////////////////////////////
+void Ogre2RenderTexturePool::Release(const void *_owner,
+    const Ogre::TexturePtr &_texture)
+{
+  auto it = this->dataPtr->Find(_texture);
+  if (it == this->dataPtr->textures.end() ||
+      it->owners.erase(_owner) == 0u)
+  {
+    ignwarn << "Releasing a render texture that was not acquired"
+            << std::endl;
+    return;
+  }
+
+  this->dataPtr->unpooledMemory -= it->bytes;
+  if (it->borrower == _owner)
+  {
+    it->borrower = nullptr;
+    it->reclaim = nullptr;
+  }
+
+  if (it->owners.empty())
+  {
+    Ogre::TextureManager::getSingleton().remove(it->texture->getName());
+    this->dataPtr->textures.erase(it);
+  }
+}
+
+//////////////////////////////////////////////////
+void Ogre2RenderTexturePool::Borrow(const void *_owner,
+    const Ogre::TexturePtr &_texture, const std::function<void()> &_reclaim)
+{
+  auto it = this->dataPtr->Find(_texture);
+  if (it == this->dataPtr->textures.end())
+  {
+    ignerr << "Borrowing a render texture that is not in the pool"
+           << std::endl;
+    return;
+  }
+
+  if (it->borrower && it->borrower != _owner)
+  {
+    // clear the borrower first in case the reclaim function returns it
+    std::function<void()> reclaim = it->reclaim;
+    it->borrower = nullptr;
+    it->reclaim = nullptr;
+    if (reclaim)
+    {
+      reclaim();
+      this->dataPtr->reclaimCount++;
+    }
+  }
+
+  it->borrower = _owner;
+  it->reclaim = _reclaim;
+}
+
+//////////////////////////////////////////////////
+void Ogre2RenderTexturePool::Return(const void *_owner,
+    const Ogre::TexturePtr &_texture)
+{
+  auto it = this->dataPtr->Find(_texture);
+  if (it == this->dataPtr->textures.end() || it->borrower != _owner)
+    return;
+
+  it->borrower = nullptr;
+  it->reclaim = nullptr;
+}
+
+//////////////////////////////////////////////////
+Ogre::CompositorChannel Ogre2RenderTexturePool::Channel(
+    const Ogre::TexturePtr &_texture)
+{
+  Ogre::CompositorChannel channel;
+  channel.target = _texture->getBuffer()->getRenderTarget();
+  channel.textures.push_back(_texture);
+  return channel;
+}
+
+//////////////////////////////////////////////////
+unsigned int Ogre2RenderTexturePool::TextureCount() const
+{
+  return static_cast<unsigned int>(this->dataPtr->textures.size());
+}
+
+//////////////////////////////////////////////////
+uint64_t Ogre2RenderTexturePool::MemoryUsage() const
+{
+  uint64_t memory = 0u;
+  for (const auto &pooled : this->dataPtr->textures)
+    memory += pooled.bytes;
+  return memory;
+}
+
+//////////////////////////////////////////////////
+uint64_t Ogre2RenderTexturePool::UnpooledMemoryUsage() const
+{
+  return this->dataPtr->unpooledMemory;
+}
+
+//////////////////////////////////////////////////
+uint64_t Ogre2RenderTexturePool::ReclaimCount() const
+{
+  return this->dataPtr->reclaimCount;
+}
@@ -0,0 +1,230 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+#include <ignition/math/Helpers.hh>
+
+#include "ignition/rendering/DepthCamera.hh"
+#include "ignition/rendering/GpuRays.hh"
+#include "ignition/rendering/RenderEngine.hh"
+#include "ignition/rendering/RenderingIface.hh"
+#include "ignition/rendering/Scene.hh"
+#include "ignition/rendering/Visual.hh"
+#include "ignition/rendering/ogre2/Ogre2RenderTexturePool.hh"
+#include "ignition/rendering/ogre2/Ogre2Scene.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+/////////////////////////////////////////////////
+/// \brief Create depth cameras and gpu rays of the same size and update
+/// them once
+/// \param[in] _scene Scene to create the sensors in
+/// \param[in] _count Number of sensors of each type
+/// \param[out] _sensors Created sensors
+void createSensors(const ScenePtr &_scene, unsigned int _count,
+    std::vector<SensorPtr> &_sensors)
+{
+  for (unsigned int i = 0u; i < _count; ++i)
+  {
+    DepthCameraPtr depthCamera = _scene->CreateDepthCamera();
+    depthCamera->SetImageWidth(320u);
+    depthCamera->SetImageHeight(240u);
+    depthCamera->SetFarClipPlane(10.0);
+    depthCamera->CreateDepthTexture();
+    _scene->RootVisual()->AddChild(depthCamera);
+    depthCamera->Update();
+    _sensors.push_back(depthCamera);
+
+    GpuRaysPtr gpuRays = _scene->CreateGpuRays();
+    gpuRays->SetAngleMin(-IGN_PI / 2.0);
+    gpuRays->SetAngleMax(IGN_PI / 2.0);
+    gpuRays->SetRayCount(320u);
+    gpuRays->SetVerticalRayCount(1u);
+    gpuRays->SetFarClipPlane(10.0);
+    _scene->RootVisual()->AddChild(gpuRays);
+    gpuRays->Update();
+    _sensors.push_back(gpuRays);
+  }
+}
+
+/////////////////////////////////////////////////
+TEST(Ogre2RenderTexturePoolTest, Pool)
+{
+  RenderEngine *engine = rendering::engine("ogre2");
+  if (!engine)
+  {
+    igndbg << "Engine 'ogre2' is not supported" << std::endl;
+    return;
+  }
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+  Ogre2ScenePtr ogreScene = std::dynamic_pointer_cast<Ogre2Scene>(scene);
+  ASSERT_NE(nullptr, ogreScene);
+  Ogre2RenderTexturePoolPtr pool = ogreScene->RenderTexturePool();
+  ASSERT_NE(nullptr, pool);
+  EXPECT_TRUE(pool->Enabled());
+  EXPECT_EQ(0u, pool->TextureCount());
+
+  // owners share a texture of the same size and format, but get distinct
+  // textures when they acquire several
+  int ownerA = 0;
+  int ownerB = 0;
+  Ogre::TexturePtr a0 = pool->Acquire(&ownerA, 64u, 32u,
+      Ogre::PF_FLOAT32_RGBA);
+  Ogre::TexturePtr a1 = pool->Acquire(&ownerA, 64u, 32u,
+      Ogre::PF_FLOAT32_RGBA);
+  Ogre::TexturePtr b0 = pool->Acquire(&ownerB, 64u, 32u,
+      Ogre::PF_FLOAT32_RGBA);
+  Ogre::TexturePtr b1 = pool->Acquire(&ownerB, 64u, 32u, Ogre::PF_L8);
+  EXPECT_FALSE(a0 == a1);
+  EXPECT_TRUE(a0 == b0);
+  EXPECT_FALSE(a0 == b1);
+  EXPECT_EQ(3u, pool->TextureCount());
+  EXPECT_EQ(2u * 64u * 32u * 16u + 64u * 32u, pool->MemoryUsage());
+  EXPECT_EQ(3u * 64u * 32u * 16u + 64u * 32u, pool->UnpooledMemoryUsage());
+
+  // borrowing a texture held by another owner reclaims it
+  unsigned int reclaimed = 0u;
+  pool->Borrow(&ownerA, a0, [&reclaimed]() { reclaimed++; });
+  pool->Borrow(&ownerA, a0, [&reclaimed]() { reclaimed++; });
+  EXPECT_EQ(0u, reclaimed);
+  pool->Borrow(&ownerB, b0);
+  EXPECT_EQ(1u, reclaimed);
+  EXPECT_EQ(1u, pool->ReclaimCount());
+  pool->Return(&ownerB, b0);
+  pool->Borrow(&ownerA, a0, [&reclaimed]() { reclaimed++; });
+  pool->Return(&ownerA, a0);
+  pool->Borrow(&ownerB, b0);
+  EXPECT_EQ(1u, reclaimed);
+  pool->Return(&ownerB, b0);
+
+  // textures are destroyed once released by all owners
+  pool->Release(&ownerA, a0);
+  pool->Release(&ownerA, a1);
+  EXPECT_EQ(2u, pool->TextureCount());
+  pool->Release(&ownerB, b0);
+  pool->Release(&ownerB, b1);
+  EXPECT_EQ(0u, pool->TextureCount());
+  EXPECT_EQ(0u, pool->UnpooledMemoryUsage());
+
+  // gamma write and depth buffer format are part of the texture key
+  Ogre::TexturePtr c0 = pool->Acquire(&ownerA, 64u, 32u, Ogre::PF_R8G8B8);
+  Ogre::TexturePtr c1 = pool->Acquire(&ownerB, 64u, 32u, Ogre::PF_R8G8B8,
+      true);
+  Ogre::TexturePtr c2 = pool->Acquire(&ownerB, 64u, 32u, Ogre::PF_R8G8B8,
+      false, Ogre::PF_D32_FLOAT);
+  EXPECT_FALSE(c0 == c1);
+  EXPECT_FALSE(c0 == c2);
+  EXPECT_FALSE(c1 == c2);
+  EXPECT_TRUE(c1->isHardwareGammaEnabled());
+  EXPECT_EQ(3u, pool->TextureCount());
+  pool->Release(&ownerA, c0);
+  pool->Release(&ownerB, c1);
+  pool->Release(&ownerB, c2);
+  EXPECT_EQ(0u, pool->TextureCount());
+
+  // the intermediate textures of the compositor are pooled along with the
+  // output texture of the sensor
+  DepthCameraPtr depthCamera = scene->CreateDepthCamera();
+  depthCamera->SetImageWidth(320u);
+  depthCamera->SetImageHeight(240u);
+  depthCamera->CreateDepthTexture();
+  EXPECT_EQ(4u, pool->TextureCount());
+  EXPECT_EQ(320u * 240u * (16u + 4u + 3u) + 160u * 120u,
+      pool->MemoryUsage());
+  scene->DestroySensor(depthCamera);
+  EXPECT_EQ(0u, pool->TextureCount());
+  EXPECT_EQ(0u, pool->UnpooledMemoryUsage());
+
+  // memory of the sensor render targets without and with pooling
+  std::vector<SensorPtr> sensors;
+  pool->SetEnabled(false);
+  EXPECT_FALSE(pool->Enabled());
+  createSensors(scene, 1u, sensors);
+  uint64_t single = pool->MemoryUsage();
+  EXPECT_LT(0u, single);
+  createSensors(scene, 3u, sensors);
+  uint64_t unpooled = pool->MemoryUsage();
+  EXPECT_EQ(4u * single, unpooled);
+  for (auto &sensor : sensors)
+    scene->DestroySensor(sensor);
+  sensors.clear();
+  EXPECT_EQ(0u, pool->TextureCount());
+
+  pool->SetEnabled(true);
+  createSensors(scene, 4u, sensors);
+  uint64_t pooled = pool->MemoryUsage();
+  EXPECT_EQ(single, pooled);
+  EXPECT_EQ(unpooled, pool->UnpooledMemoryUsage());
+  std::cout << "Render targets of 4 depth cameras and 4 gpu rays" << std::endl
+            << "  without pool: " << unpooled / (1024.0 * 1024.0) << " MB"
+            << std::endl
+            << "  with pool:    " << pooled / (1024.0 * 1024.0) << " MB"
+            << std::endl;
+
+  // sensors sharing a texture still get their own data when their updates
+  // interleave
+  DepthCameraPtr nearCamera =
+      std::dynamic_pointer_cast<DepthCamera>(sensors[0]);
+  DepthCameraPtr farCamera =
+      std::dynamic_pointer_cast<DepthCamera>(sensors[2]);
+  ASSERT_NE(nullptr, nearCamera);
+  ASSERT_NE(nullptr, farCamera);
+  VisualPtr box = scene->CreateVisual();
+  box->AddGeometry(scene->CreateBox());
+  box->SetLocalPosition(2.0, 0.0, 0.0);
+  scene->RootVisual()->AddChild(box);
+  nearCamera->SetLocalPosition(0.0, 0.0, 0.0);
+  farCamera->SetLocalPosition(0.0, 0.0, 0.0);
+  farCamera->SetLocalRotation(0.0, 0.0, IGN_PI);
+
+  uint64_t reclaims = pool->ReclaimCount();
+  scene->PreRender();
+  nearCamera->Render();
+  farCamera->Render();
+  nearCamera->PostRender();
+  farCamera->PostRender();
+  // the far camera reclaims the node inputs and the output texture
+  EXPECT_EQ(reclaims + 2u, pool->ReclaimCount());
+
+  unsigned int mid = 120u * 320u + 160u;
+  EXPECT_NEAR(1.5, nearCamera->DepthData()[mid * 4u], 0.1);
+  EXPECT_TRUE(std::isinf(farCamera->DepthData()[mid * 4u]));
+
+  for (auto &sensor : sensors)
+    scene->DestroySensor(sensor);
+  EXPECT_EQ(0u, pool->TextureCount());
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
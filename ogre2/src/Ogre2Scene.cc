@@ -15,11 +15,16 @@
  *
  */
 
+#include <algorithm>
+#include <map>
+#include <string>
+
 #include <ignition/common/Console.hh>
 
 #include "ignition/rendering/RenderTypes.hh"
 #include "ignition/rendering/ogre2/Ogre2ArrowVisual.hh"
 #include "ignition/rendering/ogre2/Ogre2AxisVisual.hh"
+#include "ignition/rendering/ogre2/Ogre2BoundingBoxCamera.hh"
 #include "ignition/rendering/ogre2/Ogre2Camera.hh"
 #include "ignition/rendering/ogre2/Ogre2Conversions.hh"
 #include "ignition/rendering/ogre2/Ogre2DepthCamera.hh"
@@ -32,22 +37,81 @@
 #include "ignition/rendering/ogre2/Ogre2Marker.hh"
 #include "ignition/rendering/ogre2/Ogre2Material.hh"
 #include "ignition/rendering/ogre2/Ogre2MeshFactory.hh"
+#include "ignition/rendering/ogre2/Ogre2MultiViewCamera.hh"
 #include "ignition/rendering/ogre2/Ogre2Node.hh"
 #include "ignition/rendering/ogre2/Ogre2ParticleEmitter.hh"
 #include "ignition/rendering/ogre2/Ogre2RayQuery.hh"
 #include "ignition/rendering/ogre2/Ogre2RenderEngine.hh"
 #include "ignition/rendering/ogre2/Ogre2RenderTarget.hh"
+#include "ignition/rendering/ogre2/Ogre2RenderTexturePool.hh"
 #include "ignition/rendering/ogre2/Ogre2RenderTypes.hh"
 #include "ignition/rendering/ogre2/Ogre2Scene.hh"
 #include "ignition/rendering/ogre2/Ogre2ThermalCamera.hh"
 #include "ignition/rendering/ogre2/Ogre2Visual.hh"
 #include "ignition/rendering/ogre2/Ogre2WireBox.hh"
 
+/// \brief Empty shadow node of the compositor scripts, used while there
+/// are no shadow casting lights
+static const char kScriptShadowNode[] = "PbsMaterialsShadowNode";
+
+/// \brief Shadow maps of spot and point lights are added in groups of this
+/// size, so that adding a light or turning its shadows on rarely needs a
+/// new shadow node
+static const unsigned int kShadowMapGroupSize = 4u;
+
+/// \brief Max number of shadow maps. Shaders dynamically generated by ogre
+/// produce compile error at runtime if the number of shadow maps exceeds
+/// certain number. The error seems to suggest that the number of uniform
+/// variables has exceeded the max number allowed
+static const unsigned int kMaxShadowMaps = 25u;
+
 /// \brief Private data for the Ogre2Scene class
 class ignition::rendering::Ogre2ScenePrivate
 {
+  /// \brief Create ogre compositor shadow node definition. The function
+  /// takes a vector of parameters that describe the type, number, and
+  /// resolution of textures create. Note that it is not necessary to
+  /// create separate textures for each shadow map. It is more efficient to
+  /// define a large texture atlas which is composed of multiple shadow
+  /// maps each occupying a subspace within the texture. This function is
+  /// similar to Ogre::ShadowNodeHelper::createShadowNodeWithSettings but
+  /// fixes a problem with the shadow map index when directional and spot
+  /// light shadow textures are defined on two different texture atlases.
+  /// \param[in] _compositorManager ogre compositor manager
+  /// \param[in] _shadowNodeName Name of the shadow node definition
+  /// \param[in] _shadowParams Parameters containing the shadow type,
+  /// texure resolution and position on the texture atlas.
+  public: static void CreateShadowNodeWithSettings(
+      Ogre::CompositorManager2 *_compositorManager,
+      const std::string &_shadowNodeName,
+      const Ogre::ShadowNodeHelper::ShadowParamVec &_shadowParams);
+
+  /// \brief Remove a shadow node definition created by the scene
+  /// \param[in] _name Name of the shadow node definition
+  public: static void RemoveShadowNode(const std::string &_name);
+
   /// \brief Flag to indicate if shadows need to be updated
   public: bool shadowsDirty = true;
+
+  /// \brief Name of the current shadow node definition
+  public: std::string shadowNodeDefName = kScriptShadowNode;
+
+  /// \brief Number of directional lights the shadow node has room for
+  public: unsigned int dirShadowCapacity = 0u;
+
+  /// \brief Number of spot and point lights the shadow node has room for
+  public: unsigned int spotPointShadowCapacity = 0u;
+
+  /// \brief Number of shadow node definitions created, used to name them
+  public: unsigned int shadowNodeCount = 0u;
+
+  /// \brief Number of compositor workspaces using each shadow node
+  /// definition
+  public: std::map<std::string, unsigned int> shadowNodeUsers;
+
+  /// \brief Pool of render textures shared by the sensors
+  public: Ogre2RenderTexturePoolPtr renderTexturePool =
+      std::make_shared<Ogre2RenderTexturePool>();
 };
 
 using namespace ignition;
@@ -110,30 +174,11 @@ void Ogre2Scene::SetAmbientLight(const math::Color &_color)
 //////////////////////////////////////////////////
 void Ogre2Scene::PreRender()
 {
-  if (this->ShadowsDirty())
-  {
-    // notify all render targets
-    for (unsigned int i  = 0; i < this->SensorCount(); ++i)
-    {
-      auto camera = std::dynamic_pointer_cast<Ogre2Camera>(
-          this->SensorByIndex(i));
-      if (camera)
-      {
-        Ogre2RenderTexturePtr rt =
-            std::dynamic_pointer_cast<Ogre2RenderTexture>(
-            camera->RenderTarget());
-        if (rt)
-        {
-          // need to destroy compositor resources first before the render target
-          // builds the new shadow node
-          rt->DestroyCompositor();
-          // hack: this marks the render target dirty and causes it to be
-          // rebuilt
-          rt->SetCamera(rt->Camera());
-        }
-      }
-    }
-  }
+  // render the frames requested before the scene changes
+  Ogre2RenderEngine::Instance()->FlushRenderRequests();
+
+  // render targets pick up a new shadow node in their PreRender
+  this->UpdateShadowNode();
 
   BaseScene::PreRender();
 }
@@ -159,6 +204,14 @@ void Ogre2Scene::Destroy()
 
   BaseScene::Destroy();
 
+  // the compositors using the shadow node were destroyed with the sensors
+  Ogre2ScenePrivate::RemoveShadowNode(this->dataPtr->shadowNodeDefName);
+  this->dataPtr->shadowNodeDefName = kScriptShadowNode;
+  this->dataPtr->dirShadowCapacity = 0u;
+  this->dataPtr->spotPointShadowCapacity = 0u;
+  this->dataPtr->shadowNodeUsers.clear();
+  this->dataPtr->shadowsDirty = true;
+
   if (this->ogreSceneManager)
   {
     this->ogreSceneManager->removeRenderQueueListener(
@@ -172,6 +225,12 @@ Ogre::SceneManager *Ogre2Scene::OgreSceneManager() const
   return this->ogreSceneManager;
 }
 
+//////////////////////////////////////////////////
+Ogre2RenderTexturePoolPtr Ogre2Scene::RenderTexturePool() const
+{
+  return this->dataPtr->renderTexturePool;
+}
+
 //////////////////////////////////////////////////
 bool Ogre2Scene::LoadImpl()
 {
@@ -268,6 +327,26 @@ ThermalCameraPtr Ogre2Scene::CreateThermalCameraImpl(const unsigned int _id,
   return (result) ? camera : nullptr;
 }
 
+//////////////////////////////////////////////////
+MultiViewCameraPtr Ogre2Scene::CreateMultiViewCameraImpl(
+    const unsigned int _id, const std::string &_name)
+{
+  Ogre2MultiViewCameraPtr camera(new Ogre2MultiViewCamera);
+  bool result = this->InitObject(camera, _id, _name);
+  camera->SetBackgroundColor(this->backgroundColor);
+  return (result) ? camera : nullptr;
+}
+
+//////////////////////////////////////////////////
+BoundingBoxCameraPtr Ogre2Scene::CreateBoundingBoxCameraImpl(
+    const unsigned int _id, const std::string &_name)
+{
+  Ogre2BoundingBoxCameraPtr camera(new Ogre2BoundingBoxCamera);
+  bool result = this->InitObject(camera, _id, _name);
+  camera->SetBackgroundColor(this->backgroundColor);
+  return (result) ? camera : nullptr;
+}
+
 //////////////////////////////////////////////////
 GpuRaysPtr Ogre2Scene::CreateGpuRaysImpl(unsigned int _id,
     const std::string &_name)
@@ -568,3 +647,466 @@ bool Ogre2Scene::ShadowsDirty() const
 {
   return this->dataPtr->shadowsDirty;
 }
+
+//////////////////////////////////////////////////
+void Ogre2Scene::UpdateShadowNode()
+{
+  if (!this->dataPtr->shadowsDirty)
+    return;
+  this->dataPtr->shadowsDirty = false;
+
+  unsigned int spotPointLightCount = 0;
+  unsigned int dirLightCount = 0;
+
+  for (unsigned int i = 0; i < this->LightCount(); ++i)
+  {
+    LightPtr light = this->LightByIndex(i);
+    if (light->CastShadows())
+    {
+      if (std::dynamic_pointer_cast<DirectionalLight>(light))
+        dirLightCount++;
+      else
+        spotPointLightCount++;
+    }
+  }
+
+  // limit number of shadow maps
+  if (dirLightCount * 3 + spotPointLightCount > kMaxShadowMaps)
+  {
+    dirLightCount = std::min(kMaxShadowMaps / 3, dirLightCount);
+    spotPointLightCount = std::min(kMaxShadowMaps - dirLightCount * 3,
+        spotPointLightCount);
+    ignwarn << "Number of shadow-casting lights exceeds the limit supported by "
+            << "the underlying rendering engine ogre2. Limiting to "
+            << dirLightCount << " directional lights and "
+            << spotPointLightCount << " point / spot lights" << std::endl;
+  }
+
+  // the shadow node only grows, and spot and point light shadow maps are
+  // added in groups. Ogre assigns the shadow casting lights to the shadow
+  // maps every frame and skips the unused ones, so lights that still fit
+  // do not need a new shadow node, nor new compositor nodes.
+  unsigned int dirCapacity =
+      std::max(dirLightCount, this->dataPtr->dirShadowCapacity);
+  unsigned int spotPointCapacity = (spotPointLightCount +
+      kShadowMapGroupSize - 1u) / kShadowMapGroupSize * kShadowMapGroupSize;
+  spotPointCapacity =
+      std::max(spotPointCapacity, this->dataPtr->spotPointShadowCapacity);
+  if (dirCapacity * 3 + spotPointCapacity > kMaxShadowMaps)
+  {
+    dirCapacity = dirLightCount;
+    spotPointCapacity = std::min(kMaxShadowMaps - dirCapacity * 3,
+        spotPointCapacity);
+  }
+
+  if (dirCapacity == this->dataPtr->dirShadowCapacity &&
+      spotPointCapacity == this->dataPtr->spotPointShadowCapacity)
+    return;
+
+  this->dataPtr->dirShadowCapacity = dirCapacity;
+  this->dataPtr->spotPointShadowCapacity = spotPointCapacity;
+
+  std::string previousName = this->dataPtr->shadowNodeDefName;
+  std::string name = kScriptShadowNode;
+  if (dirCapacity + spotPointCapacity > 0u)
+  {
+    Ogre::ShadowNodeHelper::ShadowParamVec shadowParams;
+    Ogre::ShadowNodeHelper::ShadowParam shadowParam;
+
+    // directional lights
+    unsigned int atlasId = 0u;
+    unsigned int texSize = 2048u;
+    unsigned int halfTexSize = texSize * 0.5;
+    for (unsigned int i = 0; i < dirCapacity; ++i)
+    {
+      shadowParam.technique = Ogre::SHADOWMAP_PSSM;
+      shadowParam.atlasId = atlasId;
+      shadowParam.numPssmSplits = 3u;
+      shadowParam.resolution[0].x = texSize;
+      shadowParam.resolution[0].y = texSize;
+      shadowParam.resolution[1].x = halfTexSize;
+      shadowParam.resolution[1].y = halfTexSize;
+      shadowParam.resolution[2].x = halfTexSize;
+      shadowParam.resolution[2].y = halfTexSize;
+      shadowParam.atlasStart[0].x = 0u;
+      shadowParam.atlasStart[0].y = 0u;
+      shadowParam.atlasStart[1].x = 0u;
+      shadowParam.atlasStart[1].y = texSize;
+      shadowParam.atlasStart[2].x = halfTexSize;
+      shadowParam.atlasStart[2].y = texSize;
+      shadowParam.supportedLightTypes = 0u;
+      shadowParam.addLightType(Ogre::Light::LT_DIRECTIONAL);
+      shadowParams.push_back(shadowParam);
+      atlasId++;
+    }
+
+    // others
+    unsigned int maxTexSize = 8192u;
+    unsigned int rowIdx = 0;
+    unsigned int colIdx = 0;
+    unsigned int rowSize = maxTexSize / texSize;
+    unsigned int colSize = rowSize;
+
+    for (unsigned int i = 0; i < spotPointCapacity; ++i)
+    {
+      shadowParam.technique = Ogre::SHADOWMAP_FOCUSED;
+      shadowParam.atlasId = atlasId;
+      shadowParam.resolution[0].x = texSize;
+      shadowParam.resolution[0].y = texSize;
+      shadowParam.atlasStart[0].x = colIdx * texSize;
+      shadowParam.atlasStart[0].y = rowIdx * texSize;
+
+      shadowParam.supportedLightTypes = 0u;
+      shadowParam.addLightType(Ogre::Light::LT_DIRECTIONAL);
+      shadowParam.addLightType(Ogre::Light::LT_POINT);
+      shadowParam.addLightType(Ogre::Light::LT_SPOTLIGHT);
+      shadowParams.push_back(shadowParam);
+
+      colIdx++;
+      colIdx = colIdx % colSize;
+      if (colIdx == 0u)
+        rowIdx++;
+
+      // check if we've filled the current texture atlas
+      // if so, increment atlas id to indicate we want a new texture
+      if (rowIdx >= rowSize)
+      {
+        atlasId++;
+        colIdx = 0;
+        rowIdx = 0;
+      }
+    }
+
+    // compositor nodes of the render targets still refer to the previous
+    // definition, so the new one gets a new name
+    name = std::string(kScriptShadowNode) + "_" + std::to_string(this->Id()) +
+        "_" + std::to_string(this->dataPtr->shadowNodeCount++);
+    Ogre2ScenePrivate::CreateShadowNodeWithSettings(
+        Ogre2RenderEngine::Instance()->OgreRoot()->getCompositorManager2(),
+        name, shadowParams);
+  }
+  this->dataPtr->shadowNodeDefName = name;
+
+  // the previous definition is removed once the last render target using
+  // it recreated its nodes
+  if (this->dataPtr->shadowNodeUsers.find(previousName) ==
+      this->dataPtr->shadowNodeUsers.end())
+    Ogre2ScenePrivate::RemoveShadowNode(previousName);
+}
+
+//////////////////////////////////////////////////
+std::string Ogre2Scene::ShadowNodeDefinitionName() const
+{
+  return this->dataPtr->shadowNodeDefName;
+}
+
+//////////////////////////////////////////////////
+void Ogre2Scene::RetainShadowNode(const std::string &_name)
+{
+  if (!_name.empty())
+    this->dataPtr->shadowNodeUsers[_name]++;
+}
+
+//////////////////////////////////////////////////
+void Ogre2Scene::ReleaseShadowNode(const std::string &_name)
+{
+  auto it = this->dataPtr->shadowNodeUsers.find(_name);
+  if (it == this->dataPtr->shadowNodeUsers.end())
+    return;
+
+  if (--it->second > 0u)
+    return;
+
+  this->dataPtr->shadowNodeUsers.erase(it);
+  if (_name != this->dataPtr->shadowNodeDefName)
+    Ogre2ScenePrivate::RemoveShadowNode(_name);
+}
+
+//////////////////////////////////////////////////
+void Ogre2ScenePrivate::RemoveShadowNode(const std::string &_name)
+{
+  if (_name == kScriptShadowNode)
+    return;
+
+  Ogre::CompositorManager2 *compositorManager =
+      Ogre2RenderEngine::Instance()->OgreRoot()->getCompositorManager2();
+  if (compositorManager->hasShadowNodeDefinition(_name))
+    compositorManager->removeShadowNodeDefinition(_name);
+}
+
+////////////////////////////////////////////////////
+void Ogre2ScenePrivate::CreateShadowNodeWithSettings(
+    Ogre::CompositorManager2 *_compositorManager,
+    const std::string &_shadowNodeName,
+    const Ogre::ShadowNodeHelper::ShadowParamVec &_shadowParams)
+{
+  Ogre::uint32 pointLightCubemapResolution = 1024u;
+  Ogre::Real pssmLambda = 0.95f;
+  Ogre::Real splitPadding = 1.0f;
+  Ogre::Real splitBlend = 0.125f;
+  Ogre::Real splitFade = 0.313f;
+
+  const Ogre::uint32 spotMask           = 1u << Ogre::Light::LT_SPOTLIGHT;
+  const Ogre::uint32 directionalMask    = 1u << Ogre::Light::LT_DIRECTIONAL;
+  const Ogre::uint32 pointMask          = 1u << Ogre::Light::LT_POINT;
+  const Ogre::uint32 spotAndDirMask = spotMask | directionalMask;
+
+  typedef Ogre::vector<Ogre::ShadowNodeHelper::Resolution>::type ResolutionVec;
+
+  size_t numExtraShadowMapsForPssmSplits = 0;
+  size_t numTargetPasses = 0;
+  ResolutionVec atlasResolutions;
+
+  // Validation and data gathering
+  bool hasPointLights = false;
+
+  Ogre::ShadowNodeHelper::ShadowParamVec::const_iterator itor =
+      _shadowParams.begin();
+  Ogre::ShadowNodeHelper::ShadowParamVec::const_iterator end =
+      _shadowParams.end();
+
+  while (itor != end)
+  {
+    if (itor->technique == Ogre::SHADOWMAP_PSSM)
+    {
+      numExtraShadowMapsForPssmSplits = itor->numPssmSplits - 1u;
+      // 1 per PSSM split
+      numTargetPasses += numExtraShadowMapsForPssmSplits + 1u;
+    }
+
+    if (itor->atlasId >= atlasResolutions.size())
+      atlasResolutions.resize(itor->atlasId + 1u);
+
+    Ogre::ShadowNodeHelper::Resolution &resolution =
+        atlasResolutions[itor->atlasId];
+
+    const size_t numSplits = itor->technique == Ogre::SHADOWMAP_PSSM ?
+        itor->numPssmSplits : 1u;
+    for (size_t i = 0; i < numSplits; ++i)
+    {
+      resolution.x = std::max(resolution.x,
+          itor->atlasStart[i].x + itor->resolution[i].x);
+      resolution.y = std::max(resolution.y,
+          itor->atlasStart[i].y + itor->resolution[i].y);
+    }
+
+    if (itor->supportedLightTypes & pointMask)
+    {
+      hasPointLights = true;
+      // 6 target passes per cubemap + 1 for copy
+      numTargetPasses += 7u;
+    }
+    if (itor->supportedLightTypes & spotAndDirMask &&
+        itor->technique != Ogre::SHADOWMAP_PSSM)
+    {
+      // 1 per directional/spot light (for non-PSSM techniques)
+      numTargetPasses += 1u;
+    }
+    ++itor;
+  }
+
+  // One clear for each atlas
+  numTargetPasses += atlasResolutions.size();
+  // Create the shadow node definition
+  Ogre::CompositorShadowNodeDef *shadowNodeDef =
+      _compositorManager->addShadowNodeDefinition(_shadowNodeName);
+
+  const size_t numTextures = atlasResolutions.size();
+  {
+    // Define the atlases (textures)
+    shadowNodeDef->setNumLocalTextureDefinitions(
+        numTextures + (hasPointLights ? 1u : 0u));
+    for (size_t i = 0; i < numTextures; ++i)
+    {
+      const Ogre::ShadowNodeHelper::Resolution &atlasRes = atlasResolutions[i];
+      Ogre::TextureDefinitionBase::TextureDefinition *texDef =
+          shadowNodeDef->addTextureDefinition(
+          "atlas" + Ogre::StringConverter::toString(i));
+
+      texDef->width = std::max(atlasRes.x, 1u);
+      texDef->height = std::max(atlasRes.y, 1u);
+      texDef->formatList.push_back(Ogre::PF_D32_FLOAT);
+      texDef->depthBufferId = Ogre::DepthBuffer::POOL_NON_SHAREABLE;
+      texDef->depthBufferFormat = Ogre::PF_D32_FLOAT;
+      texDef->preferDepthTexture = false;
+      texDef->fsaa = false;
+    }
+
+    // Define the cubemap needed by point lights
+    if (hasPointLights)
+    {
+      Ogre::TextureDefinitionBase::TextureDefinition *texDef =
+          shadowNodeDef->addTextureDefinition("tmpCubemap");
+
+      texDef->width   = pointLightCubemapResolution;
+      texDef->height  = pointLightCubemapResolution;
+      texDef->depth   = 6u;
+      texDef->textureType = Ogre::TEX_TYPE_CUBE_MAP;
+      texDef->formatList.push_back(Ogre::PF_FLOAT32_R);
+      texDef->depthBufferId = 1u;
+      texDef->depthBufferFormat = Ogre::PF_D32_FLOAT;
+      texDef->preferDepthTexture = false;
+      texDef->fsaa = false;
+    }
+  }
+
+  // Create the shadow maps
+  const size_t numShadowMaps =
+      _shadowParams.size() + numExtraShadowMapsForPssmSplits;
+  shadowNodeDef->setNumShadowTextureDefinitions(numShadowMaps);
+
+  itor = _shadowParams.begin();
+
+  while (itor != end)
+  {
+    const size_t lightIdx = itor - _shadowParams.begin();
+    const Ogre::ShadowNodeHelper::ShadowParam &shadowParam = *itor;
+
+    const Ogre::ShadowNodeHelper::Resolution &texResolution =
+        atlasResolutions[shadowParam.atlasId];
+
+    const size_t numSplits =
+        shadowParam.technique == Ogre::SHADOWMAP_PSSM ?
+        shadowParam.numPssmSplits : 1u;
+
+    for (size_t j = 0; j < numSplits; ++j)
+    {
+      Ogre::Vector2 uvOffset(
+          shadowParam.atlasStart[j].x, shadowParam.atlasStart[j].y);
+      Ogre::Vector2 uvLength(
+          shadowParam.resolution[j].x, shadowParam.resolution[j].y);
+
+      uvOffset /= Ogre::Vector2(texResolution.x, texResolution.y);
+      uvLength /= Ogre::Vector2(texResolution.x, texResolution.y);
+
+      const Ogre::String texName =
+          "atlas" + Ogre::StringConverter::toString(shadowParam.atlasId);
+
+      Ogre::ShadowTextureDefinition *shadowTexDef =
+          shadowNodeDef->addShadowTextureDefinition(lightIdx, j, texName,
+          0, uvOffset, uvLength, 0);
+      shadowTexDef->shadowMapTechnique = shadowParam.technique;
+      shadowTexDef->pssmLambda = pssmLambda;
+      shadowTexDef->splitPadding = splitPadding;
+      shadowTexDef->splitBlend = splitBlend;
+      shadowTexDef->splitFade = splitFade;
+      shadowTexDef->numSplits = numSplits;
+    }
+    ++itor;
+  }
+
+  shadowNodeDef->setNumTargetPass(numTargetPasses);
+
+  // Create the passes for each atlas
+  for (size_t atlasId = 0; atlasId < numTextures; ++atlasId)
+  {
+    const Ogre::String texName =
+        "atlas" + Ogre::StringConverter::toString(atlasId);
+    {
+      // Atlas clear pass
+      Ogre::CompositorTargetDef *targetDef =
+          shadowNodeDef->addTargetPass(texName);
+      targetDef->setNumPasses(1u);
+
+      Ogre::CompositorPassDef *passDef = targetDef->addPass(Ogre::PASS_CLEAR);
+      Ogre::CompositorPassClearDef *passClear =
+          static_cast<Ogre::CompositorPassClearDef *>(passDef);
+      passClear->mColourValue = Ogre::ColourValue::White;
+      passClear->mDepthValue = 1.0f;
+    }
+
+    // Pass scene for directional and spot lights first
+    size_t shadowMapIdx = 0;
+    itor = _shadowParams.begin();
+    while (itor != end)
+    {
+      const Ogre::ShadowNodeHelper::ShadowParam &shadowParam = *itor;
+      const size_t numSplits = shadowParam.technique == Ogre::SHADOWMAP_PSSM ?
+          shadowParam.numPssmSplits : 1u;
+      if (shadowParam.atlasId == atlasId &&
+          shadowParam.supportedLightTypes & spotAndDirMask)
+      {
+        size_t currentShadowMapIdx = shadowMapIdx;
+        for (size_t i = 0; i < numSplits; ++i)
+        {
+          Ogre::CompositorTargetDef *targetDef =
+              shadowNodeDef->addTargetPass(texName);
+          targetDef->setShadowMapSupportedLightTypes(
+              shadowParam.supportedLightTypes & spotAndDirMask);
+          targetDef->setNumPasses(1u);
+
+          Ogre::CompositorPassDef *passDef =
+              targetDef->addPass(Ogre::PASS_SCENE);
+          Ogre::CompositorPassSceneDef *passScene =
+              static_cast<Ogre::CompositorPassSceneDef *>(passDef);
+
+          passScene->mShadowMapIdx = currentShadowMapIdx + i;
+          passScene->mIncludeOverlays = false;
+        }
+      }
+      shadowMapIdx += numSplits;
+      ++itor;
+    }
+
+    // Pass scene for point lights last
+    shadowMapIdx = 0;
+    itor = _shadowParams.begin();
+    while (itor != end)
+    {
+      const Ogre::ShadowNodeHelper::ShadowParam &shadowParam = *itor;
+      if (shadowParam.atlasId == atlasId &&
+          shadowParam.supportedLightTypes & pointMask)
+      {
+        // Render to cubemap, each face clear + render
+        for (Ogre::uint32 i = 0; i < 6u; ++i)
+        {
+          Ogre::CompositorTargetDef *targetDef =
+              shadowNodeDef->addTargetPass("tmpCubemap", i);
+          targetDef->setNumPasses(2u);
+          targetDef->setShadowMapSupportedLightTypes(
+              shadowParam.supportedLightTypes & pointMask);
+          {
+            // Clear pass
+            Ogre::CompositorPassDef *passDef =
+                targetDef->addPass(Ogre::PASS_CLEAR);
+            Ogre::CompositorPassClearDef *passClear =
+                static_cast<Ogre::CompositorPassClearDef *>(passDef);
+            passClear->mColourValue = Ogre::ColourValue::White;
+            passClear->mDepthValue = 1.0f;
+            passClear->mShadowMapIdx = shadowMapIdx;
+          }
+
+          {
+            // Scene pass
+            Ogre::CompositorPassDef *passDef =
+                targetDef->addPass(Ogre::PASS_SCENE);
+            Ogre::CompositorPassSceneDef *passScene =
+                static_cast<Ogre::CompositorPassSceneDef *>(passDef);
+            passScene->mCameraCubemapReorient = true;
+            passScene->mShadowMapIdx = shadowMapIdx;
+            passScene->mIncludeOverlays = false;
+          }
+        }
+
+        // Copy to the atlas using a pass quad
+        // (Cubemap -> DPSM / Dual Paraboloid).
+        Ogre::CompositorTargetDef *targetDef =
+            shadowNodeDef->addTargetPass(texName);
+        targetDef->setShadowMapSupportedLightTypes(
+            shadowParam.supportedLightTypes & pointMask);
+        targetDef->setNumPasses(1u);
+        Ogre::CompositorPassDef *passDef = targetDef->addPass(Ogre::PASS_QUAD);
+        Ogre::CompositorPassQuadDef *passQuad =
+            static_cast<Ogre::CompositorPassQuadDef *>(passDef);
+        passQuad->mMaterialIsHlms = false;
+        passQuad->mMaterialName = "Ogre/DPSM/CubeToDpsm";
+        passQuad->addQuadTextureSource(0, "tmpCubemap", 0);
+        passQuad->mShadowMapIdx = shadowMapIdx;
+      }
+      const size_t numSplits = shadowParam.technique ==
+          Ogre::SHADOWMAP_PSSM ? shadowParam.numPssmSplits : 1u;
+      shadowMapIdx += numSplits;
+      ++itor;
+    }
+  }
+}
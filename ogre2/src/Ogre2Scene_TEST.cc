@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+
+#include "ignition/rendering/Camera.hh"
+#include "ignition/rendering/DirectionalLight.hh"
+#include "ignition/rendering/Image.hh"
+#include "ignition/rendering/RenderEngine.hh"
+#include "ignition/rendering/RenderingIface.hh"
+#include "ignition/rendering/Scene.hh"
+#include "ignition/rendering/SpotLight.hh"
+#include "ignition/rendering/Visual.hh"
+#include "ignition/rendering/ogre2/Ogre2Scene.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+/////////////////////////////////////////////////
+TEST(Ogre2SceneTest, ShadowNode)
+{
+  RenderEngine *engine = rendering::engine("ogre2");
+  if (!engine)
+  {
+    igndbg << "Engine 'ogre2' is not supported" << std::endl;
+    return;
+  }
+
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+  Ogre2ScenePtr ogreScene = std::dynamic_pointer_cast<Ogre2Scene>(scene);
+  ASSERT_NE(nullptr, ogreScene);
+
+  VisualPtr box = scene->CreateVisual();
+  box->AddGeometry(scene->CreateBox());
+  scene->RootVisual()->AddChild(box);
+
+  CameraPtr camera = scene->CreateCamera();
+  camera->SetImageWidth(80u);
+  camera->SetImageHeight(60u);
+  camera->SetLocalPosition(-3.0, 0.0, 0.0);
+  scene->RootVisual()->AddChild(camera);
+  Image image = camera->CreateImage();
+
+  // no shadow casting lights
+  camera->Capture(image);
+  std::string shadowNode = ogreScene->ShadowNodeDefinitionName();
+  EXPECT_FALSE(ogreScene->ShadowsDirty());
+
+  // the first shadow casting light creates a shadow node
+  DirectionalLightPtr sun = scene->CreateDirectionalLight();
+  sun->SetDirection(-0.5, 0.5, -1.0);
+  scene->RootVisual()->AddChild(sun);
+  SpotLightPtr lamp = scene->CreateSpotLight();
+  lamp->SetLocalPosition(0.0, 0.0, 3.0);
+  scene->RootVisual()->AddChild(lamp);
+  EXPECT_TRUE(ogreScene->ShadowsDirty());
+  camera->Capture(image);
+  EXPECT_FALSE(ogreScene->ShadowsDirty());
+  EXPECT_NE(shadowNode, ogreScene->ShadowNodeDefinitionName());
+  shadowNode = ogreScene->ShadowNodeDefinitionName();
+
+  // toggling shadows, and adding or removing lights that fit in the shadow
+  // node, reuse it
+  lamp->SetCastShadows(false);
+  camera->Capture(image);
+  lamp->SetCastShadows(true);
+  camera->Capture(image);
+  std::vector<SpotLightPtr> lamps;
+  for (unsigned int i = 0u; i < 3u; ++i)
+  {
+    SpotLightPtr light = scene->CreateSpotLight();
+    light->SetLocalPosition(i, 0.0, 3.0);
+    scene->RootVisual()->AddChild(light);
+    lamps.push_back(light);
+  }
+  camera->Capture(image);
+  scene->DestroyLight(lamps.back());
+  lamps.pop_back();
+  camera->Capture(image);
+  EXPECT_EQ(shadowNode, ogreScene->ShadowNodeDefinitionName());
+
+  // setting the same value does not mark shadows dirty
+  lamp->SetCastShadows(true);
+  EXPECT_FALSE(ogreScene->ShadowsDirty());
+
+  // lights that do not fit create a bigger shadow node
+  for (unsigned int i = 0u; i < 4u; ++i)
+  {
+    SpotLightPtr light = scene->CreateSpotLight();
+    light->SetLocalPosition(i, 1.0, 3.0);
+    scene->RootVisual()->AddChild(light);
+    lamps.push_back(light);
+  }
+  camera->Capture(image);
+  EXPECT_NE(shadowNode, ogreScene->ShadowNodeDefinitionName());
+  shadowNode = ogreScene->ShadowNodeDefinitionName();
+
+  // and it is kept when they are removed again
+  for (auto &light : lamps)
+    scene->DestroyLight(light);
+  lamps.clear();
+  camera->Capture(image);
+  EXPECT_EQ(shadowNode, ogreScene->ShadowNodeDefinitionName());
+
+  // a camera created later uses the current shadow node
+  CameraPtr camera2 = scene->CreateCamera();
+  camera2->SetImageWidth(80u);
+  camera2->SetImageHeight(60u);
+  camera2->SetLocalPosition(-3.0, 0.0, 0.0);
+  scene->RootVisual()->AddChild(camera2);
+  Image image2 = camera2->CreateImage();
+  camera2->Capture(image2);
+  camera->Capture(image);
+  const unsigned char *data = image.Data<unsigned char>();
+  const unsigned char *data2 = image2.Data<unsigned char>();
+  unsigned int different = 0u;
+  for (unsigned int i = 0u; i < 80u * 60u * 3u; ++i)
+  {
+    if (data[i] != data2[i])
+      ++different;
+  }
+  EXPECT_EQ(0u, different);
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -110,11 +110,10 @@ void Ogre2SelectionBuffer::Update()
 
   this->dataPtr->materialSwitcher->Reset();
 
-  // manual update
-  this->dataPtr->ogreCompositorWorkspace->setEnabled(true);
+  // manual update, the selection is read back right away
   auto engine = Ogre2RenderEngine::Instance();
-  engine->OgreRoot()->renderOneFrame();
-  this->dataPtr->ogreCompositorWorkspace->setEnabled(false);
+  engine->RequestRender(this->dataPtr->ogreCompositorWorkspace);
+  engine->FlushRenderRequests();
 
   this->dataPtr->renderTexture->copyContentsToMemory(*this->dataPtr->pixelBox,
       Ogre::RenderTarget::FB_FRONT);
@@ -26,10 +26,12 @@
 #include <math.h>
 
 #include <algorithm>
+#include <functional>
 #include <limits>
 #include <string>
 #include <unordered_map>
 #include <variant>
+#include <vector>
 
 #ifdef _MSC_VER
 #pragma warning(push, 0)
@@ -45,12 +47,14 @@
 #include <ignition/math/Helpers.hh>
 
 #include "ignition/rendering/RenderTypes.hh"
+#include "ignition/rendering/Utils.hh"
 #include "ignition/rendering/ogre2/Ogre2Conversions.hh"
 #include "ignition/rendering/ogre2/Ogre2Includes.hh"
 #include "ignition/rendering/ogre2/Ogre2Material.hh"
 #include "ignition/rendering/ogre2/Ogre2ParticleEmitter.hh"
 #include "ignition/rendering/ogre2/Ogre2RenderEngine.hh"
 #include "ignition/rendering/ogre2/Ogre2RenderTarget.hh"
+#include "ignition/rendering/ogre2/Ogre2RenderTexturePool.hh"
 #include "ignition/rendering/ogre2/Ogre2RenderTypes.hh"
 #include "ignition/rendering/ogre2/Ogre2Scene.hh"
 #include "ignition/rendering/ogre2/Ogre2Sensor.hh"
@@ -74,7 +78,7 @@ class Ogre2ThermalCameraMaterialSwitcher : public Ogre::RenderTargetListener
               const std::string & _name);
 
   /// \brief destructor
-  public: ~Ogre2ThermalCameraMaterialSwitcher() = default;
+  public: ~Ogre2ThermalCameraMaterialSwitcher();
 
   /// \brief Set image format
   /// \param[in] _format Image format
@@ -96,23 +100,50 @@ class Ogre2ThermalCameraMaterialSwitcher : public Ogre::RenderTargetListener
   private: virtual void postRenderTargetUpdate(
       const Ogre::RenderTargetEvent &_evt) override;
 
+  /// \brief Get the layer of a heat signature texture in the heat
+  /// signature texture array, adding the texture to the array the first
+  /// time it is used
+  /// \param[in] _texture Path to the heat signature texture
+  /// \return Layer of the texture, or -1 if the texture could not be loaded
+  private: int HeatSignatureLayer(const std::string &_texture);
+
+  /// \brief Create the heat signature texture array with room for the
+  /// given number of layers and upload the loaded textures to it
+  /// \param[in] _capacity Number of layers
+  private: void CreateHeatSignatureArray(unsigned int _capacity);
+
+  /// \brief Set the thermal camera parameters of the heat signature
+  /// material
+  private: void UpdateHeatSignatureParams();
+
   /// \brief Scene manager
   private: Ogre2ScenePtr scene = nullptr;
 
   /// \brief Pointer to the heat source material
   private: Ogre::MaterialPtr heatSourceMaterial;
 
-  /// \brief Pointer to the "base" heat signature material.
-  /// All renderable items with a heat signature texture use their own
-  /// copy of this base material, with the item's specific heat
-  /// signature texture applied to it
-  private: Ogre::MaterialPtr baseHeatSigMaterial;
+  /// \brief Heat signature material shared by all renderable items with
+  /// a heat signature texture. The textures are layers of a texture
+  /// array, and the layer and temperature range of each item are passed
+  /// as custom parameters of its sub items.
+  private: Ogre::MaterialPtr heatSignatureMaterial;
+
+  /// \brief Texture array with all heat signature textures
+  private: Ogre::TexturePtr heatSignatureArray;
+
+  /// \brief Number of layers allocated in the heat signature array
+  private: unsigned int heatSignatureCapacity = 0u;
+
+  /// \brief Width and height of the heat signature array layers. All
+  /// textures are resized to the size of the first one.
+  private: unsigned int heatSignatureSize[2] = {0u, 0u};
+
+  /// \brief Layer of each heat signature texture, by texture path
+  private: std::unordered_map<std::string, int> heatSignatureLayers;
 
-  /// \brief A map of all items that have a heat signature material.
-  /// The key is the item's ID, and the value is the heat signature
-  /// for that item.
-  private: std::unordered_map<Ogre::IdType, Ogre::MaterialPtr>
-            heatSignatureMaterials;
+  /// \brief Pixels of each layer of the heat signature array, kept to
+  /// fill a larger array when more textures are added
+  private: std::vector<std::vector<uint8_t>> heatSignatureData;
 
   /// \brief The name of the thermal camera sensor
   private: const std::string name;
@@ -125,6 +156,11 @@ class Ogre2ThermalCameraMaterialSwitcher : public Ogre::RenderTargetListener
   /// script in media/materials/scripts/thermal_camera.material
   private: const unsigned int customParamIdx = 10u;
 
+  /// \brief Custom parameter index of the heat signature layer and
+  /// temperature range in an ogre subitem. This has to match the custom
+  /// index specified in the ThermalHeatSignature material script
+  private: const unsigned int heatSignatureParamIdx = 11u;
+
   /// \brief A map of ogre sub item pointer to their original hlms material
   private: std::unordered_map<Ogre::SubItem *, Ogre::HlmsDatablock *>
       datablockMap;
@@ -168,9 +204,32 @@ class ignition::rendering::Ogre2ThermalCameraPrivate
   /// \brief 1st pass compositor workspace. One for each cubemap camera
   public: Ogre::CompositorWorkspace *ogreCompositorWorkspace;
 
-  /// \brief Thermal textures.
+  /// \brief Copy the thermal texture to the thermal buffer
+  public: void ReadThermalBuffer();
+
+  /// \brief Thermal textures, acquired from the render texture pool of the
+  /// scene
   public: Ogre::TexturePtr ogreThermalTexture;
 
+  /// \brief Pool the thermal texture is acquired from
+  public: Ogre2RenderTexturePoolPtr texturePool;
+
+  /// \brief Depth and color textures rendered and sampled by the
+  /// compositor node, acquired from the render texture pool
+  public: std::vector<Ogre::TexturePtr> nodeInputTextures;
+
+  /// \brief True while the node input textures are borrowed
+  public: bool nodeInputsBorrowed = false;
+
+  /// \brief Render the requested frame and return the node input textures
+  /// to the pool
+  /// \param[in] _owner Camera the textures were acquired for
+  public: void ReturnNodeInputs(const void *_owner);
+
+  /// \brief True if the thermal buffer already holds the last rendered
+  /// frame
+  public: bool thermalBufferRead = false;
+
   /// \brief Dummy render texture for the thermal data
   public: RenderTexturePtr thermalTexture = nullptr;
 
@@ -198,6 +257,47 @@ class ignition::rendering::Ogre2ThermalCameraPrivate
 using namespace ignition;
 using namespace rendering;
 
+/// \brief Index of the color texture in the node input textures
+static const unsigned int kColorTextureInput = 1u;
+
+//////////////////////////////////////////////////
+void Ogre2ThermalCameraPrivate::ReturnNodeInputs(const void *_owner)
+{
+  if (!this->nodeInputsBorrowed)
+    return;
+  this->nodeInputsBorrowed = false;
+
+  // the material switcher must be attached while the frame renders
+  Ogre2RenderEngine::Instance()->FlushRenderRequests();
+  this->nodeInputTextures[kColorTextureInput]->getBuffer()->
+      getRenderTarget()->removeListener(this->thermalMaterialSwitcher.get());
+  for (auto &texture : this->nodeInputTextures)
+    this->texturePool->Return(_owner, texture);
+}
+
+//////////////////////////////////////////////////
+void Ogre2ThermalCameraPrivate::ReadThermalBuffer()
+{
+  // make sure the requested frame is rendered
+  Ogre2RenderEngine::Instance()->FlushRenderRequests();
+
+  unsigned int width = this->ogreThermalTexture->getWidth();
+  unsigned int height = this->ogreThermalTexture->getHeight();
+  Ogre::PixelFormat format = this->ogreThermalTexture->getFormat();
+
+  if (!this->thermalBuffer)
+  {
+    this->thermalBuffer = new unsigned char[
+        Ogre::PixelUtil::getMemorySize(width, height, 1, format)];
+  }
+  Ogre::PixelBox dstBox(width, height, 1, format, this->thermalBuffer);
+
+  // blit data from gpu to cpu
+  auto rt = this->ogreThermalTexture->getBuffer()->getRenderTarget();
+  rt->copyContentsToMemory(dstBox, Ogre::RenderTarget::FB_FRONT);
+  this->thermalBufferRead = true;
+}
+
 //////////////////////////////////////////////////
 Ogre2ThermalCameraMaterialSwitcher::Ogre2ThermalCameraMaterialSwitcher(
     Ogre2ScenePtr _scene, const std::string & _name) : name(_name)
@@ -211,23 +311,143 @@ Ogre2ThermalCameraMaterialSwitcher::Ogre2ThermalCameraMaterialSwitcher(
   this->heatSourceMaterial = res.staticCast<Ogre::Material>();
   this->heatSourceMaterial->load();
 
-  this->baseHeatSigMaterial = Ogre::MaterialManager::getSingleton().
-    getByName("ThermalHeatSignature");
+  // the heat signature parameters depend on the camera format, so each
+  // camera has its own copy of the material
+  Ogre::MaterialPtr baseHeatSigMaterial =
+      Ogre::MaterialManager::getSingleton().getByName("ThermalHeatSignature");
+  this->heatSignatureMaterial = baseHeatSigMaterial->clone(
+      this->name + "_ThermalHeatSignature");
 
   this->ogreCamera = this->scene->OgreSceneManager()->findCamera(this->name);
 }
 
+//////////////////////////////////////////////////
+Ogre2ThermalCameraMaterialSwitcher::~Ogre2ThermalCameraMaterialSwitcher()
+{
+  if (this->heatSignatureMaterial && Ogre::MaterialManager::getSingletonPtr())
+  {
+    Ogre::MaterialManager::getSingleton().remove(
+        this->heatSignatureMaterial->getName());
+  }
+  if (this->heatSignatureArray && Ogre::TextureManager::getSingletonPtr())
+  {
+    Ogre::TextureManager::getSingleton().remove(
+        this->heatSignatureArray->getName());
+  }
+}
+
 //////////////////////////////////////////////////
 void Ogre2ThermalCameraMaterialSwitcher::SetFormat(PixelFormat _format)
 {
   this->format = _format;
   this->bitDepth = 8u * PixelUtil::BytesPerChannel(format);
+  this->UpdateHeatSignatureParams();
 }
 
 //////////////////////////////////////////////////
 void Ogre2ThermalCameraMaterialSwitcher::SetLinearResolution(double _resolution)
 {
   this->resolution = _resolution;
+  this->UpdateHeatSignatureParams();
+}
+
+//////////////////////////////////////////////////
+void Ogre2ThermalCameraMaterialSwitcher::UpdateHeatSignatureParams()
+{
+  Ogre::GpuProgramParametersSharedPtr params =
+      this->heatSignatureMaterial->getTechnique(0)->getPass(0)->
+      getFragmentProgramParameters();
+  params->setNamedConstant("bitDepth", static_cast<int>(this->bitDepth));
+  params->setNamedConstant("resolution",
+      static_cast<float>(this->resolution));
+}
+
+//////////////////////////////////////////////////
+int Ogre2ThermalCameraMaterialSwitcher::HeatSignatureLayer(
+    const std::string &_texture)
+{
+  auto it = this->heatSignatureLayers.find(_texture);
+  if (it != this->heatSignatureLayers.end())
+    return it->second;
+
+  // make sure the texture is in ogre's resource path
+  auto engine = Ogre2RenderEngine::Instance();
+  engine->AddResourcePath(_texture);
+
+  Ogre::Image image;
+  try
+  {
+    image.load(common::basename(_texture),
+        Ogre::ResourceGroupManager::AUTODETECT_RESOURCE_GROUP_NAME);
+  }
+  catch(Ogre::Exception &e)
+  {
+    ignerr << "Unable to load heat signature texture [" << _texture << "]: "
+           << e.getFullDescription() << std::endl;
+    this->heatSignatureLayers[_texture] = -1;
+    return -1;
+  }
+
+  // all layers have the size of the first texture
+  if (this->heatSignatureData.empty())
+  {
+    this->heatSignatureSize[0] = static_cast<unsigned int>(image.getWidth());
+    this->heatSignatureSize[1] = static_cast<unsigned int>(image.getHeight());
+  }
+  unsigned int width = this->heatSignatureSize[0];
+  unsigned int height = this->heatSignatureSize[1];
+  if (image.getWidth() != width || image.getHeight() != height)
+    image.resize(width, height);
+
+  // only the first channel is used by the heat signature shader
+  std::vector<uint8_t> data(width * height);
+  Ogre::PixelUtil::bulkPixelConversion(image.getPixelBox(),
+      Ogre::PixelBox(width, height, 1, Ogre::PF_L8, data.data()));
+  int layer = static_cast<int>(this->heatSignatureData.size());
+  this->heatSignatureData.push_back(std::move(data));
+  this->heatSignatureLayers[_texture] = layer;
+
+  if (this->heatSignatureData.size() > this->heatSignatureCapacity)
+  {
+    this->CreateHeatSignatureArray(
+        std::max(4u, this->heatSignatureCapacity * 2u));
+  }
+  else
+  {
+    this->heatSignatureArray->getBuffer()->blitFromMemory(
+        Ogre::PixelBox(width, height, 1, Ogre::PF_L8,
+        this->heatSignatureData[layer].data()),
+        Ogre::Box(0, 0, layer, width, height, layer + 1));
+  }
+  return layer;
+}
+
+//////////////////////////////////////////////////
+void Ogre2ThermalCameraMaterialSwitcher::CreateHeatSignatureArray(
+    unsigned int _capacity)
+{
+  auto &manager = Ogre::TextureManager::getSingleton();
+  if (this->heatSignatureArray)
+    manager.remove(this->heatSignatureArray->getName());
+
+  unsigned int width = this->heatSignatureSize[0];
+  unsigned int height = this->heatSignatureSize[1];
+  this->heatSignatureArray = manager.createManual(
+      this->name + "_HeatSignatureArray", "General",
+      Ogre::TEX_TYPE_2D_ARRAY, width, height, _capacity, 0, Ogre::PF_L8);
+  this->heatSignatureCapacity = _capacity;
+
+  for (unsigned int i = 0u; i < this->heatSignatureData.size(); ++i)
+  {
+    this->heatSignatureArray->getBuffer()->blitFromMemory(
+        Ogre::PixelBox(width, height, 1, Ogre::PF_L8,
+        this->heatSignatureData[i].data()),
+        Ogre::Box(0, 0, i, width, height, i + 1));
+  }
+
+  this->heatSignatureMaterial->getTechnique(0)->getPass(0)->
+      getTextureUnitState(0)->setTexture(this->heatSignatureArray);
+  this->heatSignatureMaterial->load();
 }
 //////////////////////////////////////////////////
 void Ogre2ThermalCameraMaterialSwitcher::preRenderTargetUpdate(
@@ -322,66 +542,40 @@ void Ogre2ThermalCameraMaterialSwitcher::preRenderTargetUpdate(
       // get heat signature and the corresponding min/max temperature values
       else if (auto heatSignature = std::get_if<std::string>(&tempAny))
       {
-        // if this is the first time rendering the heat signature,
-        // we need to make sure that the texture is loaded and applied to
-        // the heat signature material before loading the material
-        if (this->heatSignatureMaterials.find(item->getId()) ==
-            this->heatSignatureMaterials.end())
+        int layer = this->HeatSignatureLayer(*heatSignature);
+        if (layer >= 0)
         {
-          // make sure the texture is in ogre's resource path
-          const auto &texture = *heatSignature;
-          auto engine = Ogre2RenderEngine::Instance();
-          engine->AddResourcePath(texture);
-
-          // create a material for this item, now that the texture has been
-          // searched for. We must clone the base heat signature material since
-          // different items may use different textures. We also append the
-          // item's ID to the end of the new material name to ensure new
-          // material uniqueness in case two items use the same heat signature
-          // texture, but have different temperature ranges
-          std::string baseName = common::basename(texture);
-          auto heatSignatureMaterial = this->baseHeatSigMaterial->clone(
-              this->name + "_" + baseName + "_" +
-              Ogre::StringConverter::toString(item->getId()));
-          auto textureUnitStatePtr = heatSignatureMaterial->
-            getTechnique(0)->getPass(0)->getTextureUnitState(0);
-          Ogre::String textureName = baseName;
-          textureUnitStatePtr->setTextureName(textureName);
-
-          // set temperature range for the heat signature
+          // set temperature range for the heat signature, making sure it is
+          // between [min, max] kelvin for the given pixel format and camera
+          // resolution
+          float minTemp = 0.0f;
+          float maxTemp = 100.0f;
           auto minTempVariant = ogreVisual->UserData("minTemp");
           auto maxTempVariant = ogreVisual->UserData("maxTemp");
           auto minTemperature = std::get_if<float>(&minTempVariant);
           auto maxTemperature = std::get_if<float>(&maxTempVariant);
           if (minTemperature && maxTemperature)
           {
-            // make sure the temperature range is between [min, max] kelvin
-            // for the given pixel format and camera resolution
-            float maxTemp = ((1 << bitDepth) - 1.0) * this->resolution;
-            Ogre::GpuProgramParametersSharedPtr params =
-              heatSignatureMaterial->getTechnique(0)->getPass(0)->
-              getFragmentProgramParameters();
-            params->setNamedConstant("minTemp",
-                std::max(static_cast<float>(*minTemperature), 0.0f));
-            params->setNamedConstant("maxTemp",
-                std::min(static_cast<float>(*maxTemperature), maxTemp));
-            params->setNamedConstant("bitDepth",
-                static_cast<int>(this->bitDepth));
-            params->setNamedConstant("resolution",
-                static_cast<float>(this->resolution));
+            minTemp = std::max(*minTemperature, 0.0f);
+            maxTemp = std::min(*maxTemperature,
+                static_cast<float>(((1 << bitDepth) - 1.0) *
+                this->resolution));
           }
-          heatSignatureMaterial->load();
-          this->heatSignatureMaterials[item->getId()] = heatSignatureMaterial;
-        }
 
-        for (unsigned int i = 0; i < item->getNumSubItems(); ++i)
-        {
-          Ogre::SubItem *subItem = item->getSubItem(i);
+          // all items share the heat signature material, the texture layer
+          // and temperature range are passed per sub item
+          for (unsigned int i = 0; i < item->getNumSubItems(); ++i)
+          {
+            Ogre::SubItem *subItem = item->getSubItem(i);
+            subItem->setCustomParameter(this->heatSignatureParamIdx,
+                Ogre::Vector4(static_cast<Ogre::Real>(layer), minTemp,
+                maxTemp, 0.0));
 
-          Ogre::HlmsDatablock *datablock = subItem->getDatablock();
-          this->datablockMap[subItem] = datablock;
+            Ogre::HlmsDatablock *datablock = subItem->getDatablock();
+            this->datablockMap[subItem] = datablock;
 
-          subItem->setMaterial(this->heatSignatureMaterials[item->getId()]);
+            subItem->setMaterial(this->heatSignatureMaterial);
+          }
         }
       }
       // background objects
@@ -482,16 +676,28 @@ void Ogre2ThermalCamera::Destroy()
   Ogre::CompositorManager2 *ogreCompMgr = ogreRoot->getCompositorManager2();
 
   // remove thermal texture, material, compositor
-  if (this->dataPtr->ogreThermalTexture)
-  {
-    Ogre::TextureManager::getSingleton().remove(
-        this->dataPtr->ogreThermalTexture->getName());
-  }
   if (this->dataPtr->ogreCompositorWorkspace)
   {
+    engine->CancelRenderRequest(this->dataPtr->ogreCompositorWorkspace);
     ogreCompMgr->removeWorkspace(
         this->dataPtr->ogreCompositorWorkspace);
   }
+  if (this->dataPtr->ogreThermalTexture)
+  {
+    this->dataPtr->texturePool->Release(this,
+        this->dataPtr->ogreThermalTexture);
+    this->dataPtr->ogreThermalTexture.reset();
+  }
+  if (this->dataPtr->nodeInputsBorrowed)
+  {
+    this->dataPtr->nodeInputTextures[kColorTextureInput]->getBuffer()->
+        getRenderTarget()->removeListener(
+        this->dataPtr->thermalMaterialSwitcher.get());
+    this->dataPtr->nodeInputsBorrowed = false;
+  }
+  for (auto &texture : this->dataPtr->nodeInputTextures)
+    this->dataPtr->texturePool->Release(this, texture);
+  this->dataPtr->nodeInputTextures.clear();
 
   if (this->dataPtr->thermalMaterial)
   {
@@ -656,8 +862,9 @@ void Ogre2ThermalCamera::CreateThermalTexture()
   // compositor_node ThermalCamera
   // {
   //   in 0 rt_input
-  //   texture depthTexture target_width target_height PF_D32_FLOAT
-  //   texture colorTexture target_width target_height PF_R8G8B8A8
+  //   // inputs are acquired from the render texture pool of the scene
+  //   in 1 depthTexture // PF_D32_FLOAT
+  //   in 2 colorTexture // PF_R8G8B8A8, depth_texture PF_D32_FLOAT
   //   target colorTexture
   //   {
   //     pass clear
@@ -695,44 +902,14 @@ void Ogre2ThermalCamera::CreateThermalTexture()
     // Input texture
     nodeDef->addTextureSourceName("rt_input", 0,
         Ogre::TextureDefinitionBase::TEXTURE_INPUT);
-    Ogre::TextureDefinitionBase::TextureDefinition *thermalTexDef =
-        nodeDef->addTextureDefinition("depthTexture");
-    thermalTexDef->textureType = Ogre::TEX_TYPE_2D;
-    thermalTexDef->width = 0;
-    thermalTexDef->height = 0;
-    thermalTexDef->depth = 1;
-    thermalTexDef->numMipmaps = 0;
-    thermalTexDef->widthFactor = 1;
-    thermalTexDef->heightFactor = 1;
-    thermalTexDef->formatList = {Ogre::PF_D32_FLOAT};
-    thermalTexDef->fsaa = 0;
-    thermalTexDef->uav = false;
-    thermalTexDef->automipmaps = false;
-    thermalTexDef->hwGammaWrite = Ogre::TextureDefinitionBase::BoolFalse;
-    // set to default pool so that when the colorTexture pass is rendered, its
-    // depth data get populated to depthTexture
-    thermalTexDef->depthBufferId = Ogre::DepthBuffer::POOL_DEFAULT;
-    thermalTexDef->depthBufferFormat = Ogre::PF_UNKNOWN;
-    thermalTexDef->fsaaExplicitResolve = false;
-
-    Ogre::TextureDefinitionBase::TextureDefinition *colorTexDef =
-        nodeDef->addTextureDefinition("colorTexture");
-    colorTexDef->textureType = Ogre::TEX_TYPE_2D;
-    colorTexDef->width = 0;
-    colorTexDef->height = 0;
-    colorTexDef->depth = 1;
-    colorTexDef->numMipmaps = 0;
-    colorTexDef->widthFactor = 1;
-    colorTexDef->heightFactor = 1;
-    colorTexDef->formatList = {Ogre::PF_R8G8B8A8};
-    colorTexDef->fsaa = 0;
-    colorTexDef->uav = false;
-    colorTexDef->automipmaps = false;
-    colorTexDef->hwGammaWrite = Ogre::TextureDefinitionBase::BoolFalse;
-    colorTexDef->depthBufferId = Ogre::DepthBuffer::POOL_DEFAULT;
-    colorTexDef->depthBufferFormat = Ogre::PF_D32_FLOAT;
-    colorTexDef->preferDepthTexture = true;
-    colorTexDef->fsaaExplicitResolve = false;
+    // the depth and color textures are shared with other sensors. The
+    // depth texture is in the default depth pool, so that when the
+    // colorTexture pass is rendered, its depth data get populated to
+    // depthTexture
+    nodeDef->addTextureSourceName("depthTexture", 1,
+        Ogre::TextureDefinitionBase::TEXTURE_INPUT);
+    nodeDef->addTextureSourceName("colorTexture", 1 + kColorTextureInput,
+        Ogre::TextureDefinitionBase::TEXTURE_INPUT);
 
     nodeDef->setNumTargetPass(2);
     Ogre::CompositorTargetDef *colorTargetDef =
@@ -750,7 +927,8 @@ void Ogre2ThermalCamera::CreateThermalTexture()
           colorTargetDef->addPass(Ogre::PASS_SCENE));
       // thermal camera should not see particles
       passScene->mVisibilityMask = IGN_VISIBILITY_ALL &
-          ~Ogre2ParticleEmitter::kParticleVisibilityFlags;
+          ~Ogre2ParticleEmitter::kParticleVisibilityFlags &
+          renderVisibilityMask(this->VisibilityMask());
     }
 
     // rt_input target - converts to thermal
@@ -777,6 +955,8 @@ void Ogre2ThermalCamera::CreateThermalTexture()
     Ogre::CompositorWorkspaceDef *workDef =
         ogreCompMgr->addWorkspaceDefinition(wsDefName);
     workDef->connectExternal(0, nodeDef->getName(), 0);
+    workDef->connectExternal(1, nodeDef->getName(), 1);
+    workDef->connectExternal(2, nodeDef->getName(), 2);
   }
   Ogre::CompositorWorkspaceDef *wsDef =
       ogreCompMgr->getWorkspaceDefinition(wsDefName);
@@ -787,50 +967,72 @@ void Ogre2ThermalCamera::CreateThermalTexture()
            << " for " << this->Name();
   }
 
-  // create render texture - these textures pack the thermal data
-  this->dataPtr->ogreThermalTexture =
-    Ogre::TextureManager::getSingleton().createManual(
-    this->Name() + "_thermal", "General", Ogre::TEX_TYPE_2D,
-    this->ImageWidth(), this->ImageHeight(), 1, 0,
-    ogrePF, Ogre::TU_RENDERTARGET,
-    0, false, 0, Ogre::BLANKSTRING, false, true);
-
-  Ogre::RenderTarget *rt =
-    this->dataPtr->ogreThermalTexture->getBuffer()->getRenderTarget();
+  // create render texture - these textures pack the thermal data.
+  // The texture is only needed while the camera is updated so it is shared
+  // with the other sensors of the same size and format
+  unsigned int width = this->ImageWidth();
+  unsigned int height = this->ImageHeight();
+  Ogre2RenderTexturePoolPtr pool = this->scene->RenderTexturePool();
+  this->dataPtr->texturePool = pool;
+  this->dataPtr->ogreThermalTexture = pool->Acquire(
+      this, width, height, ogrePF);
+  this->dataPtr->nodeInputTextures = {
+      pool->Acquire(this, width, height, Ogre::PF_D32_FLOAT),
+      pool->Acquire(this, width, height, Ogre::PF_R8G8B8A8, false,
+          Ogre::PF_D32_FLOAT)};
+
+  Ogre::CompositorChannelVec externalTargets;
+  externalTargets.push_back(
+      Ogre2RenderTexturePool::Channel(this->dataPtr->ogreThermalTexture));
+  for (auto &texture : this->dataPtr->nodeInputTextures)
+    externalTargets.push_back(Ogre2RenderTexturePool::Channel(texture));
 
   // create compositor worksspace
   this->dataPtr->ogreCompositorWorkspace =
       ogreCompMgr->addWorkspace(this->scene->OgreSceneManager(),
-      rt, this->ogreCamera, wsDefName, false);
-
-  // add thermal material swticher to render target listener
-  // so we can switch to use heat material when the camera is being udpated
-  Ogre::CompositorNode *node =
-      this->dataPtr->ogreCompositorWorkspace->getNodeSequence()[0];
-  auto channels = node->getLocalTextures();
-  for (auto c : channels)
-  {
-    if (c.textures[0]->getSrcFormat() == Ogre::PF_R8G8B8A8)
-    {
-      this->dataPtr->thermalMaterialSwitcher.reset(
-          new Ogre2ThermalCameraMaterialSwitcher(this->scene, this->Name()));
-      this->dataPtr->thermalMaterialSwitcher->SetFormat(this->ImageFormat());
-      this->dataPtr->thermalMaterialSwitcher->SetLinearResolution(
-          this->resolution);
-      c.target->addListener(this->dataPtr->thermalMaterialSwitcher.get());
-      break;
-    }
-  }
+      externalTargets, this->ogreCamera, wsDefName, false);
+
+  // thermal material swticher so we can switch to use heat material when
+  // the camera is being udpated. It is added to the color texture while the
+  // camera borrows it, see Render
+  this->dataPtr->thermalMaterialSwitcher.reset(
+      new Ogre2ThermalCameraMaterialSwitcher(this->scene, this->Name()));
+  this->dataPtr->thermalMaterialSwitcher->SetFormat(this->ImageFormat());
+  this->dataPtr->thermalMaterialSwitcher->SetLinearResolution(
+      this->resolution);
 }
 
 //////////////////////////////////////////////////
 void Ogre2ThermalCamera::Render()
 {
-  // update the compositors
-  this->dataPtr->ogreCompositorWorkspace->setEnabled(true);
-  auto engine = Ogre2RenderEngine::Instance();
-  engine->OgreRoot()->renderOneFrame();
-  this->dataPtr->ogreCompositorWorkspace->setEnabled(false);
+  // borrow the node inputs. Other sensors render into them too, so the
+  // material switcher is only attached while the camera holds them
+  for (auto &texture : this->dataPtr->nodeInputTextures)
+  {
+    this->dataPtr->texturePool->Borrow(this, texture,
+        [this]() { this->dataPtr->ReturnNodeInputs(this); });
+  }
+  if (!this->dataPtr->nodeInputsBorrowed)
+  {
+    this->dataPtr->nodeInputTextures[kColorTextureInput]->getBuffer()->
+        getRenderTarget()->addListener(
+        this->dataPtr->thermalMaterialSwitcher.get());
+    this->dataPtr->nodeInputsBorrowed = true;
+  }
+
+  // borrow the thermal texture. If another sensor borrows it before
+  // PostRender, the thermal data is read back right away
+  std::function<void()> reclaim;
+  if (this->dataPtr->newThermalFrame.ConnectionCount() > 0u)
+    reclaim = [this]() { this->dataPtr->ReadThermalBuffer(); };
+  this->dataPtr->thermalBufferRead = false;
+  this->dataPtr->texturePool->Borrow(this, this->dataPtr->ogreThermalTexture,
+      reclaim);
+
+  // update the compositors together with the other sensors, the thermal
+  // data is read back in PostRender
+  Ogre2RenderEngine::Instance()->RequestRender(
+      this->dataPtr->ogreCompositorWorkspace);
 }
 
 //////////////////////////////////////////////////
@@ -844,28 +1046,29 @@ void Ogre2ThermalCamera::PreRender()
 void Ogre2ThermalCamera::PostRender()
 {
   if (this->dataPtr->newThermalFrame.ConnectionCount() <= 0u)
+  {
+    this->dataPtr->texturePool->Return(this,
+        this->dataPtr->ogreThermalTexture);
+    this->dataPtr->ReturnNodeInputs(this);
     return;
+  }
 
   unsigned int width = this->ImageWidth();
   unsigned int height = this->ImageHeight();
   PixelFormat format = this->ImageFormat();
-  Ogre::PixelFormat imageFormat = Ogre2Conversions::Convert(format);
 
   int len = width * height;
   unsigned int channelCount = PixelUtil::ChannelCount(format);
   unsigned int bytesPerChannel = PixelUtil::BytesPerChannel(format);
 
-  if (!this->dataPtr->thermalBuffer)
-  {
-    this->dataPtr->thermalBuffer =
-        new unsigned char[len * channelCount * bytesPerChannel];
-  }
-  Ogre::PixelBox dstBox(width, height,
-        1, imageFormat, this->dataPtr->thermalBuffer);
-
-  // blit data from gpu to cpu
-  auto rt = this->dataPtr->ogreThermalTexture->getBuffer()->getRenderTarget();
-  rt->copyContentsToMemory(dstBox, Ogre::RenderTarget::FB_FRONT);
+  // blit data from gpu to cpu, unless it was already done when another
+  // sensor borrowed the thermal texture
+  if (!this->dataPtr->thermalBufferRead)
+    this->dataPtr->ReadThermalBuffer();
+  this->dataPtr->thermalBufferRead = false;
+  this->dataPtr->texturePool->Return(this,
+      this->dataPtr->ogreThermalTexture);
+  this->dataPtr->ReturnNodeInputs(this);
 
   if (!this->dataPtr->thermalImage)
   {
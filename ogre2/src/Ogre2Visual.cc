@@ -15,6 +15,8 @@
  *
  */
 
+#include <vector>
+
 #include <ignition/common/Console.hh>
 
 #include "ignition/rendering/ogre2/Ogre2Conversions.hh"
@@ -32,8 +34,34 @@ using namespace rendering;
 /// \brief Private data for the Ogre2Visual class
 class ignition::rendering::Ogre2VisualPrivate
 {
+  /// \brief Local bounding boxes of the visible objects attached to the
+  /// visual's node, in the node's frame and without scale applied
+  public: std::vector<ignition::math::AxisAlignedBox> objectBoxes;
+
+  /// \brief Scratch storage used to check if objectBoxes changed without
+  /// allocating memory
+  public: std::vector<ignition::math::AxisAlignedBox> scratchBoxes;
+
+  /// \brief True if a visible light is attached to the visual's node
+  public: bool hasLight = false;
+
+  /// \brief True if objectBoxes and hasLight need to be recomputed
+  public: bool contentDirty = true;
+
+  /// \brief Cached world bounding box of this visual and its descendants,
+  /// valid when Ogre2Node::worldBoundsDirty is false
+  public: ignition::math::AxisAlignedBox worldBox;
+
+  /// \brief Cached local bounding box of this visual and its descendants,
+  /// valid when Ogre2Node::localBoundsDirty is false
+  public: ignition::math::AxisAlignedBox localBox;
 };
 
+/// \brief Bounding box used for lights, which Ogre does not provide
+static const ignition::math::AxisAlignedBox kLightBox(
+    ignition::math::Vector3d(-0.5, -0.5, -0.5),
+    ignition::math::Vector3d(0.5, 0.5, 0.5));
+
 //////////////////////////////////////////////////
 Ogre2Visual::Ogre2Visual()
   : dataPtr(new Ogre2VisualPrivate)
@@ -48,7 +76,11 @@ Ogre2Visual::~Ogre2Visual()
 //////////////////////////////////////////////////
 void Ogre2Visual::SetVisible(bool _visible)
 {
+  this->visible = _visible;
   this->ogreNode->setVisible(_visible);
+
+  // ogre cascades the visibility to all descendants
+  this->MarkContentDirty(true);
 }
 
 //////////////////////////////////////////////////
@@ -61,9 +93,11 @@ void Ogre2Visual::SetVisibilityFlags(uint32_t _flags)
 
   for (unsigned int i = 0; i < this->ogreNode->numAttachedObjects(); ++i)
   {
-    this->ogreNode->getAttachedObject(i)->setVisibilityFlags(_flags
+    this->ogreNode->getAttachedObject(i)->setVisibilityFlags(
+      renderVisibilityFlags(_flags)
       & ~Ogre2ParticleEmitter::kParticleVisibilityFlags);
   }
+  this->MarkContentDirty(false);
 }
 
 //////////////////////////////////////////////////
@@ -104,11 +138,12 @@ bool Ogre2Visual::AttachGeometry(GeometryPtr _geometry)
   ogreObj->getUserObjectBindings().setUserAny(
       Ogre::Any(this->Id()));
   ogreObj->setName(this->Name() + "_" + _geometry->Name());
-  ogreObj->setVisibilityFlags(this->visibilityFlags
+  ogreObj->setVisibilityFlags(renderVisibilityFlags(this->visibilityFlags)
       & ~Ogre2ParticleEmitter::kParticleVisibilityFlags);
 
   derived->SetParent(this->SharedThis());
   this->ogreNode->attachObject(ogreObj);
+  this->MarkContentDirty(false);
 
   return true;
 }
@@ -129,37 +164,119 @@ bool Ogre2Visual::DetachGeometry(GeometryPtr _geometry)
 
   this->ogreNode->detachObject(derived->OgreObject());
   derived->SetParent(nullptr);
+  this->MarkContentDirty(false);
   return true;
 }
 
+//////////////////////////////////////////////////
+void Ogre2Visual::PreRender()
+{
+  BaseVisual::PreRender();
+
+  // geometries such as markers and particle emitters may change their
+  // bounds in PreRender. Detect that so cached bounds stay valid.
+  if (!this->dataPtr->contentDirty && this->UpdateContentBounds())
+  {
+    this->MarkBoundsDirty();
+    this->MarkSceneBoundsDirty();
+  }
+}
+
 //////////////////////////////////////////////////
 ignition::math::AxisAlignedBox Ogre2Visual::LocalBoundingBox() const
 {
-  ignition::math::AxisAlignedBox box;
-  this->BoundsHelper(box, true /* local frame */);
-  return box;
+  if (this->localBoundsDirty)
+  {
+    ignition::math::AxisAlignedBox box;
+    this->BoundsHelper(box, this->WorldPose());
+    this->dataPtr->localBox = box;
+    this->localBoundsDirty = false;
+  }
+  return this->dataPtr->localBox;
 }
 
 //////////////////////////////////////////////////
 ignition::math::AxisAlignedBox Ogre2Visual::BoundingBox() const
 {
-  ignition::math::AxisAlignedBox box;
-  this->BoundsHelper(box, false /* world frame */);
-  return box;
+  if (this->worldBoundsDirty)
+  {
+    if (this->dataPtr->contentDirty)
+      this->UpdateContentBounds();
+
+    ignition::math::AxisAlignedBox box;
+    if (this->dataPtr->hasLight)
+      box.Merge(kLightBox);
+
+    if (!this->dataPtr->objectBoxes.empty())
+    {
+      const ignition::math::Pose3d &pose = this->WorldPose();
+      const ignition::math::Vector3d &scale = this->WorldScale();
+      for (const auto &objBox : this->dataPtr->objectBoxes)
+      {
+        box.Merge(transformAxisAlignedBox(ignition::math::AxisAlignedBox(
+            scale * objBox.Min(), scale * objBox.Max()), pose));
+      }
+    }
+
+    // the union of the children's world boxes is exact, so the cached
+    // boxes of the children can be reused as is
+    for (auto it = this->children->Begin(); it != this->children->End();
+        ++it)
+    {
+      const Ogre2Visual *visual =
+          dynamic_cast<const Ogre2Visual *>(it->second.get());
+      if (visual)
+        box.Merge(visual->BoundingBox());
+    }
+
+    this->dataPtr->worldBox = box;
+    this->worldBoundsDirty = false;
+  }
+  return this->dataPtr->worldBox;
 }
 
 //////////////////////////////////////////////////
 void Ogre2Visual::BoundsHelper(ignition::math::AxisAlignedBox &_box,
-    bool _local) const
+    const ignition::math::Pose3d &_pose) const
 {
-  this->BoundsHelper(_box, _local, this->WorldPose());
+  if (this->dataPtr->contentDirty)
+    this->UpdateContentBounds();
+
+  if (this->dataPtr->hasLight)
+    _box.Merge(kLightBox);
+
+  if (!this->dataPtr->objectBoxes.empty())
+  {
+    // transform from this visual's frame to the frame of _pose
+    const ignition::math::Pose3d &worldPose = this->WorldPose();
+    const ignition::math::Vector3d &scale = this->WorldScale();
+    ignition::math::Quaterniond parentRotInv = _pose.Rot().Inverse();
+    ignition::math::Pose3d transform(
+        parentRotInv * (worldPose.Pos() - _pose.Pos()),
+        parentRotInv * worldPose.Rot());
+
+    for (const auto &objBox : this->dataPtr->objectBoxes)
+    {
+      _box.Merge(transformAxisAlignedBox(ignition::math::AxisAlignedBox(
+          scale * objBox.Min(), scale * objBox.Max()), transform));
+    }
+  }
+
+  for (auto it = this->children->Begin(); it != this->children->End(); ++it)
+  {
+    const Ogre2Visual *visual =
+        dynamic_cast<const Ogre2Visual *>(it->second.get());
+    if (visual)
+      visual->BoundsHelper(_box, _pose);
+  }
 }
 
 //////////////////////////////////////////////////
-void Ogre2Visual::BoundsHelper(ignition::math::AxisAlignedBox &_box,
-    bool _local, const ignition::math::Pose3d &_pose) const
+bool Ogre2Visual::UpdateContentBounds() const
 {
-  ignition::math::Vector3d scale = this->WorldScale();
+  auto &boxes = this->dataPtr->scratchBoxes;
+  boxes.clear();
+  bool hasLight = false;
 
   for (size_t i = 0; i < this->ogreNode->numAttachedObjects(); i++)
   {
@@ -167,62 +284,45 @@ void Ogre2Visual::BoundsHelper(ignition::math::AxisAlignedBox &_box,
 
     if (obj->isVisible() && obj->getVisibilityFlags() != IGN_VISIBILITY_GUI)
     {
-      Ogre::Aabb bb = obj->getLocalAabb();
-
-      ignition::math::Vector3d min(0, 0, 0);
-      ignition::math::Vector3d max(0, 0, 0);
-      ignition::math::AxisAlignedBox box(min, max);
-
       // Ogre does not return a valid bounding box for lights.
       if (obj->getMovableType() == Ogre::LightFactory::FACTORY_TYPE_NAME)
       {
-        box.Min() = ignition::math::Vector3d(-0.5, -0.5, -0.5);
-        box.Max()  = ignition::math::Vector3d(0.5, 0.5, 0.5);
+        hasLight = true;
       }
       else
       {
-        Ogre::Vector3 ogreMin = bb.getMinimum();
-        Ogre::Vector3 ogreMax = bb.getMaximum();
-
-        // Get ogre bounding boxes and size to object's scale
-        min = scale * ignition::math::Vector3d(ogreMin.x, ogreMin.y, ogreMin.z);
-        max = scale * ignition::math::Vector3d(ogreMax.x, ogreMax.y, ogreMax.z);
-        box.Min() = min,
-        box.Max() = max;
-
-        // Assume world transform
-        ignition::math::Pose3d transform = _pose;
-
-        // If local frame, calculate transform matrix and set
-        if (_local)
-        {
-          ignition::math::Pose3d worldPose = this->WorldPose();
-          ignition::math::Vector3d parentPos = _pose.Pos();
-          ignition::math::Quaternion parentRotInv = _pose.Rot().Inverse();
-          ignition::math::Pose3d localTransform =
-            ignition::math::Pose3d(
-                (parentRotInv * (worldPose.Pos() - parentPos)),
-                (parentRotInv * worldPose.Rot()));
-          transform = localTransform;
-        }
-
-        // Transform to world or local space
-        box = transformAxisAlignedBox(box, transform);
+        Ogre::Aabb bb = obj->getLocalAabb();
+        boxes.push_back(ignition::math::AxisAlignedBox(
+            Ogre2Conversions::Convert(bb.getMinimum()),
+            Ogre2Conversions::Convert(bb.getMaximum())));
       }
-      _box.Merge(box);
     }
   }
 
-  auto childNodes = std::dynamic_pointer_cast<Ogre2NodeStore>(this->Children());
-  if (!childNodes)
+  bool changed = this->dataPtr->contentDirty ||
+      hasLight != this->dataPtr->hasLight ||
+      boxes != this->dataPtr->objectBoxes;
+
+  this->dataPtr->objectBoxes.swap(boxes);
+  this->dataPtr->hasLight = hasLight;
+  this->dataPtr->contentDirty = false;
+  return changed;
+}
+
+//////////////////////////////////////////////////
+void Ogre2Visual::MarkContentDirty(bool _recursive)
+{
+  this->dataPtr->contentDirty = true;
+  this->MarkBoundsDirty();
+
+  if (!_recursive || !this->children)
     return;
 
-  for (auto it = childNodes->Begin(); it != childNodes->End(); ++it)
+  for (auto it = this->children->Begin(); it != this->children->End(); ++it)
   {
-    NodePtr child = it->second;
-    Ogre2VisualPtr visual = std::dynamic_pointer_cast<Ogre2Visual>(child);
+    Ogre2Visual *visual = dynamic_cast<Ogre2Visual *>(it->second.get());
     if (visual)
-      visual->BoundsHelper(_box, _local, _pose);
+      visual->MarkContentDirty(true);
   }
 }
 
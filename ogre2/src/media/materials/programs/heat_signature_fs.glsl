@@ -17,8 +17,8 @@
 
 #version 330
 
-// The input texture, which is set up by the Ogre Compositor infrastructure.
-uniform sampler2D RT;
+// The heat signature textures of all items, one per layer
+uniform sampler2DArray RT;
 
 // input params from vertex shader
 in block
@@ -29,11 +29,11 @@ in block
 // final output color
 out vec4 fragColor;
 
-// The minimum and maximum temprature values (in Kelvin) that the
+// Per item heat signature parameters:
+// x: layer of the item's heat signature texture in RT
+// y, z: the minimum and maximum temprature values (in Kelvin) that the
 // heat signature texture should be normalized to
-// (users can override these defaults)
-uniform float minTemp = 0.0;
-uniform float maxTemp = 100.0;
+uniform vec4 heatSignature;
 
 uniform int bitDepth;
 uniform float resolution;
@@ -42,13 +42,15 @@ uniform float resolution;
 // [minTemp, maxTemp] range
 float mapNormalized(float num)
 {
+  float minTemp = heatSignature.y;
+  float maxTemp = heatSignature.z;
   float mappedKelvin = ((maxTemp - minTemp) * num) + minTemp;
   return mappedKelvin / (((1 << bitDepth) - 1.0) * resolution);
 }
 
 void main()
 {
-  float heat = texture(RT, inPs.uv0.xy).x;
+  float heat = texture(RT, vec3(inPs.uv0.xy, heatSignature.x)).x;
 
   // set g, b, a to 0. This will be used by thermal_camera_fs.glsl to determine
   // if a particular fragment is a heat source or not
@@ -39,6 +39,11 @@ namespace ignition
 
       public: virtual optix::Buffer OptixBuffer() const = 0;
 
+      /// \brief Get the resolution scale. Optix render targets always
+      /// render at full resolution.
+      /// \return Always 1
+      public: virtual double ResolutionScale() const override;
+
       protected: unsigned int MemorySize() const;
 
       protected: float *hostData;
@@ -68,6 +68,12 @@ void OptixRenderTarget::Copy(Image &_image) const
   this->OptixBuffer()->unmap();
 }
 
+//////////////////////////////////////////////////
+double OptixRenderTarget::ResolutionScale() const
+{
+  return 1.0;
+}
+
 //////////////////////////////////////////////////
 unsigned int OptixRenderTarget::MemorySize() const
 {
@@ -0,0 +1,196 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+
+#include "test_config.h"  // NOLINT(build/include)
+#include "ignition/rendering/BoundingBoxCamera.hh"
+#include "ignition/rendering/RenderEngine.hh"
+#include "ignition/rendering/RenderingIface.hh"
+#include "ignition/rendering/Scene.hh"
+#include "ignition/rendering/Visual.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+class BoundingBoxCameraTest : public testing::Test,
+                              public testing::WithParamInterface<const char *>
+{
+  /// \brief Test the boxes of labelled visuals
+  public: void Boxes(const std::string &_renderEngine);
+};
+
+/////////////////////////////////////////////////
+/// \brief Find the box with the given label
+/// \param[in] _boxes Boxes reported by the camera
+/// \param[in] _label Label to look for
+/// \return Pointer to the box, or null if there is none
+const BoundingBox *FindBox(const std::vector<BoundingBox> &_boxes,
+    uint32_t _label)
+{
+  for (const auto &box : _boxes)
+  {
+    if (box.label == _label)
+      return &box;
+  }
+  return nullptr;
+}
+
+/////////////////////////////////////////////////
+void BoundingBoxCameraTest::Boxes(const std::string &_renderEngine)
+{
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+           << "' is not supported" << std::endl;
+    return;
+  }
+
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+
+  BoundingBoxCameraPtr camera = scene->CreateBoundingBoxCamera();
+  if (!camera)
+  {
+    igndbg << "Bounding box camera not supported yet in rendering engine: "
+           << _renderEngine << std::endl;
+    engine->DestroyScene(scene);
+    rendering::unloadEngine(engine->Name());
+    return;
+  }
+  EXPECT_EQ(BBT_VISIBLEBOX2D, camera->Type());
+  camera->SetBoundingBoxType(BBT_BOX3D);
+  EXPECT_EQ(BBT_BOX3D, camera->Type());
+
+  // a labelled visual whose box is a child without a label
+  VisualPtr left = scene->CreateVisual();
+  left->SetLocalPosition(3.0, 0.8, 0.0);
+  left->SetUserData("label", 1);
+  VisualPtr leftBox = scene->CreateVisual();
+  leftBox->AddGeometry(scene->CreateBox());
+  left->AddChild(leftBox);
+  scene->RootVisual()->AddChild(left);
+
+  // a labelled box, partly hidden by an unlabelled one
+  VisualPtr right = scene->CreateVisual();
+  right->AddGeometry(scene->CreateBox());
+  right->SetLocalPosition(3.0, -0.8, 0.0);
+  right->SetUserData("label", 2);
+  scene->RootVisual()->AddChild(right);
+
+  VisualPtr occluder = scene->CreateVisual();
+  occluder->AddGeometry(scene->CreateBox());
+  occluder->SetLocalPosition(2.0, -0.9, 0.0);
+  occluder->SetLocalScale(0.1, 0.4, 2.0);
+  scene->RootVisual()->AddChild(occluder);
+
+  // a labelled box behind the camera is left out
+  VisualPtr behind = scene->CreateVisual();
+  behind->AddGeometry(scene->CreateBox());
+  behind->SetLocalPosition(-3.0, 0.0, 0.0);
+  behind->SetUserData("label", 3);
+  scene->RootVisual()->AddChild(behind);
+
+  const unsigned int width = 320u;
+  const unsigned int height = 240u;
+  camera->SetImageWidth(width);
+  camera->SetImageHeight(height);
+  camera->SetAspectRatio(static_cast<double>(width) / height);
+  camera->SetLocalPosition(0.0, 0.0, 0.0);
+  scene->RootVisual()->AddChild(camera);
+
+  unsigned int frames = 0u;
+  common::ConnectionPtr connection = camera->ConnectNewBoundingBoxes(
+      [&frames](const std::vector<BoundingBox> &) { ++frames; });
+
+  // 3D boxes are in the camera frame
+  camera->Update();
+  EXPECT_EQ(1u, frames);
+  std::vector<BoundingBox> boxes = camera->BoundingBoxData();
+  ASSERT_EQ(2u, boxes.size());
+  EXPECT_EQ(nullptr, FindBox(boxes, 3u));
+  const BoundingBox *box = FindBox(boxes, 1u);
+  ASSERT_NE(nullptr, box);
+  EXPECT_EQ(BBT_BOX3D, box->type);
+  EXPECT_TRUE(box->center.Equal(math::Vector3d(3.0, 0.8, 0.0), 1e-3));
+  EXPECT_TRUE(box->size.Equal(math::Vector3d::One, 1e-3));
+  box = FindBox(boxes, 2u);
+  ASSERT_NE(nullptr, box);
+  EXPECT_TRUE(box->center.Equal(math::Vector3d(3.0, -0.8, 0.0), 1e-3));
+
+  // the full box of the partly hidden visual is larger than its visible
+  // box, the other one is fully visible
+  camera->SetBoundingBoxType(BBT_FULLBOX2D);
+  camera->Update();
+  std::vector<BoundingBox> fullBoxes = camera->BoundingBoxData();
+  camera->SetBoundingBoxType(BBT_VISIBLEBOX2D);
+  camera->Update();
+  std::vector<BoundingBox> visibleBoxes = camera->BoundingBoxData();
+  EXPECT_EQ(3u, frames);
+  ASSERT_EQ(2u, fullBoxes.size());
+  ASSERT_EQ(2u, visibleBoxes.size());
+
+  const BoundingBox *fullLeft = FindBox(fullBoxes, 1u);
+  const BoundingBox *visibleLeft = FindBox(visibleBoxes, 1u);
+  ASSERT_NE(nullptr, fullLeft);
+  ASSERT_NE(nullptr, visibleLeft);
+  EXPECT_EQ(BBT_FULLBOX2D, fullLeft->type);
+  EXPECT_EQ(BBT_VISIBLEBOX2D, visibleLeft->type);
+  EXPECT_NEAR(fullLeft->center.X(), visibleLeft->center.X(), 2.0);
+  EXPECT_NEAR(fullLeft->center.Y(), visibleLeft->center.Y(), 2.0);
+  EXPECT_NEAR(fullLeft->size.X(), visibleLeft->size.X(), 2.0);
+  EXPECT_NEAR(fullLeft->size.Y(), visibleLeft->size.Y(), 2.0);
+
+  // the left visual is on the left of the image
+  EXPECT_LT(fullLeft->center.X(), width * 0.5);
+  EXPECT_NEAR(height * 0.5, fullLeft->center.Y(), 2.0);
+
+  const BoundingBox *fullRight = FindBox(fullBoxes, 2u);
+  const BoundingBox *visibleRight = FindBox(visibleBoxes, 2u);
+  ASSERT_NE(nullptr, fullRight);
+  ASSERT_NE(nullptr, visibleRight);
+  EXPECT_GT(fullRight->center.X(), width * 0.5);
+  EXPECT_LT(visibleRight->size.X() + 2.0, fullRight->size.X());
+  EXPECT_NEAR(fullRight->size.Y(), visibleRight->size.Y(), 2.0);
+
+  // Clean up
+  connection.reset();
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+TEST_P(BoundingBoxCameraTest, Boxes)
+{
+  Boxes(GetParam());
+}
+
+INSTANTIATE_TEST_CASE_P(BoundingBoxCamera, BoundingBoxCameraTest,
+    RENDER_ENGINE_VALUES,
+    ignition::rendering::PrintToStringParam());
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -17,15 +17,23 @@
 
 #include <gtest/gtest.h>
 
+#include <string>
+#include <vector>
+
 #include <ignition/common/Console.hh>
 
 #include "test_config.h"  // NOLINT(build/include)
 #include "ignition/rendering/Camera.hh"
 #include "ignition/rendering/GaussianNoisePass.hh"
+#include "ignition/rendering/Image.hh"
+#include "ignition/rendering/Material.hh"
 #include "ignition/rendering/RenderEngine.hh"
 #include "ignition/rendering/RenderingIface.hh"
 #include "ignition/rendering/RenderPassSystem.hh"
 #include "ignition/rendering/Scene.hh"
+#include "ignition/rendering/Utils.hh"
+#include "ignition/rendering/VisibilityIndex.hh"
+#include "ignition/rendering/Visual.hh"
 
 using namespace ignition;
 using namespace rendering;
@@ -47,6 +55,12 @@ class CameraTest : public testing::Test,
 
   /// \brief Test setting visibility mask
   public: void VisibilityMask(const std::string &_renderEngine);
+
+  /// \brief Test that visuals on disabled layers are not rendered
+  public: void VisibilityLayers(const std::string &_renderEngine);
+
+  /// \brief Test querying visible visuals without rendering
+  public: void VisibleVisuals(const std::string &_renderEngine);
 };
 
 /////////////////////////////////////////////////
@@ -81,6 +95,16 @@ void CameraTest::ViewProjectionMatrix(const std::string &_renderEngine)
   camera->SetAntiAliasing(1u);
   EXPECT_EQ(1u, camera->AntiAliasing());
 
+  // cameras start with the scene background color and can have their own
+  EXPECT_EQ(scene->BackgroundColor(), camera->BackgroundColor());
+  if (_renderEngine != "optix")
+  {
+    math::Color background = scene->BackgroundColor();
+    camera->SetBackgroundColor(math::Color(1.0f, 0.0f, 1.0f));
+    EXPECT_EQ(math::Color(1.0f, 0.0f, 1.0f), camera->BackgroundColor());
+    EXPECT_EQ(background, scene->BackgroundColor());
+  }
+
   EXPECT_GT(camera->NearClipPlane(), 0);
   camera->SetNearClipPlane(0.1);
   EXPECT_DOUBLE_EQ(0.1, camera->NearClipPlane());
@@ -309,6 +333,260 @@ void CameraTest::VisibilityMask(const std::string &_renderEngine)
   camera->SetVisibilityMask(0u);
   EXPECT_EQ(0u, camera->VisibilityMask());
 
+  // named visibility layers
+  camera->SetVisibilityMask(IGN_VISIBILITY_ALL);
+  uint32_t collision = scene->VisibilityLayer("collision");
+  uint32_t inertia = scene->VisibilityLayer("inertia");
+  EXPECT_NE(0u, collision & IGN_VISIBILITY_LAYERS);
+  EXPECT_NE(0u, inertia & IGN_VISIBILITY_LAYERS);
+  EXPECT_NE(collision, inertia);
+  EXPECT_EQ(collision, scene->VisibilityLayer("collision"));
+  EXPECT_TRUE(camera->VisibilityLayerEnabled("collision"));
+  EXPECT_TRUE(camera->VisibilityLayerEnabled("inertia"));
+
+  VisualPtr visual = scene->CreateVisual();
+  VisualPtr child = scene->CreateVisual();
+  visual->AddChild(child);
+  visual->SetVisibilityLayer("collision");
+  uint32_t layered = (IGN_VISIBILITY_ALL &
+      ~static_cast<uint32_t>(IGN_VISIBILITY_LAYERS)) | collision;
+  EXPECT_EQ(layered, visual->VisibilityFlags());
+  EXPECT_EQ(layered, child->VisibilityFlags());
+  EXPECT_NE(0u, visual->VisibilityFlags() & IGN_VISIBILITY_GUI);
+  EXPECT_NE(0u, visual->VisibilityFlags() & IGN_VISIBILITY_SELECTABLE);
+
+  camera->SetVisibilityLayerEnabled("collision", false);
+  EXPECT_FALSE(camera->VisibilityLayerEnabled("collision"));
+  EXPECT_TRUE(camera->VisibilityLayerEnabled("inertia"));
+  EXPECT_EQ(0u, renderVisibilityMask(camera->VisibilityMask()) &
+      renderVisibilityFlags(visual->VisibilityFlags()));
+  camera->SetVisibilityLayerEnabled("collision", true);
+  EXPECT_TRUE(camera->VisibilityLayerEnabled("collision"));
+  EXPECT_EQ(static_cast<uint32_t>(IGN_VISIBILITY_ALL),
+      camera->VisibilityMask());
+
+  // querying an unknown layer does not create it
+  EXPECT_FALSE(camera->VisibilityLayerEnabled("unknown"));
+  EXPECT_EQ(0u, scene->VisibilityLayerFlag("unknown"));
+  EXPECT_EQ(collision, scene->VisibilityLayerFlag("collision"));
+
+  // there is a limited number of layers
+  unsigned int layerCount = 2u;
+  while (scene->VisibilityLayer("layer" + std::to_string(layerCount)) != 0u)
+    ++layerCount;
+  EXPECT_EQ(12u, layerCount);
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+void CameraTest::VisibilityLayers(const std::string &_renderEngine)
+{
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+  scene->SetBackgroundColor(0.0, 0.0, 1.0);
+
+  MaterialPtr red = scene->CreateMaterial();
+  red->SetAmbient(1.0, 0.0, 0.0);
+  red->SetDiffuse(1.0, 0.0, 0.0);
+  red->SetEmissive(1.0, 0.0, 0.0);
+
+  // a box filling the image, on the collision layer
+  VisualPtr box = scene->CreateVisual();
+  box->AddGeometry(scene->CreateBox());
+  box->SetMaterial(red);
+  box->SetLocalPosition(2.0, 0.0, 0.0);
+  box->SetLocalScale(1.0, 4.0, 4.0);
+  box->SetVisibilityLayer("collision");
+  scene->RootVisual()->AddChild(box);
+
+  CameraPtr camera = scene->CreateCamera();
+  ASSERT_NE(nullptr, camera);
+  camera->SetImageWidth(32u);
+  camera->SetImageHeight(32u);
+  camera->SetImageFormat(PixelFormat::PF_R8G8B8);
+  scene->RootVisual()->AddChild(camera);
+
+  // the pixel at the center is red while the layer is enabled, and shows
+  // the blue background otherwise
+  Image image = camera->CreateImage();
+  unsigned int center = (16u * 32u + 16u) * 3u;
+  camera->Capture(image);
+  const unsigned char *data = image.Data<unsigned char>();
+  EXPECT_GT(data[center], data[center + 2]);
+
+  camera->SetVisibilityLayerEnabled("collision", false);
+  camera->Capture(image);
+  data = image.Data<unsigned char>();
+  EXPECT_LT(data[center], data[center + 2]);
+
+  // other layers do not hide the box
+  camera->SetVisibilityLayerEnabled("collision", true);
+  camera->SetVisibilityLayerEnabled("inertia", false);
+  camera->Capture(image);
+  data = image.Data<unsigned char>();
+  EXPECT_GT(data[center], data[center + 2]);
+
+  // visuals that are only flagged as selectable are still rendered by
+  // cameras with every layer enabled
+  camera->SetVisibilityLayerEnabled("inertia", true);
+  box->SetVisibilityFlags(IGN_VISIBILITY_SELECTABLE);
+  camera->Capture(image);
+  data = image.Data<unsigned char>();
+  EXPECT_GT(data[center], data[center + 2]);
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+void CameraTest::VisibleVisuals(const std::string &_renderEngine)
+{
+  // create and populate scene
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+  VisualPtr root = scene->RootVisual();
+
+  CameraPtr camera = scene->CreateCamera();
+  ASSERT_NE(nullptr, camera);
+  camera->SetImageWidth(320);
+  camera->SetImageHeight(240);
+  camera->SetAspectRatio(320.0 / 240.0);
+  camera->SetHFOV(IGN_PI / 2);
+  root->AddChild(camera);
+
+  // box in front of the camera, box behind it and box hidden behind the
+  // first one
+  VisualPtr front = scene->CreateVisual();
+  front->AddGeometry(scene->CreateBox());
+  front->SetLocalPosition(5, 0, 0);
+  root->AddChild(front);
+
+  VisualPtr back = scene->CreateVisual();
+  back->AddGeometry(scene->CreateBox());
+  back->SetLocalPosition(-5, 0, 0);
+  root->AddChild(back);
+
+  VisualPtr hidden = scene->CreateVisual();
+  hidden->AddGeometry(scene->CreateBox());
+  hidden->SetLocalPosition(10, 0, 0);
+  root->AddChild(hidden);
+
+  // child visuals are only reported in recursive queries
+  VisualPtr child = scene->CreateVisual();
+  child->AddGeometry(scene->CreateBox());
+  child->SetLocalPosition(0, 0, 1);
+  front->AddChild(child);
+
+  std::vector<VisibleVisual> visuals = camera->VisibleVisuals();
+  ASSERT_EQ(2u, visuals.size());
+  EXPECT_EQ(front->Id(), visuals[0].id);
+  EXPECT_EQ(hidden->Id(), visuals[1].id);
+  EXPECT_NEAR(4.5, visuals[0].distance, 1e-3);
+  EXPECT_NEAR(9.5, visuals[1].distance, 1e-3);
+  EXPECT_DOUBLE_EQ(1.0, visuals[1].visibleFraction);
+
+  // the front box is centered horizontally and its child extends its
+  // bounds upwards
+  EXPECT_NEAR(160.0,
+      (visuals[0].screenMin.X() + visuals[0].screenMax.X()) * 0.5, 1.0);
+  EXPECT_LT(visuals[0].screenMin.Y(), 120.0);
+  EXPECT_GT(visuals[0].screenMax.Y(), 120.0);
+  EXPECT_GT(visuals[0].screenArea, 0.0);
+  EXPECT_LT(visuals[1].screenArea, visuals[0].screenArea);
+
+  VisibleVisualsOptions options;
+  options.recursive = true;
+  visuals = camera->VisibleVisuals(options);
+  EXPECT_EQ(3u, visuals.size());
+
+  options.recursive = false;
+  options.occlusionSamples = 4u;
+  visuals = camera->VisibleVisuals(options);
+  ASSERT_EQ(1u, visuals.size());
+  EXPECT_EQ(front->Id(), visuals[0].id);
+  EXPECT_DOUBLE_EQ(1.0, visuals[0].visibleFraction);
+
+  options.occlusionSamples = 0u;
+  options.minScreenArea = 1e6;
+  EXPECT_TRUE(camera->VisibleVisuals(options).empty());
+
+  // visibility mask
+  front->SetVisibilityFlags(0x00000010u);
+  options.minScreenArea = 0.0;
+  options.visibilityMask = 0x00000010u;
+  visuals = camera->VisibleVisuals(options);
+  ASSERT_EQ(1u, visuals.size());
+  EXPECT_EQ(front->Id(), visuals[0].id);
+  camera->SetVisibilityMask(0x00000001u);
+  EXPECT_TRUE(camera->VisibleVisuals(options).empty());
+  camera->SetVisibilityMask(IGN_VISIBILITY_ALL);
+
+  // query multiple cameras at once
+  CameraPtr camera2 = scene->CreateCamera();
+  ASSERT_NE(nullptr, camera2);
+  camera2->SetImageWidth(320);
+  camera2->SetImageHeight(240);
+  camera2->SetAspectRatio(320.0 / 240.0);
+  camera2->SetHFOV(IGN_PI / 2);
+  camera2->SetLocalRotation(0, 0, IGN_PI);
+  root->AddChild(camera2);
+
+  VisibilityIndex index;
+  index.Update(scene);
+  EXPECT_EQ(4u, index.VisualCount());
+  std::vector<std::vector<VisibleVisual>> results =
+      index.Query({camera, camera2}, VisibleVisualsOptions());
+  ASSERT_EQ(2u, results.size());
+  EXPECT_EQ(2u, results[0].size());
+  ASSERT_EQ(1u, results[1].size());
+  EXPECT_EQ(back->Id(), results[1][0].id);
+
+  // the scene index follows visuals that move or are added and removed
+  EXPECT_EQ(4u, scene->UpdateVisibilityIndex().VisualCount());
+  hidden->SetLocalPosition(-10, 0, 0);
+  visuals = camera->VisibleVisuals();
+  ASSERT_EQ(1u, visuals.size());
+  EXPECT_EQ(front->Id(), visuals[0].id);
+  results = scene->UpdateVisibilityIndex().Query({camera2},
+      VisibleVisualsOptions());
+  ASSERT_EQ(1u, results.size());
+  EXPECT_EQ(2u, results[0].size());
+
+  VisualPtr added = scene->CreateVisual();
+  added->AddGeometry(scene->CreateBox());
+  added->SetLocalPosition(3, 0, 0);
+  root->AddChild(added);
+  visuals = camera->VisibleVisuals();
+  ASSERT_EQ(2u, visuals.size());
+  EXPECT_EQ(added->Id(), visuals[0].id);
+  EXPECT_EQ(5u, scene->UpdateVisibilityIndex().VisualCount());
+
+  front->RemoveChild(child);
+  EXPECT_EQ(4u, scene->UpdateVisibilityIndex().VisualCount());
+  scene->DestroyVisual(added);
+  visuals = camera->VisibleVisuals();
+  ASSERT_EQ(1u, visuals.size());
+  EXPECT_EQ(front->Id(), visuals[0].id);
+  EXPECT_EQ(3u, scene->UpdateVisibilityIndex().VisualCount());
+
   // Clean up
   engine->DestroyScene(scene);
   rendering::unloadEngine(engine->Name());
@@ -343,6 +621,18 @@ TEST_P(CameraTest, VisibilityMask)
   VisibilityMask(GetParam());
 }
 
+/////////////////////////////////////////////////
+TEST_P(CameraTest, VisibilityLayers)
+{
+  VisibilityLayers(GetParam());
+}
+
+/////////////////////////////////////////////////
+TEST_P(CameraTest, VisibleVisuals)
+{
+  VisibleVisuals(GetParam());
+}
+
 INSTANTIATE_TEST_CASE_P(Camera, CameraTest,
     RENDER_ENGINE_VALUES,
     ignition::rendering::PrintToStringParam());
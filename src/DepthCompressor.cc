@@ -0,0 +1,722 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <thread>
+
+#include <ignition/common/Console.hh>
+
+#include "ignition/rendering/DepthCamera.hh"
+#include "ignition/rendering/DepthCompressor.hh"
+#include "ignition/rendering/GpuRays.hh"
+
+/// \brief Identifies a compressed frame ("IRVL")
+static const uint32_t kMagic = 0x4c565249u;
+
+/// \brief Size of the compressed frame header: magic, width, height and
+/// quantization step
+static const size_t kHeaderSize = 16u;
+
+/// \brief Code of +inf, the most common invalid value, which RVL encodes as
+/// runs
+static const uint32_t kPositiveInf = 0u;
+
+/// \brief Code of NaN
+static const uint32_t kNaN = 1u;
+
+/// \brief Code of -inf
+static const uint32_t kNegativeInf = 2u;
+
+/// \brief Code of a range of 0, larger codes are multiples of the
+/// quantization step
+static const uint32_t kFirstValue = 3u;
+
+/// \brief Writes variable length values as 4 bit nibbles: 3 bits of data
+/// and a continuation bit
+struct NibbleWriter
+{
+  /// \brief Constructor
+  /// \param[in] _out Output buffer
+  explicit NibbleWriter(std::vector<unsigned char> &_out) : out(_out) {}
+
+  /// \brief Write a nibble
+  /// \param[in] _nibble Nibble, in the 4 low bits
+  void Put(unsigned char _nibble)
+  {
+    if (this->half)
+      this->out.push_back(this->current | _nibble);
+    else
+      this->current = static_cast<unsigned char>(_nibble << 4);
+    this->half = !this->half;
+  }
+
+  /// \brief Write a value
+  /// \param[in] _value Value
+  void Write(uint64_t _value)
+  {
+    do
+    {
+      unsigned char nibble = _value & 0x7u;
+      _value >>= 3;
+      if (_value)
+        nibble |= 0x8u;
+      this->Put(nibble);
+    } while (_value);
+  }
+
+  /// \brief Write the last incomplete byte
+  void Flush()
+  {
+    if (this->half)
+      this->out.push_back(this->current);
+    this->half = false;
+  }
+
+  /// \brief Output buffer
+  std::vector<unsigned char> &out;
+
+  /// \brief Byte being written
+  unsigned char current = 0u;
+
+  /// \brief True if the high nibble of the current byte is written
+  bool half = false;
+};
+
+/// \brief Reads values written by NibbleWriter
+struct NibbleReader
+{
+  /// \brief Read a value
+  /// \param[out] _value Value
+  /// \return False if the end of the data was reached
+  bool Read(uint64_t &_value)
+  {
+    _value = 0u;
+    unsigned int shift = 0u;
+    while (true)
+    {
+      if (this->data >= this->end || shift > 63u)
+        return false;
+      unsigned char nibble = this->half ? (*this->data & 0xFu) :
+          (*this->data >> 4);
+      if (this->half)
+        ++this->data;
+      this->half = !this->half;
+
+      _value |= static_cast<uint64_t>(nibble & 0x7u) << shift;
+      shift += 3u;
+      if (!(nibble & 0x8u))
+        return true;
+    }
+  }
+
+  /// \brief Next byte
+  const unsigned char *data = nullptr;
+
+  /// \brief End of the data
+  const unsigned char *end = nullptr;
+
+  /// \brief True if the high nibble of the next byte was read
+  bool half = false;
+};
+
+/// \brief Quantize a range
+/// \param[in] _value Range in meters
+/// \param[in] _inverseStep Inverse of the quantization step
+/// \return Code
+static uint32_t Quantize(float _value, double _inverseStep)
+{
+  if (std::isnan(_value))
+    return kNaN;
+  if (std::isinf(_value))
+    return _value > 0 ? kPositiveInf : kNegativeInf;
+  if (_value <= 0.0f)
+    return kFirstValue;
+
+  double code = _value * _inverseStep + 0.5 + kFirstValue;
+  if (code >= std::numeric_limits<uint32_t>::max())
+    return std::numeric_limits<uint32_t>::max();
+  return static_cast<uint32_t>(code);
+}
+
+/// \brief Convert a code back to a range
+/// \param[in] _code Code
+/// \param[in] _step Quantization step
+/// \return Range in meters
+static float Dequantize(uint32_t _code, float _step)
+{
+  switch (_code)
+  {
+    case kPositiveInf:
+      return std::numeric_limits<float>::infinity();
+    case kNaN:
+      return std::numeric_limits<float>::quiet_NaN();
+    case kNegativeInf:
+      return -std::numeric_limits<float>::infinity();
+    default:
+      return static_cast<float>((_code - kFirstValue) *
+          static_cast<double>(_step));
+  }
+}
+
+/// \brief A frame waiting to be compressed
+struct DepthJob
+{
+  /// \brief Ranges
+  std::vector<float> data;
+
+  /// \brief Frame width
+  unsigned int width = 0u;
+
+  /// \brief Frame height
+  unsigned int height = 0u;
+
+  /// \brief Quantization step
+  double step = 0.001;
+
+  /// \brief Frame number
+  uint64_t sequence = 0u;
+};
+
+/// \brief A compressed frame waiting to be delivered
+struct DepthResult
+{
+  /// \brief Compressed data
+  std::vector<unsigned char> data;
+
+  /// \brief Frame width
+  unsigned int width = 0u;
+
+  /// \brief Frame height
+  unsigned int height = 0u;
+};
+
+/// \brief Private data class for DepthCompressor
+class ignition::rendering::DepthCompressorPrivate
+{
+  /// \brief Compress queued frames until stopped
+  public: void Work();
+
+  /// \brief Deliver compressed frames that are next in order
+  public: void Deliver();
+
+  /// \brief Stop and join the worker threads once the frames being
+  /// copied are queued
+  /// \param[in] _close True to also reject new frames and wait for
+  /// callers of Compress to return, used on destruction
+  public: void StopWorkers(bool _close);
+
+  /// \brief Quantization step
+  public: double step = 0.001;
+
+  /// \brief Number of worker threads
+  public: unsigned int workerCount = 2u;
+
+  /// \brief Maximum number of queued frames
+  public: unsigned int queueSize = 4u;
+
+  /// \brief Worker threads, started with the first frame
+  public: std::vector<std::thread> workers;
+
+  /// \brief True while workers are asked to exit
+  public: bool stopping = false;
+
+  /// \brief True once the compressor is being destroyed
+  public: bool closed = false;
+
+  /// \brief Number of threads inside Compress
+  public: unsigned int callers = 0u;
+
+  /// \brief Frames waiting to be compressed
+  public: std::deque<DepthJob> queue;
+
+  /// \brief Buffers that can be reused for new frames
+  public: std::vector<std::vector<float>> freeBuffers;
+
+  /// \brief Compressed frames waiting for earlier frames to be delivered
+  public: std::map<uint64_t, DepthResult> pending;
+
+  /// \brief Number of queue slots reserved by frames being copied
+  public: unsigned int reserved = 0u;
+
+  /// \brief Number of frames being compressed
+  public: unsigned int busy = 0u;
+
+  /// \brief Number of the next queued frame
+  public: uint64_t nextSequence = 0u;
+
+  /// \brief Number of the next frame to deliver
+  public: uint64_t nextDelivery = 0u;
+
+  /// \brief Number of frames compressed
+  public: uint64_t frames = 0u;
+
+  /// \brief Size of the compressed float data
+  public: uint64_t rawBytes = 0u;
+
+  /// \brief Size of the compressed frames
+  public: uint64_t compressedBytes = 0u;
+
+  /// \brief Time spent compressing
+  public: double encodeSeconds = 0.0;
+
+  /// \brief Protects all members except the event
+  public: mutable std::mutex mutex;
+
+  /// \brief Keeps frames delivered in order
+  public: std::mutex deliverMutex;
+
+  /// \brief Signaled when a frame is queued or workers must exit
+  public: std::condition_variable frameQueued;
+
+  /// \brief Signaled when a queue slot becomes available
+  public: std::condition_variable slotFreed;
+
+  /// \brief Signaled when all queued frames have been delivered or a
+  /// reserved slot is released
+  public: std::condition_variable idle;
+
+  /// \brief Event fired for each compressed frame
+  public: common::EventT<void(const std::vector<unsigned char> &,
+      unsigned int, unsigned int, uint64_t)> compressedEvent;
+};
+
+using namespace ignition;
+using namespace rendering;
+
+//////////////////////////////////////////////////
+DepthCompressor::DepthCompressor()
+    : dataPtr(new DepthCompressorPrivate)
+{
+}
+
+//////////////////////////////////////////////////
+DepthCompressor::~DepthCompressor()
+{
+  this->dataPtr->StopWorkers(true);
+}
+
+//////////////////////////////////////////////////
+void DepthCompressor::SetQuantization(double _step)
+{
+  if (_step <= 0.0)
+  {
+    ignerr << "Quantization step must be positive" << std::endl;
+    return;
+  }
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->step = _step;
+}
+
+//////////////////////////////////////////////////
+double DepthCompressor::Quantization() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->step;
+}
+
+//////////////////////////////////////////////////
+void DepthCompressor::SetWorkerCount(unsigned int _count)
+{
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    this->dataPtr->workerCount = std::max(1u, _count);
+  }
+  // the new workers are started with the next frame
+  this->dataPtr->StopWorkers(false);
+}
+
+//////////////////////////////////////////////////
+unsigned int DepthCompressor::WorkerCount() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->workerCount;
+}
+
+//////////////////////////////////////////////////
+void DepthCompressor::SetQueueSize(unsigned int _size)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->queueSize = std::max(1u, _size);
+  this->dataPtr->slotFreed.notify_all();
+}
+
+//////////////////////////////////////////////////
+unsigned int DepthCompressor::QueueSize() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->queueSize;
+}
+
+//////////////////////////////////////////////////
+common::ConnectionPtr DepthCompressor::ConnectDepthCamera(
+    const DepthCameraPtr &_camera)
+{
+  if (!_camera)
+    return common::ConnectionPtr();
+
+  return _camera->ConnectNewDepthFrame(
+      [this](const float *_data, unsigned int _width, unsigned int _height,
+             unsigned int _channels, const std::string &)
+      {
+        this->Compress(_data, _width, _height, _channels);
+      });
+}
+
+//////////////////////////////////////////////////
+common::ConnectionPtr DepthCompressor::ConnectGpuRays(const GpuRaysPtr &_rays)
+{
+  if (!_rays)
+    return common::ConnectionPtr();
+
+  return _rays->ConnectNewGpuRaysFrame(
+      [this](const float *_data, unsigned int _width, unsigned int _height,
+             unsigned int _channels, const std::string &)
+      {
+        this->Compress(_data, _width, _height, _channels);
+      });
+}
+
+//////////////////////////////////////////////////
+void DepthCompressor::Compress(const float *_data, unsigned int _width,
+    unsigned int _height, unsigned int _channels)
+{
+  if (!_data || _channels == 0u)
+    return;
+
+  DepthJob job;
+  {
+    std::unique_lock<std::mutex> lock(this->dataPtr->mutex);
+    ++this->dataPtr->callers;
+
+    // back-pressure so that no frame is lost, frames arriving while the
+    // workers are restarted wait for them
+    this->dataPtr->slotFreed.wait(lock, [this]
+        {
+          return this->dataPtr->closed || (!this->dataPtr->stopping &&
+              this->dataPtr->queue.size() + this->dataPtr->reserved <
+              this->dataPtr->queueSize);
+        });
+    --this->dataPtr->callers;
+    if (this->dataPtr->closed)
+    {
+      this->dataPtr->idle.notify_all();
+      return;
+    }
+
+    if (this->dataPtr->workers.empty())
+    {
+      for (unsigned int i = 0; i < this->dataPtr->workerCount; ++i)
+      {
+        this->dataPtr->workers.push_back(
+            std::thread(&DepthCompressorPrivate::Work, this->dataPtr.get()));
+      }
+    }
+    ++this->dataPtr->reserved;
+
+    job.sequence = this->dataPtr->nextSequence++;
+    job.step = this->dataPtr->step;
+    if (!this->dataPtr->freeBuffers.empty())
+    {
+      job.data = std::move(this->dataPtr->freeBuffers.back());
+      this->dataPtr->freeBuffers.pop_back();
+    }
+  }
+
+  // copy the range channel outside of the lock
+  size_t count = static_cast<size_t>(_width) * _height;
+  job.data.resize(count);
+  job.width = _width;
+  job.height = _height;
+  if (_channels == 1u)
+  {
+    std::memcpy(job.data.data(), _data, count * sizeof(float));
+  }
+  else
+  {
+    for (size_t i = 0; i < count; ++i)
+      job.data[i] = _data[i * _channels];
+  }
+
+  // workers do not exit while a slot is reserved, so the frame is always
+  // picked up even if StopWorkers was called during the copy
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  --this->dataPtr->reserved;
+  // keep the queue sorted so workers pick up frames in order
+  auto it = this->dataPtr->queue.begin();
+  while (it != this->dataPtr->queue.end() && it->sequence < job.sequence)
+    ++it;
+  this->dataPtr->queue.insert(it, std::move(job));
+  this->dataPtr->frameQueued.notify_one();
+  this->dataPtr->idle.notify_all();
+}
+
+//////////////////////////////////////////////////
+void DepthCompressor::Flush()
+{
+  std::unique_lock<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->idle.wait(lock, [this]
+      {
+        return this->dataPtr->queue.empty() && this->dataPtr->busy == 0u &&
+            this->dataPtr->reserved == 0u;
+      });
+}
+
+//////////////////////////////////////////////////
+common::ConnectionPtr DepthCompressor::ConnectNewCompressedFrame(
+    CompressedFrameListener _listener)
+{
+  return this->dataPtr->compressedEvent.Connect(_listener);
+}
+
+//////////////////////////////////////////////////
+uint64_t DepthCompressor::FramesCompressed() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->frames;
+}
+
+//////////////////////////////////////////////////
+double DepthCompressor::CompressionRatio() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  if (this->dataPtr->compressedBytes == 0u)
+    return 0.0;
+  return static_cast<double>(this->dataPtr->rawBytes) /
+      this->dataPtr->compressedBytes;
+}
+
+//////////////////////////////////////////////////
+double DepthCompressor::Throughput() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  if (this->dataPtr->encodeSeconds <= 0.0)
+    return 0.0;
+  return this->dataPtr->rawBytes / (1024.0 * 1024.0) /
+      this->dataPtr->encodeSeconds;
+}
+
+//////////////////////////////////////////////////
+void DepthCompressorPrivate::Work()
+{
+  std::unique_lock<std::mutex> lock(this->mutex);
+  while (true)
+  {
+    this->frameQueued.wait(lock, [this]
+        {
+          return (this->stopping && this->reserved == 0u) ||
+              !this->queue.empty();
+        });
+    if (this->queue.empty())
+      return;
+
+    DepthJob job = std::move(this->queue.front());
+    this->queue.pop_front();
+    ++this->busy;
+    this->slotFreed.notify_one();
+    lock.unlock();
+
+    DepthResult result;
+    result.width = job.width;
+    result.height = job.height;
+    auto start = std::chrono::steady_clock::now();
+    DepthCompressor::Encode(job.data.data(), job.width, job.height, 1u,
+        job.step, result.data);
+    double seconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+
+    lock.lock();
+    ++this->frames;
+    this->rawBytes += job.data.size() * sizeof(float);
+    this->compressedBytes += result.data.size();
+    this->encodeSeconds += seconds;
+    this->freeBuffers.push_back(std::move(job.data));
+    this->pending[job.sequence] = std::move(result);
+    lock.unlock();
+
+    this->Deliver();
+
+    lock.lock();
+    --this->busy;
+    if (this->queue.empty() && this->busy == 0u && this->reserved == 0u)
+      this->idle.notify_all();
+  }
+}
+
+//////////////////////////////////////////////////
+void DepthCompressorPrivate::Deliver()
+{
+  std::lock_guard<std::mutex> deliverLock(this->deliverMutex);
+  while (true)
+  {
+    DepthResult result;
+    uint64_t sequence = 0u;
+    {
+      std::lock_guard<std::mutex> lock(this->mutex);
+      auto it = this->pending.find(this->nextDelivery);
+      if (it == this->pending.end())
+        return;
+      sequence = it->first;
+      result = std::move(it->second);
+      this->pending.erase(it);
+      ++this->nextDelivery;
+    }
+    this->compressedEvent(result.data, result.width, result.height,
+        sequence);
+  }
+}
+
+//////////////////////////////////////////////////
+void DepthCompressorPrivate::StopWorkers(bool _close)
+{
+  std::vector<std::thread> stopped;
+  {
+    std::unique_lock<std::mutex> lock(this->mutex);
+    this->stopping = true;
+    this->closed = this->closed || _close;
+    this->slotFreed.notify_all();
+
+    // frames being copied must be queued before the workers exit, and on
+    // destruction no caller may still be inside Compress
+    this->idle.wait(lock, [this]
+        {
+          return this->reserved == 0u &&
+              (!this->closed || this->callers == 0u);
+        });
+    this->frameQueued.notify_all();
+    stopped.swap(this->workers);
+  }
+
+  // workers compress the remaining frames before exiting
+  for (auto &worker : stopped)
+    worker.join();
+
+  std::lock_guard<std::mutex> lock(this->mutex);
+  this->stopping = false;
+  this->slotFreed.notify_all();
+}
+
+//////////////////////////////////////////////////
+void DepthCompressor::Encode(const float *_data, unsigned int _width,
+    unsigned int _height, unsigned int _channels, double _step,
+    std::vector<unsigned char> &_out)
+{
+  _out.clear();
+  _out.resize(kHeaderSize);
+  uint32_t header[3] = {kMagic, _width, _height};
+  float step = static_cast<float>(_step);
+  std::memcpy(_out.data(), header, sizeof(header));
+  std::memcpy(_out.data() + sizeof(header), &step, sizeof(step));
+  if (!_data || _channels == 0u || _step <= 0.0)
+    return;
+
+  // RVL: alternating runs of invalid and valid values, valid values are
+  // stored as zigzag encoded differences to the previous valid value
+  double inverseStep = 1.0 / step;
+  size_t count = static_cast<size_t>(_width) * _height;
+  _out.reserve(kHeaderSize + count);
+  NibbleWriter writer(_out);
+  uint32_t previous = kFirstValue;
+  thread_local std::vector<uint32_t> run;
+  size_t i = 0;
+  while (i < count)
+  {
+    size_t zeros = 0u;
+    for (; i < count; ++i)
+    {
+      if (Quantize(_data[i * _channels], inverseStep) != kPositiveInf)
+        break;
+      ++zeros;
+    }
+    writer.Write(zeros);
+
+    run.clear();
+    for (; i < count; ++i)
+    {
+      uint32_t code = Quantize(_data[i * _channels], inverseStep);
+      if (code == kPositiveInf)
+        break;
+      run.push_back(code);
+    }
+    writer.Write(run.size());
+
+    for (uint32_t code : run)
+    {
+      int64_t delta = static_cast<int64_t>(code) - previous;
+      writer.Write((static_cast<uint64_t>(delta) << 1) ^
+          static_cast<uint64_t>(delta >> 63));
+      previous = code;
+    }
+  }
+  writer.Flush();
+}
+
+//////////////////////////////////////////////////
+bool DepthCompressor::Decode(const unsigned char *_data, size_t _size,
+    std::vector<float> &_out, unsigned int &_width, unsigned int &_height)
+{
+  if (!_data || _size < kHeaderSize)
+    return false;
+
+  uint32_t header[3];
+  float step = 0.0f;
+  std::memcpy(header, _data, sizeof(header));
+  std::memcpy(&step, _data + sizeof(header), sizeof(step));
+  if (header[0] != kMagic)
+    return false;
+
+  _width = header[1];
+  _height = header[2];
+  size_t count = static_cast<size_t>(_width) * _height;
+  _out.resize(count);
+
+  NibbleReader reader;
+  reader.data = _data + kHeaderSize;
+  reader.end = _data + _size;
+  uint32_t previous = kFirstValue;
+  size_t i = 0;
+  while (i < count)
+  {
+    uint64_t zeros = 0u;
+    uint64_t values = 0u;
+    if (!reader.Read(zeros) || zeros > count - i)
+      return false;
+    for (uint64_t z = 0; z < zeros; ++z)
+      _out[i++] = std::numeric_limits<float>::infinity();
+
+    if (!reader.Read(values) || values > count - i)
+      return false;
+    for (uint64_t v = 0; v < values; ++v)
+    {
+      uint64_t zigzag = 0u;
+      if (!reader.Read(zigzag))
+        return false;
+      int64_t delta = static_cast<int64_t>(zigzag >> 1) ^
+          -static_cast<int64_t>(zigzag & 1u);
+      previous = static_cast<uint32_t>(previous + delta);
+      _out[i++] = Dequantize(previous, step);
+    }
+  }
+  return true;
+}
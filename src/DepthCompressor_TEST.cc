@@ -0,0 +1,228 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "test_config.h"  // NOLINT(build/include)
+
+#include "ignition/rendering/DepthCompressor.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+/////////////////////////////////////////////////
+/// \brief Create a depth frame: a slanted plane with a hole of +inf
+/// \param[in] _width Frame width
+/// \param[in] _height Frame height
+/// \param[in] _offset Distance added to the plane
+/// \return Depth values
+std::vector<float> CreateFrame(unsigned int _width, unsigned int _height,
+    float _offset)
+{
+  std::vector<float> frame(_width * _height);
+  for (unsigned int y = 0; y < _height; ++y)
+  {
+    for (unsigned int x = 0; x < _width; ++x)
+    {
+      float value = _offset + 1.0f + 0.01f * x + 0.003f * y;
+      if (x < _width / 4u)
+        value = std::numeric_limits<float>::infinity();
+      frame[y * _width + x] = value;
+    }
+  }
+  return frame;
+}
+
+/////////////////////////////////////////////////
+TEST(DepthCompressorTest, EncodeDecode)
+{
+  const float inf = std::numeric_limits<float>::infinity();
+  std::vector<float> frame = {inf, inf, 0.5f, 0.5004f, -inf,
+      std::numeric_limits<float>::quiet_NaN(), -1.0f, 0.0f, 1200.25f, inf,
+      3.0f, 2.9996f};
+
+  std::vector<unsigned char> compressed;
+  DepthCompressor::Encode(frame.data(), 4u, 3u, 1u, 0.001, compressed);
+
+  std::vector<float> decoded;
+  unsigned int width = 0u;
+  unsigned int height = 0u;
+  ASSERT_TRUE(DepthCompressor::Decode(compressed.data(), compressed.size(),
+      decoded, width, height));
+  EXPECT_EQ(4u, width);
+  EXPECT_EQ(3u, height);
+  ASSERT_EQ(frame.size(), decoded.size());
+
+  EXPECT_TRUE(std::isinf(decoded[0]) && decoded[0] > 0);
+  EXPECT_TRUE(std::isinf(decoded[1]) && decoded[1] > 0);
+  EXPECT_NEAR(0.5, decoded[2], 1e-5);
+  EXPECT_NEAR(0.5, decoded[3], 1e-5);
+  EXPECT_TRUE(std::isinf(decoded[4]) && decoded[4] < 0);
+  EXPECT_TRUE(std::isnan(decoded[5]));
+  // negative ranges are clamped to 0
+  EXPECT_FLOAT_EQ(0.0f, decoded[6]);
+  EXPECT_FLOAT_EQ(0.0f, decoded[7]);
+  EXPECT_NEAR(1200.25, decoded[8], 1e-3);
+  EXPECT_TRUE(std::isinf(decoded[9]) && decoded[9] > 0);
+  EXPECT_NEAR(3.0, decoded[10], 1e-5);
+  EXPECT_NEAR(3.0, decoded[11], 1e-5);
+
+  // smooth depth images compress well
+  std::vector<float> plane = CreateFrame(320u, 240u, 0.0f);
+  DepthCompressor::Encode(plane.data(), 320u, 240u, 1u, 0.001, compressed);
+  EXPECT_LT(compressed.size() * 4u, plane.size() * sizeof(float));
+  ASSERT_TRUE(DepthCompressor::Decode(compressed.data(), compressed.size(),
+      decoded, width, height));
+  ASSERT_EQ(plane.size(), decoded.size());
+  for (size_t i = 0; i < plane.size(); ++i)
+  {
+    if (std::isinf(plane[i]))
+      EXPECT_TRUE(std::isinf(decoded[i]));
+    else
+      EXPECT_NEAR(plane[i], decoded[i], 0.0005 + 1e-6);
+  }
+
+  // only the first channel is compressed
+  std::vector<float> rays = {1.0f, 0.5f, 0.0f, 2.0f, 0.5f, 0.0f};
+  DepthCompressor::Encode(rays.data(), 2u, 1u, 3u, 0.01, compressed);
+  ASSERT_TRUE(DepthCompressor::Decode(compressed.data(), compressed.size(),
+      decoded, width, height));
+  ASSERT_EQ(2u, decoded.size());
+  EXPECT_NEAR(1.0, decoded[0], 1e-5);
+  EXPECT_NEAR(2.0, decoded[1], 1e-5);
+
+  // invalid data
+  EXPECT_FALSE(DepthCompressor::Decode(nullptr, 0u, decoded, width,
+      height));
+  EXPECT_FALSE(DepthCompressor::Decode(compressed.data(), 8u, decoded,
+      width, height));
+  std::vector<unsigned char> truncated(compressed.begin(),
+      compressed.begin() + 16);
+  EXPECT_FALSE(DepthCompressor::Decode(truncated.data(), truncated.size(),
+      decoded, width, height));
+  compressed[0] ^= 0xFF;
+  EXPECT_FALSE(DepthCompressor::Decode(compressed.data(), compressed.size(),
+      decoded, width, height));
+}
+
+/////////////////////////////////////////////////
+TEST(DepthCompressorTest, Compress)
+{
+  DepthCompressor compressor;
+  EXPECT_DOUBLE_EQ(0.001, compressor.Quantization());
+  EXPECT_EQ(2u, compressor.WorkerCount());
+  EXPECT_EQ(4u, compressor.QueueSize());
+  EXPECT_EQ(0u, compressor.FramesCompressed());
+  EXPECT_DOUBLE_EQ(0.0, compressor.CompressionRatio());
+
+  compressor.SetQuantization(0.0);
+  EXPECT_DOUBLE_EQ(0.001, compressor.Quantization());
+  compressor.SetQuantization(0.005);
+  EXPECT_DOUBLE_EQ(0.005, compressor.Quantization());
+  compressor.SetWorkerCount(3u);
+  EXPECT_EQ(3u, compressor.WorkerCount());
+  compressor.SetQueueSize(2u);
+  EXPECT_EQ(2u, compressor.QueueSize());
+
+  std::mutex mutex;
+  std::vector<uint64_t> sequences;
+  std::vector<std::vector<unsigned char>> frames;
+  common::ConnectionPtr connection = compressor.ConnectNewCompressedFrame(
+      [&](const std::vector<unsigned char> &_data, unsigned int _width,
+          unsigned int _height, uint64_t _sequence)
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        EXPECT_EQ(160u, _width);
+        EXPECT_EQ(120u, _height);
+        sequences.push_back(_sequence);
+        frames.push_back(_data);
+      });
+
+  // frames are delivered in order even with several workers
+  const unsigned int frameCount = 12u;
+  for (unsigned int i = 0; i < frameCount; ++i)
+  {
+    std::vector<float> frame = CreateFrame(160u, 120u, i * 0.1f);
+    compressor.Compress(frame.data(), 160u, 120u);
+  }
+  compressor.Flush();
+
+  ASSERT_EQ(frameCount, sequences.size());
+  for (unsigned int i = 0; i < frameCount; ++i)
+  {
+    EXPECT_EQ(i, sequences[i]);
+    std::vector<float> decoded;
+    unsigned int width = 0u;
+    unsigned int height = 0u;
+    ASSERT_TRUE(DepthCompressor::Decode(frames[i].data(), frames[i].size(),
+        decoded, width, height));
+    EXPECT_NEAR(1.0 + 0.01 * 40 + i * 0.1, decoded[40], 0.0025 + 1e-5);
+  }
+  EXPECT_EQ(frameCount, compressor.FramesCompressed());
+  EXPECT_LT(1.0, compressor.CompressionRatio());
+  EXPECT_LT(0.0, compressor.Throughput());
+}
+
+/////////////////////////////////////////////////
+TEST(DepthCompressorTest, RestartWorkers)
+{
+  DepthCompressor compressor;
+  compressor.SetQueueSize(2u);
+
+  std::mutex mutex;
+  std::vector<uint64_t> sequences;
+  common::ConnectionPtr connection = compressor.ConnectNewCompressedFrame(
+      [&](const std::vector<unsigned char> &, unsigned int, unsigned int,
+          uint64_t _sequence)
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        sequences.push_back(_sequence);
+      });
+
+  // changing the worker count while frames are copied loses no frame and
+  // does not leave queued frames without a worker
+  const unsigned int frameCount = 40u;
+  std::thread producer([&]()
+      {
+        std::vector<float> frame = CreateFrame(320u, 240u, 0.0f);
+        for (unsigned int i = 0; i < frameCount; ++i)
+          compressor.Compress(frame.data(), 320u, 240u);
+      });
+  for (unsigned int i = 0; i < 10u; ++i)
+    compressor.SetWorkerCount(1u + i % 3u);
+  producer.join();
+  compressor.Flush();
+
+  std::lock_guard<std::mutex> lock(mutex);
+  ASSERT_EQ(frameCount, sequences.size());
+  for (unsigned int i = 0; i < frameCount; ++i)
+    EXPECT_EQ(i, sequences[i]);
+  EXPECT_EQ(frameCount, compressor.FramesCompressed());
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,651 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cctype>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+#include <ignition/common/Filesystem.hh>
+#include <ignition/common/Image.hh>
+
+#include "ignition/rendering/Camera.hh"
+#include "ignition/rendering/FrameRecorder.hh"
+
+/// \brief A frame waiting to be saved
+struct QueuedFrame
+{
+  /// \brief Pixel data
+  ignition::rendering::Image image;
+
+  /// \brief Frame number, used in the file name
+  uint64_t index = 0u;
+};
+
+/// \brief Private data class for FrameRecorder
+class ignition::rendering::FrameRecorderPrivate
+{
+  /// \brief Reserve a slot in the queue, applying the drop policy
+  /// \param[in] _lock Lock on the mutex
+  /// \return True if a slot was reserved
+  public: bool Reserve(std::unique_lock<std::mutex> &_lock);
+
+  /// \brief Copy a frame into a pooled buffer and queue it
+  /// \param[in] _width Width in pixels
+  /// \param[in] _height Height in pixels
+  /// \param[in] _format Pixel format
+  /// \param[in] _fill Function that writes the pixels into the buffer
+  /// \return True if the frame was queued
+  public: bool Enqueue(unsigned int _width, unsigned int _height,
+      PixelFormat _format, const std::function<void(Image &)> &_fill);
+
+  /// \brief Save queued frames until stopped
+  public: void Work();
+
+  /// \brief Number of worker threads
+  public: unsigned int workerCount = 2u;
+
+  /// \brief Maximum number of queued frames
+  public: unsigned int queueSize = 8u;
+
+  /// \brief What to do with frames when the queue is full
+  public: FrameDropPolicy policy = FDP_BLOCK;
+
+  /// \brief Output directory
+  public: std::string directory;
+
+  /// \brief File name prefix
+  public: std::string prefix;
+
+  /// \brief File extension
+  public: std::string extension;
+
+  /// \brief True between Start() and Stop()
+  public: bool recording = false;
+
+  /// \brief True while workers are asked to exit
+  public: bool stopping = false;
+
+  /// \brief Worker threads
+  public: std::vector<std::thread> workers;
+
+  /// \brief Frames waiting to be saved
+  public: std::deque<QueuedFrame> queue;
+
+  /// \brief Buffers that can be reused for new frames
+  public: std::vector<Image> freeImages;
+
+  /// \brief Number of queue slots reserved by frames being copied
+  public: unsigned int reserved = 0u;
+
+  /// \brief Number of frames being saved
+  public: unsigned int busy = 0u;
+
+  /// \brief Number of the next frame
+  public: uint64_t nextIndex = 0u;
+
+  /// \brief Number of frames saved since Start()
+  public: uint64_t saved = 0u;
+
+  /// \brief Number of frames dropped since Start()
+  public: uint64_t dropped = 0u;
+
+  /// \brief Time of the last call to Start()
+  public: std::chrono::steady_clock::time_point startTime;
+
+  /// \brief Time of the last call to Stop()
+  public: std::chrono::steady_clock::time_point stopTime;
+
+  /// \brief Protects all members
+  public: mutable std::mutex mutex;
+
+  /// \brief Signaled when a frame is queued or workers must exit
+  public: std::condition_variable frameQueued;
+
+  /// \brief Signaled when a queue slot becomes available
+  public: std::condition_variable slotFreed;
+
+  /// \brief Signaled when the queue becomes empty and no frame is being
+  /// saved
+  public: std::condition_variable idle;
+};
+
+using namespace ignition;
+using namespace rendering;
+
+//////////////////////////////////////////////////
+FrameRecorder::FrameRecorder()
+    : dataPtr(new FrameRecorderPrivate)
+{
+}
+
+//////////////////////////////////////////////////
+FrameRecorder::~FrameRecorder()
+{
+  this->Stop();
+}
+
+//////////////////////////////////////////////////
+void FrameRecorder::SetWorkerCount(unsigned int _count)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->workerCount = std::max(1u, _count);
+}
+
+//////////////////////////////////////////////////
+unsigned int FrameRecorder::WorkerCount() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->workerCount;
+}
+
+//////////////////////////////////////////////////
+void FrameRecorder::SetQueueSize(unsigned int _size)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->queueSize = std::max(1u, _size);
+  this->dataPtr->slotFreed.notify_all();
+}
+
+//////////////////////////////////////////////////
+unsigned int FrameRecorder::QueueSize() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->queueSize;
+}
+
+//////////////////////////////////////////////////
+void FrameRecorder::SetDropPolicy(FrameDropPolicy _policy)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->policy = _policy;
+  this->dataPtr->slotFreed.notify_all();
+}
+
+//////////////////////////////////////////////////
+FrameDropPolicy FrameRecorder::DropPolicy() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->policy;
+}
+
+//////////////////////////////////////////////////
+bool FrameRecorder::Start(const std::string &_directory,
+    const std::string &_prefix, const std::string &_extension)
+{
+  this->Stop();
+
+  if (!common::isDirectory(_directory) &&
+      !common::createDirectories(_directory))
+  {
+    ignerr << "Unable to create frame directory [" << _directory << "]"
+           << std::endl;
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->directory = _directory;
+  this->dataPtr->prefix = _prefix;
+  this->dataPtr->extension = _extension;
+  this->dataPtr->nextIndex = 0u;
+  this->dataPtr->saved = 0u;
+  this->dataPtr->dropped = 0u;
+  this->dataPtr->startTime = std::chrono::steady_clock::now();
+  this->dataPtr->recording = true;
+  for (unsigned int i = 0; i < this->dataPtr->workerCount; ++i)
+  {
+    this->dataPtr->workers.push_back(
+        std::thread(&FrameRecorderPrivate::Work, this->dataPtr.get()));
+  }
+  return true;
+}
+
+//////////////////////////////////////////////////
+void FrameRecorder::Stop()
+{
+  {
+    std::unique_lock<std::mutex> lock(this->dataPtr->mutex);
+    if (!this->dataPtr->recording)
+      return;
+    this->dataPtr->recording = false;
+    this->dataPtr->stopping = true;
+    this->dataPtr->frameQueued.notify_all();
+    this->dataPtr->slotFreed.notify_all();
+
+    // frames still being copied are rejected by Enqueue, wait for them so
+    // none is queued after the workers exit
+    this->dataPtr->idle.wait(lock, [this]
+        {
+          return this->dataPtr->reserved == 0u;
+        });
+  }
+
+  // workers save the remaining frames before exiting
+  for (auto &worker : this->dataPtr->workers)
+    worker.join();
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->workers.clear();
+  this->dataPtr->freeImages.clear();
+  this->dataPtr->stopping = false;
+  this->dataPtr->stopTime = std::chrono::steady_clock::now();
+}
+
+//////////////////////////////////////////////////
+bool FrameRecorder::Recording() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->recording;
+}
+
+//////////////////////////////////////////////////
+bool FrameRecorder::AddFrame(const CameraPtr &_camera)
+{
+  if (!_camera)
+    return false;
+
+  return this->dataPtr->Enqueue(_camera->ImageWidth(),
+      _camera->ImageHeight(), _camera->ImageFormat(),
+      [&_camera](Image &_image)
+      {
+        _camera->Copy(_image);
+      });
+}
+
+//////////////////////////////////////////////////
+bool FrameRecorder::AddFrame(const Image &_image)
+{
+  return this->AddFrame(_image.Data(), _image.Width(), _image.Height(),
+      _image.Format());
+}
+
+//////////////////////////////////////////////////
+bool FrameRecorder::AddFrame(const void *_data, unsigned int _width,
+    unsigned int _height, PixelFormat _format)
+{
+  if (!_data)
+    return false;
+
+  return this->dataPtr->Enqueue(_width, _height, _format,
+      [_data](Image &_image)
+      {
+        std::memcpy(_image.Data(), _data, _image.MemorySize());
+      });
+}
+
+//////////////////////////////////////////////////
+void FrameRecorder::Flush()
+{
+  std::unique_lock<std::mutex> lock(this->dataPtr->mutex);
+
+  // nothing is saved without workers
+  if (this->dataPtr->workers.empty())
+    return;
+
+  this->dataPtr->idle.wait(lock, [this]
+      {
+        return this->dataPtr->queue.empty() && this->dataPtr->busy == 0u &&
+            this->dataPtr->reserved == 0u;
+      });
+}
+
+//////////////////////////////////////////////////
+unsigned int FrameRecorder::QueueDepth() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return static_cast<unsigned int>(this->dataPtr->queue.size());
+}
+
+//////////////////////////////////////////////////
+uint64_t FrameRecorder::FramesSaved() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->saved;
+}
+
+//////////////////////////////////////////////////
+uint64_t FrameRecorder::FramesDropped() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->dropped;
+}
+
+//////////////////////////////////////////////////
+double FrameRecorder::EncodeRate() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  auto end = this->dataPtr->recording ?
+      std::chrono::steady_clock::now() : this->dataPtr->stopTime;
+  double seconds = std::chrono::duration<double>(
+      end - this->dataPtr->startTime).count();
+  return seconds > 0.0 ? this->dataPtr->saved / seconds : 0.0;
+}
+
+//////////////////////////////////////////////////
+bool FrameRecorderPrivate::Reserve(std::unique_lock<std::mutex> &_lock)
+{
+  if (!this->recording)
+    return false;
+
+  auto full = [this]
+  {
+    return this->queue.size() + this->reserved >= this->queueSize;
+  };
+
+  while (full())
+  {
+    if (this->policy == FDP_DROP_NEWEST)
+    {
+      ++this->dropped;
+      return false;
+    }
+    else if (this->policy == FDP_DROP_OLDEST && !this->queue.empty())
+    {
+      this->freeImages.push_back(this->queue.front().image);
+      this->queue.pop_front();
+      ++this->dropped;
+    }
+    else
+    {
+      // back-pressure: wait for a worker to take a frame
+      this->slotFreed.wait(_lock);
+      if (!this->recording)
+        return false;
+    }
+  }
+
+  ++this->reserved;
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool FrameRecorderPrivate::Enqueue(unsigned int _width, unsigned int _height,
+    PixelFormat _format, const std::function<void(Image &)> &_fill)
+{
+  Image image;
+  {
+    std::unique_lock<std::mutex> lock(this->mutex);
+    if (!this->Reserve(lock))
+      return false;
+
+    // reuse a buffer of a previous frame if possible
+    auto it = std::find_if(this->freeImages.begin(), this->freeImages.end(),
+        [&](const Image &_free)
+        {
+          return _free.Width() == _width && _free.Height() == _height &&
+              _free.Format() == _format;
+        });
+    if (it != this->freeImages.end())
+    {
+      image = *it;
+      this->freeImages.erase(it);
+    }
+  }
+
+  // copy outside of the lock so workers are not blocked
+  if (!image.Data())
+    image = Image(_width, _height, _format);
+  _fill(image);
+
+  std::lock_guard<std::mutex> lock(this->mutex);
+  --this->reserved;
+
+  // the recorder was stopped while the frame was copied
+  if (this->stopping || !this->recording)
+  {
+    ++this->dropped;
+    this->idle.notify_all();
+    return false;
+  }
+
+  QueuedFrame frame;
+  frame.image = image;
+  frame.index = this->nextIndex++;
+  this->queue.push_back(frame);
+  this->frameQueued.notify_one();
+  return true;
+}
+
+//////////////////////////////////////////////////
+void FrameRecorderPrivate::Work()
+{
+  std::unique_lock<std::mutex> lock(this->mutex);
+  while (true)
+  {
+    this->frameQueued.wait(lock, [this]
+        {
+          return this->stopping || !this->queue.empty();
+        });
+    if (this->queue.empty())
+      return;
+
+    QueuedFrame frame = this->queue.front();
+    this->queue.pop_front();
+    ++this->busy;
+    this->slotFreed.notify_one();
+
+    char number[32];
+    std::snprintf(number, sizeof(number), "%06llu",
+        static_cast<unsigned long long>(frame.index));
+    std::string filename = common::joinPaths(this->directory,
+        this->prefix + "_" + number + "." + this->extension);
+
+    lock.unlock();
+    bool result = FrameRecorder::SaveImage(frame.image, filename);
+    lock.lock();
+
+    --this->busy;
+    if (result)
+      ++this->saved;
+    else
+      ++this->dropped;
+    this->freeImages.push_back(frame.image);
+    if (this->queue.empty() && this->busy == 0u)
+      this->idle.notify_all();
+  }
+}
+
+//////////////////////////////////////////////////
+bool FrameRecorder::SaveImage(const Image &_image,
+    const std::string &_filename)
+{
+  const unsigned char *data = _image.Data<unsigned char>();
+  if (!data)
+  {
+    ignerr << "Unable to save empty image to [" << _filename << "]"
+           << std::endl;
+    return false;
+  }
+
+  std::string extension;
+  size_t dot = _filename.rfind('.');
+  if (dot != std::string::npos)
+    extension = _filename.substr(dot + 1);
+  std::transform(extension.begin(), extension.end(), extension.begin(),
+      ::tolower);
+
+  unsigned int width = _image.Width();
+  unsigned int height = _image.Height();
+  PixelFormat format = _image.Format();
+  unsigned int channels = PixelUtil::ChannelCount(format);
+  bool isFloat = format == PF_FLOAT32_R || format == PF_FLOAT32_RGB ||
+      format == PF_FLOAT32_RGBA;
+
+  if (extension == "png")
+  {
+    common::Image::PixelFormatType type;
+    switch (format)
+    {
+      case PF_R8G8B8:
+        type = common::Image::RGB_INT8;
+        break;
+      case PF_B8G8R8:
+        type = common::Image::BGR_INT8;
+        break;
+      case PF_L16:
+        type = common::Image::L_INT16;
+        break;
+      case PF_L8:
+      case PF_BAYER_RGGB8:
+      case PF_BAYER_BGGR8:
+      case PF_BAYER_GBGR8:
+      case PF_BAYER_GRGB8:
+        type = common::Image::L_INT8;
+        break;
+      default:
+        ignerr << "Unable to save " << PixelUtil::Name(format)
+               << " image as png, use pfm for float images" << std::endl;
+        return false;
+    }
+    common::Image image;
+    image.SetFromData(data, width, height, type);
+    if (!image.Valid())
+    {
+      ignerr << "Unable to convert " << PixelUtil::Name(format)
+             << " image to save [" << _filename << "]" << std::endl;
+      return false;
+    }
+
+    // SavePNG does not report errors, check that the file was written
+    if (common::exists(_filename))
+      common::removeFile(_filename);
+    image.SavePNG(_filename);
+    if (!common::isFile(_filename))
+    {
+      ignerr << "Unable to write [" << _filename << "]" << std::endl;
+      return false;
+    }
+    return true;
+  }
+
+  std::ofstream file(_filename, std::ios::out | std::ios::binary);
+  if (!file)
+  {
+    ignerr << "Unable to open [" << _filename << "] for writing"
+           << std::endl;
+    return false;
+  }
+
+  if (extension == "ppm" || extension == "pgm")
+  {
+    if (isFloat)
+    {
+      ignerr << "Unable to save " << PixelUtil::Name(format)
+             << " image as " << extension << ", use pfm for float images"
+             << std::endl;
+      return false;
+    }
+
+    // netpbm has gray and rgb images only
+    if (channels != 1u && channels != 3u)
+    {
+      ignerr << "Unable to save " << PixelUtil::Name(format)
+             << " image with " << channels << " channels as " << extension
+             << std::endl;
+      return false;
+    }
+
+    // binary netpbm, 16 bit values are big endian
+    bool color = channels == 3u;
+    unsigned int maxValue = format == PF_L16 ? 65535u : 255u;
+    file << (color ? "P6" : "P5") << "\n" << width << " " << height << "\n"
+         << maxValue << "\n";
+    if (format == PF_B8G8R8)
+    {
+      std::vector<unsigned char> row(width * 3u);
+      for (unsigned int y = 0; y < height; ++y)
+      {
+        const unsigned char *src = data + y * width * 3u;
+        for (unsigned int x = 0; x < width; ++x)
+        {
+          row[x * 3u] = src[x * 3u + 2u];
+          row[x * 3u + 1u] = src[x * 3u + 1u];
+          row[x * 3u + 2u] = src[x * 3u];
+        }
+        file.write(reinterpret_cast<const char *>(row.data()), row.size());
+      }
+    }
+    else if (format == PF_L16)
+    {
+      const uint16_t *src = static_cast<const uint16_t *>(_image.Data());
+      std::vector<unsigned char> row(width * 2u);
+      for (unsigned int y = 0; y < height; ++y)
+      {
+        for (unsigned int x = 0; x < width; ++x)
+        {
+          uint16_t value = src[y * width + x];
+          row[x * 2u] = static_cast<unsigned char>(value >> 8);
+          row[x * 2u + 1u] = static_cast<unsigned char>(value & 0xFF);
+        }
+        file.write(reinterpret_cast<const char *>(row.data()), row.size());
+      }
+    }
+    else
+    {
+      file.write(reinterpret_cast<const char *>(data),
+          static_cast<std::streamsize>(width) * height * channels);
+    }
+  }
+  else if (extension == "pfm")
+  {
+    if (!isFloat)
+    {
+      ignerr << "Unable to save " << PixelUtil::Name(format)
+             << " image as pfm" << std::endl;
+      return false;
+    }
+
+    // portable float map: rows from bottom to top, a negative scale
+    // means little endian values
+    const uint16_t one = 1u;
+    bool littleEndian = *reinterpret_cast<const unsigned char *>(&one) == 1u;
+    bool color = channels >= 3u;
+    file << (color ? "PF" : "Pf") << "\n" << width << " " << height << "\n"
+         << (littleEndian ? "-1.0" : "1.0") << "\n";
+    const float *src = static_cast<const float *>(_image.Data());
+    unsigned int outChannels = color ? 3u : 1u;
+    std::vector<float> row(width * outChannels);
+    for (unsigned int y = height; y > 0; --y)
+    {
+      const float *srcRow = src + (y - 1u) * width * channels;
+      for (unsigned int x = 0; x < width; ++x)
+      {
+        for (unsigned int c = 0; c < outChannels; ++c)
+          row[x * outChannels + c] = srcRow[x * channels + c];
+      }
+      file.write(reinterpret_cast<const char *>(row.data()),
+          row.size() * sizeof(float));
+    }
+  }
+  else
+  {
+    ignerr << "Unsupported image format [" << extension << "] for ["
+           << _filename << "]" << std::endl;
+    return false;
+  }
+
+  return static_cast<bool>(file);
+}
@@ -0,0 +1,202 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <string>
+
+#include <ignition/common/Filesystem.hh>
+
+#include "test_config.h"  // NOLINT(build/include)
+
+#include "ignition/rendering/FrameRecorder.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+/////////////////////////////////////////////////
+/// \brief Read the netpbm header of a file
+/// \param[in] _filename File to read
+/// \param[out] _magic Magic number
+/// \param[out] _width Image width
+/// \param[out] _height Image height
+void ReadHeader(const std::string &_filename, std::string &_magic,
+    unsigned int &_width, unsigned int &_height)
+{
+  std::ifstream file(_filename, std::ios::binary);
+  file >> _magic >> _width >> _height;
+}
+
+/////////////////////////////////////////////////
+TEST(FrameRecorderTest, Properties)
+{
+  FrameRecorder recorder;
+  EXPECT_EQ(2u, recorder.WorkerCount());
+  EXPECT_EQ(8u, recorder.QueueSize());
+  EXPECT_EQ(FDP_BLOCK, recorder.DropPolicy());
+  EXPECT_FALSE(recorder.Recording());
+  EXPECT_EQ(0u, recorder.QueueDepth());
+  EXPECT_EQ(0u, recorder.FramesSaved());
+  EXPECT_EQ(0u, recorder.FramesDropped());
+
+  recorder.SetWorkerCount(4u);
+  EXPECT_EQ(4u, recorder.WorkerCount());
+  recorder.SetWorkerCount(0u);
+  EXPECT_EQ(1u, recorder.WorkerCount());
+
+  recorder.SetQueueSize(16u);
+  EXPECT_EQ(16u, recorder.QueueSize());
+  recorder.SetQueueSize(0u);
+  EXPECT_EQ(1u, recorder.QueueSize());
+
+  recorder.SetDropPolicy(FDP_DROP_OLDEST);
+  EXPECT_EQ(FDP_DROP_OLDEST, recorder.DropPolicy());
+
+  // frames are ignored when not recording
+  Image image(4u, 4u, PF_L8);
+  EXPECT_FALSE(recorder.AddFrame(image));
+  EXPECT_FALSE(recorder.AddFrame(CameraPtr()));
+
+  // there is nothing to wait for without workers
+  recorder.Flush();
+}
+
+/////////////////////////////////////////////////
+TEST(FrameRecorderTest, SaveImage)
+{
+  std::string dir = common::joinPaths(PROJECT_BUILD_PATH,
+      "test_frame_recorder_save");
+  ASSERT_TRUE(common::createDirectories(dir));
+
+  std::string magic;
+  unsigned int width = 0u;
+  unsigned int height = 0u;
+
+  Image rgb(8u, 4u, PF_B8G8R8);
+  std::string filename = common::joinPaths(dir, "rgb.ppm");
+  EXPECT_TRUE(FrameRecorder::SaveImage(rgb, filename));
+  ReadHeader(filename, magic, width, height);
+  EXPECT_EQ("P6", magic);
+  EXPECT_EQ(8u, width);
+  EXPECT_EQ(4u, height);
+
+  Image gray(6u, 2u, PF_L16);
+  filename = common::joinPaths(dir, "gray.PGM");
+  EXPECT_TRUE(FrameRecorder::SaveImage(gray, filename));
+  ReadHeader(filename, magic, width, height);
+  EXPECT_EQ("P5", magic);
+  EXPECT_EQ(6u, width);
+  EXPECT_EQ(2u, height);
+
+  Image depth(3u, 5u, PF_FLOAT32_R);
+  filename = common::joinPaths(dir, "depth.pfm");
+  EXPECT_TRUE(FrameRecorder::SaveImage(depth, filename));
+  ReadHeader(filename, magic, width, height);
+  EXPECT_EQ("Pf", magic);
+  EXPECT_EQ(3u, width);
+  EXPECT_EQ(5u, height);
+
+  // float images can only be saved as pfm and 8 bit images can not
+  EXPECT_FALSE(FrameRecorder::SaveImage(depth,
+      common::joinPaths(dir, "depth.png")));
+  EXPECT_FALSE(FrameRecorder::SaveImage(depth,
+      common::joinPaths(dir, "depth.ppm")));
+  EXPECT_FALSE(FrameRecorder::SaveImage(rgb,
+      common::joinPaths(dir, "rgb.pfm")));
+  EXPECT_FALSE(FrameRecorder::SaveImage(rgb,
+      common::joinPaths(dir, "rgb.unknown")));
+  EXPECT_FALSE(FrameRecorder::SaveImage(Image(),
+      common::joinPaths(dir, "empty.ppm")));
+
+  // write errors are reported
+  EXPECT_FALSE(FrameRecorder::SaveImage(rgb,
+      common::joinPaths(dir, "missing", "rgb.png")));
+  EXPECT_FALSE(FrameRecorder::SaveImage(rgb,
+      common::joinPaths(dir, "missing", "rgb.ppm")));
+}
+
+/////////////////////////////////////////////////
+TEST(FrameRecorderTest, Record)
+{
+  std::string dir = common::joinPaths(PROJECT_BUILD_PATH,
+      "test_frame_recorder_record");
+
+  FrameRecorder recorder;
+  recorder.SetWorkerCount(3u);
+  recorder.SetQueueSize(4u);
+  ASSERT_TRUE(recorder.Start(dir, "frame", "ppm"));
+  EXPECT_TRUE(recorder.Recording());
+
+  // the blocking policy does not lose frames
+  const unsigned int frameCount = 20u;
+  Image image(16u, 16u, PF_R8G8B8);
+  for (unsigned int i = 0; i < frameCount; ++i)
+  {
+    unsigned char *data = image.Data<unsigned char>();
+    data[0] = static_cast<unsigned char>(i);
+    EXPECT_TRUE(recorder.AddFrame(image));
+  }
+  recorder.Flush();
+  EXPECT_EQ(0u, recorder.QueueDepth());
+  EXPECT_EQ(frameCount, recorder.FramesSaved());
+  EXPECT_EQ(0u, recorder.FramesDropped());
+  EXPECT_LT(0.0, recorder.EncodeRate());
+
+  recorder.Stop();
+  EXPECT_FALSE(recorder.Recording());
+  EXPECT_TRUE(common::exists(common::joinPaths(dir, "frame_000000.ppm")));
+  EXPECT_TRUE(common::exists(common::joinPaths(dir, "frame_000019.ppm")));
+  EXPECT_FALSE(recorder.AddFrame(image));
+  recorder.Flush();
+
+  // the frame data is copied when queued
+  std::ifstream file(common::joinPaths(dir, "frame_000007.ppm"),
+      std::ios::binary);
+  std::string magic;
+  unsigned int width = 0u;
+  unsigned int height = 0u;
+  unsigned int maxValue = 0u;
+  file >> magic >> width >> height >> maxValue;
+  file.get();
+  EXPECT_EQ(7, file.get());
+
+  // dropping frames never blocks, every frame is either saved or dropped
+  recorder.SetWorkerCount(1u);
+  recorder.SetQueueSize(1u);
+  recorder.SetDropPolicy(FDP_DROP_NEWEST);
+  ASSERT_TRUE(recorder.Start(dir, "dropped", "pgm"));
+  Image gray(64u, 64u, PF_L8);
+  for (unsigned int i = 0; i < frameCount; ++i)
+    recorder.AddFrame(gray.Data(), gray.Width(), gray.Height(), PF_L8);
+  recorder.Stop();
+  EXPECT_EQ(frameCount, recorder.FramesSaved() + recorder.FramesDropped());
+
+  recorder.SetDropPolicy(FDP_DROP_OLDEST);
+  ASSERT_TRUE(recorder.Start(dir, "oldest", "pgm"));
+  for (unsigned int i = 0; i < frameCount; ++i)
+    EXPECT_TRUE(recorder.AddFrame(gray));
+  recorder.Stop();
+  EXPECT_EQ(frameCount, recorder.FramesSaved() + recorder.FramesDropped());
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
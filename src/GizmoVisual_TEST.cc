@@ -61,9 +61,13 @@ void GizmoVisualTest::GizmoVisual(const std::string &_renderEngine)
   EXPECT_EQ(TransformMode::TM_NONE, gizmo->Mode());
   EXPECT_EQ(math::Vector3d::Zero, gizmo->ActiveAxis());
 
+  // visuals are only created for the modes that are used
+  EXPECT_EQ(0u, gizmo->ChildCount());
+
   // test setting mode
   gizmo->SetTransformMode(TransformMode::TM_ROTATION);
   EXPECT_EQ(TransformMode::TM_ROTATION, gizmo->Mode());
+  EXPECT_EQ(1u, gizmo->ChildCount());
 
   // test setting active axis
   gizmo->SetActiveAxis(math::Vector3d::UnitZ);
@@ -105,6 +109,7 @@ void GizmoVisualTest::GizmoVisual(const std::string &_renderEngine)
   VisualPtr zscale = gizmo->ChildByAxis(TransformAxis::TA_SCALE_Z);
   EXPECT_NE(nullptr, zscale);
   EXPECT_EQ(TransformAxis::TA_SCALE_Z, gizmo->AxisById(zscale->Id()));
+  EXPECT_EQ(3u, gizmo->ChildCount());
 
   // Clean up
   engine->DestroyScene(scene);
@@ -191,6 +196,16 @@ void GizmoVisualTest::Material(const std::string &_renderEngine)
   EXPECT_EQ(yMat, yMat4);
   EXPECT_EQ(zMat, zMat4);
 
+  // axis materials are shared by all gizmos in the scene
+  GizmoVisualPtr gizmo2 = scene->CreateGizmoVisual();
+  ASSERT_NE(nullptr, gizmo2);
+  EXPECT_EQ(xMat,
+      gizmo2->ChildByAxis(TransformAxis::TA_TRANSLATION_X)->Material());
+  EXPECT_EQ(yMat,
+      gizmo2->ChildByAxis(TransformAxis::TA_TRANSLATION_Y)->Material());
+  EXPECT_EQ(zMat,
+      gizmo2->ChildByAxis(TransformAxis::TA_TRANSLATION_Z)->Material());
+
   // Clean up
   engine->DestroyScene(scene);
   rendering::unloadEngine(engine->Name());
@@ -0,0 +1,677 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+#include <ignition/common/Mesh.hh>
+#include <ignition/common/SubMesh.hh>
+
+#include "ignition/rendering/Heightmap.hh"
+#include "ignition/rendering/Material.hh"
+#include "ignition/rendering/Mesh.hh"
+#include "ignition/rendering/Scene.hh"
+
+/// \brief Number of bisection steps used to refine a ray intersection
+static const unsigned int kBisectionSteps = 24u;
+
+/// \brief A chunk of the quadtree
+struct HeightmapNode
+{
+  /// \brief Level, 0 is the finest
+  unsigned int level = 0u;
+
+  /// \brief Distance between two vertices, in samples
+  unsigned int stride = 1u;
+
+  /// \brief First sample column
+  unsigned int x0 = 0u;
+
+  /// \brief First sample row
+  unsigned int y0 = 0u;
+
+  /// \brief Last sample column
+  unsigned int x1 = 0u;
+
+  /// \brief Last sample row
+  unsigned int y1 = 0u;
+
+  /// \brief Lowest sampled height, in the terrain frame
+  double minHeight = 0.0;
+
+  /// \brief Highest sampled height, in the terrain frame
+  double maxHeight = 0.0;
+
+  /// \brief Number of vertices of the chunk mesh, including skirts
+  unsigned int vertexCount = 0u;
+
+  /// \brief Visual of the chunk, null until the chunk is first drawn
+  ignition::rendering::VisualPtr visual;
+
+  /// \brief True if the chunk is drawn
+  bool visible = false;
+
+  /// \brief True once the children have been created
+  bool split = false;
+
+  /// \brief Children, null if outside of the samples
+  std::array<std::unique_ptr<HeightmapNode>, 4> children;
+};
+
+/// \brief Private data class for Heightmap
+class ignition::rendering::HeightmapPrivate
+{
+  /// \brief Create a node and compute its height range
+  /// \param[in] _level Level of the node
+  /// \param[in] _x0 First sample column
+  /// \param[in] _y0 First sample row
+  /// \return The node
+  public: std::unique_ptr<HeightmapNode> CreateNode(unsigned int _level,
+      unsigned int _x0, unsigned int _y0) const;
+
+  /// \brief Collect the nodes to draw for a view position
+  /// \param[in] _node Node to check
+  /// \param[in] _position View position in the terrain frame
+  public: void Select(HeightmapNode &_node, const math::Vector3d &_position);
+
+  /// \brief Build the mesh and visual of a node
+  /// \param[in] _node Node to load
+  public: void Load(HeightmapNode &_node);
+
+  /// \brief Draw the selected nodes and hide the others
+  public: void Show();
+
+  /// \brief Get the sample indices of a node along one axis
+  /// \param[in] _first First sample
+  /// \param[in] _last Last sample
+  /// \param[in] _stride Distance between samples
+  /// \return Sample indices, always including _last
+  public: static std::vector<unsigned int> Samples(unsigned int _first,
+      unsigned int _last, unsigned int _stride);
+
+  /// \brief Get the interpolated height at a position
+  /// \param[in] _x X position in the terrain frame
+  /// \param[in] _y Y position in the terrain frame
+  /// \return Height in the terrain frame
+  public: double Height(double _x, double _y) const;
+
+  /// \brief Heightmap description
+  public: HeightmapDescriptor desc;
+
+  /// \brief Root visual of the terrain
+  public: VisualPtr visual;
+
+  /// \brief Camera used to select the levels
+  public: CameraPtr camera;
+
+  /// \brief True if the material was created by the heightmap
+  public: bool ownMaterial = false;
+
+  /// \brief Root of the quadtree
+  public: std::unique_ptr<HeightmapNode> root;
+
+  /// \brief Nodes drawn after the last update
+  public: std::vector<HeightmapNode *> visible;
+
+  /// \brief Nodes selected during an update
+  public: std::vector<HeightmapNode *> selected;
+
+  /// \brief Number of levels
+  public: unsigned int levelCount = 0u;
+
+  /// \brief Number of nodes whose mesh has been built
+  public: unsigned int loadedCount = 0u;
+
+  /// \brief Distance between two sample columns
+  public: double cellX = 1.0;
+
+  /// \brief Distance between two sample rows
+  public: double cellY = 1.0;
+};
+
+using namespace ignition;
+using namespace rendering;
+
+//////////////////////////////////////////////////
+std::vector<unsigned int> HeightmapPrivate::Samples(unsigned int _first,
+    unsigned int _last, unsigned int _stride)
+{
+  std::vector<unsigned int> samples;
+  for (unsigned int s = _first; s < _last; s += _stride)
+    samples.push_back(s);
+  samples.push_back(_last);
+  return samples;
+}
+
+//////////////////////////////////////////////////
+double HeightmapPrivate::Height(double _x, double _y) const
+{
+  double column = (_x + this->desc.size.X() * 0.5) / this->cellX;
+  double row = (this->desc.size.Y() * 0.5 - _y) / this->cellY;
+  return this->desc.data->Interpolate(column, row) * this->desc.size.Z();
+}
+
+//////////////////////////////////////////////////
+std::unique_ptr<HeightmapNode> HeightmapPrivate::CreateNode(
+    unsigned int _level, unsigned int _x0, unsigned int _y0) const
+{
+  const HeightmapData &data = *this->desc.data;
+  if (_x0 >= data.Width() - 1u || _y0 >= data.Height() - 1u)
+    return nullptr;
+
+  auto node = std::make_unique<HeightmapNode>();
+  node->level = _level;
+  node->stride = 1u << _level;
+  node->x0 = _x0;
+  node->y0 = _y0;
+  unsigned int span = (this->desc.chunkSize - 1u) * node->stride;
+  node->x1 = std::min(_x0 + span, data.Width() - 1u);
+  node->y1 = std::min(_y0 + span, data.Height() - 1u);
+
+  // height range of the samples the chunk is built from
+  node->minHeight = std::numeric_limits<double>::max();
+  node->maxHeight = std::numeric_limits<double>::lowest();
+  for (unsigned int y : Samples(node->y0, node->y1, node->stride))
+  {
+    for (unsigned int x : Samples(node->x0, node->x1, node->stride))
+    {
+      double height = data.Value(x, y) * this->desc.size.Z();
+      node->minHeight = std::min(node->minHeight, height);
+      node->maxHeight = std::max(node->maxHeight, height);
+    }
+  }
+  return node;
+}
+
+//////////////////////////////////////////////////
+void HeightmapPrivate::Select(HeightmapNode &_node,
+    const math::Vector3d &_position)
+{
+  double halfX = this->desc.size.X() * 0.5;
+  double halfY = this->desc.size.Y() * 0.5;
+  double minX = -halfX + _node.x0 * this->cellX;
+  double maxX = -halfX + _node.x1 * this->cellX;
+  double minY = halfY - _node.y1 * this->cellY;
+  double maxY = halfY - _node.y0 * this->cellY;
+
+  double dx = std::max({minX - _position.X(), 0.0, _position.X() - maxX});
+  double dy = std::max({minY - _position.Y(), 0.0, _position.Y() - maxY});
+  double dz = std::max({_node.minHeight - _position.Z(), 0.0,
+      _position.Z() - _node.maxHeight});
+  double distance = std::sqrt(dx * dx + dy * dy + dz * dz);
+  double size = (this->desc.chunkSize - 1u) * _node.stride *
+      std::max(this->cellX, this->cellY);
+
+  if (_node.level == 0u || distance >= size * this->desc.lodFactor)
+  {
+    this->selected.push_back(&_node);
+    return;
+  }
+
+  if (!_node.split)
+  {
+    unsigned int half = (this->desc.chunkSize - 1u) * _node.stride / 2u;
+    _node.children[0] = this->CreateNode(_node.level - 1u, _node.x0,
+        _node.y0);
+    _node.children[1] = this->CreateNode(_node.level - 1u, _node.x0 + half,
+        _node.y0);
+    _node.children[2] = this->CreateNode(_node.level - 1u, _node.x0,
+        _node.y0 + half);
+    _node.children[3] = this->CreateNode(_node.level - 1u, _node.x0 + half,
+        _node.y0 + half);
+    _node.split = true;
+  }
+
+  for (auto &child : _node.children)
+  {
+    if (child)
+      this->Select(*child, _position);
+  }
+}
+
+//////////////////////////////////////////////////
+void HeightmapPrivate::Load(HeightmapNode &_node)
+{
+  ScenePtr scene = this->visual->Scene();
+  if (!scene)
+    return;
+
+  const HeightmapData &data = *this->desc.data;
+  const double halfX = this->desc.size.X() * 0.5;
+  const double halfY = this->desc.size.Y() * 0.5;
+  const double sizeZ = this->desc.size.Z();
+  const unsigned int width = data.Width();
+  const unsigned int height = data.Height();
+  const unsigned int stride = _node.stride;
+
+  std::vector<unsigned int> columns = Samples(_node.x0, _node.x1, stride);
+  std::vector<unsigned int> rows = Samples(_node.y0, _node.y1, stride);
+  unsigned int columnCount = static_cast<unsigned int>(columns.size());
+  unsigned int rowCount = static_cast<unsigned int>(rows.size());
+
+  common::SubMesh subMesh;
+  subMesh.SetPrimitiveType(common::SubMesh::TRIANGLES);
+
+  auto addVertex = [&](unsigned int _x, unsigned int _y, double _z)
+  {
+    subMesh.AddVertex(-halfX + _x * this->cellX, halfY - _y * this->cellY,
+        _z);
+
+    // central differences at the chunk resolution, rows go towards -y
+    unsigned int left = _x >= stride ? _x - stride : 0u;
+    unsigned int right = std::min(_x + stride, width - 1u);
+    unsigned int up = _y >= stride ? _y - stride : 0u;
+    unsigned int down = std::min(_y + stride, height - 1u);
+    double dzdx = (data.Value(right, _y) - data.Value(left, _y)) * sizeZ /
+        ((right - left) * this->cellX);
+    double dzdy = (data.Value(_x, up) - data.Value(_x, down)) * sizeZ /
+        ((down - up) * this->cellY);
+    subMesh.AddNormal(math::Vector3d(-dzdx, -dzdy, 1.0).Normalize());
+
+    subMesh.AddTexCoord(static_cast<double>(_x) / (width - 1u),
+        static_cast<double>(_y) / (height - 1u));
+  };
+
+  // surface, two counter clockwise triangles per cell seen from above
+  for (unsigned int y : rows)
+  {
+    for (unsigned int x : columns)
+      addVertex(x, y, data.Value(x, y) * sizeZ);
+  }
+  for (unsigned int j = 0; j + 1u < rowCount; ++j)
+  {
+    for (unsigned int i = 0; i + 1u < columnCount; ++i)
+    {
+      unsigned int a = j * columnCount + i;
+      unsigned int b = a + 1u;
+      unsigned int c = a + columnCount;
+      unsigned int d = c + 1u;
+      subMesh.AddIndex(c);
+      subMesh.AddIndex(d);
+      subMesh.AddIndex(b);
+      subMesh.AddIndex(c);
+      subMesh.AddIndex(b);
+      subMesh.AddIndex(a);
+    }
+  }
+
+  // skirts hide the gaps along edges shared with chunks of another level.
+  // The gap is at most the height change over one stride, so the skirts
+  // reach a stride length below the lowest point of the chunk, which
+  // covers slopes up to 45 degrees between coarse samples.
+  double skirtHeight = _node.minHeight -
+      stride * std::max(this->cellX, this->cellY);
+  auto addSkirt = [&](const std::vector<std::array<unsigned int, 2>> &_edge)
+  {
+    unsigned int first = subMesh.VertexCount();
+    for (const auto &sample : _edge)
+    {
+      addVertex(sample[0], sample[1],
+          data.Value(sample[0], sample[1]) * sizeZ);
+      addVertex(sample[0], sample[1], skirtHeight);
+    }
+    for (unsigned int k = 0; k + 1u < _edge.size(); ++k)
+    {
+      unsigned int top = first + k * 2u;
+      unsigned int bottom = top + 1u;
+      subMesh.AddIndex(top);
+      subMesh.AddIndex(bottom);
+      subMesh.AddIndex(bottom + 2u);
+      subMesh.AddIndex(top);
+      subMesh.AddIndex(bottom + 2u);
+      subMesh.AddIndex(top + 2u);
+    }
+  };
+
+  // edges are walked counter clockwise seen from above so that the skirts
+  // face outwards
+  std::vector<std::array<unsigned int, 2>> edge;
+  for (unsigned int i = 0; i < columnCount; ++i)
+    edge.push_back({columns[i], rows.back()});
+  addSkirt(edge);
+  edge.clear();
+  for (unsigned int j = rowCount; j > 0u; --j)
+    edge.push_back({columns.back(), rows[j - 1u]});
+  addSkirt(edge);
+  edge.clear();
+  for (unsigned int i = columnCount; i > 0u; --i)
+    edge.push_back({columns[i - 1u], rows.front()});
+  addSkirt(edge);
+  edge.clear();
+  for (unsigned int j = 0; j < rowCount; ++j)
+    edge.push_back({columns.front(), rows[j]});
+  addSkirt(edge);
+
+  // mesh names must be unique, render engines cache meshes by name
+  std::string name = this->visual->Name() + "::" +
+      std::to_string(_node.level) + "_" + std::to_string(_node.x0) + "_" +
+      std::to_string(_node.y0);
+  common::Mesh mesh;
+  mesh.SetName(name);
+  mesh.AddSubMesh(subMesh);
+
+  MeshPtr chunk = scene->CreateMesh(&mesh);
+  if (!chunk)
+  {
+    ignerr << "Unable to create heightmap chunk [" << name << "]"
+           << std::endl;
+    return;
+  }
+
+  _node.vertexCount = subMesh.VertexCount();
+  _node.visual = scene->CreateVisual();
+  _node.visual->AddGeometry(chunk);
+  _node.visual->SetMaterial(this->desc.material, false);
+  _node.visual->SetVisible(false);
+  this->visual->AddChild(_node.visual);
+  ++this->loadedCount;
+}
+
+//////////////////////////////////////////////////
+void HeightmapPrivate::Show()
+{
+  for (auto node : this->visible)
+    node->visible = false;
+  for (auto node : this->selected)
+  {
+    if (!node->visual)
+      this->Load(*node);
+    node->visible = true;
+    if (node->visual)
+      node->visual->SetVisible(true);
+  }
+  for (auto node : this->visible)
+  {
+    if (!node->visible && node->visual)
+      node->visual->SetVisible(false);
+  }
+  std::swap(this->visible, this->selected);
+}
+
+//////////////////////////////////////////////////
+Heightmap::Heightmap(const ScenePtr &_scene,
+    const HeightmapDescriptor &_desc)
+    : dataPtr(new HeightmapPrivate)
+{
+  this->dataPtr->desc = _desc;
+  if (!_scene)
+  {
+    ignerr << "Unable to create heightmap without scene" << std::endl;
+    return;
+  }
+  this->dataPtr->visual = _scene->CreateVisual();
+
+  HeightmapDescriptor &desc = this->dataPtr->desc;
+  if (!desc.data || desc.data->Width() < 2u || desc.data->Height() < 2u)
+  {
+    ignerr << "Heightmap needs at least 2x2 samples" << std::endl;
+    return;
+  }
+  if (desc.chunkSize < 2u)
+  {
+    ignwarn << "Heightmap chunk size must be at least 2 vertices"
+            << std::endl;
+    desc.chunkSize = 2u;
+  }
+  if (desc.lodFactor <= 0.0)
+    desc.lodFactor = HeightmapDescriptor().lodFactor;
+
+  if (!desc.material)
+  {
+    desc.material = _scene->CreateMaterial();
+    desc.material->SetAmbient(0.3, 0.3, 0.3);
+    desc.material->SetDiffuse(0.7, 0.7, 0.7);
+    desc.material->SetSpecular(0.0, 0.0, 0.0);
+    this->dataPtr->ownMaterial = true;
+  }
+
+  unsigned int width = desc.data->Width();
+  unsigned int height = desc.data->Height();
+  this->dataPtr->cellX = desc.size.X() / (width - 1u);
+  this->dataPtr->cellY = desc.size.Y() / (height - 1u);
+
+  // smallest quadtree whose root covers all samples
+  unsigned int span = std::max(width, height) - 1u;
+  unsigned int levels = 1u;
+  while (static_cast<uint64_t>(desc.chunkSize - 1u) << (levels - 1u) < span)
+    ++levels;
+  this->dataPtr->levelCount = levels;
+  this->dataPtr->root = this->dataPtr->CreateNode(levels - 1u, 0u, 0u);
+}
+
+//////////////////////////////////////////////////
+Heightmap::~Heightmap()
+{
+  if (!this->dataPtr->visual)
+    return;
+
+  ScenePtr scene = this->dataPtr->visual->Scene();
+  if (!scene)
+    return;
+
+  // destroys the chunk visuals and meshes
+  scene->DestroyVisual(this->dataPtr->visual, true);
+  if (this->dataPtr->ownMaterial)
+    scene->DestroyMaterial(this->dataPtr->desc.material);
+}
+
+//////////////////////////////////////////////////
+const HeightmapDescriptor &Heightmap::Descriptor() const
+{
+  return this->dataPtr->desc;
+}
+
+//////////////////////////////////////////////////
+VisualPtr Heightmap::Visual() const
+{
+  return this->dataPtr->visual;
+}
+
+//////////////////////////////////////////////////
+void Heightmap::SetCamera(const CameraPtr &_camera)
+{
+  this->dataPtr->camera = _camera;
+}
+
+//////////////////////////////////////////////////
+CameraPtr Heightmap::Camera() const
+{
+  return this->dataPtr->camera;
+}
+
+//////////////////////////////////////////////////
+void Heightmap::SetLodFactor(double _factor)
+{
+  if (_factor > 0.0)
+    this->dataPtr->desc.lodFactor = _factor;
+}
+
+//////////////////////////////////////////////////
+double Heightmap::LodFactor() const
+{
+  return this->dataPtr->desc.lodFactor;
+}
+
+//////////////////////////////////////////////////
+void Heightmap::Update()
+{
+  if (this->dataPtr->camera)
+  {
+    this->Update(this->dataPtr->camera->WorldPosition());
+    return;
+  }
+
+  if (!this->dataPtr->root)
+    return;
+  this->dataPtr->selected.clear();
+  this->dataPtr->selected.push_back(this->dataPtr->root.get());
+  this->dataPtr->Show();
+}
+
+//////////////////////////////////////////////////
+void Heightmap::Update(const math::Vector3d &_position)
+{
+  if (!this->dataPtr->root)
+    return;
+
+  // view position in the terrain frame
+  math::Pose3d pose = this->dataPtr->visual->WorldPose();
+  math::Vector3d position = pose.Rot().Inverse() * (_position - pose.Pos()) /
+      this->dataPtr->visual->WorldScale();
+
+  this->dataPtr->selected.clear();
+  this->dataPtr->Select(*this->dataPtr->root, position);
+  this->dataPtr->Show();
+}
+
+//////////////////////////////////////////////////
+unsigned int Heightmap::LevelCount() const
+{
+  return this->dataPtr->levelCount;
+}
+
+//////////////////////////////////////////////////
+unsigned int Heightmap::VisibleChunkCount() const
+{
+  return static_cast<unsigned int>(this->dataPtr->visible.size());
+}
+
+//////////////////////////////////////////////////
+unsigned int Heightmap::LoadedChunkCount() const
+{
+  return this->dataPtr->loadedCount;
+}
+
+//////////////////////////////////////////////////
+uint64_t Heightmap::VisibleVertexCount() const
+{
+  uint64_t count = 0u;
+  for (auto node : this->dataPtr->visible)
+    count += node->vertexCount;
+  return count;
+}
+
+//////////////////////////////////////////////////
+double Heightmap::HeightAt(double _x, double _y) const
+{
+  if (!this->dataPtr->root)
+    return std::numeric_limits<double>::quiet_NaN();
+
+  math::Pose3d pose = this->dataPtr->visual->WorldPose();
+  math::Vector3d scale = this->dataPtr->visual->WorldScale();
+  math::Vector3d local = pose.Rot().Inverse() *
+      (math::Vector3d(_x, _y, pose.Pos().Z()) - pose.Pos()) / scale;
+
+  const math::Vector3d &size = this->dataPtr->desc.size;
+  if (std::abs(local.X()) > size.X() * 0.5 ||
+      std::abs(local.Y()) > size.Y() * 0.5)
+  {
+    return std::numeric_limits<double>::quiet_NaN();
+  }
+
+  local.Z(this->dataPtr->Height(local.X(), local.Y()));
+  return (pose.Pos() + pose.Rot() * (local * scale)).Z();
+}
+
+//////////////////////////////////////////////////
+bool Heightmap::Intersect(const math::Vector3d &_origin,
+    const math::Vector3d &_direction, double &_distance) const
+{
+  if (!this->dataPtr->root || _direction == math::Vector3d::Zero)
+    return false;
+
+  // ray in the terrain frame, parametrized by the world distance
+  math::Pose3d pose = this->dataPtr->visual->WorldPose();
+  math::Vector3d scale = this->dataPtr->visual->WorldScale();
+  math::Vector3d origin = pose.Rot().Inverse() * (_origin - pose.Pos()) /
+      scale;
+  math::Vector3d direction = pose.Rot().Inverse() *
+      _direction.Normalized() / scale;
+
+  // clip the ray to the bounds of the terrain
+  const math::Vector3d &size = this->dataPtr->desc.size;
+  math::Vector3d minBound(-size.X() * 0.5, -size.Y() * 0.5, 0.0);
+  math::Vector3d maxBound(size.X() * 0.5, size.Y() * 0.5, size.Z());
+  double enter = 0.0;
+  double exit = std::numeric_limits<double>::max();
+  for (unsigned int i = 0; i < 3u; ++i)
+  {
+    if (std::abs(direction[i]) < 1e-12)
+    {
+      if (origin[i] < minBound[i] || origin[i] > maxBound[i])
+        return false;
+      continue;
+    }
+    double t0 = (minBound[i] - origin[i]) / direction[i];
+    double t1 = (maxBound[i] - origin[i]) / direction[i];
+    enter = std::max(enter, std::min(t0, t1));
+    exit = std::min(exit, std::max(t0, t1));
+  }
+  if (enter > exit)
+    return false;
+
+  // distance above the surface along the ray
+  auto above = [&](double _t)
+  {
+    math::Vector3d p = origin + direction * _t;
+    return p.Z() - this->dataPtr->Height(p.X(), p.Y());
+  };
+
+  if (above(enter) <= 0.0)
+  {
+    _distance = enter;
+    return true;
+  }
+
+  // march half a cell at a time so that no sample is skipped, then refine
+  double horizontal = std::sqrt(direction.X() * direction.X() +
+      direction.Y() * direction.Y());
+  double step = exit - enter;
+  if (horizontal > 1e-12)
+  {
+    step = std::min(step, 0.5 * std::min(this->dataPtr->cellX,
+        this->dataPtr->cellY) / horizontal);
+  }
+
+  double previous = enter;
+  while (previous < exit)
+  {
+    double t = std::min(previous + step, exit);
+    if (above(t) <= 0.0)
+    {
+      for (unsigned int i = 0; i < kBisectionSteps; ++i)
+      {
+        double middle = (previous + t) * 0.5;
+        if (above(middle) <= 0.0)
+          t = middle;
+        else
+          previous = middle;
+      }
+      _distance = t;
+      return true;
+    }
+    previous = t;
+  }
+  return false;
+}
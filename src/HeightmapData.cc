@@ -0,0 +1,336 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef _WIN32
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+
+#include <ignition/common/Console.hh>
+
+#include "ignition/rendering/HeightmapData.hh"
+
+/// \brief Private data class for HeightmapData
+class ignition::rendering::HeightmapDataPrivate
+{
+  /// \brief Map or read a whole file
+  /// \param[in] _filename Path to the file
+  /// \return True on success
+  public: bool Open(const std::string &_filename);
+
+  /// \brief Number of samples per row
+  public: unsigned int width = 0u;
+
+  /// \brief Number of rows
+  public: unsigned int height = 0u;
+
+  /// \brief First sample
+  public: const unsigned char *samples = nullptr;
+
+  /// \brief Bytes per sample, 1 or 2
+  public: unsigned int bytes = 2u;
+
+  /// \brief True if 16 bit samples are big endian
+  public: bool bigEndian = false;
+
+  /// \brief Sample value that maps to 1
+  public: double maxValue = 65535.0;
+
+  /// \brief Start of the file mapping, null if not mapped
+  public: void *mapping = nullptr;
+
+  /// \brief Size of the file mapping or of the file buffer
+  public: size_t size = 0u;
+
+  /// \brief File content or samples when not memory mapped
+  public: std::vector<unsigned char> buffer;
+};
+
+using namespace ignition;
+using namespace rendering;
+
+//////////////////////////////////////////////////
+bool HeightmapDataPrivate::Open(const std::string &_filename)
+{
+#ifndef _WIN32
+  int fd = open(_filename.c_str(), O_RDONLY);
+  if (fd >= 0)
+  {
+    struct stat info;
+    if (fstat(fd, &info) == 0 && info.st_size > 0)
+    {
+      void *memory = mmap(nullptr, static_cast<size_t>(info.st_size),
+          PROT_READ, MAP_SHARED, fd, 0);
+      if (memory != MAP_FAILED)
+      {
+        // coarse levels only sample a few rows, so read ahead would load
+        // pages that are never used
+        madvise(memory, static_cast<size_t>(info.st_size), MADV_RANDOM);
+        this->mapping = memory;
+        this->size = static_cast<size_t>(info.st_size);
+      }
+    }
+    close(fd);
+    if (this->mapping)
+      return true;
+  }
+#endif
+
+  // fall back to reading the file
+  std::ifstream file(_filename, std::ios::binary);
+  if (!file)
+    return false;
+  this->buffer.assign(std::istreambuf_iterator<char>(file),
+      std::istreambuf_iterator<char>());
+  this->size = this->buffer.size();
+  return !this->buffer.empty();
+}
+
+//////////////////////////////////////////////////
+HeightmapData::HeightmapData()
+    : dataPtr(new HeightmapDataPrivate)
+{
+}
+
+//////////////////////////////////////////////////
+HeightmapData::~HeightmapData()
+{
+  this->Close();
+}
+
+//////////////////////////////////////////////////
+bool HeightmapData::Load(const std::string &_filename)
+{
+  this->Close();
+  if (!this->dataPtr->Open(_filename))
+  {
+    ignerr << "Unable to open heightmap [" << _filename << "]" << std::endl;
+    return false;
+  }
+
+  const unsigned char *data = this->dataPtr->mapping ?
+      static_cast<const unsigned char *>(this->dataPtr->mapping) :
+      this->dataPtr->buffer.data();
+  size_t size = this->dataPtr->size;
+
+  // binary pgm header: P5 <width> <height> <max value>, with comments
+  size_t pos = 2u;
+  auto readNumber = [&](unsigned long &_value)
+  {
+    while (pos < size)
+    {
+      if (data[pos] == '#')
+      {
+        while (pos < size && data[pos] != '\n')
+          ++pos;
+      }
+      else if (std::isspace(data[pos]))
+      {
+        ++pos;
+      }
+      else
+      {
+        break;
+      }
+    }
+    if (pos >= size || !std::isdigit(data[pos]))
+      return false;
+    _value = 0u;
+    while (pos < size && std::isdigit(data[pos]) && _value < 0xFFFFFFFFu)
+      _value = _value * 10u + (data[pos++] - '0');
+    return true;
+  };
+
+  unsigned long width = 0u;
+  unsigned long height = 0u;
+  unsigned long maxValue = 0u;
+  if (size < 2u || data[0] != 'P' || data[1] != '5' ||
+      !readNumber(width) || !readNumber(height) || !readNumber(maxValue) ||
+      pos >= size || width == 0u || height == 0u || maxValue == 0u ||
+      maxValue > 65535u)
+  {
+    ignerr << "Heightmap [" << _filename << "] is not a binary pgm image"
+           << std::endl;
+    this->Close();
+    return false;
+  }
+  // a single whitespace separates the header from the samples
+  ++pos;
+
+  unsigned int bytes = maxValue > 255u ? 2u : 1u;
+  if (size - pos < static_cast<uint64_t>(width) * height * bytes)
+  {
+    ignerr << "Heightmap [" << _filename << "] is truncated" << std::endl;
+    this->Close();
+    return false;
+  }
+
+  this->dataPtr->width = static_cast<unsigned int>(width);
+  this->dataPtr->height = static_cast<unsigned int>(height);
+  this->dataPtr->bytes = bytes;
+  this->dataPtr->bigEndian = true;
+  this->dataPtr->maxValue = static_cast<double>(maxValue);
+  this->dataPtr->samples = data + pos;
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool HeightmapData::LoadRaw(const std::string &_filename,
+    unsigned int _width, unsigned int _height)
+{
+  this->Close();
+  if (_width == 0u || _height == 0u)
+    return false;
+
+  if (!this->dataPtr->Open(_filename))
+  {
+    ignerr << "Unable to open heightmap [" << _filename << "]" << std::endl;
+    return false;
+  }
+
+  if (this->dataPtr->size < static_cast<uint64_t>(_width) * _height * 2u)
+  {
+    ignerr << "Heightmap [" << _filename << "] is smaller than "
+           << _width << "x" << _height << " 16 bit samples" << std::endl;
+    this->Close();
+    return false;
+  }
+
+  this->dataPtr->width = _width;
+  this->dataPtr->height = _height;
+  this->dataPtr->bytes = 2u;
+  this->dataPtr->bigEndian = false;
+  this->dataPtr->maxValue = 65535.0;
+  this->dataPtr->samples = this->dataPtr->mapping ?
+      static_cast<const unsigned char *>(this->dataPtr->mapping) :
+      this->dataPtr->buffer.data();
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool HeightmapData::SetData(const std::vector<uint16_t> &_samples,
+    unsigned int _width, unsigned int _height)
+{
+  this->Close();
+  if (_width == 0u || _height == 0u ||
+      _samples.size() != static_cast<size_t>(_width) * _height)
+  {
+    ignerr << "Heightmap sample count does not match its size" << std::endl;
+    return false;
+  }
+
+  this->dataPtr->buffer.resize(_samples.size() * 2u);
+  for (size_t i = 0; i < _samples.size(); ++i)
+  {
+    this->dataPtr->buffer[i * 2u] =
+        static_cast<unsigned char>(_samples[i] & 0xFFu);
+    this->dataPtr->buffer[i * 2u + 1u] =
+        static_cast<unsigned char>(_samples[i] >> 8);
+  }
+  this->dataPtr->size = this->dataPtr->buffer.size();
+  this->dataPtr->width = _width;
+  this->dataPtr->height = _height;
+  this->dataPtr->bytes = 2u;
+  this->dataPtr->bigEndian = false;
+  this->dataPtr->maxValue = 65535.0;
+  this->dataPtr->samples = this->dataPtr->buffer.data();
+  return true;
+}
+
+//////////////////////////////////////////////////
+void HeightmapData::Close()
+{
+#ifndef _WIN32
+  if (this->dataPtr->mapping)
+    munmap(this->dataPtr->mapping, this->dataPtr->size);
+#endif
+  this->dataPtr->mapping = nullptr;
+  this->dataPtr->size = 0u;
+  this->dataPtr->buffer.clear();
+  this->dataPtr->buffer.shrink_to_fit();
+  this->dataPtr->samples = nullptr;
+  this->dataPtr->width = 0u;
+  this->dataPtr->height = 0u;
+}
+
+//////////////////////////////////////////////////
+unsigned int HeightmapData::Width() const
+{
+  return this->dataPtr->width;
+}
+
+//////////////////////////////////////////////////
+unsigned int HeightmapData::Height() const
+{
+  return this->dataPtr->height;
+}
+
+//////////////////////////////////////////////////
+bool HeightmapData::MemoryMapped() const
+{
+  return this->dataPtr->mapping != nullptr;
+}
+
+//////////////////////////////////////////////////
+double HeightmapData::Value(unsigned int _x, unsigned int _y) const
+{
+  if (!this->dataPtr->samples)
+    return 0.0;
+
+  _x = std::min(_x, this->dataPtr->width - 1u);
+  _y = std::min(_y, this->dataPtr->height - 1u);
+  size_t index = static_cast<size_t>(_y) * this->dataPtr->width + _x;
+  const unsigned char *sample =
+      this->dataPtr->samples + index * this->dataPtr->bytes;
+
+  unsigned int value = sample[0];
+  if (this->dataPtr->bytes == 2u)
+  {
+    value = this->dataPtr->bigEndian ?
+        (static_cast<unsigned int>(sample[0]) << 8) | sample[1] :
+        (static_cast<unsigned int>(sample[1]) << 8) | sample[0];
+  }
+  return std::min(1.0, value / this->dataPtr->maxValue);
+}
+
+//////////////////////////////////////////////////
+double HeightmapData::Interpolate(double _x, double _y) const
+{
+  if (!this->dataPtr->samples)
+    return 0.0;
+
+  _x = std::max(0.0, std::min(_x, this->dataPtr->width - 1.0));
+  _y = std::max(0.0, std::min(_y, this->dataPtr->height - 1.0));
+  unsigned int x0 = static_cast<unsigned int>(std::floor(_x));
+  unsigned int y0 = static_cast<unsigned int>(std::floor(_y));
+  double fx = _x - x0;
+  double fy = _y - y0;
+
+  double top = this->Value(x0, y0) * (1.0 - fx) +
+      this->Value(x0 + 1u, y0) * fx;
+  double bottom = this->Value(x0, y0 + 1u) * (1.0 - fx) +
+      this->Value(x0 + 1u, y0 + 1u) * fx;
+  return top * (1.0 - fy) + bottom * fy;
+}
@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <ignition/common/Filesystem.hh>
+
+#include "test_config.h"  // NOLINT(build/include)
+
+#include "ignition/rendering/HeightmapData.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+/////////////////////////////////////////////////
+TEST(HeightmapDataTest, SetData)
+{
+  HeightmapData data;
+  EXPECT_EQ(0u, data.Width());
+  EXPECT_EQ(0u, data.Height());
+  EXPECT_DOUBLE_EQ(0.0, data.Value(0u, 0u));
+
+  // sample count must match the size
+  EXPECT_FALSE(data.SetData(std::vector<uint16_t>(5u), 2u, 3u));
+  EXPECT_FALSE(data.SetData(std::vector<uint16_t>(), 0u, 0u));
+
+  std::vector<uint16_t> samples = {0u, 65535u, 13107u,
+                                   26214u, 39321u, 52428u};
+  ASSERT_TRUE(data.SetData(samples, 3u, 2u));
+  EXPECT_EQ(3u, data.Width());
+  EXPECT_EQ(2u, data.Height());
+  EXPECT_FALSE(data.MemoryMapped());
+  EXPECT_DOUBLE_EQ(0.0, data.Value(0u, 0u));
+  EXPECT_DOUBLE_EQ(1.0, data.Value(1u, 0u));
+  EXPECT_NEAR(0.2, data.Value(2u, 0u), 1e-6);
+  EXPECT_NEAR(0.6, data.Value(1u, 1u), 1e-6);
+
+  // coordinates are clamped
+  EXPECT_NEAR(0.8, data.Value(10u, 10u), 1e-6);
+
+  // bilinear interpolation
+  EXPECT_NEAR(0.5, data.Interpolate(0.5, 0.0), 1e-6);
+  EXPECT_NEAR(0.2, data.Interpolate(0.0, 0.5), 1e-6);
+  EXPECT_NEAR((0.0 + 1.0 + 0.4 + 0.6) / 4.0, data.Interpolate(0.5, 0.5),
+      1e-6);
+  EXPECT_NEAR(0.8, data.Interpolate(5.0, 5.0), 1e-6);
+  EXPECT_NEAR(0.0, data.Interpolate(-1.0, -1.0), 1e-6);
+
+  data.Close();
+  EXPECT_EQ(0u, data.Width());
+  EXPECT_EQ(0u, data.Height());
+}
+
+/////////////////////////////////////////////////
+TEST(HeightmapDataTest, Load)
+{
+  std::string dir = common::joinPaths(PROJECT_BUILD_PATH,
+      "test_heightmap_data");
+  ASSERT_TRUE(common::createDirectories(dir));
+
+  // 16 bit pgm, samples are big endian
+  std::string pgm16 = common::joinPaths(dir, "terrain16.pgm");
+  {
+    std::ofstream file(pgm16, std::ios::binary);
+    file << "P5\n# terrain\n2 2\n1000\n";
+    const unsigned char samples[] = {0x00, 0x00, 0x03, 0xE8,
+                                     0x01, 0xF4, 0x00, 0xFA};
+    file.write(reinterpret_cast<const char *>(samples), sizeof(samples));
+  }
+
+  HeightmapData data;
+  ASSERT_TRUE(data.Load(pgm16));
+  EXPECT_EQ(2u, data.Width());
+  EXPECT_EQ(2u, data.Height());
+#ifndef _WIN32
+  EXPECT_TRUE(data.MemoryMapped());
+#endif
+  EXPECT_DOUBLE_EQ(0.0, data.Value(0u, 0u));
+  EXPECT_DOUBLE_EQ(1.0, data.Value(1u, 0u));
+  EXPECT_DOUBLE_EQ(0.5, data.Value(0u, 1u));
+  EXPECT_DOUBLE_EQ(0.25, data.Value(1u, 1u));
+
+  // 8 bit pgm
+  std::string pgm8 = common::joinPaths(dir, "terrain8.pgm");
+  {
+    std::ofstream file(pgm8, std::ios::binary);
+    file << "P5 3 1 255\n";
+    const unsigned char samples[] = {0u, 51u, 255u};
+    file.write(reinterpret_cast<const char *>(samples), sizeof(samples));
+  }
+  ASSERT_TRUE(data.Load(pgm8));
+  EXPECT_EQ(3u, data.Width());
+  EXPECT_EQ(1u, data.Height());
+  EXPECT_DOUBLE_EQ(0.2, data.Value(1u, 0u));
+  EXPECT_DOUBLE_EQ(1.0, data.Value(2u, 0u));
+
+  // raw 16 bit little endian
+  std::string raw = common::joinPaths(dir, "terrain.raw");
+  {
+    std::ofstream file(raw, std::ios::binary);
+    const unsigned char samples[] = {0xFF, 0xFF, 0x00, 0x00,
+                                     0x00, 0x80, 0xFF, 0x7F};
+    file.write(reinterpret_cast<const char *>(samples), sizeof(samples));
+  }
+  ASSERT_TRUE(data.LoadRaw(raw, 2u, 2u));
+  EXPECT_EQ(2u, data.Width());
+  EXPECT_EQ(2u, data.Height());
+  EXPECT_DOUBLE_EQ(1.0, data.Value(0u, 0u));
+  EXPECT_DOUBLE_EQ(0.0, data.Value(1u, 0u));
+  EXPECT_NEAR(0.5, data.Value(0u, 1u), 1e-4);
+  EXPECT_NEAR(0.5, data.Value(1u, 1u), 1e-4);
+
+  // invalid files
+  EXPECT_FALSE(data.LoadRaw(raw, 4u, 4u));
+  EXPECT_EQ(0u, data.Width());
+  EXPECT_FALSE(data.Load(raw));
+  EXPECT_FALSE(data.Load(common::joinPaths(dir, "missing.pgm")));
+
+  std::string truncated = common::joinPaths(dir, "truncated.pgm");
+  {
+    std::ofstream file(truncated, std::ios::binary);
+    file << "P5\n4 4\n65535\n";
+    file.write("abcd", 4);
+  }
+  EXPECT_FALSE(data.Load(truncated));
+  EXPECT_EQ(0u, data.Width());
+
+  common::removeAll(dir);
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,178 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+
+#include "test_config.h"  // NOLINT(build/include)
+
+#include "ignition/rendering/Camera.hh"
+#include "ignition/rendering/Heightmap.hh"
+#include "ignition/rendering/RenderEngine.hh"
+#include "ignition/rendering/RenderingIface.hh"
+#include "ignition/rendering/Scene.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+class HeightmapTest : public testing::Test,
+                      public testing::WithParamInterface<const char *>
+{
+  /// \brief Test chunk selection and height queries
+  public: void Terrain(const std::string &_renderEngine);
+};
+
+/////////////////////////////////////////////////
+void HeightmapTest::Terrain(const std::string &_renderEngine)
+{
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+
+  // 257x257 samples of a gentle sine terrain
+  const unsigned int size = 257u;
+  std::vector<uint16_t> samples(size * size);
+  for (unsigned int y = 0; y < size; ++y)
+  {
+    for (unsigned int x = 0; x < size; ++x)
+    {
+      samples[y * size + x] = static_cast<uint16_t>(65535.0 *
+          (0.5 + 0.4 * std::sin(x / 30.0) * std::cos(y / 40.0)));
+    }
+  }
+  auto data = std::make_shared<HeightmapData>();
+  ASSERT_TRUE(data->SetData(samples, size, size));
+
+  HeightmapDescriptor desc;
+  desc.data = data;
+  desc.size = math::Vector3d(256, 256, 20);
+  desc.chunkSize = 33u;
+
+  CameraPtr camera = scene->CreateCamera("camera");
+  ASSERT_NE(nullptr, camera);
+  scene->RootVisual()->AddChild(camera);
+
+  // the heightmap must be destroyed before the scene
+  {
+    HeightmapPtr heightmap = scene->CreateHeightmap(desc);
+    ASSERT_NE(nullptr, heightmap);
+    ASSERT_NE(nullptr, heightmap->Visual());
+    scene->RootVisual()->AddChild(heightmap->Visual());
+
+    // verify initial values
+    EXPECT_EQ(nullptr, heightmap->Camera());
+    EXPECT_EQ(4u, heightmap->LevelCount());
+    EXPECT_EQ(0u, heightmap->VisibleChunkCount());
+    EXPECT_EQ(0u, heightmap->LoadedChunkCount());
+    EXPECT_DOUBLE_EQ(2.0, heightmap->LodFactor());
+    heightmap->SetLodFactor(-1.0);
+    EXPECT_DOUBLE_EQ(2.0, heightmap->LodFactor());
+    heightmap->SetLodFactor(1.0);
+    EXPECT_DOUBLE_EQ(1.0, heightmap->LodFactor());
+
+    // without camera only the root chunk is drawn
+    heightmap->Update();
+    EXPECT_EQ(1u, heightmap->VisibleChunkCount());
+    EXPECT_EQ(1u, heightmap->LoadedChunkCount());
+    // 33x33 vertices and 4 skirts of 2x33 vertices
+    EXPECT_EQ(33u * 33u + 4u * 2u * 33u, heightmap->VisibleVertexCount());
+
+    // close to the terrain, finer chunks are drawn
+    heightmap->SetCamera(camera);
+    EXPECT_EQ(camera, heightmap->Camera());
+    camera->SetWorldPosition(0.0, 0.0, 15.0);
+    heightmap->Update();
+    unsigned int nearChunks = heightmap->VisibleChunkCount();
+    EXPECT_LT(1u, nearChunks);
+    EXPECT_LE(nearChunks, heightmap->LoadedChunkCount());
+
+    // far away, the root chunk is drawn again and nothing new is loaded
+    unsigned int loaded = heightmap->LoadedChunkCount();
+    camera->SetWorldPosition(0.0, 0.0, 5000.0);
+    heightmap->Update();
+    EXPECT_EQ(1u, heightmap->VisibleChunkCount());
+    EXPECT_EQ(loaded, heightmap->LoadedChunkCount());
+
+    // heights follow the pose of the visual
+    heightmap->Visual()->SetWorldPosition(100.0, 50.0, 3.0);
+    double expected = data->Interpolate(138.0, 148.0) * 20.0 + 3.0;
+    EXPECT_NEAR(expected, heightmap->HeightAt(110.0, 30.0), 1e-6);
+    EXPECT_TRUE(std::isnan(heightmap->HeightAt(500.0, 0.0)));
+
+    // ray intersection
+    double distance = 0.0;
+    EXPECT_TRUE(heightmap->Intersect(math::Vector3d(110.0, 30.0, 100.0),
+        -math::Vector3d::UnitZ, distance));
+    EXPECT_NEAR(100.0 - expected, distance, 1e-4);
+
+    math::Vector3d origin(50.0, 70.0, 40.0);
+    math::Vector3d direction = math::Vector3d(1.0, -0.5, -0.3).Normalize();
+    ASSERT_TRUE(heightmap->Intersect(origin, direction, distance));
+    math::Vector3d point = origin + direction * distance;
+    EXPECT_NEAR(heightmap->HeightAt(point.X(), point.Y()), point.Z(), 1e-3);
+
+    EXPECT_FALSE(heightmap->Intersect(origin, math::Vector3d::UnitZ,
+        distance));
+    EXPECT_FALSE(heightmap->Intersect(math::Vector3d(1000.0, 0.0, 10.0),
+        -math::Vector3d::UnitZ, distance));
+
+    // sensors that are not cameras select chunks with a position
+    heightmap->Update(math::Vector3d(110.0, 30.0, expected + 2.0));
+    EXPECT_LT(1u, heightmap->VisibleChunkCount());
+  }
+
+  // invalid data still creates a visual
+  {
+    HeightmapPtr heightmap = scene->CreateHeightmap(HeightmapDescriptor());
+    ASSERT_NE(nullptr, heightmap);
+    EXPECT_NE(nullptr, heightmap->Visual());
+    heightmap->Update();
+    EXPECT_EQ(0u, heightmap->VisibleChunkCount());
+    EXPECT_TRUE(std::isnan(heightmap->HeightAt(0.0, 0.0)));
+  }
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+TEST_P(HeightmapTest, Terrain)
+{
+  Terrain(GetParam());
+}
+
+INSTANTIATE_TEST_CASE_P(Heightmap, HeightmapTest,
+    RENDER_ENGINE_VALUES,
+    ignition::rendering::PrintToStringParam());
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,522 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+#include <ignition/common/Image.hh>
+#include <ignition/common/Uuid.hh>
+#include <ignition/math/Vector2.hh>
+
+#include "ignition/rendering/Image.hh"
+#include "ignition/rendering/ImpostorController.hh"
+#include "ignition/rendering/Marker.hh"
+#include "ignition/rendering/Material.hh"
+#include "ignition/rendering/Scene.hh"
+
+/// \brief Visibility flag used to render only the visual being captured.
+/// Visuals never carry the selection flag, it is only used in masks.
+static const uint32_t kImpostorCaptureFlags = IGN_VISIBILITY_SELECTION;
+
+/// \brief Background color of the capture camera, made transparent in the
+/// impostor textures
+static const unsigned char kKeyColor[3] = {255u, 0u, 255u};
+
+/// \brief Ratio between the switch back and switch to impostor thresholds,
+/// prevents visuals from flickering at the threshold distance
+static const double kHysteresis = 1.1;
+
+/// \brief Impostors of all the visuals added with the same key
+struct ImpostorAtlas
+{
+  /// \brief Material with the views side by side in a single texture. View
+  /// i is seen from the direction at yaw 2 * pi * i / viewCount in the
+  /// frame of the visual.
+  ignition::rendering::MaterialPtr material;
+
+  /// \brief Number of views in the texture
+  unsigned int viewCount = 0u;
+
+  /// \brief Width and height of the billboards
+  double size = 0.0;
+
+  /// \brief Billboard center in the frame of the visual, ignoring scale
+  ignition::math::Vector3d offset;
+
+  /// \brief Visual holding the billboard set
+  ignition::rendering::VisualPtr billboards;
+
+  /// \brief Triangles of the billboards of all the impostors, drawn in a
+  /// single call
+  ignition::rendering::MarkerPtr marker;
+
+  /// \brief Number of points in the marker
+  unsigned int pointCount = 0u;
+};
+
+/// \brief A visual managed by the controller
+struct ImpostorInstance
+{
+  /// \brief Managed visual
+  ignition::rendering::VisualPtr visual;
+
+  /// \brief Textures and billboard set of the impostor
+  std::shared_ptr<ImpostorAtlas> atlas;
+
+  /// \brief True if the billboard is shown instead of the visual
+  bool active = false;
+
+  /// \brief Visibility of the visual before it was replaced
+  bool visible = true;
+};
+
+/// \brief Private data class for ImpostorController
+class ignition::rendering::ImpostorControllerPrivate
+{
+  /// \brief Render the impostor textures of a visual
+  /// \param[in] _visual Visual to capture
+  /// \return New atlas, or null on failure
+  public: std::shared_ptr<ImpostorAtlas> Capture(const VisualPtr &_visual);
+
+  /// \brief Show a visual or its impostor
+  /// \param[in] _instance Managed visual
+  /// \param[in] _active True to show the impostor
+  public: void SetActive(ImpostorInstance &_instance, bool _active);
+
+  /// \brief Add a billboard to the billboard set of an atlas
+  /// \param[in] _atlas Atlas of the billboard
+  /// \param[in] _center Center of the billboard in the world frame
+  /// \param[in] _yaw Direction the billboard faces
+  /// \param[in] _view Index of the view shown on the billboard
+  public: void AddBillboard(ImpostorAtlas &_atlas,
+              const math::Vector3d &_center, double _yaw, unsigned int _view);
+
+  /// \brief Camera used to compute screen sizes
+  public: CameraPtr camera;
+
+  /// \brief Screen size threshold in pixels
+  public: double threshold = 32.0;
+
+  /// \brief Number of views per atlas
+  public: unsigned int viewCount = 8u;
+
+  /// \brief Resolution of each view
+  public: unsigned int textureSize = 128u;
+
+  /// \brief Atlases by key
+  public: std::map<std::string, std::shared_ptr<ImpostorAtlas>> atlases;
+
+  /// \brief Managed visuals by visual id
+  public: std::map<unsigned int, ImpostorInstance> instances;
+};
+
+using namespace ignition;
+using namespace rendering;
+
+//////////////////////////////////////////////////
+ImpostorController::ImpostorController()
+    : dataPtr(new ImpostorControllerPrivate)
+{
+}
+
+//////////////////////////////////////////////////
+ImpostorController::~ImpostorController()
+{
+  while (!this->dataPtr->instances.empty())
+    this->RemoveVisual(this->dataPtr->instances.begin()->second.visual);
+
+  // destroying the materials also removes the atlas textures they created
+  for (auto &atlasIt : this->dataPtr->atlases)
+  {
+    ScenePtr scene = atlasIt.second->material->Scene();
+    if (!scene)
+      continue;
+    scene->DestroyVisual(atlasIt.second->billboards);
+    scene->DestroyMaterial(atlasIt.second->material);
+  }
+}
+
+//////////////////////////////////////////////////
+void ImpostorController::SetCamera(const CameraPtr &_camera)
+{
+  this->dataPtr->camera = _camera;
+}
+
+//////////////////////////////////////////////////
+CameraPtr ImpostorController::Camera() const
+{
+  return this->dataPtr->camera;
+}
+
+//////////////////////////////////////////////////
+void ImpostorController::SetScreenSizeThreshold(double _pixels)
+{
+  this->dataPtr->threshold = std::max(0.0, _pixels);
+}
+
+//////////////////////////////////////////////////
+double ImpostorController::ScreenSizeThreshold() const
+{
+  return this->dataPtr->threshold;
+}
+
+//////////////////////////////////////////////////
+void ImpostorController::SetViewCount(unsigned int _count)
+{
+  this->dataPtr->viewCount = std::max(1u, _count);
+}
+
+//////////////////////////////////////////////////
+unsigned int ImpostorController::ViewCount() const
+{
+  return this->dataPtr->viewCount;
+}
+
+//////////////////////////////////////////////////
+void ImpostorController::SetTextureSize(unsigned int _size)
+{
+  this->dataPtr->textureSize = std::max(1u, _size);
+}
+
+//////////////////////////////////////////////////
+unsigned int ImpostorController::TextureSize() const
+{
+  return this->dataPtr->textureSize;
+}
+
+//////////////////////////////////////////////////
+bool ImpostorController::AddVisual(const VisualPtr &_visual,
+    const std::string &_key)
+{
+  if (!_visual || !_visual->Scene())
+  {
+    ignerr << "Unable to add null visual to impostor controller"
+           << std::endl;
+    return false;
+  }
+
+  if (this->dataPtr->instances.find(_visual->Id()) !=
+      this->dataPtr->instances.end())
+  {
+    return false;
+  }
+
+  std::shared_ptr<ImpostorAtlas> atlas;
+  auto atlasIt = this->dataPtr->atlases.find(_key);
+  if (atlasIt != this->dataPtr->atlases.end())
+  {
+    atlas = atlasIt->second;
+  }
+  else
+  {
+    atlas = this->dataPtr->Capture(_visual);
+    if (!atlas)
+      return false;
+
+    // a single billboard set draws the impostors of all the visuals sharing
+    // the atlas
+    ScenePtr scene = _visual->Scene();
+    atlas->marker = scene->CreateMarker();
+    atlas->marker->SetType(MT_TRIANGLE_LIST);
+    atlas->marker->SetMaterial(atlas->material, false);
+    atlas->billboards = scene->CreateVisual();
+    atlas->billboards->AddGeometry(atlas->marker);
+    atlas->billboards->SetVisibilityFlags(_visual->VisibilityFlags());
+    scene->RootVisual()->AddChild(atlas->billboards);
+    this->dataPtr->atlases[_key] = atlas;
+  }
+
+  ImpostorInstance instance;
+  instance.visual = _visual;
+  instance.atlas = atlas;
+  this->dataPtr->instances[_visual->Id()] = instance;
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool ImpostorController::RemoveVisual(const VisualPtr &_visual)
+{
+  if (!_visual)
+    return false;
+
+  auto it = this->dataPtr->instances.find(_visual->Id());
+  if (it == this->dataPtr->instances.end())
+    return false;
+
+  this->dataPtr->SetActive(it->second, false);
+  this->dataPtr->instances.erase(it);
+  return true;
+}
+
+//////////////////////////////////////////////////
+unsigned int ImpostorController::VisualCount() const
+{
+  return static_cast<unsigned int>(this->dataPtr->instances.size());
+}
+
+//////////////////////////////////////////////////
+unsigned int ImpostorController::ImpostorCount() const
+{
+  unsigned int count = 0u;
+  for (const auto &it : this->dataPtr->instances)
+  {
+    if (it.second.active)
+      ++count;
+  }
+  return count;
+}
+
+//////////////////////////////////////////////////
+bool ImpostorController::IsImpostor(const VisualPtr &_visual) const
+{
+  if (!_visual)
+    return false;
+  auto it = this->dataPtr->instances.find(_visual->Id());
+  return it != this->dataPtr->instances.end() && it->second.active;
+}
+
+//////////////////////////////////////////////////
+void ImpostorController::Update()
+{
+  if (!this->dataPtr->camera)
+    return;
+
+  math::Vector3d cameraPos = this->dataPtr->camera->WorldPosition();
+  double pixelsPerRadian = this->dataPtr->camera->ImageWidth() /
+      (2.0 * std::tan(this->dataPtr->camera->HFOV().Radian() * 0.5));
+
+  // the billboard sets are rebuilt from the active impostors
+  for (auto &atlasIt : this->dataPtr->atlases)
+  {
+    if (atlasIt.second->pointCount > 0u)
+    {
+      atlasIt.second->marker->ClearPoints();
+      atlasIt.second->pointCount = 0u;
+    }
+  }
+
+  for (auto &it : this->dataPtr->instances)
+  {
+    ImpostorInstance &instance = it.second;
+
+    // visuals hidden by the user are left alone
+    if (!instance.active && !instance.visual->Visible())
+      continue;
+
+    math::Pose3d pose = instance.visual->WorldPose();
+    math::Vector3d center = pose.Pos() + pose.Rot() * instance.atlas->offset;
+    math::Vector3d toCamera = cameraPos - center;
+    double distance = toCamera.Length();
+
+    // projected size of the billboard at the image center
+    double screenSize = (distance > 1e-6) ?
+        instance.atlas->size / distance * pixelsPerRadian :
+        std::numeric_limits<double>::max();
+    double threshold = this->dataPtr->threshold;
+    if (instance.active)
+      threshold *= kHysteresis;
+    this->dataPtr->SetActive(instance, screenSize < threshold);
+
+    if (!instance.active)
+      continue;
+
+    // pick the view captured closest to the camera direction
+    double yaw = std::atan2(toCamera.Y(), toCamera.X());
+    int viewCount = static_cast<int>(instance.atlas->viewCount);
+    double step = 2.0 * IGN_PI / viewCount;
+    int view = static_cast<int>(std::lround(
+        (yaw - pose.Rot().Yaw()) / step)) % viewCount;
+    if (view < 0)
+      view += viewCount;
+
+    this->dataPtr->AddBillboard(*instance.atlas, center, yaw,
+        static_cast<unsigned int>(view));
+  }
+}
+
+//////////////////////////////////////////////////
+void ImpostorControllerPrivate::SetActive(ImpostorInstance &_instance,
+    bool _active)
+{
+  if (_instance.active == _active)
+    return;
+  _instance.active = _active;
+  if (_active)
+  {
+    _instance.visible = _instance.visual->Visible();
+    _instance.visual->SetVisible(false);
+  }
+  else
+  {
+    _instance.visual->SetVisible(_instance.visible);
+  }
+}
+
+//////////////////////////////////////////////////
+void ImpostorControllerPrivate::AddBillboard(ImpostorAtlas &_atlas,
+    const math::Vector3d &_center, double _yaw, unsigned int _view)
+{
+  // the billboard turns around the vertical axis to face the camera
+  double half = _atlas.size * 0.5;
+  math::Vector3d right(-std::sin(_yaw) * half, std::cos(_yaw) * half, 0.0);
+  math::Vector3d up(0.0, 0.0, half);
+
+  // the views are side by side in the texture, with v = 0 at the top
+  double u0 = static_cast<double>(_view) / _atlas.viewCount;
+  double u1 = static_cast<double>(_view + 1u) / _atlas.viewCount;
+
+  const std::pair<math::Vector3d, math::Vector2d> corners[6] = {
+      {_center - right - up, {u0, 1.0}},
+      {_center + right - up, {u1, 1.0}},
+      {_center + right + up, {u1, 0.0}},
+      {_center - right - up, {u0, 1.0}},
+      {_center + right + up, {u1, 0.0}},
+      {_center - right + up, {u0, 0.0}}};
+  for (const auto &corner : corners)
+  {
+    _atlas.marker->AddPoint(corner.first, math::Color::White);
+    _atlas.marker->SetPointTexCoord(_atlas.pointCount++, corner.second);
+  }
+}
+
+//////////////////////////////////////////////////
+std::shared_ptr<ImpostorAtlas> ImpostorControllerPrivate::Capture(
+    const VisualPtr &_visual)
+{
+  ScenePtr scene = _visual->Scene();
+  math::AxisAlignedBox box = _visual->BoundingBox();
+  if (box.Min().X() > box.Max().X() || box.Min().Y() > box.Max().Y() ||
+      box.Min().Z() > box.Max().Z())
+  {
+    ignerr << "Unable to create impostor for visual [" << _visual->Name()
+           << "] without geometry" << std::endl;
+    return nullptr;
+  }
+
+  // the billboard must cover the visual when seen from any direction around
+  // the vertical axis
+  math::Vector3d center = box.Center();
+  math::Vector3d half = box.Size() * 0.5;
+  double size = 2.0 * std::max(
+      std::sqrt(half.X() * half.X() + half.Y() * half.Y()), half.Z());
+  if (size <= 0.0)
+    return nullptr;
+
+  auto atlas = std::make_shared<ImpostorAtlas>();
+  atlas->size = size;
+  math::Pose3d pose = _visual->WorldPose();
+  atlas->offset = pose.Rot().Inverse() * (center - pose.Pos());
+
+  // isolate the visual with a visibility flag. Setting flags on a visual
+  // overwrites the flags of its children, so restore them parent first.
+  std::vector<std::pair<VisualPtr, uint32_t>> flags;
+  std::vector<VisualPtr> stack = {_visual};
+  while (!stack.empty())
+  {
+    VisualPtr visual = stack.back();
+    stack.pop_back();
+    flags.push_back({visual, visual->VisibilityFlags()});
+    for (unsigned int i = visual->ChildCount(); i > 0; --i)
+    {
+      VisualPtr child =
+          std::dynamic_pointer_cast<Visual>(visual->ChildByIndex(i - 1));
+      if (child)
+        stack.push_back(child);
+    }
+  }
+  _visual->AddVisibilityFlags(kImpostorCaptureFlags);
+
+  // the key color is only set on the capture camera, and without
+  // anti-aliasing edge pixels are never blended with it. Use a narrow field
+  // of view from far away to approximate an orthographic projection.
+  CameraPtr camera = scene->CreateCamera();
+  camera->SetBackgroundColor(math::Color(kKeyColor[0] / 255.0f,
+      kKeyColor[1] / 255.0f, kKeyColor[2] / 255.0f));
+  camera->SetAntiAliasing(0u);
+
+  const double distance = 10.0 * size;
+  camera->SetImageWidth(this->textureSize);
+  camera->SetImageHeight(this->textureSize);
+  camera->SetImageFormat(PF_R8G8B8);
+  camera->SetAspectRatio(1.0);
+  camera->SetHFOV(2.0 * std::atan(0.5 * size / distance));
+  camera->SetNearClipPlane(distance - size);
+  camera->SetFarClipPlane(distance + size);
+  camera->SetVisibilityMask(kImpostorCaptureFlags);
+  scene->RootVisual()->AddChild(camera);
+
+  // the views are captured side by side into a single texture
+  const unsigned int atlasWidth = this->textureSize * this->viewCount;
+  std::vector<unsigned char> rgba(
+      atlasWidth * this->textureSize * 4u);
+  Image image = camera->CreateImage();
+  double yaw0 = pose.Rot().Yaw();
+  for (unsigned int v = 0; v < this->viewCount; ++v)
+  {
+    double yaw = yaw0 + 2.0 * IGN_PI * v / this->viewCount;
+    camera->SetWorldPosition(center +
+        math::Vector3d(std::cos(yaw), std::sin(yaw), 0.0) * distance);
+    camera->SetWorldRotation(math::Quaterniond(0, 0, yaw + IGN_PI));
+    camera->Capture(image);
+
+    // make the background transparent
+    const unsigned char *rgb = image.Data<unsigned char>();
+    for (unsigned int y = 0; y < this->textureSize; ++y)
+    {
+      for (unsigned int x = 0; x < this->textureSize; ++x)
+      {
+        const unsigned char *src = &rgb[(y * this->textureSize + x) * 3];
+        unsigned char *dst =
+            &rgba[(y * atlasWidth + v * this->textureSize + x) * 4];
+        bool key = src[0] == kKeyColor[0] && src[1] == kKeyColor[1] &&
+            src[2] == kKeyColor[2];
+        dst[0] = src[0];
+        dst[1] = src[1];
+        dst[2] = src[2];
+        dst[3] = key ? 0u : 255u;
+      }
+    }
+  }
+
+  // upload the views straight from memory. The lighting is baked into the
+  // texture and the billboards are seen from both sides.
+  auto texture = std::make_shared<common::Image>();
+  texture->SetFromData(rgba.data(), atlasWidth, this->textureSize,
+      common::Image::RGBA_INT8);
+  atlas->viewCount = this->viewCount;
+  atlas->material = scene->CreateMaterial();
+  atlas->material->SetTexture("__ignition_rendering_impostor_" +
+      common::Uuid().String(), texture);
+  atlas->material->SetAlphaFromTexture(true, 0.5, true);
+  atlas->material->SetLightingEnabled(false);
+  atlas->material->SetCastShadows(false);
+  atlas->material->SetDiffuse(1.0, 1.0, 1.0);
+  atlas->material->SetAmbient(1.0, 1.0, 1.0);
+
+  scene->DestroySensor(camera);
+  for (auto &f : flags)
+    f.first->SetVisibilityFlags(f.second);
+
+  return atlas;
+}
@@ -0,0 +1,192 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <ignition/common/Console.hh>
+
+#include "test_config.h"  // NOLINT(build/include)
+
+#include "ignition/rendering/Camera.hh"
+#include "ignition/rendering/ImpostorController.hh"
+#include "ignition/rendering/RenderEngine.hh"
+#include "ignition/rendering/RenderingIface.hh"
+#include "ignition/rendering/Scene.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+class ImpostorControllerTest : public testing::Test,
+                         public testing::WithParamInterface<const char *>
+{
+  /// \brief Test switching visuals to impostors based on distance
+  public: void Impostors(const std::string &_renderEngine);
+};
+
+/////////////////////////////////////////////////
+void ImpostorControllerTest::Impostors(const std::string &_renderEngine)
+{
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+  const math::Color background(0.2f, 0.3f, 0.4f);
+  scene->SetBackgroundColor(background);
+
+  CameraPtr camera = scene->CreateCamera("camera");
+  ASSERT_NE(nullptr, camera);
+  camera->SetImageWidth(320);
+  camera->SetImageHeight(240);
+  camera->SetHFOV(IGN_PI / 2.0);
+  scene->RootVisual()->AddChild(camera);
+
+  // the controller must be destroyed before the scene
+  {
+    ImpostorController impostors;
+
+    // verify initial values
+    EXPECT_EQ(nullptr, impostors.Camera());
+    EXPECT_EQ(0u, impostors.VisualCount());
+    EXPECT_EQ(0u, impostors.ImpostorCount());
+
+    impostors.SetCamera(camera);
+    EXPECT_EQ(camera, impostors.Camera());
+    impostors.SetScreenSizeThreshold(20.0);
+    EXPECT_DOUBLE_EQ(20.0, impostors.ScreenSizeThreshold());
+    impostors.SetViewCount(4u);
+    EXPECT_EQ(4u, impostors.ViewCount());
+    impostors.SetTextureSize(64u);
+    EXPECT_EQ(64u, impostors.TextureSize());
+
+    // visuals without geometry can not be captured
+    VisualPtr empty = scene->CreateVisual();
+    EXPECT_FALSE(impostors.AddVisual(empty, "empty"));
+    EXPECT_FALSE(impostors.AddVisual(nullptr, "null"));
+
+    VisualPtr box = scene->CreateVisual();
+    box->AddGeometry(scene->CreateBox());
+    box->SetWorldPosition(5.0, 0.0, 0.0);
+    scene->RootVisual()->AddChild(box);
+
+    VisualPtr box2 = scene->CreateVisual();
+    box2->AddGeometry(scene->CreateBox());
+    box2->SetWorldPosition(5.0, 3.0, 0.0);
+    scene->RootVisual()->AddChild(box2);
+
+    uint32_t flags = box->VisibilityFlags();
+    EXPECT_TRUE(impostors.AddVisual(box, "box"));
+    EXPECT_FALSE(impostors.AddVisual(box, "box"));
+
+    // capturing the impostor leaves the scene, the other cameras and the
+    // visual as they were
+    EXPECT_EQ(background, scene->BackgroundColor());
+    EXPECT_EQ(background, camera->BackgroundColor());
+    EXPECT_EQ(flags, box->VisibilityFlags());
+
+    // visuals with the same key share the billboard set of the first one
+    unsigned int visualCount = scene->VisualCount();
+    EXPECT_TRUE(impostors.AddVisual(box2, "box"));
+    EXPECT_EQ(2u, impostors.VisualCount());
+    EXPECT_EQ(visualCount, scene->VisualCount());
+
+    // close visuals keep their meshes
+    impostors.Update();
+    EXPECT_EQ(0u, impostors.ImpostorCount());
+    EXPECT_FALSE(impostors.IsImpostor(box));
+
+    // a distant visual is replaced by its impostor
+    box->SetWorldPosition(100.0, 0.0, 0.0);
+    impostors.Update();
+    EXPECT_EQ(1u, impostors.ImpostorCount());
+    EXPECT_TRUE(impostors.IsImpostor(box));
+    EXPECT_FALSE(impostors.IsImpostor(box2));
+
+    EXPECT_FALSE(box->Visible());
+
+    // the box covers 226 / distance pixels. It switches to an impostor
+    // farther than 11.3 m, and back to its mesh closer than 10.3 m. Inside
+    // the band in between, both keep their state.
+    box->SetWorldPosition(10.8, 0.0, 0.0);
+    impostors.Update();
+    EXPECT_TRUE(impostors.IsImpostor(box));
+
+    box->SetWorldPosition(10.0, 0.0, 0.0);
+    impostors.Update();
+    EXPECT_FALSE(impostors.IsImpostor(box));
+    EXPECT_TRUE(box->Visible());
+
+    box->SetWorldPosition(10.8, 0.0, 0.0);
+    impostors.Update();
+    EXPECT_FALSE(impostors.IsImpostor(box));
+
+    box->SetWorldPosition(11.5, 0.0, 0.0);
+    impostors.Update();
+    EXPECT_TRUE(impostors.IsImpostor(box));
+
+    box->SetWorldPosition(5.0, 0.0, 0.0);
+    impostors.Update();
+    EXPECT_FALSE(impostors.IsImpostor(box));
+
+    // hidden visuals stay hidden and are not replaced
+    box2->SetVisible(false);
+    box2->SetWorldPosition(100.0, 3.0, 0.0);
+    impostors.Update();
+    EXPECT_FALSE(impostors.IsImpostor(box2));
+    EXPECT_FALSE(box2->Visible());
+    box2->SetVisible(true);
+    impostors.Update();
+    EXPECT_TRUE(impostors.IsImpostor(box2));
+    box2->SetWorldPosition(5.0, 3.0, 0.0);
+    impostors.Update();
+    EXPECT_FALSE(impostors.IsImpostor(box2));
+    EXPECT_TRUE(box2->Visible());
+
+    // removing a visual restores it
+    box->SetWorldPosition(100.0, 0.0, 0.0);
+    impostors.Update();
+    EXPECT_TRUE(impostors.IsImpostor(box));
+    EXPECT_TRUE(impostors.RemoveVisual(box));
+    EXPECT_FALSE(impostors.RemoveVisual(box));
+    EXPECT_EQ(1u, impostors.VisualCount());
+    EXPECT_EQ(0u, impostors.ImpostorCount());
+  }
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+TEST_P(ImpostorControllerTest, Impostors)
+{
+  Impostors(GetParam());
+}
+
+INSTANTIATE_TEST_CASE_P(ImpostorController, ImpostorControllerTest,
+    RENDER_ENGINE_VALUES,
+    ignition::rendering::PrintToStringParam());
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
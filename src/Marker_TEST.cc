@@ -16,6 +16,8 @@
 
 #include <gtest/gtest.h>
 
+#include <vector>
+
 #include <ignition/common/Console.hh>
 
 #include "test_config.h"  // NOLINT(build/include)
@@ -23,6 +25,7 @@
 #include "ignition/rendering/RenderingIface.hh"
 #include "ignition/rendering/Marker.hh"
 #include "ignition/rendering/Scene.hh"
+#include "ignition/rendering/Visual.hh"
 
 using namespace ignition;
 using namespace rendering;
@@ -105,6 +108,69 @@ void MarkerTest::Marker(const std::string &_renderEngine)
   EXPECT_NO_THROW(marker->SetPoint(0, math::Vector3d(3, 1, 2)));
   EXPECT_NO_THROW(marker->ClearPoints());
 
+  // list types
+  std::vector<math::Pose3d> poses;
+  std::vector<math::Color> colors;
+  for (unsigned int i = 0u; i < 100u; ++i)
+  {
+    poses.push_back(math::Pose3d(i, 0, 0, 0, 0, 0));
+    colors.push_back(math::Color(i / 100.0f, 0, 1, 1));
+  }
+  std::vector<math::Vector3d> scales(poses.size(), math::Vector3d(1, 2, 3));
+
+  marker->SetType(MarkerType::MT_BOX_LIST);
+  EXPECT_EQ(MarkerType::MT_BOX_LIST, marker->Type());
+
+  // the shapes are created when the parent visual is rendered
+  VisualPtr visual = scene->CreateVisual();
+  ASSERT_NE(nullptr, visual);
+  scene->RootVisual()->AddChild(visual);
+  visual->AddGeometry(marker);
+  EXPECT_EQ(0u, marker->ListElementCount());
+  marker->SetListElements(poses, scales, colors);
+  EXPECT_EQ(100u, marker->ListElementCount());
+  for (unsigned int i = 0u; i < 100u; ++i)
+    EXPECT_EQ(colors[i], marker->ListElementColor(i));
+  EXPECT_EQ(math::Color::White, marker->ListElementColor(100u));
+  EXPECT_NO_THROW(visual->PreRender());
+
+  // a single color is used by all shapes
+  marker->SetListElements(poses, {}, {math::Color::Blue});
+  EXPECT_EQ(100u, marker->ListElementCount());
+  EXPECT_EQ(math::Color::Blue, marker->ListElementColor(0u));
+  EXPECT_EQ(math::Color::Blue, marker->ListElementColor(99u));
+  EXPECT_NO_THROW(visual->PreRender());
+
+  // shapes without colors are white
+  marker->SetType(MarkerType::MT_CYLINDER_LIST);
+  EXPECT_EQ(MarkerType::MT_CYLINDER_LIST, marker->Type());
+  marker->SetListElements(poses, scales, {});
+  EXPECT_EQ(100u, marker->ListElementCount());
+  EXPECT_EQ(math::Color::White, marker->ListElementColor(50u));
+  EXPECT_NO_THROW(visual->PreRender());
+
+  // fewer shapes
+  marker->SetType(MarkerType::MT_SPHERE_LIST);
+  EXPECT_EQ(MarkerType::MT_SPHERE_LIST, marker->Type());
+  std::vector<math::Pose3d> fewPoses(poses.begin(), poses.begin() + 10);
+  std::vector<math::Color> fewColors(colors.begin(), colors.begin() + 10);
+  marker->SetListElements(fewPoses, {}, fewColors);
+  EXPECT_EQ(10u, marker->ListElementCount());
+  EXPECT_EQ(colors[9], marker->ListElementColor(9u));
+  EXPECT_EQ(math::Color::White, marker->ListElementColor(10u));
+  EXPECT_NO_THROW(visual->PreRender());
+
+  // mismatched sizes and non list types are ignored
+  scales.pop_back();
+  marker->SetListElements(poses, scales, colors);
+  EXPECT_EQ(10u, marker->ListElementCount());
+  marker->SetListElements(poses, {}, {math::Color::Red, math::Color::Blue});
+  EXPECT_EQ(10u, marker->ListElementCount());
+  marker->SetType(MarkerType::MT_BOX);
+  marker->SetListElements(poses, {}, {});
+  EXPECT_EQ(10u, marker->ListElementCount());
+  EXPECT_NO_THROW(visual->PreRender());
+
   // Clean up
   engine->DestroyScene(scene);
   rendering::unloadEngine(engine->Name());
@@ -0,0 +1,607 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <numeric>
+
+#include <ignition/math/Vector3.hh>
+
+#include "ignition/rendering/MeshOptimizer.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+//////////////////////////////////////////////////
+const unsigned int MeshOptimizer::kUnused =
+    std::numeric_limits<unsigned int>::max();
+
+namespace
+{
+  /// \brief Size of the vertex cache modelled by the Forsyth scoring
+  /// function
+  const unsigned int kForsythCacheSize = 32u;
+
+  /// \brief Compute the Forsyth score of a vertex
+  /// \param[in] _cachePos Position of the vertex in the modelled LRU cache,
+  /// or -1 if the vertex is not in the cache
+  /// \param[in] _remaining Number of triangles not yet emitted that use
+  /// the vertex
+  /// \return Vertex score
+  float forsythVertexScore(int _cachePos, unsigned int _remaining)
+  {
+    if (_remaining == 0u)
+      return -1.0f;
+
+    float score = 0.0f;
+    if (_cachePos >= 0)
+    {
+      // the last triangle's vertices get a fixed score so that the
+      // algorithm does not prefer to reuse the most recent vertices
+      if (_cachePos < 3)
+      {
+        score = 0.75f;
+      }
+      else
+      {
+        const float scaler = 1.0f / (kForsythCacheSize - 3);
+        score = 1.0f - (_cachePos - 3) * scaler;
+        score = std::pow(score, 1.5f);
+      }
+    }
+
+    // boost vertices with few remaining triangles so that lone triangles
+    // do not get left behind
+    score += 2.0f / std::sqrt(static_cast<float>(_remaining));
+    return score;
+  }
+
+  /// \brief Hash the bytes of an interleaved vertex (FNV-1a)
+  /// \param[in] _data Pointer to the first float of the vertex
+  /// \param[in] _stride Number of floats per vertex
+  /// \return Hash value
+  uint64_t hashVertex(const float *_data, unsigned int _stride)
+  {
+    uint64_t h = 14695981039346656037ull;
+    for (unsigned int i = 0; i < _stride; ++i)
+    {
+      uint32_t bits;
+      std::memcpy(&bits, _data + i, sizeof(bits));
+      h ^= bits;
+      h *= 1099511628211ull;
+    }
+    return h;
+  }
+
+  /// \brief Simulate a FIFO vertex cache and return the number of misses
+  /// produced by each triangle
+  /// \param[in] _indices Triangle list indices
+  /// \param[in] _cacheSize Number of entries in the cache
+  /// \return Number of cache misses per triangle
+  std::vector<unsigned char> simulateFifoCache(
+      const std::vector<unsigned int> &_indices, unsigned int _cacheSize)
+  {
+    unsigned int maxIndex = 0u;
+    for (auto idx : _indices)
+      maxIndex = std::max(maxIndex, idx);
+
+    // a vertex is in the cache if it was inserted less than _cacheSize
+    // insertions ago
+    std::vector<unsigned int> insertTime(
+        _indices.empty() ? 0u : maxIndex + 1u, 0u);
+    unsigned int timestamp = _cacheSize + 1u;
+
+    std::vector<unsigned char> misses(_indices.size() / 3u, 0u);
+    for (size_t t = 0; t < misses.size(); ++t)
+    {
+      for (unsigned int k = 0; k < 3u; ++k)
+      {
+        unsigned int v = _indices[t * 3u + k];
+        if (timestamp - insertTime[v] > _cacheSize)
+        {
+          insertTime[v] = timestamp++;
+          ++misses[t];
+        }
+      }
+    }
+    return misses;
+  }
+}
+
+//////////////////////////////////////////////////
+unsigned int MeshOptimizer::WeldVertices(std::vector<float> &_vertices,
+    unsigned int _stride, std::vector<unsigned int> &_indices,
+    std::vector<unsigned int> &_remap)
+{
+  _remap.clear();
+  if (_stride == 0u)
+    return 0u;
+
+  const unsigned int vertexCount =
+      static_cast<unsigned int>(_vertices.size() / _stride);
+
+  // open addressing hash table holding indices into the welded array
+  size_t tableSize = 16u;
+  while (tableSize < vertexCount * 2u)
+    tableSize *= 2u;
+  const size_t mask = tableSize - 1u;
+  std::vector<unsigned int> table(tableSize, kUnused);
+
+  std::vector<float> welded;
+  welded.reserve(_vertices.size());
+  _remap.assign(vertexCount, kUnused);
+
+  unsigned int weldedCount = 0u;
+  for (unsigned int v = 0; v < vertexCount; ++v)
+  {
+    const float *src = _vertices.data() + static_cast<size_t>(v) * _stride;
+    size_t slot = hashVertex(src, _stride) & mask;
+    while (true)
+    {
+      unsigned int entry = table[slot];
+      if (entry == kUnused)
+      {
+        table[slot] = weldedCount;
+        welded.insert(welded.end(), src, src + _stride);
+        _remap[v] = weldedCount++;
+        break;
+      }
+      if (std::memcmp(welded.data() + static_cast<size_t>(entry) * _stride,
+          src, _stride * sizeof(float)) == 0)
+      {
+        _remap[v] = entry;
+        break;
+      }
+      slot = (slot + 1u) & mask;
+    }
+  }
+
+  for (auto &idx : _indices)
+    idx = _remap[idx];
+
+  _vertices.swap(welded);
+  return weldedCount;
+}
+
+//////////////////////////////////////////////////
+void MeshOptimizer::OptimizeVertexCache(std::vector<unsigned int> &_indices,
+    unsigned int _vertexCount)
+{
+  const size_t triCount = _indices.size() / 3u;
+  if (triCount == 0u || _vertexCount == 0u)
+    return;
+
+  // build vertex to triangle adjacency. The live triangles of vertex v are
+  // stored in adjacency[offsets[v], offsets[v] + remaining[v])
+  std::vector<unsigned int> remaining(_vertexCount, 0u);
+  for (size_t i = 0; i < triCount * 3u; ++i)
+    ++remaining[_indices[i]];
+
+  std::vector<unsigned int> offsets(_vertexCount, 0u);
+  for (unsigned int v = 1; v < _vertexCount; ++v)
+    offsets[v] = offsets[v - 1] + remaining[v - 1];
+
+  std::vector<unsigned int> adjacency(triCount * 3u);
+  {
+    std::vector<unsigned int> fill(offsets);
+    for (size_t t = 0; t < triCount; ++t)
+    {
+      for (unsigned int k = 0; k < 3u; ++k)
+        adjacency[fill[_indices[t * 3u + k]]++] = static_cast<unsigned int>(t);
+    }
+  }
+
+  std::vector<int> cachePos(_vertexCount, -1);
+  std::vector<float> vertexScore(_vertexCount);
+  for (unsigned int v = 0; v < _vertexCount; ++v)
+    vertexScore[v] = forsythVertexScore(-1, remaining[v]);
+
+  std::vector<float> triScore(triCount);
+  std::vector<bool> emitted(triCount, false);
+  for (size_t t = 0; t < triCount; ++t)
+  {
+    triScore[t] = vertexScore[_indices[t * 3u]] +
+        vertexScore[_indices[t * 3u + 1u]] +
+        vertexScore[_indices[t * 3u + 2u]];
+  }
+
+  // start with the highest scoring triangle
+  size_t bestTri = 0u;
+  for (size_t t = 1; t < triCount; ++t)
+  {
+    if (triScore[t] > triScore[bestTri])
+      bestTri = t;
+  }
+
+  std::vector<unsigned int> cache;
+  std::vector<unsigned int> newCache;
+  cache.reserve(kForsythCacheSize + 3u);
+  newCache.reserve(kForsythCacheSize + 3u);
+
+  std::vector<unsigned int> result;
+  result.reserve(triCount * 3u);
+
+  size_t cursor = 0u;
+  for (size_t n = 0; n < triCount; ++n)
+  {
+    if (bestTri == triCount)
+    {
+      // nothing useful in the cache; continue with the next triangle in
+      // input order
+      while (emitted[cursor])
+        ++cursor;
+      bestTri = cursor;
+    }
+
+    const unsigned int *tri = &_indices[bestTri * 3u];
+    result.insert(result.end(), tri, tri + 3u);
+    emitted[bestTri] = true;
+
+    // remove the triangle from the live adjacency of its vertices
+    for (unsigned int k = 0; k < 3u; ++k)
+    {
+      unsigned int v = tri[k];
+      unsigned int *begin = &adjacency[offsets[v]];
+      unsigned int *end = begin + remaining[v];
+      unsigned int *it = std::find(begin, end, bestTri);
+      if (it != end)
+      {
+        *it = *(end - 1);
+        --remaining[v];
+      }
+    }
+
+    // push the triangle's vertices to the front of the modelled LRU cache
+    newCache.clear();
+    for (unsigned int k = 0; k < 3u; ++k)
+    {
+      if (std::find(newCache.begin(), newCache.end(), tri[k]) ==
+          newCache.end())
+      {
+        newCache.push_back(tri[k]);
+      }
+    }
+    for (auto v : cache)
+    {
+      if (std::find(newCache.begin(), newCache.end(), v) == newCache.end())
+        newCache.push_back(v);
+    }
+
+    // update scores of vertices that are in or were evicted from the cache
+    for (size_t i = 0; i < newCache.size(); ++i)
+    {
+      unsigned int v = newCache[i];
+      cachePos[v] = i < kForsythCacheSize ? static_cast<int>(i) : -1;
+      vertexScore[v] = forsythVertexScore(cachePos[v], remaining[v]);
+    }
+
+    // update triangle scores and pick the best triangle among those that
+    // touch the cache
+    bestTri = triCount;
+    float bestScore = -1.0f;
+    for (auto v : newCache)
+    {
+      for (unsigned int i = 0; i < remaining[v]; ++i)
+      {
+        unsigned int t = adjacency[offsets[v] + i];
+        float score = vertexScore[_indices[t * 3u]] +
+            vertexScore[_indices[t * 3u + 1u]] +
+            vertexScore[_indices[t * 3u + 2u]];
+        triScore[t] = score;
+        if (score > bestScore)
+        {
+          bestScore = score;
+          bestTri = t;
+        }
+      }
+    }
+
+    if (newCache.size() > kForsythCacheSize)
+      newCache.resize(kForsythCacheSize);
+    cache.swap(newCache);
+  }
+
+  _indices.swap(result);
+}
+
+//////////////////////////////////////////////////
+void MeshOptimizer::OptimizeOverdraw(std::vector<unsigned int> &_indices,
+    const std::vector<float> &_vertices, unsigned int _stride,
+    unsigned int _cacheSize)
+{
+  const size_t triCount = _indices.size() / 3u;
+  if (triCount == 0u || _stride < 3u)
+    return;
+
+  // split into clusters wherever a triangle misses the cache on all of its
+  // vertices, i.e. the cache optimizer jumped to a new region of the mesh
+  std::vector<unsigned char> misses = simulateFifoCache(_indices, _cacheSize);
+  std::vector<size_t> clusterStart;
+  for (size_t t = 0; t < triCount; ++t)
+  {
+    if (t == 0u || misses[t] == 3u)
+      clusterStart.push_back(t);
+  }
+  if (clusterStart.size() < 2u)
+    return;
+  clusterStart.push_back(triCount);
+
+  auto position = [&](unsigned int _v)
+  {
+    const float *p = _vertices.data() + static_cast<size_t>(_v) * _stride;
+    return math::Vector3d(p[0], p[1], p[2]);
+  };
+
+  // area weighted centroid and normal of each cluster
+  const size_t clusterCount = clusterStart.size() - 1u;
+  std::vector<math::Vector3d> centroids(clusterCount);
+  std::vector<math::Vector3d> normals(clusterCount);
+  math::Vector3d meshCentroid;
+  double meshArea = 0.0;
+  for (size_t c = 0; c < clusterCount; ++c)
+  {
+    math::Vector3d centroid;
+    math::Vector3d normal;
+    double area = 0.0;
+    for (size_t t = clusterStart[c]; t < clusterStart[c + 1u]; ++t)
+    {
+      math::Vector3d p0 = position(_indices[t * 3u]);
+      math::Vector3d p1 = position(_indices[t * 3u + 1u]);
+      math::Vector3d p2 = position(_indices[t * 3u + 2u]);
+      math::Vector3d n = (p1 - p0).Cross(p2 - p0);
+      double triArea = n.Length();
+      centroid += (p0 + p1 + p2) * (triArea / 3.0);
+      normal += n;
+      area += triArea;
+    }
+    meshCentroid += centroid;
+    meshArea += area;
+    centroids[c] = area > 0.0 ? centroid / area : centroid;
+    normals[c] = normal;
+  }
+  if (meshArea > 0.0)
+    meshCentroid /= meshArea;
+
+  // clusters that face away from the mesh center are more likely to occlude
+  // the rest of the mesh, so draw them first
+  std::vector<double> sortKey(clusterCount, 0.0);
+  for (size_t c = 0; c < clusterCount; ++c)
+  {
+    double length = normals[c].Length();
+    if (length > 0.0)
+      sortKey[c] = (centroids[c] - meshCentroid).Dot(normals[c] / length);
+  }
+
+  std::vector<size_t> order(clusterCount);
+  std::iota(order.begin(), order.end(), 0u);
+  std::stable_sort(order.begin(), order.end(),
+      [&](size_t _a, size_t _b)
+      {
+        return sortKey[_a] > sortKey[_b];
+      });
+
+  std::vector<unsigned int> result;
+  result.reserve(_indices.size());
+  for (auto c : order)
+  {
+    result.insert(result.end(),
+        _indices.begin() + clusterStart[c] * 3u,
+        _indices.begin() + clusterStart[c + 1u] * 3u);
+  }
+  _indices.swap(result);
+}
+
+//////////////////////////////////////////////////
+unsigned int MeshOptimizer::OptimizeVertexFetch(std::vector<float> &_vertices,
+    unsigned int _stride, std::vector<unsigned int> &_indices,
+    std::vector<unsigned int> &_remap)
+{
+  _remap.clear();
+  if (_stride == 0u)
+    return 0u;
+
+  const unsigned int vertexCount =
+      static_cast<unsigned int>(_vertices.size() / _stride);
+  _remap.assign(vertexCount, kUnused);
+
+  unsigned int newCount = 0u;
+  for (auto &idx : _indices)
+  {
+    if (_remap[idx] == kUnused)
+      _remap[idx] = newCount++;
+    idx = _remap[idx];
+  }
+
+  std::vector<float> reordered(static_cast<size_t>(newCount) * _stride);
+  for (unsigned int v = 0; v < vertexCount; ++v)
+  {
+    if (_remap[v] == kUnused)
+      continue;
+    std::copy(_vertices.begin() + static_cast<size_t>(v) * _stride,
+        _vertices.begin() + static_cast<size_t>(v + 1u) * _stride,
+        reordered.begin() + static_cast<size_t>(_remap[v]) * _stride);
+  }
+  _vertices.swap(reordered);
+  return newCount;
+}
+
+//////////////////////////////////////////////////
+unsigned int MeshOptimizer::Optimize(std::vector<float> &_vertices,
+    unsigned int _stride, std::vector<unsigned int> &_indices,
+    std::vector<unsigned int> &_remap)
+{
+  std::vector<unsigned int> weldRemap;
+  unsigned int vertexCount =
+      WeldVertices(_vertices, _stride, _indices, weldRemap);
+  OptimizeVertexCache(_indices, vertexCount);
+  OptimizeOverdraw(_indices, _vertices, _stride);
+
+  std::vector<unsigned int> fetchRemap;
+  vertexCount = OptimizeVertexFetch(_vertices, _stride, _indices, fetchRemap);
+
+  _remap.resize(weldRemap.size());
+  for (size_t v = 0; v < weldRemap.size(); ++v)
+    _remap[v] = fetchRemap[weldRemap[v]];
+
+  return vertexCount;
+}
+
+//////////////////////////////////////////////////
+common::SubMesh MeshOptimizer::Optimize(const common::SubMesh &_subMesh)
+{
+  const unsigned int vertexCount = _subMesh.VertexCount();
+  if (_subMesh.SubMeshPrimitiveType() != common::SubMesh::TRIANGLES ||
+      vertexCount == 0u)
+  {
+    return _subMesh;
+  }
+
+  // attributes must be either absent or per vertex
+  const bool hasNormals = _subMesh.NormalCount() > 0u;
+  const bool hasTexCoords = _subMesh.TexCoordCount() > 0u;
+  if ((hasNormals && _subMesh.NormalCount() != vertexCount) ||
+      (hasTexCoords && _subMesh.TexCoordCount() != vertexCount))
+  {
+    return _subMesh;
+  }
+
+  std::vector<unsigned int> indices;
+  if (_subMesh.IndexCount() == 0u)
+  {
+    // unindexed triangle soup, e.g. from STL files
+    if (vertexCount % 3u != 0u)
+      return _subMesh;
+    indices.resize(vertexCount);
+    std::iota(indices.begin(), indices.end(), 0u);
+  }
+  else
+  {
+    if (_subMesh.IndexCount() % 3u != 0u)
+      return _subMesh;
+    indices.reserve(_subMesh.IndexCount());
+    for (unsigned int i = 0; i < _subMesh.IndexCount(); ++i)
+    {
+      int idx = _subMesh.Index(i);
+      if (idx < 0 || static_cast<unsigned int>(idx) >= vertexCount)
+        return _subMesh;
+      indices.push_back(static_cast<unsigned int>(idx));
+    }
+  }
+
+  const unsigned int stride =
+      3u + (hasNormals ? 3u : 0u) + (hasTexCoords ? 2u : 0u);
+  std::vector<float> vertices;
+  vertices.reserve(static_cast<size_t>(vertexCount) * stride);
+  for (unsigned int i = 0; i < vertexCount; ++i)
+  {
+    const math::Vector3d &p = _subMesh.Vertex(i);
+    vertices.push_back(static_cast<float>(p.X()));
+    vertices.push_back(static_cast<float>(p.Y()));
+    vertices.push_back(static_cast<float>(p.Z()));
+    if (hasNormals)
+    {
+      const math::Vector3d &n = _subMesh.Normal(i);
+      vertices.push_back(static_cast<float>(n.X()));
+      vertices.push_back(static_cast<float>(n.Y()));
+      vertices.push_back(static_cast<float>(n.Z()));
+    }
+    if (hasTexCoords)
+    {
+      const math::Vector2d &uv = _subMesh.TexCoord(i);
+      vertices.push_back(static_cast<float>(uv.X()));
+      vertices.push_back(static_cast<float>(uv.Y()));
+    }
+  }
+
+  std::vector<unsigned int> remap;
+  unsigned int newCount = 0u;
+  if (_subMesh.NodeAssignmentsCount() > 0u)
+  {
+    // vertices with identical attributes may still have different bone
+    // weights, so skinned meshes are only reordered
+    OptimizeVertexCache(indices, vertexCount);
+    OptimizeOverdraw(indices, vertices, stride);
+    newCount = OptimizeVertexFetch(vertices, stride, indices, remap);
+  }
+  else
+  {
+    newCount = Optimize(vertices, stride, indices, remap);
+  }
+
+  common::SubMesh result(_subMesh.Name());
+  result.SetPrimitiveType(_subMesh.SubMeshPrimitiveType());
+  if (_subMesh.MaterialIndex() >= 0)
+    result.SetMaterialIndex(_subMesh.MaterialIndex());
+
+  for (unsigned int i = 0; i < newCount; ++i)
+  {
+    const float *v = vertices.data() + static_cast<size_t>(i) * stride;
+    result.AddVertex(v[0], v[1], v[2]);
+    v += 3;
+    if (hasNormals)
+    {
+      result.AddNormal(v[0], v[1], v[2]);
+      v += 3;
+    }
+    if (hasTexCoords)
+      result.AddTexCoord(v[0], v[1]);
+  }
+
+  for (auto idx : indices)
+    result.AddIndex(idx);
+
+  for (unsigned int i = 0; i < _subMesh.NodeAssignmentsCount(); ++i)
+  {
+    common::NodeAssignment na = _subMesh.NodeAssignmentByIndex(i);
+    if (na.vertexIndex < remap.size() && remap[na.vertexIndex] != kUnused)
+      result.AddNodeAssignment(remap[na.vertexIndex], na.nodeIndex, na.weight);
+  }
+
+  return result;
+}
+
+//////////////////////////////////////////////////
+double MeshOptimizer::AverageCacheMissRatio(
+    const std::vector<unsigned int> &_indices, unsigned int _cacheSize)
+{
+  std::vector<unsigned char> misses = simulateFifoCache(_indices, _cacheSize);
+  if (misses.empty())
+    return 0.0;
+
+  unsigned int total = 0u;
+  for (auto m : misses)
+    total += m;
+  return static_cast<double>(total) / misses.size();
+}
+
+//////////////////////////////////////////////////
+double MeshOptimizer::AverageTransformToVertexRatio(
+    const std::vector<unsigned int> &_indices, unsigned int _vertexCount,
+    unsigned int _cacheSize)
+{
+  if (_vertexCount == 0u)
+    return 0.0;
+
+  std::vector<unsigned char> misses = simulateFifoCache(_indices, _cacheSize);
+  unsigned int total = 0u;
+  for (auto m : misses)
+    total += m;
+  return static_cast<double>(total) / _vertexCount;
+}
@@ -0,0 +1,336 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <vector>
+
+#include "ignition/rendering/MeshOptimizer.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+/// \brief Create an unindexed grid of _n x _n quads as a triangle soup with
+/// positions only
+/// \param[in] _n Number of quads along each side
+/// \param[out] _vertices Vertex positions
+/// \param[out] _indices Identity indices
+void createTriangleSoup(unsigned int _n, std::vector<float> &_vertices,
+    std::vector<unsigned int> &_indices)
+{
+  _vertices.clear();
+  _indices.clear();
+  auto addVertex = [&](unsigned int _x, unsigned int _y)
+  {
+    _indices.push_back(static_cast<unsigned int>(_vertices.size() / 3u));
+    _vertices.push_back(static_cast<float>(_x));
+    _vertices.push_back(static_cast<float>(_y));
+    _vertices.push_back(0.0f);
+  };
+
+  for (unsigned int y = 0; y < _n; ++y)
+  {
+    for (unsigned int x = 0; x < _n; ++x)
+    {
+      addVertex(x, y);
+      addVertex(x + 1, y);
+      addVertex(x + 1, y + 1);
+      addVertex(x, y);
+      addVertex(x + 1, y + 1);
+      addVertex(x, y + 1);
+    }
+  }
+}
+
+/// \brief Shuffle the triangles of a triangle list with a fixed seed
+/// \param[in,out] _indices Triangle list indices
+void shuffleTriangles(std::vector<unsigned int> &_indices)
+{
+  unsigned int seed = 12345u;
+  size_t triCount = _indices.size() / 3u;
+  for (size_t i = triCount - 1u; i > 0u; --i)
+  {
+    seed = seed * 1103515245u + 12345u;
+    size_t j = (seed >> 8) % (i + 1u);
+    for (unsigned int k = 0; k < 3u; ++k)
+      std::swap(_indices[i * 3u + k], _indices[j * 3u + k]);
+  }
+}
+
+/// \brief Get the triangles of a triangle list as sorted vertex position
+/// triples so that triangle lists can be compared independent of order
+/// \param[in] _vertices Vertex positions
+/// \param[in] _indices Triangle list indices
+/// \return Sorted list of triangles
+std::vector<std::array<float, 9>> triangleSet(
+    const std::vector<float> &_vertices,
+    const std::vector<unsigned int> &_indices)
+{
+  std::vector<std::array<float, 9>> tris;
+  for (size_t t = 0; t < _indices.size() / 3u; ++t)
+  {
+    // rotate so that the winding is kept but the start vertex is canonical
+    std::array<std::array<float, 3>, 3> corners;
+    for (unsigned int k = 0; k < 3u; ++k)
+    {
+      unsigned int v = _indices[t * 3u + k];
+      corners[k] = {_vertices[v * 3u], _vertices[v * 3u + 1u],
+          _vertices[v * 3u + 2u]};
+    }
+    auto first = std::min_element(corners.begin(), corners.end());
+    std::rotate(corners.begin(), first, corners.end());
+
+    std::array<float, 9> tri;
+    for (unsigned int k = 0; k < 3u; ++k)
+      std::copy(corners[k].begin(), corners[k].end(), tri.begin() + k * 3u);
+    tris.push_back(tri);
+  }
+  std::sort(tris.begin(), tris.end());
+  return tris;
+}
+
+/////////////////////////////////////////////////
+TEST(MeshOptimizerTest, CacheMissRatio)
+{
+  std::vector<unsigned int> indices;
+  EXPECT_DOUBLE_EQ(0.0, MeshOptimizer::AverageCacheMissRatio(indices));
+
+  indices = {0, 1, 2};
+  EXPECT_DOUBLE_EQ(3.0, MeshOptimizer::AverageCacheMissRatio(indices));
+
+  // second triangle shares an edge with the first
+  indices = {0, 1, 2, 0, 2, 3};
+  EXPECT_DOUBLE_EQ(2.0, MeshOptimizer::AverageCacheMissRatio(indices));
+  EXPECT_DOUBLE_EQ(1.0,
+      MeshOptimizer::AverageTransformToVertexRatio(indices, 4u));
+
+  // a cache with 3 entries forgets vertex 0 after vertex 3 is loaded
+  indices = {0, 1, 2, 1, 2, 3, 3, 2, 0};
+  EXPECT_DOUBLE_EQ(5.0 / 3.0,
+      MeshOptimizer::AverageCacheMissRatio(indices, 3u));
+}
+
+/////////////////////////////////////////////////
+TEST(MeshOptimizerTest, WeldVertices)
+{
+  std::vector<float> vertices;
+  std::vector<unsigned int> indices;
+  createTriangleSoup(4u, vertices, indices);
+  auto original = triangleSet(vertices, indices);
+  EXPECT_EQ(96u, vertices.size() / 3u);
+
+  std::vector<unsigned int> remap;
+  unsigned int count =
+      MeshOptimizer::WeldVertices(vertices, 3u, indices, remap);
+
+  // a 4x4 quad grid has 5x5 unique vertices
+  EXPECT_EQ(25u, count);
+  EXPECT_EQ(25u * 3u, vertices.size());
+  EXPECT_EQ(96u, remap.size());
+  EXPECT_EQ(0u, remap[0]);
+  EXPECT_EQ(remap[0], remap[3]);
+  EXPECT_EQ(original, triangleSet(vertices, indices));
+
+  // welding again is a no-op
+  std::vector<unsigned int> indicesCopy = indices;
+  EXPECT_EQ(25u, MeshOptimizer::WeldVertices(vertices, 3u, indices, remap));
+  EXPECT_EQ(indicesCopy, indices);
+}
+
+/////////////////////////////////////////////////
+TEST(MeshOptimizerTest, VertexCache)
+{
+  std::vector<float> vertices;
+  std::vector<unsigned int> indices;
+  std::vector<unsigned int> remap;
+  createTriangleSoup(32u, vertices, indices);
+  unsigned int vertexCount =
+      MeshOptimizer::WeldVertices(vertices, 3u, indices, remap);
+  shuffleTriangles(indices);
+
+  auto original = triangleSet(vertices, indices);
+  double shuffledAcmr = MeshOptimizer::AverageCacheMissRatio(indices);
+  EXPECT_GT(shuffledAcmr, 2.0);
+
+  std::vector<unsigned int> optimized = indices;
+  MeshOptimizer::OptimizeVertexCache(optimized, vertexCount);
+  EXPECT_EQ(original, triangleSet(vertices, optimized));
+
+  // a regular grid has 2 triangles per vertex so the optimal ACMR is 0.5
+  double optimizedAcmr = MeshOptimizer::AverageCacheMissRatio(optimized);
+  EXPECT_LT(optimizedAcmr, 0.8);
+  EXPECT_LT(optimizedAcmr, shuffledAcmr * 0.5);
+  EXPECT_LT(MeshOptimizer::AverageTransformToVertexRatio(
+      optimized, vertexCount), 1.6);
+
+  // deterministic output
+  std::vector<unsigned int> optimized2 = indices;
+  MeshOptimizer::OptimizeVertexCache(optimized2, vertexCount);
+  EXPECT_EQ(optimized, optimized2);
+}
+
+/////////////////////////////////////////////////
+TEST(MeshOptimizerTest, Overdraw)
+{
+  std::vector<float> vertices;
+  std::vector<unsigned int> indices;
+  std::vector<unsigned int> remap;
+  createTriangleSoup(32u, vertices, indices);
+  unsigned int vertexCount =
+      MeshOptimizer::WeldVertices(vertices, 3u, indices, remap);
+  shuffleTriangles(indices);
+  MeshOptimizer::OptimizeVertexCache(indices, vertexCount);
+
+  auto original = triangleSet(vertices, indices);
+  double acmr = MeshOptimizer::AverageCacheMissRatio(indices);
+
+  MeshOptimizer::OptimizeOverdraw(indices, vertices, 3u);
+  EXPECT_EQ(original, triangleSet(vertices, indices));
+
+  // clusters start with a cold cache so reordering them costs little
+  EXPECT_LT(MeshOptimizer::AverageCacheMissRatio(indices), acmr * 1.1);
+}
+
+/////////////////////////////////////////////////
+TEST(MeshOptimizerTest, VertexFetch)
+{
+  // 5 vertices with 2 floats of payload, vertex 2 is unused
+  std::vector<float> vertices =
+  {
+    0, 0, 0, 0, 0,
+    1, 0, 0, 1, 1,
+    2, 0, 0, 2, 2,
+    3, 0, 0, 3, 3,
+    4, 0, 0, 4, 4
+  };
+  std::vector<unsigned int> indices = {4, 3, 0, 0, 1, 4};
+
+  std::vector<unsigned int> remap;
+  unsigned int count =
+      MeshOptimizer::OptimizeVertexFetch(vertices, 5u, indices, remap);
+  EXPECT_EQ(4u, count);
+  EXPECT_EQ(20u, vertices.size());
+
+  std::vector<unsigned int> expectedIndices = {0, 1, 2, 2, 3, 0};
+  EXPECT_EQ(expectedIndices, indices);
+
+  std::vector<unsigned int> expectedRemap =
+      {2, 3, MeshOptimizer::kUnused, 1, 0};
+  EXPECT_EQ(expectedRemap, remap);
+
+  EXPECT_FLOAT_EQ(4.0f, vertices[0]);
+  EXPECT_FLOAT_EQ(4.0f, vertices[4]);
+  EXPECT_FLOAT_EQ(3.0f, vertices[5]);
+  EXPECT_FLOAT_EQ(0.0f, vertices[10]);
+  EXPECT_FLOAT_EQ(1.0f, vertices[15]);
+}
+
+/////////////////////////////////////////////////
+TEST(MeshOptimizerTest, Optimize)
+{
+  std::vector<float> vertices;
+  std::vector<unsigned int> indices;
+  createTriangleSoup(16u, vertices, indices);
+  shuffleTriangles(indices);
+  auto original = triangleSet(vertices, indices);
+  unsigned int originalCount =
+      static_cast<unsigned int>(vertices.size() / 3u);
+
+  std::vector<unsigned int> remap;
+  unsigned int count = MeshOptimizer::Optimize(vertices, 3u, indices, remap);
+  EXPECT_EQ(17u * 17u, count);
+  EXPECT_EQ(originalCount, remap.size());
+  EXPECT_EQ(original, triangleSet(vertices, indices));
+  EXPECT_LT(MeshOptimizer::AverageCacheMissRatio(indices), 0.9);
+
+  // vertices are stored in order of first use
+  unsigned int next = 0u;
+  for (auto idx : indices)
+  {
+    EXPECT_LE(idx, next);
+    if (idx == next)
+      ++next;
+  }
+  EXPECT_EQ(count, next);
+}
+
+/////////////////////////////////////////////////
+TEST(MeshOptimizerTest, OptimizeSubMesh)
+{
+  // two triangles of a quad stored as an unindexed soup
+  common::SubMesh subMesh("quad");
+  subMesh.SetPrimitiveType(common::SubMesh::TRIANGLES);
+  subMesh.SetMaterialIndex(2u);
+  const double positions[6][2] = {{0, 0}, {1, 0}, {1, 1}, {0, 0}, {1, 1},
+      {0, 1}};
+  for (unsigned int i = 0; i < 6u; ++i)
+  {
+    subMesh.AddVertex(positions[i][0], positions[i][1], 0.0);
+    subMesh.AddNormal(0.0, 0.0, 1.0);
+    subMesh.AddTexCoord(positions[i][0], positions[i][1]);
+    subMesh.AddNodeAssignment(i, 0u, 1.0f);
+  }
+
+  common::SubMesh optimized = MeshOptimizer::Optimize(subMesh);
+  EXPECT_EQ("quad", optimized.Name());
+  EXPECT_EQ(common::SubMesh::TRIANGLES, optimized.SubMeshPrimitiveType());
+  EXPECT_EQ(2, optimized.MaterialIndex());
+  EXPECT_EQ(6u, optimized.IndexCount());
+
+  // skinned sub-meshes are not welded
+  EXPECT_EQ(6u, optimized.VertexCount());
+  EXPECT_EQ(6u, optimized.NodeAssignmentsCount());
+
+  // without node assignments duplicate vertices are welded
+  common::SubMesh staticMesh("static");
+  staticMesh.SetPrimitiveType(common::SubMesh::TRIANGLES);
+  for (unsigned int i = 0; i < 6u; ++i)
+  {
+    staticMesh.AddVertex(positions[i][0], positions[i][1], 0.0);
+    staticMesh.AddNormal(0.0, 0.0, 1.0);
+    staticMesh.AddTexCoord(positions[i][0], positions[i][1]);
+  }
+  common::SubMesh welded = MeshOptimizer::Optimize(staticMesh);
+  EXPECT_EQ(4u, welded.VertexCount());
+  EXPECT_EQ(4u, welded.NormalCount());
+  EXPECT_EQ(4u, welded.TexCoordCount());
+  EXPECT_EQ(6u, welded.IndexCount());
+  for (unsigned int i = 0; i < welded.IndexCount(); ++i)
+  {
+    unsigned int idx = static_cast<unsigned int>(welded.Index(i));
+    EXPECT_DOUBLE_EQ(welded.Vertex(idx).X(), welded.TexCoord(idx).X());
+    EXPECT_DOUBLE_EQ(welded.Vertex(idx).Y(), welded.TexCoord(idx).Y());
+  }
+
+  // non triangle list sub-meshes are returned unchanged
+  common::SubMesh lines("lines");
+  lines.SetPrimitiveType(common::SubMesh::LINES);
+  lines.AddVertex(0.0, 0.0, 0.0);
+  lines.AddVertex(1.0, 0.0, 0.0);
+  common::SubMesh unchanged = MeshOptimizer::Optimize(lines);
+  EXPECT_EQ(2u, unchanged.VertexCount());
+  EXPECT_EQ(0u, unchanged.IndexCount());
+}
+
+//////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
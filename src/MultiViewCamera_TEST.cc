@@ -0,0 +1,227 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+#include <ignition/math/Helpers.hh>
+
+#include "test_config.h"  // NOLINT(build/include)
+#include "ignition/rendering/Image.hh"
+#include "ignition/rendering/MultiViewCamera.hh"
+#include "ignition/rendering/RenderEngine.hh"
+#include "ignition/rendering/RenderingIface.hh"
+#include "ignition/rendering/Scene.hh"
+#include "ignition/rendering/Visual.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+class MultiViewCameraTest : public testing::Test,
+                            public testing::WithParamInterface<const char *>
+{
+  /// \brief Test adding, moving and removing views
+  public: void Views(const std::string &_renderEngine);
+
+  /// \brief Test that the views match separate cameras
+  public: void StereoImage(const std::string &_renderEngine);
+};
+
+/////////////////////////////////////////////////
+void MultiViewCameraTest::Views(const std::string &_renderEngine)
+{
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+           << "' is not supported" << std::endl;
+    return;
+  }
+
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+
+  MultiViewCameraPtr camera = scene->CreateMultiViewCamera();
+  if (!camera)
+  {
+    igndbg << "Multi-view camera not supported yet in rendering engine: "
+           << _renderEngine << std::endl;
+    engine->DestroyScene(scene);
+    rendering::unloadEngine(engine->Name());
+    return;
+  }
+  EXPECT_EQ(0u, camera->ViewCount());
+
+  math::Pose3d left(0, 0.1, 0, 0, 0, 0);
+  math::Pose3d right(0, -0.1, 0, 0, 0, 0);
+  EXPECT_EQ(0u, camera->AddView(left));
+  EXPECT_EQ(1u, camera->AddView(right));
+  EXPECT_EQ(2u, camera->ViewCount());
+  EXPECT_EQ(left, camera->ViewPose(0u));
+  EXPECT_EQ(right, camera->ViewPose(1u));
+
+  math::Pose3d turned(0, 0.1, 0, 0, 0, 0.2);
+  camera->SetViewPose(0u, turned);
+  EXPECT_EQ(turned, camera->ViewPose(0u));
+
+  // out of range indices are ignored
+  camera->SetViewPose(2u, left);
+  EXPECT_EQ(2u, camera->ViewCount());
+  EXPECT_EQ(math::Pose3d::Zero, camera->ViewPose(2u));
+
+  // views can be changed after rendering
+  camera->SetImageWidth(160u);
+  camera->SetImageHeight(60u);
+  scene->RootVisual()->AddChild(camera);
+  Image image = camera->CreateImage();
+  camera->Capture(image);
+  camera->AddView(math::Pose3d::Zero);
+  camera->Capture(image);
+  EXPECT_EQ(3u, camera->ViewCount());
+
+  camera->ClearViews();
+  EXPECT_EQ(0u, camera->ViewCount());
+  camera->Capture(image);
+
+  // a ring of views that do not overlap
+  for (unsigned int i = 0u; i < 4u; ++i)
+    camera->AddView(math::Pose3d(0, 0, 0, 0, 0, i * IGN_PI / 2.0));
+  camera->Capture(image);
+  EXPECT_EQ(4u, camera->ViewCount());
+
+  // occlusion culling is not supported
+  camera->SetOcclusionCulling(true);
+  EXPECT_FALSE(camera->OcclusionCulling());
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+void MultiViewCameraTest::StereoImage(const std::string &_renderEngine)
+{
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+           << "' is not supported" << std::endl;
+    return;
+  }
+
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+  scene->SetBackgroundColor(0.0, 0.0, 1.0);
+
+  MultiViewCameraPtr camera = scene->CreateMultiViewCamera();
+  if (!camera)
+  {
+    engine->DestroyScene(scene);
+    rendering::unloadEngine(engine->Name());
+    return;
+  }
+
+  for (int i = 0; i < 3; ++i)
+  {
+    VisualPtr box = scene->CreateVisual();
+    box->AddGeometry(scene->CreateBox());
+    box->SetLocalPosition(0.0, i - 1.0, i * 0.5);
+    box->SetMaterial(i == 1 ? "Default/TransRed" : "Default/TransGreen");
+    scene->RootVisual()->AddChild(box);
+  }
+
+  // a stereo pair with a 0.2 m baseline, each view is 80x60
+  const unsigned int viewWidth = 80u;
+  const unsigned int height = 60u;
+  math::Pose3d rigPose(-3.0, 0.0, 0.5, 0.0, 0.0, 0.0);
+  std::vector<math::Pose3d> viewPoses = {
+      math::Pose3d(0.0, 0.1, 0.0, 0.0, 0.0, 0.0),
+      math::Pose3d(0.0, -0.1, 0.0, 0.0, 0.0, 0.05)};
+  camera->SetImageWidth(viewWidth * 2u);
+  camera->SetImageHeight(height);
+  camera->SetLocalPose(rigPose);
+  for (const auto &pose : viewPoses)
+    camera->AddView(pose);
+  scene->RootVisual()->AddChild(camera);
+
+  // separate cameras at the poses of the views
+  std::vector<CameraPtr> cameras;
+  for (const auto &pose : viewPoses)
+  {
+    CameraPtr single = scene->CreateCamera();
+    single->SetImageWidth(viewWidth);
+    single->SetImageHeight(height);
+    single->SetLocalPose(pose * rigPose);
+    scene->RootVisual()->AddChild(single);
+    cameras.push_back(single);
+  }
+
+  Image image = camera->CreateImage();
+  EXPECT_EQ(viewWidth * 2u, image.Width());
+  camera->Capture(image);
+  const unsigned char *data = image.Data<unsigned char>();
+
+  // each view is packed next to the previous one in the image
+  for (unsigned int v = 0u; v < cameras.size(); ++v)
+  {
+    Image expected = cameras[v]->CreateImage();
+    cameras[v]->Capture(expected);
+    const unsigned char *expectedData = expected.Data<unsigned char>();
+    unsigned int different = 0u;
+    for (unsigned int y = 0u; y < height; ++y)
+    {
+      for (unsigned int x = 0u; x < viewWidth * 3u; ++x)
+      {
+        unsigned int idx = y * viewWidth * 2u * 3u + v * viewWidth * 3u + x;
+        unsigned int expectedIdx = y * viewWidth * 3u + x;
+        if (std::abs(data[idx] - expectedData[expectedIdx]) > 1)
+          ++different;
+      }
+    }
+    EXPECT_EQ(0u, different) << "view " << v;
+  }
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+TEST_P(MultiViewCameraTest, Views)
+{
+  Views(GetParam());
+}
+
+/////////////////////////////////////////////////
+TEST_P(MultiViewCameraTest, StereoImage)
+{
+  StereoImage(GetParam());
+}
+
+INSTANTIATE_TEST_CASE_P(MultiViewCamera, MultiViewCameraTest,
+    RENDER_ENGINE_VALUES,
+    ignition::rendering::PrintToStringParam());
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
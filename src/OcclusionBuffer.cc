@@ -0,0 +1,358 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "ignition/rendering/OcclusionBuffer.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+/// \brief Vertex indices of the 12 triangles of a box, where bit 0, 1 and
+/// 2 of a vertex index select the max x, y and z coordinate
+static const unsigned int kBoxTriangles[12][3] =
+{
+  {0, 2, 1}, {1, 2, 3},
+  {4, 5, 6}, {5, 7, 6},
+  {0, 1, 4}, {1, 5, 4},
+  {2, 6, 3}, {3, 6, 7},
+  {0, 4, 2}, {2, 4, 6},
+  {1, 3, 5}, {3, 7, 5}
+};
+
+/// \brief A vertex in clip space
+struct ClipVertex
+{
+  /// \brief Homogeneous coordinates
+  double v[4];
+};
+
+/// \brief Private data for the OcclusionBuffer class
+class ignition::rendering::OcclusionBufferPrivate
+{
+  /// \brief Rasterize a triangle given in screen space
+  /// \param[in] _v0 First vertex: x and y in pixels, z in normalized device
+  /// coordinates
+  /// \param[in] _v1 Second vertex
+  /// \param[in] _v2 Third vertex
+  public: void RasterizeTriangle(const double _v0[3], const double _v1[3],
+      const double _v2[3]);
+
+  /// \brief Width of the depth buffer
+  public: unsigned int width = 64u;
+
+  /// \brief Height of the depth buffer
+  public: unsigned int height = 64u;
+
+  /// \brief View projection matrix of the camera
+  public: math::Matrix4d viewProj;
+
+  /// \brief Hi-Z pyramid. Level 0 is the depth buffer, each texel of the
+  /// next levels holds the farthest depth of the 2x2 texels below it.
+  public: std::vector<std::vector<float>> levels;
+};
+
+//////////////////////////////////////////////////
+/// \brief Transform a point to clip space
+/// \param[in] _m Transform
+/// \param[in] _p Point
+/// \param[out] _out Clip space point
+static void toClip(const math::Matrix4d &_m, const double _p[3],
+    ClipVertex &_out)
+{
+  for (unsigned int r = 0; r < 4; ++r)
+  {
+    _out.v[r] = _m(r, 0) * _p[0] + _m(r, 1) * _p[1] + _m(r, 2) * _p[2] +
+        _m(r, 3);
+  }
+}
+
+//////////////////////////////////////////////////
+OcclusionBuffer::OcclusionBuffer()
+  : dataPtr(new OcclusionBufferPrivate)
+{
+  this->Resize(this->dataPtr->width, this->dataPtr->height);
+}
+
+//////////////////////////////////////////////////
+OcclusionBuffer::~OcclusionBuffer()
+{
+}
+
+//////////////////////////////////////////////////
+void OcclusionBuffer::Resize(unsigned int _width, unsigned int _height)
+{
+  this->dataPtr->width = std::max(_width, 1u);
+  this->dataPtr->height = std::max(_height, 1u);
+
+  this->dataPtr->levels.clear();
+  unsigned int level = 0u;
+  while (true)
+  {
+    unsigned int w = (this->dataPtr->width + (1u << level) - 1u) >> level;
+    unsigned int h = (this->dataPtr->height + (1u << level) - 1u) >> level;
+    this->dataPtr->levels.push_back(std::vector<float>(w * h, 1.0f));
+    if (w == 1u && h == 1u)
+      break;
+    ++level;
+  }
+}
+
+//////////////////////////////////////////////////
+unsigned int OcclusionBuffer::Width() const
+{
+  return this->dataPtr->width;
+}
+
+//////////////////////////////////////////////////
+unsigned int OcclusionBuffer::Height() const
+{
+  return this->dataPtr->height;
+}
+
+//////////////////////////////////////////////////
+void OcclusionBuffer::Clear(const math::Matrix4d &_viewProjection)
+{
+  this->dataPtr->viewProj = _viewProjection;
+  for (auto &level : this->dataPtr->levels)
+    std::fill(level.begin(), level.end(), 1.0f);
+}
+
+//////////////////////////////////////////////////
+void OcclusionBuffer::AddOccluder(const math::AxisAlignedBox &_box,
+    const math::Matrix4d &_transform)
+{
+  if (_box.Min().X() > _box.Max().X() || _box.Min().Y() > _box.Max().Y() ||
+      _box.Min().Z() > _box.Max().Z())
+  {
+    return;
+  }
+
+  math::Matrix4d m = this->dataPtr->viewProj * _transform;
+  ClipVertex corners[8];
+  for (unsigned int c = 0; c < 8; ++c)
+  {
+    double p[3] = {
+        (c & 1) ? _box.Max().X() : _box.Min().X(),
+        (c & 2) ? _box.Max().Y() : _box.Min().Y(),
+        (c & 4) ? _box.Max().Z() : _box.Min().Z()};
+    toClip(m, p, corners[c]);
+  }
+
+  double w = this->dataPtr->width;
+  double h = this->dataPtr->height;
+  for (const auto &tri : kBoxTriangles)
+  {
+    // clip the triangle against the near plane, z + w >= 0
+    ClipVertex poly[4];
+    unsigned int count = 0u;
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+      const ClipVertex &a = corners[tri[i]];
+      const ClipVertex &b = corners[tri[(i + 1) % 3]];
+      double da = a.v[2] + a.v[3];
+      double db = b.v[2] + b.v[3];
+      if (da >= 0.0)
+        poly[count++] = a;
+      if ((da >= 0.0) != (db >= 0.0))
+      {
+        double t = da / (da - db);
+        for (unsigned int k = 0; k < 4; ++k)
+          poly[count].v[k] = a.v[k] + t * (b.v[k] - a.v[k]);
+        ++count;
+      }
+    }
+    if (count < 3u)
+      continue;
+
+    // project to screen space
+    double screen[4][3];
+    bool valid = true;
+    for (unsigned int i = 0; i < count; ++i)
+    {
+      double pw = poly[i].v[3];
+      if (pw <= 1e-12)
+      {
+        valid = false;
+        break;
+      }
+      screen[i][0] = (poly[i].v[0] / pw * 0.5 + 0.5) * w;
+      screen[i][1] = (poly[i].v[1] / pw * 0.5 + 0.5) * h;
+      screen[i][2] = poly[i].v[2] / pw;
+    }
+    if (!valid)
+      continue;
+
+    for (unsigned int i = 2; i < count; ++i)
+      this->dataPtr->RasterizeTriangle(screen[0], screen[i - 1], screen[i]);
+  }
+}
+
+//////////////////////////////////////////////////
+void OcclusionBufferPrivate::RasterizeTriangle(const double _v0[3],
+    const double _v1[3], const double _v2[3])
+{
+  double area = (_v1[0] - _v0[0]) * (_v2[1] - _v0[1]) -
+      (_v1[1] - _v0[1]) * (_v2[0] - _v0[0]);
+  if (std::fabs(area) < 1e-12)
+    return;
+  double invArea = 1.0 / area;
+
+  double minX = std::min({_v0[0], _v1[0], _v2[0]});
+  double maxX = std::max({_v0[0], _v1[0], _v2[0]});
+  double minY = std::min({_v0[1], _v1[1], _v2[1]});
+  double maxY = std::max({_v0[1], _v1[1], _v2[1]});
+  if (maxX < 0.0 || maxY < 0.0 || minX >= this->width ||
+      minY >= this->height)
+  {
+    return;
+  }
+
+  // pixels whose centers are covered by the triangle
+  int x0 = std::max(0, static_cast<int>(std::ceil(minX - 0.5)));
+  int x1 = std::min(static_cast<int>(this->width) - 1,
+      static_cast<int>(std::floor(maxX - 0.5)));
+  int y0 = std::max(0, static_cast<int>(std::ceil(minY - 0.5)));
+  int y1 = std::min(static_cast<int>(this->height) - 1,
+      static_cast<int>(std::floor(maxY - 0.5)));
+
+  std::vector<float> &depth = this->levels[0];
+  for (int y = y0; y <= y1; ++y)
+  {
+    double py = y + 0.5;
+    for (int x = x0; x <= x1; ++x)
+    {
+      double px = x + 0.5;
+      double b0 = ((_v1[0] - px) * (_v2[1] - py) -
+          (_v1[1] - py) * (_v2[0] - px)) * invArea;
+      double b1 = ((_v2[0] - px) * (_v0[1] - py) -
+          (_v2[1] - py) * (_v0[0] - px)) * invArea;
+      double b2 = 1.0 - b0 - b1;
+      if (b0 < 0.0 || b1 < 0.0 || b2 < 0.0)
+        continue;
+
+      float z = static_cast<float>(b0 * _v0[2] + b1 * _v1[2] + b2 * _v2[2]);
+      float &d = depth[y * this->width + x];
+      if (z < d)
+        d = z;
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+void OcclusionBuffer::BuildPyramid()
+{
+  auto &levels = this->dataPtr->levels;
+  for (unsigned int l = 1; l < levels.size(); ++l)
+  {
+    unsigned int srcW = (this->dataPtr->width + (1u << (l - 1)) - 1u) >>
+        (l - 1);
+    unsigned int srcH = (this->dataPtr->height + (1u << (l - 1)) - 1u) >>
+        (l - 1);
+    unsigned int dstW = (srcW + 1u) / 2u;
+    unsigned int dstH = (srcH + 1u) / 2u;
+    const std::vector<float> &src = levels[l - 1];
+    std::vector<float> &dst = levels[l];
+    for (unsigned int y = 0; y < dstH; ++y)
+    {
+      unsigned int sy0 = 2u * y;
+      unsigned int sy1 = std::min(sy0 + 1u, srcH - 1u);
+      for (unsigned int x = 0; x < dstW; ++x)
+      {
+        unsigned int sx0 = 2u * x;
+        unsigned int sx1 = std::min(sx0 + 1u, srcW - 1u);
+        dst[y * dstW + x] = std::max(
+            std::max(src[sy0 * srcW + sx0], src[sy0 * srcW + sx1]),
+            std::max(src[sy1 * srcW + sx0], src[sy1 * srcW + sx1]));
+      }
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+bool OcclusionBuffer::IsOccluded(const math::AxisAlignedBox &_box) const
+{
+  if (_box.Min().X() > _box.Max().X() || _box.Min().Y() > _box.Max().Y() ||
+      _box.Min().Z() > _box.Max().Z())
+  {
+    return false;
+  }
+
+  double minX = std::numeric_limits<double>::max();
+  double minY = std::numeric_limits<double>::max();
+  double minZ = std::numeric_limits<double>::max();
+  double maxX = std::numeric_limits<double>::lowest();
+  double maxY = std::numeric_limits<double>::lowest();
+  for (unsigned int c = 0; c < 8; ++c)
+  {
+    double p[3] = {
+        (c & 1) ? _box.Max().X() : _box.Min().X(),
+        (c & 2) ? _box.Max().Y() : _box.Min().Y(),
+        (c & 4) ? _box.Max().Z() : _box.Min().Z()};
+    ClipVertex clip;
+    toClip(this->dataPtr->viewProj, p, clip);
+
+    // the box reaches the camera
+    if (clip.v[2] + clip.v[3] < 0.0 || clip.v[3] <= 1e-12)
+      return false;
+
+    double x = clip.v[0] / clip.v[3];
+    double y = clip.v[1] / clip.v[3];
+    double z = clip.v[2] / clip.v[3];
+    minX = std::min(minX, x);
+    maxX = std::max(maxX, x);
+    minY = std::min(minY, y);
+    maxY = std::max(maxY, y);
+    minZ = std::min(minZ, z);
+  }
+
+  if (maxX < -1.0 || minX > 1.0 || maxY < -1.0 || minY > 1.0 || minZ > 1.0)
+    return false;
+
+  // screen rectangle in pixels
+  int w = static_cast<int>(this->dataPtr->width);
+  int h = static_cast<int>(this->dataPtr->height);
+  int x0 = std::max(0, static_cast<int>(std::floor((minX * 0.5 + 0.5) * w)));
+  int x1 = std::min(w - 1,
+      static_cast<int>(std::floor((maxX * 0.5 + 0.5) * w)));
+  int y0 = std::max(0, static_cast<int>(std::floor((minY * 0.5 + 0.5) * h)));
+  int y1 = std::min(h - 1,
+      static_cast<int>(std::floor((maxY * 0.5 + 0.5) * h)));
+
+  // pick the level where the rectangle covers at most 2x2 texels, plus one
+  // more along each axis when it is not aligned
+  int size = std::max(x1 - x0, y1 - y0) + 1;
+  unsigned int level = 0u;
+  while ((size >> level) > 2 && level + 1u < this->dataPtr->levels.size())
+    ++level;
+
+  const std::vector<float> &depth = this->dataPtr->levels[level];
+  int levelW = (w + (1 << level) - 1) >> level;
+  float boxDepth = static_cast<float>(minZ);
+  for (int y = y0 >> level; y <= y1 >> level; ++y)
+  {
+    for (int x = x0 >> level; x <= x1 >> level; ++x)
+    {
+      if (boxDepth <= depth[y * levelW + x])
+        return false;
+    }
+  }
+  return true;
+}
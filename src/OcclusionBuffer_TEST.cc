@@ -0,0 +1,121 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include "ignition/rendering/OcclusionBuffer.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+/////////////////////////////////////////////////
+/// \brief Perspective projection with a 90 degree field of view looking
+/// down the -z axis from the origin
+math::Matrix4d projection()
+{
+  double n = 0.1;
+  double f = 100.0;
+  return math::Matrix4d(
+      1, 0, 0, 0,
+      0, 1, 0, 0,
+      0, 0, -(f + n) / (f - n), -2 * f * n / (f - n),
+      0, 0, -1, 0);
+}
+
+/////////////////////////////////////////////////
+/// \brief Create a translation matrix
+math::Matrix4d translation(double _x, double _y, double _z)
+{
+  return math::Matrix4d(
+      1, 0, 0, _x,
+      0, 1, 0, _y,
+      0, 0, 1, _z,
+      0, 0, 0, 1);
+}
+
+/////////////////////////////////////////////////
+TEST(OcclusionBufferTest, Resize)
+{
+  OcclusionBuffer buffer;
+  buffer.Resize(128u, 96u);
+  EXPECT_EQ(128u, buffer.Width());
+  EXPECT_EQ(96u, buffer.Height());
+
+  buffer.Resize(0u, 0u);
+  EXPECT_EQ(1u, buffer.Width());
+  EXPECT_EQ(1u, buffer.Height());
+}
+
+/////////////////////////////////////////////////
+TEST(OcclusionBufferTest, Wall)
+{
+  OcclusionBuffer buffer;
+  buffer.Resize(64u, 48u);
+  buffer.Clear(projection());
+
+  math::AxisAlignedBox behind(math::Vector3d(-0.5, -0.5, -11),
+      math::Vector3d(0.5, 0.5, -10));
+  math::AxisAlignedBox inFront(math::Vector3d(-0.5, -0.5, -3),
+      math::Vector3d(0.5, 0.5, -2));
+  math::AxisAlignedBox aside(math::Vector3d(5, -0.5, -11),
+      math::Vector3d(6, 0.5, -10));
+  math::AxisAlignedBox peeking(math::Vector3d(3.5, -0.5, -11),
+      math::Vector3d(4.5, 0.5, -10));
+  math::AxisAlignedBox nearPlane(math::Vector3d(-0.5, -0.5, -1),
+      math::Vector3d(0.5, 0.5, 1));
+
+  // nothing is occluded without occluders
+  buffer.BuildPyramid();
+  EXPECT_FALSE(buffer.IsOccluded(behind));
+  EXPECT_FALSE(buffer.IsOccluded(inFront));
+
+  // 4x4 wall at a distance of 5
+  math::AxisAlignedBox wall(math::Vector3d(-2, -2, -0.05),
+      math::Vector3d(2, 2, 0.05));
+  buffer.AddOccluder(wall, translation(0, 0, -5));
+  buffer.BuildPyramid();
+  EXPECT_TRUE(buffer.IsOccluded(behind));
+  EXPECT_FALSE(buffer.IsOccluded(inFront));
+  EXPECT_FALSE(buffer.IsOccluded(aside));
+  EXPECT_FALSE(buffer.IsOccluded(peeking));
+  EXPECT_FALSE(buffer.IsOccluded(nearPlane));
+  EXPECT_FALSE(buffer.IsOccluded(math::AxisAlignedBox()));
+
+  // clearing removes the occluders
+  buffer.Clear(projection());
+  buffer.AddOccluder(wall, translation(10, 0, -5));
+  buffer.BuildPyramid();
+  EXPECT_FALSE(buffer.IsOccluded(behind));
+
+  // occluders that cross the near plane are clipped
+  buffer.Clear(projection());
+  math::AxisAlignedBox floor(math::Vector3d(-50, -1.1, -50),
+      math::Vector3d(50, -1, 50));
+  math::AxisAlignedBox underFloor(math::Vector3d(-0.5, -3, -11),
+      math::Vector3d(0.5, -2, -10));
+  buffer.AddOccluder(floor, math::Matrix4d::Identity);
+  buffer.BuildPyramid();
+  EXPECT_TRUE(buffer.IsOccluded(underFloor));
+  EXPECT_FALSE(buffer.IsOccluded(behind));
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
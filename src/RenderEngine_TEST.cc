@@ -17,12 +17,16 @@
 
 #include <gtest/gtest.h>
 
+#include <map>
+#include <string>
+
 #include <ignition/common/Console.hh>
 
 #include "test_config.h"  // NOLINT(build/include)
 
 #include "ignition/rendering/RenderingIface.hh"
 #include "ignition/rendering/Scene.hh"
+#include "ignition/rendering/Visual.hh"
 #include "ignition/rendering/RenderEngine.hh"
 
 using namespace ignition;
@@ -32,6 +36,9 @@ class RenderEngineTest : public testing::Test,
                   public testing::WithParamInterface<const char *>
 {
   public: void RenderEngine(const std::string &_renderEngine);
+
+  /// \brief Test the scene manager parameter of the ogre engine
+  public: void SceneManagerParam(const std::string &_renderEngine);
 };
 
 /////////////////////////////////////////////////
@@ -133,12 +140,55 @@ void RenderEngineTest::RenderEngine(const std::string &_renderEngine)
   rendering::unloadEngine(engine->Name());
 }
 
+/////////////////////////////////////////////////
+void RenderEngineTest::SceneManagerParam(const std::string &_renderEngine)
+{
+  // only the ogre engine selects its scene manager from the parameters
+  if (_renderEngine != "ogre")
+    return;
+
+  // scenes are created with the default, generic and octree scene
+  // managers, and unknown values are ignored. The type of each scene
+  // manager, and the fallback when the octree plugin is missing, are
+  // checked in ogre/src/OgreScene_TEST.cc
+  for (const std::string value : {"", "generic", "octree", "bsp"})
+  {
+    std::map<std::string, std::string> params;
+    if (!value.empty())
+      params["sceneManager"] = value;
+    auto engine = rendering::engine(_renderEngine, params);
+    if (!engine)
+    {
+      igndbg << "Engine '" << _renderEngine
+             << "' is not supported" << std::endl;
+      return;
+    }
+
+    auto scene = engine->CreateScene("scene");
+    ASSERT_NE(nullptr, scene) << value;
+    auto visual = scene->CreateVisual();
+    ASSERT_NE(nullptr, visual) << value;
+    scene->RootVisual()->AddChild(visual);
+    EXPECT_EQ(1u, scene->RootVisual()->ChildCount()) << value;
+
+    // Clean up
+    engine->DestroyScene(scene);
+    rendering::unloadEngine(engine->Name());
+  }
+}
+
 /////////////////////////////////////////////////
 TEST_P(RenderEngineTest, RenderEngine)
 {
   RenderEngine(GetParam());
 }
 
+/////////////////////////////////////////////////
+TEST_P(RenderEngineTest, SceneManagerParam)
+{
+  SceneManagerParam(GetParam());
+}
+
 INSTANTIATE_TEST_CASE_P(RenderEngine, RenderEngineTest,
     RENDER_ENGINE_VALUES,
     ignition::rendering::PrintToStringParam());
@@ -28,6 +28,7 @@
 #include "ignition/rendering/RenderPassSystem.hh"
 #include "ignition/rendering/RenderTarget.hh"
 #include "ignition/rendering/Scene.hh"
+#include "ignition/rendering/Visual.hh"
 
 using namespace ignition;
 using namespace rendering;
@@ -43,6 +44,9 @@ class RenderTargetTest : public testing::Test,
 
   /// \brief test adding and removing render passes
   public: void AddRemoveRenderPass(const std::string &_renderEngine);
+
+  /// \brief test dynamic resolution properties
+  public: void DynamicResolution(const std::string &_renderEngine);
 };
 
 /////////////////////////////////////////////////
@@ -181,6 +185,79 @@ void RenderTargetTest::AddRemoveRenderPass(const std::string &_renderEngine)
   EXPECT_EQ(pass2, renderTexture->RenderPassByIndex(0u));
 }
 
+/////////////////////////////////////////////////
+void RenderTargetTest::DynamicResolution(const std::string &_renderEngine)
+{
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+  ScenePtr scene = engine->CreateScene("scene");
+
+  CameraPtr camera = scene->CreateCamera("camera");
+  camera->SetImageWidth(320u);
+  camera->SetImageHeight(240u);
+  scene->RootVisual()->AddChild(camera);
+
+  // default properties
+  EXPECT_FALSE(camera->DynamicResolution());
+  EXPECT_DOUBLE_EQ(1.0 / 30.0, camera->TargetFrameTime());
+  EXPECT_DOUBLE_EQ(0.5, camera->MinResolutionScale());
+  EXPECT_DOUBLE_EQ(1.0, camera->MaxResolutionScale());
+  EXPECT_DOUBLE_EQ(1.0, camera->ResolutionScale());
+
+  camera->SetTargetFrameTime(1.0 / 60.0);
+  camera->SetResolutionScaleRange(0.25, 0.75);
+  EXPECT_DOUBLE_EQ(1.0 / 60.0, camera->TargetFrameTime());
+  EXPECT_DOUBLE_EQ(0.25, camera->MinResolutionScale());
+  EXPECT_DOUBLE_EQ(0.75, camera->MaxResolutionScale());
+
+  // only ogre2 renders at a lower resolution, other engines report the
+  // full resolution
+  const bool scales = _renderEngine == "ogre2";
+  const double forced = scales ? 0.5 : 1.0;
+
+  // a forced scale stays the same whatever the frame time, and the image
+  // keeps the full resolution
+  camera->SetResolutionScale(0.5);
+  Image image = camera->CreateImage();
+  for (unsigned int i = 0u; i < 10u; ++i)
+  {
+    camera->Capture(image);
+    EXPECT_DOUBLE_EQ(forced, camera->ResolutionScale());
+  }
+  EXPECT_EQ(320u, image.Width());
+  EXPECT_EQ(240u, image.Height());
+
+  // dynamic scale starts at the maximum and stays within the range
+  camera->SetDynamicResolution(true);
+  EXPECT_TRUE(camera->DynamicResolution());
+  EXPECT_DOUBLE_EQ(scales ? 0.75 : 1.0, camera->ResolutionScale());
+  for (unsigned int i = 0u; i < 10u; ++i)
+  {
+    camera->Capture(image);
+    if (scales)
+    {
+      EXPECT_LE(0.25, camera->ResolutionScale());
+      EXPECT_GE(0.75, camera->ResolutionScale());
+    }
+    else
+    {
+      EXPECT_DOUBLE_EQ(1.0, camera->ResolutionScale());
+    }
+  }
+
+  camera->SetDynamicResolution(false);
+  EXPECT_DOUBLE_EQ(forced, camera->ResolutionScale());
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
 /////////////////////////////////////////////////
 TEST_P(RenderTargetTest, RenderTexture)
 {
@@ -199,6 +276,12 @@ TEST_P(RenderTargetTest, AddRemoveRenderPass)
   AddRemoveRenderPass(GetParam());
 }
 
+/////////////////////////////////////////////////
+TEST_P(RenderTargetTest, DynamicResolution)
+{
+  DynamicResolution(GetParam());
+}
+
 
 INSTANTIATE_TEST_CASE_P(RenderTarget, RenderTargetTest,
     RENDER_ENGINE_VALUES,
@@ -0,0 +1,248 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#include <ignition/common/Console.hh>
+
+#include "ignition/rendering/ResolutionScaler.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+/// \brief Lowest scale that can be set
+static const double kMinScale = 0.1;
+
+/// \brief Size of a scale change
+static const double kScaleStep = 0.05;
+
+/// \brief Largest increase of the scale in one change
+static const double kMaxIncrease = 0.1;
+
+/// \brief Weight of a new frame time in the average
+static const double kSmoothing = 0.2;
+
+/// \brief Number of frames averaged before the scale can change
+static const unsigned int kMinSamples = 5u;
+
+/// \brief Number of frames ignored after a change, while the render
+/// target is rebuilt at the new resolution
+static const unsigned int kCooldownFrames = 10u;
+
+/// \brief The scale goes down when frames are slower than this fraction
+/// of the target
+static const double kDecreaseThreshold = 1.1;
+
+/// \brief The scale goes up when frames are faster than this fraction of
+/// the target
+static const double kIncreaseThreshold = 0.8;
+
+/// \brief Private data for the ResolutionScaler class
+class ignition::rendering::ResolutionScalerPrivate
+{
+  /// \brief Clamp a scale to the valid range
+  /// \param[in] _scale Scale to clamp
+  /// \return Clamped scale
+  public: static double Clamp(double _scale);
+
+  /// \brief True if the scale adapts to the frame time
+  public: bool dynamic = false;
+
+  /// \brief Target frame time in seconds
+  public: double targetFrameTime = 1.0 / 30.0;
+
+  /// \brief Minimum dynamic scale
+  public: double minScale = 0.5;
+
+  /// \brief Maximum dynamic scale
+  public: double maxScale = 1.0;
+
+  /// \brief Scale used when not dynamic
+  public: double fixedScale = 1.0;
+
+  /// \brief Current dynamic scale
+  public: double dynamicScale = 1.0;
+
+  /// \brief Exponential moving average of the frame time
+  public: double averageFrameTime = 0.0;
+
+  /// \brief Number of frame times in the average
+  public: unsigned int sampleCount = 0u;
+
+  /// \brief Frames left to ignore after a change
+  public: unsigned int cooldown = 0u;
+};
+
+//////////////////////////////////////////////////
+double ResolutionScalerPrivate::Clamp(double _scale)
+{
+  return std::max(kMinScale, std::min(1.0, _scale));
+}
+
+//////////////////////////////////////////////////
+ResolutionScaler::ResolutionScaler()
+  : dataPtr(new ResolutionScalerPrivate)
+{
+}
+
+//////////////////////////////////////////////////
+ResolutionScaler::~ResolutionScaler()
+{
+}
+
+//////////////////////////////////////////////////
+void ResolutionScaler::SetDynamic(bool _dynamic)
+{
+  if (_dynamic == this->dataPtr->dynamic)
+    return;
+
+  this->dataPtr->dynamic = _dynamic;
+  this->dataPtr->dynamicScale = this->dataPtr->maxScale;
+  this->Reset();
+}
+
+//////////////////////////////////////////////////
+bool ResolutionScaler::Dynamic() const
+{
+  return this->dataPtr->dynamic;
+}
+
+//////////////////////////////////////////////////
+void ResolutionScaler::SetTargetFrameTime(double _seconds)
+{
+  if (_seconds <= 0.0)
+  {
+    ignerr << "Target frame time must be positive" << std::endl;
+    return;
+  }
+  this->dataPtr->targetFrameTime = _seconds;
+  this->Reset();
+}
+
+//////////////////////////////////////////////////
+double ResolutionScaler::TargetFrameTime() const
+{
+  return this->dataPtr->targetFrameTime;
+}
+
+//////////////////////////////////////////////////
+void ResolutionScaler::SetScaleRange(double _min, double _max)
+{
+  this->dataPtr->minScale = ResolutionScalerPrivate::Clamp(_min);
+  this->dataPtr->maxScale = std::max(this->dataPtr->minScale,
+      ResolutionScalerPrivate::Clamp(_max));
+  this->dataPtr->dynamicScale = std::max(this->dataPtr->minScale,
+      std::min(this->dataPtr->maxScale, this->dataPtr->dynamicScale));
+  this->Reset();
+}
+
+//////////////////////////////////////////////////
+double ResolutionScaler::MinScale() const
+{
+  return this->dataPtr->minScale;
+}
+
+//////////////////////////////////////////////////
+double ResolutionScaler::MaxScale() const
+{
+  return this->dataPtr->maxScale;
+}
+
+//////////////////////////////////////////////////
+void ResolutionScaler::SetFixedScale(double _scale)
+{
+  this->dataPtr->fixedScale = ResolutionScalerPrivate::Clamp(_scale);
+}
+
+//////////////////////////////////////////////////
+double ResolutionScaler::FixedScale() const
+{
+  return this->dataPtr->fixedScale;
+}
+
+//////////////////////////////////////////////////
+double ResolutionScaler::Scale() const
+{
+  if (this->dataPtr->dynamic)
+    return this->dataPtr->dynamicScale;
+  return this->dataPtr->fixedScale;
+}
+
+//////////////////////////////////////////////////
+bool ResolutionScaler::Update(double _frameTime)
+{
+  if (!this->dataPtr->dynamic || _frameTime <= 0.0)
+    return false;
+
+  if (this->dataPtr->cooldown > 0u)
+  {
+    this->dataPtr->cooldown--;
+    return false;
+  }
+
+  if (this->dataPtr->sampleCount == 0u)
+  {
+    this->dataPtr->averageFrameTime = _frameTime;
+  }
+  else
+  {
+    this->dataPtr->averageFrameTime +=
+        kSmoothing * (_frameTime - this->dataPtr->averageFrameTime);
+  }
+  this->dataPtr->sampleCount++;
+  if (this->dataPtr->sampleCount < kMinSamples)
+    return false;
+
+  double target = this->dataPtr->targetFrameTime;
+  double average = this->dataPtr->averageFrameTime;
+  double scale = this->dataPtr->dynamicScale;
+
+  // the frame time is roughly proportional to the number of pixels, so
+  // the scale that hits the target is scale * sqrt(target / average).
+  // Work in whole steps, moving at least one step in the wanted direction.
+  double steps = scale * std::sqrt(target / average) / kScaleStep + 1e-6;
+  double current = std::round(scale / kScaleStep);
+  double newScale = scale;
+  if (average > target * kDecreaseThreshold)
+  {
+    newScale = std::min(std::floor(steps), current - 1.0) * kScaleStep;
+  }
+  else if (average < target * kIncreaseThreshold)
+  {
+    steps = std::min(steps, current + kMaxIncrease / kScaleStep);
+    newScale = std::max(std::floor(steps), current + 1.0) * kScaleStep;
+  }
+  newScale = std::max(this->dataPtr->minScale,
+      std::min(this->dataPtr->maxScale, newScale));
+
+  if (std::abs(newScale - scale) < 1e-6)
+    return false;
+
+  this->dataPtr->dynamicScale = newScale;
+  this->Reset();
+  this->dataPtr->cooldown = kCooldownFrames;
+  return true;
+}
+
+//////////////////////////////////////////////////
+void ResolutionScaler::Reset()
+{
+  this->dataPtr->sampleCount = 0u;
+  this->dataPtr->averageFrameTime = 0.0;
+  this->dataPtr->cooldown = 0u;
+}
@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+#include "ignition/rendering/ResolutionScaler.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+/////////////////////////////////////////////////
+/// \brief Simulate frames whose time is proportional to the number of
+/// pixels rendered
+/// \param[in] _scaler Scaler to update
+/// \param[in] _fullResTime Frame time at full resolution
+/// \param[in] _frames Number of frames
+/// \return Number of scale changes
+unsigned int simulate(ResolutionScaler &_scaler, double _fullResTime,
+    unsigned int _frames)
+{
+  unsigned int changes = 0u;
+  for (unsigned int i = 0u; i < _frames; ++i)
+  {
+    double scale = _scaler.Scale();
+    if (_scaler.Update(_fullResTime * scale * scale))
+      ++changes;
+  }
+  return changes;
+}
+
+/////////////////////////////////////////////////
+TEST(ResolutionScalerTest, Defaults)
+{
+  ResolutionScaler scaler;
+  EXPECT_FALSE(scaler.Dynamic());
+  EXPECT_DOUBLE_EQ(1.0 / 30.0, scaler.TargetFrameTime());
+  EXPECT_DOUBLE_EQ(0.5, scaler.MinScale());
+  EXPECT_DOUBLE_EQ(1.0, scaler.MaxScale());
+  EXPECT_DOUBLE_EQ(1.0, scaler.FixedScale());
+  EXPECT_DOUBLE_EQ(1.0, scaler.Scale());
+
+  // invalid values are clamped or ignored
+  scaler.SetScaleRange(0.0, 2.0);
+  EXPECT_DOUBLE_EQ(0.1, scaler.MinScale());
+  EXPECT_DOUBLE_EQ(1.0, scaler.MaxScale());
+  scaler.SetScaleRange(0.8, 0.6);
+  EXPECT_DOUBLE_EQ(0.8, scaler.MinScale());
+  EXPECT_DOUBLE_EQ(0.8, scaler.MaxScale());
+  scaler.SetTargetFrameTime(-1.0);
+  EXPECT_DOUBLE_EQ(1.0 / 30.0, scaler.TargetFrameTime());
+  scaler.SetFixedScale(5.0);
+  EXPECT_DOUBLE_EQ(1.0, scaler.FixedScale());
+}
+
+/////////////////////////////////////////////////
+TEST(ResolutionScalerTest, Fixed)
+{
+  // a fixed scale ignores frame times, so output is deterministic
+  ResolutionScaler scaler;
+  scaler.SetFixedScale(0.6);
+  EXPECT_EQ(0u, simulate(scaler, 1.0, 100u));
+  EXPECT_DOUBLE_EQ(0.6, scaler.Scale());
+
+  // switching back from dynamic restores the fixed scale
+  scaler.SetDynamic(true);
+  EXPECT_DOUBLE_EQ(1.0, scaler.Scale());
+  EXPECT_LT(0u, simulate(scaler, 1.0, 100u));
+  EXPECT_DOUBLE_EQ(0.5, scaler.Scale());
+  scaler.SetDynamic(false);
+  EXPECT_DOUBLE_EQ(0.6, scaler.Scale());
+}
+
+/////////////////////////////////////////////////
+TEST(ResolutionScalerTest, Dynamic)
+{
+  double target = 1.0 / 30.0;
+  ResolutionScaler scaler;
+  scaler.SetDynamic(true);
+  scaler.SetScaleRange(0.25, 1.0);
+  EXPECT_DOUBLE_EQ(1.0, scaler.Scale());
+
+  // frames twice as slow as the target at full resolution converge to a
+  // scale of about sqrt(1/2) and then stay there
+  simulate(scaler, 2.0 * target, 200u);
+  double scale = scaler.Scale();
+  EXPECT_NEAR(std::sqrt(0.5), scale, 0.1);
+  double frameTime = 2.0 * target * scale * scale;
+  EXPECT_LE(frameTime, target * 1.1);
+  EXPECT_GE(frameTime, target * 0.8);
+  EXPECT_EQ(0u, simulate(scaler, 2.0 * target, 200u));
+  EXPECT_DOUBLE_EQ(scale, scaler.Scale());
+
+  // once the load goes away the scale goes back up to the maximum
+  EXPECT_LT(0u, simulate(scaler, 0.5 * target, 200u));
+  EXPECT_DOUBLE_EQ(1.0, scaler.Scale());
+
+  // a heavy load is clamped to the minimum
+  simulate(scaler, 100.0 * target, 200u);
+  EXPECT_DOUBLE_EQ(0.25, scaler.Scale());
+
+  // changing the range clamps the current scale
+  scaler.SetScaleRange(0.5, 0.75);
+  EXPECT_DOUBLE_EQ(0.5, scaler.Scale());
+  simulate(scaler, 0.1 * target, 200u);
+  EXPECT_DOUBLE_EQ(0.75, scaler.Scale());
+
+  // frame times are not used before a few frames are averaged
+  scaler.Reset();
+  EXPECT_FALSE(scaler.Update(100.0 * target));
+  EXPECT_DOUBLE_EQ(0.75, scaler.Scale());
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -17,9 +17,12 @@
 
 #include <gtest/gtest.h>
 
+#include <vector>
+
 #include <ignition/common/Console.hh>
 
 #include "test_config.h"  // NOLINT(build/include)
+#include "ignition/rendering/Material.hh"
 #include "ignition/rendering/RenderEngine.hh"
 #include "ignition/rendering/RenderTarget.hh"
 #include "ignition/rendering/RenderingIface.hh"
@@ -46,6 +49,9 @@ class SceneTest : public testing::Test,
   /// \brief Test creating and destroying materials
   public: void Materials(const std::string &_renderEngine);
 
+  /// \brief Test updating the materials of many visuals at once
+  public: void VisualMaterials(const std::string &_renderEngine);
+
   /// \brief Test setting and getting Time
   public: void Time(const std::string &_renderEngine);
 };
@@ -647,6 +653,96 @@ void SceneTest::Materials(const std::string &_renderEngine)
   rendering::unloadEngine(engine->Name());
 }
 
+/////////////////////////////////////////////////
+void SceneTest::VisualMaterials(const std::string &_renderEngine)
+{
+  auto engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine << "' is not supported" << std::endl;
+    return;
+  }
+
+  auto scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+  EXPECT_EQ(0u, scene->BatchMaterialCount());
+
+  MaterialPtr baseMat = scene->CreateMaterial("base_material");
+  ASSERT_NE(nullptr, baseMat);
+
+  std::vector<VisualPtr> visuals;
+  for (unsigned int i = 0; i < 4u; ++i)
+  {
+    VisualPtr visual = scene->CreateVisual();
+    ASSERT_NE(nullptr, visual);
+    visual->AddGeometry(scene->CreateBox());
+    visual->SetMaterial(baseMat, false);
+    scene->RootVisual()->AddChild(visual);
+    visuals.push_back(visual);
+  }
+
+  // visuals with the same properties share a material
+  std::vector<VisualMaterialUpdate> updates(visuals.size());
+  for (unsigned int i = 0; i < visuals.size(); ++i)
+  {
+    updates[i].visual = visuals[i];
+    updates[i].diffuse = (i % 2u == 0u) ? math::Color::Red : math::Color::Blue;
+    updates[i].emissive = math::Color::Black;
+    updates[i].transparency = 0.0;
+  }
+  scene->UpdateVisualMaterials(updates);
+  EXPECT_EQ(2u, scene->BatchMaterialCount());
+  EXPECT_EQ(visuals[0]->Material(), visuals[2]->Material());
+  EXPECT_EQ(visuals[1]->Material(), visuals[3]->Material());
+  EXPECT_NE(visuals[0]->Material(), visuals[1]->Material());
+  EXPECT_EQ(math::Color::Red, visuals[0]->Material()->Diffuse());
+  EXPECT_EQ(math::Color::Blue, visuals[1]->Material()->Diffuse());
+
+  // unused shared materials are destroyed
+  std::string redName = visuals[0]->Material()->Name();
+  for (auto &update : updates)
+  {
+    update.diffuse = math::Color::Green;
+    update.transparency = 0.5;
+  }
+  scene->UpdateVisualMaterials(updates);
+  EXPECT_EQ(1u, scene->BatchMaterialCount());
+  EXPECT_FALSE(scene->MaterialRegistered(redName));
+  EXPECT_EQ(math::Color::Green, visuals[0]->Material()->Diffuse());
+  EXPECT_NEAR(0.5, visuals[0]->Material()->Transparency(), 0.01);
+
+  // restore the original materials
+  for (auto &visual : visuals)
+    scene->ResetVisualMaterial(visual);
+  EXPECT_EQ(0u, scene->BatchMaterialCount());
+  EXPECT_EQ(baseMat, visuals[0]->Material());
+  EXPECT_TRUE(scene->MaterialRegistered("base_material"));
+
+  // unique clones of a material share materials too
+  for (auto &visual : visuals)
+    visual->SetMaterial(baseMat);
+  EXPECT_NE(visuals[0]->Material(), visuals[1]->Material());
+  scene->UpdateVisualMaterials(updates);
+  EXPECT_EQ(1u, scene->BatchMaterialCount());
+  EXPECT_EQ(visuals[0]->Material(), visuals[3]->Material());
+
+  // setting another material or destroying a visual releases its shared
+  // material
+  std::string greenName = visuals[0]->Material()->Name();
+  visuals[0]->SetMaterial(baseMat, false);
+  visuals[1]->SetMaterial(baseMat, false);
+  EXPECT_EQ(1u, scene->BatchMaterialCount());
+  scene->DestroyVisual(visuals[2]);
+  EXPECT_EQ(1u, scene->BatchMaterialCount());
+  scene->DestroyVisual(visuals[3]);
+  EXPECT_EQ(0u, scene->BatchMaterialCount());
+  EXPECT_FALSE(scene->MaterialRegistered(greenName));
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
 /////////////////////////////////////////////////
 void SceneTest::Time(const std::string &_renderEngine)
 {
@@ -717,6 +813,12 @@ TEST_P(SceneTest, Materials)
   Materials(GetParam());
 }
 
+/////////////////////////////////////////////////
+TEST_P(SceneTest, VisualMaterials)
+{
+  VisualMaterials(GetParam());
+}
+
 /////////////////////////////////////////////////
 TEST_P(SceneTest, Time)
 {
@@ -17,7 +17,8 @@
 
 #include "ignition/rendering/ShaderParam.hh"
 
-using namespace ignition::rendering;
+using namespace ignition;
+using namespace rendering;
 
 
 class ignition::rendering::ShaderParamPrivate
@@ -31,6 +32,22 @@ class ignition::rendering::ShaderParamPrivate
       float vFloat;
       int vInt;
     } paramValue;
+
+  /// \brief Values of float buffer params
+  public: std::vector<float> floatBuffer;
+
+  /// \brief Values of int buffer params
+  public: std::vector<int> intBuffer;
+
+  /// \brief True if the value changed since the owner was last cleared
+  public: bool dirty = false;
+
+  /// \brief List of modified params of the owning ShaderParams, null if
+  /// the param does not belong to a ShaderParams
+  public: std::vector<uint32_t> *dirtyIndices = nullptr;
+
+  /// \brief Index of this param in the owning ShaderParams
+  public: uint32_t index = 0u;
 };
 
 
@@ -47,6 +64,11 @@ ShaderParam::ShaderParam(const ShaderParam &_other)
   // Avoid incorrect cppcheck error about dataPtr being assigned in constructor
   ShaderParamPrivate &dp = *(this->dataPtr);
   dp = *(_other.dataPtr);
+
+  // copies do not belong to the owner of the original
+  dp.dirty = false;
+  dp.dirtyIndices = nullptr;
+  dp.index = 0u;
 }
 
 //////////////////////////////////////////////////
@@ -63,7 +85,14 @@ ShaderParam::ParamType ShaderParam::Type() const
 //////////////////////////////////////////////////
 ShaderParam &ShaderParam::operator=(const ShaderParam &_other)
 {
-  *(this->dataPtr) = *(_other.dataPtr);
+  if (this == &_other)
+    return *this;
+
+  this->dataPtr->type = _other.dataPtr->type;
+  this->dataPtr->paramValue = _other.dataPtr->paramValue;
+  this->dataPtr->floatBuffer = _other.dataPtr->floatBuffer;
+  this->dataPtr->intBuffer = _other.dataPtr->intBuffer;
+  this->MarkDirty();
   return *this;
 }
 
@@ -72,6 +101,7 @@ void ShaderParam::operator=(const float _value)
 {
   this->dataPtr->type = PARAM_FLOAT;
   this->dataPtr->paramValue.vFloat = _value;
+  this->MarkDirty();
 }
 
 //////////////////////////////////////////////////
@@ -79,6 +109,115 @@ void ShaderParam::operator=(const int _value)
 {
   this->dataPtr->type = PARAM_INT;
   this->dataPtr->paramValue.vInt = _value;
+  this->MarkDirty();
+}
+
+//////////////////////////////////////////////////
+void ShaderParam::operator=(const math::Vector2d &_value)
+{
+  const float values[2] = {
+      static_cast<float>(_value.X()), static_cast<float>(_value.Y())};
+  this->SetFloatBuffer(values, 2u);
+}
+
+//////////////////////////////////////////////////
+void ShaderParam::operator=(const math::Vector3d &_value)
+{
+  const float values[3] = {
+      static_cast<float>(_value.X()), static_cast<float>(_value.Y()),
+      static_cast<float>(_value.Z())};
+  this->SetFloatBuffer(values, 3u);
+}
+
+//////////////////////////////////////////////////
+void ShaderParam::operator=(const math::Vector4d &_value)
+{
+  const float values[4] = {
+      static_cast<float>(_value.X()), static_cast<float>(_value.Y()),
+      static_cast<float>(_value.Z()), static_cast<float>(_value.W())};
+  this->SetFloatBuffer(values, 4u);
+}
+
+//////////////////////////////////////////////////
+void ShaderParam::operator=(const math::Color &_value)
+{
+  const float values[4] = {_value.R(), _value.G(), _value.B(), _value.A()};
+  this->SetFloatBuffer(values, 4u);
+}
+
+//////////////////////////////////////////////////
+void ShaderParam::operator=(const math::Matrix3d &_value)
+{
+  float values[9];
+  for (unsigned int r = 0; r < 3u; ++r)
+  {
+    for (unsigned int c = 0; c < 3u; ++c)
+      values[r * 3u + c] = static_cast<float>(_value(r, c));
+  }
+  this->SetFloatBuffer(values, 9u);
+}
+
+//////////////////////////////////////////////////
+void ShaderParam::operator=(const math::Matrix4d &_value)
+{
+  float values[16];
+  for (unsigned int r = 0; r < 4u; ++r)
+  {
+    for (unsigned int c = 0; c < 4u; ++c)
+      values[r * 4u + c] = static_cast<float>(_value(r, c));
+  }
+  this->SetFloatBuffer(values, 16u);
+}
+
+//////////////////////////////////////////////////
+void ShaderParam::SetFloatBuffer(const float *_values, uint32_t _count)
+{
+  this->dataPtr->type = PARAM_FLOAT_BUFFER;
+  this->dataPtr->floatBuffer.assign(_values, _values + _count);
+  this->MarkDirty();
+}
+
+//////////////////////////////////////////////////
+void ShaderParam::SetIntBuffer(const int *_values, uint32_t _count)
+{
+  this->dataPtr->type = PARAM_INT_BUFFER;
+  this->dataPtr->intBuffer.assign(_values, _values + _count);
+  this->MarkDirty();
+}
+
+//////////////////////////////////////////////////
+uint32_t ShaderParam::Count() const
+{
+  switch (this->dataPtr->type)
+  {
+    case PARAM_FLOAT:
+    case PARAM_INT:
+      return 1u;
+    case PARAM_FLOAT_BUFFER:
+      return static_cast<uint32_t>(this->dataPtr->floatBuffer.size());
+    case PARAM_INT_BUFFER:
+      return static_cast<uint32_t>(this->dataPtr->intBuffer.size());
+    default:
+      return 0u;
+  }
+}
+
+//////////////////////////////////////////////////
+const void *ShaderParam::Data() const
+{
+  switch (this->dataPtr->type)
+  {
+    case PARAM_FLOAT:
+      return &this->dataPtr->paramValue.vFloat;
+    case PARAM_INT:
+      return &this->dataPtr->paramValue.vInt;
+    case PARAM_FLOAT_BUFFER:
+      return this->dataPtr->floatBuffer.data();
+    case PARAM_INT_BUFFER:
+      return this->dataPtr->intBuffer.data();
+    default:
+      return nullptr;
+  }
 }
 
 //////////////////////////////////////////////////
@@ -102,3 +241,56 @@ bool ShaderParam::Value(int *_value) const
   }
   return false;
 }
+
+//////////////////////////////////////////////////
+bool ShaderParam::Value(std::vector<float> *_value) const
+{
+  if (PARAM_FLOAT_BUFFER == this->dataPtr->type)
+  {
+    *_value = this->dataPtr->floatBuffer;
+    return true;
+  }
+  return false;
+}
+
+//////////////////////////////////////////////////
+bool ShaderParam::Value(std::vector<int> *_value) const
+{
+  if (PARAM_INT_BUFFER == this->dataPtr->type)
+  {
+    *_value = this->dataPtr->intBuffer;
+    return true;
+  }
+  return false;
+}
+
+//////////////////////////////////////////////////
+bool ShaderParam::IsDirty() const
+{
+  return this->dataPtr->dirty;
+}
+
+//////////////////////////////////////////////////
+void ShaderParam::MarkDirty()
+{
+  if (this->dataPtr->dirty)
+    return;
+
+  this->dataPtr->dirty = true;
+  if (this->dataPtr->dirtyIndices)
+    this->dataPtr->dirtyIndices->push_back(this->dataPtr->index);
+}
+
+//////////////////////////////////////////////////
+void ShaderParam::SetOwner(std::vector<uint32_t> *_dirtyIndices,
+    uint32_t _index)
+{
+  this->dataPtr->dirtyIndices = _dirtyIndices;
+  this->dataPtr->index = _index;
+}
+
+//////////////////////////////////////////////////
+void ShaderParam::ClearDirty()
+{
+  this->dataPtr->dirty = false;
+}
@@ -16,6 +16,7 @@
 
 #include <gtest/gtest.h>
 
+#include <vector>
 
 #include "ignition/rendering/ShaderParam.hh"
 
@@ -87,6 +88,93 @@ TEST(ShaderParam, IntType)
   EXPECT_EQ(10, val3);
 }
 
+/////////////////////////////////////////////////
+TEST(ShaderParam, FloatBufferType)
+{
+  ShaderParam p;
+  const float values[3] = {1.0f, 2.0f, 3.0f};
+  p.SetFloatBuffer(values, 3u);
+  EXPECT_EQ(ShaderParam::PARAM_FLOAT_BUFFER, p.Type());
+  EXPECT_EQ(3u, p.Count());
+  std::vector<float> val;
+  EXPECT_TRUE(p.Value(&val));
+  ASSERT_EQ(3u, val.size());
+  EXPECT_FLOAT_EQ(2.0f, val[1]);
+  const float *data = static_cast<const float *>(p.Data());
+  EXPECT_FLOAT_EQ(3.0f, data[2]);
+
+  float badRef;
+  EXPECT_FALSE(p.Value(&badRef));
+  std::vector<int> badBuffer;
+  EXPECT_FALSE(p.Value(&badBuffer));
+
+  // test copy constructor
+  ShaderParam p2(p);
+  EXPECT_EQ(ShaderParam::PARAM_FLOAT_BUFFER, p2.Type());
+  EXPECT_EQ(3u, p2.Count());
+}
+
+/////////////////////////////////////////////////
+TEST(ShaderParam, IntBufferType)
+{
+  ShaderParam p;
+  const int values[2] = {4, 5};
+  p.SetIntBuffer(values, 2u);
+  EXPECT_EQ(ShaderParam::PARAM_INT_BUFFER, p.Type());
+  EXPECT_EQ(2u, p.Count());
+  std::vector<int> val;
+  EXPECT_TRUE(p.Value(&val));
+  ASSERT_EQ(2u, val.size());
+  EXPECT_EQ(5, val[1]);
+
+  std::vector<float> badRef;
+  EXPECT_FALSE(p.Value(&badRef));
+
+  // scalars hold a single value
+  p = 3;
+  EXPECT_EQ(1u, p.Count());
+  EXPECT_EQ(3, *static_cast<const int *>(p.Data()));
+}
+
+/////////////////////////////////////////////////
+TEST(ShaderParam, VectorAndMatrixTypes)
+{
+  ShaderParam p;
+  EXPECT_EQ(0u, p.Count());
+  EXPECT_EQ(nullptr, p.Data());
+
+  p = ignition::math::Vector2d(1, 2);
+  EXPECT_EQ(ShaderParam::PARAM_FLOAT_BUFFER, p.Type());
+  EXPECT_EQ(2u, p.Count());
+
+  p = ignition::math::Vector3d(1, 2, 3);
+  EXPECT_EQ(3u, p.Count());
+
+  p = ignition::math::Vector4d(1, 2, 3, 4);
+  EXPECT_EQ(4u, p.Count());
+
+  p = ignition::math::Color(0.1f, 0.2f, 0.3f, 0.4f);
+  EXPECT_EQ(4u, p.Count());
+  EXPECT_FLOAT_EQ(0.4f, static_cast<const float *>(p.Data())[3]);
+
+  p = ignition::math::Matrix3d(1, 2, 3, 4, 5, 6, 7, 8, 9);
+  EXPECT_EQ(9u, p.Count());
+  EXPECT_FLOAT_EQ(4.0f, static_cast<const float *>(p.Data())[3]);
+
+  // matrices are stored in row-major order
+  ignition::math::Matrix4d m(
+      1, 2, 3, 4,
+      5, 6, 7, 8,
+      9, 10, 11, 12,
+      13, 14, 15, 16);
+  p = m;
+  EXPECT_EQ(16u, p.Count());
+  const float *data = static_cast<const float *>(p.Data());
+  EXPECT_FLOAT_EQ(2.0f, data[1]);
+  EXPECT_FLOAT_EQ(5.0f, data[4]);
+  EXPECT_FLOAT_EQ(16.0f, data[15]);
+}
+
 //////////////////////////////////////////////////
 int main(int argc, char **argv)
 {
@@ -18,6 +18,7 @@
 #include "ignition/rendering/ShaderParams.hh"
 
 #include <unordered_map>
+#include <vector>
 
 using namespace ignition::rendering;
 
@@ -27,8 +28,12 @@ class ignition::rendering::ShaderParamsPrivate
   /// \brief collection of parameters
   public: std::unordered_map<std::string, ShaderParam> parameters;
 
-  /// \brief true if the parameters have been modified since last cleared
-  public: bool isDirty = false;
+  /// \brief Parameters by index. Pointers to elements of an unordered_map
+  /// remain valid when it grows.
+  public: std::vector<std::pair<const std::string, ShaderParam> *> entries;
+
+  /// \brief Indices of the parameters modified since last cleared
+  public: std::vector<uint32_t> dirtyIndices;
 };
 
 
@@ -127,8 +132,16 @@ ShaderParams::~ShaderParams()
 //////////////////////////////////////////////////
 ShaderParam &ShaderParams::operator[](const std::string &_name)
 {
-  this->dataPtr->isDirty = true;
-  return this->dataPtr->parameters[_name];
+  auto it = this->dataPtr->parameters.find(_name);
+  if (it == this->dataPtr->parameters.end())
+  {
+    it = this->dataPtr->parameters.emplace(_name, ShaderParam()).first;
+    auto index = static_cast<uint32_t>(this->dataPtr->entries.size());
+    it->second.SetOwner(&this->dataPtr->dirtyIndices, index);
+    this->dataPtr->entries.push_back(&*it);
+  }
+  it->second.MarkDirty();
+  return it->second;
 }
 
 //////////////////////////////////////////////////
@@ -156,11 +169,37 @@ ShaderParams::Iterator ShaderParams::end() const
 //////////////////////////////////////////////////
 bool ShaderParams::IsDirty() const
 {
-  return this->dataPtr->isDirty;
+  return !this->dataPtr->dirtyIndices.empty();
 }
 
 //////////////////////////////////////////////////
 void ShaderParams::ClearDirty()
 {
-  this->dataPtr->isDirty = false;
+  for (auto index : this->dataPtr->dirtyIndices)
+    this->dataPtr->entries[index]->second.ClearDirty();
+  this->dataPtr->dirtyIndices.clear();
+}
+
+//////////////////////////////////////////////////
+const std::vector<uint32_t> &ShaderParams::DirtyIndices() const
+{
+  return this->dataPtr->dirtyIndices;
+}
+
+//////////////////////////////////////////////////
+uint32_t ShaderParams::ParamCount() const
+{
+  return static_cast<uint32_t>(this->dataPtr->entries.size());
+}
+
+//////////////////////////////////////////////////
+const std::string &ShaderParams::NameByIndex(uint32_t _index) const
+{
+  return this->dataPtr->entries.at(_index)->first;
+}
+
+//////////////////////////////////////////////////
+const ShaderParam &ShaderParams::ParamByIndex(uint32_t _index) const
+{
+  return this->dataPtr->entries.at(_index)->second;
 }
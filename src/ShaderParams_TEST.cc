@@ -16,6 +16,7 @@
 
 #include <gtest/gtest.h>
 
+#include <string>
 
 #include "ignition/rendering/ShaderParams.hh"
 
@@ -73,6 +74,60 @@ TEST(ShaderParams, ConstRangeForLoopDoesNotDirty)
   EXPECT_FALSE(params.IsDirty());
 }
 
+//////////////////////////////////////////////////
+TEST(ShaderParams, DirtyIndices)
+{
+  ShaderParams params;
+  params["a"] = 1.0f;
+  params["b"] = 2;
+  params["c"] = ignition::math::Vector3d(1, 2, 3);
+  EXPECT_EQ(3u, params.ParamCount());
+  EXPECT_EQ(3u, params.DirtyIndices().size());
+  EXPECT_EQ(std::string("a"), params.NameByIndex(0u));
+  EXPECT_EQ(std::string("b"), params.NameByIndex(1u));
+  EXPECT_EQ(std::string("c"), params.NameByIndex(2u));
+  EXPECT_EQ(ShaderParam::PARAM_INT, params.ParamByIndex(1u).Type());
+  params.ClearDirty();
+  EXPECT_TRUE(params.DirtyIndices().empty());
+  EXPECT_FALSE(params.ParamByIndex(0u).IsDirty());
+
+  // only the modified param is dirty, and only reported once
+  params["b"] = 3;
+  params["b"] = 4;
+  EXPECT_TRUE(params.IsDirty());
+  ASSERT_EQ(1u, params.DirtyIndices().size());
+  EXPECT_EQ(1u, params.DirtyIndices()[0]);
+  EXPECT_TRUE(params.ParamByIndex(1u).IsDirty());
+  EXPECT_FALSE(params.ParamByIndex(2u).IsDirty());
+}
+
+//////////////////////////////////////////////////
+TEST(ShaderParams, Handle)
+{
+  ShaderParams params;
+  ShaderParam &handle = params["a"];
+  for (int i = 0; i < 100; ++i)
+  {
+    std::string name = "p" + std::to_string(i);
+    params[name] = static_cast<float>(i);
+  }
+  params.ClearDirty();
+
+  // references stay valid and dirty the params when set
+  handle = 5.0f;
+  ASSERT_EQ(1u, params.DirtyIndices().size());
+  EXPECT_EQ(0u, params.DirtyIndices()[0]);
+  float value;
+  EXPECT_TRUE(params.ParamByIndex(0u).Value(&value));
+  EXPECT_FLOAT_EQ(5.0f, value);
+
+  // copies are not part of the params
+  params.ClearDirty();
+  ShaderParam copy(handle);
+  copy = 6.0f;
+  EXPECT_FALSE(params.IsDirty());
+}
+
 //////////////////////////////////////////////////
 int main(int argc, char **argv)
 {
@@ -0,0 +1,685 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef _WIN32
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <thread>
+
+#include <ignition/common/Console.hh>
+
+#include "ignition/rendering/Camera.hh"
+#include "ignition/rendering/DepthCamera.hh"
+#include "ignition/rendering/GpuRays.hh"
+#include "ignition/rendering/Image.hh"
+#include "ignition/rendering/PixelFormat.hh"
+#include "ignition/rendering/SharedMemoryChannel.hh"
+#include "ignition/rendering/ThermalCamera.hh"
+
+/// \brief Identifies a shared memory channel ("IGNF")
+static const uint32_t kChannelMagic = 0x49474e46u;
+
+/// \brief Version of the shared memory layout
+static const uint32_t kChannelVersion = 1u;
+
+/// \brief Alignment of the slots in shared memory
+static const uint64_t kSlotAlignment = 64u;
+
+/// \brief Maximum length of a pixel format name, including the terminator
+static const size_t kFormatLength = 32u;
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free,
+    "Shared memory channels need lock free 64 bit atomics");
+
+/// \brief Header at the start of the shared memory
+struct alignas(64) ChannelHeader
+{
+  /// \brief Always kChannelMagic
+  uint32_t magic;
+
+  /// \brief Always kChannelVersion
+  uint32_t version;
+
+  /// \brief Number of slots
+  uint32_t slotCount;
+
+  /// \brief Maximum frame size
+  uint64_t slotSize;
+
+  /// \brief Number of frames completely written
+  std::atomic<uint64_t> published;
+};
+
+/// \brief Header of each slot, followed by the frame data
+struct alignas(64) SlotHeader
+{
+  /// \brief Slot state: 2 * sequence + 1 while frame <sequence> is being
+  /// written, 2 * sequence + 2 once it is complete, 0 if never written
+  std::atomic<uint64_t> state;
+
+  /// \brief Frame timestamp
+  int64_t timestamp;
+
+  /// \brief Frame size in bytes
+  uint64_t size;
+
+  /// \brief Frame width
+  uint32_t width;
+
+  /// \brief Frame height
+  uint32_t height;
+
+  /// \brief Number of channels per pixel
+  uint32_t channels;
+
+  /// \brief Null terminated pixel format name
+  char format[kFormatLength];
+};
+
+/// \brief Get the distance between two slots in shared memory
+/// \param[in] _slotSize Maximum frame size
+/// \return Slot stride in bytes
+static uint64_t SlotStride(uint64_t _slotSize)
+{
+  uint64_t dataSize =
+      (_slotSize + kSlotAlignment - 1u) / kSlotAlignment * kSlotAlignment;
+  return sizeof(SlotHeader) + dataSize;
+}
+
+/// \brief Get the current time of the monotonic clock
+/// \return Nanoseconds
+static int64_t Now()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/// \brief Add a leading '/' to a channel name if missing
+/// \param[in] _name Channel name
+/// \return Shared memory object name
+static std::string ShmName(const std::string &_name)
+{
+  if (!_name.empty() && _name[0] == '/')
+    return _name;
+  return "/" + _name;
+}
+
+/// \brief A mapped shared memory channel
+struct MappedChannel
+{
+  /// \brief Map a shared memory object
+  /// \param[in] _fd File descriptor of the object
+  /// \param[in] _size Number of bytes to map
+  /// \param[in] _writable True to map the memory for writing
+  /// \return True on success
+  bool Map(int _fd, uint64_t _size, bool _writable);
+
+  /// \brief Unmap the shared memory
+  void Unmap();
+
+  /// \brief Get a slot
+  /// \param[in] _index Slot index
+  /// \return Slot header, followed by the frame data
+  SlotHeader *Slot(uint64_t _index) const
+  {
+    return reinterpret_cast<SlotHeader *>(this->memory +
+        sizeof(ChannelHeader) +
+        (_index % this->header->slotCount) *
+        SlotStride(this->header->slotSize));
+  }
+
+  /// \brief Get the frame data of a slot
+  /// \param[in] _slot Slot header
+  /// \return Frame data, right after the slot header
+  static unsigned char *Data(const SlotHeader *_slot)
+  {
+    return const_cast<unsigned char *>(
+        reinterpret_cast<const unsigned char *>(_slot)) + sizeof(SlotHeader);
+  }
+
+  /// \brief Start of the shared memory
+  unsigned char *memory = nullptr;
+
+  /// \brief Size of the mapping
+  uint64_t size = 0u;
+
+  /// \brief Channel header, at the start of the shared memory
+  ChannelHeader *header = nullptr;
+};
+
+//////////////////////////////////////////////////
+bool MappedChannel::Map(int _fd, uint64_t _size, bool _writable)
+{
+#ifndef _WIN32
+  void *memory = mmap(nullptr, _size,
+      _writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, _fd, 0);
+  if (memory == MAP_FAILED)
+    return false;
+  this->memory = static_cast<unsigned char *>(memory);
+  this->size = _size;
+  this->header = reinterpret_cast<ChannelHeader *>(memory);
+  return true;
+#else
+  (void)_fd;
+  (void)_size;
+  (void)_writable;
+  return false;
+#endif
+}
+
+//////////////////////////////////////////////////
+void MappedChannel::Unmap()
+{
+#ifndef _WIN32
+  if (this->memory)
+    munmap(this->memory, this->size);
+#endif
+  this->memory = nullptr;
+  this->size = 0u;
+  this->header = nullptr;
+}
+
+/// \brief Private data class for SharedMemoryWriter
+class ignition::rendering::SharedMemoryWriterPrivate
+{
+  /// \brief Mapped shared memory
+  public: MappedChannel channel;
+
+  /// \brief Channel name
+  public: std::string name;
+
+  /// \brief Buffer used to read back camera frames
+  public: Image cameraImage;
+};
+
+/// \brief Private data class for SharedMemoryReader
+class ignition::rendering::SharedMemoryReaderPrivate
+{
+  /// \brief Copy a frame out of the ring
+  /// \param[in] _sequence Frame number
+  /// \param[out] _data Frame data
+  /// \param[out] _info Frame header
+  /// \return 1 if the frame was read, 0 if it is not written yet and -1 if
+  /// it has been overwritten
+  public: int ReadFrame(uint64_t _sequence,
+      std::vector<unsigned char> &_data, SharedMemoryFrameInfo &_info) const;
+
+  /// \brief Mapped shared memory
+  public: MappedChannel channel;
+
+  /// \brief Next frame to read
+  public: uint64_t next = 0u;
+
+  /// \brief Number of frames read
+  public: uint64_t read = 0u;
+
+  /// \brief Number of frames overwritten before being read
+  public: uint64_t missed = 0u;
+};
+
+using namespace ignition;
+using namespace rendering;
+
+//////////////////////////////////////////////////
+SharedMemoryWriter::SharedMemoryWriter()
+    : dataPtr(new SharedMemoryWriterPrivate)
+{
+}
+
+//////////////////////////////////////////////////
+SharedMemoryWriter::~SharedMemoryWriter()
+{
+  this->Close();
+}
+
+//////////////////////////////////////////////////
+bool SharedMemoryWriter::Open(const std::string &_name,
+    unsigned int _slotCount, uint64_t _slotSize)
+{
+  this->Close();
+
+  if (_slotCount == 0u || _slotSize == 0u)
+  {
+    ignerr << "Shared memory channel [" << _name << "] needs at least one "
+           << "slot of non zero size" << std::endl;
+    return false;
+  }
+
+#ifndef _WIN32
+  std::string name = ShmName(_name);
+  uint64_t size = sizeof(ChannelHeader) + _slotCount * SlotStride(_slotSize);
+
+  // replace any channel left behind by a previous writer
+  shm_unlink(name.c_str());
+  int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+  if (fd < 0)
+  {
+    ignerr << "Unable to create shared memory channel [" << name << "]: "
+           << std::strerror(errno) << std::endl;
+    return false;
+  }
+
+  bool result = ftruncate(fd, static_cast<off_t>(size)) == 0 &&
+      this->dataPtr->channel.Map(fd, size, true);
+  close(fd);
+  if (!result)
+  {
+    ignerr << "Unable to map shared memory channel [" << name << "]: "
+           << std::strerror(errno) << std::endl;
+    shm_unlink(name.c_str());
+    return false;
+  }
+
+  // ftruncate zero fills the memory, so all slots start unwritten
+  ChannelHeader *header = this->dataPtr->channel.header;
+  header->slotCount = _slotCount;
+  header->slotSize = _slotSize;
+  header->published.store(0u, std::memory_order_relaxed);
+  header->version = kChannelVersion;
+  std::atomic_thread_fence(std::memory_order_release);
+  header->magic = kChannelMagic;
+
+  this->dataPtr->name = name;
+  return true;
+#else
+  ignerr << "Shared memory channels are not supported on Windows"
+         << std::endl;
+  return false;
+#endif
+}
+
+//////////////////////////////////////////////////
+void SharedMemoryWriter::Close()
+{
+  if (!this->IsOpen())
+    return;
+
+  this->dataPtr->channel.Unmap();
+#ifndef _WIN32
+  shm_unlink(this->dataPtr->name.c_str());
+#endif
+  this->dataPtr->name.clear();
+}
+
+//////////////////////////////////////////////////
+bool SharedMemoryWriter::IsOpen() const
+{
+  return this->dataPtr->channel.header != nullptr;
+}
+
+//////////////////////////////////////////////////
+std::string SharedMemoryWriter::Name() const
+{
+  return this->dataPtr->name;
+}
+
+//////////////////////////////////////////////////
+unsigned int SharedMemoryWriter::SlotCount() const
+{
+  return this->IsOpen() ? this->dataPtr->channel.header->slotCount : 0u;
+}
+
+//////////////////////////////////////////////////
+uint64_t SharedMemoryWriter::SlotSize() const
+{
+  return this->IsOpen() ? this->dataPtr->channel.header->slotSize : 0u;
+}
+
+//////////////////////////////////////////////////
+uint64_t SharedMemoryWriter::FramesWritten() const
+{
+  if (!this->IsOpen())
+    return 0u;
+  return this->dataPtr->channel.header->published.load(
+      std::memory_order_relaxed);
+}
+
+//////////////////////////////////////////////////
+bool SharedMemoryWriter::Write(const void *_data, uint64_t _size,
+    unsigned int _width, unsigned int _height, unsigned int _channels,
+    const std::string &_format)
+{
+  if (!this->IsOpen() || !_data)
+    return false;
+
+  ChannelHeader *header = this->dataPtr->channel.header;
+  if (_size > header->slotSize)
+  {
+    ignerr << "Frame of " << _size << " bytes does not fit in the "
+           << header->slotSize << " byte slots of shared memory channel ["
+           << this->dataPtr->name << "]" << std::endl;
+    return false;
+  }
+
+  // there is a single writer so nobody else changes the sequence
+  uint64_t sequence = header->published.load(std::memory_order_relaxed);
+  SlotHeader *slot = this->dataPtr->channel.Slot(sequence);
+
+  // mark the slot as being written before touching its content, so that
+  // readers copying the previous frame notice it changed
+  slot->state.store(2u * sequence + 1u, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  slot->timestamp = Now();
+  slot->size = _size;
+  slot->width = _width;
+  slot->height = _height;
+  slot->channels = _channels;
+  std::memset(slot->format, 0, kFormatLength);
+  std::strncpy(slot->format, _format.c_str(), kFormatLength - 1u);
+  std::memcpy(MappedChannel::Data(slot), _data, _size);
+
+  slot->state.store(2u * sequence + 2u, std::memory_order_release);
+  header->published.store(sequence + 1u, std::memory_order_release);
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool SharedMemoryWriter::Write(const CameraPtr &_camera)
+{
+  if (!_camera || !this->IsOpen())
+    return false;
+
+  Image &image = this->dataPtr->cameraImage;
+  if (image.Width() != _camera->ImageWidth() ||
+      image.Height() != _camera->ImageHeight() ||
+      image.Format() != _camera->ImageFormat())
+  {
+    image = _camera->CreateImage();
+  }
+  _camera->Copy(image);
+
+  PixelFormat format = image.Format();
+  return this->Write(image.Data(), image.MemorySize(), image.Width(),
+      image.Height(), PixelUtil::ChannelCount(format),
+      PixelUtil::Name(format));
+}
+
+//////////////////////////////////////////////////
+common::ConnectionPtr SharedMemoryWriter::ConnectDepthCamera(
+    const DepthCameraPtr &_camera)
+{
+  if (!_camera)
+    return common::ConnectionPtr();
+
+  return _camera->ConnectNewDepthFrame(
+      [this](const float *_data, unsigned int _width, unsigned int _height,
+             unsigned int _channels, const std::string &_format)
+      {
+        this->Write(_data,
+            static_cast<uint64_t>(_width) * _height * _channels *
+            sizeof(float), _width, _height, _channels, _format);
+      });
+}
+
+//////////////////////////////////////////////////
+common::ConnectionPtr SharedMemoryWriter::ConnectThermalCamera(
+    const ThermalCameraPtr &_camera)
+{
+  if (!_camera)
+    return common::ConnectionPtr();
+
+  return _camera->ConnectNewThermalFrame(
+      [this](const uint16_t *_data, unsigned int _width,
+             unsigned int _height, unsigned int _channels,
+             const std::string &_format)
+      {
+        this->Write(_data,
+            static_cast<uint64_t>(_width) * _height * _channels *
+            sizeof(uint16_t), _width, _height, _channels, _format);
+      });
+}
+
+//////////////////////////////////////////////////
+common::ConnectionPtr SharedMemoryWriter::ConnectGpuRays(
+    const GpuRaysPtr &_rays)
+{
+  if (!_rays)
+    return common::ConnectionPtr();
+
+  return _rays->ConnectNewGpuRaysFrame(
+      [this](const float *_data, unsigned int _width, unsigned int _height,
+             unsigned int _channels, const std::string &_format)
+      {
+        this->Write(_data,
+            static_cast<uint64_t>(_width) * _height * _channels *
+            sizeof(float), _width, _height, _channels, _format);
+      });
+}
+
+//////////////////////////////////////////////////
+SharedMemoryReader::SharedMemoryReader()
+    : dataPtr(new SharedMemoryReaderPrivate)
+{
+}
+
+//////////////////////////////////////////////////
+SharedMemoryReader::~SharedMemoryReader()
+{
+  this->Close();
+}
+
+//////////////////////////////////////////////////
+bool SharedMemoryReader::Open(const std::string &_name)
+{
+  this->Close();
+
+#ifndef _WIN32
+  std::string name = ShmName(_name);
+  int fd = shm_open(name.c_str(), O_RDONLY, 0);
+  if (fd < 0)
+  {
+    ignerr << "Unable to open shared memory channel [" << name << "]: "
+           << std::strerror(errno) << std::endl;
+    return false;
+  }
+
+  struct stat info;
+  uint64_t size = 0u;
+  if (fstat(fd, &info) == 0)
+    size = static_cast<uint64_t>(info.st_size);
+  bool result = size >= sizeof(ChannelHeader) &&
+      this->dataPtr->channel.Map(fd, size, false);
+  close(fd);
+  if (!result)
+  {
+    ignerr << "Unable to map shared memory channel [" << name << "]"
+           << std::endl;
+    return false;
+  }
+
+  const ChannelHeader *header = this->dataPtr->channel.header;
+  bool valid = header->magic == kChannelMagic;
+  std::atomic_thread_fence(std::memory_order_acquire);
+  valid = valid && header->version == kChannelVersion &&
+      header->slotCount > 0u &&
+      sizeof(ChannelHeader) + header->slotCount *
+      SlotStride(header->slotSize) <= size;
+  if (!valid)
+  {
+    ignerr << "Shared memory channel [" << name << "] has an invalid header"
+           << std::endl;
+    this->dataPtr->channel.Unmap();
+    return false;
+  }
+
+  this->dataPtr->next = header->published.load(std::memory_order_acquire);
+  this->dataPtr->read = 0u;
+  this->dataPtr->missed = 0u;
+  return true;
+#else
+  ignerr << "Shared memory channels are not supported on Windows"
+         << std::endl;
+  return false;
+#endif
+}
+
+//////////////////////////////////////////////////
+void SharedMemoryReader::Close()
+{
+  this->dataPtr->channel.Unmap();
+}
+
+//////////////////////////////////////////////////
+bool SharedMemoryReader::IsOpen() const
+{
+  return this->dataPtr->channel.header != nullptr;
+}
+
+//////////////////////////////////////////////////
+unsigned int SharedMemoryReader::SlotCount() const
+{
+  return this->IsOpen() ? this->dataPtr->channel.header->slotCount : 0u;
+}
+
+//////////////////////////////////////////////////
+uint64_t SharedMemoryReader::SlotSize() const
+{
+  return this->IsOpen() ? this->dataPtr->channel.header->slotSize : 0u;
+}
+
+//////////////////////////////////////////////////
+int SharedMemoryReaderPrivate::ReadFrame(uint64_t _sequence,
+    std::vector<unsigned char> &_data, SharedMemoryFrameInfo &_info) const
+{
+  const SlotHeader *slot = this->channel.Slot(_sequence);
+  uint64_t complete = 2u * _sequence + 2u;
+  uint64_t before = slot->state.load(std::memory_order_acquire);
+  if (before < complete)
+    return 0;
+  if (before > complete)
+    return -1;
+
+  uint64_t size = std::min(slot->size, this->channel.header->slotSize);
+  _data.resize(size);
+  std::memcpy(_data.data(), MappedChannel::Data(slot), size);
+  _info.sequence = _sequence;
+  _info.timestamp = slot->timestamp;
+  _info.width = slot->width;
+  _info.height = slot->height;
+  _info.channels = slot->channels;
+  _info.size = size;
+  char format[kFormatLength];
+  std::memcpy(format, slot->format, kFormatLength);
+  format[kFormatLength - 1u] = '\0';
+  _info.format = format;
+
+  // the writer may have started overwriting the slot while copying
+  std::atomic_thread_fence(std::memory_order_acquire);
+  uint64_t after = slot->state.load(std::memory_order_relaxed);
+  return after == before ? 1 : -1;
+}
+
+//////////////////////////////////////////////////
+bool SharedMemoryReader::Read(std::vector<unsigned char> &_data,
+    SharedMemoryFrameInfo &_info)
+{
+  if (!this->IsOpen())
+    return false;
+
+  const ChannelHeader *header = this->dataPtr->channel.header;
+  while (true)
+  {
+    uint64_t published = header->published.load(std::memory_order_acquire);
+    if (this->dataPtr->next >= published)
+      return false;
+
+    // frames older than the ring size are gone
+    if (published - this->dataPtr->next > header->slotCount)
+    {
+      uint64_t oldest = published - header->slotCount;
+      this->dataPtr->missed += oldest - this->dataPtr->next;
+      this->dataPtr->next = oldest;
+    }
+
+    int result = this->dataPtr->ReadFrame(this->dataPtr->next, _data,
+        _info);
+    if (result == 0)
+      return false;
+
+    ++this->dataPtr->next;
+    if (result > 0)
+    {
+      ++this->dataPtr->read;
+      return true;
+    }
+    ++this->dataPtr->missed;
+  }
+}
+
+//////////////////////////////////////////////////
+bool SharedMemoryReader::ReadLatest(std::vector<unsigned char> &_data,
+    SharedMemoryFrameInfo &_info)
+{
+  if (!this->IsOpen())
+    return false;
+
+  const ChannelHeader *header = this->dataPtr->channel.header;
+  uint64_t published = header->published.load(std::memory_order_acquire);
+  if (this->dataPtr->next >= published)
+    return false;
+
+  this->dataPtr->next = published - 1u;
+  return this->Read(_data, _info);
+}
+
+//////////////////////////////////////////////////
+bool SharedMemoryReader::Wait(std::vector<unsigned char> &_data,
+    SharedMemoryFrameInfo &_info, std::chrono::nanoseconds _timeout)
+{
+  auto end = std::chrono::steady_clock::now() + _timeout;
+  unsigned int spins = 0u;
+  while (!this->Read(_data, _info))
+  {
+    if (!this->IsOpen() || std::chrono::steady_clock::now() >= end)
+      return false;
+
+    // spin briefly for low latency, then back off to avoid burning a core
+    if (++spins < 100u)
+      std::this_thread::yield();
+    else
+      std::this_thread::sleep_for(std::chrono::microseconds(50));
+  }
+  return true;
+}
+
+//////////////////////////////////////////////////
+uint64_t SharedMemoryReader::FramesRead() const
+{
+  return this->dataPtr->read;
+}
+
+//////////////////////////////////////////////////
+uint64_t SharedMemoryReader::FramesMissed() const
+{
+  return this->dataPtr->missed;
+}
+
+//////////////////////////////////////////////////
+std::chrono::nanoseconds SharedMemoryReader::Latency(
+    const SharedMemoryFrameInfo &_info)
+{
+  return std::chrono::nanoseconds(Now() - _info.timestamp);
+}
@@ -0,0 +1,131 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "test_config.h"  // NOLINT(build/include)
+
+#include "ignition/rendering/SharedMemoryChannel.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+#ifndef _WIN32
+/////////////////////////////////////////////////
+TEST(SharedMemoryChannelTest, WriteRead)
+{
+  SharedMemoryWriter writer;
+  EXPECT_FALSE(writer.IsOpen());
+  EXPECT_EQ(0u, writer.SlotCount());
+  EXPECT_FALSE(writer.Write(nullptr, 0u, 0u, 0u, 0u, ""));
+
+  EXPECT_FALSE(writer.Open("ign_rendering_test_channel", 0u, 16u));
+  EXPECT_FALSE(writer.Open("ign_rendering_test_channel", 4u, 0u));
+  ASSERT_TRUE(writer.Open("ign_rendering_test_channel", 4u, 64u));
+  EXPECT_TRUE(writer.IsOpen());
+  EXPECT_EQ("/ign_rendering_test_channel", writer.Name());
+  EXPECT_EQ(4u, writer.SlotCount());
+  EXPECT_EQ(64u, writer.SlotSize());
+
+  SharedMemoryReader reader;
+  EXPECT_FALSE(reader.Open("/ign_rendering_missing_channel"));
+  ASSERT_TRUE(reader.Open("/ign_rendering_test_channel"));
+  EXPECT_EQ(4u, reader.SlotCount());
+  EXPECT_EQ(64u, reader.SlotSize());
+
+  std::vector<unsigned char> data;
+  SharedMemoryFrameInfo info;
+  EXPECT_FALSE(reader.Read(data, info));
+
+  // frames larger than a slot are rejected
+  std::vector<float> frame(16u);
+  EXPECT_FALSE(writer.Write(frame.data(), 128u, 4u, 4u, 1u, "FLOAT32"));
+
+  for (unsigned int i = 0; i < frame.size(); ++i)
+    frame[i] = i * 0.5f;
+  EXPECT_TRUE(writer.Write(frame.data(), frame.size() * sizeof(float), 4u,
+      4u, 1u, "FLOAT32"));
+  EXPECT_EQ(1u, writer.FramesWritten());
+
+  ASSERT_TRUE(reader.Read(data, info));
+  EXPECT_EQ(0u, info.sequence);
+  EXPECT_EQ(4u, info.width);
+  EXPECT_EQ(4u, info.height);
+  EXPECT_EQ(1u, info.channels);
+  EXPECT_EQ("FLOAT32", info.format);
+  EXPECT_EQ(64u, info.size);
+  ASSERT_EQ(64u, data.size());
+  const float *values = reinterpret_cast<const float *>(data.data());
+  EXPECT_FLOAT_EQ(7.5f, values[15]);
+  EXPECT_LE(0, SharedMemoryReader::Latency(info).count());
+  EXPECT_FALSE(reader.Read(data, info));
+  EXPECT_EQ(1u, reader.FramesRead());
+
+  // frames are read in order
+  unsigned char bytes[3] = {1u, 2u, 3u};
+  for (unsigned char i = 0; i < 3u; ++i)
+  {
+    bytes[0] = i;
+    EXPECT_TRUE(writer.Write(bytes, 3u, 1u, 1u, 3u, "R8G8B8"));
+  }
+  for (unsigned char i = 0; i < 3u; ++i)
+  {
+    ASSERT_TRUE(reader.Read(data, info));
+    EXPECT_EQ(i + 1u, info.sequence);
+    ASSERT_EQ(3u, data.size());
+    EXPECT_EQ(i, data[0]);
+  }
+  EXPECT_EQ(0u, reader.FramesMissed());
+
+  // a slow reader misses the frames that were overwritten
+  for (unsigned char i = 0; i < 10u; ++i)
+  {
+    bytes[0] = i;
+    EXPECT_TRUE(writer.Write(bytes, 3u, 1u, 1u, 3u, "R8G8B8"));
+  }
+  ASSERT_TRUE(reader.Read(data, info));
+  EXPECT_EQ(10u, info.sequence);
+  EXPECT_EQ(6u, data[0]);
+  EXPECT_EQ(6u, reader.FramesMissed());
+
+  // reading the latest frame skips the others
+  ASSERT_TRUE(reader.ReadLatest(data, info));
+  EXPECT_EQ(13u, info.sequence);
+  EXPECT_EQ(9u, data[0]);
+  EXPECT_EQ(6u, reader.FramesMissed());
+  EXPECT_FALSE(reader.ReadLatest(data, info));
+  EXPECT_FALSE(reader.Wait(data, info, std::chrono::milliseconds(1)));
+
+  // the reader keeps its mapping after the writer closes the channel
+  writer.Close();
+  EXPECT_FALSE(writer.IsOpen());
+  EXPECT_TRUE(reader.IsOpen());
+  EXPECT_FALSE(reader.Read(data, info));
+  reader.Close();
+  EXPECT_FALSE(reader.IsOpen());
+  EXPECT_FALSE(reader.Open("/ign_rendering_test_channel"));
+}
+#endif
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
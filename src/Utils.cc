@@ -20,6 +20,9 @@
 #include <X11/Xresource.h>
 #endif
 
+#include <cmath>
+
+#include "ignition/rendering/RenderTypes.hh"
 #include "ignition/rendering/Utils.hh"
 
 namespace ignition
@@ -94,66 +97,87 @@ ignition::math::AxisAlignedBox transformAxisAlignedBox(
     const ignition::math::AxisAlignedBox &_bbox,
     const ignition::math::Pose3d &_pose)
 {
-  auto center = _bbox.Center();
-
-  // Get the 8 corners of the bounding box.
-  std::vector<ignition::math::Vector3d> vertices;
-  vertices.push_back(center + ignition::math::Vector3d(-_bbox.XLength()/2.0,
-                                                       _bbox.YLength()/2.0,
-                                                       _bbox.ZLength()/2.0));
-  vertices.push_back(center + ignition::math::Vector3d(_bbox.XLength()/2.0,
-                                                       _bbox.YLength()/2.0,
-                                                       _bbox.ZLength()/2.0));
-  vertices.push_back(center + ignition::math::Vector3d(-_bbox.XLength()/2.0,
-                                                       -_bbox.YLength()/2.0,
-                                                       _bbox.ZLength()/2.0));
-  vertices.push_back(center + ignition::math::Vector3d(_bbox.XLength()/2.0,
-                                                       -_bbox.YLength()/2.0,
-                                                       _bbox.ZLength()/2.0));
-
-  vertices.push_back(center + ignition::math::Vector3d(-_bbox.XLength()/2.0,
-                                                       _bbox.YLength()/2.0,
-                                                       -_bbox.ZLength()/2.0));
-  vertices.push_back(center + ignition::math::Vector3d(_bbox.XLength()/2.0,
-                                                       _bbox.YLength()/2.0,
-                                                       -_bbox.ZLength()/2.0));
-  vertices.push_back(center + ignition::math::Vector3d(-_bbox.XLength()/2.0,
-                                                       -_bbox.YLength()/2.0,
-                                                       -_bbox.ZLength()/2.0));
-  vertices.push_back(center + ignition::math::Vector3d(_bbox.XLength()/2.0,
-                                                       -_bbox.YLength()/2.0,
-                                                       -_bbox.ZLength()/2.0));
-
-
-  // Transform corners.
-  for (unsigned int i = 0; i < vertices.size(); ++i)
+  const ignition::math::Vector3d &boxMin = _bbox.Min();
+  const ignition::math::Vector3d &boxMax = _bbox.Max();
+
+  // an empty box stays empty
+  if (boxMin.X() > boxMax.X() || boxMin.Y() > boxMax.Y() ||
+      boxMin.Z() > boxMax.Z())
   {
-    auto &v = vertices[i];
-    v = _pose.Rot() * v + _pose.Pos();
+    return _bbox;
   }
 
-  ignition::math::Vector3d min = vertices[0];
-  ignition::math::Vector3d max = vertices[0];
-
-  // find min / max of vertices
-  for (unsigned int i = 1; i < vertices.size(); ++i)
+  // Transform the center and project the rotated half extents onto the
+  // world axes (Arvo's method). This gives the same result as transforming
+  // the 8 corners of the box without any temporary storage, and the fixed
+  // size loops below are easily vectorized by the compiler.
+  const double c[3] = {
+      (boxMin.X() + boxMax.X()) * 0.5,
+      (boxMin.Y() + boxMax.Y()) * 0.5,
+      (boxMin.Z() + boxMax.Z()) * 0.5};
+  const double h[3] = {
+      (boxMax.X() - boxMin.X()) * 0.5,
+      (boxMax.Y() - boxMin.Y()) * 0.5,
+      (boxMax.Z() - boxMin.Z()) * 0.5};
+
+  // rotation matrix from the (normalized) quaternion
+  const ignition::math::Quaterniond &q = _pose.Rot();
+  const double w = q.W();
+  const double x = q.X();
+  const double y = q.Y();
+  const double z = q.Z();
+  const double r[3][3] = {
+      {1.0 - 2.0 * (y * y + z * z), 2.0 * (x * y - w * z),
+          2.0 * (x * z + w * y)},
+      {2.0 * (x * y + w * z), 1.0 - 2.0 * (x * x + z * z),
+          2.0 * (y * z - w * x)},
+      {2.0 * (x * z - w * y), 2.0 * (y * z + w * x),
+          1.0 - 2.0 * (x * x + y * y)}};
+  const double t[3] = {_pose.Pos().X(), _pose.Pos().Y(), _pose.Pos().Z()};
+
+  double newMin[3];
+  double newMax[3];
+  for (unsigned int i = 0; i < 3; ++i)
   {
-    auto &v = vertices[i];
-
-    if (min.X() > v.X())
-      min.X() = v.X();
-    if (max.X() < v.X())
-      max.X() = v.X();
-    if (min.Y() > v.Y())
-      min.Y() = v.Y();
-    if (max.Y() < v.Y())
-      max.Y() = v.Y();
-    if (min.Z() > v.Z())
-      min.Z() = v.Z();
-    if (max.Z() < v.Z())
-      max.Z() = v.Z();
+    double center = t[i];
+    double extent = 0.0;
+    for (unsigned int j = 0; j < 3; ++j)
+    {
+      center += r[i][j] * c[j];
+      extent += std::abs(r[i][j]) * h[j];
+    }
+    newMin[i] = center - extent;
+    newMax[i] = center + extent;
   }
-  return ignition::math::AxisAlignedBox(min, max);
+
+  return ignition::math::AxisAlignedBox(
+      ignition::math::Vector3d(newMin[0], newMin[1], newMin[2]),
+      ignition::math::Vector3d(newMax[0], newMax[1], newMax[2]));
+}
+
+/////////////////////////////////////////////////
+uint32_t renderVisibilityFlags(uint32_t _flags)
+{
+  // visuals on every layer or on none are not restricted by layers
+  uint32_t layers = _flags & IGN_VISIBILITY_LAYERS;
+  if (layers == 0u || layers == IGN_VISIBILITY_LAYERS)
+    return _flags;
+
+  return (_flags & ~static_cast<uint32_t>(IGN_VISIBILITY_ALL)) | layers |
+      (_flags & IGN_VISIBILITY_SELECTABLE);
+}
+
+/////////////////////////////////////////////////
+uint32_t renderVisibilityMask(uint32_t _mask)
+{
+  // masks that enable every layer or none are used as they are, so
+  // visuals only flagged as selectable are still rendered
+  uint32_t layers = _mask & IGN_VISIBILITY_LAYERS;
+  if (layers == 0u || layers == IGN_VISIBILITY_LAYERS)
+    return _mask;
+
+  return _mask & ~static_cast<uint32_t>(IGN_VISIBILITY_SELECTABLE);
+}
 }
 }
 }
@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+#include "ignition/rendering/RenderTypes.hh"
+#include "ignition/rendering/Utils.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+/////////////////////////////////////////////////
+TEST(UtilsTest, TransformAxisAlignedBox)
+{
+  math::AxisAlignedBox box(math::Vector3d(-1, -2, -3), math::Vector3d(1, 2, 3));
+
+  // identity
+  math::AxisAlignedBox result = transformAxisAlignedBox(box, math::Pose3d());
+  EXPECT_EQ(box.Min(), result.Min());
+  EXPECT_EQ(box.Max(), result.Max());
+
+  // translation
+  result = transformAxisAlignedBox(box, math::Pose3d(1, 2, 3, 0, 0, 0));
+  EXPECT_EQ(math::Vector3d(0, 0, 0), result.Min());
+  EXPECT_EQ(math::Vector3d(2, 4, 6), result.Max());
+
+  // 90 degree yaw swaps the x and y extents
+  result = transformAxisAlignedBox(box,
+      math::Pose3d(0, 0, 0, 0, 0, IGN_PI / 2));
+  EXPECT_EQ(math::Vector3d(-2, -1, -3), result.Min());
+  EXPECT_EQ(math::Vector3d(2, 1, 3), result.Max());
+
+  // compare against transforming the 8 corners for an arbitrary pose
+  math::Pose3d pose(0.5, -1.0, 2.0, 0.3, -0.7, 1.1);
+  math::AxisAlignedBox offsetBox(math::Vector3d(0.5, 1, 1.5),
+      math::Vector3d(2, 2.5, 4));
+  math::AxisAlignedBox expected;
+  for (unsigned int i = 0; i < 8; ++i)
+  {
+    math::Vector3d corner(
+        (i & 1) ? offsetBox.Max().X() : offsetBox.Min().X(),
+        (i & 2) ? offsetBox.Max().Y() : offsetBox.Min().Y(),
+        (i & 4) ? offsetBox.Max().Z() : offsetBox.Min().Z());
+    corner = pose.Rot() * corner + pose.Pos();
+    expected.Merge(math::AxisAlignedBox(corner, corner));
+  }
+  result = transformAxisAlignedBox(offsetBox, pose);
+  EXPECT_TRUE(expected.Min().Equal(result.Min(), 1e-9));
+  EXPECT_TRUE(expected.Max().Equal(result.Max(), 1e-9));
+
+  // empty boxes stay empty
+  math::AxisAlignedBox empty;
+  result = transformAxisAlignedBox(empty, pose);
+  EXPECT_EQ(empty.Min(), result.Min());
+  EXPECT_EQ(empty.Max(), result.Max());
+}
+
+//////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+
+/////////////////////////////////////////////////
+TEST(UtilsTest, RenderVisibility)
+{
+  const uint32_t all = IGN_VISIBILITY_ALL;
+  const uint32_t layer = 0x00000100u;
+  EXPECT_NE(0u, layer & IGN_VISIBILITY_LAYERS);
+
+  // visuals not restricted by layers keep their flags
+  EXPECT_EQ(all, renderVisibilityFlags(all));
+  EXPECT_EQ(static_cast<uint32_t>(IGN_VISIBILITY_GUI),
+      renderVisibilityFlags(IGN_VISIBILITY_GUI));
+
+  // a layered visual keeps its layer, selectable and non generic flags
+  uint32_t flags = (all & ~static_cast<uint32_t>(IGN_VISIBILITY_LAYERS)) |
+      layer | IGN_VISIBILITY_OCCLUDER;
+  uint32_t rendered = renderVisibilityFlags(flags);
+  EXPECT_EQ(layer | IGN_VISIBILITY_SELECTABLE | IGN_VISIBILITY_OCCLUDER,
+      rendered);
+
+  // it is only rendered by masks with its layer enabled
+  EXPECT_NE(0u, rendered & renderVisibilityMask(all));
+  EXPECT_EQ(0u, rendered & renderVisibilityMask(all & ~layer));
+
+  // selection buffers still render it
+  EXPECT_NE(0u, rendered & IGN_VISIBILITY_SELECTABLE);
+
+  // masks that do not disable layers are unchanged, so visuals that are
+  // only selectable are rendered as before
+  const uint32_t selectable = IGN_VISIBILITY_SELECTABLE;
+  EXPECT_EQ(all, renderVisibilityMask(all));
+  EXPECT_EQ(selectable, renderVisibilityMask(selectable));
+  EXPECT_EQ(all & ~static_cast<uint32_t>(IGN_VISIBILITY_GUI),
+      renderVisibilityMask(all & ~static_cast<uint32_t>(IGN_VISIBILITY_GUI)));
+  EXPECT_NE(0u, renderVisibilityFlags(selectable) & renderVisibilityMask(all));
+}
@@ -0,0 +1,806 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <set>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "ignition/rendering/Camera.hh"
+#include "ignition/rendering/Scene.hh"
+#include "ignition/rendering/Utils.hh"
+#include "ignition/rendering/VisibilityIndex.hh"
+#include "ignition/rendering/Visual.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+/// \brief Maximum number of visuals stored in a leaf of the hierarchy
+static const unsigned int kLeafSize = 4u;
+
+/// \brief A visual stored in the index
+struct IndexEntry
+{
+  /// \brief World bounding box minimum
+  double min[3];
+
+  /// \brief World bounding box maximum
+  double max[3];
+
+  /// \brief Visual id
+  unsigned int id;
+
+  /// \brief Visual visibility flags
+  uint32_t flags;
+
+  /// \brief Id of the root level visual this visual belongs to
+  unsigned int root;
+};
+
+/// \brief A node of the bounding volume hierarchy
+struct IndexNode
+{
+  /// \brief Bounding box minimum
+  double min[3];
+
+  /// \brief Bounding box maximum
+  double max[3];
+
+  /// \brief First entry of a leaf, or index of the second child of an
+  /// inner node. The first child of an inner node directly follows it.
+  unsigned int offset;
+
+  /// \brief Number of entries in a leaf, zero for inner nodes
+  unsigned int count;
+};
+
+/// \brief Camera parameters of a single query
+struct QueryFrustum
+{
+  /// \brief View projection matrix
+  math::Matrix4d viewProj;
+
+  /// \brief Inverse of the view projection matrix
+  math::Matrix4d invViewProj;
+
+  /// \brief Frustum planes, stored as a, b, c, d with normals pointing
+  /// inwards
+  double planes[6][4];
+
+  /// \brief Image width in pixels
+  double width;
+
+  /// \brief Image height in pixels
+  double height;
+
+  /// \brief Camera position
+  double eye[3];
+};
+
+/// \brief Private data for the VisibilityIndex class
+class ignition::rendering::VisibilityIndexPrivate
+{
+  /// \brief Build the hierarchy over entries [_begin, _end)
+  /// \param[in] _begin First entry
+  /// \param[in] _end One past the last entry
+  public: void Build(unsigned int _begin, unsigned int _end);
+
+  /// \brief Recompute the bounds of all nodes from the entries
+  public: void Refit();
+
+  /// \brief Add the entries of a root level visual and its descendants
+  /// \param[in] _root Root level visual
+  /// \param[out] _entries Entries to append to
+  public: static void Collect(const VisualPtr &_root,
+      std::vector<IndexEntry> &_entries);
+
+  /// \brief Run a query for a single camera
+  /// \param[in] _frustum Camera parameters
+  /// \param[in] _options Query options
+  /// \return Visible visuals
+  public: std::vector<VisibleVisual> Query(const QueryFrustum &_frustum,
+      const VisibleVisualsOptions &_options) const;
+
+  /// \brief Compute the fraction of occlusion rays that reach an entry
+  /// \param[in] _frustum Camera parameters
+  /// \param[in] _entry Entry to test
+  /// \param[in] _result Result holding the screen rectangle of the entry
+  /// \param[in] _options Query options
+  /// \return Fraction of rays that reach the entry
+  public: double VisibleFraction(const QueryFrustum &_frustum,
+      const IndexEntry &_entry, const VisibleVisual &_result,
+      const VisibleVisualsOptions &_options) const;
+
+  /// \brief Check if any root level visual other than the one _entry
+  /// belongs to is hit by a ray before _distance
+  /// \param[in] _origin Ray origin
+  /// \param[in] _invDir Inverse of the ray direction
+  /// \param[in] _entry Entry the ray is cast at
+  /// \param[in] _distance Distance at which the ray enters _entry
+  /// \param[in] _mask Visibility mask of the query
+  /// \return True if the ray is blocked
+  public: bool Occluded(const double _origin[3], const double _invDir[3],
+      const IndexEntry &_entry, double _distance, uint32_t _mask) const;
+
+  /// \brief Indexed visuals, ordered so that each leaf references a
+  /// contiguous range
+  public: std::vector<IndexEntry> entries;
+
+  /// \brief Hierarchy nodes, the first one is the root
+  public: std::vector<IndexNode> nodes;
+
+  /// \brief Position of the entry of each visual
+  public: std::unordered_map<unsigned int, unsigned int> positions;
+
+  /// \brief Number of entries of each root level visual
+  public: std::map<unsigned int, unsigned int> rootCounts;
+};
+
+//////////////////////////////////////////////////
+/// \brief Intersect a ray with a box using the slab method
+/// \param[in] _min Box minimum
+/// \param[in] _max Box maximum
+/// \param[in] _origin Ray origin
+/// \param[in] _invDir Inverse of the ray direction
+/// \param[out] _tNear Distance at which the ray enters the box
+/// \return True if the ray hits the box in front of its origin
+static bool intersectRay(const double _min[3], const double _max[3],
+    const double _origin[3], const double _invDir[3], double &_tNear)
+{
+  double tNear = 0.0;
+  double tFar = std::numeric_limits<double>::max();
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    double t0 = (_min[i] - _origin[i]) * _invDir[i];
+    double t1 = (_max[i] - _origin[i]) * _invDir[i];
+    if (t0 > t1)
+      std::swap(t0, t1);
+    // NaN from 0 * inf compares false and leaves the interval unchanged
+    if (t0 > tNear)
+      tNear = t0;
+    if (t1 < tFar)
+      tFar = t1;
+    if (tNear > tFar)
+      return false;
+  }
+  _tNear = tNear;
+  return true;
+}
+
+//////////////////////////////////////////////////
+/// \brief Check if a box is completely outside one of the frustum planes
+/// \param[in] _frustum Camera parameters
+/// \param[in] _min Box minimum
+/// \param[in] _max Box maximum
+/// \return True if the box is outside the frustum
+static bool outsideFrustum(const QueryFrustum &_frustum, const double _min[3],
+    const double _max[3])
+{
+  for (const auto &plane : _frustum.planes)
+  {
+    // test the corner furthest along the plane normal
+    double d = plane[3];
+    for (unsigned int i = 0; i < 3; ++i)
+      d += plane[i] * (plane[i] >= 0.0 ? _max[i] : _min[i]);
+    if (d < 0.0)
+      return true;
+  }
+  return false;
+}
+
+//////////////////////////////////////////////////
+/// \brief Transform a point by a matrix and perform the perspective divide
+/// \param[in] _m Matrix
+/// \param[in] _p Point
+/// \param[out] _out Transformed point
+static void transformPoint(const math::Matrix4d &_m, const double _p[3],
+    double _out[3])
+{
+  double v[4];
+  for (unsigned int r = 0; r < 4; ++r)
+  {
+    v[r] = _m(r, 0) * _p[0] + _m(r, 1) * _p[1] + _m(r, 2) * _p[2] +
+        _m(r, 3);
+  }
+  for (unsigned int i = 0; i < 3; ++i)
+    _out[i] = v[i] / v[3];
+}
+
+//////////////////////////////////////////////////
+/// \brief Create the camera parameters of a query
+/// \param[in] _view View matrix
+/// \param[in] _projection Projection matrix
+/// \param[in] _width Image width in pixels
+/// \param[in] _height Image height in pixels
+/// \return Camera parameters
+static QueryFrustum createFrustum(const math::Matrix4d &_view,
+    const math::Matrix4d &_projection, unsigned int _width,
+    unsigned int _height)
+{
+  QueryFrustum frustum;
+  frustum.viewProj = _projection * _view;
+  frustum.invViewProj = frustum.viewProj.Inverse();
+  frustum.width = _width;
+  frustum.height = _height;
+
+  // extract the left, right, bottom, top, near and far planes from the
+  // rows of the view projection matrix (Gribb & Hartmann)
+  const math::Matrix4d &m = frustum.viewProj;
+  for (unsigned int p = 0; p < 6; ++p)
+  {
+    unsigned int row = p / 2;
+    double sign = (p % 2 == 0) ? 1.0 : -1.0;
+    for (unsigned int c = 0; c < 4; ++c)
+      frustum.planes[p][c] = m(3, c) + sign * m(row, c);
+  }
+
+  math::Matrix4d invView = _view.Inverse();
+  frustum.eye[0] = invView(0, 3);
+  frustum.eye[1] = invView(1, 3);
+  frustum.eye[2] = invView(2, 3);
+  return frustum;
+}
+
+//////////////////////////////////////////////////
+VisibilityIndex::VisibilityIndex()
+  : dataPtr(new VisibilityIndexPrivate)
+{
+}
+
+//////////////////////////////////////////////////
+VisibilityIndex::~VisibilityIndex()
+{
+}
+
+//////////////////////////////////////////////////
+void VisibilityIndex::Update(const ScenePtr &_scene)
+{
+  this->dataPtr->entries.clear();
+  this->dataPtr->nodes.clear();
+  this->dataPtr->positions.clear();
+  this->dataPtr->rootCounts.clear();
+  if (!_scene)
+    return;
+
+  VisualPtr rootVisual = _scene->RootVisual();
+  if (!rootVisual)
+    return;
+
+  for (unsigned int i = 0; i < rootVisual->ChildCount(); ++i)
+  {
+    VisualPtr child =
+        std::dynamic_pointer_cast<Visual>(rootVisual->ChildByIndex(i));
+    if (child)
+      VisibilityIndexPrivate::Collect(child, this->dataPtr->entries);
+  }
+
+  if (this->dataPtr->entries.empty())
+    return;
+
+  this->dataPtr->Build(0u,
+      static_cast<unsigned int>(this->dataPtr->entries.size()));
+  for (unsigned int i = 0; i < this->dataPtr->entries.size(); ++i)
+  {
+    const IndexEntry &entry = this->dataPtr->entries[i];
+    this->dataPtr->positions[entry.id] = i;
+    ++this->dataPtr->rootCounts[entry.root];
+  }
+}
+
+//////////////////////////////////////////////////
+void VisibilityIndex::Update(const ScenePtr &_scene,
+    const std::set<unsigned int> &_roots)
+{
+  VisualPtr rootVisual = _scene ? _scene->RootVisual() : VisualPtr();
+  if (!rootVisual)
+  {
+    this->Update(_scene);
+    return;
+  }
+
+  std::vector<IndexEntry> entries;
+  bool changed = false;
+  for (unsigned int id : _roots)
+  {
+    auto countIt = this->dataPtr->rootCounts.find(id);
+    unsigned int count =
+        countIt == this->dataPtr->rootCounts.end() ? 0u : countIt->second;
+
+    // visuals that are no longer root level have no entries
+    entries.clear();
+    VisualPtr visual = _scene->VisualById(id);
+    NodePtr parent = visual ? visual->Parent() : NodePtr();
+    if (parent && parent->Id() == rootVisual->Id())
+      VisibilityIndexPrivate::Collect(visual, entries);
+
+    if (entries.size() != count)
+    {
+      this->Update(_scene);
+      return;
+    }
+
+    for (const IndexEntry &entry : entries)
+    {
+      auto it = this->dataPtr->positions.find(entry.id);
+      if (it == this->dataPtr->positions.end() ||
+          this->dataPtr->entries[it->second].root != id)
+      {
+        this->Update(_scene);
+        return;
+      }
+      this->dataPtr->entries[it->second] = entry;
+      changed = true;
+    }
+  }
+
+  if (changed)
+    this->dataPtr->Refit();
+}
+
+//////////////////////////////////////////////////
+unsigned int VisibilityIndex::VisualCount() const
+{
+  return static_cast<unsigned int>(this->dataPtr->entries.size());
+}
+
+//////////////////////////////////////////////////
+std::vector<VisibleVisual> VisibilityIndex::Query(
+    const math::Matrix4d &_view, const math::Matrix4d &_projection,
+    unsigned int _width, unsigned int _height,
+    const VisibleVisualsOptions &_options) const
+{
+  return this->dataPtr->Query(
+      createFrustum(_view, _projection, _width, _height), _options);
+}
+
+//////////////////////////////////////////////////
+std::vector<std::vector<VisibleVisual>> VisibilityIndex::Query(
+    const std::vector<CameraPtr> &_cameras,
+    const VisibleVisualsOptions &_options) const
+{
+  std::vector<std::vector<VisibleVisual>> results(_cameras.size());
+
+  // camera matrices may be computed lazily by the render engine so read
+  // them on this thread
+  std::vector<QueryFrustum> frustums;
+  std::vector<VisibleVisualsOptions> options;
+  for (const auto &camera : _cameras)
+  {
+    if (!camera)
+    {
+      frustums.push_back(QueryFrustum());
+      options.push_back(VisibleVisualsOptions());
+      options.back().visibilityMask = 0u;
+      continue;
+    }
+    frustums.push_back(createFrustum(camera->ViewMatrix(),
+        camera->ProjectionMatrix(), camera->ImageWidth(),
+        camera->ImageHeight()));
+    options.push_back(_options);
+    options.back().visibilityMask &=
+        renderVisibilityMask(camera->VisibilityMask());
+  }
+
+  std::atomic<unsigned int> next(0u);
+  auto work = [&]()
+  {
+    for (unsigned int i = next++; i < _cameras.size(); i = next++)
+    {
+      if (options[i].visibilityMask != 0u)
+        results[i] = this->dataPtr->Query(frustums[i], options[i]);
+    }
+  };
+
+  unsigned int threadCount = std::min(
+      std::max(std::thread::hardware_concurrency(), 1u),
+      static_cast<unsigned int>(_cameras.size()));
+  std::vector<std::thread> threads;
+  for (unsigned int i = 1; i < threadCount; ++i)
+    threads.push_back(std::thread(work));
+  work();
+  for (auto &thread : threads)
+    thread.join();
+
+  return results;
+}
+
+//////////////////////////////////////////////////
+void VisibilityIndexPrivate::Build(unsigned int _begin, unsigned int _end)
+{
+  unsigned int nodeIndex = static_cast<unsigned int>(this->nodes.size());
+  this->nodes.push_back(IndexNode());
+
+  double min[3];
+  double max[3];
+  double centerMin[3];
+  double centerMax[3];
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    min[i] = centerMin[i] = std::numeric_limits<double>::max();
+    max[i] = centerMax[i] = std::numeric_limits<double>::lowest();
+  }
+  for (unsigned int e = _begin; e < _end; ++e)
+  {
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+      double center = this->entries[e].min[i] + this->entries[e].max[i];
+      min[i] = std::min(min[i], this->entries[e].min[i]);
+      max[i] = std::max(max[i], this->entries[e].max[i]);
+      centerMin[i] = std::min(centerMin[i], center);
+      centerMax[i] = std::max(centerMax[i], center);
+    }
+  }
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    this->nodes[nodeIndex].min[i] = min[i];
+    this->nodes[nodeIndex].max[i] = max[i];
+  }
+
+  if (_end - _begin <= kLeafSize)
+  {
+    this->nodes[nodeIndex].offset = _begin;
+    this->nodes[nodeIndex].count = _end - _begin;
+    return;
+  }
+
+  // split at the median along the axis with the largest spread of centers
+  unsigned int axis = 0;
+  for (unsigned int i = 1; i < 3; ++i)
+  {
+    if (centerMax[i] - centerMin[i] > centerMax[axis] - centerMin[axis])
+      axis = i;
+  }
+  unsigned int mid = _begin + (_end - _begin) / 2;
+  std::nth_element(this->entries.begin() + _begin,
+      this->entries.begin() + mid, this->entries.begin() + _end,
+      [axis](const IndexEntry &_a, const IndexEntry &_b)
+      {
+        return _a.min[axis] + _a.max[axis] < _b.min[axis] + _b.max[axis];
+      });
+
+  this->Build(_begin, mid);
+  this->nodes[nodeIndex].offset = static_cast<unsigned int>(this->nodes.size());
+  this->nodes[nodeIndex].count = 0u;
+  this->Build(mid, _end);
+}
+
+//////////////////////////////////////////////////
+void VisibilityIndexPrivate::Refit()
+{
+  // children are stored after their parent
+  for (size_t n = this->nodes.size(); n > 0u; --n)
+  {
+    IndexNode &node = this->nodes[n - 1u];
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+      node.min[i] = std::numeric_limits<double>::max();
+      node.max[i] = std::numeric_limits<double>::lowest();
+    }
+
+    if (node.count > 0u)
+    {
+      for (unsigned int e = node.offset; e < node.offset + node.count; ++e)
+      {
+        for (unsigned int i = 0; i < 3; ++i)
+        {
+          node.min[i] = std::min(node.min[i], this->entries[e].min[i]);
+          node.max[i] = std::max(node.max[i], this->entries[e].max[i]);
+        }
+      }
+      continue;
+    }
+
+    const IndexNode &first = this->nodes[n];
+    const IndexNode &second = this->nodes[node.offset];
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+      node.min[i] = std::min(first.min[i], second.min[i]);
+      node.max[i] = std::max(first.max[i], second.max[i]);
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+void VisibilityIndexPrivate::Collect(const VisualPtr &_root,
+    std::vector<IndexEntry> &_entries)
+{
+  std::vector<VisualPtr> stack;
+  stack.push_back(_root);
+  while (!stack.empty())
+  {
+    VisualPtr visual = stack.back();
+    stack.pop_back();
+
+    math::AxisAlignedBox box = visual->BoundingBox();
+    if (box.Min().X() > box.Max().X() || box.Min().Y() > box.Max().Y() ||
+        box.Min().Z() > box.Max().Z())
+    {
+      // empty subtree
+      continue;
+    }
+
+    IndexEntry entry;
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+      entry.min[i] = box.Min()[i];
+      entry.max[i] = box.Max()[i];
+    }
+    entry.id = visual->Id();
+    entry.flags = renderVisibilityFlags(visual->VisibilityFlags());
+    entry.root = _root->Id();
+    _entries.push_back(entry);
+
+    for (unsigned int i = 0; i < visual->ChildCount(); ++i)
+    {
+      VisualPtr child =
+          std::dynamic_pointer_cast<Visual>(visual->ChildByIndex(i));
+      if (child)
+        stack.push_back(child);
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+std::vector<VisibleVisual> VisibilityIndexPrivate::Query(
+    const QueryFrustum &_frustum, const VisibleVisualsOptions &_options) const
+{
+  std::vector<VisibleVisual> results;
+  if (this->nodes.empty() || _frustum.width <= 0.0 ||
+      _frustum.height <= 0.0)
+  {
+    return results;
+  }
+
+  std::vector<unsigned int> stack;
+  stack.push_back(0u);
+  while (!stack.empty())
+  {
+    const IndexNode &node = this->nodes[stack.back()];
+    unsigned int nodeIndex = stack.back();
+    stack.pop_back();
+
+    if (outsideFrustum(_frustum, node.min, node.max))
+      continue;
+
+    if (node.count == 0u)
+    {
+      stack.push_back(node.offset);
+      stack.push_back(nodeIndex + 1);
+      continue;
+    }
+
+    for (unsigned int e = node.offset; e < node.offset + node.count; ++e)
+    {
+      const IndexEntry &entry = this->entries[e];
+      if (!(entry.flags & _options.visibilityMask))
+        continue;
+      if (!_options.recursive && entry.root != entry.id)
+        continue;
+      if (outsideFrustum(_frustum, entry.min, entry.max))
+        continue;
+
+      // transform the box corners to clip space
+      double clip[8][4];
+      double nearDist[8];
+      for (unsigned int c = 0; c < 8; ++c)
+      {
+        double p[3] = {
+            (c & 1) ? entry.max[0] : entry.min[0],
+            (c & 2) ? entry.max[1] : entry.min[1],
+            (c & 4) ? entry.max[2] : entry.min[2]};
+        for (unsigned int r = 0; r < 4; ++r)
+        {
+          clip[c][r] = _frustum.viewProj(r, 0) * p[0] +
+              _frustum.viewProj(r, 1) * p[1] +
+              _frustum.viewProj(r, 2) * p[2] + _frustum.viewProj(r, 3);
+        }
+        nearDist[c] = clip[c][2] + clip[c][3];
+      }
+
+      // bound the projection of the part of the box in front of the near
+      // plane: corners in front of it plus edge crossings
+      double ndcMin[2] = {std::numeric_limits<double>::max(),
+          std::numeric_limits<double>::max()};
+      double ndcMax[2] = {std::numeric_limits<double>::lowest(),
+          std::numeric_limits<double>::lowest()};
+      auto addPoint = [&](const double _clip[4])
+      {
+        if (_clip[3] <= 1e-12)
+          return;
+        for (unsigned int i = 0; i < 2; ++i)
+        {
+          double ndc = _clip[i] / _clip[3];
+          ndcMin[i] = std::min(ndcMin[i], ndc);
+          ndcMax[i] = std::max(ndcMax[i], ndc);
+        }
+      };
+      for (unsigned int c = 0; c < 8; ++c)
+      {
+        if (nearDist[c] >= 0.0)
+          addPoint(clip[c]);
+        for (unsigned int axis = 0; axis < 3; ++axis)
+        {
+          unsigned int o = c | (1u << axis);
+          if (o == c || (nearDist[c] >= 0.0) == (nearDist[o] >= 0.0))
+            continue;
+          double t = nearDist[c] / (nearDist[c] - nearDist[o]);
+          double p[4];
+          for (unsigned int r = 0; r < 4; ++r)
+            p[r] = clip[c][r] + t * (clip[o][r] - clip[c][r]);
+          addPoint(p);
+        }
+      }
+      if (ndcMin[0] > ndcMax[0])
+        continue;
+
+      // convert to pixels with the origin at the top left corner
+      VisibleVisual result;
+      result.id = entry.id;
+      result.screenMin.Set(
+          std::max(0.0, (ndcMin[0] + 1.0) * 0.5 * _frustum.width),
+          std::max(0.0, (1.0 - ndcMax[1]) * 0.5 * _frustum.height));
+      result.screenMax.Set(
+          std::min(_frustum.width, (ndcMax[0] + 1.0) * 0.5 * _frustum.width),
+          std::min(_frustum.height, (1.0 - ndcMin[1]) * 0.5 * _frustum.height));
+      double w = result.screenMax.X() - result.screenMin.X();
+      double h = result.screenMax.Y() - result.screenMin.Y();
+      if (w <= 0.0 || h <= 0.0)
+        continue;
+      result.screenArea = w * h;
+      if (result.screenArea < _options.minScreenArea)
+        continue;
+
+      double dist2 = 0.0;
+      for (unsigned int i = 0; i < 3; ++i)
+      {
+        double d = std::max(std::max(entry.min[i] - _frustum.eye[i], 0.0),
+            _frustum.eye[i] - entry.max[i]);
+        dist2 += d * d;
+      }
+      result.distance = std::sqrt(dist2);
+
+      if (_options.occlusionSamples > 0u)
+      {
+        result.visibleFraction = this->VisibleFraction(_frustum, entry,
+            result, _options);
+        if (result.visibleFraction <= 0.0)
+          continue;
+      }
+
+      results.push_back(result);
+    }
+  }
+
+  std::sort(results.begin(), results.end(),
+      [](const VisibleVisual &_a, const VisibleVisual &_b)
+      {
+        if (_a.distance != _b.distance)
+          return _a.distance < _b.distance;
+        return _a.id < _b.id;
+      });
+  return results;
+}
+
+//////////////////////////////////////////////////
+double VisibilityIndexPrivate::VisibleFraction(const QueryFrustum &_frustum,
+    const IndexEntry &_entry, const VisibleVisual &_result,
+    const VisibleVisualsOptions &_options) const
+{
+  unsigned int samples = _options.occlusionSamples;
+  unsigned int hits = 0u;
+  unsigned int visible = 0u;
+  double w = _result.screenMax.X() - _result.screenMin.X();
+  double h = _result.screenMax.Y() - _result.screenMin.Y();
+  for (unsigned int y = 0; y < samples; ++y)
+  {
+    for (unsigned int x = 0; x < samples; ++x)
+    {
+      double px = _result.screenMin.X() + (x + 0.5) / samples * w;
+      double py = _result.screenMin.Y() + (y + 0.5) / samples * h;
+      double ndcNear[3] = {2.0 * px / _frustum.width - 1.0,
+          1.0 - 2.0 * py / _frustum.height, -1.0};
+      double ndcFar[3] = {ndcNear[0], ndcNear[1], 1.0};
+
+      double start[3];
+      double end[3];
+      transformPoint(_frustum.invViewProj, ndcNear, start);
+      transformPoint(_frustum.invViewProj, ndcFar, end);
+
+      double dir[3];
+      double invDir[3];
+      double length = 0.0;
+      for (unsigned int i = 0; i < 3; ++i)
+      {
+        dir[i] = end[i] - start[i];
+        length += dir[i] * dir[i];
+      }
+      length = std::sqrt(length);
+      if (length <= 0.0)
+        continue;
+      for (unsigned int i = 0; i < 3; ++i)
+        invDir[i] = length / dir[i];
+
+      double distance;
+      if (!intersectRay(_entry.min, _entry.max, start, invDir, distance))
+        continue;
+
+      ++hits;
+      if (!this->Occluded(start, invDir, _entry, distance,
+          _options.visibilityMask))
+        ++visible;
+    }
+  }
+
+  // the box is too small to be hit by any sample, treat it as visible
+  if (hits == 0u)
+    return 1.0;
+  return static_cast<double>(visible) / hits;
+}
+
+//////////////////////////////////////////////////
+bool VisibilityIndexPrivate::Occluded(const double _origin[3],
+    const double _invDir[3], const IndexEntry &_entry, double _distance,
+    uint32_t _mask) const
+{
+  std::vector<unsigned int> stack;
+  stack.push_back(0u);
+  while (!stack.empty())
+  {
+    const IndexNode &node = this->nodes[stack.back()];
+    unsigned int nodeIndex = stack.back();
+    stack.pop_back();
+
+    double tNear;
+    if (!intersectRay(node.min, node.max, _origin, _invDir, tNear) ||
+        tNear >= _distance)
+    {
+      continue;
+    }
+
+    if (node.count == 0u)
+    {
+      stack.push_back(node.offset);
+      stack.push_back(nodeIndex + 1);
+      continue;
+    }
+
+    for (unsigned int e = node.offset; e < node.offset + node.count; ++e)
+    {
+      const IndexEntry &occluder = this->entries[e];
+      // only root level visuals occlude, and never the model the target
+      // belongs to
+      if (occluder.root != occluder.id || occluder.root == _entry.root ||
+          !(occluder.flags & _mask))
+      {
+        continue;
+      }
+      // a box that contains the camera can not be used as an occluder
+      if (intersectRay(occluder.min, occluder.max, _origin, _invDir, tNear) &&
+          tNear > 0.0 && tNear < _distance)
+      {
+        return true;
+      }
+    }
+  }
+  return false;
+}
@@ -16,6 +16,7 @@
 */
 
 #include <gtest/gtest.h>
+#include <cmath>
 #include <string>
 
 #include <ignition/common/Console.hh>
@@ -537,6 +538,53 @@ void VisualTest::BoundingBox(const std::string &_renderEngine)
   EXPECT_EQ(ignition::math::Vector3d(0.5, 1.5, 2.5), boundingBox.Min());
   EXPECT_EQ(ignition::math::Vector3d(1.5, 2.5, 3.5), boundingBox.Max());
 
+  // child visuals are included at their own pose
+  VisualPtr child = scene->CreateVisual();
+  ASSERT_NE(nullptr, child);
+  child->AddGeometry(scene->CreateBox());
+  visual->AddChild(child);
+  child->SetLocalPosition(2.0, 0.0, 0.0);
+
+  localBoundingBox = visual->LocalBoundingBox();
+  boundingBox = visual->BoundingBox();
+  EXPECT_EQ(ignition::math::Vector3d(-0.5, -0.5, -0.5), localBoundingBox.Min());
+  EXPECT_EQ(ignition::math::Vector3d(2.5, 0.5, 0.5), localBoundingBox.Max());
+  EXPECT_EQ(ignition::math::Vector3d(0.5, 1.5, 2.5), boundingBox.Min());
+  EXPECT_EQ(ignition::math::Vector3d(3.5, 2.5, 3.5), boundingBox.Max());
+
+  // bounds are updated when an ancestor moves
+  visual->SetWorldPosition(0.0, 0.0, 0.0);
+  boundingBox = visual->BoundingBox();
+  EXPECT_EQ(ignition::math::Vector3d(-0.5, -0.5, -0.5), boundingBox.Min());
+  EXPECT_EQ(ignition::math::Vector3d(2.5, 0.5, 0.5), boundingBox.Max());
+  boundingBox = child->BoundingBox();
+  EXPECT_EQ(ignition::math::Vector3d(1.5, -0.5, -0.5), boundingBox.Min());
+  EXPECT_EQ(ignition::math::Vector3d(2.5, 0.5, 0.5), boundingBox.Max());
+
+  // bounds are updated when a descendant is scaled or rotated
+  child->SetLocalScale(2.0);
+  boundingBox = visual->BoundingBox();
+  EXPECT_EQ(ignition::math::Vector3d(-0.5, -1.0, -1.0), boundingBox.Min());
+  EXPECT_EQ(ignition::math::Vector3d(3.0, 1.0, 1.0), boundingBox.Max());
+
+  child->SetLocalScale(1.0);
+  child->SetLocalRotation(0.0, 0.0, IGN_PI / 4);
+  double halfDiagonal = std::sqrt(0.5);
+  boundingBox = visual->BoundingBox();
+  EXPECT_EQ(ignition::math::Vector3d(-0.5, -halfDiagonal, -0.5),
+      boundingBox.Min());
+  EXPECT_EQ(ignition::math::Vector3d(2.0 + halfDiagonal, halfDiagonal, 0.5),
+      boundingBox.Max());
+
+  // bounds are updated when geometries are removed
+  child->RemoveGeometries();
+  localBoundingBox = visual->LocalBoundingBox();
+  boundingBox = visual->BoundingBox();
+  EXPECT_EQ(ignition::math::Vector3d(-0.5, -0.5, -0.5), localBoundingBox.Min());
+  EXPECT_EQ(ignition::math::Vector3d(0.5, 0.5, 0.5), localBoundingBox.Max());
+  EXPECT_EQ(ignition::math::Vector3d(-0.5, -0.5, -0.5), boundingBox.Min());
+  EXPECT_EQ(ignition::math::Vector3d(0.5, 0.5, 0.5), boundingBox.Max());
+
   // Clean up
   engine->DestroyScene(scene);
   rendering::unloadEngine(engine->Name());
@@ -0,0 +1,900 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <ignition/common/ColladaLoader.hh>
+#include <ignition/common/Console.hh>
+#include <ignition/common/Material.hh>
+#include <ignition/common/Mesh.hh>
+#include <ignition/common/MeshManager.hh>
+#include <ignition/common/OBJLoader.hh>
+#include <ignition/common/STLLoader.hh>
+#include <ignition/common/SubMesh.hh>
+#include <ignition/common/Util.hh>
+
+#include "ignition/rendering/Mesh.hh"
+#include "ignition/rendering/MeshDescriptor.hh"
+#include "ignition/rendering/Scene.hh"
+#include "ignition/rendering/Sensor.hh"
+#include "ignition/rendering/Visual.hh"
+#include "ignition/rendering/WorldStreamer.hh"
+
+/// \brief Size of the blocks read when prefetching texture files
+static const size_t kReadBlockSize = 1u << 16;
+
+/// \brief Cell coordinates on the XY plane
+typedef std::pair<int, int> CellKey;
+
+/// \brief Loading state of a cell
+enum CellState
+{
+  /// \brief No visual is created
+  CS_UNLOADED,
+
+  /// \brief Meshes are being loaded or visuals created
+  CS_LOADING,
+
+  /// \brief All visuals are created
+  CS_LOADED
+};
+
+/// \brief A streamed model
+struct ModelState
+{
+  /// \brief Model description
+  ignition::rendering::StreamedModel desc;
+
+  /// \brief Cell of the model
+  CellKey cell;
+
+  /// \brief Visual, null when not loaded
+  ignition::rendering::VisualPtr visual;
+
+  /// \brief Estimated memory of the model when loaded
+  uint64_t bytes = 0u;
+};
+
+/// \brief A square area of the world
+struct StreamCell
+{
+  /// \brief Names of the models in the cell
+  std::vector<std::string> models;
+
+  /// \brief Loading state
+  CellState state = CS_UNLOADED;
+
+  /// \brief Number of models that remain to be created while loading
+  unsigned int remaining = 0u;
+
+  /// \brief Time the cell was scheduled for loading
+  std::chrono::steady_clock::time_point requested;
+
+  /// \brief Estimated memory of the created visuals
+  uint64_t bytes = 0u;
+};
+
+/// \brief Meshes to load for some models of a cell
+struct LoadJob
+{
+  /// \brief Cell of the models
+  CellKey cell;
+
+  /// \brief Model names
+  std::vector<std::string> models;
+
+  /// \brief Mesh of each model
+  std::vector<std::string> meshes;
+
+  /// \brief File to parse for each model, empty if the mesh is expected
+  /// to be in common::MeshManager when the visual is created
+  std::vector<std::string> files;
+
+  /// \brief Mesh parsed by a worker for each model, not yet known to
+  /// common::MeshManager
+  std::vector<std::unique_ptr<ignition::common::Mesh>> parsed;
+};
+
+/// \brief Parse a mesh file without common::MeshManager, which is not
+/// thread safe
+/// \param[in] _file Mesh file
+/// \return New mesh, null if the file could not be parsed
+static ignition::common::Mesh *ParseMesh(const std::string &_file)
+{
+  std::string extension = ignition::common::lowercase(
+      _file.substr(_file.rfind('.') + 1));
+  if (extension == "dae")
+    return ignition::common::ColladaLoader().Load(_file);
+  if (extension == "obj")
+    return ignition::common::OBJLoader().Load(_file);
+  if (extension == "stl")
+    return ignition::common::STLLoader().Load(_file);
+  return nullptr;
+}
+
+/// \brief Estimate the GPU memory of a mesh, uploaded as position, normal
+/// and texture coordinates
+/// \param[in] _mesh Mesh
+/// \return Memory in bytes
+static uint64_t MeshBytes(const ignition::common::Mesh *_mesh)
+{
+  uint64_t bytes = 0u;
+  for (unsigned int s = 0; s < _mesh->SubMeshCount(); ++s)
+  {
+    auto subMesh = _mesh->SubMeshByIndex(s).lock();
+    if (!subMesh)
+      continue;
+    bytes += static_cast<uint64_t>(subMesh->VertexCount()) * 8u *
+        sizeof(float);
+    bytes += static_cast<uint64_t>(subMesh->IndexCount()) *
+        sizeof(uint32_t);
+  }
+  return bytes;
+}
+
+/// \brief Private data class for WorldStreamer
+class ignition::rendering::WorldStreamerPrivate
+{
+  /// \brief Worker thread function
+  public: void Run();
+
+  /// \brief Parse the mesh files of a job
+  /// \param[in,out] _job Job to process
+  public: void Process(LoadJob &_job);
+
+  /// \brief Start the workers if needed and queue a job for some models
+  /// of a cell. Must be called on the render thread, which resolves the
+  /// mesh files and finds the meshes already in common::MeshManager.
+  /// \param[in] _key Cell of the models
+  /// \param[in] _models Model names
+  public: void Queue(const CellKey &_key,
+      const std::vector<std::string> &_models);
+
+  /// \brief Get the mesh of a model of a finished job, adding the mesh
+  /// parsed by the workers to common::MeshManager if needed. Must be called
+  /// on the render thread.
+  /// \param[in,out] _job Finished job
+  /// \param[in] _index Index of the model in the job
+  /// \return Mesh, null if it failed to load
+  public: const common::Mesh *Register(LoadJob &_job, size_t _index);
+
+  /// \brief Stop and join the worker threads
+  public: void StopWorkers();
+
+  /// \brief Move finished jobs to the ready queue
+  /// \param[in] _wait Wait until no job is queued or in progress
+  public: void Collect(bool _wait);
+
+  /// \brief Create the visuals of finished jobs
+  /// \param[in] _max Maximum number of visuals to create
+  public: void Create(unsigned int _max);
+
+  /// \brief Destroy the visuals of a cell
+  /// \param[in] _key Cell to unload
+  public: void Unload(const CellKey &_key);
+
+  /// \brief Get the distance from the closest sensor to a cell
+  /// \param[in] _key Cell
+  /// \param[in] _positions Sensor positions
+  /// \return Distance on the XY plane
+  public: double Distance(const CellKey &_key,
+      const std::vector<math::Vector3d> &_positions) const;
+
+  /// \brief Scene to create the visuals in
+  public: ScenePtr scene;
+
+  /// \brief Length of a cell side
+  public: double cellSize = 50.0;
+
+  /// \brief Distance under which cells are loaded
+  public: double loadDistance = 200.0;
+
+  /// \brief Distance beyond which cells may be unloaded
+  public: double unloadDistance = 250.0;
+
+  /// \brief Memory budget in bytes
+  public: uint64_t memoryBudget = 512u * 1024u * 1024u;
+
+  /// \brief Maximum number of visuals created per update
+  public: unsigned int maxLoadsPerUpdate = 64u;
+
+  /// \brief Models by name
+  public: std::map<std::string, ModelState> models;
+
+  /// \brief Cells with models
+  public: std::map<CellKey, StreamCell> cells;
+
+  /// \brief Sensors driving the loads
+  public: std::vector<SensorPtr> sensors;
+
+  /// \brief Estimated memory of the loaded models
+  public: uint64_t memory = 0u;
+
+  /// \brief Number of loaded models
+  public: unsigned int loadedModels = 0u;
+
+  /// \brief Number of cells loaded so far
+  public: uint64_t loadCount = 0u;
+
+  /// \brief Number of cells unloaded so far
+  public: uint64_t unloadCount = 0u;
+
+  /// \brief Sum of the load latencies, in seconds
+  public: double latencySum = 0.0;
+
+  /// \brief Longest load latency, in seconds
+  public: double latencyMax = 0.0;
+
+  /// \brief Finished jobs whose visuals remain to be created
+  public: std::deque<LoadJob> ready;
+
+  /// \brief Index of the next model to create in the first ready job
+  public: size_t readyIndex = 0u;
+
+  /// \brief Number of worker threads
+  public: unsigned int workerCount = 1u;
+
+  /// \brief Worker threads, started with the first job
+  public: std::vector<std::thread> workers;
+
+  /// \brief Protects the members below
+  public: std::mutex mutex;
+
+  /// \brief Notified when a job is queued or the workers must stop
+  public: std::condition_variable jobQueued;
+
+  /// \brief Notified when a job is done
+  public: std::condition_variable jobDone;
+
+  /// \brief True while workers are asked to exit
+  public: bool stopping = false;
+
+  /// \brief Jobs waiting for a worker
+  public: std::deque<LoadJob> queue;
+
+  /// \brief Number of jobs being processed by workers
+  public: unsigned int inProgress = 0u;
+
+  /// \brief Finished jobs
+  public: std::deque<LoadJob> done;
+};
+
+using namespace ignition;
+using namespace rendering;
+
+//////////////////////////////////////////////////
+void WorldStreamerPrivate::Run()
+{
+  std::unique_lock<std::mutex> lock(this->mutex);
+  while (true)
+  {
+    this->jobQueued.wait(lock, [this]
+        {
+          return this->stopping || !this->queue.empty();
+        });
+    if (this->queue.empty())
+      return;
+
+    LoadJob job = std::move(this->queue.front());
+    this->queue.pop_front();
+    ++this->inProgress;
+    lock.unlock();
+
+    this->Process(job);
+
+    lock.lock();
+    this->done.push_back(std::move(job));
+    --this->inProgress;
+    this->jobDone.notify_all();
+  }
+}
+
+//////////////////////////////////////////////////
+void WorldStreamerPrivate::Process(LoadJob &_job)
+{
+  _job.parsed.resize(_job.files.size());
+  std::set<std::string> textures;
+  for (size_t i = 0; i < _job.files.size(); ++i)
+  {
+    if (_job.files[i].empty())
+      continue;
+
+    _job.parsed[i].reset(ParseMesh(_job.files[i]));
+    const common::Mesh *mesh = _job.parsed[i].get();
+    if (!mesh)
+      continue;
+
+    for (unsigned int m = 0; m < mesh->MaterialCount(); ++m)
+    {
+      auto material = mesh->MaterialByIndex(m);
+      if (material && !material->TextureImage().empty())
+        textures.insert(material->TextureImage());
+    }
+  }
+
+  // read the textures so that the render engine finds them in the file
+  // cache when it loads them on the render thread
+  std::vector<char> block(kReadBlockSize);
+  for (const auto &texture : textures)
+  {
+    std::ifstream file(texture, std::ios::binary);
+    while (file)
+      file.read(block.data(), block.size());
+  }
+}
+
+//////////////////////////////////////////////////
+void WorldStreamerPrivate::Queue(const CellKey &_key,
+    const std::vector<std::string> &_models)
+{
+  LoadJob job;
+  job.cell = _key;
+  job.models = _models;
+
+  // each file is parsed once per job, the models sharing it find the mesh
+  // in common::MeshManager once the first one is created
+  common::MeshManager *meshManager = common::MeshManager::Instance();
+  std::set<std::string> meshes;
+  for (const auto &name : _models)
+  {
+    const std::string &mesh = this->models[name].desc.mesh;
+    job.meshes.push_back(mesh);
+    if (meshManager->HasMesh(mesh) || !meshes.insert(mesh).second)
+      job.files.push_back(std::string());
+    else
+      job.files.push_back(common::findFile(mesh));
+  }
+
+  std::lock_guard<std::mutex> lock(this->mutex);
+  if (this->workers.size() < this->workerCount)
+  {
+    for (unsigned int i = static_cast<unsigned int>(this->workers.size());
+         i < this->workerCount; ++i)
+    {
+      this->workers.emplace_back(&WorldStreamerPrivate::Run, this);
+    }
+  }
+  this->queue.push_back(std::move(job));
+  this->jobQueued.notify_one();
+}
+
+//////////////////////////////////////////////////
+const common::Mesh *WorldStreamerPrivate::Register(LoadJob &_job,
+    size_t _index)
+{
+  // another job may have added the same mesh since this one was queued
+  common::MeshManager *meshManager = common::MeshManager::Instance();
+  const std::string &name = _job.meshes[_index];
+  if (meshManager->HasMesh(name))
+    return meshManager->MeshByName(name);
+
+  if (_index >= _job.parsed.size() || !_job.parsed[_index])
+    return nullptr;
+
+  common::Mesh *mesh = _job.parsed[_index].release();
+  mesh->SetName(name);
+  meshManager->AddMesh(mesh);
+  return mesh;
+}
+
+//////////////////////////////////////////////////
+void WorldStreamerPrivate::StopWorkers()
+{
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->stopping = true;
+    this->jobQueued.notify_all();
+  }
+
+  // workers finish the queued jobs before exiting
+  for (auto &worker : this->workers)
+    worker.join();
+
+  std::lock_guard<std::mutex> lock(this->mutex);
+  this->workers.clear();
+  this->stopping = false;
+}
+
+//////////////////////////////////////////////////
+void WorldStreamerPrivate::Collect(bool _wait)
+{
+  std::deque<LoadJob> jobs;
+  {
+    std::unique_lock<std::mutex> lock(this->mutex);
+    if (this->workerCount == 0u)
+    {
+      // no workers, load here
+      jobs.swap(this->queue);
+      lock.unlock();
+      for (auto &job : jobs)
+        this->Process(job);
+      lock.lock();
+      for (auto &job : jobs)
+        this->done.push_back(std::move(job));
+      jobs.clear();
+    }
+    else if (_wait)
+    {
+      this->jobDone.wait(lock, [this]
+          {
+            return this->queue.empty() && this->inProgress == 0u;
+          });
+    }
+    jobs.swap(this->done);
+  }
+
+  for (auto &job : jobs)
+    this->ready.push_back(std::move(job));
+}
+
+//////////////////////////////////////////////////
+void WorldStreamerPrivate::Create(unsigned int _max)
+{
+  unsigned int created = 0u;
+  while (!this->ready.empty() && created < _max)
+  {
+    LoadJob &job = this->ready.front();
+    if (this->readyIndex >= job.models.size())
+    {
+      this->ready.pop_front();
+      this->readyIndex = 0u;
+      continue;
+    }
+
+    size_t index = this->readyIndex++;
+    const common::Mesh *loaded = this->Register(job, index);
+    auto cellIt = this->cells.find(job.cell);
+    if (cellIt == this->cells.end() || cellIt->second.state != CS_LOADING)
+      continue;
+    StreamCell &cell = cellIt->second;
+
+    // the model may have been removed while its mesh was loading
+    auto modelIt = this->models.find(job.models[index]);
+    if (modelIt != this->models.end() && !modelIt->second.visual &&
+        modelIt->second.cell == job.cell && loaded)
+    {
+      ModelState &model = modelIt->second;
+      MeshPtr mesh = this->scene->CreateMesh(MeshDescriptor(loaded));
+      if (mesh)
+      {
+        model.visual = this->scene->CreateVisual();
+        model.visual->AddGeometry(mesh);
+        if (model.desc.material)
+          model.visual->SetMaterial(model.desc.material, false);
+        model.visual->SetLocalPose(model.desc.pose);
+        model.visual->SetLocalScale(model.desc.scale);
+        this->scene->RootVisual()->AddChild(model.visual);
+        model.bytes = MeshBytes(loaded);
+        cell.bytes += model.bytes;
+        this->memory += model.bytes;
+        ++this->loadedModels;
+        ++created;
+      }
+    }
+    else if (modelIt != this->models.end() && !loaded)
+    {
+      ignerr << "Unable to load mesh [" << job.meshes[index]
+             << "] of streamed model [" << job.models[index] << "]"
+             << std::endl;
+    }
+
+    if (cell.remaining > 0u && --cell.remaining == 0u)
+    {
+      cell.state = CS_LOADED;
+      double latency = std::chrono::duration<double>(
+          std::chrono::steady_clock::now() - cell.requested).count();
+      this->latencySum += latency;
+      this->latencyMax = std::max(this->latencyMax, latency);
+      ++this->loadCount;
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+void WorldStreamerPrivate::Unload(const CellKey &_key)
+{
+  StreamCell &cell = this->cells[_key];
+  for (const auto &name : cell.models)
+  {
+    auto it = this->models.find(name);
+    if (it == this->models.end() || !it->second.visual)
+      continue;
+    this->scene->DestroyVisual(it->second.visual, true);
+    it->second.visual.reset();
+    this->memory -= it->second.bytes;
+    --this->loadedModels;
+  }
+  cell.bytes = 0u;
+  cell.state = CS_UNLOADED;
+  ++this->unloadCount;
+}
+
+//////////////////////////////////////////////////
+double WorldStreamerPrivate::Distance(const CellKey &_key,
+    const std::vector<math::Vector3d> &_positions) const
+{
+  double minX = _key.first * this->cellSize;
+  double minY = _key.second * this->cellSize;
+  double distance = std::numeric_limits<double>::max();
+  for (const auto &position : _positions)
+  {
+    double dx = std::max({minX - position.X(), 0.0,
+        position.X() - minX - this->cellSize});
+    double dy = std::max({minY - position.Y(), 0.0,
+        position.Y() - minY - this->cellSize});
+    distance = std::min(distance, std::sqrt(dx * dx + dy * dy));
+  }
+  return distance;
+}
+
+//////////////////////////////////////////////////
+WorldStreamer::WorldStreamer(const ScenePtr &_scene)
+    : dataPtr(new WorldStreamerPrivate)
+{
+  this->dataPtr->scene = _scene;
+  if (!_scene)
+    ignerr << "Unable to stream a world without scene" << std::endl;
+}
+
+//////////////////////////////////////////////////
+WorldStreamer::~WorldStreamer()
+{
+  this->dataPtr->StopWorkers();
+  if (!this->dataPtr->scene)
+    return;
+
+  for (auto &model : this->dataPtr->models)
+  {
+    if (model.second.visual)
+      this->dataPtr->scene->DestroyVisual(model.second.visual, true);
+  }
+}
+
+//////////////////////////////////////////////////
+void WorldStreamer::SetCellSize(double _size)
+{
+  if (_size <= 0.0)
+  {
+    ignerr << "Cell size must be positive" << std::endl;
+    return;
+  }
+  this->dataPtr->cellSize = _size;
+}
+
+//////////////////////////////////////////////////
+double WorldStreamer::CellSize() const
+{
+  return this->dataPtr->cellSize;
+}
+
+//////////////////////////////////////////////////
+void WorldStreamer::SetLoadDistance(double _distance)
+{
+  this->dataPtr->loadDistance = std::max(0.0, _distance);
+  this->dataPtr->unloadDistance = std::max(this->dataPtr->unloadDistance,
+      this->dataPtr->loadDistance);
+}
+
+//////////////////////////////////////////////////
+double WorldStreamer::LoadDistance() const
+{
+  return this->dataPtr->loadDistance;
+}
+
+//////////////////////////////////////////////////
+void WorldStreamer::SetUnloadDistance(double _distance)
+{
+  this->dataPtr->unloadDistance = std::max(0.0, _distance);
+  this->dataPtr->loadDistance = std::min(this->dataPtr->loadDistance,
+      this->dataPtr->unloadDistance);
+}
+
+//////////////////////////////////////////////////
+double WorldStreamer::UnloadDistance() const
+{
+  return this->dataPtr->unloadDistance;
+}
+
+//////////////////////////////////////////////////
+void WorldStreamer::SetMemoryBudget(uint64_t _bytes)
+{
+  this->dataPtr->memoryBudget = _bytes;
+}
+
+//////////////////////////////////////////////////
+uint64_t WorldStreamer::MemoryBudget() const
+{
+  return this->dataPtr->memoryBudget;
+}
+
+//////////////////////////////////////////////////
+void WorldStreamer::SetMaxLoadsPerUpdate(unsigned int _count)
+{
+  this->dataPtr->maxLoadsPerUpdate = std::max(1u, _count);
+}
+
+//////////////////////////////////////////////////
+unsigned int WorldStreamer::MaxLoadsPerUpdate() const
+{
+  return this->dataPtr->maxLoadsPerUpdate;
+}
+
+//////////////////////////////////////////////////
+void WorldStreamer::SetWorkerCount(unsigned int _count)
+{
+  this->dataPtr->StopWorkers();
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->workerCount = _count;
+}
+
+//////////////////////////////////////////////////
+unsigned int WorldStreamer::WorkerCount() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->workerCount;
+}
+
+//////////////////////////////////////////////////
+bool WorldStreamer::AddModel(const StreamedModel &_model)
+{
+  if (_model.name.empty() || _model.mesh.empty())
+  {
+    ignerr << "Streamed models need a name and a mesh" << std::endl;
+    return false;
+  }
+  if (this->dataPtr->models.count(_model.name))
+  {
+    ignerr << "Streamed model [" << _model.name << "] already exists"
+           << std::endl;
+    return false;
+  }
+
+  ModelState &model = this->dataPtr->models[_model.name];
+  model.desc = _model;
+  model.cell = CellKey(
+      static_cast<int>(std::floor(_model.pose.Pos().X() /
+          this->dataPtr->cellSize)),
+      static_cast<int>(std::floor(_model.pose.Pos().Y() /
+          this->dataPtr->cellSize)));
+
+  StreamCell &cell = this->dataPtr->cells[model.cell];
+  cell.models.push_back(_model.name);
+
+  // models added to a loaded cell are loaded right away
+  if (cell.state != CS_UNLOADED)
+  {
+    if (cell.state == CS_LOADED)
+    {
+      cell.state = CS_LOADING;
+      cell.requested = std::chrono::steady_clock::now();
+    }
+    ++cell.remaining;
+    this->dataPtr->Queue(model.cell, {_model.name});
+  }
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool WorldStreamer::RemoveModel(const std::string &_name)
+{
+  auto it = this->dataPtr->models.find(_name);
+  if (it == this->dataPtr->models.end())
+    return false;
+
+  ModelState &model = it->second;
+  StreamCell &cell = this->dataPtr->cells[model.cell];
+  if (model.visual)
+  {
+    if (this->dataPtr->scene)
+      this->dataPtr->scene->DestroyVisual(model.visual, true);
+    cell.bytes -= model.bytes;
+    this->dataPtr->memory -= model.bytes;
+    --this->dataPtr->loadedModels;
+  }
+  cell.models.erase(std::remove(cell.models.begin(), cell.models.end(),
+      _name), cell.models.end());
+  this->dataPtr->models.erase(it);
+  return true;
+}
+
+//////////////////////////////////////////////////
+unsigned int WorldStreamer::ModelCount() const
+{
+  return static_cast<unsigned int>(this->dataPtr->models.size());
+}
+
+//////////////////////////////////////////////////
+VisualPtr WorldStreamer::ModelVisual(const std::string &_name) const
+{
+  auto it = this->dataPtr->models.find(_name);
+  if (it == this->dataPtr->models.end())
+    return VisualPtr();
+  return it->second.visual;
+}
+
+//////////////////////////////////////////////////
+void WorldStreamer::AddSensor(const SensorPtr &_sensor)
+{
+  if (!_sensor)
+    return;
+  auto &sensors = this->dataPtr->sensors;
+  if (std::find(sensors.begin(), sensors.end(), _sensor) == sensors.end())
+    sensors.push_back(_sensor);
+}
+
+//////////////////////////////////////////////////
+void WorldStreamer::RemoveSensor(const SensorPtr &_sensor)
+{
+  auto &sensors = this->dataPtr->sensors;
+  sensors.erase(std::remove(sensors.begin(), sensors.end(), _sensor),
+      sensors.end());
+}
+
+//////////////////////////////////////////////////
+unsigned int WorldStreamer::SensorCount() const
+{
+  return static_cast<unsigned int>(this->dataPtr->sensors.size());
+}
+
+//////////////////////////////////////////////////
+void WorldStreamer::Update()
+{
+  if (!this->dataPtr->scene)
+    return;
+
+  std::vector<math::Vector3d> positions;
+  for (const auto &sensor : this->dataPtr->sensors)
+    positions.push_back(sensor->WorldPosition());
+
+  // schedule the cells in range, nearest first
+  std::vector<std::pair<double, CellKey>> candidates;
+  for (const auto &cellIt : this->dataPtr->cells)
+  {
+    if (cellIt.second.state != CS_UNLOADED || cellIt.second.models.empty())
+      continue;
+    double distance = this->dataPtr->Distance(cellIt.first, positions);
+    if (distance < this->dataPtr->loadDistance)
+      candidates.emplace_back(distance, cellIt.first);
+  }
+  std::sort(candidates.begin(), candidates.end());
+
+  auto now = std::chrono::steady_clock::now();
+  for (const auto &candidate : candidates)
+  {
+    StreamCell &cell = this->dataPtr->cells[candidate.second];
+    cell.state = CS_LOADING;
+    cell.requested = now;
+    cell.remaining = static_cast<unsigned int>(cell.models.size());
+    this->dataPtr->Queue(candidate.second, cell.models);
+  }
+
+  this->dataPtr->Collect(false);
+  this->dataPtr->Create(this->dataPtr->maxLoadsPerUpdate);
+
+  // unload the farthest cells out of range while over budget
+  if (this->dataPtr->memory <= this->dataPtr->memoryBudget)
+    return;
+
+  candidates.clear();
+  for (const auto &cellIt : this->dataPtr->cells)
+  {
+    if (cellIt.second.state != CS_LOADED)
+      continue;
+    double distance = this->dataPtr->Distance(cellIt.first, positions);
+    if (distance > this->dataPtr->unloadDistance)
+      candidates.emplace_back(distance, cellIt.first);
+  }
+  std::sort(candidates.rbegin(), candidates.rend());
+  for (const auto &candidate : candidates)
+  {
+    if (this->dataPtr->memory <= this->dataPtr->memoryBudget)
+      break;
+    this->dataPtr->Unload(candidate.second);
+  }
+}
+
+//////////////////////////////////////////////////
+void WorldStreamer::Flush()
+{
+  if (!this->dataPtr->scene)
+    return;
+
+  this->dataPtr->Collect(true);
+  this->dataPtr->Create(std::numeric_limits<unsigned int>::max());
+}
+
+//////////////////////////////////////////////////
+unsigned int WorldStreamer::CellCount() const
+{
+  unsigned int count = 0u;
+  for (const auto &cell : this->dataPtr->cells)
+    count += cell.second.models.empty() ? 0u : 1u;
+  return count;
+}
+
+//////////////////////////////////////////////////
+unsigned int WorldStreamer::LoadedCellCount() const
+{
+  unsigned int count = 0u;
+  for (const auto &cell : this->dataPtr->cells)
+  {
+    if (cell.second.state == CS_LOADED && !cell.second.models.empty())
+      ++count;
+  }
+  return count;
+}
+
+//////////////////////////////////////////////////
+unsigned int WorldStreamer::PendingCellCount() const
+{
+  unsigned int count = 0u;
+  for (const auto &cell : this->dataPtr->cells)
+    count += cell.second.state == CS_LOADING ? 1u : 0u;
+  return count;
+}
+
+//////////////////////////////////////////////////
+unsigned int WorldStreamer::LoadedModelCount() const
+{
+  return this->dataPtr->loadedModels;
+}
+
+//////////////////////////////////////////////////
+uint64_t WorldStreamer::MemoryUsage() const
+{
+  return this->dataPtr->memory;
+}
+
+//////////////////////////////////////////////////
+uint64_t WorldStreamer::LoadCount() const
+{
+  return this->dataPtr->loadCount;
+}
+
+//////////////////////////////////////////////////
+uint64_t WorldStreamer::UnloadCount() const
+{
+  return this->dataPtr->unloadCount;
+}
+
+//////////////////////////////////////////////////
+double WorldStreamer::AverageLoadLatency() const
+{
+  if (this->dataPtr->loadCount == 0u)
+    return 0.0;
+  return this->dataPtr->latencySum / this->dataPtr->loadCount;
+}
+
+//////////////////////////////////////////////////
+double WorldStreamer::MaxLoadLatency() const
+{
+  return this->dataPtr->latencyMax;
+}
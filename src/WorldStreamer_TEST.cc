@@ -0,0 +1,252 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+#include <ignition/common/Console.hh>
+#include <ignition/common/Filesystem.hh>
+#include <ignition/common/MeshManager.hh>
+
+#include "test_config.h"  // NOLINT(build/include)
+
+#include "ignition/rendering/Camera.hh"
+#include "ignition/rendering/RenderEngine.hh"
+#include "ignition/rendering/RenderingIface.hh"
+#include "ignition/rendering/Scene.hh"
+#include "ignition/rendering/WorldStreamer.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+class WorldStreamerTest : public testing::Test,
+                          public testing::WithParamInterface<const char *>
+{
+  /// \brief Test loading and unloading cells along a camera path
+  public: void Streaming(const std::string &_renderEngine);
+};
+
+/////////////////////////////////////////////////
+/// \brief Count the cells of a 10x10 grid of 20 m cells within a distance
+/// of a position
+/// \param[in] _x X position
+/// \param[in] _y Y position
+/// \param[in] _distance Distance
+/// \return Number of cells
+unsigned int cellsInRange(double _x, double _y, double _distance)
+{
+  unsigned int count = 0u;
+  for (int i = 0; i < 10; ++i)
+  {
+    for (int j = 0; j < 10; ++j)
+    {
+      double dx = std::max({i * 20.0 - _x, 0.0, _x - i * 20.0 - 20.0});
+      double dy = std::max({j * 20.0 - _y, 0.0, _y - j * 20.0 - 20.0});
+      if (std::sqrt(dx * dx + dy * dy) < _distance)
+        ++count;
+    }
+  }
+  return count;
+}
+
+/////////////////////////////////////////////////
+void WorldStreamerTest::Streaming(const std::string &_renderEngine)
+{
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+
+  CameraPtr camera = scene->CreateCamera("camera");
+  ASSERT_NE(nullptr, camera);
+  scene->RootVisual()->AddChild(camera);
+
+  // the streamer must be destroyed before the scene
+  {
+    WorldStreamer streamer(scene);
+
+    // verify initial values
+    EXPECT_DOUBLE_EQ(50.0, streamer.CellSize());
+    EXPECT_DOUBLE_EQ(200.0, streamer.LoadDistance());
+    EXPECT_DOUBLE_EQ(250.0, streamer.UnloadDistance());
+    EXPECT_EQ(64u, streamer.MaxLoadsPerUpdate());
+    EXPECT_EQ(1u, streamer.WorkerCount());
+    EXPECT_EQ(0u, streamer.ModelCount());
+    EXPECT_EQ(0u, streamer.SensorCount());
+
+    // no workers, so that loading happens in Update()
+    streamer.SetWorkerCount(0u);
+    EXPECT_EQ(0u, streamer.WorkerCount());
+    streamer.SetCellSize(20.0);
+    EXPECT_DOUBLE_EQ(20.0, streamer.CellSize());
+    streamer.SetUnloadDistance(20.0);
+    EXPECT_DOUBLE_EQ(20.0, streamer.LoadDistance());
+    streamer.SetUnloadDistance(50.0);
+    streamer.SetLoadDistance(30.0);
+    EXPECT_DOUBLE_EQ(30.0, streamer.LoadDistance());
+    EXPECT_DOUBLE_EQ(50.0, streamer.UnloadDistance());
+
+    // 20x20 models in 10x10 cells
+    for (int i = 0; i < 20; ++i)
+    {
+      for (int j = 0; j < 20; ++j)
+      {
+        StreamedModel model;
+        model.name = "model_" + std::to_string(i) + "_" + std::to_string(j);
+        model.mesh = (i + j) % 2 ? "unit_box" : "unit_sphere";
+        model.pose.Set(5.0 + i * 10.0, 5.0 + j * 10.0, 0.5, 0.0, 0.0, 0.0);
+        EXPECT_TRUE(streamer.AddModel(model));
+      }
+    }
+    StreamedModel duplicate;
+    duplicate.name = "model_0_0";
+    duplicate.mesh = "unit_box";
+    EXPECT_FALSE(streamer.AddModel(duplicate));
+    EXPECT_EQ(400u, streamer.ModelCount());
+    EXPECT_EQ(100u, streamer.CellCount());
+
+    // nothing loads without sensors
+    streamer.Update();
+    EXPECT_EQ(0u, streamer.LoadedCellCount());
+
+    streamer.AddSensor(camera);
+    streamer.AddSensor(camera);
+    EXPECT_EQ(1u, streamer.SensorCount());
+
+    camera->SetWorldPosition(10.0, 10.0, 2.0);
+    streamer.Update();
+    unsigned int expected = cellsInRange(10.0, 10.0, 30.0);
+    EXPECT_EQ(expected, streamer.LoadedCellCount());
+    EXPECT_EQ(expected * 4u, streamer.LoadedModelCount());
+    EXPECT_EQ(0u, streamer.PendingCellCount());
+    EXPECT_NE(nullptr, streamer.ModelVisual("model_0_0"));
+    EXPECT_EQ(nullptr, streamer.ModelVisual("model_19_19"));
+    EXPECT_LT(0u, streamer.MemoryUsage());
+
+    // scripted path along the diagonal, within budget nothing is unloaded
+    for (int k = 0; k <= 20; ++k)
+    {
+      camera->SetWorldPosition(10.0 + k * 9.0, 10.0 + k * 9.0, 2.0);
+      streamer.Update();
+    }
+    unsigned int loaded = streamer.LoadedCellCount();
+    EXPECT_EQ(0u, streamer.UnloadCount());
+    EXPECT_EQ(loaded, streamer.LoadCount());
+    EXPECT_LE(0.0, streamer.AverageLoadLatency());
+    EXPECT_LE(streamer.AverageLoadLatency(), streamer.MaxLoadLatency());
+
+    // over budget, only cells beyond the unload distance are unloaded
+    streamer.SetMemoryBudget(1u);
+    EXPECT_EQ(1u, streamer.MemoryBudget());
+    streamer.Update();
+    EXPECT_LT(0u, streamer.UnloadCount());
+    EXPECT_EQ(loaded - streamer.UnloadCount(), streamer.LoadedCellCount());
+    EXPECT_LE(cellsInRange(190.0, 190.0, 30.0), streamer.LoadedCellCount());
+    EXPECT_GE(cellsInRange(190.0, 190.0, 50.0 + 1e-6),
+        streamer.LoadedCellCount());
+
+    // moving less than the hysteresis does not reload anything
+    uint64_t loads = streamer.LoadCount();
+    camera->SetWorldPosition(185.0, 185.0, 2.0);
+    streamer.Update();
+    EXPECT_EQ(loads, streamer.LoadCount());
+
+    // visual creation is spread over updates
+    streamer.SetMemoryBudget(1024u * 1024u * 1024u);
+    streamer.SetMaxLoadsPerUpdate(3u);
+    camera->SetWorldPosition(10.0, 10.0, 2.0);
+    streamer.Update();
+    EXPECT_LT(0u, streamer.PendingCellCount());
+    streamer.Flush();
+    EXPECT_EQ(0u, streamer.PendingCellCount());
+
+    // models added to loaded cells are loaded right away
+    StreamedModel extra;
+    extra.name = "extra";
+    extra.mesh = "unit_cylinder";
+    extra.pose.Set(1.0, 1.0, 0.5, 0.0, 0.0, 0.0);
+    EXPECT_TRUE(streamer.AddModel(extra));
+    streamer.Flush();
+    EXPECT_NE(nullptr, streamer.ModelVisual("extra"));
+    EXPECT_TRUE(streamer.RemoveModel("extra"));
+    EXPECT_FALSE(streamer.RemoveModel("extra"));
+    EXPECT_EQ(nullptr, streamer.ModelVisual("extra"));
+
+    // mesh files are parsed by the workers and added to the mesh manager
+    // when the visuals are created
+    streamer.SetWorkerCount(2u);
+    streamer.SetMaxLoadsPerUpdate(64u);
+    std::string meshFile = common::joinPaths(
+        std::string(PROJECT_SOURCE_PATH), "test", "media", "meshes",
+        "walk.dae");
+    for (int i = 0; i < 2; ++i)
+    {
+      StreamedModel walker;
+      walker.name = "walker_" + std::to_string(i);
+      walker.mesh = meshFile;
+      walker.pose.Set(2.0 + i, 2.0, 0.0, 0.0, 0.0, 0.0);
+      EXPECT_TRUE(streamer.AddModel(walker));
+    }
+    streamer.Flush();
+    EXPECT_NE(nullptr, streamer.ModelVisual("walker_0"));
+    EXPECT_NE(nullptr, streamer.ModelVisual("walker_1"));
+    EXPECT_TRUE(common::MeshManager::Instance()->HasMesh(meshFile));
+    EXPECT_TRUE(streamer.RemoveModel("walker_0"));
+    EXPECT_TRUE(streamer.RemoveModel("walker_1"));
+
+    // same path with worker threads
+    for (int k = 0; k <= 20; ++k)
+    {
+      camera->SetWorldPosition(10.0 + k * 9.0, 10.0 + k * 9.0, 2.0);
+      streamer.Update();
+    }
+    streamer.Flush();
+    EXPECT_EQ(0u, streamer.PendingCellCount());
+    EXPECT_LE(cellsInRange(190.0, 190.0, 30.0), streamer.LoadedCellCount());
+
+    streamer.RemoveSensor(camera);
+    EXPECT_EQ(0u, streamer.SensorCount());
+  }
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+TEST_P(WorldStreamerTest, Streaming)
+{
+  Streaming(GetParam());
+}
+
+INSTANTIATE_TEST_CASE_P(WorldStreamer, WorldStreamerTest,
+    RENDER_ENGINE_VALUES,
+    ignition::rendering::PrintToStringParam());
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -15,6 +15,7 @@
  *
  */
 
+#include <cstdio>
 #include <sstream>
 
 #include <ignition/math/Helpers.hh>
@@ -28,11 +29,15 @@
 #include "ignition/rendering/ArrowVisual.hh"
 #include "ignition/rendering/AxisVisual.hh"
 #include "ignition/rendering/LidarVisual.hh"
+#include "ignition/rendering/BoundingBoxCamera.hh"
 #include "ignition/rendering/Camera.hh"
 #include "ignition/rendering/DepthCamera.hh"
 #include "ignition/rendering/GizmoVisual.hh"
 #include "ignition/rendering/GpuRays.hh"
 #include "ignition/rendering/Grid.hh"
+#include "ignition/rendering/Heightmap.hh"
+#include "ignition/rendering/Material.hh"
+#include "ignition/rendering/MultiViewCamera.hh"
 #include "ignition/rendering/ParticleEmitter.hh"
 #include "ignition/rendering/RayQuery.hh"
 #include "ignition/rendering/RenderTarget.hh"
@@ -633,6 +638,271 @@ void BaseScene::DestroyMaterials()
   this->UnregisterMaterials();
 }
 
+//////////////////////////////////////////////////
+/// \brief Describe the properties a material shared by batch updates keeps
+/// from the original material of a visual, so that visuals with equal
+/// materials, e.g. unique clones of one material, share materials.
+/// \param[in] _material Original material of a visual
+/// \return Description of the material
+static std::string BatchMaterialKey(const MaterialPtr &_material)
+{
+  if (!_material)
+    return std::string();
+
+  std::ostringstream key;
+  key << _material->Ambient() << "|" << _material->Specular() << "|"
+      << _material->Shininess() << "|" << _material->Reflectivity() << "|"
+      << _material->Roughness() << "|" << _material->Metalness() << "|"
+      << _material->LightingEnabled() << _material->DepthCheckEnabled()
+      << _material->DepthWriteEnabled() << _material->CastShadows()
+      << _material->ReceiveShadows() << _material->ReflectionEnabled()
+      << _material->TextureAlphaEnabled() << _material->TwoSidedEnabled()
+      << "|" << _material->AlphaThreshold() << "|" << _material->Texture()
+      << "|" << _material->NormalMap() << "|" << _material->RoughnessMap()
+      << "|" << _material->MetalnessMap() << "|"
+      << _material->EnvironmentMap() << "|" << _material->EmissiveMap()
+      << "|" << _material->Type() << "|" << _material->ShaderType();
+
+  // shader params belong to each material, so materials with custom
+  // shaders are not shared with other original materials
+  if (!_material->VertexShader().empty() ||
+      !_material->FragmentShader().empty())
+  {
+    key << "|" << _material->Name();
+  }
+  return key.str();
+}
+
+//////////////////////////////////////////////////
+void BaseScene::UpdateVisualMaterials(
+    const std::vector<VisualMaterialUpdate> &_updates)
+{
+  auto quantize = [](double _value)
+  {
+    return static_cast<unsigned int>(
+        math::clamp(_value, 0.0, 1.0) * 255.0 + 0.5);
+  };
+
+  // the visuals keep track of their batch materials while they are set
+  this->batchUpdating = true;
+  for (const auto &update : _updates)
+  {
+    VisualPtr visual = update.visual;
+    if (!visual)
+      continue;
+
+    // remember the material the visual had before its first update
+    auto baseIt = this->batchBaseMaterials.find(visual->Id());
+    if (baseIt == this->batchBaseMaterials.end())
+    {
+      baseIt = this->batchBaseMaterials.insert(
+          {visual->Id(), visual->Material()}).first;
+    }
+    MaterialPtr base = baseIt->second;
+
+    // key the shared material with the properties of the original material
+    // and the quantized new properties, so equal updates resolve to the
+    // same material
+    unsigned int q[8] = {
+        quantize(update.diffuse.R()), quantize(update.diffuse.G()),
+        quantize(update.diffuse.B()), quantize(update.diffuse.A()),
+        quantize(update.emissive.R()), quantize(update.emissive.G()),
+        quantize(update.emissive.B()), quantize(update.transparency)};
+    char quantized[17];
+    std::snprintf(quantized, sizeof(quantized),
+        "%02x%02x%02x%02x%02x%02x%02x%02x",
+        q[0], q[1], q[2], q[3], q[4], q[5], q[6], q[7]);
+    std::string key = BatchMaterialKey(base) + "|" + quantized;
+
+    MaterialPtr current;
+    auto currentIt = this->batchVisualMaterials.find(visual->Id());
+    if (currentIt != this->batchVisualMaterials.end())
+      current = currentIt->second;
+
+    MaterialPtr material;
+    auto nameIt = this->batchMaterialNames.find(key);
+    if (nameIt != this->batchMaterialNames.end())
+      material = this->Material(nameIt->second);
+    if (material && material == current)
+      continue;
+
+    if (!material)
+    {
+      material = base ? base->Clone() : this->CreateMaterial();
+      material->SetDiffuse(math::Color(q[0] / 255.0f, q[1] / 255.0f,
+          q[2] / 255.0f, q[3] / 255.0f));
+      material->SetEmissive(math::Color(q[4] / 255.0f, q[5] / 255.0f,
+          q[6] / 255.0f));
+      material->SetTransparency(q[7] / 255.0);
+      this->batchMaterialNames[key] = material->Name();
+    }
+
+    visual->SetMaterial(material, false);
+    this->batchVisualMaterials[visual->Id()] = material;
+    ++this->batchMaterialUsers[material->Name()];
+    this->ReleaseBatchMaterial(current);
+  }
+  this->batchUpdating = false;
+}
+
+//////////////////////////////////////////////////
+void BaseScene::ResetVisualMaterial(VisualPtr _visual)
+{
+  if (!_visual)
+    return;
+
+  auto baseIt = this->batchBaseMaterials.find(_visual->Id());
+  if (baseIt == this->batchBaseMaterials.end())
+    return;
+
+  MaterialPtr current = _visual->Material();
+  this->batchUpdating = true;
+  if (baseIt->second)
+  {
+    _visual->SetMaterial(baseIt->second, false);
+  }
+  else if (current)
+  {
+    // the visual had no material of its own, keep the current properties
+    // in a material that is not shared
+    _visual->SetMaterial(current, true);
+  }
+  this->batchUpdating = false;
+  this->ReleaseVisualMaterial(_visual->Id());
+}
+
+//////////////////////////////////////////////////
+void BaseScene::ReleaseVisualMaterial(unsigned int _visualId)
+{
+  if (this->batchUpdating)
+    return;
+
+  this->batchBaseMaterials.erase(_visualId);
+  auto it = this->batchVisualMaterials.find(_visualId);
+  if (it == this->batchVisualMaterials.end())
+    return;
+
+  MaterialPtr material = it->second;
+  this->batchVisualMaterials.erase(it);
+  this->ReleaseBatchMaterial(material);
+}
+
+//////////////////////////////////////////////////
+const VisibilityIndex &BaseScene::UpdateVisibilityIndex()
+{
+  if (!this->visibilityIndexValid)
+  {
+    this->visibilityIndex.Update(this->shared_from_this());
+    this->visibilityIndexValid = true;
+  }
+  else if (!this->dirtyBounds.empty())
+  {
+    this->visibilityIndex.Update(this->shared_from_this(),
+        this->dirtyBounds);
+  }
+  this->dirtyBounds.clear();
+  return this->visibilityIndex;
+}
+
+//////////////////////////////////////////////////
+void BaseScene::MarkBoundsDirty(unsigned int _nodeId)
+{
+  // nothing to track until the index is used or while it is rebuilt
+  if (!this->visibilityIndexValid)
+    return;
+
+  VisualPtr rootVisual = this->RootVisual();
+  if (!rootVisual || _nodeId == rootVisual->Id())
+  {
+    // root level visuals were added or removed
+    this->visibilityIndexValid = false;
+    this->dirtyBounds.clear();
+    return;
+  }
+
+  // only visuals are indexed
+  NodePtr node = this->VisualById(_nodeId);
+  if (!node)
+    return;
+
+  for (NodePtr parent = node->Parent(); parent; parent = parent->Parent())
+  {
+    if (parent->Id() == rootVisual->Id())
+    {
+      this->dirtyBounds.insert(node->Id());
+      return;
+    }
+    node = parent;
+  }
+}
+
+//////////////////////////////////////////////////
+unsigned int BaseScene::BatchMaterialCount() const
+{
+  return static_cast<unsigned int>(this->batchMaterialUsers.size());
+}
+
+//////////////////////////////////////////////////
+uint32_t BaseScene::VisibilityLayer(const std::string &_name)
+{
+  auto it = this->visibilityLayers.find(_name);
+  if (it != this->visibilityLayers.end())
+    return it->second;
+
+  uint32_t used = 0u;
+  for (const auto &layer : this->visibilityLayers)
+    used |= layer.second;
+
+  uint32_t available = IGN_VISIBILITY_LAYERS & ~used;
+  if (available == 0u)
+  {
+    ignerr << "Unable to create visibility layer [" << _name << "]. All "
+           << this->visibilityLayers.size() << " layers are in use."
+           << std::endl;
+    return 0u;
+  }
+
+  // lowest available flag
+  uint32_t flag = available & ~(available - 1u);
+  this->visibilityLayers[_name] = flag;
+  return flag;
+}
+
+//////////////////////////////////////////////////
+uint32_t BaseScene::VisibilityLayerFlag(const std::string &_name) const
+{
+  auto it = this->visibilityLayers.find(_name);
+  if (it == this->visibilityLayers.end())
+    return 0u;
+  return it->second;
+}
+
+//////////////////////////////////////////////////
+void BaseScene::ReleaseBatchMaterial(MaterialPtr _material)
+{
+  if (!_material)
+    return;
+
+  auto it = this->batchMaterialUsers.find(_material->Name());
+  if (it == this->batchMaterialUsers.end())
+    return;
+
+  if (--it->second == 0u)
+  {
+    this->batchMaterialUsers.erase(it);
+    for (auto nameIt = this->batchMaterialNames.begin();
+        nameIt != this->batchMaterialNames.end(); ++nameIt)
+    {
+      if (nameIt->second == _material->Name())
+      {
+        this->batchMaterialNames.erase(nameIt);
+        break;
+      }
+    }
+    this->DestroyMaterial(_material);
+  }
+}
+
 //////////////////////////////////////////////////
 DirectionalLightPtr BaseScene::CreateDirectionalLight()
 {
@@ -797,6 +1067,61 @@ ThermalCameraPtr BaseScene::CreateThermalCamera(const unsigned int _id,
   return (result) ? camera : nullptr;
 }
 
+//////////////////////////////////////////////////
+MultiViewCameraPtr BaseScene::CreateMultiViewCamera()
+{
+  unsigned int objId = this->CreateObjectId();
+  return this->CreateMultiViewCamera(objId);
+}
+//////////////////////////////////////////////////
+MultiViewCameraPtr BaseScene::CreateMultiViewCamera(const unsigned int _id)
+{
+  std::string objName = this->CreateObjectName(_id, "MultiViewCamera");
+  return this->CreateMultiViewCamera(_id, objName);
+}
+//////////////////////////////////////////////////
+MultiViewCameraPtr BaseScene::CreateMultiViewCamera(const std::string &_name)
+{
+  unsigned int objId = this->CreateObjectId();
+  return this->CreateMultiViewCamera(objId, _name);
+}
+//////////////////////////////////////////////////
+MultiViewCameraPtr BaseScene::CreateMultiViewCamera(const unsigned int _id,
+    const std::string &_name)
+{
+  MultiViewCameraPtr camera = this->CreateMultiViewCameraImpl(_id, _name);
+  bool result = this->RegisterSensor(camera);
+  return (result) ? camera : nullptr;
+}
+
+//////////////////////////////////////////////////
+BoundingBoxCameraPtr BaseScene::CreateBoundingBoxCamera()
+{
+  unsigned int objId = this->CreateObjectId();
+  return this->CreateBoundingBoxCamera(objId);
+}
+//////////////////////////////////////////////////
+BoundingBoxCameraPtr BaseScene::CreateBoundingBoxCamera(const unsigned int _id)
+{
+  std::string objName = this->CreateObjectName(_id, "BoundingBoxCamera");
+  return this->CreateBoundingBoxCamera(_id, objName);
+}
+//////////////////////////////////////////////////
+BoundingBoxCameraPtr BaseScene::CreateBoundingBoxCamera(
+    const std::string &_name)
+{
+  unsigned int objId = this->CreateObjectId();
+  return this->CreateBoundingBoxCamera(objId, _name);
+}
+//////////////////////////////////////////////////
+BoundingBoxCameraPtr BaseScene::CreateBoundingBoxCamera(
+    const unsigned int _id, const std::string &_name)
+{
+  BoundingBoxCameraPtr camera = this->CreateBoundingBoxCameraImpl(_id, _name);
+  bool result = this->RegisterSensor(camera);
+  return (result) ? camera : nullptr;
+}
+
 //////////////////////////////////////////////////
 GpuRaysPtr BaseScene::CreateGpuRays()
 {
@@ -999,6 +1324,12 @@ MeshPtr BaseScene::CreateMesh(const MeshDescriptor &_desc)
   return this->CreateMeshImpl(objId, objName, _desc);
 }
 
+//////////////////////////////////////////////////
+HeightmapPtr BaseScene::CreateHeightmap(const HeightmapDescriptor &_desc)
+{
+  return std::make_shared<Heightmap>(this->shared_from_this(), _desc);
+}
+
 //////////////////////////////////////////////////
 GridPtr BaseScene::CreateGrid()
 {
@@ -1161,6 +1492,10 @@ void BaseScene::PreRender()
 void BaseScene::Clear()
 {
   this->nodes->DestroyAll();
+  this->batchBaseMaterials.clear();
+  this->batchVisualMaterials.clear();
+  this->batchMaterialUsers.clear();
+  this->batchMaterialNames.clear();
   this->DestroyMaterials();
   this->nextObjectId = ignition::math::MAX_UI16;
 }
@@ -62,6 +62,9 @@ class GpuRaysTest: public testing::Test,
   // Test vertical measurements
   public: void LaserVertical(const std::string &_renderEngine);
 
+  // Test vertical measurements with a wide vertical field of view
+  public: void LaserWideVertical(const std::string &_renderEngine);
+
   // Test detection of particles
   public: void RaysParticles(const std::string &_renderEngine);
 };
@@ -463,6 +466,108 @@ void GpuRaysTest::LaserVertical(const std::string &_renderEngine)
   rendering::unloadEngine(engine->Name());
 }
 
+/////////////////////////////////////////////////
+/// \brief Test GPU rays with a vertical field of view wider than 90 degrees
+void GpuRaysTest::LaserWideVertical(const std::string &_renderEngine)
+{
+#ifdef __APPLE__
+  std::cerr << "Skipping test for apple, see issue #35." << std::endl;
+  return;
+#endif
+
+  if (_renderEngine == "optix")
+  {
+    igndbg << "GpuRays not supported yet in rendering engine: "
+            << _renderEngine << std::endl;
+    return;
+  }
+
+  // Rays pointing down, forward and up. Place boxes in front of and above
+  // the sensor and verify range values.
+  double hMinAngle = -0.2;
+  double hMaxAngle = 0.2;
+  double vMinAngle = -IGN_PI/2.0;
+  double vMaxAngle = IGN_PI/2.0;
+  double minRange = 0.1;
+  double maxRange = 5.0;
+  unsigned int hRayCount = 5;
+  unsigned int vRayCount = 3;
+
+  // create and populate scene
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_TRUE(scene != nullptr);
+
+  VisualPtr root = scene->RootVisual();
+
+  GpuRaysPtr gpuRays = scene->CreateGpuRays("wide_vertical_gpu_rays");
+  gpuRays->SetWorldPosition(0, 0, 0);
+  gpuRays->SetNearClipPlane(minRange);
+  gpuRays->SetFarClipPlane(maxRange);
+  gpuRays->SetAngleMin(hMinAngle);
+  gpuRays->SetAngleMax(hMaxAngle);
+  gpuRays->SetVerticalAngleMin(vMinAngle);
+  gpuRays->SetVerticalAngleMax(vMaxAngle);
+  gpuRays->SetRayCount(hRayCount);
+  gpuRays->SetVerticalRayCount(vRayCount);
+  root->AddChild(gpuRays);
+
+  // box in front of ray sensor
+  VisualPtr visualBox1 = scene->CreateVisual("WideVerticalTestBox1");
+  visualBox1->AddGeometry(scene->CreateBox());
+  visualBox1->SetWorldPosition(2, 0, 0);
+  root->AddChild(visualBox1);
+
+  // box above ray sensor
+  VisualPtr visualBox2 = scene->CreateVisual("WideVerticalTestBox2");
+  visualBox2->AddGeometry(scene->CreateBox());
+  visualBox2->SetWorldPosition(0, 0, 3);
+  root->AddChild(visualBox2);
+
+  unsigned int channels = gpuRays->Channels();
+  float *scan = new float[hRayCount * vRayCount * channels];
+  common::ConnectionPtr c =
+    gpuRays->ConnectNewGpuRaysFrame(
+        std::bind(&::OnNewGpuRaysFrame, scan,
+          std::placeholders::_1, std::placeholders::_2, std::placeholders::_3,
+          std::placeholders::_4, std::placeholders::_5));
+
+  gpuRays->Update();
+
+  unsigned int mid = hRayCount / 2;
+  double unitBoxSize = 1.0;
+
+  // ray pointing down does not hit anything
+  EXPECT_DOUBLE_EQ(scan[mid * channels], ignition::math::INF_D);
+
+  // ray pointing forward hits the first box
+  EXPECT_NEAR(scan[(hRayCount + mid) * channels], 2.0 - unitBoxSize/2,
+      VERTICAL_LASER_TOL);
+
+  // rays pointing up hit the second box
+  for (unsigned int i = 0; i < hRayCount; ++i)
+  {
+    EXPECT_NEAR(scan[(2 * hRayCount + i) * channels], 3.0 - unitBoxSize/2,
+        VERTICAL_LASER_TOL);
+  }
+
+  c.reset();
+
+  delete [] scan;
+  scan = nullptr;
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
 /////////////////////////////////////////////////
 /// \brief Test detection of particles
 void GpuRaysTest::RaysParticles(const std::string &_renderEngine)
@@ -695,6 +800,12 @@ TEST_P(GpuRaysTest, LaserVertical)
   LaserVertical(GetParam());
 }
 
+/////////////////////////////////////////////////
+TEST_P(GpuRaysTest, LaserWideVertical)
+{
+  LaserWideVertical(GetParam());
+}
+
 /////////////////////////////////////////////////
 TEST_P(GpuRaysTest, RaysParticles)
 {
@@ -17,6 +17,10 @@
 
 #include <gtest/gtest.h>
 
+#include <cmath>
+#include <string>
+#include <vector>
+
 #include <ignition/common/Console.hh>
 #include <ignition/common/Filesystem.hh>
 #include <ignition/common/Event.hh>
@@ -66,6 +70,10 @@ class ThermalCameraTest: public testing::Test,
   // Test 8 bit thermal camera output
   public: void ThermalCameraBoxes8Bit(const std::string &_renderEngine);
 
+  // Test several items sharing a heat signature texture with different
+  // temperature ranges
+  public: void ThermalCameraHeatSignatures(const std::string &_renderEngine);
+
   // Test that particles do not appear in thermal camera image
   public: void ThermalCameraParticles(const std::string &_renderEngine);
 
@@ -625,6 +633,119 @@ void ThermalCameraTest::ThermalCameraParticles(
   ignition::rendering::unloadEngine(engine->Name());
 }
 
+//////////////////////////////////////////////////
+void ThermalCameraTest::ThermalCameraHeatSignatures(
+    const std::string &_renderEngine)
+{
+  int imgWidth = 50;
+  int imgHeight = 50;
+  double aspectRatio = imgWidth / imgHeight;
+
+  // Only ogre2 supports heat signatures
+  if (_renderEngine.compare("ogre2") != 0)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' doesn't support heat signatures" << std::endl;
+    return;
+  }
+
+  // Setup ign-rendering with an empty scene
+  auto *engine = ignition::rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+
+  ignition::rendering::ScenePtr scene = engine->CreateScene("scene");
+  scene->SetBackgroundColor(1.0, 0.0, 0.0);
+  scene->SetAmbientLight(1.0, 1.0, 1.0);
+  ignition::rendering::VisualPtr root = scene->RootVisual();
+
+  // a row of boxes using the same heat signature with different ranges.
+  // The heat signature is a texture of gray pixels, so the temperature of
+  // each box should be midway between its minTemp and maxTemp
+  std::string textureName =
+    ignition::common::joinPaths(TEST_MEDIA_PATH, "gray_texture.png");
+  std::vector<double> boxY = {1.0, 0.0, -1.0};
+  std::vector<float> boxTemps = {150.0f, 250.0f, 350.0f};
+  for (unsigned int i = 0u; i < boxY.size(); ++i)
+  {
+    ignition::rendering::VisualPtr box = scene->CreateVisual();
+    box->AddGeometry(scene->CreateBox());
+    box->SetLocalPosition(3.0, boxY[i], 0.0);
+    box->SetLocalScale(0.6, 0.6, 0.6);
+    box->SetUserData("temperature", textureName);
+    box->SetUserData("minTemp", boxTemps[i] - 50.0f);
+    box->SetUserData("maxTemp", boxTemps[i] + 50.0f);
+    root->AddChild(box);
+  }
+
+  {
+    float boxTempRange = 3.0;
+    double hfov = 1.05;
+    auto thermalCamera = scene->CreateThermalCamera("ThermalCamera");
+    ASSERT_NE(thermalCamera, nullptr);
+    thermalCamera->SetImageWidth(imgWidth);
+    thermalCamera->SetImageHeight(imgHeight);
+    thermalCamera->SetFarClipPlane(10.0);
+    thermalCamera->SetNearClipPlane(0.15);
+    thermalCamera->SetAspectRatio(aspectRatio);
+    thermalCamera->SetHFOV(hfov);
+
+    float ambientTemp = 296.0f;
+    float ambientTempRange = 4.0f;
+    float linearResolution = 0.01f;
+    thermalCamera->SetAmbientTemperature(ambientTemp);
+    thermalCamera->SetAmbientTemperatureRange(ambientTempRange);
+    thermalCamera->SetLinearResolution(linearResolution);
+    thermalCamera->SetHeatSourceTemperatureRange(boxTempRange);
+    scene->RootVisual()->AddChild(thermalCamera);
+
+    uint16_t *thermalData = new uint16_t[imgHeight * imgWidth];
+    ignition::common::ConnectionPtr connection =
+      thermalCamera->ConnectNewThermalFrame(
+          std::bind(&::OnNewThermalFrame, thermalData,
+            std::placeholders::_1, std::placeholders::_2, std::placeholders::_3,
+            std::placeholders::_4, std::placeholders::_5));
+    EXPECT_NE(nullptr, connection);
+
+    // update a few times to make sure the per item ranges stay the same
+    int midHeight = static_cast<int>(thermalCamera->ImageHeight() * 0.5);
+    double tanHalfFov = std::tan(hfov * 0.5);
+    for (unsigned int k = 0u; k < 3u; ++k)
+    {
+      thermalCamera->Update();
+
+      // sample the middle of the front face of each box
+      for (unsigned int i = 0u; i < boxY.size(); ++i)
+      {
+        double ratio = boxY[i] / 2.7 / tanHalfFov;
+        int column = static_cast<int>(imgWidth * 0.5 * (1.0 - ratio));
+        int index = midHeight * thermalCamera->ImageWidth() + column;
+        EXPECT_NEAR(boxTemps[i], thermalData[index] * linearResolution,
+            boxTempRange);
+      }
+
+      // the sides of the image are ambient temperature
+      int left = midHeight * thermalCamera->ImageWidth();
+      int right = (midHeight + 1) * thermalCamera->ImageWidth() - 1;
+      EXPECT_NEAR(ambientTemp, thermalData[left] * linearResolution,
+          ambientTempRange);
+      EXPECT_NEAR(ambientTemp, thermalData[right] * linearResolution,
+          ambientTempRange);
+    }
+
+    // Clean up
+    connection.reset();
+    delete [] thermalData;
+  }
+
+  engine->DestroyScene(scene);
+  ignition::rendering::unloadEngine(engine->Name());
+}
+
 TEST_P(ThermalCameraTest, ThermalCameraBoxesUniformTemp)
 {
   ThermalCameraBoxes(GetParam(), false);
@@ -640,6 +761,11 @@ TEST_P(ThermalCameraTest, ThermalCameraBoxesUniformTemp8Bit)
   ThermalCameraBoxes8Bit(GetParam());
 }
 
+TEST_P(ThermalCameraTest, ThermalCameraHeatSignatures)
+{
+  ThermalCameraHeatSignatures(GetParam());
+}
+
 TEST_P(ThermalCameraTest, ThermalCameraParticles)
 {
   ThermalCameraParticles(GetParam());
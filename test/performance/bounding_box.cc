@@ -0,0 +1,159 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+
+#include "test_config.h"  // NOLINT(build/include)
+
+#include "ignition/rendering/RenderEngine.hh"
+#include "ignition/rendering/RenderingIface.hh"
+#include "ignition/rendering/Scene.hh"
+#include "ignition/rendering/Visual.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+/// \brief Profile bounding box queries on large visual hierarchies
+class BoundingBoxTest: public testing::Test,
+                       public testing::WithParamInterface<const char *>
+{
+  /// \brief Query the bounds of a 10k node assembly
+  public: void LargeAssembly(const std::string &_renderEngine);
+};
+
+/////////////////////////////////////////////////
+/// \brief Average time in microseconds taken by a function
+/// \param[in] _iterations Number of times to call the function
+/// \param[in] _func Function to profile
+/// \return Average time per call in microseconds
+double profile(unsigned int _iterations, const std::function<void()> &_func)
+{
+  auto start = std::chrono::steady_clock::now();
+  for (unsigned int i = 0; i < _iterations; ++i)
+    _func();
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::micro>(end - start).count() /
+      _iterations;
+}
+
+/////////////////////////////////////////////////
+void BoundingBoxTest::LargeAssembly(const std::string &_renderEngine)
+{
+  auto engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine << "' is not supported" << std::endl;
+    return;
+  }
+
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+
+  // 10 assemblies of 10 sub-assemblies of 100 parts each, plus 111 group
+  // nodes, for a total of 10111 visuals
+  const unsigned int groupCount = 10u;
+  const unsigned int partCount = 100u;
+  VisualPtr root = scene->CreateVisual();
+  scene->RootVisual()->AddChild(root);
+  std::vector<VisualPtr> parts;
+  for (unsigned int i = 0; i < groupCount; ++i)
+  {
+    VisualPtr assembly = scene->CreateVisual();
+    assembly->SetLocalPosition(i * 20.0, 0.0, 0.0);
+    assembly->SetLocalRotation(0.0, 0.0, 0.1 * i);
+    root->AddChild(assembly);
+    for (unsigned int j = 0; j < groupCount; ++j)
+    {
+      VisualPtr subAssembly = scene->CreateVisual();
+      subAssembly->SetLocalPosition(0.0, j * 2.0, 0.0);
+      assembly->AddChild(subAssembly);
+      for (unsigned int k = 0; k < partCount; ++k)
+      {
+        VisualPtr part = scene->CreateVisual();
+        part->AddGeometry(scene->CreateBox());
+        part->SetLocalPosition(0.0, 0.0, k * 0.1);
+        part->SetLocalScale(0.1);
+        subAssembly->AddChild(part);
+        parts.push_back(part);
+      }
+    }
+  }
+
+  math::AxisAlignedBox box;
+  double cold = profile(1u, [&]() { box = root->BoundingBox(); });
+  EXPECT_TRUE(box.Min().IsFinite());
+  EXPECT_TRUE(box.Max().IsFinite());
+
+  // repeated queries on an unchanged hierarchy
+  double warm = profile(1000u, [&]() { box = root->BoundingBox(); });
+
+  // one part moves every frame
+  unsigned int n = 0u;
+  double leafMoved = profile(1000u, [&]()
+  {
+    parts[n++ % parts.size()]->SetLocalPosition(0.0, 0.0, 0.0);
+    box = root->BoundingBox();
+  });
+
+  // the whole assembly moves every frame
+  double rootMoved = profile(100u, [&]()
+  {
+    root->SetLocalPosition(0.0, 0.0, n++ * 0.01);
+    box = root->BoundingBox();
+  });
+
+  double local = profile(10u, [&]()
+  {
+    root->SetLocalPosition(0.0, 0.0, n++ * 0.01);
+    box = root->LocalBoundingBox();
+  });
+
+  std::cout << "[" << _renderEngine << "] BoundingBox of "
+            << parts.size() + groupCount * groupCount + groupCount + 1u
+            << " visuals (us):" << std::endl
+            << "  cold:        " << cold << std::endl
+            << "  unchanged:   " << warm << std::endl
+            << "  leaf moved:  " << leafMoved << std::endl
+            << "  root moved:  " << rootMoved << std::endl
+            << "  local, root moved: " << local << std::endl;
+
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+TEST_P(BoundingBoxTest, LargeAssembly)
+{
+  LargeAssembly(GetParam());
+}
+
+INSTANTIATE_TEST_CASE_P(BoundingBox, BoundingBoxTest,
+    RENDER_ENGINE_VALUES,
+    ignition::rendering::PrintToStringParam());
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,275 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+
+#include "test_config.h"  // NOLINT(build/include)
+
+#include "ignition/rendering/DepthCamera.hh"
+#include "ignition/rendering/DepthCompressor.hh"
+#include "ignition/rendering/GpuRays.hh"
+#include "ignition/rendering/RenderEngine.hh"
+#include "ignition/rendering/RenderingIface.hh"
+#include "ignition/rendering/Scene.hh"
+#include "ignition/rendering/Visual.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+/// \brief Frames recorded from a sensor
+struct RecordedFrames
+{
+  /// \brief Frame width
+  unsigned int width = 0u;
+
+  /// \brief Frame height
+  unsigned int height = 0u;
+
+  /// \brief Number of floats per pixel
+  unsigned int channels = 0u;
+
+  /// \brief Frame data
+  std::vector<std::vector<float>> frames;
+};
+
+/// \brief Profile depth frame compression on frames recorded from depth
+/// cameras and gpu rays sensors
+class DepthCompressionTest: public testing::Test,
+                            public testing::WithParamInterface<const char *>
+{
+  /// \brief Record frames and compress them
+  public: void Compression(const std::string &_renderEngine);
+
+  /// \brief Compress recorded frames and print ratio and throughput
+  /// \param[in] _name Name of the recording
+  /// \param[in] _recording Recorded frames
+  public: void Profile(const std::string &_name,
+      const RecordedFrames &_recording);
+};
+
+/////////////////////////////////////////////////
+void DepthCompressionTest::Profile(const std::string &_name,
+    const RecordedFrames &_recording)
+{
+  ASSERT_FALSE(_recording.frames.empty());
+  const double step = 0.001;
+  double rawBytes = 0.0;
+  double compressedBytes = 0.0;
+
+  // single thread encoding, and check the round trip
+  std::vector<unsigned char> compressed;
+  std::vector<float> decoded;
+  auto start = std::chrono::steady_clock::now();
+  for (const auto &frame : _recording.frames)
+  {
+    DepthCompressor::Encode(frame.data(), _recording.width,
+        _recording.height, _recording.channels, step, compressed);
+    rawBytes += _recording.width * _recording.height * sizeof(float);
+    compressedBytes += compressed.size();
+  }
+  double encodeSeconds = std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - start).count();
+
+  start = std::chrono::steady_clock::now();
+  unsigned int width = 0u;
+  unsigned int height = 0u;
+  for (unsigned int i = 0; i < 10u; ++i)
+  {
+    EXPECT_TRUE(DepthCompressor::Decode(compressed.data(), compressed.size(),
+        decoded, width, height));
+  }
+  double decodeSeconds = std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - start).count() / 10.0;
+
+  const auto &last = _recording.frames.back();
+  ASSERT_EQ(_recording.width * _recording.height, decoded.size());
+  for (size_t i = 0; i < decoded.size(); ++i)
+  {
+    float value = last[i * _recording.channels];
+    if (std::isfinite(value) && value > 0.0f)
+      EXPECT_NEAR(value, decoded[i], step * 0.5 + 1e-4);
+  }
+
+  const double mb = 1024.0 * 1024.0;
+  std::cout << _name << " " << _recording.width << "x" << _recording.height
+            << ", " << _recording.frames.size() << " frames" << std::endl
+            << "  ratio:              " << rawBytes / compressedBytes
+            << std::endl
+            << "  encode (1 thread):  " << rawBytes / mb / encodeSeconds
+            << " MB/s" << std::endl
+            << "  decode (1 thread):  "
+            << _recording.width * _recording.height * sizeof(float) / mb /
+               decodeSeconds << " MB/s" << std::endl;
+
+  // worker threads, the caller only copies the frames
+  for (unsigned int workers : {1u, 2u, 4u})
+  {
+    DepthCompressor compressor;
+    compressor.SetWorkerCount(workers);
+    compressor.SetQueueSize(workers * 2u);
+    start = std::chrono::steady_clock::now();
+    for (const auto &frame : _recording.frames)
+    {
+      compressor.Compress(frame.data(), _recording.width, _recording.height,
+          _recording.channels);
+    }
+    compressor.Flush();
+    double seconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+    EXPECT_EQ(_recording.frames.size(), compressor.FramesCompressed());
+    std::cout << "  " << workers << " worker(s):        "
+              << _recording.frames.size() / seconds << " frames/s"
+              << std::endl;
+  }
+}
+
+/////////////////////////////////////////////////
+void DepthCompressionTest::Compression(const std::string &_renderEngine)
+{
+  if (_renderEngine == "optix")
+  {
+    igndbg << "Engine '" << _renderEngine
+           << "' doesn't support depth cameras" << std::endl;
+    return;
+  }
+
+  auto engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine << "' is not supported" << std::endl;
+    return;
+  }
+
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+  VisualPtr root = scene->RootVisual();
+
+  // ground and a field of boxes of different sizes
+  VisualPtr ground = scene->CreateVisual();
+  ground->AddGeometry(scene->CreateBox());
+  ground->SetLocalScale(100.0, 100.0, 0.1);
+  ground->SetLocalPosition(0.0, 0.0, -0.05);
+  root->AddChild(ground);
+  for (unsigned int i = 0; i < 100u; ++i)
+  {
+    VisualPtr box = scene->CreateVisual();
+    box->AddGeometry(scene->CreateBox());
+    double size = 0.3 + (i % 7) * 0.2;
+    box->SetLocalScale(size, size, size * 2.0);
+    box->SetLocalPosition(2.0 + (i % 10) * 2.5, -12.0 + (i / 10) * 2.6,
+        size);
+    box->SetLocalRotation(0.0, 0.0, i * 0.3);
+    root->AddChild(box);
+  }
+
+  const unsigned int frameCount = 30u;
+
+  RecordedFrames depth;
+  {
+    DepthCameraPtr camera = scene->CreateDepthCamera();
+    ASSERT_NE(nullptr, camera);
+    camera->SetImageWidth(1280u);
+    camera->SetImageHeight(720u);
+    camera->SetAspectRatio(1280.0 / 720.0);
+    camera->SetHFOV(1.05);
+    camera->SetNearClipPlane(0.1);
+    camera->SetFarClipPlane(40.0);
+    camera->CreateDepthTexture();
+    root->AddChild(camera);
+
+    common::ConnectionPtr connection = camera->ConnectNewDepthFrame(
+        [&depth](const float *_data, unsigned int _width,
+                 unsigned int _height, unsigned int _channels,
+                 const std::string &)
+        {
+          depth.width = _width;
+          depth.height = _height;
+          depth.channels = _channels;
+          depth.frames.emplace_back(_data,
+              _data + _width * _height * _channels);
+        });
+
+    for (unsigned int i = 0; i < frameCount; ++i)
+    {
+      camera->SetLocalPosition(0.0, -2.0 + i * 0.1, 1.2);
+      camera->SetLocalRotation(0.0, 0.1, 0.02 * i);
+      camera->Update();
+    }
+  }
+  this->Profile("[" + _renderEngine + "] depth camera", depth);
+
+  RecordedFrames rays;
+  {
+    GpuRaysPtr lidar = scene->CreateGpuRays();
+    ASSERT_NE(nullptr, lidar);
+    lidar->SetNearClipPlane(0.1);
+    lidar->SetFarClipPlane(40.0);
+    lidar->SetAngleMin(-IGN_PI);
+    lidar->SetAngleMax(IGN_PI);
+    lidar->SetRayCount(1800u);
+    lidar->SetVerticalAngleMin(-0.26);
+    lidar->SetVerticalAngleMax(0.26);
+    lidar->SetVerticalRayCount(16u);
+    lidar->SetLocalPosition(0.0, 0.0, 1.0);
+    root->AddChild(lidar);
+
+    common::ConnectionPtr connection = lidar->ConnectNewGpuRaysFrame(
+        [&rays](const float *_data, unsigned int _width,
+                unsigned int _height, unsigned int _channels,
+                const std::string &)
+        {
+          rays.width = _width;
+          rays.height = _height;
+          rays.channels = _channels;
+          rays.frames.emplace_back(_data,
+              _data + _width * _height * _channels);
+        });
+
+    for (unsigned int i = 0; i < frameCount; ++i)
+    {
+      lidar->SetLocalPosition(0.0, -2.0 + i * 0.1, 1.0);
+      lidar->Update();
+    }
+  }
+  this->Profile("[" + _renderEngine + "] gpu rays", rays);
+
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+TEST_P(DepthCompressionTest, Compression)
+{
+  Compression(GetParam());
+}
+
+INSTANTIATE_TEST_CASE_P(DepthCompression, DepthCompressionTest,
+    RENDER_ENGINE_VALUES,
+    ignition::rendering::PrintToStringParam());
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
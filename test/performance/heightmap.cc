@@ -0,0 +1,275 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifdef __linux__
+  #include <unistd.h>
+#endif
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+#include <ignition/common/Filesystem.hh>
+#include <ignition/common/Mesh.hh>
+#include <ignition/common/SubMesh.hh>
+
+#include "test_config.h"  // NOLINT(build/include)
+
+#include "ignition/rendering/Camera.hh"
+#include "ignition/rendering/Heightmap.hh"
+#include "ignition/rendering/Mesh.hh"
+#include "ignition/rendering/RenderEngine.hh"
+#include "ignition/rendering/RenderingIface.hh"
+#include "ignition/rendering/Scene.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+/// \brief Number of samples along each side of the terrain
+static const unsigned int kSamples = 2049u;
+
+/// \brief Size of the terrain in meters
+static const double kSize = 2048.0;
+
+/// \brief Height of the terrain in meters
+static const double kHeight = 150.0;
+
+/// \brief Number of frames rendered while flying over the terrain
+static const unsigned int kFrameCount = 100u;
+
+/// \brief Compare a chunked heightmap with a single mesh built from all
+/// samples
+class HeightmapPerfTest: public testing::Test,
+                         public testing::WithParamInterface<const char *>
+{
+  /// \brief Profile memory and frame time of both terrains
+  public: void Terrain(const std::string &_renderEngine);
+
+  /// \brief Fly a camera over the terrain and measure the frame time
+  /// \param[in] _camera Camera to render with
+  /// \param[in] _heightmap Heightmap to update, null for the single mesh
+  /// \return Average frame time in milliseconds
+  public: double Fly(const CameraPtr &_camera, const HeightmapPtr &_heightmap);
+};
+
+/////////////////////////////////////////////////
+/// \brief Get resident memory of the process
+/// \return Resident memory in KB, 0 if not available
+double residentMemory()
+{
+  double resident = 0.0;
+#ifdef __linux__
+  int totalSize = 0;
+  int residentPages = 0;
+  std::ifstream buffer("/proc/self/statm");
+  buffer >> totalSize >> residentPages;
+  resident = residentPages * (sysconf(_SC_PAGE_SIZE) / 1024.0);
+#endif
+  return resident;
+}
+
+/////////////////////////////////////////////////
+double HeightmapPerfTest::Fly(const CameraPtr &_camera,
+    const HeightmapPtr &_heightmap)
+{
+  double total = 0.0;
+  for (unsigned int i = 0; i < kFrameCount; ++i)
+  {
+    double t = static_cast<double>(i) / kFrameCount;
+    _camera->SetWorldPosition(-kSize * 0.4 + t * kSize * 0.8,
+        -kSize * 0.2 + t * kSize * 0.3, kHeight + 20.0);
+    _camera->SetWorldRotation(0.0, 0.3, 0.4);
+
+    auto start = std::chrono::steady_clock::now();
+    if (_heightmap)
+      _heightmap->Update();
+    _camera->Update();
+    total += std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+  }
+  return total / kFrameCount;
+}
+
+/////////////////////////////////////////////////
+void HeightmapPerfTest::Terrain(const std::string &_renderEngine)
+{
+  if (_renderEngine == "optix")
+  {
+    igndbg << "Engine '" << _renderEngine
+           << "' doesn't support heightmaps" << std::endl;
+    return;
+  }
+
+  auto engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine << "' is not supported" << std::endl;
+    return;
+  }
+
+  // rolling hills with ridges, stored as a raw file so that it is memory
+  // mapped like a large elevation model would be
+  std::string dir = common::joinPaths(PROJECT_BUILD_PATH,
+      "test_heightmap_perf");
+  ASSERT_TRUE(common::createDirectories(dir));
+  std::string filename = common::joinPaths(dir, "terrain.raw");
+  {
+    std::vector<uint16_t> samples(kSamples * kSamples);
+    for (unsigned int y = 0; y < kSamples; ++y)
+    {
+      for (unsigned int x = 0; x < kSamples; ++x)
+      {
+        double value = 0.5 + 0.3 * std::sin(x / 150.0) * std::cos(y / 210.0) +
+            0.1 * std::sin(x / 23.0 + y / 31.0) +
+            0.05 * std::cos(x / 7.0) * std::sin(y / 5.0);
+        samples[y * kSamples + x] = static_cast<uint16_t>(65535.0 *
+            std::max(0.0, std::min(1.0, value)));
+      }
+    }
+    std::ofstream file(filename, std::ios::binary);
+    file.write(reinterpret_cast<const char *>(samples.data()),
+        samples.size() * sizeof(uint16_t));
+  }
+
+  auto data = std::make_shared<HeightmapData>();
+  ASSERT_TRUE(data->LoadRaw(filename, kSamples, kSamples));
+
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+  VisualPtr root = scene->RootVisual();
+
+  CameraPtr camera = scene->CreateCamera();
+  ASSERT_NE(nullptr, camera);
+  camera->SetImageWidth(1280u);
+  camera->SetImageHeight(720u);
+  camera->SetHFOV(1.2);
+  camera->SetFarClipPlane(5000.0);
+  root->AddChild(camera);
+
+  // chunked heightmap
+  double heightmapMemory = 0.0;
+  double heightmapTime = 0.0;
+  {
+    double start = residentMemory();
+    HeightmapDescriptor desc;
+    desc.data = data;
+    desc.size = math::Vector3d(kSize, kSize, kHeight);
+    HeightmapPtr heightmap = scene->CreateHeightmap(desc);
+    ASSERT_NE(nullptr, heightmap);
+    root->AddChild(heightmap->Visual());
+    heightmap->SetCamera(camera);
+
+    heightmapTime = this->Fly(camera, heightmap);
+    heightmapMemory = residentMemory() - start;
+    std::cout << "[" << _renderEngine << "] heightmap " << kSamples << "x"
+              << kSamples << std::endl
+              << "  levels:         " << heightmap->LevelCount() << std::endl
+              << "  visible chunks: " << heightmap->VisibleChunkCount()
+              << std::endl
+              << "  loaded chunks:  " << heightmap->LoadedChunkCount()
+              << std::endl
+              << "  drawn vertices: " << heightmap->VisibleVertexCount()
+              << std::endl
+              << "  memory:         " << heightmapMemory / 1024.0 << " MB"
+              << std::endl
+              << "  frame time:     " << heightmapTime << " ms" << std::endl;
+  }
+
+  // a single mesh with one vertex per sample
+  double meshMemory = 0.0;
+  double meshTime = 0.0;
+  {
+    double start = residentMemory();
+    common::Mesh mesh;
+    mesh.SetName("heightmap_perf_single_mesh");
+    common::SubMesh subMesh;
+    subMesh.SetPrimitiveType(common::SubMesh::TRIANGLES);
+    double cell = kSize / (kSamples - 1u);
+    for (unsigned int y = 0; y < kSamples; ++y)
+    {
+      for (unsigned int x = 0; x < kSamples; ++x)
+      {
+        subMesh.AddVertex(-kSize * 0.5 + x * cell, kSize * 0.5 - y * cell,
+            data->Value(x, y) * kHeight);
+        subMesh.AddNormal(0.0, 0.0, 1.0);
+        subMesh.AddTexCoord(static_cast<double>(x) / (kSamples - 1u),
+            static_cast<double>(y) / (kSamples - 1u));
+      }
+    }
+    for (unsigned int y = 0; y + 1u < kSamples; ++y)
+    {
+      for (unsigned int x = 0; x + 1u < kSamples; ++x)
+      {
+        unsigned int a = y * kSamples + x;
+        unsigned int c = a + kSamples;
+        subMesh.AddIndex(c);
+        subMesh.AddIndex(c + 1u);
+        subMesh.AddIndex(a + 1u);
+        subMesh.AddIndex(c);
+        subMesh.AddIndex(a + 1u);
+        subMesh.AddIndex(a);
+      }
+    }
+    mesh.AddSubMesh(subMesh);
+
+    VisualPtr visual = scene->CreateVisual();
+    MeshPtr geometry = scene->CreateMesh(&mesh);
+    ASSERT_NE(nullptr, geometry);
+    visual->AddGeometry(geometry);
+    root->AddChild(visual);
+
+    meshTime = this->Fly(camera, nullptr);
+    meshMemory = residentMemory() - start;
+    std::cout << "[" << _renderEngine << "] single mesh" << std::endl
+              << "  drawn vertices: "
+              << static_cast<uint64_t>(kSamples) * kSamples << std::endl
+              << "  memory:         " << meshMemory / 1024.0 << " MB"
+              << std::endl
+              << "  frame time:     " << meshTime << " ms" << std::endl;
+    scene->DestroyVisual(visual, true);
+  }
+
+  EXPECT_LT(heightmapMemory, meshMemory);
+
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+  common::removeAll(dir);
+}
+
+/////////////////////////////////////////////////
+TEST_P(HeightmapPerfTest, Terrain)
+{
+  Terrain(GetParam());
+}
+
+INSTANTIATE_TEST_CASE_P(Heightmap, HeightmapPerfTest,
+    RENDER_ENGINE_VALUES,
+    ignition::rendering::PrintToStringParam());
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
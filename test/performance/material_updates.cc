@@ -0,0 +1,166 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+
+#include "test_config.h"  // NOLINT(build/include)
+
+#include "ignition/rendering/Camera.hh"
+#include "ignition/rendering/Image.hh"
+#include "ignition/rendering/Material.hh"
+#include "ignition/rendering/RenderEngine.hh"
+#include "ignition/rendering/RenderingIface.hh"
+#include "ignition/rendering/Scene.hh"
+#include "ignition/rendering/Visual.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+/// \brief Profile recoloring many visuals every frame, as done by status
+/// heatmaps
+class MaterialUpdatesTest: public testing::Test,
+                           public testing::WithParamInterface<const char *>
+{
+  /// \brief Recolor a grid of boxes with unique materials and with batch
+  /// updates
+  public: void Heatmap(const std::string &_renderEngine);
+};
+
+/////////////////////////////////////////////////
+/// \brief Color of a heatmap cell at a given frame, with a few levels
+static math::Color HeatColor(unsigned int _index, unsigned int _frame)
+{
+  const double levels = 16.0;
+  double t = 0.5 + 0.5 * std::sin(_index * 0.37 + _frame * 0.2);
+  t = std::floor(t * (levels - 1.0) + 0.5) / (levels - 1.0);
+  return math::Color(static_cast<float>(t), 0.2f,
+      static_cast<float>(1.0 - t));
+}
+
+/////////////////////////////////////////////////
+void MaterialUpdatesTest::Heatmap(const std::string &_renderEngine)
+{
+  auto engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine << "' is not supported" << std::endl;
+    return;
+  }
+
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+  scene->SetAmbientLight(0.5, 0.5, 0.5);
+  VisualPtr root = scene->RootVisual();
+
+  MaterialPtr material = scene->CreateMaterial();
+
+  const unsigned int side = 50u;
+  std::vector<VisualPtr> visuals;
+  for (unsigned int i = 0; i < side * side; ++i)
+  {
+    VisualPtr visual = scene->CreateVisual();
+    visual->AddGeometry(scene->CreateBox());
+    visual->SetMaterial(material);
+    visual->SetLocalPosition(i % side, i / side, 0.0);
+    visual->SetLocalScale(0.8);
+    root->AddChild(visual);
+    visuals.push_back(visual);
+  }
+
+  CameraPtr camera = scene->CreateCamera();
+  ASSERT_NE(nullptr, camera);
+  camera->SetImageWidth(320);
+  camera->SetImageHeight(240);
+  camera->SetLocalPosition(side * 0.5, -side * 0.5, side * 0.8);
+  camera->SetLocalRotation(0.0, 0.8, IGN_PI / 2);
+  root->AddChild(camera);
+  Image image = camera->CreateImage();
+
+  const unsigned int frames = 20u;
+
+  // one unique material per visual, updated one at a time
+  double uniqueUpdate = 0.0;
+  auto start = std::chrono::steady_clock::now();
+  for (unsigned int f = 0; f < frames; ++f)
+  {
+    auto updateStart = std::chrono::steady_clock::now();
+    for (unsigned int i = 0; i < visuals.size(); ++i)
+      visuals[i]->Material()->SetDiffuse(HeatColor(i, f));
+    uniqueUpdate += std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - updateStart).count();
+    camera->Capture(image);
+  }
+  double uniqueFrame = std::chrono::duration<double, std::milli>(
+      std::chrono::steady_clock::now() - start).count() / frames;
+
+  // shared materials, updated in one call
+  std::vector<VisualMaterialUpdate> updates(visuals.size());
+  for (unsigned int i = 0; i < visuals.size(); ++i)
+    updates[i].visual = visuals[i];
+
+  double batchUpdate = 0.0;
+  start = std::chrono::steady_clock::now();
+  for (unsigned int f = 0; f < frames; ++f)
+  {
+    auto updateStart = std::chrono::steady_clock::now();
+    for (unsigned int i = 0; i < visuals.size(); ++i)
+      updates[i].diffuse = HeatColor(i, f);
+    scene->UpdateVisualMaterials(updates);
+    batchUpdate += std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - updateStart).count();
+    camera->Capture(image);
+  }
+  double batchFrame = std::chrono::duration<double, std::milli>(
+      std::chrono::steady_clock::now() - start).count() / frames;
+
+  EXPECT_LE(scene->BatchMaterialCount(), 16u);
+
+  std::cout << "[" << _renderEngine << "] Recoloring " << visuals.size()
+            << " visuals per frame:" << std::endl
+            << "  unique materials: " << visuals.size() << " materials, "
+            << uniqueUpdate / frames << " ms update, "
+            << uniqueFrame << " ms frame" << std::endl
+            << "  batch update:     " << scene->BatchMaterialCount()
+            << " materials, " << batchUpdate / frames << " ms update, "
+            << batchFrame << " ms frame" << std::endl;
+
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+TEST_P(MaterialUpdatesTest, Heatmap)
+{
+  Heatmap(GetParam());
+}
+
+INSTANTIATE_TEST_CASE_P(MaterialUpdates, MaterialUpdatesTest,
+    RENDER_ENGINE_VALUES,
+    ignition::rendering::PrintToStringParam());
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,179 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <iostream>
+
+#include <ignition/common/Console.hh>
+
+#include "test_config.h"  // NOLINT(build/include)
+
+#include "ignition/rendering/Camera.hh"
+#include "ignition/rendering/Image.hh"
+#include "ignition/rendering/Light.hh"
+#include "ignition/rendering/Material.hh"
+#include "ignition/rendering/RenderEngine.hh"
+#include "ignition/rendering/RenderingIface.hh"
+#include "ignition/rendering/Scene.hh"
+#include "ignition/rendering/Visual.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+/// \brief Profile occlusion culling on a synthetic indoor scene. To
+/// measure software rendering, run with LIBGL_ALWAYS_SOFTWARE=1 so that
+/// llvmpipe is used.
+class OcclusionCullingTest: public testing::Test,
+                            public testing::WithParamInterface<const char *>
+{
+  /// \brief Render a maze of walls filled with small objects
+  public: void Maze(const std::string &_renderEngine);
+};
+
+/////////////////////////////////////////////////
+void OcclusionCullingTest::Maze(const std::string &_renderEngine)
+{
+  auto engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine << "' is not supported" << std::endl;
+    return;
+  }
+
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+  scene->SetAmbientLight(0.3, 0.3, 0.3);
+  VisualPtr root = scene->RootVisual();
+
+  DirectionalLightPtr light = scene->CreateDirectionalLight();
+  light->SetDirection(0.5, 0.5, -1);
+  light->SetDiffuseColor(0.8, 0.8, 0.8);
+  root->AddChild(light);
+
+  MaterialPtr material = scene->CreateMaterial();
+  material->SetDiffuse(0.7, 0.7, 0.7);
+
+  // square cells separated by walls with a door in some of them, and a
+  // grid of small boxes in each cell
+  const unsigned int cellCount = 25u;
+  const unsigned int itemsPerSide = 9u;
+  const double cellSize = 4.0;
+  const double wallHeight = 2.5;
+  unsigned int wallCount = 0u;
+  unsigned int itemCount = 0u;
+  for (unsigned int i = 0; i < cellCount; ++i)
+  {
+    for (unsigned int j = 0; j < cellCount; ++j)
+    {
+      double x = i * cellSize;
+      double y = j * cellSize;
+      for (unsigned int side = 0; side < 2; ++side)
+      {
+        // leave a door in every third wall
+        if ((i * 7 + j * 3 + side) % 3 == 0)
+          continue;
+        VisualPtr wall = scene->CreateVisual();
+        wall->AddGeometry(scene->CreateBox());
+        wall->SetMaterial(material);
+        if (side == 0)
+        {
+          wall->SetLocalPosition(x + cellSize * 0.5, y, wallHeight * 0.5);
+          wall->SetLocalScale(0.2, cellSize, wallHeight);
+        }
+        else
+        {
+          wall->SetLocalPosition(x, y + cellSize * 0.5, wallHeight * 0.5);
+          wall->SetLocalScale(cellSize, 0.2, wallHeight);
+        }
+        wall->AddVisibilityFlags(IGN_VISIBILITY_OCCLUDER);
+        root->AddChild(wall);
+        ++wallCount;
+      }
+
+      for (unsigned int k = 0; k < itemsPerSide * itemsPerSide; ++k)
+      {
+        VisualPtr item = scene->CreateVisual();
+        item->AddGeometry(scene->CreateBox());
+        item->SetMaterial(material);
+        item->SetLocalPosition(
+            x + (k % itemsPerSide + 0.5) * cellSize / itemsPerSide -
+            cellSize * 0.5,
+            y + (k / itemsPerSide + 0.5) * cellSize / itemsPerSide -
+            cellSize * 0.5,
+            0.1);
+        item->SetLocalScale(0.2);
+        root->AddChild(item);
+        ++itemCount;
+      }
+    }
+  }
+
+  CameraPtr camera = scene->CreateCamera();
+  ASSERT_NE(nullptr, camera);
+  camera->SetImageWidth(320);
+  camera->SetImageHeight(240);
+  camera->SetHFOV(IGN_PI / 2);
+  camera->SetLocalPosition(0.0, 0.0, 1.6);
+  camera->SetLocalRotation(0.0, 0.2, 0.4);
+  root->AddChild(camera);
+
+  Image image = camera->CreateImage();
+  const unsigned int frames = 20u;
+  double frameTime[2];
+  for (unsigned int culling = 0; culling < 2; ++culling)
+  {
+    camera->SetOcclusionCulling(culling == 1u);
+    EXPECT_EQ(culling == 1u, camera->OcclusionCulling());
+
+    // warm up
+    camera->Capture(image);
+
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned int f = 0; f < frames; ++f)
+      camera->Capture(image);
+    auto end = std::chrono::steady_clock::now();
+    frameTime[culling] = std::chrono::duration<double, std::milli>(
+        end - start).count() / frames;
+  }
+
+  std::cout << "[" << _renderEngine << "] Maze with " << wallCount
+            << " walls and " << itemCount << " items (ms per frame):"
+            << std::endl
+            << "  frustum culling:   " << frameTime[0] << std::endl
+            << "  occlusion culling: " << frameTime[1] << std::endl;
+
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+TEST_P(OcclusionCullingTest, Maze)
+{
+  Maze(GetParam());
+}
+
+INSTANTIATE_TEST_CASE_P(OcclusionCulling, OcclusionCullingTest,
+    RENDER_ENGINE_VALUES,
+    ignition::rendering::PrintToStringParam());
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
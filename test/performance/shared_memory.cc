@@ -0,0 +1,203 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef _WIN32
+  #include <sys/wait.h>
+  #include <unistd.h>
+#endif
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+
+#include "test_config.h"  // NOLINT(build/include)
+
+#include "ignition/rendering/SharedMemoryChannel.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+/// \brief Statistics measured by the consumer process
+struct ConsumerResult
+{
+  /// \brief Number of frames received
+  uint64_t received = 0u;
+
+  /// \brief Number of frames overwritten before being read
+  uint64_t missed = 0u;
+
+  /// \brief Mean time between writing and reading a frame, in microseconds
+  double meanLatency = 0.0;
+
+  /// \brief Maximum time between writing and reading a frame, in
+  /// microseconds
+  double maxLatency = 0.0;
+};
+
+#ifndef _WIN32
+/// \brief Stream frames to a consumer in another process and measure
+/// latency and throughput
+/// \param[in] _name Channel name
+/// \param[in] _width Frame width
+/// \param[in] _height Frame height
+/// \param[in] _channels Number of channels per pixel
+/// \param[in] _bytes Number of bytes per channel
+/// \param[in] _format Pixel format name
+/// \param[in] _frameCount Number of frames to stream
+/// \param[in] _period Time between frames, zero to stream as fast as
+/// possible
+void StreamFrames(const std::string &_name, unsigned int _width,
+    unsigned int _height, unsigned int _channels, unsigned int _bytes,
+    const std::string &_format, unsigned int _frameCount,
+    std::chrono::microseconds _period)
+{
+  uint64_t frameSize =
+      static_cast<uint64_t>(_width) * _height * _channels * _bytes;
+  SharedMemoryWriter writer;
+  ASSERT_TRUE(writer.Open(_name, 8u, frameSize));
+
+  int ready[2];
+  int results[2];
+  ASSERT_EQ(0, pipe(ready));
+  ASSERT_EQ(0, pipe(results));
+
+  pid_t pid = fork();
+  ASSERT_NE(-1, pid);
+  if (pid == 0)
+  {
+    // consumer process
+    ConsumerResult result;
+    SharedMemoryReader reader;
+    bool opened = reader.Open(_name);
+    char byte = opened ? 1 : 0;
+    if (write(ready[1], &byte, 1) != 1 || !opened)
+      _exit(1);
+
+    std::vector<unsigned char> data;
+    SharedMemoryFrameInfo info;
+    double total = 0.0;
+    while (reader.Wait(data, info, std::chrono::seconds(5)))
+    {
+      double latency = std::chrono::duration<double, std::micro>(
+          SharedMemoryReader::Latency(info)).count();
+      total += latency;
+      result.maxLatency = std::max(result.maxLatency, latency);
+      if (info.sequence + 1u == _frameCount)
+        break;
+    }
+    result.received = reader.FramesRead();
+    result.missed = reader.FramesMissed();
+    if (result.received > 0u)
+      result.meanLatency = total / result.received;
+    bool written = write(results[1], &result, sizeof(result)) ==
+        static_cast<ssize_t>(sizeof(result));
+    _exit(written ? 0 : 1);
+  }
+
+  // producer process
+  char byte = 0;
+  ASSERT_EQ(1, read(ready[0], &byte, 1));
+  ASSERT_EQ(1, byte);
+
+  std::vector<unsigned char> frame(frameSize, 127u);
+  auto start = std::chrono::steady_clock::now();
+  for (unsigned int i = 0; i < _frameCount; ++i)
+  {
+    frame[0] = static_cast<unsigned char>(i);
+    EXPECT_TRUE(writer.Write(frame.data(), frameSize, _width, _height,
+        _channels, _format));
+    if (_period.count() > 0)
+      std::this_thread::sleep_until(start + _period * (i + 1u));
+  }
+  double seconds = std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - start).count();
+
+  ConsumerResult result;
+  ASSERT_EQ(static_cast<ssize_t>(sizeof(result)),
+      read(results[0], &result, sizeof(result)));
+  int status = 0;
+  waitpid(pid, &status, 0);
+  EXPECT_EQ(0, WEXITSTATUS(status));
+
+  close(ready[0]);
+  close(ready[1]);
+  close(results[0]);
+  close(results[1]);
+
+  EXPECT_EQ(_frameCount, result.received + result.missed);
+  if (_period.count() > 0)
+  {
+    EXPECT_LT(0u, result.received);
+  }
+
+  double rate = _frameCount / seconds;
+  ignmsg << _format << " " << _width << "x" << _height << ", "
+         << (_period.count() > 0 ? "paced" : "unpaced") << ": "
+         << rate << " frames/s written ("
+         << rate * frameSize / (1024.0 * 1024.0) << " MB/s), "
+         << result.received << " received, " << result.missed
+         << " missed, latency mean " << result.meanLatency << " us, max "
+         << result.maxLatency << " us" << std::endl;
+}
+
+/////////////////////////////////////////////////
+TEST(SharedMemoryTest, Camera)
+{
+  common::Console::SetVerbosity(3);
+
+  // 30 Hz camera, then as fast as possible
+  StreamFrames("ign_rendering_perf_camera", 1280u, 720u, 3u, 1u, "R8G8B8",
+      60u, std::chrono::microseconds(33333));
+  StreamFrames("ign_rendering_perf_camera", 1280u, 720u, 3u, 1u, "R8G8B8",
+      500u, std::chrono::microseconds(0));
+}
+
+/////////////////////////////////////////////////
+TEST(SharedMemoryTest, Depth)
+{
+  common::Console::SetVerbosity(3);
+
+  StreamFrames("ign_rendering_perf_depth", 640u, 480u, 1u, 4u, "FLOAT32",
+      60u, std::chrono::microseconds(33333));
+  StreamFrames("ign_rendering_perf_depth", 640u, 480u, 1u, 4u, "FLOAT32",
+      1000u, std::chrono::microseconds(0));
+}
+
+/////////////////////////////////////////////////
+TEST(SharedMemoryTest, GpuRays)
+{
+  common::Console::SetVerbosity(3);
+
+  // 1800 x 16 lidar with 3 floats per reading at 10 Hz
+  StreamFrames("ign_rendering_perf_lidar", 1800u, 16u, 3u, 4u,
+      "PF_FLOAT32_RGB", 20u, std::chrono::microseconds(100000));
+  StreamFrames("ign_rendering_perf_lidar", 1800u, 16u, 3u, 4u,
+      "PF_FLOAT32_RGB", 5000u, std::chrono::microseconds(0));
+}
+#endif
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}